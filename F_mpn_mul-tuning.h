@@ -22,11 +22,13 @@
 #ifndef FLINT_F_MPN_MUL_TUNING_H
 #define FLINT_F_MPN_MUL_TUNING_H
 
+#include "flint-tuning.h"
+
 #ifdef __cplusplus
  extern "C" {
 #endif
  
-#define FLINT_FFT_LIMBS_CROSSOVER 2300
+#define FLINT_FFT_LIMBS_CROSSOVER (flint_tuning.fft_limbs_thresh)
 
 #define MUL_TWK_SMALL_CUTOFF 2000
 #define MUL_TWK_SMALL_DEFAULT 64
@@ -44,6 +46,8 @@
 #define FFT_SQR_COUNT 30
 #define FFT_TUNE_CUTOFF 20000000L
 
+extern unsigned long FFT_MUL_TWK[FFT_MUL_COUNT][2];
+
 #ifdef __cplusplus
  }
 #endif
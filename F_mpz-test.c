@@ -335,6 +335,55 @@ int test_F_mpz_get_d_2exp()
    return result;
 }
 
+int test_F_mpz_get_ld_2exp()
+{
+   mpz_t m1, m2;
+	long double fd;
+   F_mpz_t f1;
+   int result = 1;
+   ulong bits;
+   long expf;
+   
+   mpz_init(m1); 
+   mpz_init(m2); 
+   
+   ulong count1;
+   for (count1 = 0; (count1 < 100000*ITER) && (result == 1); count1++)
+   {
+      F_mpz_init2(f1, z_randint(10));
+      
+      bits = z_randint(200) + 1;
+      F_mpz_test_random(f1, bits);
+           
+      F_mpz_get_mpz(m1, f1);
+      
+		fd = F_mpz_get_ld_2exp(&expf, f1);
+      
+      // the top FLINT_BITS bits of m1 should be the mantissa exactly
+      mpz_abs(m2, m1);
+      if (mpz_sgn(m1) == 0) result = ((fd == 0.0L) && (expf == 0L));
+      else
+      {
+         if (expf > FLINT_BITS) mpz_tdiv_q_2exp(m2, m2, expf - FLINT_BITS);
+         else mpz_mul_2exp(m2, m2, FLINT_BITS - expf);
+
+         result = ((expf == mpz_sizeinbase(m1, 2)) && (mpz_sgn(m1) == ((fd < 0.0L) ? -1 : 1))
+                && (ldexpl(fabsl(fd), FLINT_BITS) == (long double) mpz_get_ui(m2)));
+      }
+		if (!result) 
+		{
+			gmp_printf("Error: bits = %ld, m1 = %Zd, fd = %Lf, expf = %ld\n", bits, m1, fd, expf);
+		}
+          
+      F_mpz_clear(f1);
+   }
+   
+   mpz_clear(m1);
+   mpz_clear(m2);
+   
+   return result;
+}
+
 int test_F_mpz_get_d()
 {
    mpz_t m1;
@@ -2813,6 +2862,525 @@ int test_F_mpz_smod_preinv()
    return result;
 }
 
+int test_F_mpz_mod_ctx_reduce()
+{
+   mpz_t m1, m2, m3, m4;
+   F_mpz_t f1, f2, f3;
+   F_mpz_mod_ctx_t ctx;
+   int result = 1;
+   ulong bits, bits2;
+   
+   mpz_init(m1); 
+   mpz_init(m2); 
+   mpz_init(m3); 
+   mpz_init(m4); 
+
+   ulong count1;
+   for (count1 = 0; (count1 < 100000*ITER) && (result == 1); count1++)
+   {
+      F_mpz_init(f1);
+      F_mpz_init(f2);
+      F_mpz_init(f3);
+
+      bits = z_randint(1000) + 1;
+      F_mpz_test_random(f1, bits);
+      bits2 = z_randint(500) + 1;
+      F_mpz_test_random(f2, bits2);
+      F_mpz_abs(f2, f2);
+      if (F_mpz_is_zero(f2)) 
+			F_mpz_set_ui(f2, 1L);
+           
+      F_mpz_get_mpz(m1, f1);
+      F_mpz_get_mpz(m2, f2);
+
+      F_mpz_mod_ctx_init(ctx, f2);
+		
+      if (z_randint(2)) F_mpz_mod_ctx_reduce(f3, f1, ctx);
+      else
+      {
+         F_mpz_set(f3, f1);
+         F_mpz_mod_ctx_reduce(f3, f3, ctx); // test aliasing
+      }
+		F_mpz_get_mpz(m3, f3);
+      mpz_mod(m4, m1, m2);
+          
+      result = (mpz_cmp(m4, m3) == 0); 
+		if (!result) 
+		{
+			gmp_printf("Error: bits = %ld, bits2 = %ld, m1 = %Zd, m2 = %Zd, m3 = %Zd, m4 = %Zd\n", bits, bits2, m1, m2, m3, m4);
+		}
+      
+      F_mpz_mod_ctx_clear(ctx);
+
+      F_mpz_clear(f1);
+      F_mpz_clear(f2);
+      F_mpz_clear(f3);
+   }
+   
+   mpz_clear(m1);
+   mpz_clear(m2);
+   mpz_clear(m3);
+   mpz_clear(m4);
+
+   return result;
+}
+
+int test_F_mpz_mod_ctx_mulmod()
+{
+   mpz_t m1, m2, m3, m4, m5;
+   F_mpz_t f1, f2, f3, f4;
+   F_mpz_mod_ctx_t ctx;
+   int result = 1;
+   ulong bits;
+   
+   mpz_init(m1); 
+   mpz_init(m2); 
+   mpz_init(m3); 
+   mpz_init(m4); 
+   mpz_init(m5); 
+
+   ulong count1;
+   for (count1 = 0; (count1 < 100000*ITER) && (result == 1); count1++)
+   {
+      F_mpz_init(f1);
+      F_mpz_init(f2);
+      F_mpz_init(f3);
+      F_mpz_init(f4);
+
+      bits = z_randint(500) + 1;
+      F_mpz_test_random(f3, bits);
+      F_mpz_abs(f3, f3);
+      if (F_mpz_is_zero(f3)) 
+			F_mpz_set_ui(f3, 1L);
+      
+      F_mpz_mod_ctx_init(ctx, f3);
+      
+      F_mpz_test_random(f1, bits);
+      F_mpz_test_random(f2, bits);
+      F_mpz_mod_ctx_reduce(f1, f1, ctx);
+      F_mpz_mod_ctx_reduce(f2, f2, ctx);
+           
+      F_mpz_get_mpz(m1, f1);
+      F_mpz_get_mpz(m2, f2);
+      F_mpz_get_mpz(m3, f3);
+
+      // multiplication
+		F_mpz_mod_ctx_mulmod(f4, f1, f2, ctx);
+		F_mpz_get_mpz(m4, f4);
+      mpz_mul(m5, m1, m2);
+      mpz_mod(m5, m5, m3);
+      result = (mpz_cmp(m4, m5) == 0); 
+
+      // addition
+      F_mpz_mod_ctx_addmod(f4, f1, f2, ctx);
+		F_mpz_get_mpz(m4, f4);
+      mpz_add(m5, m1, m2);
+      mpz_mod(m5, m5, m3);
+      result &= (mpz_cmp(m4, m5) == 0); 
+
+      // subtraction
+      F_mpz_mod_ctx_submod(f4, f1, f2, ctx);
+		F_mpz_get_mpz(m4, f4);
+      mpz_sub(m5, m1, m2);
+      mpz_mod(m5, m5, m3);
+      result &= (mpz_cmp(m4, m5) == 0); 
+
+		if (!result) 
+		{
+			gmp_printf("Error: bits = %ld, m1 = %Zd, m2 = %Zd, m3 = %Zd, m4 = %Zd, m5 = %Zd\n", bits, m1, m2, m3, m4, m5);
+		}
+      
+      F_mpz_mod_ctx_clear(ctx);
+
+      F_mpz_clear(f1);
+      F_mpz_clear(f2);
+      F_mpz_clear(f3);
+      F_mpz_clear(f4);
+   }
+   
+   mpz_clear(m1);
+   mpz_clear(m2);
+   mpz_clear(m3);
+   mpz_clear(m4);
+   mpz_clear(m5);
+
+   return result;
+}
+
+int test_F_mpz_mod_ctx_mont()
+{
+   mpz_t m1, m2, m3, m4, m5;
+   F_mpz_t f1, f2, f3, f4;
+   F_mpz_mod_ctx_t ctx;
+   int result = 1;
+   ulong bits;
+   
+   mpz_init(m1); 
+   mpz_init(m2); 
+   mpz_init(m3); 
+   mpz_init(m4); 
+   mpz_init(m5); 
+
+   ulong count1;
+   for (count1 = 0; (count1 < 100000*ITER) && (result == 1); count1++)
+   {
+      F_mpz_init(f1);
+      F_mpz_init(f2);
+      F_mpz_init(f3);
+      F_mpz_init(f4);
+
+      bits = z_randint(500) + 1;
+      do
+      {
+         F_mpz_test_random(f3, bits);
+         F_mpz_abs(f3, f3);
+      } while (F_mpz_is_zero(f3) || !(F_mpz_get_ui(f3) & 1L)); // need an odd modulus
+      
+      F_mpz_mod_ctx_init(ctx, f3);
+      
+      F_mpz_test_random(f1, bits);
+      F_mpz_test_random(f2, bits);
+      F_mpz_mod_ctx_reduce(f1, f1, ctx);
+      F_mpz_mod_ctx_reduce(f2, f2, ctx);
+           
+      F_mpz_get_mpz(m1, f1);
+      F_mpz_get_mpz(m2, f2);
+      F_mpz_get_mpz(m3, f3);
+
+      // convert into Montgomery form, multiply and convert back
+		F_mpz_mod_ctx_mont_set(f4, f1, ctx);
+		F_mpz_mod_ctx_mont_set(f2, f2, ctx);
+		F_mpz_mod_ctx_mont_mul(f4, f4, f2, ctx);
+		F_mpz_mod_ctx_mont_redc(f4, f4, ctx);
+		
+      F_mpz_get_mpz(m4, f4);
+      mpz_mul(m5, m1, m2);
+      mpz_mod(m5, m5, m3);
+      result = (mpz_cmp(m4, m5) == 0); 
+
+      // round trip
+      F_mpz_mod_ctx_mont_set(f4, f1, ctx);
+		F_mpz_mod_ctx_mont_redc(f4, f4, ctx);
+      result &= F_mpz_equal(f4, f1); 
+
+		if (!result) 
+		{
+			gmp_printf("Error: bits = %ld, m1 = %Zd, m2 = %Zd, m3 = %Zd, m4 = %Zd, m5 = %Zd\n", bits, m1, m2, m3, m4, m5);
+		}
+      
+      F_mpz_mod_ctx_clear(ctx);
+
+      F_mpz_clear(f1);
+      F_mpz_clear(f2);
+      F_mpz_clear(f3);
+      F_mpz_clear(f4);
+   }
+   
+   mpz_clear(m1);
+   mpz_clear(m2);
+   mpz_clear(m3);
+   mpz_clear(m4);
+   mpz_clear(m5);
+
+   return result;
+}
+
+int test_F_mpz_powm()
+{
+   mpz_t m1, m2, m3, m4, m5;
+   F_mpz_t f1, f2, f3, f4;
+   int result = 1;
+   ulong bits, bits2;
+   
+   mpz_init(m1); 
+   mpz_init(m2); 
+   mpz_init(m3); 
+   mpz_init(m4); 
+   mpz_init(m5); 
+
+   ulong count1;
+   for (count1 = 0; (count1 < 5000*ITER) && (result == 1); count1++)
+   {
+      F_mpz_init(f1);
+      F_mpz_init(f2);
+      F_mpz_init(f3);
+      F_mpz_init(f4);
+
+      // large enough to test both Montgomery and plain reduction
+      bits = (count1 & 15) ? z_randint(300) + 1 : z_randint(5000) + 1;
+      bits2 = z_randint(400);
+      do
+      {
+         F_mpz_test_random(f3, bits);
+         F_mpz_abs(f3, f3);
+      } while (F_mpz_is_zero(f3));
+      
+      F_mpz_test_random(f1, z_randint(bits + 100));
+      F_mpz_test_random(f2, bits2);
+      
+      F_mpz_get_mpz(m1, f1);
+      F_mpz_get_mpz(m2, f2);
+      F_mpz_get_mpz(m3, f3);
+
+      if (mpz_sgn(m2) < 0 && !mpz_invert(m5, m1, m3)) // base must be invertible
+      {
+         F_mpz_neg(f2, f2);
+         mpz_neg(m2, m2);
+      }
+
+      F_mpz_powm(f4, f1, f2, f3);
+		
+      F_mpz_get_mpz(m4, f4);
+      mpz_powm(m5, m1, m2, m3);
+      result = (mpz_cmp(m4, m5) == 0); 
+
+      // check aliasing of the output with the base and the exponent
+      F_mpz_set(f4, f1);
+      F_mpz_powm(f4, f4, f2, f3);
+      F_mpz_get_mpz(m4, f4);
+      result &= (mpz_cmp(m4, m5) == 0); 
+
+      F_mpz_set(f4, f2);
+      F_mpz_powm(f4, f1, f4, f3);
+      F_mpz_get_mpz(m4, f4);
+      result &= (mpz_cmp(m4, m5) == 0); 
+
+		if (!result) 
+		{
+			gmp_printf("Error: bits = %ld, m1 = %Zd, m2 = %Zd, m3 = %Zd, m4 = %Zd, m5 = %Zd\n", bits, m1, m2, m3, m4, m5);
+		}
+      
+      F_mpz_clear(f1);
+      F_mpz_clear(f2);
+      F_mpz_clear(f3);
+      F_mpz_clear(f4);
+   }
+   
+   mpz_clear(m1);
+   mpz_clear(m2);
+   mpz_clear(m3);
+   mpz_clear(m4);
+   mpz_clear(m5);
+
+   return result;
+}
+
+int test_F_mpz_powm_ui()
+{
+   mpz_t m1, m3, m4, m5;
+   F_mpz_t f1, f3, f4;
+   int result = 1;
+   ulong bits, e;
+   
+   mpz_init(m1); 
+   mpz_init(m3); 
+   mpz_init(m4); 
+   mpz_init(m5); 
+
+   ulong count1;
+   for (count1 = 0; (count1 < 20000*ITER) && (result == 1); count1++)
+   {
+      F_mpz_init(f1);
+      F_mpz_init(f3);
+      F_mpz_init(f4);
+
+      bits = z_randint(500) + 1;
+      do
+      {
+         F_mpz_test_random(f3, bits);
+         F_mpz_abs(f3, f3);
+      } while (F_mpz_is_zero(f3));
+      
+      F_mpz_test_random(f1, bits);
+      e = z_randbits(z_randint(FLINT_BITS + 1));
+      
+      F_mpz_get_mpz(m1, f1);
+      F_mpz_get_mpz(m3, f3);
+
+      F_mpz_powm_ui(f4, f1, e, f3);
+		
+      F_mpz_get_mpz(m4, f4);
+      mpz_powm_ui(m5, m1, e, m3);
+      result = (mpz_cmp(m4, m5) == 0); 
+
+		if (!result) 
+		{
+			gmp_printf("Error: bits = %ld, e = %lu, m1 = %Zd, m3 = %Zd, m4 = %Zd, m5 = %Zd\n", bits, e, m1, m3, m4, m5);
+		}
+      
+      F_mpz_clear(f1);
+      F_mpz_clear(f3);
+      F_mpz_clear(f4);
+   }
+   
+   mpz_clear(m1);
+   mpz_clear(m3);
+   mpz_clear(m4);
+   mpz_clear(m5);
+
+   return result;
+}
+
+int test_F_mpz_powm_fixed()
+{
+   mpz_t m1, m2, m3, m4, m5;
+   F_mpz_t f1, f2, f3, f4;
+   F_mpz_mod_ctx_t ctx;
+   F_mpz_powm_fixed_t pre;
+   int result = 1;
+   ulong bits, maxbits, i;
+   
+   mpz_init(m1); 
+   mpz_init(m2); 
+   mpz_init(m3); 
+   mpz_init(m4); 
+   mpz_init(m5); 
+
+   ulong count1;
+   for (count1 = 0; (count1 < 1000*ITER) && (result == 1); count1++)
+   {
+      F_mpz_init(f1);
+      F_mpz_init(f2);
+      F_mpz_init(f3);
+      F_mpz_init(f4);
+
+      bits = (count1 & 15) ? z_randint(300) + 1 : z_randint(5000) + 1;
+      do
+      {
+         F_mpz_test_random(f3, bits);
+         F_mpz_abs(f3, f3);
+      } while (F_mpz_is_zero(f3));
+      
+      F_mpz_mod_ctx_init(ctx, f3);
+      F_mpz_test_random(f1, bits);
+      maxbits = z_randint(1000);
+      F_mpz_powm_fixed_init(pre, f1, maxbits, ctx);
+
+      F_mpz_get_mpz(m1, f1);
+      F_mpz_get_mpz(m3, f3);
+
+      // exponents of up to maxbits bits use the table, the others do not
+      for (i = 0; (i < 10) && (result == 1); i++)
+      {
+         F_mpz_test_random(f2, z_randint(maxbits + 10));
+         F_mpz_abs(f2, f2);
+         F_mpz_get_mpz(m2, f2);
+         
+         F_mpz_powm_fixed(f4, f2, pre);
+		
+         F_mpz_get_mpz(m4, f4);
+         mpz_powm(m5, m1, m2, m3);
+         result = (mpz_cmp(m4, m5) == 0); 
+      }
+
+		if (!result) 
+		{
+			gmp_printf("Error: bits = %ld, maxbits = %ld, m1 = %Zd, m2 = %Zd, m3 = %Zd, m4 = %Zd, m5 = %Zd\n", bits, maxbits, m1, m2, m3, m4, m5);
+		}
+      
+      F_mpz_powm_fixed_clear(pre);
+      F_mpz_mod_ctx_clear(ctx);
+
+      F_mpz_clear(f1);
+      F_mpz_clear(f2);
+      F_mpz_clear(f3);
+      F_mpz_clear(f4);
+   }
+   
+   mpz_clear(m1);
+   mpz_clear(m2);
+   mpz_clear(m3);
+   mpz_clear(m4);
+   mpz_clear(m5);
+
+   return result;
+}
+
+int test_F_mpz_powm_batch()
+{
+   mpz_t m1, m2, m3, m4, m5;
+   F_mpz_t f3;
+   F_mpz * bases, * exps, * res;
+   F_mpz_mod_ctx_t ctx;
+   int result = 1;
+   ulong bits, num, i;
+   
+   mpz_init(m1); 
+   mpz_init(m2); 
+   mpz_init(m3); 
+   mpz_init(m4); 
+   mpz_init(m5); 
+
+   ulong count1;
+   for (count1 = 0; (count1 < 1000*ITER) && (result == 1); count1++)
+   {
+      F_mpz_init(f3);
+
+      bits = z_randint(1000) + 1;
+      do
+      {
+         F_mpz_test_random(f3, bits);
+         F_mpz_abs(f3, f3);
+      } while (F_mpz_is_zero(f3));
+      
+      F_mpz_mod_ctx_init(ctx, f3);
+      F_mpz_get_mpz(m3, f3);
+
+      num = z_randint(20);
+      bases = (F_mpz *) flint_heap_alloc(2*num + 1);
+      exps = bases + num;
+      res = (F_mpz *) flint_heap_alloc(num + 1);
+      for (i = 0; i < 2*num; i++)
+         F_mpz_init(bases + i);
+      for (i = 0; i < num; i++)
+      {
+         F_mpz_init(res + i);
+         F_mpz_test_random(bases + i, bits);
+         F_mpz_test_random(exps + i, z_randint(300));
+         F_mpz_abs(exps + i, exps + i);
+      }
+
+      F_mpz_powm_batch(res, bases, exps, num, ctx);
+
+      for (i = 0; (i < num) && (result == 1); i++)
+      {
+         F_mpz_get_mpz(m1, bases + i);
+         F_mpz_get_mpz(m2, exps + i);
+         F_mpz_get_mpz(m4, res + i);
+         mpz_powm(m5, m1, m2, m3);
+         result = (mpz_cmp(m4, m5) == 0); 
+      }
+
+      // check aliasing of the output with the bases
+      F_mpz_powm_batch(bases, bases, exps, num, ctx);
+      for (i = 0; (i < num) && (result == 1); i++)
+         result = F_mpz_equal(bases + i, res + i);
+
+		if (!result) 
+		{
+			gmp_printf("Error: bits = %ld, num = %ld, i = %ld, m1 = %Zd, m2 = %Zd, m3 = %Zd, m4 = %Zd, m5 = %Zd\n", bits, num, i, m1, m2, m3, m4, m5);
+		}
+      
+      for (i = 0; i < 2*num; i++)
+         F_mpz_clear(bases + i);
+      for (i = 0; i < num; i++)
+         F_mpz_clear(res + i);
+      flint_heap_free(bases);
+      flint_heap_free(res);
+
+      F_mpz_mod_ctx_clear(ctx);
+      F_mpz_clear(f3);
+   }
+   
+   mpz_clear(m1);
+   mpz_clear(m2);
+   mpz_clear(m3);
+   mpz_clear(m4);
+   mpz_clear(m5);
+
+   return result;
+}
+
 int test_F_mpz_fdiv_qr()
 {
    mpz_t m1, m2, m3, m4, m5, m6;
@@ -4014,6 +4582,7 @@ void F_mpz_poly_test_all()
    RUN_TEST(F_mpz_get_d); 
    RUN_TEST(F_mpz_set_d); 
    RUN_TEST(F_mpz_get_d_2exp); 
+   RUN_TEST(F_mpz_get_ld_2exp); 
    RUN_TEST(F_mpz_set_d_2exp); 
    RUN_TEST(F_mpz_set); 
    RUN_TEST(F_mpz_equal); 
@@ -4037,6 +4606,13 @@ void F_mpz_poly_test_all()
    RUN_TEST(F_mpz_smod); 
    RUN_TEST(F_mpz_mod_preinv); 
    RUN_TEST(F_mpz_smod_preinv); 
+   RUN_TEST(F_mpz_mod_ctx_reduce); 
+   RUN_TEST(F_mpz_mod_ctx_mulmod); 
+   RUN_TEST(F_mpz_mod_ctx_mont); 
+   RUN_TEST(F_mpz_powm); 
+   RUN_TEST(F_mpz_powm_ui); 
+   RUN_TEST(F_mpz_powm_fixed); 
+   RUN_TEST(F_mpz_powm_batch); 
    RUN_TEST(F_mpz_fdiv_qr); 
    RUN_TEST(F_mpz_pow_ui); 
    RUN_TEST(F_mpz_gcd); 
@@ -366,6 +366,41 @@ double F_mpz_get_d_2exp(long * exp, const F_mpz_t f)
 	}
 }
 
+long double F_mpz_get_ld_2exp(long * exp, const F_mpz_t f)
+{
+   F_mpz d = *f;
+
+	if (!COEFF_IS_MPZ(d))
+   {
+      if (d == 0L) 
+      {
+         (*exp) = 0L;
+         return 0.0L;
+      }
+      ulong d_abs = FLINT_ABS(d);
+      (*exp) = FLINT_BIT_COUNT(d_abs);
+      return ldexpl((long double) d, -*exp);
+   } else 
+	{
+		__mpz_struct * m = F_mpz_arr + COEFF_TO_OFF(d);
+      long size = FLINT_ABS(m->_mp_size);
+      ulong top = m->_mp_d[size - 1];
+      ulong bits = FLINT_BIT_COUNT(top);
+      
+      // get the top FLINT_BITS bits of |f| into a single limb
+      if (bits < FLINT_BITS)
+      {
+         top <<= (FLINT_BITS - bits);
+         if (size > 1) top += (m->_mp_d[size - 2] >> bits);
+      }
+
+      (*exp) = (size - 1)*FLINT_BITS + bits;
+      
+      long double ret = ldexpl((long double) top, -FLINT_BITS);
+      return (m->_mp_size < 0) ? -ret : ret;
+	}
+}
+
 /* 
    Gets f as a double.
 */
@@ -2024,6 +2059,739 @@ void F_mpz_rdiv_q(F_mpz_t f, const F_mpz_t g, const F_mpz_t h)
 	F_mpz_clear(h2);
 }
 
+/*===============================================================================
+
+	Modulus contexts
+
+================================================================================*/
+
+#define F_MPZ_MOD_CTX_STACK 256 // number of limbs of scratch space kept on the stack
+
+void F_mpz_mod_ctx_init(F_mpz_mod_ctx_t ctx, const F_mpz_t n)
+{
+   if (F_mpz_sgn(n) <= 0)
+   {
+      printf("FLINT Exception: modulus must be positive\n");
+      abort();
+   }
+
+   F_mpz_init(ctx->n);
+   F_mpz_set(ctx->n, n);
+
+   ulong k = F_mpz_size(n);
+   ctx->limbs = k;
+   
+   ctx->nm = (mp_limb_t *) malloc(sizeof(mp_limb_t)*k);
+   F_mpz_get_limbs(ctx->nm, n);
+
+   // Newton iteration for 1/n mod B, each step doubles the number of correct bits
+   if (ctx->nm[0] & 1L)
+   {
+      mp_limb_t n0 = ctx->nm[0], inv = n0; // correct to 3 bits
+      ulong i;
+      for (i = 3; i < FLINT_BITS; i *= 2)
+         inv *= 2 - n0*inv;
+      ctx->minv = -inv;
+   } else ctx->minv = 0L;
+}
+
+void F_mpz_mod_ctx_clear(F_mpz_mod_ctx_t ctx)
+{
+   free(ctx->nm);
+   F_mpz_clear(ctx->n);
+}
+
+/*
+   Set f to the nonnegative integer with the rs limbs r, the top one nonzero.
+   This avoids the overhead of F_mpz_set_limbs.
+*/
+static inline
+void __F_mpz_mod_ctx_set_limbs(F_mpz_t f, const mp_limb_t * r, const ulong rs)
+{
+   if (rs <= 1) F_mpz_set_ui(f, rs ? r[0] : 0L);
+   else
+   {
+      __mpz_struct * f_ptr = _F_mpz_promote(f);
+      if (f_ptr->_mp_alloc < rs) _mpz_realloc(f_ptr, rs);
+      F_mpn_copy(f_ptr->_mp_d, r, rs);
+      f_ptr->_mp_size = rs;
+   }
+}
+
+void F_mpz_mod_ctx_reduce(F_mpz_t f, const F_mpz_t g, const F_mpz_mod_ctx_t ctx)
+{
+   if (!COEFF_IS_MPZ(*ctx->n)) // n is small
+   {
+      F_mpz_mod(f, g, ctx->n);
+      return;
+   }
+
+   if (!COEFF_IS_MPZ(*g) || F_mpz_cmpabs(g, ctx->n) < 0) // |g| < n already
+   {
+      if (F_mpz_sgn(g) < 0) F_mpz_add(f, g, ctx->n);
+      else F_mpz_set(f, g);
+      return;
+   }
+
+   ulong k = ctx->limbs;
+   __mpz_struct * g_ptr = F_mpz_ptr_mpz(*g);
+   ulong gs = FLINT_ABS(g_ptr->_mp_size);
+   int negative = (g_ptr->_mp_size < 0);
+
+   // divide directly on the limbs, the quotient is discarded
+   ulong size = gs + 1;
+   mp_limb_t stack[F_MPZ_MOD_CTX_STACK];
+   mp_limb_t * r = (size <= F_MPZ_MOD_CTX_STACK) ? stack : (mp_limb_t *) malloc(sizeof(mp_limb_t)*size);
+   mp_limb_t * q = r + k;
+
+   mpn_tdiv_qr(q, r, 0, g_ptr->_mp_d, gs, ctx->nm, k);
+   
+   ulong rs = k;
+   while (rs && !r[rs - 1]) rs--;
+   if (negative && rs) 
+   {
+      F_mpn_clear(r + rs, k - rs);
+      mpn_sub_n(r, ctx->nm, r, k);
+      rs = k;
+      while (rs && !r[rs - 1]) rs--;
+   }
+   
+   // f may alias g, whose limbs are no longer needed
+   __F_mpz_mod_ctx_set_limbs(f, r, rs);
+
+   if (r != stack) free(r);
+}
+
+void F_mpz_mod_ctx_mulmod(F_mpz_t f, const F_mpz_t g, const F_mpz_t h, 
+                                                   const F_mpz_mod_ctx_t ctx)
+{
+   F_mpz_t t;
+   F_mpz_init(t);
+
+   F_mpz_mul2(t, g, h);
+   F_mpz_mod_ctx_reduce(f, t, ctx);
+
+   F_mpz_clear(t);
+}
+
+/*
+   Set r to t/B^k mod n, in [0, n), where t has 2k limbs and t < n*B^k. The 
+   array t is destroyed. This is Montgomery's REDC, with the carries of each 
+   step stored in the limb of t that the step cleared.
+*/
+static inline
+void __F_mpz_mod_ctx_redc(mp_limb_t * r, mp_limb_t * t, const mp_limb_t * n, 
+                                                   const ulong k, const mp_limb_t minv)
+{
+   ulong i;
+   mp_limb_t cy;
+
+   for (i = 0; i < k; i++)
+      t[i] = mpn_addmul_1(t + i, n, k, t[i]*minv);
+
+   cy = mpn_add_n(r, t + k, t, k);
+   if (cy || mpn_cmp(r, n, k) >= 0) mpn_sub_n(r, r, n, k);
+}
+
+/*
+   Returns a pointer to the limbs of |g| and sets *size to their number. The 
+   limb x is used to hold the value if g is small. 
+*/
+static inline
+const mp_limb_t * __F_mpz_mod_ctx_limbs(ulong * size, mp_limb_t * x, const F_mpz_t g)
+{
+   if (!COEFF_IS_MPZ(*g))
+   {
+      *x = FLINT_ABS(*g);
+      *size = (*x != 0L);
+      return x;
+   }
+
+   __mpz_struct * g_ptr = F_mpz_ptr_mpz(*g);
+   *size = FLINT_ABS(g_ptr->_mp_size);
+   return g_ptr->_mp_d;
+}
+
+void F_mpz_mod_ctx_mont_set(F_mpz_t f, const F_mpz_t g, const F_mpz_mod_ctx_t ctx)
+{
+   F_mpz_t t;
+   F_mpz_init(t);
+
+   F_mpz_mul_2exp(t, g, ctx->limbs*FLINT_BITS);
+   F_mpz_mod_ctx_reduce(f, t, ctx);
+
+   F_mpz_clear(t);
+}
+
+void F_mpz_mod_ctx_mont_redc(F_mpz_t f, const F_mpz_t g, const F_mpz_mod_ctx_t ctx)
+{
+   ulong k = ctx->limbs, gs;
+   mp_limb_t x;
+
+   if (!ctx->minv)
+   {
+      printf("FLINT Exception: Montgomery reduction requires an odd modulus\n");
+      abort();
+   }
+
+   mp_limb_t stack[F_MPZ_MOD_CTX_STACK];
+   mp_limb_t * t = (3*k <= F_MPZ_MOD_CTX_STACK) ? stack : (mp_limb_t *) malloc(sizeof(mp_limb_t)*3*k);
+   mp_limb_t * r = t + 2*k;
+
+   const mp_limb_t * gm = __F_mpz_mod_ctx_limbs(&gs, &x, g);
+   F_mpn_copy(t, gm, gs);
+   F_mpn_clear(t + gs, 2*k - gs);
+   
+   __F_mpz_mod_ctx_redc(r, t, ctx->nm, k, ctx->minv);
+
+   ulong rs = k;
+   while (rs && !r[rs - 1]) rs--;
+   __F_mpz_mod_ctx_set_limbs(f, r, rs);
+
+   if (t != stack) free(t);
+}
+
+void F_mpz_mod_ctx_mont_mul(F_mpz_t f, const F_mpz_t g, const F_mpz_t h, 
+                                                   const F_mpz_mod_ctx_t ctx)
+{
+   ulong k = ctx->limbs, gs, hs;
+   mp_limb_t x, y;
+
+   if (!ctx->minv)
+   {
+      printf("FLINT Exception: Montgomery reduction requires an odd modulus\n");
+      abort();
+   }
+
+   const mp_limb_t * gm = __F_mpz_mod_ctx_limbs(&gs, &x, g);
+   const mp_limb_t * hm = __F_mpz_mod_ctx_limbs(&hs, &y, h);
+   
+   if (gs == 0 || hs == 0) 
+   {
+      F_mpz_zero(f);
+      return;
+   }
+
+   mp_limb_t stack[F_MPZ_MOD_CTX_STACK];
+   mp_limb_t * t = (3*k <= F_MPZ_MOD_CTX_STACK) ? stack : (mp_limb_t *) malloc(sizeof(mp_limb_t)*3*k);
+   mp_limb_t * r = t + 2*k;
+
+   if (gs >= hs) mpn_mul(t, gm, gs, hm, hs);
+   else mpn_mul(t, hm, hs, gm, gs);
+   F_mpn_clear(t + gs + hs, 2*k - gs - hs);
+   
+   __F_mpz_mod_ctx_redc(r, t, ctx->nm, k, ctx->minv);
+
+   // f may alias g or h, whose limbs are no longer needed
+   ulong rs = k;
+   while (rs && !r[rs - 1]) rs--;
+   __F_mpz_mod_ctx_set_limbs(f, r, rs);
+
+   if (t != stack) free(t);
+}
+
+/*===============================================================================
+
+	Modular exponentiation
+
+================================================================================*/
+
+/*
+   Returns 1 if the exponentiation routines should work in Montgomery form.
+*/
+static inline
+int __F_mpz_powm_use_mont(const F_mpz_mod_ctx_t ctx)
+{
+   return (ctx->minv != 0L && ctx->limbs <= FLINT_F_MPZ_MONTGOMERY_CUTOFF);
+}
+
+/*
+   Set r to a*b mod n, where a and b are reduced and have k limbs, r also 
+   having k limbs. In Montgomery form if mont is set. Requires 3k + 1 limbs 
+   of scratch space t. The output may alias either input.
+*/
+static inline
+void __F_mpz_powm_mulmod(mp_limb_t * r, const mp_limb_t * a, const mp_limb_t * b, 
+                   mp_limb_t * t, const F_mpz_mod_ctx_t ctx, const int mont)
+{
+   ulong k = ctx->limbs;
+
+   if (mont && k == 1) // single limb REDC
+   {
+      mp_limb_t hi, lo, mh, ml, s, n = ctx->nm[0];
+      umul_ppmm(hi, lo, a[0], b[0]);
+      umul_ppmm(mh, ml, lo*ctx->minv, n); // lo + ml = 0 mod B
+      s = hi + (lo != 0L); // hi < n, so there is no overflow
+      r[0] = s + mh;
+      if (r[0] < s || r[0] >= n) r[0] -= n;
+      return;
+   }
+
+   if (a == b) mpn_sqr(t, a, k);
+   else mpn_mul_n(t, a, b, k);
+   
+   if (mont) __F_mpz_mod_ctx_redc(r, t, ctx->nm, k, ctx->minv);
+   else mpn_tdiv_qr(t + 2*k, r, 0, t, 2*k, ctx->nm, k);
+}
+
+/*
+   Set r to the representation of the reduced value a, i.e. a*R mod n if 
+   mont is set, otherwise a itself. Requires 3k + 1 limbs of scratch space.
+*/
+static inline
+void __F_mpz_powm_to(mp_limb_t * r, const mp_limb_t * a, mp_limb_t * t, 
+                                    const F_mpz_mod_ctx_t ctx, const int mont)
+{
+   ulong k = ctx->limbs;
+
+   if (!mont) F_mpn_copy(r, a, k);
+   else
+   {
+      F_mpn_clear(t, k);
+      F_mpn_copy(t + k, a, k);
+      mpn_tdiv_qr(t + 2*k, r, 0, t, 2*k, ctx->nm, k);
+   }
+}
+
+/*
+   Inverse of __F_mpz_powm_to.
+*/
+static inline
+void __F_mpz_powm_from(mp_limb_t * r, const mp_limb_t * a, mp_limb_t * t, 
+                                    const F_mpz_mod_ctx_t ctx, const int mont)
+{
+   ulong k = ctx->limbs;
+
+   if (!mont) F_mpn_copy(r, a, k);
+   else
+   {
+      F_mpn_copy(t, a, k);
+      F_mpn_clear(t + k, k);
+      __F_mpz_mod_ctx_redc(r, t, ctx->nm, k, ctx->minv);
+   }
+}
+
+/*
+   Returns bits j to i inclusive of the exponent with the es limbs em.
+*/
+static inline
+ulong __F_mpz_powm_bits(const mp_limb_t * em, const long i, const long j)
+{
+   ulong val = 0L;
+   long l;
+
+   for (l = i; l >= j; l--)
+      val = 2*val + ((em[l/FLINT_BITS] >> (l%FLINT_BITS)) & 1L);
+
+   return val;
+}
+
+/*
+   Window width for a sliding window exponentiation with an exponent of the
+   given number of bits, chosen to minimise the number of multiplications.
+*/
+static inline
+ulong __F_mpz_powm_window(const ulong bits)
+{
+   if (bits <= 8) return 1;
+   if (bits <= 24) return 2;
+   if (bits <= 80) return 3;
+   if (bits <= 240) return 4;
+   if (bits <= 672) return 5;
+   if (bits <= 1792) return 6;
+   return 7;
+}
+
+/*
+   Set r to b^e mod n where b is reduced and has k limbs and e > 0 has the 
+   es limbs em, the top one nonzero. The result has k limbs. Uses no F_mpz's,
+   so that it may be called from several threads at once.
+
+   For moduli of more than one limb mpz_powm is used, as its Montgomery 
+   reduction is faster than ours at all sizes. It is called on mpz's whose
+   limbs are those of the inputs.
+*/
+static
+void __F_mpz_powm_limbs(mp_limb_t * r, const mp_limb_t * b, 
+           const mp_limb_t * em, const ulong es, const F_mpz_mod_ctx_t ctx)
+{
+   ulong k = ctx->limbs, lz, i, l;
+   
+   if (k > 1)
+   {
+      __mpz_struct bz, ez, nz, rz;
+      ulong bs = k;
+      while (bs && !b[bs - 1]) bs--;
+
+      bz._mp_d = (mp_limb_t *) b;
+      bz._mp_size = bz._mp_alloc = bs;
+      ez._mp_d = (mp_limb_t *) em;
+      ez._mp_size = ez._mp_alloc = es;
+      nz._mp_d = ctx->nm;
+      nz._mp_size = nz._mp_alloc = k;
+
+      mpz_init2(&rz, k*FLINT_BITS);
+      mpz_powm(&rz, &bz, &ez, &nz);
+      F_mpn_copy(r, rz._mp_d, rz._mp_size);
+      F_mpn_clear(r + rz._mp_size, k - rz._mp_size);
+      mpz_clear(&rz);
+
+      return;
+   }
+
+   int mont = __F_mpz_powm_use_mont(ctx);
+   
+   count_lead_zeros(lz, em[es - 1]);
+   ulong bits = es*FLINT_BITS - lz;
+   ulong w = __F_mpz_powm_window(bits);
+   ulong tabsize = (1UL << (w - 1));
+
+   mp_limb_t stack[F_MPZ_MOD_CTX_STACK];
+   ulong size = (tabsize + 2)*k + 3*k + 1;
+   mp_limb_t * t = (size <= F_MPZ_MOD_CTX_STACK) ? stack : (mp_limb_t *) malloc(sizeof(mp_limb_t)*size);
+   mp_limb_t * tab = t + 3*k + 1; // odd powers b, b^3, ..., b^(2^w - 1)
+   mp_limb_t * b2 = tab + tabsize*k;
+   mp_limb_t * acc = b2 + k;
+
+   __F_mpz_powm_to(tab, b, t, ctx, mont);
+   if (tabsize > 1)
+   {
+      __F_mpz_powm_mulmod(b2, tab, tab, t, ctx, mont);
+      for (i = 1; i < tabsize; i++)
+         __F_mpz_powm_mulmod(tab + i*k, tab + (i - 1)*k, b2, t, ctx, mont);
+   }
+
+   // the first window starts at the top bit of e, which is 1
+   long j, s = bits - 1;
+   int first = 1;
+   while (s >= 0)
+   {
+      if (!((em[s/FLINT_BITS] >> (s%FLINT_BITS)) & 1L))
+      {
+         __F_mpz_powm_mulmod(acc, acc, acc, t, ctx, mont);
+         s--;
+         continue;
+      }
+
+      // longest window of at most w bits starting at bit s and ending in a 1
+      j = FLINT_MAX(s - (long) w + 1, 0L);
+      while (!((em[j/FLINT_BITS] >> (j%FLINT_BITS)) & 1L)) j++;
+      
+      mp_limb_t * p = tab + (__F_mpz_powm_bits(em, s, j) >> 1)*k;
+      if (first) 
+      {
+         F_mpn_copy(acc, p, k);
+         first = 0;
+      } else
+      {
+         for (l = 0; l < s - j + 1; l++)
+            __F_mpz_powm_mulmod(acc, acc, acc, t, ctx, mont);
+         __F_mpz_powm_mulmod(acc, acc, p, t, ctx, mont);
+      }
+
+      s = j - 1;
+   }
+
+   __F_mpz_powm_from(r, acc, t, ctx, mont);
+
+   if (t != stack) free(t);
+}
+
+/*
+   Set the k limbs r to 1 mod n. Only the limbs of n are read, so that it 
+   may be called from several threads at once.
+*/
+static inline
+void __F_mpz_powm_one(mp_limb_t * r, const F_mpz_mod_ctx_t ctx)
+{
+   F_mpn_clear(r, ctx->limbs);
+   r[0] = (ctx->limbs != 1L || ctx->nm[0] != 1L);
+}
+
+/*
+   Set b to g^sgn(e) mod n, i.e. g or its inverse, reduced. 
+*/
+static
+void __F_mpz_powm_base(F_mpz_t b, const F_mpz_t g, const F_mpz_t e, 
+                                                 const F_mpz_mod_ctx_t ctx)
+{
+   if (F_mpz_sgn(e) < 0 && !F_mpz_is_one(ctx->n))
+   {
+      if (!F_mpz_invert(b, g, ctx->n))
+      {
+         printf("FLINT Exception: base is not invertible modulo n\n");
+         abort();
+      }
+   } else F_mpz_set(b, g);
+
+   F_mpz_mod_ctx_reduce(b, b, ctx);
+}
+
+/*
+   Set f to b^e mod n where b is reduced and e, possibly zero, has the es 
+   limbs em. The output f is only written once em is no longer needed.
+*/
+static
+void __F_mpz_powm_ctx(F_mpz_t f, const F_mpz_t b, const mp_limb_t * em, 
+                                   const ulong es, const F_mpz_mod_ctx_t ctx)
+{
+   ulong k = ctx->limbs, bs;
+   mp_limb_t x;
+   
+   mp_limb_t stack[F_MPZ_MOD_CTX_STACK];
+   mp_limb_t * r = (2*k <= F_MPZ_MOD_CTX_STACK) ? stack : (mp_limb_t *) malloc(sizeof(mp_limb_t)*2*k);
+   mp_limb_t * bl = r + k;
+
+   if (es == 0) __F_mpz_powm_one(r, ctx);
+   else
+   {
+      const mp_limb_t * bm = __F_mpz_mod_ctx_limbs(&bs, &x, b);
+      F_mpn_copy(bl, bm, bs);
+      F_mpn_clear(bl + bs, k - bs);
+
+      __F_mpz_powm_limbs(r, bl, em, es, ctx);
+   }
+
+   ulong rs = k;
+   while (rs && !r[rs - 1]) rs--;
+   __F_mpz_mod_ctx_set_limbs(f, r, rs);
+
+   if (r != stack) free(r);
+}
+
+void F_mpz_powm_ctx(F_mpz_t f, const F_mpz_t g, const F_mpz_t e, 
+                                                   const F_mpz_mod_ctx_t ctx)
+{
+   ulong es;
+   mp_limb_t x;
+   F_mpz_t b;
+   
+   if (F_mpz_sgn(e) >= 0 && F_mpz_sgn(g) >= 0 && F_mpz_cmp(g, ctx->n) < 0) // g is reduced 
+   {
+      const mp_limb_t * em = __F_mpz_mod_ctx_limbs(&es, &x, e);
+      __F_mpz_powm_ctx(f, g, em, es, ctx);
+      return;
+   }
+
+   F_mpz_init(b);
+
+   __F_mpz_powm_base(b, g, e, ctx);
+
+   // f may alias e, but is only written once the exponent has been used
+   const mp_limb_t * em = __F_mpz_mod_ctx_limbs(&es, &x, e);
+   __F_mpz_powm_ctx(f, b, em, es, ctx);
+
+   F_mpz_clear(b);
+}
+
+void F_mpz_powm(F_mpz_t f, const F_mpz_t g, const F_mpz_t e, const F_mpz_t n)
+{
+   F_mpz_mod_ctx_t ctx;
+   F_mpz_mod_ctx_init(ctx, n);
+
+   F_mpz_powm_ctx(f, g, e, ctx);
+
+   F_mpz_mod_ctx_clear(ctx);
+}
+
+void F_mpz_powm_ui(F_mpz_t f, const F_mpz_t g, const ulong e, const F_mpz_t n)
+{
+   F_mpz_mod_ctx_t ctx;
+   F_mpz_mod_ctx_init(ctx, n);
+
+   F_mpz_t b;
+   F_mpz_init(b);
+   
+   F_mpz_mod_ctx_reduce(b, g, ctx);
+   __F_mpz_powm_ctx(f, b, &e, (e != 0L), ctx);
+
+   F_mpz_clear(b);
+   F_mpz_mod_ctx_clear(ctx);
+}
+
+void F_mpz_powm_fixed_init(F_mpz_powm_fixed_t pre, const F_mpz_t g, 
+                                  const ulong maxbits, const F_mpz_mod_ctx_t ctx)
+{
+   ulong k = ctx->limbs, i, j, w, bs;
+   mp_limb_t x;
+
+   // choose w to minimise the cost maxbits/w + 2^w
+   ulong best = 1, cost = maxbits + 2;
+   for (w = 2; w < 16; w++)
+   {
+      ulong c = (maxbits + w - 1)/w + (1UL << w);
+      if (c < cost) 
+      {
+         cost = c;
+         best = w;
+      }
+   }
+
+   pre->width = best;
+   pre->length = FLINT_MAX((maxbits + best - 1)/best, 1L);
+   pre->mont = __F_mpz_powm_use_mont(ctx);
+   pre->ctx = ctx;
+   pre->powers = (mp_limb_t *) malloc(sizeof(mp_limb_t)*(pre->length*k + 4*k + 1));
+   mp_limb_t * t = pre->powers + pre->length*k;
+
+   F_mpz_init(pre->g);
+   F_mpz_mod_ctx_reduce(pre->g, g, ctx);
+
+   const mp_limb_t * gm = __F_mpz_mod_ctx_limbs(&bs, &x, pre->g);
+   F_mpn_copy(t, gm, bs);
+   F_mpn_clear(t + bs, k - bs);
+   __F_mpz_powm_to(pre->powers, t, t + k, ctx, pre->mont);
+   
+   for (i = 1; i < pre->length; i++)
+   {
+      mp_limb_t * p = pre->powers + i*k;
+      __F_mpz_powm_mulmod(p, p - k, p - k, t, ctx, pre->mont);
+      for (j = 1; j < best; j++)
+         __F_mpz_powm_mulmod(p, p, p, t, ctx, pre->mont);
+   }
+}
+
+void F_mpz_powm_fixed_clear(F_mpz_powm_fixed_t pre)
+{
+   F_mpz_clear(pre->g);
+   free(pre->powers);
+}
+
+/*
+   This is the method of Brickell, Gordon, McCurley and Wilson. Writing 
+   e = sum_i d_i 2^(i*w) with digits 0 <= d_i < 2^w, and G_i = g^(2^(i*w)),
+   g^e = prod_{d = 1}^{2^w - 1} B_d where B_d is the product of the G_i with 
+   d_i >= d. The running products B_d and their product are both accumulated
+   starting at the largest digit, so that no squarings are needed.
+*/
+void F_mpz_powm_fixed(F_mpz_t f, const F_mpz_t e, const F_mpz_powm_fixed_t pre)
+{
+   const F_mpz_mod_ctx_struct * ctx = pre->ctx;
+   ulong k = ctx->limbs, w = pre->width, es, i;
+   long d;
+   mp_limb_t x;
+
+   if (F_mpz_sgn(e) < 0 || F_mpz_bits(e) > pre->length*w)
+   {
+      F_mpz_powm_ctx(f, pre->g, e, ctx);
+      return;
+   }
+   
+   if (F_mpz_is_zero(e))
+   {
+      F_mpz_set_ui(f, !F_mpz_is_one(ctx->n));
+      return;
+   }
+
+   const mp_limb_t * em = __F_mpz_mod_ctx_limbs(&es, &x, e);
+   ulong digits = (F_mpz_bits(e) + w - 1)/w;
+   
+   // bucket the digits, head[d] is the first i with d_i = d and next[i] the following one
+   long * head = (long *) malloc(sizeof(long)*((1UL << w) + digits));
+   long * next = head + (1UL << w);
+   for (d = 0; d < (1L << w); d++) head[d] = -1L;
+   for (i = 0; i < digits; i++)
+   {
+      ulong top = FLINT_MIN((i + 1)*w, es*FLINT_BITS) - 1;
+      d = __F_mpz_powm_bits(em, top, i*w);
+      next[i] = head[d];
+      head[d] = i;
+   }
+
+   mp_limb_t * t = (mp_limb_t *) malloc(sizeof(mp_limb_t)*(5*k + 1));
+   mp_limb_t * A = t + 3*k + 1;
+   mp_limb_t * B = A + k;
+   int A_set = 0, B_set = 0;
+
+   for (d = (1L << w) - 1; d >= 1; d--)
+   {
+      for (i = head[d]; i != -1L; i = next[i])
+      {
+         if (B_set) __F_mpz_powm_mulmod(B, B, pre->powers + i*k, t, ctx, pre->mont);
+         else 
+         {
+            F_mpn_copy(B, pre->powers + i*k, k);
+            B_set = 1;
+         }
+      }
+
+      if (B_set)
+      {
+         if (A_set) __F_mpz_powm_mulmod(A, A, B, t, ctx, pre->mont);
+         else
+         {
+            F_mpn_copy(A, B, k);
+            A_set = 1;
+         }
+      }
+   }
+
+   // e is nonzero, so A is set
+   __F_mpz_powm_from(B, A, t, ctx, pre->mont);
+   
+   ulong rs = k;
+   while (rs && !B[rs - 1]) rs--;
+   __F_mpz_mod_ctx_set_limbs(f, B, rs);
+
+   free(t);
+   free(head);
+}
+
+void F_mpz_powm_batch(F_mpz * res, const F_mpz * bases, const F_mpz * exps, 
+                                    const ulong num, const F_mpz_mod_ctx_t ctx)
+{
+   ulong k = ctx->limbs, i, bs;
+   long j;
+   mp_limb_t x;
+
+   if (num == 0) return;
+
+   mp_limb_t * r = (mp_limb_t *) malloc(sizeof(mp_limb_t)*(2*num*k + num));
+   mp_limb_t * b = r + num*k;
+   mp_limb_t * e_small = b + num*k;
+   const mp_limb_t ** em = (const mp_limb_t **) malloc(sizeof(mp_limb_t *)*num);
+   ulong * es = (ulong *) malloc(sizeof(ulong)*num);
+
+   // reduce the bases first, as this may move the limbs of the exponents
+   F_mpz_t t;
+   F_mpz_init(t);
+   for (i = 0; i < num; i++)
+   {
+      __F_mpz_powm_base(t, bases + i, exps + i, ctx);
+      const mp_limb_t * bm = __F_mpz_mod_ctx_limbs(&bs, &x, t);
+      F_mpn_copy(b + i*k, bm, bs);
+      F_mpn_clear(b + i*k + bs, k - bs);
+   }
+   F_mpz_clear(t);
+
+   for (i = 0; i < num; i++)
+      em[i] = __F_mpz_mod_ctx_limbs(es + i, e_small + i, exps + i);
+   
+   /* 
+      The parallel section works only with the limbs gathered above, the 
+      limbs of n in ctx and mpz's of its own, so no F_mpz is read or written 
+      while the threads run. The limbs of the exponents cannot move, as no 
+      F_mpz is allocated.
+   */
+#pragma omp parallel for
+   for (j = 0; j < num; j++)
+   {
+      if (es[j]) __F_mpz_powm_limbs(r + j*k, b + j*k, em[j], es[j], ctx);
+      else __F_mpz_powm_one(r + j*k, ctx);
+   }
+
+   for (i = 0; i < num; i++)
+   {
+      ulong rs = k;
+      while (rs && !r[i*k + rs - 1]) rs--;
+      __F_mpz_mod_ctx_set_limbs(res + i, r + i*k, rs);
+   }
+
+   free(es);
+   free(em);
+   free(r);
+}
+
 void F_mpz_comb_init(F_mpz_comb_t comb, ulong * primes, ulong num_primes)
 {
    ulong i, j, k;
@@ -38,6 +38,7 @@
 #endif
 #include "flint.h"
 #include "mpn_extras.h"
+#include "flint-tuning.h"
 #include "zn_poly/src/zn_poly.h"
 
 
@@ -83,6 +84,30 @@ typedef struct
 
 typedef F_mpz_comb_struct F_mpz_comb_t[1];
 
+typedef struct
+{
+   F_mpz_t n; // the modulus, n > 0
+   ulong limbs; // number of limbs of n
+   mp_limb_t * nm; // limbs of n
+   mp_limb_t minv; // -1/n mod B for Montgomery reduction, zero if n is even
+} F_mpz_mod_ctx_struct;
+
+typedef F_mpz_mod_ctx_struct F_mpz_mod_ctx_t[1];
+
+#define FLINT_F_MPZ_MONTGOMERY_CUTOFF (flint_tuning.F_mpz_montgomery_thresh) // maximum number of limbs of n for which F_mpz_powm_fixed uses Montgomery multiplication
+
+typedef struct
+{
+   mp_limb_t * powers; // g^(2^(i*width)) mod n for 0 <= i < length, limbs each, Montgomery form if mont
+   ulong length; // number of powers
+   ulong width; // number of bits of exponent per power
+   int mont; // whether the powers are in Montgomery form
+   F_mpz_t g; // the base, reduced mod n
+   const F_mpz_mod_ctx_struct * ctx; // the modulus context, which must outlive the table
+} F_mpz_powm_fixed_struct;
+
+typedef F_mpz_powm_fixed_struct F_mpz_powm_fixed_t[1];
+
 #define FLINT_F_MPZ_LOG_MULTI_MOD_CUTOFF 2
 
 /*===============================================================================
@@ -267,6 +292,13 @@ void F_mpz_get_mpz(mpz_t x, const F_mpz_t f);
 */
 double F_mpz_get_d_2exp(long * exp, const F_mpz_t f);
 
+/** 
+   \fn     long double F_mpz_get_ld_2exp(long * exp, const F_mpz_t f)
+   \brief  Return f as a signed normalised long double and a long exponent.
+           The top FLINT_BITS bits of f are used.
+*/
+long double F_mpz_get_ld_2exp(long * exp, const F_mpz_t f);
+
 /** 
    \fn     double F_mpz_get_d(const F_mpz_t f)
    \brief  Return f as a signed double. The usual exponent limits for
@@ -481,6 +513,29 @@ void F_mpz_sscanf(F_mpz_t f, char * str)
    _F_mpz_demote_val(f);
 }
 
+/*
+   Binary format for vectors of F_mpz's (see mpn_extras.h for the file 
+   header). Each integer in the range of a small F_mpz is stored inline as 
+   the F_mpz itself, so that a vector of small integers is stored as is. 
+   Any other integer is stored as a limb F_MPZ_BIN_LARGE + size, plus 
+   F_MPZ_BIN_NEG if it is negative, followed by the size limbs of its 
+   absolute value, least significant first.
+*/
+
+#define F_MPZ_BIN_LARGE (1UL<<(FLINT_BITS-2))
+#define F_MPZ_BIN_NEG (1UL<<(FLINT_BITS-3))
+
+/** 
+   \fn     int F_mpz_bin_is_small(mp_limb_t x)
+   \brief  Returns 1 if x is an integer stored inline, i.e. a valid small
+           F_mpz, otherwise 0.
+*/
+static inline
+int F_mpz_bin_is_small(mp_limb_t x)
+{
+   return (x + (ulong) COEFF_MAX <= 2*(ulong) COEFF_MAX);
+}
+
 /*===============================================================================
 
 	Arithmetic
@@ -704,6 +759,175 @@ void F_mpz_mulmod2(F_mpz_t f, const F_mpz_t g, const F_mpz_t h, const F_mpz_t p)
    F_mpz_mod(f, f, p);
 }
 
+/*===============================================================================
+
+	Modulus contexts
+
+================================================================================*/
+
+/** 
+   \fn     void F_mpz_mod_ctx_init(F_mpz_mod_ctx_t ctx, const F_mpz_t n)
+   \brief  Initialise a context for arithmetic modulo n > 0. If n is odd this
+           precomputes -1/n mod B for Montgomery reduction, where B = 2^FLINT_BITS.
+*/
+void F_mpz_mod_ctx_init(F_mpz_mod_ctx_t ctx, const F_mpz_t n);
+
+/** 
+   \fn     void F_mpz_mod_ctx_clear(F_mpz_mod_ctx_t ctx)
+   \brief  Release the memory used by the context.
+*/
+void F_mpz_mod_ctx_clear(F_mpz_mod_ctx_t ctx);
+
+/** 
+   \fn     void F_mpz_mod_ctx_reduce(F_mpz_t f, const F_mpz_t g, 
+                                                  const F_mpz_mod_ctx_t ctx)
+   \brief  Set f to g mod n, in [0, n). There is no restriction on the size
+           or sign of g, so that sums of products may be accumulated and
+           reduced only once (lazy reduction). The division is done directly 
+           on the limbs of g and n.
+*/
+void F_mpz_mod_ctx_reduce(F_mpz_t f, const F_mpz_t g, const F_mpz_mod_ctx_t ctx);
+
+/** 
+   \fn     void F_mpz_mod_ctx_mulmod(F_mpz_t f, const F_mpz_t g, 
+                                   const F_mpz_t h, const F_mpz_mod_ctx_t ctx)
+   \brief  Set f to g*h mod n, in [0, n).
+*/
+void F_mpz_mod_ctx_mulmod(F_mpz_t f, const F_mpz_t g, const F_mpz_t h, 
+                                                   const F_mpz_mod_ctx_t ctx);
+
+/** 
+   \fn     void F_mpz_mod_ctx_addmod(F_mpz_t f, const F_mpz_t g, 
+                                   const F_mpz_t h, const F_mpz_mod_ctx_t ctx)
+   \brief  Set f to g + h mod n, assuming g and h are in [0, n).
+*/
+static inline
+void F_mpz_mod_ctx_addmod(F_mpz_t f, const F_mpz_t g, const F_mpz_t h, 
+                                                   const F_mpz_mod_ctx_t ctx)
+{
+   F_mpz_add(f, g, h);
+   if (F_mpz_cmp(f, ctx->n) >= 0) F_mpz_sub(f, f, ctx->n);
+}
+
+/** 
+   \fn     void F_mpz_mod_ctx_submod(F_mpz_t f, const F_mpz_t g, 
+                                   const F_mpz_t h, const F_mpz_mod_ctx_t ctx)
+   \brief  Set f to g - h mod n, assuming g and h are in [0, n).
+*/
+static inline
+void F_mpz_mod_ctx_submod(F_mpz_t f, const F_mpz_t g, const F_mpz_t h, 
+                                                   const F_mpz_mod_ctx_t ctx)
+{
+   F_mpz_sub(f, g, h);
+   if (F_mpz_sgn(f) < 0) F_mpz_add(f, f, ctx->n);
+}
+
+/** 
+   \fn     void F_mpz_mod_ctx_mont_set(F_mpz_t f, const F_mpz_t g, 
+                                                  const F_mpz_mod_ctx_t ctx)
+   \brief  Set f to the Montgomery form g*R mod n of g, where R = B^limbs. 
+           Any g is allowed. The modulus must be odd.
+*/
+void F_mpz_mod_ctx_mont_set(F_mpz_t f, const F_mpz_t g, const F_mpz_mod_ctx_t ctx);
+
+/** 
+   \fn     void F_mpz_mod_ctx_mont_redc(F_mpz_t f, const F_mpz_t g, 
+                                                  const F_mpz_mod_ctx_t ctx)
+   \brief  Set f to g/R mod n, in [0, n), where R = B^limbs and 0 <= g < n*R. 
+           In particular this converts g in [0, n) out of Montgomery form. 
+           The modulus must be odd.
+*/
+void F_mpz_mod_ctx_mont_redc(F_mpz_t f, const F_mpz_t g, const F_mpz_mod_ctx_t ctx);
+
+/** 
+   \fn     void F_mpz_mod_ctx_mont_mul(F_mpz_t f, const F_mpz_t g, 
+                                   const F_mpz_t h, const F_mpz_mod_ctx_t ctx)
+   \brief  Set f to g*h/R mod n, in [0, n), where R = B^limbs, i.e. multiply
+           two values in Montgomery form. Assumes g and h are in [0, n). The
+           modulus must be odd. The reduction is quadratic in the number of
+           limbs, so this is only faster than F_mpz_mod_ctx_mulmod for moduli 
+           of up to about FLINT_F_MPZ_MONTGOMERY_CUTOFF limbs.
+*/
+void F_mpz_mod_ctx_mont_mul(F_mpz_t f, const F_mpz_t g, const F_mpz_t h, 
+                                                   const F_mpz_mod_ctx_t ctx);
+
+/*===============================================================================
+
+	Modular exponentiation
+
+================================================================================*/
+
+/** 
+   \fn     void F_mpz_powm_ctx(F_mpz_t f, const F_mpz_t g, const F_mpz_t e, 
+                                                  const F_mpz_mod_ctx_t ctx)
+   \brief  Set f to g^e mod n, in [0, n). If e is negative, g must be invertible
+           modulo n, otherwise an exception is raised. For n of a single limb 
+           a left-to-right sliding window is used, with the window width chosen 
+           from the number of bits of e, and Montgomery multiplication if n is
+           odd. Larger moduli are dealt with by mpz_powm, which is faster than 
+           our Montgomery multiplication at all sizes.
+*/
+void F_mpz_powm_ctx(F_mpz_t f, const F_mpz_t g, const F_mpz_t e, 
+                                                   const F_mpz_mod_ctx_t ctx);
+
+/** 
+   \fn     void F_mpz_powm(F_mpz_t f, const F_mpz_t g, const F_mpz_t e, 
+                                                           const F_mpz_t n)
+   \brief  Set f to g^e mod n, in [0, n), where n > 0. If e is negative, g must 
+           be invertible modulo n. When many exponentiations are done with the 
+           same modulus, F_mpz_powm_ctx avoids setting up the context each time.
+*/
+void F_mpz_powm(F_mpz_t f, const F_mpz_t g, const F_mpz_t e, const F_mpz_t n);
+
+/** 
+   \fn     void F_mpz_powm_ui(F_mpz_t f, const F_mpz_t g, const ulong e, 
+                                                           const F_mpz_t n)
+   \brief  Set f to g^e mod n, in [0, n), where n > 0.
+*/
+void F_mpz_powm_ui(F_mpz_t f, const F_mpz_t g, const ulong e, const F_mpz_t n);
+
+/** 
+   \fn     void F_mpz_powm_fixed_init(F_mpz_powm_fixed_t pre, const F_mpz_t g, 
+                                   const ulong maxbits, const F_mpz_mod_ctx_t ctx)
+   \brief  Precompute a table of powers g^(2^(i*w)) mod n for raising the fixed
+           base g to exponents of up to maxbits bits. The width w is chosen to 
+           minimise the number of multiplications, which is about 
+           maxbits/w + 2^w per exponentiation, with no squarings. The context 
+           must not be cleared before the table.
+*/
+void F_mpz_powm_fixed_init(F_mpz_powm_fixed_t pre, const F_mpz_t g, 
+                                 const ulong maxbits, const F_mpz_mod_ctx_t ctx);
+
+/** 
+   \fn     void F_mpz_powm_fixed_clear(F_mpz_powm_fixed_t pre)
+   \brief  Release the memory used by the table.
+*/
+void F_mpz_powm_fixed_clear(F_mpz_powm_fixed_t pre);
+
+/** 
+   \fn     void F_mpz_powm_fixed(F_mpz_t f, const F_mpz_t e, 
+                                            const F_mpz_powm_fixed_t pre)
+   \brief  Set f to g^e mod n, in [0, n), where g and n are those of the table.
+           Exponents which are negative or have more than maxbits bits are 
+           dealt with by F_mpz_powm_ctx.
+*/
+void F_mpz_powm_fixed(F_mpz_t f, const F_mpz_t e, const F_mpz_powm_fixed_t pre);
+
+/** 
+   \fn     void F_mpz_powm_batch(F_mpz * res, const F_mpz * bases, 
+                      const F_mpz * exps, const ulong num, const F_mpz_mod_ctx_t ctx)
+   \brief  Set res[i] to bases[i]^exps[i] mod n for 0 <= i < num. The 
+           exponentiations are done in parallel if FLINT is built with OpenMP.
+           As F_mpz's are not thread safe, the bases are reduced and the 
+           results are set serially, only the exponentiations on the limbs 
+           being done by several threads. As for F_mpz_powm_ctx, each 
+           exponentiation modulo an n of more than one limb is simply done 
+           by mpz_powm, there is no multi-limb Montgomery code of our own.
+           The output may alias either input.
+*/
+void F_mpz_powm_batch(F_mpz * res, const F_mpz * bases, const F_mpz * exps, 
+                                   const ulong num, const F_mpz_mod_ctx_t ctx);
+
 /*===============================================================================
 
 	Multimodular routines
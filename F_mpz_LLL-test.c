@@ -622,6 +622,133 @@ int test_F_mpz_LLL_randintrel()
    return result;
 }
 
+int test_F_mpz_LLL_recursive()
+{
+   mpz_mat_t m_mat;
+   F_mpz_mat_t F_mat;
+   int result = 1;
+   ulong bits;
+   F_mpz_t fzero;
+   F_mpz_init(fzero);
+   
+   ulong count1;
+   for (count1 = 0; (count1 < 50*ITER) && (result == 1) ; count1++)
+   {
+#if TRACE
+      printf("count1 == %ld\n", count1);
+#endif
+      ulong r = z_randint(10)+1;
+      ulong c = r + 1;
+
+      F_mpz_mat_init(F_mat, r, c);
+
+      mpz_mat_init(m_mat, r, c);
+
+      bits = z_randint(2000) + 1;
+      
+      mpz_mat_randintrel(m_mat, r, c, bits);
+           
+      mpz_mat_to_F_mpz_mat(F_mat, m_mat);
+      
+      F_mpz_set_d_2exp(fzero, 2.0, bits);
+
+      if (z_randint(2)) 
+         LLL_recursive(F_mat, 60);
+      else
+         LLL_recursive_with_removal(F_mat, 60, fzero);
+
+      mp_prec_t prec;
+      prec = 20;
+
+      __mpfr_struct ** Q, ** R;
+
+      Q = mpfr_mat_init2(r, c, prec);
+      R = mpfr_mat_init2(r, r, prec);
+
+      F_mpz_mat_RQ_factor(F_mat, R, Q, r, c, prec); 
+
+      result = mpfr_mat_R_reduced(R, r, (double) DELTA, (double) ETA, prec);
+
+      mpfr_mat_clear(Q, r, c);
+      mpfr_mat_clear(R, r, r);
+          
+      if (!result) 
+      {
+         F_mpz_mat_print_pretty(F_mat);
+         printf("Error: bits = %ld, count1 = %ld\n", bits, count1);
+      }
+          
+      F_mpz_mat_clear(F_mat);
+      mpz_mat_clear(m_mat);
+   }
+
+   F_mpz_clear(fzero);
+   return result;
+}
+
+int test_F_mpz_LLL_householder()
+{
+   mpz_mat_t m_mat;
+   F_mpz_mat_t F_mat;
+   int result = 1, res;
+   ulong bits;
+   
+   ulong count1;
+   for (count1 = 0; (count1 < 100*ITER) && (result == 1) ; count1++)
+   {
+#if TRACE
+      printf("count1 == %ld\n", count1);
+#endif
+      ulong r = z_randint(20)+1;
+      ulong c = r + 1;
+
+      F_mpz_mat_init(F_mat, r, c);
+
+      mpz_mat_init(m_mat, r, c);
+
+      bits = z_randint(200) + 1;
+      
+      mpz_mat_randintrel(m_mat, r, c, bits);
+           
+      mpz_mat_to_F_mpz_mat(F_mat, m_mat);
+      
+      if (z_randint(2)) 
+         res = LLL_householder_d(F_mat);
+      else
+         res = LLL_householder_ld(F_mat);
+
+      // if there was insufficient precision, finish the job
+      if (res == -1) 
+         LLL_wrapper(F_mat);
+      
+      mp_prec_t prec;
+      prec = 20;
+
+      __mpfr_struct ** Q, ** R;
+
+      Q = mpfr_mat_init2(r, c, prec);
+      R = mpfr_mat_init2(r, r, prec);
+
+      F_mpz_mat_RQ_factor(F_mat, R, Q, r, c, prec); 
+
+      result = mpfr_mat_R_reduced(R, r, (double) DELTA, (double) ETA, prec);
+
+      mpfr_mat_clear(Q, r, c);
+      mpfr_mat_clear(R, r, r);
+          
+      if (!result) 
+      {
+         F_mpz_mat_print_pretty(F_mat);
+         printf("Error: bits = %ld, count1 = %ld\n", bits, count1);
+      }
+          
+      F_mpz_mat_clear(F_mat);
+      mpz_mat_clear(m_mat);
+   }
+
+   return result;
+}
+
 int test_F_mpz_LLL_randajtai()
 {
    mpz_mat_t m_mat;
@@ -785,6 +912,8 @@ void F_mpz_mat_test_all()
    RUN_TEST(heuristic_scalar_product);
    RUN_TEST(F_mpz_LLL_randajtai);
    RUN_TEST(F_mpz_LLL_randintrel);
+   RUN_TEST(F_mpz_LLL_recursive);
+   RUN_TEST(F_mpz_LLL_householder);
    RUN_TEST(F_mpz_LLL_randsimdioph);
    RUN_TEST(F_mpz_LLL_randntrulike);
 
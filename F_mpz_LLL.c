@@ -195,24 +195,11 @@ int check_Babai (int kappa, F_mpz_mat_t B, double **mu, double **r, double *s,
 #endif
 	      }
 	  	  
-          if (j > zeros + 2)
-	      {
-	         tmp = mu[j][zeros+1] * r[kappa][zeros+1];
-	         rtmp = appSP[kappa][j] - tmp;
-	         
-			 for (k = zeros + 2; k < j - 1; k++)
-		      {
-		         tmp = mu[j][k] * r[kappa][k];
-		         rtmp = rtmp - tmp;
-		      }
-	         
-			 tmp = mu[j][j-1] * r[kappa][j-1];
-	         r[kappa][j] = rtmp - tmp;
-          } else if (j == zeros+2)
-	      {
-	         tmp = mu[j][zeros+1] * r[kappa][zeros+1];
-	         r[kappa][j] = appSP[kappa][j] - tmp;
-	      } else r[kappa][j] = appSP[kappa][j];
+          if (j > zeros + 1)
+          {
+             tmp = _d_vec_scalar_product(mu[j] + zeros + 1, r[kappa] + zeros + 1, j - zeros - 1);
+             r[kappa][j] = appSP[kappa][j] - tmp;
+          } else r[kappa][j] = appSP[kappa][j];
 
 	      mu[kappa][j] = r[kappa][j] / r[j][j];
       }
@@ -518,23 +505,11 @@ int check_Babai_heuristic_d (int kappa, F_mpz_mat_t B, double **mu, double **r,
 #endif
          }
 	  	  
-         if (j > zeros + 2)
-	     {
-	        tmp = mu[j][zeros+1] * r[kappa][zeros+1];
-	        rtmp = appSP[kappa][j] - tmp;
-	        for (k = zeros + 2; k < j - 1; k++)
-		    {
-		       tmp = mu[j][k] * r[kappa][k];
-		       rtmp = rtmp - tmp;
-		    }
-	        
-			tmp = mu[j][j-1] * r[kappa][j-1];
-	        r[kappa][j] = rtmp - tmp;
-         } else if (j == zeros+2)
-	     {
-	        tmp = mu[j][zeros+1] * r[kappa][zeros+1];
-	        r[kappa][j] = appSP[kappa][j] - tmp;
-	     } else r[kappa][j] = appSP[kappa][j];
+         if (j > zeros + 1)
+         {
+            tmp = _d_vec_scalar_product(mu[j] + zeros + 1, r[kappa] + zeros + 1, j - zeros - 1);
+            r[kappa][j] = appSP[kappa][j] - tmp;
+         } else r[kappa][j] = appSP[kappa][j];
 
 	     mu[kappa][j] = r[kappa][j] / r[j][j];
       }
@@ -1093,24 +1068,11 @@ int advance_check_Babai (int cur_kappa, int kappa, F_mpz_mat_t B, double **mu, d
 	         appSP[kappa][j] = _d_vec_scalar_product(appB[kappa], appB[j], n);
 	      }
 	  	  
-          if (j > zeros + 2)
-	      {
-	         tmp = mu[j][zeros+1] * r[kappa][zeros+1];
-	         rtmp = appSP[kappa][j] - tmp;
-	         
-			 for (k = zeros + 2; k < j - 1; k++)
-		     {
-		         tmp = mu[j][k] * r[kappa][k];
-		         rtmp = rtmp - tmp;
-		     }
-	         
-			 tmp = mu[j][j-1] * r[kappa][j-1];
-	         r[kappa][j] = rtmp - tmp;
-          } else if (j == zeros+2)
-	      {
-	         tmp = mu[j][zeros+1] * r[kappa][zeros+1];
-	         r[kappa][j] = appSP[kappa][j] - tmp;
-	      } else r[kappa][j] = appSP[kappa][j];
+          if (j > zeros + 1)
+          {
+             tmp = _d_vec_scalar_product(mu[j] + zeros + 1, r[kappa] + zeros + 1, j - zeros - 1);
+             r[kappa][j] = appSP[kappa][j] - tmp;
+          } else r[kappa][j] = appSP[kappa][j];
 
 	      mu[kappa][j] = r[kappa][j] / r[j][j];
       }
@@ -1293,24 +1255,11 @@ int advance_check_Babai_heuristic_d (int cur_kappa, int kappa, F_mpz_mat_t B, do
 //---------------------------
          }
 	  	  
-         if (j > zeros + 2)
-	     {
-	         tmp = mu[j][zeros+1] * r[kappa][zeros+1];
-	         rtmp = appSP[kappa][j] - tmp;
-	         
-			 for (k = zeros + 2; k < j - 1; k++)
-		     {
-		        tmp = mu[j][k] * r[kappa][k];
-		        rtmp = rtmp - tmp;
-		     }
-	         
-			 tmp = mu[j][j-1] * r[kappa][j-1];
-	         r[kappa][j] = rtmp - tmp;
-         } else if (j == zeros+2)
-	     {
-	         tmp = mu[j][zeros+1] * r[kappa][zeros+1];
-	         r[kappa][j] = appSP[kappa][j] - tmp;
-	     } else r[kappa][j] = appSP[kappa][j];
+         if (j > zeros + 1)
+         {
+            tmp = _d_vec_scalar_product(mu[j] + zeros + 1, r[kappa] + zeros + 1, j - zeros - 1);
+            r[kappa][j] = appSP[kappa][j] - tmp;
+         } else r[kappa][j] = appSP[kappa][j];
 
 	     mu[kappa][j] = r[kappa][j] / r[j][j];
       }
@@ -1662,24 +1611,11 @@ int check_Babai_heuristic_d_zero_vec (int kappa, F_mpz_mat_t B, double **mu, dou
 //---------------------------
           }
 	  	  
-          if (j > zeros + 2)
-	      {
-	          tmp = mu[j][zeros+1] * r[kappa][zeros+1];
-	          rtmp = appSP[kappa][j] - tmp;
-	          
-			  for (k = zeros + 2; k < j - 1; k++)
-		      {
-		         tmp = mu[j][k] * r[kappa][k];
-		         rtmp = rtmp - tmp;
-		      }
-	          
-			  tmp = mu[j][j-1] * r[kappa][j-1];
-	          r[kappa][j] = rtmp - tmp;
-          } else if (j == zeros+2)
-	      {
-	          tmp = mu[j][zeros+1] * r[kappa][zeros+1];
-	          r[kappa][j] = appSP[kappa][j] - tmp;
-	      } else r[kappa][j] = appSP[kappa][j];
+          if (j > zeros + 1)
+          {
+             tmp = _d_vec_scalar_product(mu[j] + zeros + 1, r[kappa] + zeros + 1, j - zeros - 1);
+             r[kappa][j] = appSP[kappa][j] - tmp;
+          } else r[kappa][j] = appSP[kappa][j];
 
 	      mu[kappa][j] = r[kappa][j] / r[j][j];
       }
@@ -2500,9 +2436,472 @@ int LLL_mpfr(F_mpz_mat_t B)
       return -1;
 }
 
+/****************************************************************************
+
+   Householder LLL
+
+   The following is the LLL of Morel, Stehl and Villard ("H-LLL: Using 
+   Householder inside LLL", ISSAC 2009). Instead of computing the Gram-Schmidt 
+   data from the (approximate) Gram matrix as check_Babai does, the R factor of 
+   the QR factorisation of the basis is computed directly from the rows of B 
+   using Householder reflections, which is numerically much more stable. Thus 
+   the doubles version succeeds for many lattices where LLL_d needs to fall 
+   back to mpfr. 
+
+   As with appB in LLL_d, each row of R is stored as a vector of mantissas with
+   a single exponent expo[i] for the whole row. Reflections act on columns so 
+   they are not affected by this scaling. The reflections used for rows 
+   zeros + 1, ..., kappa - 1 are stored in V, normalised to have norm 2, and 
+   the first nonzero entry of the reflection for row i is in column 
+   i - zeros - 1. 
+
+****************************************************************************/
+
+/*
+   Computes the Householder reflection for row kappa of R, which must already
+   have had the reflections for the previous rows applied, and stores it in
+   V[kappa]. The entries of R[kappa] from column c onwards are replaced with 
+   those of the triangular factor.
+*/
+
+void householder_d_reflection(double ** R, double ** V, int kappa, int c, int n)
+{
+   int k;
+   double sigma, t;
+
+   sigma = sqrt(_d_vec_norm(R[kappa] + c, n - c));
+   
+   if (sigma == 0.0)
+   {
+      for (k = c; k < n; k++) V[kappa][k] = 0.0;
+      return;
+   }
+
+   if (R[kappa][c] < 0.0) sigma = -sigma;
+  
+   // v = x + sigma*e_1 scaled to have norm 2, so that x*(I - v*v^T) = (-sigma, 0, ..., 0)
+   for (k = c; k < n; k++) V[kappa][k] = R[kappa][k];
+   V[kappa][c] += sigma;
+
+   t = sqrt(1.0/(sigma*V[kappa][c]));
+   for (k = c; k < n; k++) V[kappa][k] *= t;
+
+   R[kappa][c] = -sigma;
+   for (k = c + 1; k < n; k++) R[kappa][k] = 0.0;
+}
+
+/*
+   Size reduces row kappa of B by the previous rows, using the Householder 
+   data in R and V. On exit R[kappa] contains the row kappa of the R factor 
+   and V[kappa] the corresponding reflection. Returns -1 if the size reduction 
+   does not converge, which indicates insufficient precision.
+*/
+
+int householder_d_size_reduce(int kappa, F_mpz_mat_t B, double ** R, double ** V,
+                                                 long * expo, int zeros, int n, double eta)
+{
+   int j, c, cj, ex, test;
+   long xx, e;
+   double mu, tmp;
+
+   c = kappa - zeros - 1;
+   long loops = 0;
+
+   do
+   {
+      test = 0;
+      
+      loops++;
+      if (loops > 200) return -1;
+
+      expo[kappa] = _F_mpz_vec_to_d_vec_2exp(R[kappa], B->rows[kappa], n);
+      for (j = zeros + 1; j < kappa; j++)
+      {
+         cj = j - zeros - 1;
+         _d_vec_reflect(R[kappa] + cj, V[j] + cj, n - cj);
+      }
+
+      for (j = kappa - 1; j > zeros; j--)
+      {
+         cj = j - zeros - 1;
+         
+         if (R[j][cj] == 0.0) continue;
+
+         mu = R[kappa][cj] / R[j][cj];
+         if (mu != mu) return -1; // NaN
+
+         tmp = frexp(mu, &ex);
+         e = ex + expo[kappa] - expo[j]; // mu_true = tmp*2^e
+
+         if (tmp == 0.0 || e < 0 || (e == 0 && fabs(tmp) <= eta)) continue; // |mu_true| <= eta
+         
+         test = 1;
+
+         // X = xx*2^e is the nearest integer to mu_true (to 53 bits)
+         if (e <= CPU_SIZE_1)
+         {
+            xx = (long) rint(ldexp(tmp, e));
+            e = 0;
+         } else
+         {
+            xx = (long) (tmp * MAX_LONG);
+            e -= CPU_SIZE_1;
+         }
+
+         if (xx == 0L) continue;
+
+         if (e == 0)
+         {
+            if (xx == 1L) _F_mpz_vec_sub(B->rows[kappa], B->rows[kappa], B->rows[j], n);
+            else if (xx == -1L) _F_mpz_vec_add(B->rows[kappa], B->rows[kappa], B->rows[j], n);
+            else if (xx > 0L) _F_mpz_vec_submul_ui(B->rows[kappa], B->rows[j], n, (ulong) xx);
+            else _F_mpz_vec_addmul_ui(B->rows[kappa], B->rows[j], n, (ulong) -xx);
+         } else
+         {
+            if (xx > 0L) _F_mpz_vec_submul_2exp_ui(B->rows[kappa], B->rows[j], n, (ulong) xx, e);
+            else _F_mpz_vec_addmul_2exp_ui(B->rows[kappa], B->rows[j], n, (ulong) -xx, e);
+         }
+
+         // update the remaining entries of R[kappa] which will be used this pass
+         tmp = ldexp((double) xx, e + expo[j] - expo[kappa]);
+         _d_vec_addmul(R[kappa], R[j], cj + 1, -tmp);
+      }
+   } while (test);
+
+   householder_d_reflection(R, V, kappa, c, n);
+
+   return 0;
+}
+
+/* 
+   LLL reduces B in place using Householder reflections with doubles. Returns
+   0 on success and -1 if the precision was insufficient.
+*/
+
+int LLL_householder_d(F_mpz_mat_t B)
+{
+   int kappa, d, n, i, zeros, c, ok = 0;
+   double ** R, ** V;
+   double * Rtmp, eta, delta, tmp, tmp2;
+   long * expo, etmp;
+   F_mpz * Btmp;
+   
+   n = B->c;
+   d = B->r;
+
+   if (d == 0) return 0;
+   
+   delta = (4*DELTA + 1)/5;
+   eta = (4*ETA + .5)/5;
+
+   expo = (long *) malloc(d * sizeof(long)); 
+   R = d_mat_init(d, n);
+   V = d_mat_init(d, n);
+
+   zeros = -1;
+   kappa = 0;
+
+   while (kappa < d)
+   {
+      if (householder_d_size_reduce(kappa, B, R, V, expo, zeros, n, eta) == -1)
+      {
+         ok = -1;
+         break;
+      }
+
+      c = kappa - zeros - 1;
+
+      // if row kappa is now zero, move it to the front
+      for (i = 0; i < n && F_mpz_is_zero(B->rows[kappa] + i); i++) ;
+      if (i == n)
+      {
+         Btmp = B->rows[kappa];
+         Rtmp = R[kappa];
+         for (i = kappa; i > zeros + 1; i--) 
+         {
+            B->rows[i] = B->rows[i - 1];
+            R[i] = R[i - 1];
+            expo[i] = expo[i - 1];
+         }
+         B->rows[zeros + 1] = Btmp;
+         R[zeros + 1] = Rtmp;
+         
+         // the reflections stay with their rows
+         Rtmp = V[kappa];
+         for (i = kappa; i > zeros + 1; i--) V[i] = V[i - 1];
+         V[zeros + 1] = Rtmp;
+
+         zeros++;
+         kappa++;
+         continue;
+      }
+
+      if (c == 0)
+      {
+         kappa++;
+         continue;
+      }
+
+      // Lovasz condition: delta*r_{k-1,k-1}^2 <= r_{k,k-1}^2 + r_{k,k}^2
+      tmp = R[kappa - 1][c - 1];
+      tmp = ldexp(delta*tmp*tmp, 2*(expo[kappa - 1] - expo[kappa]));
+      tmp2 = R[kappa][c - 1]*R[kappa][c - 1] + R[kappa][c]*R[kappa][c];
+
+      if (tmp != tmp || tmp2 != tmp2)
+      {
+         ok = -1;
+         break;
+      }
+
+      if (tmp <= tmp2)
+         kappa++;
+      else
+      {
+         Btmp = B->rows[kappa];
+         B->rows[kappa] = B->rows[kappa - 1];
+         B->rows[kappa - 1] = Btmp;
+
+         Rtmp = R[kappa];
+         R[kappa] = R[kappa - 1];
+         R[kappa - 1] = Rtmp;
+
+         etmp = expo[kappa];
+         expo[kappa] = expo[kappa - 1];
+         expo[kappa - 1] = etmp;
+
+         kappa--;
+      }
+   }
+
+   free(expo);
+   d_mat_clear(R);
+   d_mat_clear(V);
+
+   return ok;
+}
+
+/*
+   As per householder_d_reflection but with long doubles.
+*/
+
+void householder_ld_reflection(long double ** R, long double ** V, int kappa, int c, int n)
+{
+   int k;
+   long double sigma, t;
+
+   sigma = sqrtl(_ld_vec_norm(R[kappa] + c, n - c));
+   
+   if (sigma == 0.0L)
+   {
+      for (k = c; k < n; k++) V[kappa][k] = 0.0L;
+      return;
+   }
+
+   if (R[kappa][c] < 0.0L) sigma = -sigma;
+  
+   // v = x + sigma*e_1 scaled to have norm 2, so that x*(I - v*v^T) = (-sigma, 0, ..., 0)
+   for (k = c; k < n; k++) V[kappa][k] = R[kappa][k];
+   V[kappa][c] += sigma;
+
+   t = sqrtl(1.0L/(sigma*V[kappa][c]));
+   for (k = c; k < n; k++) V[kappa][k] *= t;
+
+   R[kappa][c] = -sigma;
+   for (k = c + 1; k < n; k++) R[kappa][k] = 0.0L;
+}
+
+/*
+   As per householder_d_size_reduce but with long doubles.
+*/
+
+int householder_ld_size_reduce(int kappa, F_mpz_mat_t B, long double ** R, long double ** V,
+                                                 long * expo, int zeros, int n, long double eta)
+{
+   int j, k, c, cj, ex, test;
+   long xx, e;
+   long double mu, tmp;
+
+   c = kappa - zeros - 1;
+   long loops = 0;
+
+   do
+   {
+      test = 0;
+      
+      loops++;
+      if (loops > 200) return -1;
+
+      expo[kappa] = _F_mpz_vec_to_ld_vec_2exp(R[kappa], B->rows[kappa], n);
+      for (j = zeros + 1; j < kappa; j++)
+      {
+         cj = j - zeros - 1;
+         _ld_vec_reflect(R[kappa] + cj, V[j] + cj, n - cj);
+      }
+
+      for (j = kappa - 1; j > zeros; j--)
+      {
+         cj = j - zeros - 1;
+         
+         if (R[j][cj] == 0.0L) continue;
+
+         mu = R[kappa][cj] / R[j][cj];
+         if (mu != mu) return -1; // NaN
+
+         tmp = frexpl(mu, &ex);
+         e = ex + expo[kappa] - expo[j]; // mu_true = tmp*2^e
+
+         if (tmp == 0.0L || e < 0 || (e == 0 && fabsl(tmp) <= eta)) continue; // |mu_true| <= eta
+         
+         test = 1;
+
+         // X = xx*2^e is the nearest integer to mu_true (to 53 bits)
+         if (e <= CPU_SIZE_1)
+         {
+            xx = (long) rintl(ldexpl(tmp, e));
+            e = 0;
+         } else
+         {
+            xx = (long) (tmp * MAX_LONG);
+            e -= CPU_SIZE_1;
+         }
+
+         if (xx == 0L) continue;
+
+         if (e == 0)
+         {
+            if (xx == 1L) _F_mpz_vec_sub(B->rows[kappa], B->rows[kappa], B->rows[j], n);
+            else if (xx == -1L) _F_mpz_vec_add(B->rows[kappa], B->rows[kappa], B->rows[j], n);
+            else if (xx > 0L) _F_mpz_vec_submul_ui(B->rows[kappa], B->rows[j], n, (ulong) xx);
+            else _F_mpz_vec_addmul_ui(B->rows[kappa], B->rows[j], n, (ulong) -xx);
+         } else
+         {
+            if (xx > 0L) _F_mpz_vec_submul_2exp_ui(B->rows[kappa], B->rows[j], n, (ulong) xx, e);
+            else _F_mpz_vec_addmul_2exp_ui(B->rows[kappa], B->rows[j], n, (ulong) -xx, e);
+         }
+
+         // update the remaining entries of R[kappa] which will be used this pass
+         tmp = ldexpl((long double) xx, e + expo[j] - expo[kappa]);
+         for (k = 0; k <= cj; k++)
+            R[kappa][k] -= tmp * R[j][k];
+      }
+   } while (test);
+
+   householder_ld_reflection(R, V, kappa, c, n);
+
+   return 0;
+}
+
+/* 
+   As per LLL_householder_d but using long doubles, which on some machines 
+   provides an extra 11 bits of precision.
+*/
+
+int LLL_householder_ld(F_mpz_mat_t B)
+{
+   int kappa, d, n, i, zeros, c, ok = 0;
+   long double ** R, ** V;
+   long double * Rtmp, eta, delta, tmp, tmp2;
+   long * expo, etmp;
+   F_mpz * Btmp;
+   
+   n = B->c;
+   d = B->r;
+
+   if (d == 0) return 0;
+   
+   delta = (4*DELTA + 1)/5;
+   eta = (4*ETA + .5)/5;
+
+   expo = (long *) malloc(d * sizeof(long)); 
+   R = ld_mat_init(d, n);
+   V = ld_mat_init(d, n);
+
+   zeros = -1;
+   kappa = 0;
+
+   while (kappa < d)
+   {
+      if (householder_ld_size_reduce(kappa, B, R, V, expo, zeros, n, eta) == -1)
+      {
+         ok = -1;
+         break;
+      }
+
+      c = kappa - zeros - 1;
+
+      // if row kappa is now zero, move it to the front
+      for (i = 0; i < n && F_mpz_is_zero(B->rows[kappa] + i); i++) ;
+      if (i == n)
+      {
+         Btmp = B->rows[kappa];
+         Rtmp = R[kappa];
+         for (i = kappa; i > zeros + 1; i--) 
+         {
+            B->rows[i] = B->rows[i - 1];
+            R[i] = R[i - 1];
+            expo[i] = expo[i - 1];
+         }
+         B->rows[zeros + 1] = Btmp;
+         R[zeros + 1] = Rtmp;
+         
+         // the reflections stay with their rows
+         Rtmp = V[kappa];
+         for (i = kappa; i > zeros + 1; i--) V[i] = V[i - 1];
+         V[zeros + 1] = Rtmp;
+
+         zeros++;
+         kappa++;
+         continue;
+      }
+
+      if (c == 0)
+      {
+         kappa++;
+         continue;
+      }
+
+      // Lovasz condition: delta*r_{k-1,k-1}^2 <= r_{k,k-1}^2 + r_{k,k}^2
+      tmp = R[kappa - 1][c - 1];
+      tmp = ldexpl(delta*tmp*tmp, 2*(expo[kappa - 1] - expo[kappa]));
+      tmp2 = R[kappa][c - 1]*R[kappa][c - 1] + R[kappa][c]*R[kappa][c];
+
+      if (tmp != tmp || tmp2 != tmp2)
+      {
+         ok = -1;
+         break;
+      }
+
+      if (tmp <= tmp2)
+         kappa++;
+      else
+      {
+         Btmp = B->rows[kappa];
+         B->rows[kappa] = B->rows[kappa - 1];
+         B->rows[kappa - 1] = Btmp;
+
+         Rtmp = R[kappa];
+         R[kappa] = R[kappa - 1];
+         R[kappa - 1] = Rtmp;
+
+         etmp = expo[kappa];
+         expo[kappa] = expo[kappa - 1];
+         expo[kappa - 1] = etmp;
+
+         kappa--;
+      }
+   }
+
+   free(expo);
+   ld_mat_clear(R);
+   ld_mat_clear(V);
+
+   return ok;
+}
+
 /* 
    A wrapper of the above procedures.  Begins with the greediest version, then 
-   adapts to heuristic inner products only, then finally to mpfr if needed.
+   adapts to heuristic inner products only, then to the Householder versions,
+   then finally to mpfr if needed.
 */
 
 int LLL_wrapper(F_mpz_mat_t B){
@@ -2518,6 +2917,13 @@ int LLL_wrapper(F_mpz_mat_t B){
       res = LLL_d_heuristic(B);
    }
 
+   if (res == -1)
+   { 
+	  //try the more stable Householder versions
+      res = LLL_householder_d(B);
+      if (res == -1) res = LLL_householder_ld(B);
+   }
+
    if (res == -1)
    { 
 	  //Now try the mpfr version
@@ -4484,7 +4890,7 @@ void gs_Babai(int kappa, F_mpz_mat_t B, double **mu, double **r, double *s,
 {
    int i, j, k, test, aa, exponent;
    signed long xx;
-   double tmp, rtmp;
+   double tmp;
    
    aa = (a > zeros) ? a : zeros + 1;
   
@@ -4496,24 +4902,11 @@ void gs_Babai(int kappa, F_mpz_mat_t B, double **mu, double **r, double *s,
             appSP[kappa][j] = heuristic_scalar_product(appB[kappa], appB[j], n, B, kappa, j, expo[kappa]+expo[j]);
           }
 	  	  
-          if (j > zeros + 2)
-	      {
-	         tmp = mu[j][zeros + 1] * r[kappa][zeros + 1];
-	         rtmp = appSP[kappa][j] - tmp;
-	         
-			 for (k = zeros + 2; k < j - 1; k++)
-		     {
-		         tmp = mu[j][k] * r[kappa][k];
-		         rtmp = rtmp - tmp;
-		     }
-	         
-			 tmp = mu[j][j-1] * r[kappa][j-1];
-	         r[kappa][j] = rtmp - tmp;
-          } else if (j == zeros+2)
-	      {
-	         tmp = mu[j][zeros + 1] * r[kappa][zeros + 1];
-	         r[kappa][j] = appSP[kappa][j] - tmp;
-	      } else r[kappa][j] = appSP[kappa][j];
+          if (j > zeros + 1)
+          {
+             tmp = _d_vec_scalar_product(mu[j] + zeros + 1, r[kappa] + zeros + 1, j - zeros - 1);
+             r[kappa][j] = appSP[kappa][j] - tmp;
+          } else r[kappa][j] = appSP[kappa][j];
 
 	      mu[kappa][j] = r[kappa][j] / r[j][j];
       }
@@ -4847,6 +5240,121 @@ int U_LLL_with_removal(F_mpz_mat_t FM, long new_size, F_mpz_t gs_B)
    return newd;
 }
 
+/***************************************
+
+   LLL_recursive is a divide and conquer variant of U_LLL for lattices with 
+   very large entries.  Rather than truncating to new_size bits and lifting 
+   new_size/4 bits at a time, the top half of the bits of the basis is reduced 
+   (recursively, with an identity adjoined to record the transformation), the 
+   unimodular transform is applied to the full basis and the process repeated 
+   until no more progress is made.  The final pass is done by the usual 
+   wrapper, so the output is always fully LLL reduced.  Each level works with 
+   half as many bits as the one above it, so the bulk of the work is done with 
+   the fast doubles code.
+
+****************************************/
+
+/*
+   Reduces the truncation of FM to keep bits adjoined to an identity matrix
+   and sets U to the resulting r x r unimodular transformation.  Recurses 
+   if the truncated lattice is itself larger than new_size bits.
+*/
+
+void _LLL_recursive_transform(F_mpz_mat_t U, F_mpz_mat_t FM, long bits, 
+                                                   long keep, long new_size)
+{
+   long r = FM->r, c = FM->c, i, j;
+
+   F_mpz_mat_t big_FM, trunc_data, W;
+   F_mpz_mat_init(big_FM, r, r + c);
+   F_mpz_mat_init(trunc_data, r, c);
+
+   F_mpz_mat_div_2exp(trunc_data, FM, (ulong) (bits - keep));
+
+   for (i = 0; i < r; i++)
+   {
+      F_mpz_set_ui(big_FM->rows[i] + i, 1L);
+      for (j = r; j < r + c; j++)
+         F_mpz_set(big_FM->rows[i] + j, trunc_data->rows[i] + j - r);
+   }
+
+   LLL_recursive(big_FM, new_size);
+
+   F_mpz_mat_window_init(W, big_FM, 0, 0, r, r);
+   F_mpz_mat_set(U, W);
+   F_mpz_mat_window_clear(W);
+
+   F_mpz_mat_clear(trunc_data);
+   F_mpz_mat_clear(big_FM);
+}
+
+/*
+   Pre-reduces FM in place by repeatedly reducing its top bits.  Does not 
+   do the final full precision pass.
+*/
+
+void _LLL_recursive(F_mpz_mat_t FM, long new_size)
+{
+   long r = FM->r;
+   long bits = FLINT_ABS(F_mpz_mat_max_bits(FM));
+   long prev_bits, keep;
+   int is_U_I;
+
+   F_mpz_mat_t U, I;
+   F_mpz_mat_init(U, r, r);
+   F_mpz_mat_init_identity(I, r);
+
+   while (bits > new_size)
+   {
+      keep = FLINT_MAX(bits/2, new_size);
+      
+      _LLL_recursive_transform(U, FM, bits, keep, new_size);
+
+      is_U_I = F_mpz_mat_equal(U, I);
+      if (is_U_I) break;
+
+      F_mpz_mat_mul_classical(FM, U, FM);
+
+      prev_bits = bits;
+      bits = FLINT_ABS(F_mpz_mat_max_bits(FM));
+
+      // make sure we are still making progress
+      if (bits > prev_bits - new_size/4) break;
+   }
+
+   F_mpz_mat_clear(I);
+   F_mpz_mat_clear(U);
+}
+
+/*
+   Reduces B in place using the recursive strategy above, with the entries of 
+   the truncated lattices kept to roughly new_size bits at the bottom level.  
+   The removal bound gs_B is only used in the final full precision pass.  
+   Returns the new dimension of B, as per LLL_wrapper_with_removal.
+*/
+
+int LLL_recursive_with_removal(F_mpz_mat_t B, long new_size, F_mpz_t gs_B)
+{
+   if (B->r == 0) return 0;
+   
+   _LLL_recursive(B, new_size);
+
+   return LLL_wrapper_with_removal(B, gs_B);
+}
+
+/*
+   As above, but with no removals.
+*/
+
+int LLL_recursive(F_mpz_mat_t B, long new_size)
+{
+   if (B->r == 0) return 0;
+   
+   _LLL_recursive(B, new_size);
+
+   return LLL_wrapper(B);
+}
+
 /* 
    A wrapper of U_LLL_with_removal the most numerically stable LLL.  This is the default LLL
    which reduced B in place.
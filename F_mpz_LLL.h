@@ -90,6 +90,20 @@ int LLL_mpfr2(F_mpz_mat_t B, mp_prec_t prec);
 
 int LLL_mpfr(F_mpz_mat_t B);
 
+void householder_d_reflection(double ** R, double ** V, int kappa, int c, int n);
+
+int householder_d_size_reduce(int kappa, F_mpz_mat_t B, double ** R, double ** V,
+                                                 long * expo, int zeros, int n, double eta);
+
+int LLL_householder_d(F_mpz_mat_t B);
+
+void householder_ld_reflection(long double ** R, long double ** V, int kappa, int c, int n);
+
+int householder_ld_size_reduce(int kappa, F_mpz_mat_t B, long double ** R, long double ** V,
+                                                 long * expo, int zeros, int n, long double eta);
+
+int LLL_householder_ld(F_mpz_mat_t B);
+
 int LLL_wrapper(F_mpz_mat_t B);
 
 int LLL_d_with_removal(F_mpz_mat_t B, F_mpz_t gs_B);
@@ -126,6 +140,15 @@ void gs_Babai(int kappa, F_mpz_mat_t B, double **mu, double **r, double *s,
 
 int U_LLL_with_removal(F_mpz_mat_t FM, long new_size, F_mpz_t gs_B);
 
+void _LLL_recursive_transform(F_mpz_mat_t U, F_mpz_mat_t FM, long bits, 
+                                                   long keep, long new_size);
+
+void _LLL_recursive(F_mpz_mat_t FM, long new_size);
+
+int LLL_recursive_with_removal(F_mpz_mat_t B, long new_size, F_mpz_t gs_B);
+
+int LLL_recursive(F_mpz_mat_t B, long new_size);
+
 ulong getShift(F_mpz_mat_t B);
 
 void LLL (F_mpz_mat_t B);
@@ -26,11 +26,14 @@ Copyright (C) 2009, 2010 Andy Novocin
 
 *****************************************************************************/
 
+#define _POSIX_C_SOURCE 200809L // for fileno and ftruncate
+
 #include <stdio.h>
 #include <string.h>
 #include <gmp.h>
 #include <mpfr.h>
 #include <time.h>
+#include <unistd.h>
 #include "flint.h"
 #include "long_extras.h"
 #include "d_mat.h"
@@ -1132,6 +1135,115 @@ int test_F_mpz_mat_tofromstring()
    return result;
 }
 
+int test_F_mpz_mat_fwrite_bin()
+{
+   mpz_mat_t test_mat;
+   F_mpz_mat_t test_F_mpz_mat, test_F_mpz_mat2;
+   int result = 1;
+   ulong bits;
+
+   ulong count1;
+   for (count1 = 0; (count1 < 2000*ITER) && (result == 1) ; count1++)
+   {
+      ulong r1 = z_randint(30);
+      ulong c1 = z_randint(30);
+      ulong r2 = z_randint(30);
+      ulong c2 = z_randint(30);
+      
+		F_mpz_mat_init(test_F_mpz_mat, r1, c1);
+      F_mpz_mat_init(test_F_mpz_mat2, r2, c2);
+
+      bits = z_randint(200) + 1;
+
+      mpz_mat_init(test_mat, r1, c1);
+		mpz_randmat(test_mat, r1, c1, bits);
+      mpz_mat_to_F_mpz_mat(test_F_mpz_mat, test_mat);
+
+      FILE * file = tmpfile();
+      int OK = F_mpz_mat_fwrite_bin(test_F_mpz_mat, file);
+      
+      // the payload is stored inline if and only if all entries are small
+      OK &= (ftell(file) == (FLINT_BIN_HEADER_LIMBS + r1*c1)*sizeof(mp_limb_t)) 
+                                          == (FLINT_ABS(F_mpz_mat_max_bits(test_F_mpz_mat)) <= FLINT_BITS - 2);
+
+      rewind(file);
+      OK &= F_mpz_mat_fread_bin(test_F_mpz_mat2, file);
+      fclose(file);
+
+      result = F_mpz_mat_equal(test_F_mpz_mat, test_F_mpz_mat2) && OK
+           && (test_F_mpz_mat2->r == r1) && (test_F_mpz_mat2->c == c1); 
+		if (!result) 
+		{
+			printf("Error: r1 = %ld, c1 = %ld, r2 = %ld, c2 = %ld\n", r1, c1, r2, c2);
+		}
+          
+		F_mpz_mat_clear(test_F_mpz_mat);
+      F_mpz_mat_clear(test_F_mpz_mat2);
+      mpz_mat_clear(test_mat); 
+   }
+   
+   return result;
+}
+
+int test_F_mpz_mat_fread_bin_corrupt()
+{
+   mpz_mat_t test_mat;
+   F_mpz_mat_t test_F_mpz_mat, test_F_mpz_mat2;
+   mp_limb_t limb;
+   int result = 1;
+   ulong bits, field;
+
+   ulong count1;
+   for (count1 = 0; (count1 < 2000*ITER) && (result == 1) ; count1++)
+   {
+      ulong r1 = z_randint(30) + 1;
+      ulong c1 = z_randint(30) + 1;
+      
+		F_mpz_mat_init(test_F_mpz_mat, r1, c1);
+      F_mpz_mat_init(test_F_mpz_mat2, 0, 0);
+
+      bits = z_randint(200) + 1;
+
+      mpz_mat_init(test_mat, r1, c1);
+		mpz_randmat(test_mat, r1, c1, bits);
+      mpz_mat_to_F_mpz_mat(test_F_mpz_mat, test_mat);
+
+      FILE * file = tmpfile();
+      int OK = F_mpz_mat_fwrite_bin(test_F_mpz_mat, file);
+      
+      // enlarge one of the dimensions or the payload size, or truncate the file
+      field = z_randint(4);
+      if (field < 3)
+      {
+         fseek(file, (5 + field)*sizeof(mp_limb_t), SEEK_SET);
+         fread(&limb, sizeof(mp_limb_t), 1, file);
+         limb = (z_randint(2) ? limb + z_randint(1000) + 1 : -z_randint(1000) - 1L);
+         fseek(file, (5 + field)*sizeof(mp_limb_t), SEEK_SET);
+         fwrite(&limb, sizeof(mp_limb_t), 1, file);
+      } else
+      {
+         fflush(file);
+         OK &= (ftruncate(fileno(file), ftell(file) - sizeof(mp_limb_t)) == 0);
+      }
+
+      rewind(file);
+      OK &= !F_mpz_mat_fread_bin(test_F_mpz_mat2, file);
+      fclose(file);
+
+      result = OK; 
+		if (!result) 
+		{
+			printf("Error: r1 = %ld, c1 = %ld, field = %ld\n", r1, c1, field);
+		}
+          
+		F_mpz_mat_clear(test_F_mpz_mat);
+      F_mpz_mat_clear(test_F_mpz_mat2);
+      mpz_mat_clear(test_mat); 
+   }
+   
+   return result;
+}
+
 int test_F_mpz_mat_tofromstringpretty()
 {
    mpz_mat_t test_mat;
@@ -2615,6 +2727,80 @@ int test_F_mpz_mat_mul_classical()
    return result;
 }
 
+int test__F_mpz_mat_mul_small()
+{
+   mpz_mat_t m_mat1, m_mat2;
+   F_mpz_mat_t F_mat1, F_mat2, F_res1, F_res2;
+   int result = 1;
+   ulong bits1, bits2, i, j, k;
+   
+   ulong count1;
+   for (count1 = 0; (count1 < 1000*ITER) && (result == 1) ; count1++)
+   {
+      // occasionally large enough for several tiles
+      ulong max = (count1 % 100 == 0) ? 300 : 40;
+      ulong r1 = z_randint(max)+1;
+      ulong c1 = z_randint(max)+1;
+      ulong c2 = z_randint(max)+1;
+      
+      F_mpz_mat_init(F_mat1, r1, c1);
+      F_mpz_mat_init(F_mat2, c1, c2);
+      F_mpz_mat_init(F_res1, r1, c2);
+      F_mpz_mat_init(F_res2, r1, c2);
+
+      mpz_mat_init(m_mat1, r1, c1); 
+      mpz_mat_init(m_mat2, c1, c2); 
+
+      // exercise the double, one limb and two limb products and the general case
+      bits1 = z_randint(FLINT_BITS) + 1;
+      bits2 = z_randint(FLINT_BITS) + 1;
+      if (z_randint(2))
+      {
+         bits1 = FLINT_MIN(bits1, 30);
+         bits2 = FLINT_MIN(bits2, 20);
+      }
+      
+      mpz_randmat(m_mat1, r1, c1, bits1);
+      mpz_randmat(m_mat2, c1, c2, bits2);
+           
+      mpz_mat_to_F_mpz_mat(F_mat1, m_mat1);
+      mpz_mat_to_F_mpz_mat(F_mat2, m_mat2);
+
+      ulong b1 = FLINT_ABS(F_mpz_mat_max_bits(F_mat1));
+      ulong b2 = FLINT_ABS(F_mpz_mat_max_bits(F_mat2));
+      int small = (b1 <= FLINT_BITS - 2 && b2 <= FLINT_BITS - 2 
+                && b1 + b2 + FLINT_BIT_COUNT(c1) <= 2*FLINT_BITS - 1);
+
+      for (i = 0; i < r1; i++)
+         for (j = 0; j < c2; j++)
+            for (k = 0; k < c1; k++)
+               F_mpz_addmul(F_res2->rows[i] + j, F_mat1->rows[i] + k, F_mat2->rows[k] + j);
+
+      result = (_F_mpz_mat_mul_small(F_res1, F_mat1, F_mat2) == small);
+      if (result && small) result = F_mpz_mat_equal(F_res1, F_res2);
+      
+      if (result)
+      {
+         F_mpz_mat_mul_classical(F_res1, F_mat1, F_mat2);
+         result = F_mpz_mat_equal(F_res1, F_res2);
+      }
+
+      if (!result) 
+      {
+         printf("Error: bits1 = %ld, bits2 = %ld, r1 = %ld, c1 = %ld, c2 = %ld\n", bits1, bits2, r1, c1, c2);
+      }
+          
+      F_mpz_mat_clear(F_mat1);
+      F_mpz_mat_clear(F_mat2);
+      F_mpz_mat_clear(F_res1);
+      F_mpz_mat_clear(F_res2);
+      mpz_mat_clear(m_mat1); 
+      mpz_mat_clear(m_mat2);
+   }
+   
+   return result;
+}
+
 int test__F_mpz_vec_submul_2exp_F_mpz()
 {
    mpz_mat_t m_mat, m_mat2, m_mat3;
@@ -2839,6 +3025,180 @@ int test__F_mpz_vec_scalar_product()
    return result; 
 }
 
+/*
+   Vectors whose entries are mostly small, some close to COEFF_MAX, and 
+   occasionally large, exercising the fast paths for small entries.
+*/
+void F_mpz_test_random_small_vec(F_mpz * vec, mpz_t * m_vec, ulong n)
+{
+   ulong i;
+   
+   for (i = 0; i < n; i++)
+   {
+      if (z_randint(100) == 0) F_mpz_test_random(vec + i, z_randint(200) + 1);
+      else if (z_randint(4) == 0)
+      {
+         F_mpz_set_si(vec + i, COEFF_MAX - z_randint(4));
+         if (z_randint(2)) F_mpz_neg(vec + i, vec + i);
+      } else F_mpz_test_random(vec + i, z_randint(FLINT_BITS - 2));
+
+      F_mpz_get_mpz(m_vec[i], vec + i);
+   }
+}
+
+int test__F_mpz_vec_small()
+{
+   int result = 1;
+   ulong count1, i, n, op, exp;
+   long c;
+   F_mpz_t F_c;
+   mpz_t temp, temp2;
+   mpz_init(temp);
+   mpz_init(temp2);
+   F_mpz_init(F_c);
+
+   ulong block = F_MPZ_VEC_BLOCK;
+   
+   F_mpz_vec_stats_reset();
+
+   for (count1 = 0; (count1 < 10000) && (result == 1); count1++)
+   {
+      flint_tuning.F_mpz_vec_block = z_randint(64) + 1;
+      
+      n = z_randint(200);
+      op = z_randint(7);
+      exp = z_randint(8);
+      c = z_randint(1000) - 500;
+      if (z_randint(4) == 0) c = (z_randint(2) ? COEFF_MAX : COEFF_MIN);
+      F_mpz_set_si(F_c, c);
+
+      F_mpz * vec1 = _F_mpz_vec_init(n);
+      F_mpz * vec2 = _F_mpz_vec_init(n);
+      F_mpz * res = _F_mpz_vec_init(n);
+      mpz_t * m_vec1 = (mpz_t *) malloc((n + 1)*sizeof(mpz_t));
+      mpz_t * m_vec2 = (mpz_t *) malloc((n + 1)*sizeof(mpz_t));
+      for (i = 0; i < n; i++)
+      {
+         mpz_init(m_vec1[i]);
+         mpz_init(m_vec2[i]);
+      }
+
+      F_mpz_test_random_small_vec(vec1, m_vec1, n);
+      F_mpz_test_random_small_vec(vec2, m_vec2, n);
+      for (i = 0; i < n; i++) // res may have large entries
+         if (z_randint(10) == 0) F_mpz_test_random(res + i, 100);
+      
+      switch (op)
+      {
+         case 0: _F_mpz_vec_add(res, vec1, vec2, n); break;
+         case 1: _F_mpz_vec_sub(res, vec1, vec2, n); break;
+         case 2: _F_mpz_vec_addmul_ui(vec1, vec2, n, FLINT_ABS(c)); break;
+         case 3: _F_mpz_vec_submul_F_mpz(vec1, vec2, n, F_c); break;
+         case 4: _F_mpz_vec_addmul_2exp_ui(vec1, vec2, n, FLINT_ABS(c), exp); break;
+         case 5: _F_mpz_vec_submul_2exp_F_mpz(vec1, vec2, n, F_c, exp); break;
+         case 6: _F_mpz_vec_scalar_product(F_c, vec1, vec2, n); break;
+      }
+
+      mpz_set_ui(temp2, 0);
+      for (i = 0; (i < n) && result; i++)
+      {
+         switch (op)
+         {
+            case 0: mpz_add(temp, m_vec1[i], m_vec2[i]); break;
+            case 1: mpz_sub(temp, m_vec1[i], m_vec2[i]); break;
+            case 2: mpz_mul_ui(temp, m_vec2[i], FLINT_ABS(c)); mpz_add(temp, m_vec1[i], temp); break;
+            case 3: mpz_mul_si(temp, m_vec2[i], c); mpz_sub(temp, m_vec1[i], temp); break;
+            case 4: mpz_mul_ui(temp, m_vec2[i], FLINT_ABS(c)); mpz_mul_2exp(temp, temp, exp); mpz_add(temp, m_vec1[i], temp); break;
+            case 5: mpz_mul_si(temp, m_vec2[i], c); mpz_mul_2exp(temp, temp, exp); mpz_sub(temp, m_vec1[i], temp); break;
+            case 6: mpz_addmul(temp2, m_vec1[i], m_vec2[i]); break;
+         }
+
+         if (op < 6)
+         {
+            F_mpz_get_mpz(temp2, (op < 2) ? res + i : vec1 + i);
+            result = (mpz_cmp(temp, temp2) == 0);
+         }
+      }
+      
+      if (op == 6)
+      {
+         F_mpz_get_mpz(temp, F_c);
+         result = (mpz_cmp(temp, temp2) == 0);
+      }
+
+      if (!result) printf("Error: op = %ld, n = %ld, c = %ld, exp = %ld, i = %ld\n", op, n, c, exp, i);
+
+      for (i = 0; i < n; i++)
+      {
+         mpz_clear(m_vec1[i]);
+         mpz_clear(m_vec2[i]);
+      }
+      free(m_vec1);
+      free(m_vec2);
+      _F_mpz_vec_clear(vec1, n);
+      _F_mpz_vec_clear(vec2, n);
+      _F_mpz_vec_clear(res, n);
+   }
+
+   flint_tuning.F_mpz_vec_block = block;
+
+   // all paths must have been taken
+   for (op = 0; op < F_MPZ_VEC_OPS; op++)
+      result &= (F_mpz_vec_stats[op].fast > 0 && F_mpz_vec_stats[op].slow > 0);
+   result &= (F_mpz_vec_stats[F_MPZ_VEC_ADD].promoted > 0);
+   result &= (F_mpz_vec_stats[F_MPZ_VEC_SUBMUL].promoted > 0);
+
+   mpz_clear(temp);
+   mpz_clear(temp2);
+   F_mpz_clear(F_c);
+
+   return result;
+}
+
+/*
+   Each thread counts its own calls when FLINT is built with OpenMP. The 
+   entries are small, so that no F_mpz's are allocated by the threads.
+*/
+int test__F_mpz_vec_stats_threads()
+{
+   int result = 1;
+
+#pragma omp parallel num_threads(4) reduction(&&:result)
+   {
+      ulong i, calls, n = 100;
+      ulong thread = 0;
+      F_mpz a[100], b[100], res[100];
+
+#ifdef _OPENMP
+      thread = omp_get_thread_num();
+#endif
+
+      for (i = 0; i < n; i++)
+      {
+         a[i] = i;
+         b[i] = thread;
+         res[i] = 0L;
+      }
+
+      F_mpz_vec_stats_reset();
+      
+#pragma omp barrier
+
+      for (calls = 0; calls <= thread; calls++)
+         _F_mpz_vec_add(res, a, b, n);
+
+      result = (F_mpz_vec_stats[F_MPZ_VEC_ADD].calls == thread + 1)
+            && (F_mpz_vec_stats[F_MPZ_VEC_ADD].fast == (thread + 1)*n)
+            && (F_mpz_vec_stats[F_MPZ_VEC_SUB].calls == 0L);
+      for (i = 0; i < n; i++)
+         result = result && (res[i] == i + thread);
+
+      if (!result) printf("Error: thread = %ld\n", thread);
+   }
+
+   return result;
+}
+
 int test__F_mpz_vec_to_d_vec_2exp()
 {
    double * d1, * d2;
@@ -3094,6 +3454,8 @@ void F_mpz_mat_test_all()
    RUN_TEST(_F_mpz_vec_submul_2exp_ui); 
    RUN_TEST(_F_mpz_vec_submul_2exp_F_mpz); 
    RUN_TEST(_F_mpz_vec_scalar_product); 
+   RUN_TEST(_F_mpz_vec_small); 
+   RUN_TEST(_F_mpz_vec_stats_threads); 
    RUN_TEST(_F_mpz_vec_to_d_vec_2exp); 
    RUN_TEST(_F_mpz_vec_to_mpfr_vec); 
    RUN_TEST(F_mpz_mat_convert); 
@@ -3106,11 +3468,14 @@ void F_mpz_mat_test_all()
    RUN_TEST(F_mpz_mat_resize);
    RUN_TEST(F_mpz_mat_tofromstring);
    RUN_TEST(F_mpz_mat_tofromstringpretty);
+   RUN_TEST(F_mpz_mat_fwrite_bin);
+   RUN_TEST(F_mpz_mat_fread_bin_corrupt);
    RUN_TEST(F_mpz_mat_neg); 
    RUN_TEST(F_mpz_mat_add); 
    RUN_TEST(F_mpz_mat_sub); 
    RUN_TEST(F_mpz_mat_mul_div_2exp); 
    RUN_TEST(F_mpz_mat_mul_classical);
+   RUN_TEST(_F_mpz_mat_mul_small);
    RUN_TEST(F_mpz_mat_col_partition);
    RUN_TEST(F_mpz_mat_window_init_clear);
    RUN_TEST(F_mpz_mat_smod);
@@ -40,6 +40,7 @@
 #include "F_mpz_mat.h"
 #include "F_mpz_LLL.h"
 #include "mpz_mat.h"
+#include "d_mat.h"
 
 /*===============================================================================
 
@@ -384,9 +385,11 @@ void F_mpz_mat_print_pretty(F_mpz_mat_t mat)
 
 void F_mpz_mat_fprint(F_mpz_mat_t mat, FILE* f)
 {
-   char* s = F_mpz_mat_to_string(mat);
-   fputs(s, f);
-   free(s);
+   mpz_mat_t m;
+   mpz_mat_init(m, mat->r, mat->c);
+   F_mpz_mat_to_mpz_mat(m, mat);
+   mpz_mat_fprint(m, f);
+   mpz_mat_clear(m);
 }
 
 void F_mpz_mat_fprint_pretty(F_mpz_mat_t mat, FILE* f)
@@ -434,6 +437,50 @@ int F_mpz_mat_fread_pretty(F_mpz_mat_t mat, FILE* f)
    return ok;
 }
 
+int F_mpz_mat_fwrite_bin(const F_mpz_mat_t mat, FILE * f)
+{
+   F_mpn_bin_header_t hdr;
+   ulong i;
+
+   hdr->type = FLINT_BIN_F_MPZ_MAT;
+   hdr->dim1 = mat->r;
+   hdr->dim2 = mat->c;
+   hdr->limbs = 0L;
+   for (i = 0; i < mat->r; i++)
+      hdr->limbs += _F_mpz_vec_size_bin(mat->rows[i], mat->c);
+   hdr->flags = (hdr->limbs == mat->r*mat->c) ? FLINT_BIN_SMALL : 0L;
+
+   if (!F_mpn_fwrite_bin_header(hdr, f)) return 0;
+
+   for (i = 0; i < mat->r; i++)
+      if (!_F_mpz_vec_fwrite_bin(mat->rows[i], mat->c, f)) return 0;
+
+   return 1;
+}
+
+int F_mpz_mat_fread_bin(F_mpz_mat_t mat, FILE * f)
+{
+   F_mpn_bin_header_t hdr;
+   ulong i;
+
+   if (!F_mpn_fread_bin_header(hdr, f) || hdr->type != FLINT_BIN_F_MPZ_MAT)
+      return 0;
+
+   // each entry takes at least one limb, so this also bounds the allocation
+   if (hdr->dim2 && hdr->dim1 > hdr->limbs/hdr->dim2) return 0;
+   if (!F_mpn_bin_header_check(hdr, hdr->dim1*hdr->dim2)) return 0;
+
+   F_mpz_mat_clear(mat);
+   F_mpz_mat_init(mat, hdr->dim1, hdr->dim2);
+
+   if (mat->c == 0L) return 1; // no rows are allocated
+
+   for (i = 0; i < mat->r; i++)
+      if (!_F_mpz_vec_fread_bin(mat->rows[i], mat->c, f, hdr)) return 0;
+
+   return 1;
+}
+
 /*===============================================================================
 
 	Conversions
@@ -481,6 +528,23 @@ long _F_mpz_vec_to_d_vec_2exp(double * appv, const F_mpz * vec, const ulong n)
    return maxexp;
 }
 
+long _F_mpz_vec_to_ld_vec_2exp(long double * appv, const F_mpz * vec, const ulong n)
+{
+   long * exp, i, maxexp = 0L;
+   exp = (long *) malloc(n * sizeof(long)); 
+  
+   for (i = 0; i < n; i++)
+   {
+      appv[i] = F_mpz_get_ld_2exp(&exp[i], vec + i);
+      if (exp[i] > maxexp) maxexp = exp[i];
+   }
+
+   for (i = 0; i < n; i++) appv[i] = ldexpl(appv[i], exp[i] - maxexp);
+
+   free(exp);
+   return maxexp;
+}
+
 void _F_mpz_vec_to_mpfr_vec(__mpfr_struct * appv, const F_mpz * vec, const ulong n)
 {
    ulong i;
@@ -549,6 +613,314 @@ void F_mpz_mat_neg(F_mpz_mat_t mat1, const F_mpz_mat_t mat2)
 		   F_mpz_neg(mat1->rows[i] + j, mat2->rows[i] + j);
 }
 
+/*===============================================================================
+
+	Vector input/output
+
+================================================================================*/
+
+#define F_MPZ_BIN_BLOCK 256 // number of limbs buffered when writing
+
+ulong _F_mpz_vec_size_bin(const F_mpz * vec, ulong n)
+{
+   ulong i, limbs = n;
+
+   for (i = 0; i < n; i++)
+      if (COEFF_IS_MPZ(vec[i]))
+         limbs += F_mpz_size(vec + i);
+
+   return limbs;
+}
+
+int _F_mpz_vec_fwrite_bin(const F_mpz * vec, ulong n, FILE * f)
+{
+   mp_limb_t buf[F_MPZ_BIN_BLOCK];
+   ulong i, len = 0;
+
+   for (i = 0; i < n; i++)
+   {
+      if (!COEFF_IS_MPZ(vec[i])) 
+      {
+         buf[len++] = vec[i];
+         if (len == F_MPZ_BIN_BLOCK)
+         {
+            if (fwrite(buf, sizeof(mp_limb_t), len, f) != len) return 0;
+            len = 0;
+         }
+      } else
+      {
+         __mpz_struct * m = F_mpz_ptr_mpz(vec[i]);
+         ulong size = mpz_size(m);
+
+         buf[len++] = F_MPZ_BIN_LARGE + size + (mpz_sgn(m) < 0 ? F_MPZ_BIN_NEG : 0L);
+         if (fwrite(buf, sizeof(mp_limb_t), len, f) != len) return 0;
+         len = 0;
+
+         if (fwrite(m->_mp_d, sizeof(mp_limb_t), size, f) != size) return 0;
+      }
+   }
+
+   return (fwrite(buf, sizeof(mp_limb_t), len, f) == len);
+}
+
+/*
+   Given that the mpz associated with f holds size limbs of the absolute
+   value of an integer, in the byte order of the data if swap is set, sets 
+   f to that integer, negated if neg is set.
+*/
+static
+void _F_mpz_set_bin(F_mpz_t f, ulong size, int neg, int swap)
+{
+   __mpz_struct * m = F_mpz_ptr_mpz(*f);
+
+   if (swap) F_mpn_byte_swap(m->_mp_d, size);
+   
+   while (size && (m->_mp_d[size - 1] == 0L)) size--;
+   m->_mp_size = neg ? -size : size;
+   
+   _F_mpz_demote_val(f);
+}
+
+int _F_mpz_vec_fread_bin(F_mpz * vec, ulong n, FILE * f, const F_mpn_bin_header_t hdr)
+{
+   ulong i;
+   mp_limb_t x;
+
+   if (hdr->flags & FLINT_BIN_SMALL) // read directly into vec
+   {
+      for (i = 0; i < n; i++)
+         F_mpz_zero(vec + i);
+
+      if (!F_mpn_fread_bin((mp_limb_t *) vec, n, f, hdr->swap)) 
+      {
+         F_mpn_clear((mp_limb_t *) vec, n);
+         return 0;
+      }
+
+      for (i = 0; i < n; i++)
+         if (!F_mpz_bin_is_small(vec[i])) break;
+
+      if (i == n) return 1;
+
+      F_mpn_clear((mp_limb_t *) vec, n);
+      return 0;
+   }
+
+   for (i = 0; i < n; i++)
+   {
+      if (!F_mpn_fread_bin(&x, 1, f, hdr->swap)) return 0;
+
+      if (F_mpz_bin_is_small(x)) F_mpz_set_si(vec + i, (long) x);
+      else if (COEFF_IS_MPZ(x))
+      {
+         ulong size = x & (F_MPZ_BIN_NEG - 1L);
+         if (size >= hdr->limbs) return 0; // corrupt, cannot fit in the payload
+         
+         __mpz_struct * m = _F_mpz_promote(vec + i);
+
+         // read the limbs directly into the mpz
+         if (fread(_mpz_realloc(m, size), sizeof(mp_limb_t), size, f) != size) 
+         {
+            F_mpz_zero(vec + i);
+            return 0;
+         }
+         _F_mpz_set_bin(vec + i, size, (x & F_MPZ_BIN_NEG) != 0L, hdr->swap);
+      } else return 0;
+   }
+
+   return 1;
+}
+
+int _F_mpz_vec_set_bin(F_mpz * vec, ulong n, const mp_limb_t * data, 
+                                     ulong limbs, const F_mpn_bin_header_t hdr)
+{
+   ulong i, pos = 0;
+   mp_limb_t x;
+
+   for (i = 0; i < n; i++)
+   {
+      if (pos == limbs) return 0;
+      
+      x = data[pos++];
+      if (hdr->swap) F_mpn_byte_swap(&x, 1);
+
+      if (F_mpz_bin_is_small(x)) F_mpz_set_si(vec + i, (long) x);
+      else if (COEFF_IS_MPZ(x))
+      {
+         ulong size = x & (F_MPZ_BIN_NEG - 1L);
+         if (size > limbs - pos) return 0;
+
+         __mpz_struct * m = _F_mpz_promote(vec + i);
+         F_mpn_copy(_mpz_realloc(m, size), data + pos, size);
+         _F_mpz_set_bin(vec + i, size, (x & F_MPZ_BIN_NEG) != 0L, hdr->swap);
+         pos += size;
+      } else return 0;
+   }
+
+   return (pos == limbs);
+}
+
+/*===============================================================================
+
+	Small entries
+
+================================================================================*/
+
+THREAD F_mpz_vec_count_t F_mpz_vec_stats[F_MPZ_VEC_OPS];
+
+void F_mpz_vec_stats_reset(void)
+{
+   memset(F_mpz_vec_stats, 0, sizeof(F_mpz_vec_stats));
+}
+
+void F_mpz_vec_stats_print(void)
+{
+   const char * names[F_MPZ_VEC_OPS] = {"add", "sub", "addmul", "submul", "scalar_product"};
+   ulong i;
+
+   for (i = 0; i < F_MPZ_VEC_OPS; i++)
+   {
+      F_mpz_vec_count_t * c = F_mpz_vec_stats + i;
+      ulong total = c->fast + c->slow;
+      
+      printf("%-15s calls = %ld, fast = %ld, slow = %ld, promoted = %ld (%.1f%% fast)\n", 
+         names[i], c->calls, c->fast, c->slow, c->promoted, 
+         total ? (100.0*c->fast)/total : 0.0);
+   }
+}
+
+/*
+   Sets res[i] to vec1[i] + c*2^exp*vec2[i] for 0 <= i < n, where c is small. 
+   If res is not vec1 then c must be 1 or -1 and exp must be 0.
+*/
+static
+void __F_mpz_vec_addmul_si_2exp(F_mpz * res, const F_mpz * vec1, const F_mpz * vec2, 
+                          ulong n, long c, ulong exp, F_mpz_vec_count_t * count)
+{
+   ulong i, j, len, big, m;
+   ulong cbits = FLINT_BIT_COUNT(FLINT_ABS(c));
+   F_mpz_t t;
+   F_mpz_init(t);
+
+   count->calls++;
+
+   for (i = 0; i < n; i += len)
+   {
+      F_mpz * r = res + i;
+      const F_mpz * a = vec1 + i;
+      const F_mpz * b = vec2 + i;
+      len = FLINT_MIN(F_MPZ_VEC_BLOCK, n - i);
+
+      // check all entries are small and bound the entries of vec2
+      big = m = 0;
+      for (j = 0; j < len; j++)
+      {
+         big |= COEFF_IS_MPZ(a[j]) | COEFF_IS_MPZ(b[j]) | COEFF_IS_MPZ(r[j]);
+         m |= FLINT_ABS(b[j]);
+      }
+
+      // |a[j]| and |c*2^exp*b[j]| < 2^(FLINT_BITS - 2), so the sum fits in a long
+      if (!big && FLINT_BIT_COUNT(m) + cbits + exp <= FLINT_BITS - 2)
+      {
+         ulong ovf = 0;
+         
+         for (j = 0; j < len; j++)
+         {
+            long x = a[j] + (long) ((ulong) (c*b[j]) << exp);
+            r[j] = x;
+            ovf |= ((ulong) (x - COEFF_MIN) > (ulong) (COEFF_MAX - COEFF_MIN));
+         }
+         
+         if (ovf)
+         {
+            for (j = 0; j < len; j++)
+            {
+               long x = r[j];
+               if (x < COEFF_MIN || x > COEFF_MAX)
+               {
+                  r[j] = 0;
+                  F_mpz_set_si(r + j, x);
+                  count->promoted++;
+               }
+            }
+         }
+
+         count->fast += len;
+      } else
+      {
+         for (j = 0; j < len; j++)
+         {
+            if (exp == 0 && c == 1L) F_mpz_add(r + j, a + j, b + j);
+            else if (exp == 0 && c == -1L) F_mpz_sub(r + j, a + j, b + j);
+            else
+            {
+               F_mpz_mul_2exp(t, b + j, exp);
+               if (c >= 0) F_mpz_addmul_ui(r + j, t, c);
+               else F_mpz_submul_ui(r + j, t, -c);
+            }
+         }
+
+         count->slow += len;
+      }
+   }
+
+   F_mpz_clear(t);
+}
+
+/*
+   Adds the signed two limb integer hi:lo to f
+*/
+static
+void __F_mpz_add_2limb(F_mpz_t f, mp_limb_t hi, mp_limb_t lo)
+{
+   if (hi == (mp_limb_t) ((long) lo >> (FLINT_BITS - 1))
+      && (long) lo >= COEFF_MIN && (long) lo <= COEFF_MAX && !COEFF_IS_MPZ(*f))
+   {
+      F_mpz_set_si(f, *f + (long) lo);
+      return;
+   }
+
+   int neg = ((long) hi < 0L);
+   if (neg) sub_ddmmss(hi, lo, 0L, 0L, hi, lo);
+
+   mp_limb_t x[2];
+   x[0] = lo;
+   x[1] = hi;
+   
+   F_mpz_t t;
+   F_mpz_init(t);
+   F_mpz_set_limbs(t, x, hi ? 2L : 1L);
+   if (neg) F_mpz_sub(f, f, t);
+   else F_mpz_add(f, f, t);
+   F_mpz_clear(t);
+}
+
+/*
+   Sets hi:lo to the scalar product of the n small integers a[0], a[sa], ... 
+   and b[0], b[sb], ... as a signed, twos complement, two limb integer. The 
+   caller must ensure it fits.
+*/
+static inline
+void __F_mpz_dot_2limb(mp_limb_t * hi, mp_limb_t * lo, const long * a, ulong sa, 
+                                                  const long * b, ulong sb, ulong n)
+{
+   mp_limb_t h = 0, l = 0, ph, pl, neg;
+   ulong i;
+
+   for (i = 0; i < n; i++, a += sa, b += sb)
+   {
+      neg = (mp_limb_t) (((*a) ^ (*b)) >> (FLINT_BITS - 1));
+      umul_ppmm(ph, pl, FLINT_ABS(*a), FLINT_ABS(*b));
+      ph ^= neg;
+      pl ^= neg;
+      add_ssaaaa(ph, pl, ph, pl, 0L, neg & 1L);
+      add_ssaaaa(h, l, h, l, ph, pl);
+   }
+
+   *hi = h;
+   *lo = l;
+}
+
 /*===============================================================================
 
 	Addition/subtraction
@@ -558,17 +930,13 @@ void F_mpz_mat_neg(F_mpz_mat_t mat1, const F_mpz_mat_t mat2)
 void _F_mpz_vec_add(F_mpz * res, const F_mpz * vec1, 
 					                     const F_mpz * vec2, const ulong n)
 {
-   ulong i;
-   for (i = 0; i < n; i++) 
-		F_mpz_add(res + i, vec1 + i, vec2 + i);   
+   __F_mpz_vec_addmul_si_2exp(res, vec1, vec2, n, 1L, 0L, F_mpz_vec_stats + F_MPZ_VEC_ADD);
 }
 
 void _F_mpz_vec_sub(F_mpz * res, const F_mpz * vec1, 
 					                     const F_mpz * vec2, const ulong n)
 {
-   ulong i;
-   for (i = 0; i < n; i++) 
-		F_mpz_sub(res + i, vec1 + i, vec2 + i);   
+   __F_mpz_vec_addmul_si_2exp(res, vec1, vec2, n, -1L, 0L, F_mpz_vec_stats + F_MPZ_VEC_SUB);
 }
 
 void F_mpz_mat_add(F_mpz_mat_t res, const F_mpz_mat_t mat1, const F_mpz_mat_t mat2)
@@ -710,6 +1078,12 @@ void _F_mpz_vec_addmul_ui(F_mpz * vec1, F_mpz * vec2, ulong n, ulong x)
 	if (x == 0L)
 		return;
 	
+   if (x <= COEFF_MAX)
+   {
+      __F_mpz_vec_addmul_si_2exp(vec1, vec1, vec2, n, x, 0L, F_mpz_vec_stats + F_MPZ_VEC_ADDMUL);
+      return;
+   }
+	
 	// special case, multiply by 1
 	if (x == 1L) 
 	{
@@ -731,6 +1105,12 @@ void _F_mpz_vec_addmul_F_mpz(F_mpz * vec1, F_mpz * vec2, ulong n, F_mpz_t x)
 	if ((*x) == 0L)
 		return;
 	
+   if (!COEFF_IS_MPZ(*x))
+   {
+      __F_mpz_vec_addmul_si_2exp(vec1, vec1, vec2, n, *x, 0L, F_mpz_vec_stats + F_MPZ_VEC_ADDMUL);
+      return;
+   }
+	
 	// special case, multiply by 1
 	if ((*x) == 1L) 
 	{
@@ -762,6 +1142,12 @@ void _F_mpz_vec_submul_ui(F_mpz * vec1, F_mpz * vec2, ulong n, ulong x)
 	if (x == 0L)
 		return;
 	
+   if (x <= COEFF_MAX)
+   {
+      __F_mpz_vec_addmul_si_2exp(vec1, vec1, vec2, n, -(long) x, 0L, F_mpz_vec_stats + F_MPZ_VEC_SUBMUL);
+      return;
+   }
+	
 	// special case, multiply by 1
 	if (x == 1L) 
 	{
@@ -783,6 +1169,12 @@ void _F_mpz_vec_submul_F_mpz(F_mpz * vec1, F_mpz * vec2, ulong n, F_mpz_t x)
 	if ((*x) == 0L)
 		return;
 	
+   if (!COEFF_IS_MPZ(*x))
+   {
+      __F_mpz_vec_addmul_si_2exp(vec1, vec1, vec2, n, -(*x), 0L, F_mpz_vec_stats + F_MPZ_VEC_SUBMUL);
+      return;
+   }
+	
 	// special case, multiply by 1
 	if ((*x) == 1L) 
 	{
@@ -816,6 +1208,12 @@ void _F_mpz_vec_addmul_2exp_ui(F_mpz * vec1, F_mpz * vec2, ulong n, ulong c, ulo
 	   return;
 	}
 	
+   if (c <= COEFF_MAX)
+   {
+      __F_mpz_vec_addmul_si_2exp(vec1, vec1, vec2, n, c, exp, F_mpz_vec_stats + F_MPZ_VEC_ADDMUL);
+      return;
+   }
+	
 	// scalar is 1, just add 2^exp times the entry
 	if (c == 1)
 	{
@@ -865,6 +1263,12 @@ void _F_mpz_vec_submul_2exp_ui(F_mpz * vec1, F_mpz * vec2, ulong n, ulong c, ulo
 	   return;
 	}
 	
+   if (c <= COEFF_MAX)
+   {
+      __F_mpz_vec_addmul_si_2exp(vec1, vec1, vec2, n, -(long) c, exp, F_mpz_vec_stats + F_MPZ_VEC_SUBMUL);
+      return;
+   }
+	
 	// scalar is 1, just subtract 2^exp times the entry
 	if (c == 1)
 	{
@@ -914,6 +1318,12 @@ void _F_mpz_vec_submul_2exp_F_mpz(F_mpz * vec1, F_mpz * vec2, ulong n, F_mpz_t c
 	   return;
 	}
 	
+   if (!COEFF_IS_MPZ(*c))
+   {
+      __F_mpz_vec_addmul_si_2exp(vec1, vec1, vec2, n, -(*c), exp, F_mpz_vec_stats + F_MPZ_VEC_SUBMUL);
+      return;
+   }
+	
 	// scalar is 1, just subtract 2^exp times the entry
 	if (F_mpz_is_one(c) || F_mpz_is_m1(c))
 	{
@@ -972,6 +1382,137 @@ void _F_mpz_vec_submul_2exp_F_mpz(F_mpz * vec1, F_mpz * vec2, ulong n, F_mpz_t c
 
 =========================================================================================================*/
 
+int _F_mpz_mat_mul_small(F_mpz_mat_t res, const F_mpz_mat_t mat1, const F_mpz_mat_t mat2)
+{
+   ulong r1 = mat1->r;
+   ulong c1 = mat1->c;
+   ulong c2 = mat2->c;
+   ulong i, j, k, j0, k0, jlen, klen;
+
+   ulong b1 = FLINT_ABS(F_mpz_mat_max_bits(mat1));
+   ulong b2 = FLINT_ABS(F_mpz_mat_max_bits(mat2));
+
+   if (b1 > FLINT_BITS - 2 || b2 > FLINT_BITS - 2)
+      return 0;
+
+   // all partial sums of entries of the product are less than 2^bits in absolute value
+   ulong bits = b1 + b2 + FLINT_BIT_COUNT(c1);
+
+   if (bits <= 53) // exact in doubles
+   {
+      double ** A = d_mat_init(r1, c1);
+      double ** B = d_mat_init(c1, c2);
+      double ** C = d_mat_init(r1, c2);
+
+      for (i = 0; i < r1; i++)
+      {
+         for (k = 0; k < c1; k++)
+            A[i][k] = (double) F_mpz_get_si(mat1->rows[i] + k);
+         for (j = 0; j < c2; j++)
+            C[i][j] = 0.0;
+      }
+      for (k = 0; k < c1; k++)
+         for (j = 0; j < c2; j++)
+            B[k][j] = (double) F_mpz_get_si(mat2->rows[k] + j);
+
+      // C += A*B, a tile of B at a time
+      for (j0 = 0; j0 < c2; j0 += jlen)
+      {
+         jlen = FLINT_MIN(F_MPZ_MAT_MUL_TILE_J, c2 - j0);
+         for (k0 = 0; k0 < c1; k0 += klen)
+         {
+            klen = FLINT_MIN(F_MPZ_MAT_MUL_TILE_K, c1 - k0);
+            for (i = 0; i < r1; i++)
+               for (k = k0; k < k0 + klen; k++)
+                  if (A[i][k] != 0.0)
+                     _d_vec_addmul(C[i] + j0, B[k] + j0, jlen, A[i][k]);
+         }
+      }
+
+      for (i = 0; i < r1; i++)
+         for (j = 0; j < c2; j++)
+            F_mpz_set_si(res->rows[i] + j, (long) C[i][j]);
+
+      d_mat_clear(A);
+      d_mat_clear(B);
+      d_mat_clear(C);
+   } else if (bits <= FLINT_BITS - 1) // exact in a limb
+   {
+      long * A = (long *) flint_heap_alloc(r1*c1 + 1);
+      long * B = (long *) flint_heap_alloc(c1*c2 + 1);
+      long * C = (long *) flint_heap_alloc(r1*c2 + 1);
+
+      for (i = 0; i < r1; i++)
+         for (k = 0; k < c1; k++)
+            A[i*c1 + k] = F_mpz_get_si(mat1->rows[i] + k);
+      for (k = 0; k < c1; k++)
+         for (j = 0; j < c2; j++)
+            B[k*c2 + j] = F_mpz_get_si(mat2->rows[k] + j);
+      for (i = 0; i < r1*c2; i++)
+         C[i] = 0L;
+
+      for (j0 = 0; j0 < c2; j0 += jlen)
+      {
+         jlen = FLINT_MIN(F_MPZ_MAT_MUL_TILE_J, c2 - j0);
+         for (k0 = 0; k0 < c1; k0 += klen)
+         {
+            klen = FLINT_MIN(F_MPZ_MAT_MUL_TILE_K, c1 - k0);
+            for (i = 0; i < r1; i++)
+            {
+               long * Ci = C + i*c2 + j0;
+               for (k = k0; k < k0 + klen; k++)
+               {
+                  long a = A[i*c1 + k];
+                  long * Bk = B + k*c2 + j0;
+                  if (a != 0L)
+                     for (j = 0; j < jlen; j++)
+                        Ci[j] += a*Bk[j];
+               }
+            }
+         }
+      }
+
+      for (i = 0; i < r1; i++)
+         for (j = 0; j < c2; j++)
+            F_mpz_set_si(res->rows[i] + j, C[i*c2 + j]);
+
+      flint_heap_free(A);
+      flint_heap_free(B);
+      flint_heap_free(C);
+   } else if (bits <= 2*FLINT_BITS - 1) // exact in two limbs
+   {
+      // scalar products of rows of A with rows of B^T, a tile of F_MPZ_MAT_MUL_TILE_J 
+      // rows of B^T, i.e. columns of the product, at a time, reused for every row of A
+      long * A = (long *) flint_heap_alloc(r1*c1 + 1);
+      long * Bt = (long *) flint_heap_alloc(c1*c2 + 1);
+      mp_limb_t hi, lo;
+
+      for (i = 0; i < r1; i++)
+         for (k = 0; k < c1; k++)
+            A[i*c1 + k] = F_mpz_get_si(mat1->rows[i] + k);
+      for (k = 0; k < c1; k++)
+         for (j = 0; j < c2; j++)
+            Bt[j*c1 + k] = F_mpz_get_si(mat2->rows[k] + j);
+
+      for (j0 = 0; j0 < c2; j0 += jlen)
+      {
+         jlen = FLINT_MIN(F_MPZ_MAT_MUL_TILE_J, c2 - j0);
+         for (i = 0; i < r1; i++)
+            for (j = j0; j < j0 + jlen; j++)
+            {
+               __F_mpz_dot_2limb(&hi, &lo, A + i*c1, 1, Bt + j*c1, 1, c1);
+               __F_mpz_add_2limb(res->rows[i] + j, hi, lo);
+            }
+      }
+
+      flint_heap_free(A);
+      flint_heap_free(Bt);
+   } else 
+      return 0;
+
+   return 1;
+}
+
 void _F_mpz_mat_mul_classical(F_mpz_mat_t res, const F_mpz_mat_t mat1, const F_mpz_mat_t mat2)
 {
    //res=mat1*mat2
@@ -987,6 +1528,9 @@ void _F_mpz_mat_mul_classical(F_mpz_mat_t res, const F_mpz_mat_t mat1, const F_m
    F_mpz_mat_clear(res);
    F_mpz_mat_init(res,r1,c2);
 
+   if (_F_mpz_mat_mul_small(res, mat1, mat2))
+      return;
+
    ulong i, j, c;
    for (i = 0; i < r1; i++) // add up to the length of the shorter mat
       for (j = 0; j < c2; j++)
@@ -1125,12 +1669,51 @@ void F_mpz_mat_div_2exp(F_mpz_mat_t res, F_mpz_mat_t M, ulong n)
 
 void _F_mpz_vec_scalar_product(F_mpz_t sp, F_mpz * vec1, F_mpz * vec2, ulong n)
 {
-	ulong i;
-   
-   F_mpz_mul2(sp, vec1, vec2);
+	ulong i, j, len, big, m1, m2, bits;
+   F_mpz_vec_count_t * count = F_mpz_vec_stats + F_MPZ_VEC_SCALAR_PRODUCT;
    
-   for (i = 1; i < n; i++)
-      F_mpz_addmul(sp, vec1 + i, vec2 + i);
+   count->calls++;
+
+   F_mpz_zero(sp);
+
+   for (i = 0; i < n; i += len)
+   {
+      const F_mpz * a = vec1 + i;
+      const F_mpz * b = vec2 + i;
+      len = FLINT_MIN(F_MPZ_VEC_BLOCK, n - i);
+
+      big = m1 = m2 = 0;
+      for (j = 0; j < len; j++)
+      {
+         big |= COEFF_IS_MPZ(a[j]) | COEFF_IS_MPZ(b[j]);
+         m1 |= FLINT_ABS(a[j]);
+         m2 |= FLINT_ABS(b[j]);
+      }
+
+      // the sum of the products of the block is less than 2^bits in absolute value
+      bits = FLINT_BIT_COUNT(m1) + FLINT_BIT_COUNT(m2) + FLINT_BIT_COUNT(len);
+      
+      if (!big && bits <= FLINT_BITS - 1)
+      {
+         long s = 0;
+         for (j = 0; j < len; j++)
+            s += a[j]*b[j];
+
+         __F_mpz_add_2limb(sp, (mp_limb_t) (s >> (FLINT_BITS - 1)), s);
+         count->fast += len;
+      } else if (!big && bits <= 2*FLINT_BITS - 1)
+      {
+         mp_limb_t hi, lo;
+         __F_mpz_dot_2limb(&hi, &lo, a, 1, b, 1, len);
+         __F_mpz_add_2limb(sp, hi, lo);
+         count->fast += len;
+      } else
+      {
+         for (j = 0; j < len; j++)
+            F_mpz_addmul(sp, a + j, b + j);
+         count->slow += len;
+      }
+   }
 
    return;
 }
@@ -39,6 +39,7 @@
 #include "flint.h"
 #include "mpz_mat.h"
 #include "F_mpz.h"
+#include "flint-tuning.h"
 
 /*==============================================================================
 
@@ -183,6 +184,24 @@ int F_mpz_mat_fread(F_mpz_mat_t mat, FILE * f);
 */
 int F_mpz_mat_fread_pretty(F_mpz_mat_t mat, FILE * f);
 
+/** 
+   \fn     int F_mpz_mat_fwrite_bin(const F_mpz_mat_t mat, FILE * f)
+	\brief  Writes mat to the binary stream f a row at a time, in the binary 
+           format described in mpn_extras.h and F_mpz.h. Returns 1 on 
+           success, 0 on failure.
+*/
+int F_mpz_mat_fwrite_bin(const F_mpz_mat_t mat, FILE * f);
+
+/** 
+   \fn     int F_mpz_mat_fread_bin(F_mpz_mat_t mat, FILE * f)
+	\brief  Reads a matrix written by F_mpz_mat_fwrite_bin from f a row at a 
+           time, reinitialising mat to the right dimensions. Returns 0 if the
+           data is not a valid matrix, including if the dimensions or the 
+           limb count in the header are inconsistent with each other or 
+           with the length of f, in which case nothing is allocated.
+*/
+int F_mpz_mat_fread_bin(F_mpz_mat_t mat, FILE * f);
+
 /*===============================================================================
 
 	Conversions
@@ -208,6 +227,12 @@ void F_mpz_mat_to_mpz_mat(mpz_mat_t m_mat, const F_mpz_mat_t F_mat);
 */
 long _F_mpz_vec_to_d_vec_2exp(double * appv, const F_mpz * vec, const ulong n);
 
+/** 
+   \fn     long _F_mpz_vec_to_ld_vec_2exp(long double * appv, const F_mpz * vec, const ulong n)
+   \brief  As per _F_mpz_vec_to_d_vec_2exp but with long double mantissas.
+*/
+long _F_mpz_vec_to_ld_vec_2exp(long double * appv, const F_mpz * vec, const ulong n);
+
 /** 
    \fn     void _F_mpz_vec_to_mpfr_vec(mpfr_t * appv, const F_mpz * vec, const ulong n)
    \brief  Sets the entries of appv to the entries of the given vec.
@@ -345,6 +370,100 @@ int _F_mpz_vec_equal(F_mpz * vec1, const F_mpz * vec2, ulong n)
    return 1;
 }
 
+/*===============================================================================
+
+	Vector input/output
+
+================================================================================*/
+
+/** 
+   \fn     ulong _F_mpz_vec_size_bin(const F_mpz * vec, ulong n)
+   \brief  Returns the number of limbs required to store the n integers of 
+           vec in binary format. This is n if and only if they are all small.
+*/
+ulong _F_mpz_vec_size_bin(const F_mpz * vec, ulong n);
+
+/** 
+   \fn     int _F_mpz_vec_fwrite_bin(const F_mpz * vec, ulong n, FILE * f)
+   \brief  Writes the n integers of vec to f in binary format. Returns 1 on
+           success, 0 on failure.
+*/
+int _F_mpz_vec_fwrite_bin(const F_mpz * vec, ulong n, FILE * f);
+
+/** 
+   \fn     int _F_mpz_vec_fread_bin(F_mpz * vec, ulong n, FILE * f, 
+                                                const F_mpn_bin_header_t hdr)
+   \brief  Reads n integers in binary format from f into vec, using the 
+           byte order and flags of the given header. Returns 0 if the data 
+           cannot be read or is invalid, in which case vec is left with 
+           arbitrary valid values. No integer is allowed more limbs than 
+           the payload size given by the header.
+*/
+int _F_mpz_vec_fread_bin(F_mpz * vec, ulong n, FILE * f, const F_mpn_bin_header_t hdr);
+
+/** 
+   \fn     int _F_mpz_vec_set_bin(F_mpz * vec, ulong n, const mp_limb_t * data,
+                                   ulong limbs, const F_mpn_bin_header_t hdr)
+   \brief  As per _F_mpz_vec_fread_bin, but reads the integers from the given
+           limbs of data, all of which must be used.
+*/
+int _F_mpz_vec_set_bin(F_mpz * vec, ulong n, const mp_limb_t * data, 
+                                    ulong limbs, const F_mpn_bin_header_t hdr);
+
+/*===============================================================================
+
+	Small entries
+
+================================================================================*/
+
+/*
+   The _F_mpz_vec addition, subtraction, addmul/submul and scalar product 
+   functions work on blocks of F_MPZ_VEC_BLOCK entries. If all entries of a 
+   block are small, and the results are known to fit in a limb, the block is 
+   processed by branch free code which the compiler can vectorise. Results 
+   which no longer fit in an F_mpz are promoted afterwards. Other blocks are 
+   processed an entry at a time in the usual way.
+
+   For each operation, F_mpz_vec_stats counts the calls, the entries handled
+   by the fast and the general code and the number of results promoted.
+   The counters are declared THREAD, so in a FLINT_OPENMP=1 build each 
+   thread has its own, and F_mpz_vec_stats_reset and F_mpz_vec_stats_print 
+   only see those of the calling thread. Otherwise FLINT is not thread 
+   safe and there is a single set of counters.
+*/
+
+#define F_MPZ_VEC_BLOCK (flint_tuning.F_mpz_vec_block)
+
+#define F_MPZ_VEC_ADD 0
+#define F_MPZ_VEC_SUB 1
+#define F_MPZ_VEC_ADDMUL 2
+#define F_MPZ_VEC_SUBMUL 3
+#define F_MPZ_VEC_SCALAR_PRODUCT 4
+#define F_MPZ_VEC_OPS 5
+
+typedef struct
+{
+   ulong calls;
+   ulong fast; // entries processed by the branch free code
+   ulong slow; // entries processed one at a time
+   ulong promoted;
+} F_mpz_vec_count_t;
+
+extern THREAD F_mpz_vec_count_t F_mpz_vec_stats[F_MPZ_VEC_OPS];
+
+/** 
+   \fn     void F_mpz_vec_stats_reset(void)
+   \brief  Sets all the counters in F_mpz_vec_stats to zero.
+*/
+void F_mpz_vec_stats_reset(void);
+
+/** 
+   \fn     void F_mpz_vec_stats_print(void)
+   \brief  Prints the counters in F_mpz_vec_stats, with the proportion of
+           entries handled by the fast code for each operation.
+*/
+void F_mpz_vec_stats_print(void);
+
 /*===============================================================================
 
 	Addition/subtraction
@@ -497,6 +616,26 @@ void _F_mpz_vec_neg(F_mpz * vec1, F_mpz * vec2, ulong n)
 
 =========================================================================================================*/
 
+/*
+   Tile sizes for the multiplication of matrices with small entries, in 
+   entries of the inner dimension and columns of the product.
+*/
+#define F_MPZ_MAT_MUL_TILE_K (flint_tuning.F_mpz_mat_mul_tile_k)
+#define F_MPZ_MAT_MUL_TILE_J (flint_tuning.F_mpz_mat_mul_tile_j)
+
+/** 
+   \fn     int _F_mpz_mat_mul_small(F_mpz_mat_t res, const F_mpz_mat_t mat1,
+                                                  const F_mpz_mat_t mat2)
+
+	\brief  Sets res, which must be a zero matrix of the correct dimensions,
+           to mat1*mat2 if the bounds given by F_mpz_mat_max_bits allow 
+           every entry of the product to be accumulated exactly in doubles, 
+           in a limb or in two limbs. Returns 1 if so, otherwise returns 0
+           and leaves res unchanged. Not alias safe.
+*/
+int _F_mpz_mat_mul_small(F_mpz_mat_t res, const F_mpz_mat_t mat1,
+                                                  const F_mpz_mat_t mat2);
+
 /** 
    \fn     void _F_mpz_mat_mul_classical(F_mpz_mat_t res, const F_mpz_mat_t mat1,
                                                   const F_mpz_mat_t mat2)
@@ -1396,6 +1396,415 @@ int test_F_mpz_mod_poly_divrem_divconquer()
    return result;
 }
 
+int test_F_mpz_mod_poly_mul_trunc_n()
+{
+   F_mpz_mod_poly_t F_poly1, F_poly2, F_poly3, F_poly4;
+   int result = 1;
+   ulong bits, length1, length2, trunc;
+   F_mpz_t P;
+   
+   F_mpz_init(P);
+     
+   for (ulong count1 = 0; (count1 < 500*ITER) && (result == 1) ; count1++)
+   {
+		bits = z_randint(200) + 2;
+      length1 = z_randint(200);
+		length2 = z_randint(200);
+      trunc = z_randint(400);
+     
+      F_mpz_random_prime_modulus(P, bits);
+      F_mpz_mod_poly_init(F_poly1, P);
+      F_mpz_mod_poly_init(F_poly2, P);
+      F_mpz_mod_poly_init(F_poly3, P);
+      F_mpz_mod_poly_init(F_poly4, P);
+
+      F_mpz_mod_randpoly(F_poly1, length1, bits);
+      F_mpz_mod_randpoly(F_poly2, length2, bits);
+      
+		F_mpz_mod_poly_mul(F_poly3, F_poly1, F_poly2);
+      F_mpz_mod_poly_truncate(F_poly3, trunc);
+      
+      if (z_randint(2)) F_mpz_mod_poly_mul_trunc_n(F_poly4, F_poly1, F_poly2, trunc);
+      else 
+      {
+         F_mpz_mod_poly_set(F_poly4, F_poly1);
+         F_mpz_mod_poly_mul_trunc_n(F_poly4, F_poly4, F_poly2, trunc); // test aliasing
+      }
+
+      result = F_mpz_mod_poly_equal(F_poly3, F_poly4); 
+		if (!result) 
+		{
+			printf("Error: length1 = %ld, length2 = %ld, trunc = %ld, bits = %ld\n", F_poly1->length, F_poly2->length, trunc, bits);
+         F_mpz_mod_poly_print(F_poly3); printf("\n");
+         F_mpz_mod_poly_print(F_poly4); printf("\n");
+		}
+          
+      F_mpz_mod_poly_clear(F_poly1);
+		F_mpz_mod_poly_clear(F_poly2);
+		F_mpz_mod_poly_clear(F_poly3);
+		F_mpz_mod_poly_clear(F_poly4);
+   }
+      
+   F_mpz_clear(P);
+   
+   return result;
+}
+
+int test_F_mpz_mod_poly_newton_invert()
+{
+   F_mpz_mod_poly_t F_poly1, F_poly2, F_poly3;
+   int result = 1;
+   ulong bits, length, n;
+   F_mpz_t P;
+   
+   F_mpz_init(P);
+     
+   for (ulong count1 = 0; (count1 < 500*ITER) && (result == 1) ; count1++)
+   {
+		bits = z_randint(200) + 2;
+      length = z_randint(300) + 1;
+      n = z_randint(300) + 1;
+     
+      F_mpz_random_prime_modulus(P, bits);
+      F_mpz_mod_poly_init(F_poly1, P);
+      F_mpz_mod_poly_init(F_poly2, P);
+      F_mpz_mod_poly_init(F_poly3, P);
+
+      do {F_mpz_mod_randpoly(F_poly1, length, bits);} 
+      while ((F_poly1->length == 0) || F_mpz_is_zero(F_poly1->coeffs));
+      
+      F_mpz_mod_poly_newton_invert(F_poly2, F_poly1, n);
+		F_mpz_mod_poly_mul_trunc_n(F_poly3, F_poly1, F_poly2, n);
+
+      result = ((F_poly3->length == 1) && F_mpz_is_one(F_poly3->coeffs)); 
+		if (!result) 
+		{
+			printf("Error: length = %ld, n = %ld, bits = %ld\n", F_poly1->length, n, bits);
+         F_mpz_mod_poly_print(F_poly3); printf("\n");
+		}
+          
+      F_mpz_mod_poly_clear(F_poly1);
+		F_mpz_mod_poly_clear(F_poly2);
+		F_mpz_mod_poly_clear(F_poly3);
+   }
+      
+   F_mpz_clear(P);
+   
+   return result;
+}
+
+int test_F_mpz_mod_poly_divrem_newton()
+{
+   F_mpz_mod_poly_t F_poly1, F_poly2, F_poly3, Q, R;
+   int result = 1;
+   ulong bits, length1, length2;
+   F_mpz_t P;
+   
+   F_mpz_init(P);
+     
+   for (ulong count1 = 0; (count1 < 500*ITER) && (result == 1) ; count1++)
+   {
+		bits = z_randint(200) + 2;
+      length1 = z_randint(500);
+		length2 = z_randint(500) + 1;
+     
+      F_mpz_random_prime_modulus(P, bits);
+      F_mpz_mod_poly_init(F_poly1, P);
+      F_mpz_mod_poly_init(F_poly2, P);
+      F_mpz_mod_poly_init(F_poly3, P);
+      F_mpz_mod_poly_init(Q, P);
+      F_mpz_mod_poly_init(R, P);
+
+      F_mpz_mod_randpoly(F_poly1, length1, bits);
+      do {F_mpz_mod_randpoly(F_poly2, length2, bits);} while (F_poly2->length == 0);
+      
+		F_mpz_mod_poly_divrem_newton(Q, R, F_poly1, F_poly2);
+      F_mpz_mod_poly_mul(F_poly3, Q, F_poly2);
+      F_mpz_mod_poly_add(F_poly3, F_poly3, R);
+      
+      result = (F_mpz_mod_poly_equal(F_poly3, F_poly1) && (R->length < F_poly2->length)); 
+		if (!result) 
+		{
+			printf("Error: length1 = %ld, length2 = %ld, bits = %ld\n", F_poly1->length, F_poly2->length, bits);
+         F_mpz_mod_poly_print(F_poly3); printf("\n");
+         F_mpz_mod_poly_print(F_poly1); printf("\n");
+		}
+
+      F_mpz_mod_poly_divrem_newton(F_poly3, F_poly1, F_poly1, F_poly2); // test aliasing
+      result &= (F_mpz_mod_poly_equal(F_poly3, Q) && F_mpz_mod_poly_equal(F_poly1, R));
+      if (!result) printf("Error: aliasing, length2 = %ld, bits = %ld\n", F_poly2->length, bits);
+          
+      F_mpz_mod_poly_clear(F_poly1);
+		F_mpz_mod_poly_clear(F_poly2);
+		F_mpz_mod_poly_clear(F_poly3);
+		F_mpz_mod_poly_clear(Q);
+		F_mpz_mod_poly_clear(R);
+   }
+      
+   F_mpz_clear(P);
+   
+   return result;
+}
+
+int test_F_mpz_mod_poly_divrem()
+{
+   F_mpz_mod_poly_t F_poly1, F_poly2, Q, R, Q2, R2;
+   int result = 1;
+   ulong bits, length1, length2;
+   F_mpz_t P;
+   
+   F_mpz_init(P);
+     
+   for (ulong count1 = 0; (count1 < 200*ITER) && (result == 1) ; count1++)
+   {
+		bits = z_randint(200) + 2;
+      length1 = z_randint(1000);
+		length2 = z_randint(500) + 1;
+     
+      F_mpz_random_prime_modulus(P, bits);
+      F_mpz_mod_poly_init(F_poly1, P);
+      F_mpz_mod_poly_init(F_poly2, P);
+      F_mpz_mod_poly_init(Q, P);
+      F_mpz_mod_poly_init(R, P);
+      F_mpz_mod_poly_init(Q2, P);
+      F_mpz_mod_poly_init(R2, P);
+
+      F_mpz_mod_randpoly(F_poly1, length1, bits);
+      do {F_mpz_mod_randpoly(F_poly2, length2, bits);} while (F_poly2->length == 0);
+      
+		F_mpz_mod_poly_divrem(Q, R, F_poly1, F_poly2);
+		F_mpz_mod_poly_divrem_basecase(Q2, R2, F_poly1, F_poly2);
+      
+      result = (F_mpz_mod_poly_equal(Q, Q2) && F_mpz_mod_poly_equal(R, R2)); 
+		if (!result) 
+		{
+			printf("Error: length1 = %ld, length2 = %ld, bits = %ld\n", F_poly1->length, F_poly2->length, bits);
+         F_mpz_mod_poly_print(Q); printf("\n");
+         F_mpz_mod_poly_print(Q2); printf("\n");
+		}
+          
+      F_mpz_mod_poly_clear(F_poly1);
+		F_mpz_mod_poly_clear(F_poly2);
+		F_mpz_mod_poly_clear(Q);
+		F_mpz_mod_poly_clear(R);
+		F_mpz_mod_poly_clear(Q2);
+		F_mpz_mod_poly_clear(R2);
+   }
+      
+   F_mpz_clear(P);
+   
+   return result;
+}
+
+int test_F_mpz_mod_poly_mulmod()
+{
+   F_mpz_mod_poly_t F_poly1, F_poly2, F_poly3, F_poly4, F_poly5;
+   int result = 1;
+   ulong bits, length1, length2, length3;
+   F_mpz_t P;
+   
+   F_mpz_init(P);
+     
+   for (ulong count1 = 0; (count1 < 500*ITER) && (result == 1) ; count1++)
+   {
+		bits = z_randint(200) + 2;
+      length1 = z_randint(300);
+		length2 = z_randint(300);
+		length3 = z_randint(300) + 1;
+     
+      F_mpz_random_prime_modulus(P, bits);
+      F_mpz_mod_poly_init(F_poly1, P);
+      F_mpz_mod_poly_init(F_poly2, P);
+      F_mpz_mod_poly_init(F_poly3, P);
+      F_mpz_mod_poly_init(F_poly4, P);
+      F_mpz_mod_poly_init(F_poly5, P);
+
+      F_mpz_mod_randpoly(F_poly1, length1, bits);
+      F_mpz_mod_randpoly(F_poly2, length2, bits);
+      do {F_mpz_mod_randpoly(F_poly3, length3, bits);} while (F_poly3->length == 0);
+      
+		F_mpz_mod_poly_mul(F_poly4, F_poly1, F_poly2);
+		F_mpz_mod_poly_rem(F_poly4, F_poly4, F_poly3);
+      F_mpz_mod_poly_mulmod(F_poly1, F_poly1, F_poly2, F_poly3); // test aliasing
+      
+      result = F_mpz_mod_poly_equal(F_poly1, F_poly4); 
+		if (!result) 
+		{
+			printf("Error: length1 = %ld, length2 = %ld, length3 = %ld, bits = %ld\n", length1, F_poly2->length, F_poly3->length, bits);
+         F_mpz_mod_poly_print(F_poly1); printf("\n");
+         F_mpz_mod_poly_print(F_poly4); printf("\n");
+		}
+          
+      F_mpz_mod_poly_clear(F_poly1);
+		F_mpz_mod_poly_clear(F_poly2);
+		F_mpz_mod_poly_clear(F_poly3);
+		F_mpz_mod_poly_clear(F_poly4);
+		F_mpz_mod_poly_clear(F_poly5);
+   }
+      
+   F_mpz_clear(P);
+   
+   return result;
+}
+
+int test_F_mpz_mod_poly_powmod()
+{
+   F_mpz_mod_poly_t F_poly1, F_poly2, F_poly3, F_poly4;
+   int result = 1;
+   ulong bits, length1, length2, exp;
+   F_mpz_t P, e1, e2;
+   
+   F_mpz_init(P);
+   F_mpz_init(e1);
+   F_mpz_init(e2);
+     
+   // compare with repeated multiplication
+   for (ulong count1 = 0; (count1 < 300*ITER) && (result == 1) ; count1++)
+   {
+		bits = z_randint(200) + 2;
+      length1 = z_randint(200);
+		length2 = z_randint(200) + 1;
+      exp = z_randint(20);
+     
+      F_mpz_random_prime_modulus(P, bits);
+      F_mpz_mod_poly_init(F_poly1, P);
+      F_mpz_mod_poly_init(F_poly2, P);
+      F_mpz_mod_poly_init(F_poly3, P);
+      F_mpz_mod_poly_init(F_poly4, P);
+
+      F_mpz_mod_randpoly(F_poly1, length1, bits);
+      do {F_mpz_mod_randpoly(F_poly2, length2, bits);} while (F_poly2->length == 0);
+      
+      F_mpz_mod_poly_fit_length(F_poly4, 1);
+      F_mpz_set_ui(F_poly4->coeffs, 1L);
+      _F_mpz_mod_poly_set_length(F_poly4, 1);
+      F_mpz_mod_poly_rem(F_poly4, F_poly4, F_poly2);
+      for (ulong i = 0; i < exp; i++)
+         F_mpz_mod_poly_mulmod(F_poly4, F_poly4, F_poly1, F_poly2);
+
+      F_mpz_mod_poly_powmod(F_poly3, F_poly1, exp, F_poly2);
+      
+      result = F_mpz_mod_poly_equal(F_poly3, F_poly4); 
+		if (!result) 
+		{
+			printf("Error: length1 = %ld, length2 = %ld, exp = %ld, bits = %ld\n", F_poly1->length, F_poly2->length, exp, bits);
+         F_mpz_mod_poly_print(F_poly3); printf("\n");
+         F_mpz_mod_poly_print(F_poly4); printf("\n");
+		}
+          
+      F_mpz_mod_poly_clear(F_poly1);
+		F_mpz_mod_poly_clear(F_poly2);
+		F_mpz_mod_poly_clear(F_poly3);
+		F_mpz_mod_poly_clear(F_poly4);
+   }
+      
+   // check a^e1 * a^e2 = a^(e1 + e2) for large exponents
+   for (ulong count1 = 0; (count1 < 100*ITER) && (result == 1) ; count1++)
+   {
+		bits = z_randint(200) + 2;
+      length1 = z_randint(200);
+		length2 = z_randint(200) + 1;
+     
+      F_mpz_random_prime_modulus(P, bits);
+      F_mpz_mod_poly_init(F_poly1, P);
+      F_mpz_mod_poly_init(F_poly2, P);
+      F_mpz_mod_poly_init(F_poly3, P);
+      F_mpz_mod_poly_init(F_poly4, P);
+
+      F_mpz_mod_randpoly(F_poly1, length1, bits);
+      do {F_mpz_mod_randpoly(F_poly2, length2, bits);} while (F_poly2->length == 0);
+      F_mpz_random_modulus(e1, z_randint(200) + 1);
+      F_mpz_random_modulus(e2, z_randint(200) + 1);
+      
+      F_mpz_mod_poly_powmod_F_mpz(F_poly3, F_poly1, e1, F_poly2);
+      F_mpz_mod_poly_powmod_F_mpz(F_poly4, F_poly1, e2, F_poly2);
+      F_mpz_mod_poly_mulmod(F_poly3, F_poly3, F_poly4, F_poly2);
+      F_mpz_add(e1, e1, e2);
+      F_mpz_mod_poly_powmod_F_mpz(F_poly1, F_poly1, e1, F_poly2); // test aliasing
+      
+      result = F_mpz_mod_poly_equal(F_poly1, F_poly3); 
+		if (!result) 
+		{
+			printf("Error: length2 = %ld, bits = %ld\n", F_poly2->length, bits);
+         F_mpz_mod_poly_print(F_poly1); printf("\n");
+         F_mpz_mod_poly_print(F_poly3); printf("\n");
+		}
+          
+      F_mpz_mod_poly_clear(F_poly1);
+		F_mpz_mod_poly_clear(F_poly2);
+		F_mpz_mod_poly_clear(F_poly3);
+		F_mpz_mod_poly_clear(F_poly4);
+   }
+      
+   F_mpz_clear(e2);
+   F_mpz_clear(e1);
+   F_mpz_clear(P);
+   
+   return result;
+}
+
+int test_F_mpz_mod_poly_gcd()
+{
+   F_mpz_mod_poly_t F_poly1, F_poly2, F_poly3, F_poly4, R;
+   int result = 1;
+   ulong bits, length1, length2, length3;
+   F_mpz_t P;
+   
+   F_mpz_init(P);
+     
+   for (ulong count1 = 0; (count1 < 300*ITER) && (result == 1) ; count1++)
+   {
+		bits = z_randint(200) + 2;
+      length1 = z_randint(150);
+		length2 = z_randint(150);
+		length3 = z_randint(100) + 1;
+     
+      F_mpz_random_prime_modulus(P, bits);
+      F_mpz_mod_poly_init(F_poly1, P);
+      F_mpz_mod_poly_init(F_poly2, P);
+      F_mpz_mod_poly_init(F_poly3, P);
+      F_mpz_mod_poly_init(F_poly4, P);
+      F_mpz_mod_poly_init(R, P);
+
+      F_mpz_mod_randpoly(F_poly1, length1, bits);
+      F_mpz_mod_randpoly(F_poly2, length2, bits);
+      do {F_mpz_mod_randpoly(F_poly3, length3, bits);} while (F_poly3->length == 0);
+      
+      F_mpz_mod_poly_mul(F_poly1, F_poly1, F_poly3);
+      F_mpz_mod_poly_mul(F_poly2, F_poly2, F_poly3);
+      F_mpz_mod_poly_gcd(F_poly4, F_poly1, F_poly2);
+
+      // F_poly3 must divide the gcd, which must be monic and divide both inputs
+      if ((F_poly1->length == 0) && (F_poly2->length == 0))
+         result = (F_poly4->length == 0);
+      else
+      {
+         result = F_mpz_is_one(F_poly4->coeffs + F_poly4->length - 1);
+         F_mpz_mod_poly_rem(R, F_poly4, F_poly3);
+         result &= (R->length == 0);
+         F_mpz_mod_poly_rem(R, F_poly1, F_poly4);
+         result &= (R->length == 0);
+         F_mpz_mod_poly_rem(R, F_poly2, F_poly4);
+         result &= (R->length == 0);
+      }
+		if (!result) 
+		{
+			printf("Error: length1 = %ld, length2 = %ld, length3 = %ld, bits = %ld\n", F_poly1->length, F_poly2->length, F_poly3->length, bits);
+         F_mpz_mod_poly_print(F_poly4); printf("\n");
+		}
+          
+      F_mpz_mod_poly_clear(F_poly1);
+		F_mpz_mod_poly_clear(F_poly2);
+		F_mpz_mod_poly_clear(F_poly3);
+		F_mpz_mod_poly_clear(F_poly4);
+		F_mpz_mod_poly_clear(R);
+   }
+      
+   F_mpz_clear(P);
+   
+   return result;
+}
+
 void F_mpz_mod_poly_test_all()
 {
    int success, all_success = 1;
@@ -1418,6 +1827,13 @@ void F_mpz_mod_poly_test_all()
    RUN_TEST(F_mpz_mod_poly_mul_trunc_left); 
    RUN_TEST(F_mpz_mod_poly_divrem_basecase); 
    RUN_TEST(F_mpz_mod_poly_divrem_divconquer);
+   RUN_TEST(F_mpz_mod_poly_mul_trunc_n); 
+   RUN_TEST(F_mpz_mod_poly_newton_invert); 
+   RUN_TEST(F_mpz_mod_poly_divrem_newton); 
+   RUN_TEST(F_mpz_mod_poly_divrem); 
+   RUN_TEST(F_mpz_mod_poly_mulmod); 
+   RUN_TEST(F_mpz_mod_poly_powmod); 
+   RUN_TEST(F_mpz_mod_poly_gcd); 
    
    printf(all_success ? "\nAll tests passed\n" :
                         "\nAt least one test FAILED!\n");
@@ -414,16 +414,93 @@ void F_mpz_mod_poly_scalar_mul(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t pol1
 
 ****************************************************************************/
 
+/*
+   Set res to pol1*pol2, reducing the coefficients with the modulus context 
+   ctx. Deals with zero inputs and aliasing.
+*/
+static
+void __F_mpz_mod_poly_mul(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t pol1, 
+                            const F_mpz_mod_poly_t pol2, const F_mpz_mod_ctx_t ctx)
+{
+   if ((pol1->length == 0) || (pol2->length == 0)) // special case if either poly is zero
+   {
+      F_mpz_mod_poly_zero(res);
+      return;
+   }
+
+   F_mpz_poly_t p1, p2, r;
+   
+   if (pol1->length >= pol2->length)
+   {
+      _F_mpz_poly_attach_F_mpz_mod_poly(p1, pol1);
+      _F_mpz_poly_attach_F_mpz_mod_poly(p2, pol2);
+   } else
+   {
+      _F_mpz_poly_attach_F_mpz_mod_poly(p1, pol2);
+      _F_mpz_poly_attach_F_mpz_mod_poly(p2, pol1);
+   }
+
+   if ((pol1 == res) || (pol2 == res)) // aliased inputs
+	{
+		F_mpz_mod_poly_t output; // create temporary
+		F_mpz_mod_poly_init2(output, res->P, pol1->length + pol2->length - 1);
+      _F_mpz_poly_attach_F_mpz_mod_poly(r, output);
+      _F_mpz_poly_mul(r, p1, p2);
+      _F_mpz_poly_reduce_coeffs_ctx(r, ctx);
+      _F_mpz_mod_poly_attach_F_mpz_poly(output, r);
+      _F_mpz_mod_poly_normalise(output);
+		F_mpz_mod_poly_swap(output, res); // swap temporary with real output
+		F_mpz_mod_poly_clear(output);
+	} else // ordinary case
+	{
+		F_mpz_mod_poly_fit_length(res, pol1->length + pol2->length - 1);
+      _F_mpz_poly_attach_F_mpz_mod_poly(r, res);
+      _F_mpz_poly_mul(r, p1, p2);
+      _F_mpz_poly_reduce_coeffs_ctx(r, ctx);
+      _F_mpz_mod_poly_attach_F_mpz_poly(res, r);
+      _F_mpz_mod_poly_normalise(res);
+	}		
+}
+
+/*
+   Set res to pol1*pol2 truncated to length trunc.
+*/
+static
+void __F_mpz_mod_poly_mul_trunc_n(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t pol1, 
+          const F_mpz_mod_poly_t pol2, const ulong trunc, const F_mpz_mod_ctx_t ctx)
+{
+   F_mpz_mod_poly_t t1, t2;
+
+   // higher coefficients of the inputs are not needed
+   _F_mpz_mod_poly_attach_truncate(t1, pol1, trunc);
+   _F_mpz_mod_poly_attach_truncate(t2, pol2, trunc);
+
+   if ((pol1 == res) || (pol2 == res)) // aliased inputs, which t1 and t2 share coeffs with
+	{
+		F_mpz_mod_poly_t output; // create temporary
+		F_mpz_mod_poly_init(output, res->P);
+      __F_mpz_mod_poly_mul(output, t1, t2, ctx);
+		F_mpz_mod_poly_swap(output, res); // swap temporary with real output
+		F_mpz_mod_poly_clear(output);
+	} else
+      __F_mpz_mod_poly_mul(res, t1, t2, ctx);
+
+   F_mpz_mod_poly_truncate(res, trunc);
+}
+
 void _F_mpz_mod_poly_mul(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t pol1, const F_mpz_mod_poly_t pol2)
 {
    F_mpz_poly_t p1, p2, r;
+   F_mpz_mod_ctx_t ctx;
 
    _F_mpz_poly_attach_F_mpz_mod_poly(p1, pol1);
    _F_mpz_poly_attach_F_mpz_mod_poly(p2, pol2);
    _F_mpz_poly_attach_F_mpz_mod_poly(r, res);
 
    _F_mpz_poly_mul(r, p1, p2);
-   _F_mpz_poly_reduce_coeffs(r, res->P);
+   F_mpz_mod_ctx_init(ctx, res->P);
+   _F_mpz_poly_reduce_coeffs_ctx(r, ctx);
+   F_mpz_mod_ctx_clear(ctx);
 
    _F_mpz_mod_poly_attach_F_mpz_poly(res, r);
    _F_mpz_mod_poly_normalise(res);
@@ -437,25 +514,18 @@ void F_mpz_mod_poly_mul(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t pol1, const
       return;
    }
 
-	if ((pol1 == res) || (pol2 == res)) // aliased inputs
-	{
-		F_mpz_mod_poly_t output; // create temporary
-		F_mpz_mod_poly_init2(output, pol1->P, pol1->length + pol2->length - 1);
-		if (pol1->length >= pol2->length) _F_mpz_mod_poly_mul(output, pol1, pol2);
-		else _F_mpz_mod_poly_mul(output, pol2, pol1);
-		F_mpz_mod_poly_swap(output, res); // swap temporary with real output
-		F_mpz_mod_poly_clear(output);
-	} else // ordinary case
-	{
-		F_mpz_mod_poly_fit_length(res, pol1->length + pol2->length - 1);
-      if (pol1->length >= pol2->length) _F_mpz_mod_poly_mul(res, pol1, pol2);
-		else _F_mpz_mod_poly_mul(res, pol2, pol1);
-	}		
+   F_mpz_mod_ctx_t ctx;
+   F_mpz_mod_ctx_init(ctx, res->P);
+   
+   __F_mpz_mod_poly_mul(res, pol1, pol2, ctx);
+
+   F_mpz_mod_ctx_clear(ctx);
 }
 
 void _F_mpz_mod_poly_mul_trunc_left(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t pol1, const F_mpz_mod_poly_t pol2, ulong trunc)
 {
    F_mpz_poly_t p1, p2, r;
+   F_mpz_mod_ctx_t ctx;
 
    if (trunc + 1 > pol1->length + pol2->length) trunc = pol1->length + pol2->length - 1;
    if (!pol1->length && !pol2->length) trunc = 0;
@@ -465,7 +535,9 @@ void _F_mpz_mod_poly_mul_trunc_left(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t
    _F_mpz_poly_attach_F_mpz_mod_poly(r, res);
 
    _F_mpz_poly_mul_trunc_left(r, p1, p2, trunc);
-   _F_mpz_poly_reduce_coeffs(r, res->P);
+   F_mpz_mod_ctx_init(ctx, res->P);
+   _F_mpz_poly_reduce_coeffs_ctx(r, ctx);
+   F_mpz_mod_ctx_clear(ctx);
 
    _F_mpz_mod_poly_attach_F_mpz_poly(res, r);
    _F_mpz_mod_poly_normalise(res);
@@ -495,12 +567,94 @@ void F_mpz_mod_poly_mul_trunc_left(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t
 	}		
 }
 
+void F_mpz_mod_poly_mul_trunc_n(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t poly1, const F_mpz_mod_poly_t poly2, const ulong trunc)
+{
+   if ((poly1->length == 0) || (poly2->length == 0) || (trunc == 0)) // special case if either poly is zero
+   {
+      F_mpz_mod_poly_zero(res);
+      return;
+   }
+
+   F_mpz_mod_ctx_t ctx;
+   F_mpz_mod_ctx_init(ctx, res->P);
+   
+   __F_mpz_mod_poly_mul_trunc_n(res, poly1, poly2, trunc, ctx);
+
+   F_mpz_mod_ctx_clear(ctx);
+}
+
 /****************************************************************************
 
    Division
 
 ****************************************************************************/
 
+/*
+   Set inv to the inverse of the leading coefficient of B modulo P, raising
+   an exception if it is not invertible.
+*/
+static
+void __F_mpz_mod_poly_lead_inv(F_mpz_t inv, const F_mpz_mod_poly_t B, const F_mpz_mod_ctx_t ctx)
+{
+   if (!F_mpz_invert(inv, B->coeffs + B->length - 1, ctx->n))
+   {
+      printf("FLINT Exception: leading coefficient is not invertible\n");
+      abort();
+   }
+   F_mpz_mod_ctx_reduce(inv, inv, ctx);
+}
+
+/*
+   Classical division with remainder, assuming A->length >= B->length > 0, 
+   that Q does not alias A or B and that R does not alias B. Reduction of 
+   the partial remainder is delayed: each coefficient accumulates its 
+   products unreduced and is reduced only once, when it becomes the leading 
+   coefficient or at the end for the remainder. 
+*/
+static
+void __F_mpz_mod_poly_divrem_basecase(F_mpz_mod_poly_t Q, F_mpz_mod_poly_t R, 
+          const F_mpz_mod_poly_t A, const F_mpz_mod_poly_t B, const F_mpz_mod_ctx_t ctx)
+{
+   ulong lenB = B->length;
+   ulong lenQ = A->length - lenB + 1;
+   
+   F_mpz_t lead_inv;
+   F_mpz_init(lead_inv);
+   __F_mpz_mod_poly_lead_inv(lead_inv, B, ctx);
+   
+   F_mpz_mod_poly_set(R, A);
+   F_mpz_mod_poly_fit_length(Q, lenQ);
+   
+   for (long i = A->length - 1; i >= (long) lenB - 1; i--)
+   {
+      F_mpz * r = R->coeffs + i - lenB + 1;
+      F_mpz * q = Q->coeffs + i - lenB + 1;
+
+      F_mpz_mod_ctx_reduce(R->coeffs + i, R->coeffs + i, ctx);
+
+      if (F_mpz_is_zero(R->coeffs + i))
+      {
+         F_mpz_zero(q);
+         continue;
+      }
+
+      F_mpz_mod_ctx_mulmod(q, R->coeffs + i, lead_inv, ctx);
+      
+      for (ulong j = 0; j < lenB - 1; j++)
+         F_mpz_submul(r + j, B->coeffs + j, q);
+   }
+
+   _F_mpz_mod_poly_set_length(Q, lenQ);
+   _F_mpz_mod_poly_normalise(Q);
+
+   _F_mpz_mod_poly_set_length(R, lenB - 1);
+   for (ulong j = 0; j < lenB - 1; j++)
+      F_mpz_mod_ctx_reduce(R->coeffs + j, R->coeffs + j, ctx);
+   _F_mpz_mod_poly_normalise(R);
+
+   F_mpz_clear(lead_inv);
+}
+
 void F_mpz_mod_poly_divrem_basecase(F_mpz_mod_poly_t Q, F_mpz_mod_poly_t R, const F_mpz_mod_poly_t A, const F_mpz_mod_poly_t B)
 {
    if (B->length == 0)
@@ -517,63 +671,28 @@ void F_mpz_mod_poly_divrem_basecase(F_mpz_mod_poly_t Q, F_mpz_mod_poly_t R, cons
       return;
    }
 
-   F_mpz_t lead_inv;
-   F_mpz_init(lead_inv);
-   F_mpz_invert(lead_inv, B->coeffs + B->length - 1, B->P);
-   
-   F_mpz * coeff_Q;
-   
-   F_mpz_mod_poly_t qB;
-   F_mpz_mod_poly_init2(qB, B->P, B->length);
-   
-   F_mpz_mod_poly_t Bm1;
-   _F_mpz_mod_poly_attach_truncate(Bm1, B, B->length - 1);
-   
-   long coeff = A->length - 1;
-   
-   F_mpz_mod_poly_set(R, A);
-   
-   if (A->length >= B->length)
-   {
-      F_mpz_mod_poly_fit_length(Q, A->length - B->length + 1);
-      _F_mpz_mod_poly_set_length(Q, A->length - B->length + 1);
-   } else F_mpz_mod_poly_zero(Q); 
-
-   coeff_Q = Q->coeffs - B->length + 1;
+   F_mpz_mod_ctx_t ctx;
+   F_mpz_mod_ctx_init(ctx, B->P);
    
-   while (coeff >= (long) B->length - 1)
+   if ((Q == A) || (Q == B) || (R == B)) // aliased inputs
    {
-      while ((coeff >= (long) B->length - 1) && (F_mpz_is_zero(R->coeffs + coeff)))
-      {
-         F_mpz_zero(coeff_Q + coeff);
-         coeff--;
-      }
-      
-      if (coeff >= (long) B->length - 1)
-      {
-         F_mpz_mulmod2(coeff_Q + coeff, R->coeffs + coeff, lead_inv, B->P);
-         
-         F_mpz_mod_poly_scalar_mul(qB, Bm1, coeff_Q + coeff);
-         
-         F_mpz_mod_poly_t R_sub;
-         F_mpz_init(R_sub->P);
-         F_mpz_set(R_sub->P, B->P);
-         R_sub->coeffs = R->coeffs + coeff - B->length + 1;
-         R_sub->length = B->length - 1;
-         _F_mpz_mod_poly_sub(R_sub, R_sub, qB);
-         F_mpz_clear(R_sub->P);
-         
-         coeff--;
-      }
-   }
-   
-   _F_mpz_mod_poly_set_length(R, B->length - 1);
-   _F_mpz_mod_poly_normalise(R);
-   F_mpz_mod_poly_clear(qB);
-   F_mpz_clear(lead_inv);
+      F_mpz_mod_poly_t Qt, Rt; // create temporaries
+      F_mpz_mod_poly_init(Qt, B->P);
+      F_mpz_mod_poly_init(Rt, B->P);
+      __F_mpz_mod_poly_divrem_basecase(Qt, Rt, A, B, ctx);
+      F_mpz_mod_poly_swap(Qt, Q); // swap temporaries with real outputs
+      F_mpz_mod_poly_swap(Rt, R);
+      F_mpz_mod_poly_clear(Qt);
+      F_mpz_mod_poly_clear(Rt);
+   } else
+      __F_mpz_mod_poly_divrem_basecase(Q, R, A, B, ctx);
+
+   F_mpz_mod_ctx_clear(ctx);
 }
 
-void F_mpz_mod_poly_div_divconquer_recursive(F_mpz_mod_poly_t Q, F_mpz_mod_poly_t BQ, const F_mpz_mod_poly_t A, const F_mpz_mod_poly_t B)
+static
+void __F_mpz_mod_poly_div_divconquer_recursive(F_mpz_mod_poly_t Q, F_mpz_mod_poly_t BQ, 
+          const F_mpz_mod_poly_t A, const F_mpz_mod_poly_t B, const F_mpz_mod_ctx_t ctx)
 {
    if (A->length < B->length)
    {
@@ -585,7 +704,7 @@ void F_mpz_mod_poly_div_divconquer_recursive(F_mpz_mod_poly_t Q, F_mpz_mod_poly_
    
    // A->length is now >= B->length
    
-   ulong crossover = 16;
+   ulong crossover = 32; // the classical algorithm is faster now that it reduces lazily
    
    if (A->length - B->length + 1 <= crossover) 
    {
@@ -596,7 +715,7 @@ void F_mpz_mod_poly_div_divconquer_recursive(F_mpz_mod_poly_t Q, F_mpz_mod_poly_
       
       F_mpz_mod_poly_t Rb;
       F_mpz_mod_poly_init(Rb, B->P);
-      F_mpz_mod_poly_divrem_basecase(Q, Rb, A, B);
+      __F_mpz_mod_poly_divrem_basecase(Q, Rb, A, B, ctx);
       F_mpz_mod_poly_fit_length(BQ, A->length);
       F_mpz_mod_poly_sub(BQ, A, Rb);
       F_mpz_mod_poly_clear(Rb);
@@ -629,7 +748,7 @@ void F_mpz_mod_poly_div_divconquer_recursive(F_mpz_mod_poly_t Q, F_mpz_mod_poly_
       _F_mpz_mod_poly_attach_truncate(t_B2, B, q2);
       
       F_mpz_mod_poly_init(d1q1, B->P);
-      F_mpz_mod_poly_div_divconquer_recursive(Q, d1q1, t_A, t_B); 
+      __F_mpz_mod_poly_div_divconquer_recursive(Q, d1q1, t_A, t_B, ctx); 
       
       /*
          Compute d2q1 = Q*t_B2
@@ -637,7 +756,7 @@ void F_mpz_mod_poly_div_divconquer_recursive(F_mpz_mod_poly_t Q, F_mpz_mod_poly_
       */
       
       F_mpz_mod_poly_init(d2q1, B->P);
-      F_mpz_mod_poly_mul(d2q1, Q, t_B2);
+      __F_mpz_mod_poly_mul(d2q1, Q, t_B2, ctx);
       
       /*
          Compute BQ = d1q1*x^n1 + d2q1
@@ -671,7 +790,7 @@ void F_mpz_mod_poly_div_divconquer_recursive(F_mpz_mod_poly_t Q, F_mpz_mod_poly_
       F_mpz_mod_poly_init(d1q1, B->P);
       F_mpz_mod_poly_init(q1, Q->P);
       
-      F_mpz_mod_poly_div_divconquer_recursive(q1, d1q1, p1, B); 
+      __F_mpz_mod_poly_div_divconquer_recursive(q1, d1q1, p1, B, ctx); 
       
       /* 
          Compute dq1 = d1*q1*x^shift
@@ -705,7 +824,7 @@ void F_mpz_mod_poly_div_divconquer_recursive(F_mpz_mod_poly_t Q, F_mpz_mod_poly_
    
       F_mpz_mod_poly_init(q2, Q->P);
       F_mpz_mod_poly_init(dq2, Q->P);
-      F_mpz_mod_poly_div_divconquer_recursive(q2, dq2, t, B); 
+      __F_mpz_mod_poly_div_divconquer_recursive(q2, dq2, t, B, ctx); 
       F_mpz_mod_poly_clear(t);  
       
       /*
@@ -757,7 +876,7 @@ void F_mpz_mod_poly_div_divconquer_recursive(F_mpz_mod_poly_t Q, F_mpz_mod_poly_
       
    F_mpz_mod_poly_init(d1q1, B->P);
    F_mpz_mod_poly_init(q1, B->P);
-   F_mpz_mod_poly_div_divconquer_recursive(q1, d1q1, p1, d1); 
+   __F_mpz_mod_poly_div_divconquer_recursive(q1, d1q1, p1, d1, ctx); 
    
    /* 
       Compute d2q1 = d2*q1 
@@ -765,7 +884,7 @@ void F_mpz_mod_poly_div_divconquer_recursive(F_mpz_mod_poly_t Q, F_mpz_mod_poly_
    */  
    
    F_mpz_mod_poly_init(d2q1, B->P);
-   F_mpz_mod_poly_mul(d2q1, d2, q1);
+   __F_mpz_mod_poly_mul(d2q1, d2, q1, ctx);
    
    /* 
       Compute dq1 = d1*q1*x^n2 + d2*q1
@@ -799,7 +918,7 @@ void F_mpz_mod_poly_div_divconquer_recursive(F_mpz_mod_poly_t Q, F_mpz_mod_poly_
    
    F_mpz_mod_poly_init(d1q2, B->P);
    F_mpz_mod_poly_init(q2, Q->P);
-   F_mpz_mod_poly_div_divconquer_recursive(q2, d1q2, t, d1); 
+   __F_mpz_mod_poly_div_divconquer_recursive(q2, d1q2, t, d1, ctx); 
    F_mpz_mod_poly_clear(t);
       
    /*
@@ -808,7 +927,7 @@ void F_mpz_mod_poly_div_divconquer_recursive(F_mpz_mod_poly_t Q, F_mpz_mod_poly_
    */
    
    F_mpz_mod_poly_init(d2q2, A->P);
-   F_mpz_mod_poly_mul(d2q2, d2, q2);
+   __F_mpz_mod_poly_mul(d2q2, d2, q2, ctx);
    
    /*
       Compute dq2 = d1*q2*x^n2 + d2q2
@@ -845,6 +964,16 @@ void F_mpz_mod_poly_div_divconquer_recursive(F_mpz_mod_poly_t Q, F_mpz_mod_poly_
    F_mpz_mod_poly_clear(dq1);
 }
 
+void F_mpz_mod_poly_div_divconquer_recursive(F_mpz_mod_poly_t Q, F_mpz_mod_poly_t BQ, const F_mpz_mod_poly_t A, const F_mpz_mod_poly_t B)
+{
+   F_mpz_mod_ctx_t ctx;
+   F_mpz_mod_ctx_init(ctx, B->P);
+
+   __F_mpz_mod_poly_div_divconquer_recursive(Q, BQ, A, B, ctx);
+
+   F_mpz_mod_ctx_clear(ctx);
+}
+
 void F_mpz_mod_poly_divrem_divconquer(F_mpz_mod_poly_t Q, F_mpz_mod_poly_t R, const F_mpz_mod_poly_t A, const F_mpz_mod_poly_t B)
 {
    F_mpz_mod_poly_t QB;
@@ -860,3 +989,587 @@ void F_mpz_mod_poly_divrem_divconquer(F_mpz_mod_poly_t Q, F_mpz_mod_poly_t R, co
    F_mpz_mod_poly_clear(QB);
 }
 
+/****************************************************************************
+
+   Newton division
+
+****************************************************************************/
+
+/*
+   Set res to the reverse of the first length coefficients of poly, 
+   i.e. x^(length - 1)*poly(1/x) truncated. Assumes res does not alias poly.
+*/
+static
+void __F_mpz_mod_poly_reverse(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t poly, const ulong length)
+{
+   ulong len = FLINT_MIN(length, poly->length);
+   
+   F_mpz_mod_poly_fit_length(res, length);
+
+   for (ulong i = 0; i < len; i++)
+      F_mpz_set(res->coeffs + length - i - 1, poly->coeffs + i);
+   for (ulong i = len; i < length; i++)
+      F_mpz_zero(res->coeffs + length - i - 1);
+
+   _F_mpz_mod_poly_set_length(res, length);
+   _F_mpz_mod_poly_normalise(res);
+}
+
+/*
+   Set Q_inv to 1/Q mod x^n by the classical recurrence. Each coefficient 
+   is accumulated unreduced and reduced only once. Assumes Q_inv does not 
+   alias Q.
+*/
+static
+void __F_mpz_mod_poly_newton_invert_basecase(F_mpz_mod_poly_t Q_inv, 
+               const F_mpz_mod_poly_t Q, const ulong n, const F_mpz_mod_ctx_t ctx)
+{
+   F_mpz_t c0_inv;
+   F_mpz_init(c0_inv);
+
+   if (!F_mpz_invert(c0_inv, Q->coeffs, ctx->n))
+   {
+      printf("FLINT Exception: constant coefficient is not invertible\n");
+      abort();
+   }
+   F_mpz_mod_poly_fit_length(Q_inv, n);
+   F_mpz_mod_ctx_reduce(Q_inv->coeffs, c0_inv, ctx);
+   F_mpz_neg(c0_inv, Q_inv->coeffs); // -1/Q[0], the sign is dealt with by the reductions
+
+   for (ulong i = 1; i < n; i++)
+   {
+      F_mpz * c = Q_inv->coeffs + i;
+      ulong top = FLINT_MIN(i, Q->length - 1);
+      
+      F_mpz_zero(c);
+      for (ulong j = 1; j <= top; j++)
+         F_mpz_addmul(c, Q->coeffs + j, Q_inv->coeffs + i - j);
+
+      F_mpz_mod_ctx_reduce(c, c, ctx);
+      F_mpz_mod_ctx_mulmod(c, c, c0_inv, ctx);
+   }
+
+   _F_mpz_mod_poly_set_length(Q_inv, n);
+   _F_mpz_mod_poly_normalise(Q_inv);
+
+   F_mpz_clear(c0_inv);
+}
+
+/*
+   Set Q_inv to 1/Q mod x^n by Newton iteration, g' = g - g*(Q*g - 1). 
+   Assumes Q_inv does not alias Q.
+*/
+static
+void __F_mpz_mod_poly_newton_invert(F_mpz_mod_poly_t Q_inv, 
+               const F_mpz_mod_poly_t Q, const ulong n, const F_mpz_mod_ctx_t ctx)
+{
+   if (n < FLINT_F_MPZ_MOD_POLY_NEWTON_INVERSE_CUTOFF)
+   {
+      __F_mpz_mod_poly_newton_invert_basecase(Q_inv, Q, n, ctx);
+      return;
+   }
+
+   ulong m = (n + 1)/2;
+   
+   F_mpz_mod_poly_t g0, prod, prod2, prod_s;
+   F_mpz_mod_poly_init(g0, Q->P);
+   F_mpz_mod_poly_init(prod, Q->P);
+   F_mpz_mod_poly_init(prod2, Q->P);
+   
+   __F_mpz_mod_poly_newton_invert(g0, Q, m, ctx);
+   
+   /* 
+      Q*g0 = 1 + x^m*h mod x^n, so we only need h*g0 mod x^(n - m)
+   */
+   
+   __F_mpz_mod_poly_mul_trunc_n(prod, Q, g0, n, ctx);
+   _F_mpz_mod_poly_attach_shift(prod_s, prod, m);
+   __F_mpz_mod_poly_mul_trunc_n(prod2, prod_s, g0, n - m, ctx);
+   
+   F_mpz_mod_poly_left_shift(prod, prod2, m);
+   F_mpz_mod_poly_sub(Q_inv, g0, prod);
+
+   F_mpz_mod_poly_clear(prod2);
+   F_mpz_mod_poly_clear(prod);
+   F_mpz_mod_poly_clear(g0);
+}
+
+void F_mpz_mod_poly_newton_invert(F_mpz_mod_poly_t Q_inv, const F_mpz_mod_poly_t Q, const ulong n)
+{
+   if (n == 0)
+   {
+      F_mpz_mod_poly_zero(Q_inv);
+      return;
+   }
+
+   if (Q->length == 0)
+   {
+      printf("Error: Divide by zero\n");
+      abort();      
+   }
+
+   F_mpz_mod_ctx_t ctx;
+   F_mpz_mod_ctx_init(ctx, Q->P);
+
+   if (Q_inv == Q) // aliased inputs
+   {
+      F_mpz_mod_poly_t output; // create temporary
+      F_mpz_mod_poly_init2(output, Q->P, n);
+      __F_mpz_mod_poly_newton_invert(output, Q, n, ctx);
+      F_mpz_mod_poly_swap(output, Q_inv); // swap temporary with real output
+      F_mpz_mod_poly_clear(output);
+   } else
+      __F_mpz_mod_poly_newton_invert(Q_inv, Q, n, ctx);
+
+   F_mpz_mod_ctx_clear(ctx);
+}
+
+/*
+   Set Q to A/B mod x^n, assuming Q does not alias A or B.
+*/
+static
+void __F_mpz_mod_poly_div_series(F_mpz_mod_poly_t Q, const F_mpz_mod_poly_t A, 
+          const F_mpz_mod_poly_t B, const ulong n, const F_mpz_mod_ctx_t ctx)
+{
+   F_mpz_mod_poly_t B_inv;
+   F_mpz_mod_poly_init(B_inv, B->P);
+   
+   __F_mpz_mod_poly_newton_invert(B_inv, B, n, ctx);
+   __F_mpz_mod_poly_mul_trunc_n(Q, B_inv, A, n, ctx);
+   
+   F_mpz_mod_poly_clear(B_inv);
+}
+
+void F_mpz_mod_poly_div_series(F_mpz_mod_poly_t Q, const F_mpz_mod_poly_t A, const F_mpz_mod_poly_t B, const ulong n)
+{
+   if (n == 0 || A->length == 0)
+   {
+      F_mpz_mod_poly_zero(Q);
+      return;
+   }
+
+   if (B->length == 0)
+   {
+      printf("Error: Divide by zero\n");
+      abort();      
+   }
+
+   F_mpz_mod_ctx_t ctx;
+   F_mpz_mod_ctx_init(ctx, B->P);
+
+   if ((Q == A) || (Q == B)) // aliased inputs
+   {
+      F_mpz_mod_poly_t output; // create temporary
+      F_mpz_mod_poly_init2(output, B->P, n);
+      __F_mpz_mod_poly_div_series(output, A, B, n, ctx);
+      F_mpz_mod_poly_swap(output, Q); // swap temporary with real output
+      F_mpz_mod_poly_clear(output);
+   } else
+      __F_mpz_mod_poly_div_series(Q, A, B, n, ctx);
+
+   F_mpz_mod_ctx_clear(ctx);
+}
+
+/*
+   Set Q to the quotient of A by B, assuming A->length >= B->length > 0 
+   and that Q does not alias A or B.
+*/
+static
+void __F_mpz_mod_poly_div_newton(F_mpz_mod_poly_t Q, const F_mpz_mod_poly_t A, 
+                      const F_mpz_mod_poly_t B, const F_mpz_mod_ctx_t ctx)
+{
+   ulong lenQ = A->length - B->length + 1;
+   
+   F_mpz_mod_poly_t A_rev, B_rev, Q_rev, top;
+   F_mpz_mod_poly_init2(A_rev, B->P, lenQ);
+   F_mpz_mod_poly_init2(B_rev, B->P, lenQ);
+   F_mpz_mod_poly_init2(Q_rev, B->P, lenQ);
+   
+   // only the top lenQ coefficients of A and B affect the quotient
+   _F_mpz_mod_poly_attach_shift(top, A, A->length - lenQ);
+   __F_mpz_mod_poly_reverse(A_rev, top, lenQ);
+   if (B->length >= lenQ)
+   {
+      _F_mpz_mod_poly_attach_shift(top, B, B->length - lenQ);
+      __F_mpz_mod_poly_reverse(B_rev, top, lenQ);
+   } else
+      __F_mpz_mod_poly_reverse(B_rev, B, B->length);
+   
+   __F_mpz_mod_poly_div_series(Q_rev, A_rev, B_rev, lenQ, ctx);
+   __F_mpz_mod_poly_reverse(Q, Q_rev, lenQ);
+   
+   F_mpz_mod_poly_clear(Q_rev);
+   F_mpz_mod_poly_clear(B_rev);
+   F_mpz_mod_poly_clear(A_rev);
+}
+
+void F_mpz_mod_poly_div_newton(F_mpz_mod_poly_t Q, const F_mpz_mod_poly_t A, const F_mpz_mod_poly_t B)
+{
+   if (B->length == 0)
+   {
+      printf("Error: Divide by zero\n");
+      abort();      
+   }
+   
+   if (A->length < B->length)
+   {
+      F_mpz_mod_poly_zero(Q);
+      return;
+   }
+
+   F_mpz_mod_ctx_t ctx;
+   F_mpz_mod_ctx_init(ctx, B->P);
+
+   if ((Q == A) || (Q == B)) // aliased inputs
+   {
+      F_mpz_mod_poly_t output; // create temporary
+      F_mpz_mod_poly_init(output, B->P);
+      __F_mpz_mod_poly_div_newton(output, A, B, ctx);
+      F_mpz_mod_poly_swap(output, Q); // swap temporary with real output
+      F_mpz_mod_poly_clear(output);
+   } else
+      __F_mpz_mod_poly_div_newton(Q, A, B, ctx);
+
+   F_mpz_mod_ctx_clear(ctx);
+}
+
+/*
+   Set Q and R to the quotient and remainder of A by B, assuming 
+   A->length >= B->length > 0 and that Q and R do not alias A or B. 
+   The remainder is A - QB mod x^(B->length - 1).
+*/
+static
+void __F_mpz_mod_poly_divrem_newton(F_mpz_mod_poly_t Q, F_mpz_mod_poly_t R, 
+          const F_mpz_mod_poly_t A, const F_mpz_mod_poly_t B, const F_mpz_mod_ctx_t ctx)
+{
+   F_mpz_mod_poly_t A_trunc;
+
+   __F_mpz_mod_poly_div_newton(Q, A, B, ctx);
+   __F_mpz_mod_poly_mul_trunc_n(R, Q, B, B->length - 1, ctx);
+   
+   _F_mpz_mod_poly_attach_truncate(A_trunc, A, B->length - 1);
+   F_mpz_mod_poly_sub(R, A_trunc, R);
+}
+
+void F_mpz_mod_poly_divrem_newton(F_mpz_mod_poly_t Q, F_mpz_mod_poly_t R, const F_mpz_mod_poly_t A, const F_mpz_mod_poly_t B)
+{
+   if (B->length == 0)
+   {
+      printf("Error: Divide by zero\n");
+      abort();      
+   }
+   
+   if (A->length < B->length)
+   {
+      F_mpz_mod_poly_set(R, A);
+      F_mpz_mod_poly_zero(Q);
+      
+      return;
+   }
+
+   F_mpz_mod_ctx_t ctx;
+   F_mpz_mod_ctx_init(ctx, B->P);
+
+   if ((Q == A) || (Q == B) || (R == A) || (R == B)) // aliased inputs
+   {
+      F_mpz_mod_poly_t Qt, Rt; // create temporaries
+      F_mpz_mod_poly_init(Qt, B->P);
+      F_mpz_mod_poly_init(Rt, B->P);
+      __F_mpz_mod_poly_divrem_newton(Qt, Rt, A, B, ctx);
+      F_mpz_mod_poly_swap(Qt, Q); // swap temporaries with real outputs
+      F_mpz_mod_poly_swap(Rt, R);
+      F_mpz_mod_poly_clear(Qt);
+      F_mpz_mod_poly_clear(Rt);
+   } else
+      __F_mpz_mod_poly_divrem_newton(Q, R, A, B, ctx);
+
+   F_mpz_mod_ctx_clear(ctx);
+}
+
+/****************************************************************************
+
+   Modular multiplication
+
+****************************************************************************/
+
+void F_mpz_mod_poly_mulmod(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t A, const F_mpz_mod_poly_t B, const F_mpz_mod_poly_t C)
+{
+   if (C->length == 0)
+   {
+      printf("Error: Divide by zero\n");
+      abort();      
+   }
+
+   F_mpz_mod_poly_t prod;
+   F_mpz_mod_poly_init(prod, C->P);
+
+   F_mpz_mod_poly_mul(prod, A, B);
+   if (prod->length < C->length) F_mpz_mod_poly_swap(res, prod);
+   else F_mpz_mod_poly_rem(res, prod, C);
+
+   F_mpz_mod_poly_clear(prod);
+}
+
+/****************************************************************************
+
+   Powering
+
+****************************************************************************/
+
+/*
+   Set res to A*B mod f, where A and B are reduced mod f. The inverse of the
+   reverse of f to precision f->length - 1 and the bottom f->length - 1 
+   coefficients of f are cached in pre_finv and pre_f respectively, so that 
+   the reduction costs two truncated multiplications with a precached 
+   operand. The remainder is reduced mod P only once. The output may alias 
+   either input.
+*/
+static
+void __F_mpz_mod_poly_mulmod_preinv(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t A, 
+                    const F_mpz_mod_poly_t B, const F_mpz_mod_poly_t f, 
+                    F_mpz_poly_precache_t pre_finv, F_mpz_poly_precache_t pre_f, 
+                                                          const F_mpz_mod_ctx_t ctx)
+{
+   ulong lenf = f->length;
+   
+   F_mpz_mod_poly_t prod, top, q_rev, q;
+   F_mpz_poly_t p, r;
+
+   F_mpz_mod_poly_init(prod, f->P);
+   __F_mpz_mod_poly_mul(prod, A, B, ctx);
+
+   if (prod->length < lenf)
+   {
+      F_mpz_mod_poly_swap(res, prod);
+      F_mpz_mod_poly_clear(prod);
+      return;
+   }
+
+   ulong lenQ = prod->length - lenf + 1;
+
+   F_mpz_mod_poly_init2(q_rev, f->P, lenQ);
+   F_mpz_mod_poly_init2(q, f->P, lenQ);
+   F_mpz_poly_init(r);
+   
+   // the quotient is the reverse of rev(prod)*finv mod x^lenQ
+   _F_mpz_mod_poly_attach_shift(top, prod, prod->length - lenQ);
+   __F_mpz_mod_poly_reverse(q_rev, top, lenQ);
+
+   _F_mpz_poly_attach_F_mpz_mod_poly(p, q_rev);
+   F_mpz_poly_mul_trunc_n_precache(r, p, pre_finv, lenQ);
+   _F_mpz_poly_reduce_coeffs_ctx(r, ctx);
+   
+   _F_mpz_mod_poly_attach_F_mpz_poly(top, r);
+   __F_mpz_mod_poly_reverse(q, top, lenQ);
+
+   // the remainder is prod - q*f mod x^(lenf - 1), reduced once
+   _F_mpz_poly_attach_F_mpz_mod_poly(p, q);
+   F_mpz_poly_mul_trunc_n_precache(r, p, pre_f, lenf - 1);
+
+   F_mpz_mod_poly_fit_length(res, lenf - 1);
+   for (ulong i = 0; i < lenf - 1; i++)
+   {
+      if (i < r->length) F_mpz_sub(res->coeffs + i, prod->coeffs + i, r->coeffs + i);
+      else F_mpz_set(res->coeffs + i, prod->coeffs + i);
+      F_mpz_mod_ctx_reduce(res->coeffs + i, res->coeffs + i, ctx);
+   }
+   _F_mpz_mod_poly_set_length(res, lenf - 1);
+   _F_mpz_mod_poly_normalise(res);
+
+   F_mpz_poly_clear(r);
+   F_mpz_mod_poly_clear(q);
+   F_mpz_mod_poly_clear(q_rev);
+   F_mpz_mod_poly_clear(prod);
+}
+
+/*
+   Set res to pol^e mod f, where pol is reduced mod f, f->length > 1 and 
+   e > 0. The output may alias pol but not f.
+*/
+static
+void __F_mpz_mod_poly_powmod(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t pol, 
+                             const mpz_t e, const F_mpz_mod_poly_t f, const F_mpz_mod_ctx_t ctx)
+{
+   ulong lenf = f->length;
+   ulong bits = F_mpz_bits(f->P);
+   
+   F_mpz_mod_poly_t f_rev, finv, y;
+   F_mpz_poly_t p;
+   F_mpz_poly_precache_t pre_finv, pre_f;
+   
+   /*
+      Precompute the inverse of the reverse of f to the precision needed
+      to reduce products of length up to 2*lenf - 2
+   */
+   
+   F_mpz_mod_poly_init2(f_rev, f->P, lenf);
+   F_mpz_mod_poly_init2(finv, f->P, lenf - 1);
+   __F_mpz_mod_poly_reverse(f_rev, f, lenf);
+   __F_mpz_mod_poly_newton_invert(finv, f_rev, lenf - 1, ctx);
+   F_mpz_mod_poly_clear(f_rev);
+
+   _F_mpz_poly_attach_F_mpz_mod_poly(p, finv);
+   F_mpz_poly_mul_trunc_n_precache_init(pre_finv, p, bits, lenf - 1);
+   _F_mpz_poly_attach_F_mpz_mod_poly(p, f);
+   F_mpz_poly_mul_trunc_n_precache_init(pre_f, p, bits, lenf - 1);
+
+   F_mpz_mod_poly_init(y, f->P);
+   F_mpz_mod_poly_set(y, pol);
+   F_mpz_mod_poly_set(res, pol);
+
+   // left to right binary powering
+   for (long i = mpz_sizeinbase(e, 2) - 2; i >= 0; i--)
+   {
+      __F_mpz_mod_poly_mulmod_preinv(res, res, res, f, pre_finv, pre_f, ctx);
+      if (mpz_tstbit(e, i)) 
+         __F_mpz_mod_poly_mulmod_preinv(res, res, y, f, pre_finv, pre_f, ctx);
+   }
+
+   F_mpz_mod_poly_clear(y);
+   F_mpz_poly_mul_precache_clear(pre_f);
+   F_mpz_poly_mul_precache_clear(pre_finv);
+   F_mpz_mod_poly_clear(finv);
+}
+
+void F_mpz_mod_poly_powmod_F_mpz(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t pol, const F_mpz_t exp, const F_mpz_mod_poly_t f)
+{
+   if (f->length == 0)
+   {
+      printf("Error: Divide by zero\n");
+      abort();      
+   }
+
+   if (F_mpz_sgn(exp) < 0)
+   {
+      printf("FLINT Exception: negative exponent\n");
+      abort();      
+   }
+
+   if (f->length == 1) // everything is zero modulo a constant
+   {
+      F_mpz_mod_poly_zero(res);
+      return;
+   }
+
+   if (F_mpz_is_zero(exp))
+   {
+      F_mpz_mod_poly_fit_length(res, 1);
+      F_mpz_set_ui(res->coeffs, 1L);
+      _F_mpz_mod_poly_set_length(res, 1);
+      _F_mpz_mod_poly_normalise(res); // in case P = 1
+      return;
+   }
+
+   F_mpz_mod_poly_t f_in, pol_r;
+   F_mpz_mod_ctx_t ctx;
+   mpz_t e;
+
+   F_mpz_mod_poly_init(f_in, f->P);
+   F_mpz_mod_poly_init(pol_r, f->P);
+   F_mpz_mod_ctx_init(ctx, f->P);
+   mpz_init(e);
+   
+   F_mpz_mod_poly_set(f_in, f); // res may alias f
+   F_mpz_get_mpz(e, exp);
+   
+   if (pol->length >= f->length) F_mpz_mod_poly_rem(pol_r, pol, f_in);
+   else F_mpz_mod_poly_set(pol_r, pol);
+
+   if (pol_r->length == 0) F_mpz_mod_poly_zero(res);
+   else __F_mpz_mod_poly_powmod(res, pol_r, e, f_in, ctx);
+
+   mpz_clear(e);
+   F_mpz_mod_ctx_clear(ctx);
+   F_mpz_mod_poly_clear(pol_r);
+   F_mpz_mod_poly_clear(f_in);
+}
+
+void F_mpz_mod_poly_powmod(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t pol, const ulong exp, const F_mpz_mod_poly_t f)
+{
+   F_mpz_t e;
+   F_mpz_init(e);
+
+   F_mpz_set_ui(e, exp);
+   F_mpz_mod_poly_powmod_F_mpz(res, pol, e, f);
+
+   F_mpz_clear(e);
+}
+
+/****************************************************************************
+
+   GCD
+
+****************************************************************************/
+
+void F_mpz_mod_poly_make_monic(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t pol)
+{
+   if (pol->length == 0)
+   {
+      F_mpz_mod_poly_zero(res);
+      return;
+   }
+
+   F_mpz_t lead_inv;
+   F_mpz_mod_ctx_t ctx;
+   F_mpz_init(lead_inv);
+   F_mpz_mod_ctx_init(ctx, pol->P);
+
+   __F_mpz_mod_poly_lead_inv(lead_inv, pol, ctx);
+   
+   F_mpz_mod_poly_fit_length(res, pol->length);
+   for (ulong i = 0; i < pol->length - 1; i++)
+      F_mpz_mod_ctx_mulmod(res->coeffs + i, pol->coeffs + i, lead_inv, ctx);
+   F_mpz_set_ui(res->coeffs + pol->length - 1, 1L);
+   _F_mpz_mod_poly_set_length(res, pol->length);
+
+   F_mpz_mod_ctx_clear(ctx);
+   F_mpz_clear(lead_inv);
+}
+
+void F_mpz_mod_poly_gcd_euclidean(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t poly1, const F_mpz_mod_poly_t poly2)
+{
+   if (poly1->length == 0) 
+	{
+      F_mpz_mod_poly_make_monic(res, poly2);
+		return;
+   }
+
+	if (poly2->length == 0) 
+   {
+      F_mpz_mod_poly_make_monic(res, poly1);
+      return;
+   }
+
+   F_mpz_mod_poly_t A, B, R;
+   F_mpz_mod_poly_init(A, poly1->P);
+   F_mpz_mod_poly_init(B, poly1->P);
+   F_mpz_mod_poly_init(R, poly1->P);
+
+   if (poly1->length >= poly2->length)
+   {
+      F_mpz_mod_poly_set(A, poly1);
+      F_mpz_mod_poly_set(B, poly2);
+   } else
+   {
+      F_mpz_mod_poly_set(A, poly2);
+      F_mpz_mod_poly_set(B, poly1);
+   }
+
+   while (B->length > 1)
+   {
+      F_mpz_mod_poly_rem(R, A, B);
+      F_mpz_mod_poly_swap(A, B);
+      F_mpz_mod_poly_swap(B, R);
+   }
+   
+   if (B->length == 1) // the gcd is a unit
+   {
+      F_mpz_mod_poly_fit_length(res, 1);
+      F_mpz_set_ui(res->coeffs, 1L);
+      _F_mpz_mod_poly_set_length(res, 1);
+   } else F_mpz_mod_poly_make_monic(res, A);
+
+   F_mpz_mod_poly_clear(R);
+   F_mpz_mod_poly_clear(B);
+   F_mpz_mod_poly_clear(A);
+}
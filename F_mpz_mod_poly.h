@@ -38,6 +38,7 @@
 #include "memory-manager.h"
 #include "mpn_extras.h"
 #include "long_extras.h"
+#include "flint-tuning.h"
 
 #ifndef _F_MPZ_MOD_POLY_H_
 #define _F_MPZ_MOD_POLY_H_
@@ -222,6 +223,13 @@ void _F_mpz_poly_reduce_coeffs(F_mpz_poly_t poly, const F_mpz_t P)
       F_mpz_mod(poly->coeffs + i, poly->coeffs + i, P);
 }
 
+static inline
+void _F_mpz_poly_reduce_coeffs_ctx(F_mpz_poly_t poly, const F_mpz_mod_ctx_t ctx)
+{
+   for (ulong i = 0; i < poly->length; i++)
+      F_mpz_mod_ctx_reduce(poly->coeffs + i, poly->coeffs + i, ctx);
+}
+
 /****************************************************************************
 
    Assignment/swap
@@ -305,6 +313,8 @@ void _F_mpz_mod_poly_mul_trunc_left(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t
 
 void F_mpz_mod_poly_mul_trunc_left(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t poly1, const F_mpz_mod_poly_t poly2, const ulong trunc);
 
+void F_mpz_mod_poly_mul_trunc_n(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t poly1, const F_mpz_mod_poly_t poly2, const ulong trunc);
+
 /****************************************************************************
 
    Division
@@ -317,14 +327,29 @@ void F_mpz_mod_poly_div_divconquer_recursive(F_mpz_mod_poly_t Q, F_mpz_mod_poly_
 
 void F_mpz_mod_poly_divrem_divconquer(F_mpz_mod_poly_t Q, F_mpz_mod_poly_t R, const F_mpz_mod_poly_t A, const F_mpz_mod_poly_t B);
 
+#define FLINT_F_MPZ_MOD_POLY_NEWTON_INVERSE_CUTOFF (flint_tuning.F_mpz_mod_poly_newton_inverse_thresh) // below this length series are inverted classically
+
+#define FLINT_F_MPZ_MOD_POLY_NEWTON_DIVREM_CUTOFF (flint_tuning.F_mpz_mod_poly_newton_divrem_thresh) // minimum length of B for which newton division is used
+
+void F_mpz_mod_poly_newton_invert(F_mpz_mod_poly_t Q_inv, const F_mpz_mod_poly_t Q, const ulong n);
+
+void F_mpz_mod_poly_div_series(F_mpz_mod_poly_t Q, const F_mpz_mod_poly_t A, const F_mpz_mod_poly_t B, const ulong n);
+
+void F_mpz_mod_poly_div_newton(F_mpz_mod_poly_t Q, const F_mpz_mod_poly_t A, const F_mpz_mod_poly_t B);
+
+void F_mpz_mod_poly_divrem_newton(F_mpz_mod_poly_t Q, F_mpz_mod_poly_t R, const F_mpz_mod_poly_t A, const F_mpz_mod_poly_t B);
+
 static inline
 void F_mpz_mod_poly_divrem(F_mpz_mod_poly_t Q, F_mpz_mod_poly_t R, const F_mpz_mod_poly_t A, const F_mpz_mod_poly_t B)
 {
-   F_mpz_mod_poly_divrem_divconquer(Q, R, A, B);
+   if (B->length >= FLINT_F_MPZ_MOD_POLY_NEWTON_DIVREM_CUTOFF && A->length >= B->length + FLINT_F_MPZ_MOD_POLY_NEWTON_DIVREM_CUTOFF/2)
+      F_mpz_mod_poly_divrem_newton(Q, R, A, B);
+   else
+      F_mpz_mod_poly_divrem_divconquer(Q, R, A, B);
 }
 
 static inline
-void F_mpz_mod_poly_rem(F_mpz_mod_poly_t R, F_mpz_mod_poly_t A, F_mpz_mod_poly_t B)
+void F_mpz_mod_poly_rem(F_mpz_mod_poly_t R, const F_mpz_mod_poly_t A, const F_mpz_mod_poly_t B)
 {
    F_mpz_mod_poly_t Q;
    F_mpz_mod_poly_init(Q, A->P);
@@ -334,19 +359,33 @@ void F_mpz_mod_poly_rem(F_mpz_mod_poly_t R, F_mpz_mod_poly_t A, F_mpz_mod_poly_t
    F_mpz_mod_poly_clear(Q);
 }
 
-static inline
-void F_mpz_mod_poly_mulmod( F_mpz_mod_poly_t res, F_mpz_mod_poly_t A, F_mpz_mod_poly_t B, F_mpz_mod_poly_t C)
-{
+void F_mpz_mod_poly_mulmod(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t A, const F_mpz_mod_poly_t B, const F_mpz_mod_poly_t C);
 
-   F_mpz_mod_poly_t Q;
-   F_mpz_mod_poly_init(Q, A->P);
+/****************************************************************************
 
-   F_mpz_mod_poly_mul(Q, A, B);
-   F_mpz_mod_poly_rem(res, Q, C);
+   Powering
 
-   F_mpz_mod_poly_clear(Q);
-}
+****************************************************************************/
+
+void F_mpz_mod_poly_powmod_F_mpz(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t pol, const F_mpz_t exp, const F_mpz_mod_poly_t f);
+
+void F_mpz_mod_poly_powmod(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t pol, const ulong exp, const F_mpz_mod_poly_t f);
+
+/****************************************************************************
 
+   GCD
+
+****************************************************************************/
+
+void F_mpz_mod_poly_make_monic(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t pol);
+
+void F_mpz_mod_poly_gcd_euclidean(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t poly1, const F_mpz_mod_poly_t poly2);
+
+static inline
+void F_mpz_mod_poly_gcd(F_mpz_mod_poly_t res, const F_mpz_mod_poly_t poly1, const F_mpz_mod_poly_t poly2)
+{
+   F_mpz_mod_poly_gcd_euclidean(res, poly1, poly2);
+}
 
 #ifdef __cplusplus
  }
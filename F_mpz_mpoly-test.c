@@ -124,6 +124,48 @@ int test_F_mpz_mpoly_add_inplace()
    return result;
 }
 
+int test_F_mpz_mpoly_set_var_exp()
+{
+   int result = 1;
+	F_mpz_mpoly_t poly;
+	ulong exps[8*20];
+	ulong count, vars, length, bits, i, j, unpacked = 0;
+
+	for (count = 0; (count < 2000*ITER) && (result == 1); count++)
+	{
+		vars = z_randint(7) + 2;
+		length = z_randint(20) + 1;
+		F_mpz_mpoly_init2(poly, 0, vars, GRLEX);
+
+		// exponents of up to 40 bits, so the fields often outgrow a limb
+		bits = z_randint(40) + 1;
+		for (i = 0; i < length; i++)
+		{
+			F_mpz_mpoly_set_coeff_ui(poly, i, z_randint(100) + 1);
+			for (j = 0; j < vars; j++)
+			{
+				exps[i*vars + j] = z_randbits(z_randint(bits) + 1);
+				F_mpz_mpoly_set_var_exp(poly, i, j, exps[i*vars + j]);
+			}
+		}
+
+		for (i = 0; (i < length) && (result == 1); i++)
+			for (j = 0; (j < vars) && (result == 1); j++)
+				result = (F_mpz_mpoly_get_var_exp(poly, i, j) == exps[i*vars + j]);
+		if (!result) printf("Error: vars = %ld, length = %ld, bits = %ld, small = %d\n", 
+			                  vars, length, bits, poly->small);
+
+		if (!poly->small) unpacked++;
+
+		F_mpz_mpoly_clear(poly);
+	}
+
+	// check the large representation was actually used
+	if (result) result = (unpacked > 0);
+
+	return result;
+}
+
 int test__F_mpz_mpoly_mul_mxn()
 {
    int result = 1;
@@ -539,6 +581,591 @@ int test_F_mpz_mpoly_mul_fateman()
    return result;
 }
 
+/*
+   Sets the coefficients of poly to random signed values of up to the given 
+	number of bits.
+*/
+void rand_mpoly_coeffs(F_mpz_mpoly_t poly, ulong bits)
+{
+	ulong i;
+	for (i = 0; i < poly->length; i++)
+	{
+		F_mpz_random(poly->coeffs + i, z_randint(bits) + 1);
+		if (F_mpz_is_zero(poly->coeffs + i)) F_mpz_set_ui(poly->coeffs + i, 1);
+		if (z_randint(2)) F_mpz_neg(poly->coeffs + i, poly->coeffs + i);
+	}
+}
+
+/*
+   Sets res to the value of the small GRLEX polynomial poly at the given point.
+*/
+void eval_mpoly(mpz_t res, F_mpz_mpoly_t poly, long * point)
+{
+	mpz_t term, pow;
+	ulong i, j;
+
+	mpz_init(term);
+	mpz_init(pow);
+	mpz_set_ui(res, 0);
+
+	for (i = 0; i < poly->length; i++)
+	{
+		F_mpz_get_mpz(term, poly->coeffs + i);
+		for (j = 0; j < poly->vars; j++)
+		{
+			mpz_set_si(pow, point[j]);
+			mpz_pow_ui(pow, pow, F_mpz_mpoly_get_var_exp(poly, i, j));
+			mpz_mul(term, term, pow);
+		}
+		mpz_add(res, res, term);
+	}
+
+	mpz_clear(term);
+	mpz_clear(pow);
+}
+
+/*
+   Checks the monomials of poly are strictly increasing and its coefficients
+	are nonzero.
+*/
+int check_mpoly(F_mpz_mpoly_t poly)
+{
+	ulong i;
+	for (i = 0; i < poly->length; i++)
+	{
+		if (F_mpz_is_zero(poly->coeffs + i)) return 0;
+		if ((i > 0) && (poly->packed[i - 1] >= poly->packed[i])) return 0;
+	}
+
+	return 1;
+}
+
+int test_F_mpz_mpoly_mul_heap()
+{
+   int result = 1;
+	F_mpz_mpoly_t poly1, poly2, res, res2;
+	mpz_t v1, v2, v;
+	long point[6];
+	ulong count, vars, i;
+
+	mpz_init(v1);
+	mpz_init(v2);
+	mpz_init(v);
+
+	for (count = 0; (count < 2000*ITER) && (result == 1); count++)
+	{
+		vars = z_randint(5) + 2;
+		F_mpz_mpoly_init2(poly1, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(poly2, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(res, 0, vars, GRLEX);
+
+		// total degrees up to 250 overflow 8 bit fields in the product, and
+		// with 5 or more variables only 9 or 10 bit fields fit in a limb
+		rand_mpoly(poly1, z_randint(100) + 1, vars, z_randint(250) + 1, 10);
+		rand_mpoly(poly2, z_randint(100) + 1, vars, z_randint(250) + 1, 10);
+		rand_mpoly_coeffs(poly1, z_randint(200) + 1);
+		rand_mpoly_coeffs(poly2, z_randint(200) + 1);
+
+		if (z_randint(2)) F_mpz_mpoly_mul_heap(res, poly1, poly2);
+		else F_mpz_mpoly_mul_heap(res, poly2, poly1);
+
+		for (i = 0; i < vars; i++)
+			point[i] = z_randint(2001) - 1000L;
+
+		eval_mpoly(v1, poly1, point);
+		eval_mpoly(v2, poly2, point);
+		eval_mpoly(v, res, point);
+		mpz_mul(v1, v1, v2);
+
+		result = (check_mpoly(res) && (mpz_cmp(v, v1) == 0)
+			&& ((F_mpz_mpoly_degree_packed_grlex(poly1) + F_mpz_mpoly_degree_packed_grlex(poly2) 
+			   < 256) || (res->packed_bits > 8)));
+		if (!result) printf("Error: length1 = %ld, length2 = %ld, bits = %d\n", 
+			                  poly1->length, poly2->length, res->packed_bits);
+
+		F_mpz_mpoly_clear(poly1);
+		F_mpz_mpoly_clear(poly2);
+		F_mpz_mpoly_clear(res);
+	}
+
+	// small nonnegative coefficients agree with mul_small_heap, which needs
+	// operands of length at least 2
+	for (count = 0; (count < 1000*ITER) && (result == 1); count++)
+	{
+		vars = z_randint(5) + 2;
+		F_mpz_mpoly_init2(poly1, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(poly2, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(res, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(res2, 0, vars, GRLEX);
+
+		rand_mpoly(poly1, z_randint(100) + 2, vars, z_randint(120) + 2, 20);
+		rand_mpoly(poly2, z_randint(100) + 2, vars, z_randint(120) + 2, 20);
+		rand_mpoly_coeffs(poly1, 20);
+		rand_mpoly_coeffs(poly2, 20);
+		for (i = 0; i < poly1->length; i++)
+			F_mpz_abs(poly1->coeffs + i, poly1->coeffs + i);
+		for (i = 0; i < poly2->length; i++)
+			F_mpz_abs(poly2->coeffs + i, poly2->coeffs + i);
+
+		F_mpz_mpoly_mul_heap(res, poly1, poly2);
+		F_mpz_mpoly_mul_small_heap(res2, poly1, poly2);
+
+		result = (res->length == res2->length);
+		for (i = 0; (i < res->length) && result; i++)
+			result = ((res->packed[i] == res2->packed[i]) 
+			       && F_mpz_equal(res->coeffs + i, res2->coeffs + i));
+		if (!result) printf("Error: length = %ld, length2 = %ld, i = %ld\n", 
+			                  res->length, res2->length, i);
+
+		F_mpz_mpoly_clear(poly1);
+		F_mpz_mpoly_clear(poly2);
+		F_mpz_mpoly_clear(res);
+		F_mpz_mpoly_clear(res2);
+	}
+
+	// (x + y)*(x - y) = x^2 - y^2, with aliasing
+	if (result)
+	{
+		F_mpz_mpoly_init2(poly1, 2, 2, GRLEX);
+		F_mpz_mpoly_init2(poly2, 2, 2, GRLEX);
+
+		F_mpz_mpoly_set_coeff_ui(poly1, 0, 1);
+		F_mpz_mpoly_set_coeff_ui(poly1, 1, 1);
+		F_mpz_mpoly_set_var_exp(poly1, 0, 1, 1);
+		F_mpz_mpoly_set_var_exp(poly1, 1, 0, 1);
+		F_mpz_mpoly_set_coeff_ui(poly2, 0, 1);
+		F_mpz_mpoly_set_coeff_ui(poly2, 1, 1);
+		F_mpz_neg(poly2->coeffs, poly2->coeffs);
+		F_mpz_mpoly_set_var_exp(poly2, 0, 1, 1);
+		F_mpz_mpoly_set_var_exp(poly2, 1, 0, 1);
+
+		F_mpz_mpoly_mul_heap(poly1, poly1, poly2);
+
+		result = ((poly1->length == 2) && (F_mpz_mpoly_get_var_exp(poly1, 0, 1) == 2) 
+			    && (F_mpz_mpoly_get_var_exp(poly1, 1, 0) == 2) 
+				 && (F_mpz_sgn(poly1->coeffs) < 0) && (F_mpz_sgn(poly1->coeffs + 1) > 0));
+		if (!result) printf("Error: length = %ld\n", poly1->length);
+
+		F_mpz_mpoly_clear(poly1);
+		F_mpz_mpoly_clear(poly2);
+	}
+
+	mpz_clear(v1);
+	mpz_clear(v2);
+	mpz_clear(v);
+
+	return result;
+}
+
+/*
+   Returns 1 if the small GRLEX polynomials poly1 and poly2 are equal, which
+	may have different field widths.
+*/
+int equal_mpoly(F_mpz_mpoly_t poly1, F_mpz_mpoly_t poly2)
+{
+	ulong i, j;
+
+	if (poly1->length != poly2->length) return 0;
+
+	for (i = 0; i < poly1->length; i++)
+	{
+		if (!F_mpz_equal(poly1->coeffs + i, poly2->coeffs + i)) return 0;
+		for (j = 0; j < FLINT_MAX(poly1->vars, poly2->vars); j++)
+		{
+			ulong e1 = (j < poly1->vars) ? F_mpz_mpoly_get_var_exp(poly1, i, j) : 0L;
+			ulong e2 = (j < poly2->vars) ? F_mpz_mpoly_get_var_exp(poly2, i, j) : 0L;
+			if (e1 != e2) return 0;
+		}
+	}
+
+	return 1;
+}
+
+/*
+   Appends to poly the monomials in vars variables of total degree rem in 
+	the variables from var on, with exponents exps in the earlier variables,
+	each with probability 3/4, in increasing GRLEX order.
+*/
+void dense_mpoly_rec(F_mpz_mpoly_t poly, ulong * exps, ulong var, ulong vars, ulong rem)
+{
+	ulong i, e;
+
+	if (var == vars - 1)
+	{
+		if (z_randint(4) == 0) return;
+		
+		exps[var] = rem;
+		i = poly->length;
+		F_mpz_mpoly_set_coeff_ui(poly, i, 1);
+		for (var = 0; var < vars; var++)
+			if (exps[var]) F_mpz_mpoly_set_var_exp(poly, i, var, exps[var]);
+		return;
+	}
+
+	for (e = 0; e <= rem; e++)
+	{
+		exps[var] = e + ((var == 0) ? exps[vars] : 0L);
+		dense_mpoly_rec(poly, exps, var + 1, vars, rem - e);
+	}
+}
+
+/*
+   Sets poly to a random polynomial in vars variables containing about 3/4 of
+	the monomials of total degree at most deg, multiplied by x0^shift, with 
+	coefficients of up to the given number of bits.
+*/
+void dense_mpoly(F_mpz_mpoly_t poly, ulong vars, ulong deg, ulong shift, ulong bits)
+{
+	ulong * exps = (ulong *) flint_heap_alloc(vars + 1);
+	ulong d;
+
+	_F_mpz_mpoly_truncate(poly, 0);
+	exps[vars] = shift;
+	for (d = 0; d <= deg; d++)
+		dense_mpoly_rec(poly, exps, 0, vars, d);
+	flint_heap_free(exps);
+
+	if (poly->length == 0) F_mpz_mpoly_set_coeff_ui(poly, 0, 1);
+	rand_mpoly_coeffs(poly, bits);
+}
+
+typedef struct
+{
+	ulong count[3]; // number of times each algorithm was chosen
+	ulong len1;
+	ulong len2;
+} mul_hook_arg;
+
+void mul_hook(F_mpz_mpoly_mul_alg_t alg, ulong len1, ulong len2, void * arg)
+{
+	mul_hook_arg * h = (mul_hook_arg *) arg;
+	h->count[alg]++;
+	h->len1 = len1;
+	h->len2 = len2;
+}
+
+int test_F_mpz_mpoly_mul_kronecker()
+{
+   int result = 1;
+	F_mpz_mpoly_t poly1, poly2, res, res2;
+	ulong count, vars;
+
+	for (count = 0; (count < 1000*ITER) && (result == 1); count++)
+	{
+		vars = z_randint(4) + 1;
+		F_mpz_mpoly_init2(poly1, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(poly2, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(res, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(res2, 0, vars, GRLEX);
+
+		if (z_randint(2))
+		   dense_mpoly(poly1, vars, z_randint(24/vars) + 1, z_randint(300), z_randint(100) + 1);
+		else
+		{
+			rand_mpoly(poly1, z_randint(50) + 1, vars, z_randint(40/vars) + 1, 10);
+			rand_mpoly_coeffs(poly1, z_randint(100) + 1);
+		}
+		dense_mpoly(poly2, vars, z_randint(24/vars) + 1, z_randint(3), z_randint(100) + 1);
+
+		result = F_mpz_mpoly_mul_kronecker(res, poly1, poly2);
+		F_mpz_mpoly_mul_heap(res2, poly1, poly2);
+
+		result = (result && equal_mpoly(res, res2) && (res->packed_bits == res2->packed_bits));
+		if (!result) printf("Error: vars = %ld, length1 = %ld, length2 = %ld\n", 
+			                  vars, poly1->length, poly2->length);
+
+		// aliasing
+		if (result)
+		{
+			F_mpz_mpoly_mul_kronecker(poly2, poly1, poly2);
+			result = equal_mpoly(poly2, res2);
+			if (!result) printf("Error: aliasing, vars = %ld\n", vars);
+		}
+
+		F_mpz_mpoly_clear(poly1);
+		F_mpz_mpoly_clear(poly2);
+		F_mpz_mpoly_clear(res);
+		F_mpz_mpoly_clear(res2);
+	}
+
+	// check F_mpz_mpoly_mul chooses Kronecker substitution for dense inputs only
+	mul_hook_arg h;
+	h.count[0] = h.count[1] = h.count[2] = 0;
+	F_mpz_mpoly_mul_set_hook(mul_hook, &h);
+
+	for (count = 0; (count < 100*ITER) && (result == 1); count++)
+	{
+		int dense = z_randint(2);
+		vars = dense ? z_randint(2) + 1 : z_randint(3) + 2;
+		F_mpz_mpoly_init2(poly1, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(poly2, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(res, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(res2, 0, vars, GRLEX);
+
+		if (dense)
+		{
+			dense_mpoly(poly1, vars, 100/(vars*vars), z_randint(300), z_randint(100) + 1);
+			dense_mpoly(poly2, vars, 100/(vars*vars), z_randint(300), z_randint(100) + 1);
+		} else
+		{
+			// about one term for every third total degree up to 1000
+			rand_mpoly(poly1, 300, vars, 1000, 10);
+			rand_mpoly(poly2, 300, vars, 1000, 10);
+			rand_mpoly_coeffs(poly1, z_randint(100) + 1);
+			rand_mpoly_coeffs(poly2, z_randint(100) + 1);
+		}
+
+		ulong before = h.count[F_MPZ_MPOLY_MUL_KRONECKER];
+		F_mpz_mpoly_mul(res, poly1, poly2);
+		F_mpz_mpoly_mul_heap(res2, poly1, poly2);
+
+		result = (equal_mpoly(res, res2) && h.len1 == poly1->length && h.len2 == poly2->length
+			      && (h.count[F_MPZ_MPOLY_MUL_KRONECKER] - before == dense));
+		if (!result) printf("Error: dense = %d, vars = %ld, length1 = %ld, length2 = %ld\n", 
+			                  dense, vars, poly1->length, poly2->length);
+
+		F_mpz_mpoly_clear(poly1);
+		F_mpz_mpoly_clear(poly2);
+		F_mpz_mpoly_clear(res);
+		F_mpz_mpoly_clear(res2);
+	}
+
+	F_mpz_mpoly_mul_set_hook(NULL, NULL);
+
+	return result;
+}
+
+/*
+   Sets res to poly times the given variable to the power shift.
+*/
+void shift_mpoly(F_mpz_mpoly_t res, F_mpz_mpoly_t poly, ulong var, ulong shift)
+{
+	ulong i, j, exp;
+
+	for (i = 0; i < poly->length; i++)
+	{
+		F_mpz_mpoly_set_coeff_ui(res, i, 1);
+		F_mpz_set(res->coeffs + i, poly->coeffs + i);
+		for (j = 0; j < poly->vars; j++)
+		{
+			exp = F_mpz_mpoly_get_var_exp(poly, i, j) + ((j == var) ? shift : 0L);
+			if (exp) F_mpz_mpoly_set_var_exp(res, i, j, exp);
+		}
+	}
+}
+
+int test_F_mpz_mpoly_mul_unpacked()
+{
+   int result = 1;
+	F_mpz_mpoly_t poly1, poly2, a, b, res, res2;
+	ulong count, vars, var, shift1, shift2, i, j;
+	mul_hook_arg h;
+
+	h.count[0] = h.count[1] = h.count[2] = 0;
+	F_mpz_mpoly_mul_set_hook(mul_hook, &h);
+
+	for (count = 0; (count < 1000*ITER) && (result == 1); count++)
+	{
+		vars = z_randint(5) + 2;
+		var = z_randint(vars);
+		F_mpz_mpoly_init2(poly1, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(poly2, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(a, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(b, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(res, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(res2, 0, vars, GRLEX);
+
+		rand_mpoly(poly1, z_randint(50) + 1, vars, z_randint(100) + 1, 10);
+		rand_mpoly(poly2, z_randint(50) + 1, vars, z_randint(100) + 1, 10);
+		rand_mpoly_coeffs(poly1, z_randint(100) + 1);
+		rand_mpoly_coeffs(poly2, z_randint(100) + 1);
+
+		// exponents of 33 to 62 bits, so the product has fields of more than 
+		// a third of a limb, and sometimes only one input is large
+		shift1 = z_randbits(z_randint(30) + 33);
+		shift2 = z_randint(2) ? z_randbits(z_randint(30) + 33) : 0L;
+		shift_mpoly(a, poly1, var, shift1);
+		shift_mpoly(b, poly2, var, shift2);
+
+		ulong before = h.count[F_MPZ_MPOLY_MUL_HEAP];
+		F_mpz_mpoly_mul(res, a, b);
+		F_mpz_mpoly_mul_heap(res2, poly1, poly2);
+
+		result = (!res->small && (res->length == res2->length) 
+			       && (h.count[F_MPZ_MPOLY_MUL_HEAP] - before == 1)
+			       && !F_mpz_mpoly_mul_kronecker(res, a, b));
+		for (i = 0; (i < res->length) && result; i++)
+		{
+			result = F_mpz_equal(res->coeffs + i, res2->coeffs + i);
+			for (j = 0; (j < vars) && result; j++)
+				result = (F_mpz_mpoly_get_var_exp(res, i, j) == 
+					F_mpz_mpoly_get_var_exp(res2, i, j) + ((j == var) ? shift1 + shift2 : 0L));
+		}
+		if (!result) printf("Error: vars = %ld, length1 = %ld, length2 = %ld, shift1 = %lu, shift2 = %lu\n", 
+			                  vars, a->length, b->length, shift1, shift2);
+
+		// aliasing, and the threaded version
+		if (result)
+		{
+			F_mpz_mpoly_mul_heap_threaded(b, a, b, z_randint(4) + 1);
+			result = (b->length == res->length);
+			for (i = 0; (i < res->length) && result; i++)
+			{
+				result = F_mpz_equal(res->coeffs + i, b->coeffs + i);
+				for (j = 0; (j < vars) && result; j++)
+					result = (F_mpz_mpoly_get_var_exp(res, i, j) == F_mpz_mpoly_get_var_exp(b, i, j));
+			}
+			if (!result) printf("Error: aliasing, vars = %ld\n", vars);
+		}
+
+		F_mpz_mpoly_clear(poly1);
+		F_mpz_mpoly_clear(poly2);
+		F_mpz_mpoly_clear(a);
+		F_mpz_mpoly_clear(b);
+		F_mpz_mpoly_clear(res);
+		F_mpz_mpoly_clear(res2);
+	}
+
+	F_mpz_mpoly_mul_set_hook(NULL, NULL);
+
+	// a 40 bit exponent times itself, which needs fields of 41 bits
+	if (result)
+	{
+		F_mpz_mpoly_init2(poly1, 0, 2, GRLEX);
+		F_mpz_mpoly_init2(res, 0, 2, GRLEX);
+
+		F_mpz_mpoly_set_coeff_ui(poly1, 0, 3);
+		F_mpz_mpoly_set_var_exp(poly1, 0, 1, 1L << 39);
+		F_mpz_mpoly_set_coeff_ui(poly1, 1, 5);
+		F_mpz_mpoly_set_var_exp(poly1, 1, 0, (1L << 40) - 1L);
+
+		F_mpz_mpoly_mul(res, poly1, poly1);
+
+		result = ((res->length == 3) && (F_mpz_mpoly_get_coeff_ui(res, 0) == 9)
+			&& (F_mpz_mpoly_get_coeff_ui(res, 1) == 30) && (F_mpz_mpoly_get_coeff_ui(res, 2) == 25)
+			&& (F_mpz_mpoly_get_var_exp(res, 0, 0) == 0) && (F_mpz_mpoly_get_var_exp(res, 0, 1) == (1L << 40))
+			&& (F_mpz_mpoly_get_var_exp(res, 1, 0) == (1L << 40) - 1L) 
+			&& (F_mpz_mpoly_get_var_exp(res, 1, 1) == (1L << 39))
+			&& (F_mpz_mpoly_get_var_exp(res, 2, 0) == (1L << 41) - 2L) 
+			&& (F_mpz_mpoly_get_var_exp(res, 2, 1) == 0));
+		if (!result) printf("Error: length = %ld\n", res->length);
+
+		F_mpz_mpoly_clear(poly1);
+		F_mpz_mpoly_clear(res);
+	}
+
+	return result;
+}
+
+int test_F_mpz_mpoly_mul_heap_threaded()
+{
+   int result = 1;
+	F_mpz_mpoly_t poly1, poly2, res, res2;
+	ulong count, vars, threads;
+
+	for (count = 0; (count < 1000*ITER) && (result == 1); count++)
+	{
+		vars = z_randint(5) + 2;
+		threads = z_randint(8) + 2;
+		F_mpz_mpoly_init2(poly1, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(poly2, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(res, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(res2, 0, vars, GRLEX);
+
+		rand_mpoly(poly1, z_randint(150) + 1, vars, z_randint(250) + 1, 10);
+		rand_mpoly(poly2, z_randint(150) + 1, vars, z_randint(250) + 1, 10);
+		rand_mpoly_coeffs(poly1, z_randint(100) + 1);
+		rand_mpoly_coeffs(poly2, z_randint(100) + 1);
+
+		F_mpz_mpoly_mul_heap_threaded(res, poly1, poly2, 1);
+		F_mpz_mpoly_mul_heap_threaded(res2, poly1, poly2, threads);
+
+		result = (equal_mpoly(res, res2) && (res->packed_bits == res2->packed_bits));
+		if (!result) printf("Error: length1 = %ld, length2 = %ld, threads = %ld\n", 
+			                  poly1->length, poly2->length, threads);
+
+		// aliasing
+		if (result)
+		{
+			F_mpz_mpoly_mul_heap_threaded(poly1, poly1, poly2, threads);
+			result = equal_mpoly(poly1, res);
+			if (!result) printf("Error: aliasing, threads = %ld\n", threads);
+		}
+
+		F_mpz_mpoly_clear(poly1);
+		F_mpz_mpoly_clear(poly2);
+		F_mpz_mpoly_clear(res);
+		F_mpz_mpoly_clear(res2);
+	}
+
+	return result;
+}
+
+int test_F_mpz_mpoly_divides_heap()
+{
+   int result = 1;
+	F_mpz_mpoly_t poly1, poly2, prod, Q;
+	ulong count, vars, i;
+
+	for (count = 0; (count < 1000*ITER) && (result == 1); count++)
+	{
+		vars = z_randint(5) + 2;
+		F_mpz_mpoly_init2(poly1, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(poly2, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(prod, 0, vars, GRLEX);
+		F_mpz_mpoly_init2(Q, 0, vars, GRLEX);
+
+		// poly2 has at least two terms, so it can't divide a monomial
+		rand_mpoly(poly1, z_randint(100) + 1, vars, z_randint(120) + 1, 10);
+		rand_mpoly(poly2, z_randint(100) + 2, vars, z_randint(120) + 2, 10);
+		rand_mpoly_coeffs(poly1, z_randint(100) + 1);
+		rand_mpoly_coeffs(poly2, z_randint(100) + 1);
+
+		F_mpz_mpoly_mul_heap(prod, poly1, poly2);
+
+		result = (F_mpz_mpoly_divides_heap(Q, prod, poly2) && equal_mpoly(Q, poly1));
+		if (!result) printf("Error: divides, length1 = %ld, length2 = %ld\n", 
+			                  poly1->length, poly2->length);
+
+		if (result)
+		{
+			F_mpz_mpoly_divexact_heap(Q, prod, poly2);
+			result = equal_mpoly(Q, poly1);
+			if (!result) printf("Error: divexact, length1 = %ld, length2 = %ld\n", 
+			                  poly1->length, poly2->length);
+		}
+
+		// change one coefficient, so that the division is no longer exact
+		if (result)
+		{
+			i = z_randint(prod->length);
+			F_mpz_add_ui(prod->coeffs + i, prod->coeffs + i, z_randint(10) + 1);
+			if (F_mpz_is_zero(prod->coeffs + i)) 
+				F_mpz_add_ui(prod->coeffs + i, prod->coeffs + i, 1);
+
+			result = (!F_mpz_mpoly_divides_heap(Q, prod, poly2) && (Q->length == 0));
+			if (!result) printf("Error: not divisible, length1 = %ld, length2 = %ld\n", 
+			                  poly1->length, poly2->length);
+		}
+
+		// aliasing
+		if (result)
+		{
+			F_mpz_mpoly_mul_heap(prod, poly1, poly2);
+			result = (F_mpz_mpoly_divides_heap(prod, prod, poly2) && equal_mpoly(prod, poly1));
+			if (!result) printf("Error: aliasing, length1 = %ld, length2 = %ld\n", 
+			                  poly1->length, poly2->length);
+		}
+
+		F_mpz_mpoly_clear(poly1);
+		F_mpz_mpoly_clear(poly2);
+		F_mpz_mpoly_clear(prod);
+		F_mpz_mpoly_clear(Q);
+	}
+
+	return result;
+}
+
 void F_mpz_mpoly_test_all()
 {
    int success, all_success = 1;
@@ -552,7 +1179,13 @@ void F_mpz_mpoly_test_all()
 	RUN_TEST(F_mpz_mpoly_mul_small_recursive); */
 	//RUN_TEST(F_mpz_mpoly_mul_fateman); 
 	//RUN_TEST(F_mpz_mpoly_mul_fateman_heap); 
+	RUN_TEST(F_mpz_mpoly_set_var_exp); 
 	RUN_TEST(F_mpz_mpoly_mul_5sparse_heap); 
+	RUN_TEST(F_mpz_mpoly_mul_heap); 
+	RUN_TEST(F_mpz_mpoly_mul_heap_threaded); 
+	RUN_TEST(F_mpz_mpoly_mul_kronecker); 
+	RUN_TEST(F_mpz_mpoly_mul_unpacked); 
+	RUN_TEST(F_mpz_mpoly_divides_heap); 
 	
    printf(all_success ? "\nAll tests passed\n" :
                         "\nAt least one test FAILED!\n");
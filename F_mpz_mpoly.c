@@ -27,9 +27,13 @@
 #include <stdint.h>
 #include <string.h>
 #include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "flint.h"
 #include "F_mpz.h"
+#include "F_mpz_poly.h"
 #include "mpn_extras.h"
 #include "longlong_wrapper.h"
 #include "longlong.h"
@@ -68,7 +72,13 @@ void F_mpz_mpoly_init2(F_mpz_mpoly_t poly, const ulong alloc,
 		F_mpn_clear(poly->coeffs, alloc);
 		F_mpn_clear(poly->packed, alloc);
    }
-   else poly->coeffs = NULL;
+   else 
+	{
+		poly->coeffs = NULL;
+		poly->packed = NULL;
+	}
+
+	poly->exps = NULL;
 
 	/*if (vars)
 	{
@@ -116,26 +126,27 @@ void F_mpz_mpoly_realloc(F_mpz_mpoly_t poly, const ulong alloc, const ulong vars
 	   }
 		
 		if (!poly->small) 
+		{
 			ulong i;
 			for (i = 0; i < FLINT_MIN(vars, poly->vars); i++)
 			   pv_realloc(poly->exps + i, alloc);
+		}
 	}
    
    poly->alloc = alloc;
 
-   if (vars != poly->vars)
+   if ((!poly->small) && (vars != poly->vars)) // exps are only used for large polys
 	{
 		if (poly->vars) // realloc
 		{
+			ulong i;
 			if (vars < poly->vars)
-			   ulong i;
 			   for (i = vars; i < poly->vars; i++)
 					pv_clear(poly->exps + i);
 
 			poly->exps = (pv_s *) flint_heap_realloc(poly->exps, vars*sizeof(pv_s));
 
 			if (vars > poly->vars)
-			   ulong i;
 			   for (i = poly->vars; i < vars; i++)
 				   pv_init(poly->exps + i, alloc, 0);
 		} else // nothing allocated already so do it now
@@ -143,7 +154,7 @@ void F_mpz_mpoly_realloc(F_mpz_mpoly_t poly, const ulong alloc, const ulong vars
 			poly->exps = (pv_s *) flint_heap_alloc_bytes(vars*sizeof(pv_s));
 			ulong i;
 			for (i = 0; i < vars; i++)
-				   pv_init(poly->exps, alloc, 0);
+				   pv_init(poly->exps + i, alloc, 0);
 		}  
 	}
 
@@ -168,7 +179,7 @@ void F_mpz_mpoly_clear(F_mpz_mpoly_t poly)
    for (i = 0; i < poly->alloc; i++) // Clean up any mpz_t's
 		_F_mpz_demote(poly->coeffs + i);
 	if (poly->coeffs) flint_heap_free(poly->coeffs); // clean up coeffs
-   if (poly->coeffs) flint_heap_free(poly->packed); // and packed
+   if (poly->packed) flint_heap_free(poly->packed); // and packed
 
 	if (!poly->small)
 	{
@@ -218,12 +229,40 @@ void F_mpz_mpoly_set_var_exp_packed_grlex(F_mpz_mpoly_t poly, const ulong n, con
 	poly->packed[n] += ((exp << (FLINT_BITS - bits)) + (exp << shift)); // update total degree and relevant exponent
 }
 
+/*
+   Returns the width of field, at least bits, needed to pack monomials in
+	vars variables of total degree up to deg. The width is doubled until it
+	is large enough, unless the fields would then no longer fit in a limb, in
+	which case the smallest width that works is used. Returns 0 if there is 
+	no such width.
+*/
+static
+int _F_mpz_mpoly_packed_bits(int bits, const ulong deg, const ulong vars)
+{
+	int min_bits = FLINT_MAX(bits, FLINT_BIT_COUNT(deg));
+	
+	while ((bits < FLINT_BITS) && (FLINT_BIT_COUNT(deg) > bits)) bits *= 2;
+	
+	if ((vars + 1)*bits <= FLINT_BITS) return bits;
+	if ((vars + 1)*min_bits <= FLINT_BITS) return min_bits;
+
+	return 0;
+}
+
 void F_mpz_mpoly_set_var_exp(F_mpz_mpoly_t poly, const ulong n, const ulong var, 
 									                                        const ulong exp)
 {
    F_mpz_mpoly_fit_length(poly, n+1);
    F_mpz_mpoly_fit_vars(poly, var+1);
 
+   if ((poly->small) && (poly->ordering == GRLEX)) // widen the fields if the total degree won't fit
+	{
+		ulong deg = (poly->packed[n] >> (FLINT_BITS - poly->packed_bits)) + exp;
+		int bits = _F_mpz_mpoly_packed_bits(poly->packed_bits, deg, poly->vars);
+		if (!bits) F_mpz_mpoly_unpack(poly); // the monomials no longer fit in a limb
+		else if (bits != poly->packed_bits) F_mpz_mpoly_repack(poly, bits);
+	}
+
    if ((poly->small) && (FLINT_BIT_COUNT(exp) <= poly->packed_bits)) // monomials can be packed
 	{
 		switch (poly->ordering)
@@ -235,14 +274,19 @@ void F_mpz_mpoly_set_var_exp(F_mpz_mpoly_t poly, const ulong n, const ulong var,
 			default:
 			   abort(); // not implemented
 		}
-	} else if (poly->small)
-	{
-		abort(); // changing packed_bits or converting to big poly not yet implemented
-	} else // poly is not small (exponents aren't packed)
+	} else 
 	{
+		if (poly->small) F_mpz_mpoly_unpack(poly);
+		
+		// poly is not small (exponents aren't packed)
 		int bits = pv_bit_fit(FLINT_BIT_COUNT(exp));
 	   pv_s * expt = poly->exps + var;
-	   if (bits > expt->bits) pv_set_bits(expt, bits);
+	   if (bits > expt->bits) pv_set_bits(expt, bits); // keeps the first length entries
+
+		// entries between the old length and n have not been set, so are zero
+		for ( ; expt->length < n; expt->length++)
+			PV_SET_ENTRY(*expt, expt->length, 0UL);
+		if (n == expt->length) expt->length++;
 
 	   PV_SET_ENTRY(*expt, n, exp);
 	}
@@ -271,9 +315,9 @@ ulong F_mpz_mpoly_get_var_exp(F_mpz_mpoly_t poly, const ulong n, const ulong var
 		}
 	} else
 	{
-		if (var > poly->vars) return 0;
+		if (var >= poly->vars) return 0;
 	   if (poly->exps[var].bits == 0) return 0;
-	   if (n > poly->length) return 0;
+	   if (n >= poly->exps[var].length) return 0; // entries past the length are zero
 
       ulong val;
 	   pv_s * expt = poly->exps + var;
@@ -283,6 +327,89 @@ ulong F_mpz_mpoly_get_var_exp(F_mpz_mpoly_t poly, const ulong n, const ulong var
 	}
 }
 
+/*===============================================================================
+
+	Packing
+
+================================================================================*/
+
+void _F_mpz_mpoly_repack(ulong * res, const ulong * packed, const ulong length, 
+							 const ulong vars, const int bits_in, const int bits_out)
+{
+	ulong mask = (bits_in == FLINT_BITS) ? -1L : ((1L << bits_in) - 1L);
+	ulong i, k;
+	
+	for (i = 0; i < length; i++)
+	{
+		ulong in = packed[i], out = 0;
+
+		for (k = 0; k <= vars; k++) // field 0 is the total degree
+			out += (((in >> (FLINT_BITS - (k+1)*bits_in)) & mask) << (FLINT_BITS - (k+1)*bits_out));
+		
+		res[i] = out;
+	}
+}
+
+void F_mpz_mpoly_repack(F_mpz_mpoly_t poly, const int bits)
+{
+	if (bits == poly->packed_bits) return;
+
+	if ((poly->vars + 1)*bits > FLINT_BITS) // fields don't fit in a limb
+	{
+		F_mpz_mpoly_unpack(poly);
+		return;
+	}
+
+	// unused entries are also repacked, as set_var_exp may write beyond the length
+	_F_mpz_mpoly_repack(poly->packed, poly->packed, poly->alloc, poly->vars, poly->packed_bits, bits);
+	poly->packed_bits = bits;
+}
+
+void F_mpz_mpoly_unpack(F_mpz_mpoly_t poly)
+{
+	if (!poly->small) return;
+
+	if (poly->ordering != GRLEX)
+		abort(); // not implemented
+
+	ulong i, j, exp, max;
+	ulong vars = poly->vars;
+
+	poly->exps = vars ? (pv_s *) flint_heap_alloc_bytes(vars*sizeof(pv_s)) : NULL;
+
+	// unused entries are also unpacked, as set_var_exp may write beyond the length
+	for (j = 0; j < vars; j++)
+	{
+		for (i = 0, max = 0; i < poly->alloc; i++)
+		{
+			exp = F_mpz_mpoly_get_var_exp_packed_grlex(poly, i, j);
+			if (exp > max) max = exp;
+		}
+
+		pv_init(poly->exps + j, poly->alloc, max ? pv_bit_fit(FLINT_BIT_COUNT(max)) : 0);
+		poly->exps[j].length = max ? poly->alloc : 0;
+		if (max)
+			for (i = 0; i < poly->alloc; i++)
+				PV_SET_ENTRY(poly->exps[j], i, F_mpz_mpoly_get_var_exp_packed_grlex(poly, i, j));
+	}
+
+	// the packed monomials are no longer maintained, so make them all equal
+	if (poly->alloc) F_mpn_clear(poly->packed, poly->alloc);
+	poly->small = 0;
+}
+
+int F_mpz_mpoly_mul_packed_bits(F_mpz_mpoly_t poly1, F_mpz_mpoly_t poly2)
+{
+	int bits = FLINT_MAX(poly1->packed_bits, poly2->packed_bits);
+	ulong vars = FLINT_MAX(poly1->vars, poly2->vars);
+	
+	// for GRLEX every exponent is bounded by the total degree of the product
+	ulong deg = F_mpz_mpoly_degree_packed_grlex(poly1) + F_mpz_mpoly_degree_packed_grlex(poly2);
+	if (deg < F_mpz_mpoly_degree_packed_grlex(poly1)) return 0; // degree overflowed a limb
+	
+	return _F_mpz_mpoly_packed_bits(bits, deg, vars);
+}
+
 /*===============================================================================
 
 	Print/read
@@ -305,6 +432,7 @@ void F_mpz_mpoly_print_pretty(F_mpz_mpoly_t poly, char ** var_syms)
 		switch (poly->ordering)
 		{
 		   case GRLEX:
+			{
 				long i;
 				for (i = poly->length - 1; i >= 0; i--)
 		      {
@@ -335,6 +463,7 @@ void F_mpz_mpoly_print_pretty(F_mpz_mpoly_t poly, char ** var_syms)
 						}
 			      }
 		      }
+			}
 			break;
 
 			default: abort(); // not implemented yet
@@ -689,7 +818,7 @@ void _F_mpz_mpoly_mul_small_3x2(F_mpz_mpoly_t res, F_mpz_mpoly_t poly1,
 	_F_mpz_mpoly_add_inplace(res, 1, temp);
 
 	//ulong i;
-for (i = 0; i < temp->length; i++)
+	//for (i = 0; i < temp->length; i++)
 	//	_F_mpz_demote(temp->coeffs + i);
 
 	flint_stack_release(); // coeffs
@@ -739,7 +868,7 @@ void _F_mpz_mpoly_mul_small_3x3(F_mpz_mpoly_t res, F_mpz_mpoly_t poly1,
 	_F_mpz_mpoly_add_inplace(res, 1, temp);
 
 	//ulong i;
-for (i = 0; i < temp->length; i++)
+	//for (i = 0; i < temp->length; i++)
 	//	_F_mpz_demote(temp->coeffs + i);
 
 	//flint_stack_release_small(); // coeffs
@@ -790,7 +919,7 @@ void _F_mpz_mpoly_mul_small_4x2(F_mpz_mpoly_t res, F_mpz_mpoly_t poly1,
 	_F_mpz_mpoly_add_inplace(res, 1, temp);
 
 	//ulong i;
-for (i = 0; i < temp->length; i++)
+	//for (i = 0; i < temp->length; i++)
 	//	_F_mpz_demote(temp->coeffs + i);
 
 	flint_stack_release(); // coeffs
@@ -860,7 +989,7 @@ void _F_mpz_mpoly_mul_small_4x3(F_mpz_mpoly_t res, F_mpz_mpoly_t poly1,
 	_F_mpz_mpoly_add_inplace(res, 1, temp);
 
 	//ulong i;
-for (i = 0; i < temp->length; i++)
+	//for (i = 0; i < temp->length; i++)
 	//	_F_mpz_demote(temp->coeffs + i);
 
 	flint_stack_release(); // coeffs
@@ -916,7 +1045,7 @@ void _F_mpz_mpoly_mul_small_4x4(F_mpz_mpoly_t res, F_mpz_mpoly_t poly1,
 	_F_mpz_mpoly_add_inplace(res, 1, temp);
 
 	//ulong i;
-for (i = 0; i < temp->length; i++)
+	//for (i = 0; i < temp->length; i++)
 	//	_F_mpz_demote(temp->coeffs + i);
 
 	//flint_stack_release_small(); // coeffs
@@ -1152,7 +1281,7 @@ void _F_mpz_mpoly_mul_small_Mxn(F_mpz_mpoly_t res, F_mpz_mpoly_t poly1,
 		_F_mpz_mpoly_add_inplace(res, ptr, temp);
 
 		//ulong i;
-for (i = 0; i < temp2->length; i++)
+	//for (i = 0; i < temp2->length; i++)
    		//_F_mpz_demote(temp2->coeffs + i);
 
 		flint_stack_release(); // packed
@@ -1160,7 +1289,7 @@ for (i = 0; i < temp2->length; i++)
 	}
 
 	//ulong i;
-for (i = 0; i < temp->length; i++)
+	//for (i = 0; i < temp->length; i++)
 	//	_F_mpz_demote(temp->coeffs + i);
 
 	flint_stack_release(); // packed
@@ -1599,7 +1728,7 @@ void F_mpz_mpoly_mul_small_heap(F_mpz_mpoly_t res,
 
 	ulong sum[3];
 
-   ulong i, j, oldi, next;
+   ulong j, oldi, next;
 	ulong packed, old_packed, empty;
 	ulong arr[2];
 	ulong cry;
@@ -1857,3 +1986,1494 @@ void F_mpz_mpoly_mul_small_heap(F_mpz_mpoly_t res,
 	flint_heap_free(entries);
 	flint_heap_free(heap);
 }
+
+/*
+   Adds c1*c2 to the signed three limb accumulator sum, where c1 and c2 are
+   small F_mpz's. The accumulator is in twos complement, so it can absorb
+   about 2^(FLINT_BITS + 2) such products without overflowing.
+*/
+static inline
+void _F_mpz_mpoly_addmul_3(ulong * sum, const F_mpz c1, const F_mpz c2)
+{
+	ulong p1, p0, cy;
+
+	umul_ppmm(p1, p0, FLINT_ABS(c1), FLINT_ABS(c2));
+
+	if ((c1 ^ c2) < 0L) // product is negative
+	{
+		sub_ddmmss(cy, sum[0], 0, sum[0], 0, p0); // cy is 0 or -1
+		sub_ddmmss(sum[2], sum[1], sum[2], sum[1], 0, p1);
+		add_ssaaaa(sum[2], sum[1], sum[2], sum[1], cy, cy);
+	} else
+	{
+		add_ssaaaa(cy, sum[0], 0, sum[0], 0, p0);
+		add_ssaaaa(sum[2], sum[1], sum[2], sum[1], 0, p1);
+		add_ssaaaa(sum[2], sum[1], sum[2], sum[1], 0, cy);
+	}
+}
+
+/*
+   Sets f to the signed three limb value in sum.
+*/
+static inline
+void _F_mpz_mpoly_set_3(F_mpz_t f, ulong * sum)
+{
+	int neg = ((long) sum[2] < 0L);
+	
+	if (neg) // take the absolute value
+	{
+		sum[0] = ~sum[0];
+		sum[1] = ~sum[1];
+		sum[2] = ~sum[2];
+		add_ssaaaa(sum[2], sum[1], sum[2], sum[1], 0, (sum[0] == -1L));
+		sum[0]++;
+	}
+
+	if (sum[2]) F_mpz_set_limbs(f, sum, 3);
+	else if (sum[1]) F_mpz_set_limbs(f, sum, 2);
+	else F_mpz_set_ui(f, sum[0]);
+
+	if (neg) F_mpz_neg(f, f);
+}
+
+/*
+   The heap used by the multiplication holds at most one term (i, j) for each
+   row i of the first polynomial. The heap is an array of row indices, 
+	ordered by entries[i].packed, and rows whose monomials compare equal are 
+	chained together through entries[i].chain so that they come off the heap 
+	at once.
+*/
+static inline
+void _F_mpz_mpoly_heap_push(ulong * heap, F_mpz_mpoly_heap_s * entries, 
+									                   ulong * heap_bottom, const ulong i)
+{
+	ulong packed = entries[i].packed;
+	ulong entry = *heap_bottom + 1;
+	ulong parent;
+
+	// look for an equal monomial on the path to the root
+	for (parent = entry/2; parent >= 1; parent /= 2)
+	{
+		ulong p = heap[parent];
+		if (entries[p].packed == packed)
+		{
+			entries[i].chain = p;
+			heap[parent] = i;
+			return;
+		}
+		if (entries[p].packed < packed) break;
+	}
+
+	entries[i].chain = -1L;
+	(*heap_bottom)++;
+
+	while ((entry > 1) && (entries[heap[entry/2]].packed > packed))
+	{
+		heap[entry] = heap[entry/2];
+		entry /= 2;
+	}
+
+	heap[entry] = i;
+}
+
+static inline
+ulong _F_mpz_mpoly_heap_pop(ulong * heap, F_mpz_mpoly_heap_s * entries, ulong * heap_bottom)
+{
+	ulong top = heap[1];
+	ulong last = heap[*heap_bottom];
+	ulong packed = entries[last].packed;
+	ulong n = --(*heap_bottom);
+	ulong entry = 1, child;
+
+	while ((child = 2*entry) <= n)
+	{
+		if ((child < n) && (entries[heap[child + 1]].packed < entries[heap[child]].packed))
+			child++;
+		if (entries[heap[child]].packed >= packed) break;
+		heap[entry] = heap[child];
+		entry = child;
+	}
+
+	heap[entry] = last;
+
+	return top;
+}
+
+void _F_mpz_mpoly_mul_heap(F_mpz_mpoly_t res, const F_mpz * coeffs1, const ulong * packed1, 
+		const ulong len1, const F_mpz * coeffs2, const ulong * packed2, const ulong len2)
+{
+	F_mpz_mpoly_heap_s * entries = (F_mpz_mpoly_heap_s *) 
+		                 flint_heap_alloc_bytes(len1*sizeof(F_mpz_mpoly_heap_s));
+	ulong * heap = (ulong *) flint_heap_alloc(len1 + 1);
+	ulong * hind = (ulong *) flint_heap_alloc(len1); 
+	ulong * Q = (ulong *) flint_heap_alloc(2*len1); // terms (i, j) popped for the current monomial
+	ulong heap_bottom = 0;
+	ulong Q_len, i, j, k = 0;
+	ulong sum[3];
+	F_mpz_t big;
+
+	F_mpz_init(big);
+	_F_mpz_mpoly_truncate(res, 0);
+
+	/*
+	   hind[i] is 2*j + 1 if (i, j) is the next term of row i to be inserted 
+		and 2*j if (i, j - 1) is in the heap. Term (i, j + 1) is only inserted
+		once (i - 1, j + 1) has been removed, which keeps the heap small.
+	*/
+	for (i = 0; i < len1; i++) hind[i] = 1;
+
+	entries[0].j = 0;
+	entries[0].packed = packed1[0] + packed2[0];
+	_F_mpz_mpoly_heap_push(heap, entries, &heap_bottom, 0);
+	hind[0] = 2;
+
+	while (heap_bottom)
+	{
+		ulong packed = entries[heap[1]].packed;
+		int is_big = 0;
+
+		sum[0] = sum[1] = sum[2] = 0L;
+		Q_len = 0;
+
+		do // pop all terms with this monomial
+		{
+			i = _F_mpz_mpoly_heap_pop(heap, entries, &heap_bottom);
+
+			do
+			{
+				j = entries[i].j;
+				hind[i] |= 1L;
+				Q[Q_len++] = i;
+				Q[Q_len++] = j;
+
+				if (!COEFF_IS_MPZ(coeffs1[i]) && !COEFF_IS_MPZ(coeffs2[j]))
+					_F_mpz_mpoly_addmul_3(sum, coeffs1[i], coeffs2[j]);
+				else // only promote for products which really are large
+				{
+					if (!is_big) F_mpz_zero(big);
+					F_mpz_addmul(big, coeffs1 + i, coeffs2 + j);
+					is_big = 1;
+				}
+
+				i = entries[i].chain;
+			} while (i != -1L);
+		} while ((heap_bottom) && (entries[heap[1]].packed == packed));
+
+		while (Q_len) // insert successors of the terms just removed
+		{
+			j = Q[--Q_len];
+			i = Q[--Q_len];
+
+			if ((i + 1 < len1) && (hind[i + 1] == 2*j + 1)) // next row
+			{
+				entries[i + 1].j = j;
+				entries[i + 1].packed = packed1[i + 1] + packed2[j];
+				_F_mpz_mpoly_heap_push(heap, entries, &heap_bottom, i + 1);
+				hind[i + 1] = 2*(j + 1);
+			}
+
+			if ((j + 1 < len2) && (hind[i] & 1L) 
+				 && ((i == 0) || (hind[i - 1] >= 2*(j + 2) + 1))) // same row
+			{
+				entries[i].j = j + 1;
+				entries[i].packed = packed1[i] + packed2[j + 1];
+				_F_mpz_mpoly_heap_push(heap, entries, &heap_bottom, i);
+				hind[i] = 2*(j + 2);
+			}
+		}
+
+		F_mpz_mpoly_fit_length(res, k + 1);
+		_F_mpz_mpoly_set_3(res->coeffs + k, sum);
+		if (is_big) F_mpz_add(res->coeffs + k, res->coeffs + k, big);
+		res->packed[k] = packed;
+
+		if (!F_mpz_is_zero(res->coeffs + k)) k++; // otherwise the terms cancelled
+	}
+
+	res->length = k;
+
+	F_mpz_clear(big);
+	flint_heap_free(Q);
+	flint_heap_free(hind);
+	flint_heap_free(heap);
+	flint_heap_free(entries);
+}
+
+/*
+   The terms of a product whose monomials lie in a given range, computed by
+	one thread. Threads can't create F_mpz's, so each coefficient is kept as
+	three limbs, plus an mpz_t for the terms involving large coefficients.
+*/
+typedef struct
+{
+	ulong * packed;
+	ulong * sums; // three limbs per term
+	ulong length;
+	ulong alloc;
+	ulong * big; // indices of the terms with an mpz_t part, in increasing order
+	__mpz_struct * big_vals;
+	ulong big_length;
+	ulong big_alloc;
+} F_mpz_mpoly_chunk_s;
+
+/*
+   Returns the number of pairs (i, j) with packed1[i] + packed2[j] < S. If
+	J is not NULL, J[i] is set to the number of such pairs in row i, i.e. 
+	the first j in row i whose monomial is at least S. 
+*/
+static
+ulong _F_mpz_mpoly_mul_split(ulong * J, const ulong * packed1, const ulong len1, 
+								     const ulong * packed2, const ulong len2, const ulong S)
+{
+	ulong count = 0, i, j = len2;
+
+	for (i = 0; i < len1; i++)
+	{
+		if (packed1[i] >= S) j = 0;
+		else // S - packed1[i] decreases with i, so j only moves down
+			while ((j > 0) && (packed2[j - 1] >= S - packed1[i])) j--;
+		
+		if (J) J[i] = j;
+		count += j;
+	}
+
+	return count;
+}
+
+/*
+   Adds c1*c2 to the mpz_t sum, where at least one of c1 and c2 is large.
+	Only reads the mpz_t's of the coefficients, so it is safe to call from 
+	several threads at once.
+*/
+static inline
+void _F_mpz_mpoly_addmul_mpz(mpz_t sum, const F_mpz c1, const F_mpz c2)
+{
+	if (COEFF_IS_MPZ(c1) && COEFF_IS_MPZ(c2))
+		mpz_addmul(sum, F_mpz_ptr_mpz(c1), F_mpz_ptr_mpz(c2));
+	else if (COEFF_IS_MPZ(c1))
+	{
+		if (c2 < 0L) mpz_submul_ui(sum, F_mpz_ptr_mpz(c1), -c2);
+		else mpz_addmul_ui(sum, F_mpz_ptr_mpz(c1), c2);
+	} else
+	{
+		if (c1 < 0L) mpz_submul_ui(sum, F_mpz_ptr_mpz(c2), -c1);
+		else mpz_addmul_ui(sum, F_mpz_ptr_mpz(c2), c1);
+	}
+}
+
+/*
+   Computes the terms (i, j) of the product with start[i] <= j < end[i], 
+	which must be all the terms whose monomials lie in some range, into chunk.
+*/
+static
+void _F_mpz_mpoly_mul_heap_chunk(F_mpz_mpoly_chunk_s * chunk, 
+		      const F_mpz * coeffs1, const ulong * packed1, const ulong len1, 
+				const F_mpz * coeffs2, const ulong * packed2, 
+				const ulong * start, const ulong * end)
+{
+	F_mpz_mpoly_heap_s * entries = (F_mpz_mpoly_heap_s *) 
+		                 flint_heap_alloc_bytes(len1*sizeof(F_mpz_mpoly_heap_s));
+	ulong * heap = (ulong *) flint_heap_alloc(len1 + 1);
+	ulong * Q = (ulong *) flint_heap_alloc(len1); // rows popped for the current monomial
+	ulong heap_bottom = 0;
+	ulong Q_len, i, j;
+	mpz_t big;
+
+	mpz_init(big);
+
+	chunk->length = chunk->big_length = 0;
+	chunk->alloc = chunk->big_alloc = 16;
+	chunk->packed = (ulong *) flint_heap_alloc(chunk->alloc);
+	chunk->sums = (ulong *) flint_heap_alloc(3*chunk->alloc);
+	chunk->big = (ulong *) flint_heap_alloc(chunk->big_alloc);
+	chunk->big_vals = (__mpz_struct *) flint_heap_alloc_bytes(chunk->big_alloc*sizeof(__mpz_struct));
+
+	for (i = 0; i < len1; i++)
+	{
+		if (start[i] < end[i])
+		{
+			entries[i].j = start[i];
+			entries[i].packed = packed1[i] + packed2[start[i]];
+			_F_mpz_mpoly_heap_push(heap, entries, &heap_bottom, i);
+		}
+	}
+
+	while (heap_bottom)
+	{
+		ulong packed = entries[heap[1]].packed;
+		ulong * sum;
+		int is_big = 0;
+
+		if (chunk->length == chunk->alloc)
+		{
+			chunk->alloc *= 2;
+			chunk->packed = (ulong *) flint_heap_realloc(chunk->packed, chunk->alloc);
+			chunk->sums = (ulong *) flint_heap_realloc(chunk->sums, 3*chunk->alloc);
+		}
+
+		sum = chunk->sums + 3*chunk->length;
+		sum[0] = sum[1] = sum[2] = 0L;
+		Q_len = 0;
+
+		do
+		{
+			i = _F_mpz_mpoly_heap_pop(heap, entries, &heap_bottom);
+
+			do
+			{
+				j = entries[i].j;
+				Q[Q_len++] = i;
+
+				if (!COEFF_IS_MPZ(coeffs1[i]) && !COEFF_IS_MPZ(coeffs2[j]))
+					_F_mpz_mpoly_addmul_3(sum, coeffs1[i], coeffs2[j]);
+				else 
+				{
+					if (!is_big) mpz_set_ui(big, 0);
+					_F_mpz_mpoly_addmul_mpz(big, coeffs1[i], coeffs2[j]);
+					is_big = 1;
+				}
+
+				i = entries[i].chain;
+			} while (i != -1L);
+		} while ((heap_bottom) && (entries[heap[1]].packed == packed));
+
+		while (Q_len) // each row moves on to its next term
+		{
+			i = Q[--Q_len];
+			j = entries[i].j + 1;
+
+			if (j < end[i])
+			{
+				entries[i].j = j;
+				entries[i].packed = packed1[i] + packed2[j];
+				_F_mpz_mpoly_heap_push(heap, entries, &heap_bottom, i);
+			}
+		}
+
+		if (is_big && mpz_sgn(big))
+		{
+			if (chunk->big_length == chunk->big_alloc)
+			{
+				chunk->big_alloc *= 2;
+				chunk->big = (ulong *) flint_heap_realloc(chunk->big, chunk->big_alloc);
+				chunk->big_vals = (__mpz_struct *) flint_heap_realloc_bytes(chunk->big_vals, 
+					                              chunk->big_alloc*sizeof(__mpz_struct));
+			}
+
+			chunk->big[chunk->big_length] = chunk->length;
+			mpz_init_set(chunk->big_vals + chunk->big_length, big);
+			chunk->big_length++;
+		} else if (!sum[0] && !sum[1] && !sum[2]) continue; // the terms cancelled
+
+		chunk->packed[chunk->length++] = packed;
+	}
+
+	mpz_clear(big);
+	flint_heap_free(Q);
+	flint_heap_free(heap);
+	flint_heap_free(entries);
+}
+
+void _F_mpz_mpoly_mul_heap_threaded(F_mpz_mpoly_t res, const F_mpz * coeffs1, 
+		const ulong * packed1, const ulong len1, const F_mpz * coeffs2, 
+		const ulong * packed2, const ulong len2, const ulong threads)
+{
+	F_mpz_mpoly_chunk_s * chunks = (F_mpz_mpoly_chunk_s *) 
+		                   flint_heap_alloc_bytes(threads*sizeof(F_mpz_mpoly_chunk_s));
+	ulong * J = (ulong *) flint_heap_alloc((threads + 1)*len1); // J + t*len1 starts chunk t
+	ulong total = len1*len2;
+	ulong lo = packed1[0] + packed2[0];
+	ulong hi = packed1[len1 - 1] + packed2[len2 - 1] + 1L;
+	ulong i, k, length = 0;
+	long t;
+	F_mpz_t temp;
+
+	for (i = 0; i < len1; i++)
+	{
+		J[i] = 0;
+		J[threads*len1 + i] = len2;
+	}
+
+	/*
+	   Split the monomials of the product into ranges [S_t, S_{t+1}) which 
+		each contain about total/threads of the pairs (i, j), by bisection.
+	*/
+#pragma omp parallel for num_threads(threads)
+	for (t = 1; t < threads; t++)
+	{
+		ulong target = (total/threads)*t + ((total%threads)*t)/threads;
+		ulong a = lo, b = hi;
+
+		if (target) // count(a) < target <= count(b)
+		{
+			while (b - a > 1)
+			{
+				ulong mid = a + (b - a)/2;
+				if (_F_mpz_mpoly_mul_split(NULL, packed1, len1, packed2, len2, mid) >= target)
+					b = mid;
+				else a = mid;
+			}
+		} else b = lo;
+
+		_F_mpz_mpoly_mul_split(J + t*len1, packed1, len1, packed2, len2, b);
+	}
+
+#pragma omp parallel for num_threads(threads)
+	for (t = 0; t < threads; t++)
+		_F_mpz_mpoly_mul_heap_chunk(chunks + t, coeffs1, packed1, len1, 
+			                coeffs2, packed2, J + t*len1, J + (t + 1)*len1);
+
+	// write out the terms, which are in order from one chunk to the next
+	for (t = 0; t < threads; t++)
+		length += chunks[t].length;
+
+	_F_mpz_mpoly_truncate(res, 0);
+	F_mpz_mpoly_fit_length(res, length);
+	F_mpz_init(temp);
+
+	for (t = 0, k = 0; t < threads; t++)
+	{
+		F_mpz_mpoly_chunk_s * chunk = chunks + t;
+		ulong b = 0;
+
+		for (i = 0; i < chunk->length; i++)
+		{
+			_F_mpz_mpoly_set_3(res->coeffs + k, chunk->sums + 3*i);
+			
+			if ((b < chunk->big_length) && (chunk->big[b] == i))
+			{
+				F_mpz_set_mpz(temp, chunk->big_vals + b);
+				F_mpz_add(res->coeffs + k, res->coeffs + k, temp);
+				mpz_clear(chunk->big_vals + b);
+				b++;
+			}
+			
+			res->packed[k] = chunk->packed[i];
+			if (!F_mpz_is_zero(res->coeffs + k)) k++; 
+		}
+
+		flint_heap_free(chunk->packed);
+		flint_heap_free(chunk->sums);
+		flint_heap_free(chunk->big);
+		flint_heap_free(chunk->big_vals);
+	}
+
+	res->length = k;
+
+	F_mpz_clear(temp);
+	flint_heap_free(J);
+	flint_heap_free(chunks);
+}
+
+ulong F_mpz_mpoly_mul_threads(void)
+{
+#ifdef _OPENMP
+   return omp_get_max_threads();
+#else
+   return 1;
+#endif
+}
+
+/*
+   Sets *packed1 and *packed2 to the monomials of poly1 and poly2 with fields
+	of the width returned, which is wide enough for their product. Copies 
+	are made if they need to be repacked, which must be freed with 
+	_F_mpz_mpoly_unpack_operands. Returns 0, setting neither, if an input 
+	is not a small GRLEX polynomial or the monomials of the product can't
+	be packed into a limb.
+*/
+static
+int _F_mpz_mpoly_pack_operands(ulong ** packed1, ulong ** packed2, 
+										 F_mpz_mpoly_t poly1, F_mpz_mpoly_t poly2)
+{
+	if (!poly1->small || !poly2->small || (poly1->ordering != GRLEX) || (poly2->ordering != GRLEX))
+		return 0;
+
+	int bits = F_mpz_mpoly_mul_packed_bits(poly1, poly2);
+	if (!bits) return 0;
+
+	*packed1 = poly1->packed;
+	*packed2 = poly2->packed;
+
+	if (poly1->packed_bits != bits)
+	{
+		*packed1 = (ulong *) flint_heap_alloc(poly1->length);
+		_F_mpz_mpoly_repack(*packed1, poly1->packed, poly1->length, 
+			                      poly1->vars, poly1->packed_bits, bits);
+	}
+
+	if (poly2->packed_bits != bits)
+	{
+		*packed2 = (ulong *) flint_heap_alloc(poly2->length);
+		_F_mpz_mpoly_repack(*packed2, poly2->packed, poly2->length, 
+			                      poly2->vars, poly2->packed_bits, bits);
+	}
+
+	return bits;
+}
+
+static
+void _F_mpz_mpoly_unpack_operands(ulong * packed1, ulong * packed2, 
+										 F_mpz_mpoly_t poly1, F_mpz_mpoly_t poly2)
+{
+	if (packed1 != poly1->packed) flint_heap_free(packed1);
+	if (packed2 != poly2->packed) flint_heap_free(packed2);
+}
+
+/*
+   Multiplies poly1 and poly2, whose monomials have been packed into packed1 
+	and packed2 by _F_mpz_mpoly_pack_operands, with the heap algorithm. 
+*/
+static
+void _F_mpz_mpoly_mul_heap_packed(F_mpz_mpoly_t res, F_mpz_mpoly_t poly1, 
+		ulong * packed1, F_mpz_mpoly_t poly2, ulong * packed2, const ulong threads)
+{
+	// the heaps have one entry per term of the first operand, so make it the shorter
+	if (poly1->length <= poly2->length)
+	{
+		if (threads > 1)
+			_F_mpz_mpoly_mul_heap_threaded(res, poly1->coeffs, packed1, poly1->length,
+			                         poly2->coeffs, packed2, poly2->length, threads);
+		else
+			_F_mpz_mpoly_mul_heap(res, poly1->coeffs, packed1, poly1->length,
+			                         poly2->coeffs, packed2, poly2->length);
+	} else
+	{
+		if (threads > 1)
+			_F_mpz_mpoly_mul_heap_threaded(res, poly2->coeffs, packed2, poly2->length,
+			                         poly1->coeffs, packed1, poly1->length, threads);
+		else
+			_F_mpz_mpoly_mul_heap(res, poly2->coeffs, packed2, poly2->length,
+			                         poly1->coeffs, packed1, poly1->length);
+	}
+}
+
+/*
+   Monomials which can't be packed into a limb are multiplied as vectors of 
+	vars + 2 limbs, the total degree in two limbs, so that it can't overflow, 
+	followed by the exponents of each variable. Comparing these vectors limb 
+	by limb gives the GRLEX order, as for the packed monomials.
+*/
+static inline
+int _F_mpz_mpoly_mon_cmp(const ulong * m1, const ulong * m2, const ulong N)
+{
+	ulong k;
+
+	for (k = 0; k < N; k++)
+		if (m1[k] != m2[k]) return (m1[k] < m2[k]) ? -1 : 1;
+
+	return 0;
+}
+
+/*
+   Sets res to the monomials of the GRLEX polynomial poly, small or not, as
+	vectors of vars + 2 limbs, where vars is at least poly->vars.
+*/
+static
+void _F_mpz_mpoly_get_mons(ulong * res, F_mpz_mpoly_t poly, const ulong vars)
+{
+	ulong i, j, exp;
+	ulong * m;
+
+	for (i = 0, m = res; i < poly->length; i++, m += vars + 2)
+	{
+		m[0] = m[1] = 0L;
+		for (j = 0; j < vars; j++)
+		{
+			exp = F_mpz_mpoly_get_var_exp(poly, i, j);
+			add_ssaaaa(m[0], m[1], m[0], m[1], 0L, exp);
+			m[j + 2] = exp;
+		}
+	}
+}
+
+/*
+   As for _F_mpz_mpoly_heap_push and _F_mpz_mpoly_heap_pop, but the heap is
+	ordered by the monomials of N limbs mons + N*i of its rows i, and equal
+	monomials are not chained.
+*/
+static inline
+void _F_mpz_mpoly_heap_push_mons(ulong * heap, const ulong * mons, const ulong N, 
+											ulong * heap_bottom, const ulong i)
+{
+	ulong entry = ++(*heap_bottom);
+
+	while ((entry > 1) && (_F_mpz_mpoly_mon_cmp(mons + N*heap[entry/2], mons + N*i, N) > 0))
+	{
+		heap[entry] = heap[entry/2];
+		entry /= 2;
+	}
+
+	heap[entry] = i;
+}
+
+static inline
+ulong _F_mpz_mpoly_heap_pop_mons(ulong * heap, const ulong * mons, const ulong N, 
+											ulong * heap_bottom)
+{
+	ulong top = heap[1];
+	ulong last = heap[*heap_bottom];
+	ulong n = --(*heap_bottom);
+	ulong entry = 1, child;
+
+	while ((child = 2*entry) <= n)
+	{
+		if ((child < n) && (_F_mpz_mpoly_mon_cmp(mons + N*heap[child + 1], 
+			                                      mons + N*heap[child], N) < 0))
+			child++;
+		if (_F_mpz_mpoly_mon_cmp(mons + N*heap[child], mons + N*last, N) >= 0) break;
+		heap[entry] = heap[child];
+		entry = child;
+	}
+
+	heap[entry] = last;
+
+	return top;
+}
+
+/*
+   Sets res to poly1*poly2, which are GRLEX polynomials but need not be 
+	small, as a large polynomial, using the same heap algorithm as 
+	_F_mpz_mpoly_mul_heap on unpacked monomials. Used when the monomials of 
+	the product can't be packed into a limb. Assumes neither input is zero
+	and res is not one of them.
+*/
+static
+void _F_mpz_mpoly_mul_heap_unpacked(F_mpz_mpoly_t res, F_mpz_mpoly_t poly1, 
+																 F_mpz_mpoly_t poly2)
+{
+	// the heap has one entry per term of the first operand, so make it the shorter
+	F_mpz_mpoly_struct * p1 = (poly1->length <= poly2->length) ? poly1 : poly2;
+	F_mpz_mpoly_struct * p2 = (poly1->length <= poly2->length) ? poly2 : poly1;
+	const ulong len1 = p1->length, len2 = p2->length;
+	const ulong vars = FLINT_MAX(poly1->vars, poly2->vars);
+	const ulong N = vars + 2;
+	ulong i, j, k = 0, f, Q_len, max1, max2, alloc;
+	ulong sum[3];
+	F_mpz_mpoly_t temp;
+	F_mpz_t big;
+
+	ulong * mons1 = (ulong *) flint_heap_alloc(N*len1);
+	ulong * mons2 = (ulong *) flint_heap_alloc(N*len2);
+	_F_mpz_mpoly_get_mons(mons1, p1, vars);
+	_F_mpz_mpoly_get_mons(mons2, p2, vars);
+
+	// the exponents of the product must still fit in a limb
+	for (f = 2; f < N; f++)
+	{
+		for (i = 0, max1 = 0L; i < len1; i++) max1 = FLINT_MAX(max1, mons1[N*i + f]);
+		for (j = 0, max2 = 0L; j < len2; j++) max2 = FLINT_MAX(max2, mons2[N*j + f]);
+		if (max1 + max2 < max1)
+		{
+			printf("FLINT Exception: Exponent overflow in F_mpz_mpoly_mul\n");
+			abort();
+		}
+	}
+
+	ulong * heap = (ulong *) flint_heap_alloc(len1 + 1);
+	ulong * hind = (ulong *) flint_heap_alloc(len1); 
+	ulong * hj = (ulong *) flint_heap_alloc(len1); // column of the term of each row in the heap
+	ulong * hmons = (ulong *) flint_heap_alloc(N*(len1 + 1)); // and its monomial, then the current one
+	ulong * Q = (ulong *) flint_heap_alloc(2*len1);
+	ulong * mon = hmons + N*len1;
+	ulong heap_bottom = 0;
+
+	alloc = len1 + len2;
+	ulong * mons = (ulong *) flint_heap_alloc(N*alloc); // monomials of the product
+
+	F_mpz_init(big);
+	F_mpz_mpoly_init2(temp, 0, vars, GRLEX);
+
+#define SET_TERM(ii, jj) \
+	do { \
+		ulong * m_xxx = hmons + N*(ii); \
+		const ulong * m1_xxx = mons1 + N*(ii), * m2_xxx = mons2 + N*(jj); \
+		add_ssaaaa(m_xxx[0], m_xxx[1], m1_xxx[0], m1_xxx[1], m2_xxx[0], m2_xxx[1]); \
+		for (f = 2; f < N; f++) m_xxx[f] = m1_xxx[f] + m2_xxx[f]; \
+		hj[ii] = (jj); \
+	} while (0)
+
+	// hind is as for _F_mpz_mpoly_mul_heap
+	for (i = 0; i < len1; i++) hind[i] = 1;
+
+	SET_TERM(0, 0);
+	_F_mpz_mpoly_heap_push_mons(heap, hmons, N, &heap_bottom, 0);
+	hind[0] = 2;
+
+	while (heap_bottom)
+	{
+		int is_big = 0;
+
+		F_mpn_copy(mon, hmons + N*heap[1], N);
+		sum[0] = sum[1] = sum[2] = 0L;
+		Q_len = 0;
+
+		do // pop all terms with this monomial
+		{
+			i = _F_mpz_mpoly_heap_pop_mons(heap, hmons, N, &heap_bottom);
+			j = hj[i];
+			hind[i] |= 1L;
+			Q[Q_len++] = i;
+			Q[Q_len++] = j;
+
+			if (!COEFF_IS_MPZ(p1->coeffs[i]) && !COEFF_IS_MPZ(p2->coeffs[j]))
+				_F_mpz_mpoly_addmul_3(sum, p1->coeffs[i], p2->coeffs[j]);
+			else
+			{
+				if (!is_big) F_mpz_zero(big);
+				F_mpz_addmul(big, p1->coeffs + i, p2->coeffs + j);
+				is_big = 1;
+			}
+		} while ((heap_bottom) && (_F_mpz_mpoly_mon_cmp(hmons + N*heap[1], mon, N) == 0));
+
+		while (Q_len) // insert successors of the terms just removed
+		{
+			j = Q[--Q_len];
+			i = Q[--Q_len];
+
+			if ((i + 1 < len1) && (hind[i + 1] == 2*j + 1)) // next row
+			{
+				SET_TERM(i + 1, j);
+				_F_mpz_mpoly_heap_push_mons(heap, hmons, N, &heap_bottom, i + 1);
+				hind[i + 1] = 2*(j + 1);
+			}
+
+			if ((j + 1 < len2) && (hind[i] & 1L) 
+				 && ((i == 0) || (hind[i - 1] >= 2*(j + 2) + 1))) // same row
+			{
+				SET_TERM(i, j + 1);
+				_F_mpz_mpoly_heap_push_mons(heap, hmons, N, &heap_bottom, i);
+				hind[i] = 2*(j + 2);
+			}
+		}
+
+		F_mpz_mpoly_fit_length(temp, k + 1);
+		_F_mpz_mpoly_set_3(temp->coeffs + k, sum);
+		if (is_big) F_mpz_add(temp->coeffs + k, temp->coeffs + k, big);
+
+		if (!F_mpz_is_zero(temp->coeffs + k)) // otherwise the terms cancelled
+		{
+			if (k == alloc)
+			{
+				alloc *= 2;
+				mons = (ulong *) flint_heap_realloc(mons, N*alloc);
+			}
+			F_mpn_copy(mons + N*k, mon, N);
+			k++;
+		}
+	}
+
+#undef SET_TERM
+
+	temp->length = k;
+
+	// move the exponents into packed vectors, as F_mpz_mpoly_unpack does
+	temp->exps = vars ? (pv_s *) flint_heap_alloc_bytes(vars*sizeof(pv_s)) : NULL;
+	for (f = 0; f < vars; f++)
+	{
+		for (i = 0, max1 = 0L; i < k; i++) max1 = FLINT_MAX(max1, mons[N*i + f + 2]);
+
+		pv_init(temp->exps + f, temp->alloc, max1 ? pv_bit_fit(FLINT_BIT_COUNT(max1)) : 0);
+		temp->exps[f].length = max1 ? k : 0;
+		if (max1)
+			for (i = 0; i < k; i++)
+				PV_SET_ENTRY(temp->exps[f], i, mons[N*i + f + 2]);
+	}
+	temp->small = 0;
+
+	F_mpz_mpoly_clear(res);
+	*res = *temp;
+
+	F_mpz_clear(big);
+	flint_heap_free(mons);
+	flint_heap_free(Q);
+	flint_heap_free(hmons);
+	flint_heap_free(hj);
+	flint_heap_free(hind);
+	flint_heap_free(heap);
+	flint_heap_free(mons2);
+	flint_heap_free(mons1);
+}
+
+void F_mpz_mpoly_mul_heap_threaded(F_mpz_mpoly_t res, F_mpz_mpoly_t poly1, 
+											  F_mpz_mpoly_t poly2, ulong threads)
+{
+	if ((poly1->length == 0) || (poly2->length == 0))
+	{
+		_F_mpz_mpoly_truncate(res, 0);
+		return;
+	}
+
+	if ((res == poly1) || (res == poly2))
+	{
+		F_mpz_mpoly_t temp;
+		F_mpz_mpoly_init2(temp, 0, FLINT_MAX(poly1->vars, poly2->vars), GRLEX);
+		F_mpz_mpoly_mul_heap_threaded(temp, poly1, poly2, threads);
+		F_mpz_mpoly_clear(res);
+		*res = *temp;
+		return;
+	}
+
+	ulong * packed1, * packed2;
+	int bits = _F_mpz_mpoly_pack_operands(&packed1, &packed2, poly1, poly2);
+
+	if (!bits) // the monomials of the product don't fit in a limb
+	{
+		_F_mpz_mpoly_mul_heap_unpacked(res, poly1, poly2);
+		return;
+	}
+
+	res->vars = FLINT_MAX(poly1->vars, poly2->vars);
+	res->ordering = GRLEX;
+	res->packed_bits = bits;
+
+	_F_mpz_mpoly_mul_heap_packed(res, poly1, packed1, poly2, packed2, threads);
+
+	_F_mpz_mpoly_unpack_operands(packed1, packed2, poly1, poly2);
+}
+
+void F_mpz_mpoly_mul_heap(F_mpz_mpoly_t res, F_mpz_mpoly_t poly1, F_mpz_mpoly_t poly2)
+{
+	ulong threads = F_mpz_mpoly_mul_threads();
+
+	// each thread should have a reasonable share of the work
+	if (poly1->length*poly2->length < threads*FLINT_F_MPZ_MPOLY_THREADED_CUTOFF) 
+		threads = 1;
+
+	F_mpz_mpoly_mul_heap_threaded(res, poly1, poly2, threads);
+}
+
+/*===============================================================================
+
+	Kronecker substitution
+
+================================================================================*/
+
+/*
+   In GRLEX the total degree determines the exponent of the last variable, 
+	so a packed monomial is determined by its first vars fields, i.e. the 
+	total degree and all but the last variable, and the packed monomials are
+	ordered lexicographically by these fields. Substituting 
+	
+	   field f -> x^(w[f]*(value - lo[f]))
+	
+	for weights w decreasing with f therefore gives a univariate polynomial
+	whose terms are in the same order as those of the multivariate one. For
+	a product, lo[f] is the smallest value of field f in each input and the 
+	weights are chosen so that no field of the product carries into the next.
+*/
+typedef struct
+{
+	ulong * lo1; // smallest value of each field in the first input
+	ulong * lo2; // smallest value of each field in the second input
+	ulong * radix; // number of values each field of the product can take
+	ulong * w; // weight of each field
+	ulong len1; // length of the first input after substitution
+	ulong len2; // length of the second input after substitution
+	ulong length; // length of the product after substitution
+	ulong vars;
+	int bits;
+} F_mpz_mpoly_kronecker_s;
+
+static inline
+ulong _F_mpz_mpoly_field(const ulong m, const ulong f, const int bits)
+{
+	return (m >> (FLINT_BITS - bits*(f + 1))) & ((1L << bits) - 1L);
+}
+
+static inline
+ulong _F_mpz_mpoly_kronecker_index(const ulong m, const ulong * lo, 
+											  const F_mpz_mpoly_kronecker_s * ks)
+{
+	ulong f, index = 0L;
+
+	for (f = 0; f < ks->vars; f++)
+		index += (_F_mpz_mpoly_field(m, f, ks->bits) - lo[f])*ks->w[f];
+
+	return index;
+}
+
+static
+void _F_mpz_mpoly_field_range(ulong * lo, ulong * hi, const ulong * packed, 
+						 const ulong len, const ulong vars, const int bits)
+{
+	ulong i, f, v;
+
+	for (f = 0; f < vars; f++)
+	{
+		lo[f] = -1L;
+		hi[f] = 0L;
+	}
+
+	for (i = 0; i < len; i++)
+	{
+		for (f = 0; f < vars; f++)
+		{
+			v = _F_mpz_mpoly_field(packed[i], f, bits);
+			if (v < lo[f]) lo[f] = v;
+			if (v > hi[f]) hi[f] = v;
+		}
+	}
+}
+
+/*
+   Sets up the substitution for the product of the given monomials, which 
+	must be packed with fields wide enough for the product. Returns 0 if the 
+	substituted product would be too long, in which case ks is cleared.
+*/
+static
+int _F_mpz_mpoly_kronecker_init(F_mpz_mpoly_kronecker_s * ks, 
+		const ulong * packed1, const ulong len1, const ulong * packed2, 
+		const ulong len2, const ulong vars, const int bits)
+{
+	ulong * hi1, * hi2;
+	ulong length = 1L;
+	long f;
+
+	if (vars == 0) return 0;
+
+	ks->vars = vars;
+	ks->bits = bits;
+	ks->lo1 = (ulong *) flint_heap_alloc(6*vars);
+	ks->lo2 = ks->lo1 + vars;
+	ks->radix = ks->lo2 + vars;
+	ks->w = ks->radix + vars;
+	hi1 = ks->w + vars;
+	hi2 = hi1 + vars;
+
+	_F_mpz_mpoly_field_range(ks->lo1, hi1, packed1, len1, vars, bits);
+	_F_mpz_mpoly_field_range(ks->lo2, hi2, packed2, len2, vars, bits);
+
+	for (f = vars - 1; f >= 0; f--)
+	{
+		ks->radix[f] = (hi1[f] - ks->lo1[f]) + (hi2[f] - ks->lo2[f]) + 1;
+		ks->w[f] = length;
+		
+		// the length must fit comfortably in a limb
+		if (length > (1L << (FLINT_BITS - 2))/ks->radix[f])
+		{
+			flint_heap_free(ks->lo1);
+			return 0;
+		}
+		length *= ks->radix[f];
+	}
+
+	ks->length = length;
+
+	// the last monomial of each input has the largest index
+	ks->len1 = _F_mpz_mpoly_kronecker_index(packed1[len1 - 1], ks->lo1, ks) + 1;
+	ks->len2 = _F_mpz_mpoly_kronecker_index(packed2[len2 - 1], ks->lo2, ks) + 1;
+
+	return 1;
+}
+
+static
+void _F_mpz_mpoly_kronecker_clear(F_mpz_mpoly_kronecker_s * ks)
+{
+	flint_heap_free(ks->lo1);
+}
+
+/*
+   Multiplies the given polynomials, whose monomials are packed as for 
+	_F_mpz_mpoly_kronecker_init, by Kronecker substitution.
+*/
+static
+void _F_mpz_mpoly_mul_kronecker_ks(F_mpz_mpoly_t res, 
+		const F_mpz * coeffs1, const ulong * packed1, const ulong len1, 
+		const F_mpz * coeffs2, const ulong * packed2, const ulong len2, 
+		const F_mpz_mpoly_kronecker_s * ks)
+{
+	F_mpz_poly_t a, b, p;
+	ulong i, k, count;
+	long f;
+	const ulong vars = ks->vars;
+	const int bits = ks->bits;
+	const ulong last = 1L << (FLINT_BITS - bits*(vars + 1)); // last variable
+
+	F_mpz_poly_init2(a, ks->len1);
+	F_mpz_poly_init2(b, ks->len2);
+	F_mpz_poly_init(p);
+
+	for (i = 0; i < len1; i++)
+		F_mpz_set(a->coeffs + _F_mpz_mpoly_kronecker_index(packed1[i], ks->lo1, ks), coeffs1 + i);
+	a->length = ks->len1;
+	
+	for (i = 0; i < len2; i++)
+		F_mpz_set(b->coeffs + _F_mpz_mpoly_kronecker_index(packed2[i], ks->lo2, ks), coeffs2 + i);
+	b->length = ks->len2;
+
+	F_mpz_poly_mul(p, a, b);
+
+	F_mpz_poly_clear(a);
+	F_mpz_poly_clear(b);
+
+	count = 0;
+	for (k = 0; k < p->length; k++)
+		if (!F_mpz_is_zero(p->coeffs + k)) count++;
+
+	_F_mpz_mpoly_truncate(res, 0);
+	F_mpz_mpoly_fit_length(res, count);
+
+	/*
+	   Runs through the indices k with an odometer d of field values, keeping 
+		m equal to the packed monomial with those fields. Increasing the total
+		degree increases the exponent of the last variable and increasing any 
+		other variable decreases it. Arithmetic is mod 2^FLINT_BITS, so m need
+		only be correct when d corresponds to a monomial.
+	*/
+	ulong * d = (ulong *) flint_heap_alloc(2*vars);
+	ulong * unit = d + vars;
+	ulong m = 0L, lo;
+
+	for (f = 0; f < vars; f++)
+	{
+		d[f] = 0L;
+		unit[f] = (1L << (FLINT_BITS - bits*(f + 1))) - last;
+		lo = ks->lo1[f] + ks->lo2[f];
+		m += lo*unit[f];
+	}
+	unit[0] += 2*last;
+	m += 2*last*(ks->lo1[0] + ks->lo2[0]);
+
+	count = 0;
+	for (k = 0; k < p->length; k++)
+	{
+		if (!F_mpz_is_zero(p->coeffs + k))
+		{
+			F_mpz_swap(res->coeffs + count, p->coeffs + k);
+			res->packed[count] = m;
+			count++;
+		}
+
+		for (f = vars - 1; f >= 0; f--)
+		{
+			d[f]++;
+			m += unit[f];
+			if (d[f] < ks->radix[f]) break;
+			m -= d[f]*unit[f];
+			d[f] = 0L;
+		}
+	}
+
+	res->length = count;
+
+	flint_heap_free(d);
+	F_mpz_poly_clear(p);
+}
+
+int F_mpz_mpoly_mul_kronecker(F_mpz_mpoly_t res, F_mpz_mpoly_t poly1, F_mpz_mpoly_t poly2)
+{
+	if ((poly1->length == 0) || (poly2->length == 0))
+	{
+		_F_mpz_mpoly_truncate(res, 0);
+		return 1;
+	}
+
+	if ((res == poly1) || (res == poly2))
+	{
+		F_mpz_mpoly_t temp;
+		F_mpz_mpoly_init2(temp, 0, FLINT_MAX(poly1->vars, poly2->vars), GRLEX);
+		int ok = F_mpz_mpoly_mul_kronecker(temp, poly1, poly2);
+		if (ok)
+		{
+			F_mpz_mpoly_clear(res);
+			*res = *temp;
+		} else
+			F_mpz_mpoly_clear(temp);
+		return ok;
+	}
+
+	ulong * packed1, * packed2;
+	ulong vars = FLINT_MAX(poly1->vars, poly2->vars);
+	int bits = _F_mpz_mpoly_pack_operands(&packed1, &packed2, poly1, poly2);
+	F_mpz_mpoly_kronecker_s ks;
+
+	if (!bits) return 0; // the monomials of the product don't fit in a limb
+
+	int ok = _F_mpz_mpoly_kronecker_init(&ks, packed1, poly1->length, 
+		                                  packed2, poly2->length, vars, bits);
+
+	if (ok)
+	{
+		res->vars = vars;
+		res->ordering = GRLEX;
+		res->packed_bits = bits;
+
+		_F_mpz_mpoly_mul_kronecker_ks(res, poly1->coeffs, packed1, poly1->length, 
+		                                   poly2->coeffs, packed2, poly2->length, &ks);
+		_F_mpz_mpoly_kronecker_clear(&ks);
+	}
+
+	_F_mpz_mpoly_unpack_operands(packed1, packed2, poly1, poly2);
+
+	return ok;
+}
+
+/*===============================================================================
+
+	Multiplication
+
+================================================================================*/
+
+static F_mpz_mpoly_mul_hook_t _F_mpz_mpoly_mul_hook = NULL;
+static void * _F_mpz_mpoly_mul_hook_arg = NULL;
+
+void F_mpz_mpoly_mul_set_hook(F_mpz_mpoly_mul_hook_t hook, void * arg)
+{
+	_F_mpz_mpoly_mul_hook = hook;
+	_F_mpz_mpoly_mul_hook_arg = arg;
+}
+
+void F_mpz_mpoly_mul(F_mpz_mpoly_t res, F_mpz_mpoly_t poly1, F_mpz_mpoly_t poly2)
+{
+	if ((poly1->length == 0) || (poly2->length == 0))
+	{
+		_F_mpz_mpoly_truncate(res, 0);
+		return;
+	}
+
+	if ((res == poly1) || (res == poly2))
+	{
+		F_mpz_mpoly_t temp;
+		F_mpz_mpoly_init2(temp, 0, FLINT_MAX(poly1->vars, poly2->vars), GRLEX);
+		F_mpz_mpoly_mul(temp, poly1, poly2);
+		F_mpz_mpoly_clear(res);
+		*res = *temp;
+		return;
+	}
+
+	ulong * packed1, * packed2;
+	ulong len1 = poly1->length, len2 = poly2->length;
+	ulong vars = FLINT_MAX(poly1->vars, poly2->vars);
+	int bits = _F_mpz_mpoly_pack_operands(&packed1, &packed2, poly1, poly2);
+	F_mpz_mpoly_kronecker_s ks;
+
+	if (!bits) // the monomials of the product don't fit in a limb
+	{
+		if (_F_mpz_mpoly_mul_hook) 
+			_F_mpz_mpoly_mul_hook(F_MPZ_MPOLY_MUL_HEAP, len1, len2, _F_mpz_mpoly_mul_hook_arg);
+
+		_F_mpz_mpoly_mul_heap_unpacked(res, poly1, poly2);
+		return;
+	}
+
+	res->vars = vars;
+	res->ordering = GRLEX;
+	res->packed_bits = bits;
+
+	/*
+	   The heap algorithm does about len1*len2 operations, multiplication by
+		Kronecker substitution about as many as the substituted inputs have
+		coefficients, up to logarithmic factors. 
+	*/
+	if (_F_mpz_mpoly_kronecker_init(&ks, packed1, len1, packed2, len2, vars, bits))
+	{
+		if (len1*len2 >= FLINT_F_MPZ_MPOLY_KRONECKER_RATIO*(ks.len1 + ks.len2))
+		{
+			if (_F_mpz_mpoly_mul_hook) 
+				_F_mpz_mpoly_mul_hook(F_MPZ_MPOLY_MUL_KRONECKER, len1, len2, 
+				                                         _F_mpz_mpoly_mul_hook_arg);
+			
+			_F_mpz_mpoly_mul_kronecker_ks(res, poly1->coeffs, packed1, len1, 
+			                                    poly2->coeffs, packed2, len2, &ks);
+			_F_mpz_mpoly_kronecker_clear(&ks);
+			_F_mpz_mpoly_unpack_operands(packed1, packed2, poly1, poly2);
+			return;
+		}
+
+		_F_mpz_mpoly_kronecker_clear(&ks);
+	}
+
+	ulong threads = F_mpz_mpoly_mul_threads();
+	if (len1*len2 < threads*FLINT_F_MPZ_MPOLY_THREADED_CUTOFF) 
+		threads = 1;
+
+	if (_F_mpz_mpoly_mul_hook) 
+		_F_mpz_mpoly_mul_hook((threads > 1) ? F_MPZ_MPOLY_MUL_HEAP_THREADED 
+		                   : F_MPZ_MPOLY_MUL_HEAP, len1, len2, _F_mpz_mpoly_mul_hook_arg);
+
+	_F_mpz_mpoly_mul_heap_packed(res, poly1, packed1, poly2, packed2, threads);
+
+	_F_mpz_mpoly_unpack_operands(packed1, packed2, poly1, poly2);
+}
+
+/*===============================================================================
+
+	Division
+
+================================================================================*/
+
+/*
+   Returns a mask with the lowest bit of each field which a packed monomial 
+	in vars variables with fields of the given width can borrow into.
+*/
+static inline
+ulong _F_mpz_mpoly_borrow_mask(const ulong vars, const int bits)
+{
+	ulong mask = 0L, k;
+
+	for (k = 1; k <= vars; k++)
+		mask |= (1L << (FLINT_BITS - k*bits));
+
+	return mask;
+}
+
+/*
+   Returns the monomial whose fields are the largest values of the 
+	corresponding fields of the given monomials.
+*/
+static
+ulong _F_mpz_mpoly_field_max(const ulong * packed, const ulong len, 
+									  const ulong vars, const int bits)
+{
+	ulong i, f, v, max, res = 0L;
+	const ulong field = (1L << bits) - 1L;
+
+	for (f = 0; f <= vars; f++)
+	{
+		ulong shift = FLINT_BITS - bits*(f + 1);
+		max = 0L;
+		for (i = 0; i < len; i++)
+		{
+			v = (packed[i] >> shift) & field;
+			if (v > max) max = v;
+		}
+		res += (max << shift);
+	}
+
+	return res;
+}
+
+int _F_mpz_mpoly_divides_heap(F_mpz_mpoly_t Q, const F_mpz * coeffs1, const ulong * packed1, 
+		const ulong len1, const F_mpz * coeffs2, const ulong * packed2, const ulong len2, 
+		const ulong vars, const int bits, const int exact)
+{
+	ulong alloc = FLINT_MAX(len1/len2, 16); // entries and heap grow with Q
+	F_mpz_mpoly_heap_s * entries = (F_mpz_mpoly_heap_s *) 
+		                 flint_heap_alloc_bytes(alloc*sizeof(F_mpz_mpoly_heap_s));
+	ulong * heap = (ulong *) flint_heap_alloc(alloc + 1);
+	ulong * Qi = (ulong *) flint_heap_alloc(alloc); // rows popped for the current monomial
+	ulong heap_bottom = 0;
+	ulong Q_len, i, j, k = 0, q = 0;
+	ulong sum[3];
+	int result = 1;
+	F_mpz_t big, c, r;
+
+	const ulong mask = _F_mpz_mpoly_borrow_mask(vars, bits);
+
+	// a quotient monomial can be no larger than this, which bounds the work
+	ulong bound = packed1[len1 - 1] - packed2[len2 - 1]; 
+
+	/* 
+	   The degree of Q in each variable, and its total degree, is the 
+		difference of those of A and B, so the fields of each monomial of Q 
+		are bounded by those of max1 - max2.
+	*/
+	ulong max1 = _F_mpz_mpoly_field_max(packed1, len1, vars, bits);
+	ulong max2 = _F_mpz_mpoly_field_max(packed2, len2, vars, bits);
+	ulong qmax = max1 - max2;
+
+	F_mpz_init(big);
+	F_mpz_init(c);
+	F_mpz_init(r);
+	_F_mpz_mpoly_truncate(Q, 0);
+
+	if ((packed1[len1 - 1] < packed2[len2 - 1]) || (max1 < max2) 
+		                                        || ((max1 ^ max2 ^ qmax) & mask)) 
+		result = 0;
+	else if (!exact) // cheap test: the largest term of B must divide that of A
+	{
+		ulong qm = packed1[len1 - 1] - packed2[len2 - 1];
+		if ((packed1[len1 - 1] ^ packed2[len2 - 1] ^ qm) & mask) result = 0;
+		else 
+		{
+			F_mpz_fdiv_qr(c, r, coeffs1 + len1 - 1, coeffs2 + len2 - 1);
+			if (!F_mpz_is_zero(r)) result = 0;
+		}
+	}
+
+	/*
+	   Terms are produced from the bottom up. As the monomial ordering is 
+		multiplicative, the smallest term of A - Q*B, where Q is the quotient so
+		far, is divisible by the smallest term of B if B divides A, giving the 
+		next term of Q.
+	*/
+	while (result && ((k < len1) || heap_bottom))
+	{
+		ulong packed = (heap_bottom) ? entries[heap[1]].packed : -1L;
+		int is_big = 0;
+
+		if ((k < len1) && (packed1[k] <= packed)) packed = packed1[k];
+
+		if (exact && ((packed < packed2[0]) || (packed - packed2[0] > bound))) 
+			break; // there are no more terms of the quotient
+		
+		sum[0] = sum[1] = sum[2] = 0L;
+		Q_len = 0;
+
+		while ((heap_bottom) && (entries[heap[1]].packed == packed))
+		{
+			i = _F_mpz_mpoly_heap_pop(heap, entries, &heap_bottom);
+
+			do
+			{
+				j = entries[i].j;
+				Qi[Q_len++] = i;
+
+				if (!COEFF_IS_MPZ(Q->coeffs[i]) && !COEFF_IS_MPZ(coeffs2[j]))
+					_F_mpz_mpoly_addmul_3(sum, Q->coeffs[i], coeffs2[j]);
+				else
+				{
+					if (!is_big) F_mpz_zero(big);
+					F_mpz_addmul(big, Q->coeffs + i, coeffs2 + j);
+					is_big = 1;
+				}
+
+				i = entries[i].chain;
+			} while (i != -1L);
+		}
+
+		while (Q_len) // each row of Q*B moves on to its next term
+		{
+			i = Qi[--Q_len];
+			j = entries[i].j + 1;
+
+			if (j < len2)
+			{
+				entries[i].j = j;
+				entries[i].packed = Q->packed[i] + packed2[j];
+				_F_mpz_mpoly_heap_push(heap, entries, &heap_bottom, i);
+			}
+		}
+
+		// c is the coefficient of A - Q*B
+		_F_mpz_mpoly_set_3(c, sum);
+		if (is_big) F_mpz_add(c, c, big);
+		if ((k < len1) && (packed1[k] == packed)) F_mpz_sub(c, coeffs1 + k++, c);
+		else F_mpz_neg(c, c);
+
+		if (F_mpz_is_zero(c)) continue;
+
+		// the monomial must be divisible by the smallest one of B, with a 
+		// quotient not exceeding the bounds
+		ulong qm = packed - packed2[0];
+		if ((packed < packed2[0]) || (((packed ^ packed2[0] ^ qm) & mask) != 0L) || (qm > bound)
+			 || (qm > qmax) || (((qmax ^ qm ^ (qmax - qm)) & mask) != 0L))
+		{
+			result = 0;
+			break;
+		}
+
+		F_mpz_mpoly_fit_length(Q, q + 1);
+		if (exact) F_mpz_divexact(Q->coeffs + q, c, coeffs2);
+		else
+		{
+			F_mpz_fdiv_qr(Q->coeffs + q, r, c, coeffs2);
+			if (!F_mpz_is_zero(r))
+			{
+				result = 0;
+				break;
+			}
+		}
+		Q->packed[q] = qm;
+		
+		if (len2 > 1) // add the row of Q[q]*B to the heap
+		{
+			if (q == alloc)
+			{
+				alloc *= 2;
+				entries = (F_mpz_mpoly_heap_s *) flint_heap_realloc_bytes(entries, 
+					                          alloc*sizeof(F_mpz_mpoly_heap_s));
+				heap = (ulong *) flint_heap_realloc(heap, alloc + 1);
+				Qi = (ulong *) flint_heap_realloc(Qi, alloc);
+			}
+
+			entries[q].j = 1;
+			entries[q].packed = qm + packed2[1];
+			_F_mpz_mpoly_heap_push(heap, entries, &heap_bottom, q);
+		}
+
+		q++;
+		Q->length = q;
+	}
+
+	if (!result) _F_mpz_mpoly_truncate(Q, 0);
+	
+	F_mpz_clear(big);
+	F_mpz_clear(c);
+	F_mpz_clear(r);
+	flint_heap_free(Qi);
+	flint_heap_free(heap);
+	flint_heap_free(entries);
+
+	return result;
+}
+
+static
+int _F_mpz_mpoly_divides(F_mpz_mpoly_t Q, F_mpz_mpoly_t A, F_mpz_mpoly_t B, const int exact)
+{
+	if (B->length == 0)
+	{
+		printf("FLINT Exception: Division by zero\n");
+		abort();
+	}
+
+	if (A->length == 0)
+	{
+		_F_mpz_mpoly_truncate(Q, 0);
+		return 1;
+	}
+
+	if (!A->small || !B->small || (A->ordering != GRLEX) || (B->ordering != GRLEX))
+		abort(); // only implemented for packed GRLEX monomials
+
+	if ((Q == A) || (Q == B))
+	{
+		F_mpz_mpoly_t temp;
+		F_mpz_mpoly_init2(temp, 0, FLINT_MAX(A->vars, B->vars), GRLEX);
+		int result = _F_mpz_mpoly_divides(temp, A, B, exact);
+		F_mpz_mpoly_clear(Q);
+		*Q = *temp;
+		return result;
+	}
+
+	// the quotient fits in the wider of the fields of A and B
+	int bits = FLINT_MAX(A->packed_bits, B->packed_bits);
+	ulong vars = FLINT_MAX(A->vars, B->vars);
+	ulong * packed1 = A->packed;
+	ulong * packed2 = B->packed;
+
+	if (A->packed_bits != bits)
+	{
+		packed1 = (ulong *) flint_heap_alloc(A->length);
+		_F_mpz_mpoly_repack(packed1, A->packed, A->length, A->vars, A->packed_bits, bits);
+	}
+
+	if (B->packed_bits != bits)
+	{
+		packed2 = (ulong *) flint_heap_alloc(B->length);
+		_F_mpz_mpoly_repack(packed2, B->packed, B->length, B->vars, B->packed_bits, bits);
+	}
+
+	Q->vars = vars;
+	Q->ordering = GRLEX;
+	Q->packed_bits = bits;
+
+	int result = _F_mpz_mpoly_divides_heap(Q, A->coeffs, packed1, A->length, 
+		  B->coeffs, packed2, B->length, vars, bits, exact);
+
+	if (packed1 != A->packed) flint_heap_free(packed1);
+	if (packed2 != B->packed) flint_heap_free(packed2);
+
+	return result;
+}
+
+int F_mpz_mpoly_divides_heap(F_mpz_mpoly_t Q, F_mpz_mpoly_t A, F_mpz_mpoly_t B)
+{
+	return _F_mpz_mpoly_divides(Q, A, B, 0);
+}
+
+void F_mpz_mpoly_divexact_heap(F_mpz_mpoly_t Q, F_mpz_mpoly_t A, F_mpz_mpoly_t B)
+{
+	_F_mpz_mpoly_divides(Q, A, B, 1);
+}
@@ -38,6 +38,7 @@
 #include "flint.h"
 #include "F_mpz.h"
 #include "packed_vec.h"
+#include "flint-tuning.h"
 
 /*==============================================================================
 
@@ -107,6 +108,27 @@ typedef struct
 // F_mpz_poly_t allows reference-like semantics for F_mpz_poly_struct
 typedef F_mpz_mpoly_struct F_mpz_mpoly_t[1];
 
+// minimum number of pairs of terms per thread for multiplication to be threaded
+#define FLINT_F_MPZ_MPOLY_THREADED_CUTOFF (flint_tuning.F_mpz_mpoly_threaded_cutoff)
+
+/* 
+   F_mpz_mpoly_mul uses Kronecker substitution if the product of the lengths 
+	of the inputs is at least this times the sum of their lengths after 
+	substitution
+*/
+#define FLINT_F_MPZ_MPOLY_KRONECKER_RATIO (flint_tuning.F_mpz_mpoly_kronecker_ratio)
+
+// the algorithms F_mpz_mpoly_mul reports to its hook
+typedef enum
+{
+	F_MPZ_MPOLY_MUL_HEAP,
+	F_MPZ_MPOLY_MUL_HEAP_THREADED,
+	F_MPZ_MPOLY_MUL_KRONECKER
+} F_mpz_mpoly_mul_alg_t;
+
+typedef void (*F_mpz_mpoly_mul_hook_t)(F_mpz_mpoly_mul_alg_t alg, 
+												  ulong len1, ulong len2, void * arg);
+
 typedef struct F_mpz_mpoly_heap_s
 {
    ulong packed;
@@ -252,6 +274,63 @@ ulong F_mpz_mpoly_get_var_exp_packed_grlex(F_mpz_mpoly_t poly, const ulong n, co
 */
 ulong F_mpz_mpoly_get_var_exp(F_mpz_mpoly_t poly, const ulong n, const ulong var);
 
+/*===============================================================================
+
+	Packing
+
+================================================================================*/
+
+/** 
+   \fn     void _F_mpz_mpoly_repack(ulong * res, const ulong * packed, 
+	         const ulong length, const ulong vars, const int bits_in, const int bits_out)
+   \brief  Set res to the length packed GRLEX monomials in vars variables
+	        given by packed, which has fields of bits_in bits, but with fields
+			  of bits_out bits. The total degree and all exponents must fit 
+			  in bits_out bits. Aliasing is allowed if bits_out >= bits_in.
+*/
+void _F_mpz_mpoly_repack(ulong * res, const ulong * packed, const ulong length, 
+							 const ulong vars, const int bits_in, const int bits_out);
+
+/** 
+   \fn     void F_mpz_mpoly_repack(F_mpz_mpoly_t poly, const int bits)
+   \brief  Change the packed exponent fields of the small GRLEX polynomial 
+	        poly to be bits bits wide. Every field must fit in the new width.
+			  If the fields would no longer fit in a limb, poly is unpacked 
+			  instead, see F_mpz_mpoly_unpack.
+*/
+void F_mpz_mpoly_repack(F_mpz_mpoly_t poly, const int bits);
+
+/** 
+   \fn     void F_mpz_mpoly_unpack(F_mpz_mpoly_t poly)
+   \brief  Convert the small GRLEX polynomial poly to a large one, i.e. move 
+	        its exponents from the packed monomials to the packed vectors 
+			  exps, one per variable. Does nothing if poly is not small.
+*/
+void F_mpz_mpoly_unpack(F_mpz_mpoly_t poly);
+
+/** 
+   \fn     ulong F_mpz_mpoly_degree_packed_grlex(F_mpz_mpoly_t poly)
+   \brief  Return the total degree of the small GRLEX polynomial poly, i.e.
+	        the total degree of its last monomial, or 0 if poly is zero.
+*/
+static inline
+ulong F_mpz_mpoly_degree_packed_grlex(F_mpz_mpoly_t poly)
+{
+	if (poly->length == 0) return 0L;
+	return poly->packed[poly->length - 1] >> (FLINT_BITS - poly->packed_bits);
+}
+
+/** 
+   \fn     int F_mpz_mpoly_mul_packed_bits(F_mpz_mpoly_t poly1, F_mpz_mpoly_t poly2)
+   \brief  Return the field width, in bits, in which the packed GRLEX monomials 
+	        of poly1*poly2 can be stored without overflow. This is the larger 
+			  of the widths of poly1 and poly2, doubled as many times as needed,
+			  or if that no longer fits in a limb, the smallest width that does.
+			  Returns 0 if the monomials of the product can't be packed into a 
+			  limb.
+*/
+int F_mpz_mpoly_mul_packed_bits(F_mpz_mpoly_t poly1, F_mpz_mpoly_t poly2);
+
 /*===============================================================================
 
 	Print/read
@@ -325,6 +404,166 @@ void F_mpz_mpoly_mul_small_recursive(F_mpz_mpoly_t res,
 void F_mpz_mpoly_mul_small_heap(F_mpz_mpoly_t res, 
 				                    F_mpz_mpoly_t poly1, F_mpz_mpoly_t poly2);
 
+/** 
+   \fn     void _F_mpz_mpoly_mul_heap(F_mpz_mpoly_t res, const F_mpz * coeffs1, 
+	           const ulong * packed1, const ulong len1, const F_mpz * coeffs2, 
+				  const ulong * packed2, const ulong len2)
+
+   \brief  Set res to the product of the polynomials with the given coefficients
+	        and packed monomials, using a Monagan-Pearce heap with one entry 
+			  per term of the first polynomial, which should be the shorter. 
+			  The monomials must already be packed with fields wide enough for 
+			  the product. Only the coefficients, monomials and length of res 
+			  are set. Sums of products of small coefficients are accumulated in
+			  three limbs, and only products of large coefficients use F_mpz 
+			  arithmetic. Assumes len1 and len2 are nonzero and res is not one 
+			  of the inputs.
+*/
+void _F_mpz_mpoly_mul_heap(F_mpz_mpoly_t res, const F_mpz * coeffs1, const ulong * packed1, 
+		const ulong len1, const F_mpz * coeffs2, const ulong * packed2, const ulong len2);
+
+/** 
+   \fn     void F_mpz_mpoly_mul_heap(F_mpz_mpoly_t res, 
+				                    F_mpz_mpoly_t poly1, F_mpz_mpoly_t poly2)
+
+   \brief  Multiply poly1 by poly2, which must be GRLEX polynomials but may 
+	        have arbitrary coefficients. If the exponents of the product 
+			  would overflow the packed fields, the product is computed with
+			  wider fields, as given by F_mpz_mpoly_mul_packed_bits, which res
+			  is left with. If the monomials of the product can't be packed 
+			  into a limb, or an input is not small, the heap algorithm is run 
+			  on unpacked monomials instead and res is a large polynomial. 
+			  Aborts only if an exponent of the product doesn't fit in a limb.
+*/
+void F_mpz_mpoly_mul_heap(F_mpz_mpoly_t res, F_mpz_mpoly_t poly1, F_mpz_mpoly_t poly2);
+
+/** 
+   \fn     void _F_mpz_mpoly_mul_heap_threaded(F_mpz_mpoly_t res, 
+	           const F_mpz * coeffs1, const ulong * packed1, const ulong len1, 
+				  const F_mpz * coeffs2, const ulong * packed2, const ulong len2, 
+				  const ulong threads)
+
+   \brief  As for _F_mpz_mpoly_mul_heap, but the monomials of the product are 
+	        split into the given number of ranges, each containing about the 
+			  same number of pairs of terms of the inputs, and the terms in each 
+			  range are computed in parallel with a heap of their own, if FLINT 
+			  is built with OpenMP.
+*/
+void _F_mpz_mpoly_mul_heap_threaded(F_mpz_mpoly_t res, const F_mpz * coeffs1, 
+		const ulong * packed1, const ulong len1, const F_mpz * coeffs2, 
+		const ulong * packed2, const ulong len2, const ulong threads);
+
+/** 
+   \fn     void F_mpz_mpoly_mul_heap_threaded(F_mpz_mpoly_t res, 
+				           F_mpz_mpoly_t poly1, F_mpz_mpoly_t poly2, ulong threads)
+
+   \brief  As for F_mpz_mpoly_mul_heap, but the product is split into the 
+	        given number of ranges of monomials, computed in parallel. 
+			  Products whose monomials can't be packed are not threaded.
+*/
+void F_mpz_mpoly_mul_heap_threaded(F_mpz_mpoly_t res, F_mpz_mpoly_t poly1, 
+											  F_mpz_mpoly_t poly2, ulong threads);
+
+/** 
+   \fn     ulong F_mpz_mpoly_mul_threads(void)
+
+   \brief  The number of threads F_mpz_mpoly_mul_heap uses for large products,
+	        which is 1 unless FLINT is built with OpenMP.
+*/
+ulong F_mpz_mpoly_mul_threads(void);
+
+/** 
+   \fn     int F_mpz_mpoly_mul_kronecker(F_mpz_mpoly_t res, 
+				                    F_mpz_mpoly_t poly1, F_mpz_mpoly_t poly2)
+
+   \brief  Multiply poly1 by poly2, which must be small GRLEX polynomials, by
+	        Kronecker substitution into univariate polynomials, which are
+			  multiplied with F_mpz_poly_mul. The total degree and all but the
+			  last variable are substituted, offset by their smallest values in
+			  each input, so that the terms of the univariate product are 
+			  already in GRLEX order. Returns 0, leaving res unchanged, if the 
+			  univariate product would have 2^(FLINT_BITS - 2) or more 
+			  coefficients or the monomials of the product can't be packed 
+			  into a limb, otherwise returns 1. The fields of res are widened 
+			  as for F_mpz_mpoly_mul_heap.
+*/
+int F_mpz_mpoly_mul_kronecker(F_mpz_mpoly_t res, F_mpz_mpoly_t poly1, F_mpz_mpoly_t poly2);
+
+/** 
+   \fn     void F_mpz_mpoly_mul_set_hook(F_mpz_mpoly_mul_hook_t hook, void * arg)
+
+   \brief  Set a function which F_mpz_mpoly_mul calls with the algorithm it 
+	        has chosen, the lengths of the inputs and arg, for each product. 
+			  A NULL hook turns reporting off, which is the default.
+*/
+void F_mpz_mpoly_mul_set_hook(F_mpz_mpoly_mul_hook_t hook, void * arg);
+
+/** 
+   \fn     void F_mpz_mpoly_mul(F_mpz_mpoly_t res, 
+				                    F_mpz_mpoly_t poly1, F_mpz_mpoly_t poly2)
+
+   \brief  Multiply poly1 by poly2, which must be GRLEX polynomials. If the 
+	        monomials of the product can be packed into a limb and the inputs 
+			  are dense in the box of exponents they span, i.e. the 
+			  product of their lengths is at least 
+			  FLINT_F_MPZ_MPOLY_KRONECKER_RATIO times the sum of their lengths 
+			  after Kronecker substitution, F_mpz_mpoly_mul_kronecker is used, 
+			  otherwise F_mpz_mpoly_mul_heap.
+*/
+void F_mpz_mpoly_mul(F_mpz_mpoly_t res, F_mpz_mpoly_t poly1, F_mpz_mpoly_t poly2);
+
+/*===============================================================================
+
+	Division
+
+================================================================================*/
+
+/** 
+   \fn     int _F_mpz_mpoly_divides_heap(F_mpz_mpoly_t Q, const F_mpz * coeffs1, 
+	           const ulong * packed1, const ulong len1, const F_mpz * coeffs2, 
+				  const ulong * packed2, const ulong len2, const ulong vars, 
+				  const int bits, const int exact)
+
+   \brief  Divide the polynomial A given by the first len1 coefficients and 
+	        packed monomials by the polynomial B given by the second, where 
+			  both are in the given number of variables, packed into fields of 
+			  the given width. If B divides A, Q is set to the quotient and 1 
+			  is returned, otherwise 0 is returned and Q is set to zero. Terms 
+			  of Q are found from the bottom up with a heap of one entry per 
+			  term of Q, and the division fails as soon as a term of Q would 
+			  exceed the degree of A minus that of B in some variable. If 
+			  exact is nonzero, the division is assumed to be exact and the 
+			  terms of Q*B above the largest term of Q times the smallest of 
+			  B are not computed. Only the coefficients, monomials and length 
+			  of Q are set.
+*/
+int _F_mpz_mpoly_divides_heap(F_mpz_mpoly_t Q, const F_mpz * coeffs1, const ulong * packed1, 
+		const ulong len1, const F_mpz * coeffs2, const ulong * packed2, const ulong len2, 
+		const ulong vars, const int bits, const int exact);
+
+/** 
+   \fn     int F_mpz_mpoly_divides_heap(F_mpz_mpoly_t Q, F_mpz_mpoly_t A, 
+				                                                   F_mpz_mpoly_t B)
+
+   \brief  If B divides A, set Q to A/B and return 1, otherwise set Q to zero
+	        and return 0. Both polynomials must be small GRLEX polynomials. 
+			  Returns as soon as a term of A - Q*B is found which can't be 
+			  divided by the smallest term of B, or whose quotient is larger 
+			  than the largest term of A divided by that of B.
+*/
+int F_mpz_mpoly_divides_heap(F_mpz_mpoly_t Q, F_mpz_mpoly_t A, F_mpz_mpoly_t B);
+
+/** 
+   \fn     void F_mpz_mpoly_divexact_heap(F_mpz_mpoly_t Q, F_mpz_mpoly_t A, 
+				                                                   F_mpz_mpoly_t B)
+
+   \brief  Set Q to A/B, assuming that B divides A. This is faster than 
+	        F_mpz_mpoly_divides_heap as the terms of Q*B above the largest
+			  term of A/B times the smallest term of B are not computed. The 
+			  result is undefined if B does not divide A.
+*/
+void F_mpz_mpoly_divexact_heap(F_mpz_mpoly_t Q, F_mpz_mpoly_t A, F_mpz_mpoly_t B);
+
 
 #ifdef __cplusplus
  }
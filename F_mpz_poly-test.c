@@ -1081,6 +1081,90 @@ int test_F_mpz_poly_tofromstring()
    return result; 
 }
 
+#define BIN_TESTFILE "F_mpz_poly-test.bin"
+
+int test_F_mpz_poly_fwrite_bin()
+{
+   F_mpz_poly_t F_poly1, F_poly2, F_poly3;
+   F_mpn_map_t map;
+   int result = 1;
+   ulong bits, length, limbs;
+   
+   ulong count1;
+   for (count1 = 0; (count1 < 2000*ITER) && (result == 1); count1++)
+   {
+      F_mpz_poly_init(F_poly1);
+      F_mpz_poly_init(F_poly2);
+
+      bits = z_randint(200) + 1;
+      length = z_randint(100);
+      F_mpz_randpoly(F_poly1, length, bits);
+      F_mpz_randpoly(F_poly2, z_randint(100), z_randint(200) + 1);
+
+      int swap = z_randint(2);
+      int small = (_F_mpz_vec_size_bin(F_poly1->coeffs, F_poly1->length) == F_poly1->length);
+
+      FILE * file = fopen(BIN_TESTFILE, "w+b");
+      result = F_mpz_poly_fwrite_bin(F_poly1, file);
+      
+      // make a file of the opposite byte order
+      if (result && swap)
+      {
+         limbs = ftell(file)/sizeof(mp_limb_t);
+         mp_limb_t * data = (mp_limb_t *) flint_heap_alloc(limbs);
+         rewind(file);
+         result = F_mpn_fread_bin(data, limbs, file, 1);
+         rewind(file);
+         fwrite(data, sizeof(mp_limb_t), limbs, file);
+         flint_heap_free(data);
+      }
+      
+      fflush(file);
+      rewind(file);
+      if (result) result = F_mpz_poly_fread_bin(F_poly2, file);
+      if (result) result = F_mpz_poly_equal(F_poly1, F_poly2);
+      fclose(file);
+
+      if (result) result = F_mpn_map_init(map, BIN_TESTFILE);
+      if (result)
+      {
+         result = F_mpz_poly_set_map(F_poly2, map);
+         if (result) result = F_mpz_poly_equal(F_poly1, F_poly2);
+
+         // zero copy is only possible for small coefficients and native order
+         if (result) result = (F_mpz_poly_attach_map(F_poly3, map) == (small && !swap));
+         if (result && small && !swap) result = F_mpz_poly_equal(F_poly1, F_poly3);
+         
+         F_mpn_map_clear(map);
+      }
+
+      if (!result) printf("Error: length = %ld, bits = %ld, swap = %d\n", length, bits, swap);
+
+      F_mpz_poly_clear(F_poly1);
+      F_mpz_poly_clear(F_poly2);
+   }
+   
+   // a file with a different type of object or truncated payload is rejected
+   F_mpz_poly_init(F_poly1);
+   F_mpz_randpoly(F_poly1, 10, 100);
+   FILE * file = fopen(BIN_TESTFILE, "w+b");
+   F_mpz_poly_fwrite_bin(F_poly1, file);
+   fflush(file);
+   F_mpn_map_init(map, BIN_TESTFILE);
+   map->limbs--;
+   if (result) result = !F_mpz_poly_set_map(F_poly1, map);
+   map->limbs++;
+   map->data[2] = FLINT_BIN_F_MPZ_MAT;
+   if (result) result = !F_mpz_poly_set_map(F_poly1, map);
+   F_mpn_map_clear(map);
+   fclose(file);
+   F_mpz_poly_clear(F_poly1);
+
+   remove(BIN_TESTFILE);
+
+   return result; 
+}
+
 int test_F_mpz_poly_neg()
 {
    F_mpz_poly_t F_poly1, F_poly2, F_poly3, F_poly4;
@@ -2629,6 +2713,44 @@ int test_F_mpz_poly_mul()
 		F_mpz_poly_clear(res);
    }
    
+   // test short operands of different lengths with large coefficients, which
+   // use karatsuba, into an output which holds longer stale values
+	for (count1 = 0; (count1 < 500*ITER) && (result == 1) ; count1++)
+   {
+      F_mpz_poly_init(F_poly1);
+      F_mpz_poly_init(F_poly2);
+      F_mpz_poly_init(res);
+
+		bits1 = z_randint(200) + 300;
+      bits2 = z_randint(200) + 300;
+      length1 = z_randint(14) + 2;
+      do length2 = z_randint(14) + 2; while (length2 == length1);
+      mpz_randpoly(m_poly1, length1, bits1);
+      mpz_randpoly(m_poly2, length2, bits2);
+           
+      mpz_poly_to_F_mpz_poly(F_poly1, m_poly1);
+      mpz_poly_to_F_mpz_poly(F_poly2, m_poly2);
+      
+      mpz_randpoly(res1, length1 + length2 + z_randint(10), 100);
+      mpz_poly_to_F_mpz_poly(res, res1);
+
+		F_mpz_poly_mul(res, F_poly1, F_poly2);
+		F_mpz_poly_to_mpz_poly(res2, res);
+      mpz_poly_mul(res1, m_poly1, m_poly2);		
+		    
+      result = mpz_poly_equal(res1, res2); 
+		if (!result) 
+		{
+			printf("Error: length1 = %ld, bits1 = %ld, length2 = %ld, bits2 = %ld\n", length1, bits1, length2, bits2);
+         mpz_poly_print_pretty(res1, "x"); printf("\n");
+         mpz_poly_print_pretty(res2, "x"); printf("\n");
+		}
+          
+      F_mpz_poly_clear(F_poly1);
+      F_mpz_poly_clear(F_poly2);
+		F_mpz_poly_clear(res);
+   }
+   
 	mpz_poly_clear(res1);
    mpz_poly_clear(res2);
    mpz_poly_clear(m_poly1);
@@ -6011,6 +6133,311 @@ int test_F_mpz_poly_is_squarefree()
    return result;
 }
 
+// set res to coefficients [start, trunc) of poly1*poly2, using the ordinary multiplication
+void F_mpz_poly_mul_range_naive(F_mpz_poly_t res, F_mpz_poly_t poly1, F_mpz_poly_t poly2, 
+                                                                ulong start, ulong trunc)
+{
+   F_mpz_poly_mul(res, poly1, poly2);
+   F_mpz_poly_truncate(res, trunc);
+   
+   ulong i;
+   for (i = 0; (i < start) && (i < res->length); i++)
+      F_mpz_zero(res->coeffs + i);
+   _F_mpz_poly_normalise(res);
+}
+
+int test_F_mpz_poly_mul_precache()
+{
+   mpz_poly_t m_poly;
+   F_mpz_poly_t F_poly1, F_poly2, F_poly3, res1, res2;
+   F_mpz_poly_precache_t pre;
+   int result = 1;
+   ulong bits1, bits2, length1, length2, trunc, trunc2, type, i;
+   long bits_in;
+   int unsign;
+   
+   mpz_poly_init(m_poly); 
+   
+   // full and truncated products, with the algorithm chosen automatically or forced
+   ulong count1;
+   for (count1 = 0; (count1 < 1000*ITER) && (result == 1) ; count1++)
+   {
+      F_mpz_poly_init(F_poly1);
+      F_mpz_poly_init(F_poly2);
+      F_mpz_poly_init(res1);
+      F_mpz_poly_init(res2);
+
+      bits1 = z_randint(300) + 1;
+      bits2 = z_randint(300) + 1;
+      length1 = z_randint(300);
+      length2 = z_randint(300);
+      unsign = z_randint(2);
+      type = z_randint(3);
+      
+      if (unsign) mpz_randpoly_unsigned(m_poly, length2, bits2);
+      else mpz_randpoly(m_poly, length2, bits2);
+      mpz_poly_to_F_mpz_poly(F_poly2, m_poly);
+      
+      bits_in = unsign ? bits1 : -bits1;
+      if (type == 0) F_mpz_poly_mul_precache_init(pre, F_poly2, bits_in, length1);
+      else if (type == 1) _F_mpz_poly_mul_precache_init_KS(pre, F_poly2, bits_in, length1);
+      else _F_mpz_poly_mul_precache_init_SS(pre, F_poly2, bits_in, length1, 0);
+      
+      for (i = 0; (i < 5) && (result == 1); i++)
+      {
+         if (unsign) mpz_randpoly_unsigned(m_poly, z_randint(length1 + 1), z_randint(bits1) + 1);
+         else mpz_randpoly(m_poly, z_randint(length1 + 1), z_randint(bits1) + 1);
+         mpz_poly_to_F_mpz_poly(F_poly1, m_poly);
+         trunc = z_randint(length1 + length2 + 1);
+         
+         F_mpz_poly_mul_precache(res1, F_poly1, pre);
+         F_mpz_poly_mul(res2, F_poly1, F_poly2);
+         result = F_mpz_poly_equal(res1, res2);
+
+         if (result)
+         {
+            F_mpz_poly_mul_trunc_n_precache(res1, F_poly1, pre, trunc);
+            F_mpz_poly_mul_range_naive(res2, F_poly1, F_poly2, 0, trunc);
+            result = F_mpz_poly_equal(res1, res2);
+         }
+
+         if (result)
+         {
+            F_mpz_poly_mul_middle_precache(res1, F_poly1, pre, trunc);
+            F_mpz_poly_truncate(F_poly1, trunc);
+            F_mpz_poly_mul_range_naive(res2, F_poly1, F_poly2, trunc/2, trunc);
+            result = F_mpz_poly_equal(res1, res2);
+         }
+
+         if (!result) 
+		   {
+			   printf("Error: length1 = %ld, bits1 = %ld, length2 = %ld, bits2 = %ld, type = %ld, trunc = %ld\n", 
+                                               length1, bits1, length2, bits2, type, trunc);
+         }
+      }
+          
+      F_mpz_poly_mul_precache_clear(pre);
+
+      F_mpz_poly_clear(F_poly1);
+		F_mpz_poly_clear(F_poly2);
+		F_mpz_poly_clear(res1);
+		F_mpz_poly_clear(res2);
+   }
+   
+   // precaches for truncated and middle products only
+   for (count1 = 0; (count1 < 1000*ITER) && (result == 1) ; count1++)
+   {
+      F_mpz_poly_init(F_poly1);
+      F_mpz_poly_init(F_poly2);
+      F_mpz_poly_init(F_poly3);
+      F_mpz_poly_init(res1);
+      F_mpz_poly_init(res2);
+
+      bits1 = z_randint(300) + 1;
+      bits2 = z_randint(300) + 1;
+      length2 = z_randint(300);
+      trunc = z_randint(400);
+      unsign = z_randint(2);
+      type = z_randint(4);
+      
+      if (unsign) mpz_randpoly_unsigned(m_poly, length2, bits2);
+      else mpz_randpoly(m_poly, length2, bits2);
+      mpz_poly_to_F_mpz_poly(F_poly2, m_poly);
+      
+      bits_in = unsign ? bits1 : -bits1;
+      if (type == 0) F_mpz_poly_mul_trunc_n_precache_init(pre, F_poly2, bits_in, trunc);
+      else if (type == 1) F_mpz_poly_mul_middle_precache_init(pre, F_poly2, bits_in, trunc);
+      else 
+      {
+         F_mpz_poly_set(F_poly3, F_poly2);
+         F_mpz_poly_truncate(F_poly3, trunc);
+         if (type == 2) _F_mpz_poly_mul_precache_init_SS(pre, F_poly3, bits_in, trunc, 0);
+         else _F_mpz_poly_mul_precache_init_SS(pre, F_poly3, bits_in, trunc, trunc/2);
+      }
+      
+      for (i = 0; (i < 5) && (result == 1); i++)
+      {
+         if (unsign) mpz_randpoly_unsigned(m_poly, z_randint(2*trunc + 1), z_randint(bits1) + 1);
+         else mpz_randpoly(m_poly, z_randint(2*trunc + 1), z_randint(bits1) + 1);
+         mpz_poly_to_F_mpz_poly(F_poly1, m_poly);
+         
+         if ((type == 0) || (type == 2)) // any truncation up to trunc
+         {
+            trunc2 = z_randint(trunc + 1);
+            F_mpz_poly_mul_trunc_n_precache(res1, F_poly1, pre, trunc2);
+            F_mpz_poly_truncate(F_poly1, trunc2);
+            F_mpz_poly_mul_range_naive(res2, F_poly1, F_poly2, 0, trunc2);
+            result = F_mpz_poly_equal(res1, res2);
+
+            if (result)
+            {
+               F_mpz_poly_mul_middle_precache(res1, F_poly1, pre, trunc2);
+               F_mpz_poly_mul_range_naive(res2, F_poly1, F_poly2, trunc2/2, trunc2);
+               result = F_mpz_poly_equal(res1, res2);
+            }
+         } else // middle product with the given trunc
+         {
+            trunc2 = trunc;
+            F_mpz_poly_mul_middle_precache(res1, F_poly1, pre, trunc);
+            F_mpz_poly_truncate(F_poly1, trunc);
+            F_mpz_poly_mul_range_naive(res2, F_poly1, F_poly2, trunc/2, trunc);
+            result = F_mpz_poly_equal(res1, res2);
+         }
+
+         if (!result) 
+		   {
+			   printf("Error: bits1 = %ld, length2 = %ld, bits2 = %ld, type = %ld, trunc = %ld, trunc2 = %ld\n", 
+                                               bits1, length2, bits2, type, trunc, trunc2);
+         }
+      }
+          
+      F_mpz_poly_mul_precache_clear(pre);
+
+      F_mpz_poly_clear(F_poly1);
+		F_mpz_poly_clear(F_poly2);
+		F_mpz_poly_clear(F_poly3);
+		F_mpz_poly_clear(res1);
+		F_mpz_poly_clear(res2);
+   }
+   
+   // test aliasing of res and poly1
+   for (count1 = 0; (count1 < 500*ITER) && (result == 1) ; count1++)
+   {
+      F_mpz_poly_init(F_poly1);
+      F_mpz_poly_init(F_poly2);
+      F_mpz_poly_init(res2);
+
+      bits1 = z_randint(300) + 1;
+      bits2 = z_randint(300) + 1;
+      length1 = z_randint(300);
+      length2 = z_randint(300);
+      type = z_randint(3);
+      
+      mpz_randpoly(m_poly, length2, bits2);
+      mpz_poly_to_F_mpz_poly(F_poly2, m_poly);
+      mpz_randpoly(m_poly, length1, bits1);
+      mpz_poly_to_F_mpz_poly(F_poly1, m_poly);
+      
+      if (type == 0) F_mpz_poly_mul_precache_init(pre, F_poly2, -bits1, length1);
+      else if (type == 1) _F_mpz_poly_mul_precache_init_KS(pre, F_poly2, -bits1, length1);
+      else _F_mpz_poly_mul_precache_init_SS(pre, F_poly2, -bits1, length1, 0);
+      
+      F_mpz_poly_mul(res2, F_poly1, F_poly2);
+      F_mpz_poly_mul_precache(F_poly1, F_poly1, pre);
+      result = F_mpz_poly_equal(F_poly1, res2);
+      if (!result) 
+		{
+			printf("Error: length1 = %ld, bits1 = %ld, length2 = %ld, bits2 = %ld, type = %ld\n", 
+                                               length1, bits1, length2, bits2, type);
+      }
+
+      F_mpz_poly_mul_precache_clear(pre);
+
+      F_mpz_poly_clear(F_poly1);
+		F_mpz_poly_clear(F_poly2);
+		F_mpz_poly_clear(res2);
+   }
+   
+   mpz_poly_clear(m_poly);
+   
+   return result; 
+}
+
+int test_F_mpz_poly_mat_mul()
+{
+   mpz_poly_t m_poly;
+   F_mpz_poly_struct A[9], B[9], C[9], D[9];
+   F_mpz_poly_t temp, dot;
+   int result = 1;
+   ulong bits, length, r, s, t, i, j, k;
+   int unsign;
+   
+   mpz_poly_init(m_poly); 
+   
+   ulong count1;
+   for (count1 = 0; (count1 < 2000*ITER) && (result == 1) ; count1++)
+   {
+      for (i = 0; i < 9; i++)
+      {
+         F_mpz_poly_init(A + i);
+         F_mpz_poly_init(B + i);
+         F_mpz_poly_init(C + i);
+         F_mpz_poly_init(D + i);
+      }
+      F_mpz_poly_init(temp);
+      F_mpz_poly_init(dot);
+
+      // large coefficients for the Fourier domain code, small for the fallback
+      bits = z_randint(2) ? z_randint(1000) + 1 : z_randint(100) + 1;
+      length = z_randint(100) + 1;
+      unsign = z_randint(2);
+      r = z_randint(3) + 1;
+      s = z_randint(3) + 1;
+      t = z_randint(3) + 1;
+      if (z_randint(2)) r = s = t = 2;
+
+      for (i = 0; i < r*s; i++)
+      {
+         if (unsign) mpz_randpoly_unsigned(m_poly, z_randint(length), z_randint(bits) + 1);
+         else mpz_randpoly(m_poly, z_randint(length), z_randint(bits) + 1);
+         mpz_poly_to_F_mpz_poly(A + i, m_poly);
+      }
+      for (i = 0; i < s*t; i++)
+      {
+         if (unsign) mpz_randpoly_unsigned(m_poly, z_randint(length), z_randint(bits) + 1);
+         else mpz_randpoly(m_poly, z_randint(length), z_randint(bits) + 1);
+         mpz_poly_to_F_mpz_poly(B + i, m_poly);
+      }
+
+      for (i = 0; i < r; i++)
+         for (j = 0; j < t; j++)
+         {
+            F_mpz_poly_zero(D + i*t + j);
+            for (k = 0; k < s; k++)
+            {
+               F_mpz_poly_mul(temp, A + i*s + k, B + k*t + j);
+               F_mpz_poly_add(D + i*t + j, D + i*t + j, temp);
+            }
+         }
+
+      F_mpz_poly_mat_mul(C, A, B, r, s, t);
+      for (i = 0; i < r*t; i++)
+         result &= F_mpz_poly_equal(C + i, D + i);
+
+      // first row of A times first column of B
+      for (k = 0; k < s; k++) F_mpz_poly_set(C + k, B + k*t);
+      F_mpz_poly_dot(dot, A, C, s);
+      result &= F_mpz_poly_equal(dot, D);
+
+      // aliasing of the output with the first input
+      if (s == t)
+      {
+         F_mpz_poly_mat_mul(A, A, B, r, s, t);
+         for (i = 0; i < r*t; i++)
+            result &= F_mpz_poly_equal(A + i, D + i);
+      }
+
+      if (!result)
+      {
+         printf("Error: bits = %ld, length = %ld, r = %ld, s = %ld, t = %ld\n", bits, length, r, s, t);
+      }
+
+      for (i = 0; i < 9; i++)
+      {
+         F_mpz_poly_clear(A + i);
+         F_mpz_poly_clear(B + i);
+         F_mpz_poly_clear(C + i);
+         F_mpz_poly_clear(D + i);
+      }
+      F_mpz_poly_clear(temp);
+      F_mpz_poly_clear(dot);
+   }
+   
+   mpz_poly_clear(m_poly);
+   
+   return result; 
+}
+
 int test_F_mpz_poly_pow_ui()
 {
    F_mpz_poly_t F_poly1, F_poly2, F_poly;
@@ -6454,6 +6881,7 @@ void F_mpz_poly_test_all()
    RUN_TEST(F_mpz_poly_max_bits);
    RUN_TEST(F_mpz_poly_max_limbs);
    RUN_TEST(F_mpz_poly_tofromstring);
+   RUN_TEST(F_mpz_poly_fwrite_bin);
    RUN_TEST(F_mpz_poly_neg);
    RUN_TEST(F_mpz_poly_reverse); 
    RUN_TEST(F_mpz_poly_add); 
@@ -6479,6 +6907,8 @@ void F_mpz_poly_test_all()
    RUN_TEST(F_mpz_poly_mul_SS); 
    RUN_TEST(F_mpz_poly_mul); 
    RUN_TEST(F_mpz_poly_mul_trunc_left); 
+   RUN_TEST(F_mpz_poly_mul_precache); 
+   RUN_TEST(F_mpz_poly_mat_mul); 
    RUN_TEST(F_mpz_poly_pow_ui); 
    RUN_TEST(F_mpz_poly_pack_bytes); 
    RUN_TEST(F_mpz_poly_divrem_basecase); 
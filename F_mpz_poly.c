@@ -42,6 +42,7 @@
 #include "F_mpz_poly.h"
 #include "fmpz_poly.h"
 #include "mpn_extras.h"
+#include "F_mpn_mul-tuning.h"
 #include "longlong_wrapper.h"
 #include "longlong.h"
 #include "memory-manager.h"
@@ -539,9 +540,11 @@ char* F_mpz_poly_to_string_pretty(const F_mpz_poly_t poly, const char * x)
 
 void F_mpz_poly_fprint(const F_mpz_poly_t poly, FILE* f)
 {
-   char* s = F_mpz_poly_to_string(poly);
-   fputs(s, f);
-   free(s);
+   mpz_poly_t m_poly;
+   mpz_poly_init(m_poly);
+   F_mpz_poly_to_mpz_poly(m_poly, poly);
+   mpz_poly_fprint(m_poly, f);
+   mpz_poly_clear(m_poly);
 }
 
 void F_mpz_poly_fprint_pretty(const F_mpz_poly_t poly, FILE* f, const char * x)
@@ -572,6 +575,83 @@ int F_mpz_poly_fread(F_mpz_poly_t poly, FILE* f)
    return ok;
 }
 
+int F_mpz_poly_fwrite_bin(const F_mpz_poly_t poly, FILE * f)
+{
+   F_mpn_bin_header_t hdr;
+
+   hdr->type = FLINT_BIN_F_MPZ_POLY;
+   hdr->dim1 = poly->length;
+   hdr->dim2 = 0L;
+   hdr->limbs = _F_mpz_vec_size_bin(poly->coeffs, poly->length);
+   hdr->flags = (hdr->limbs == poly->length) ? FLINT_BIN_SMALL : 0L;
+
+   if (!F_mpn_fwrite_bin_header(hdr, f)) return 0;
+
+   return _F_mpz_vec_fwrite_bin(poly->coeffs, poly->length, f);
+}
+
+int F_mpz_poly_fread_bin(F_mpz_poly_t poly, FILE * f)
+{
+   F_mpn_bin_header_t hdr;
+   int ok;
+
+   F_mpz_poly_zero(poly);
+
+   if (!F_mpn_fread_bin_header(hdr, f) || hdr->type != FLINT_BIN_F_MPZ_POLY
+         || !F_mpn_bin_header_check(hdr, hdr->dim1))
+      return 0;
+
+   F_mpz_poly_fit_length(poly, hdr->dim1);
+   ok = _F_mpz_vec_fread_bin(poly->coeffs, hdr->dim1, f, hdr);
+
+   poly->length = hdr->dim1;
+   _F_mpz_poly_normalise(poly);
+
+   return ok;
+}
+
+int F_mpz_poly_set_map(F_mpz_poly_t poly, const F_mpn_map_t map)
+{
+   F_mpn_bin_header_t hdr;
+   int ok;
+
+   F_mpz_poly_zero(poly);
+
+   if (!F_mpn_get_bin_header(hdr, map->data, map->limbs) || hdr->type != FLINT_BIN_F_MPZ_POLY)
+      return 0;
+
+   F_mpz_poly_fit_length(poly, hdr->dim1);
+   ok = _F_mpz_vec_set_bin(poly->coeffs, hdr->dim1, 
+                           map->data + FLINT_BIN_HEADER_LIMBS, hdr->limbs, hdr);
+
+   poly->length = hdr->dim1;
+   _F_mpz_poly_normalise(poly);
+
+   return ok;
+}
+
+int F_mpz_poly_attach_map(F_mpz_poly_t poly, const F_mpn_map_t map)
+{
+   F_mpn_bin_header_t hdr;
+   ulong i;
+
+   if (!F_mpn_get_bin_header(hdr, map->data, map->limbs) || hdr->type != FLINT_BIN_F_MPZ_POLY
+         || hdr->swap || hdr->limbs != hdr->dim1)
+      return 0;
+
+   F_mpz * coeffs = (F_mpz *) (map->data + FLINT_BIN_HEADER_LIMBS);
+
+   // a limb which is not small would be taken as an mpz
+   for (i = 0; i < hdr->dim1; i++)
+      if (!F_mpz_bin_is_small(coeffs[i])) return 0;
+
+   poly->coeffs = coeffs;
+   poly->alloc = hdr->dim1;
+   poly->length = hdr->dim1;
+
+   return 1;
+}
+
 /*===============================================================================
 
 	Assignment/swap
@@ -1791,6 +1871,18 @@ void _F_mpz_poly_mul_karatsuba(F_mpz_poly_t output, const F_mpz_poly_t poly1, co
       
       return;
    }
+
+   // the recursive code expects equal lengths, otherwise it does not write
+   // the top coefficients of the output, which may contain stale values
+   if (poly1->length < poly2->length)
+   {
+      _F_mpz_poly_mul_karatsuba_odd_even(output, (F_mpz_poly_struct *) poly1, (F_mpz_poly_struct *) poly2);
+      return;
+   } else if (poly1->length > poly2->length)
+   {
+      _F_mpz_poly_mul_karatsuba_odd_even(output, (F_mpz_poly_struct *) poly2, (F_mpz_poly_struct *) poly1);
+      return;
+   }
    
 	F_mpz_poly_t scratch;
    F_mpz_poly_init2(scratch, 5*poly1->length);
@@ -2148,131 +2240,182 @@ void F_mpz_poly_mul_karatsuba_trunc_left(F_mpz_poly_t res, F_mpz_poly_t poly1,
 		xxxcoeff &= xxxmask; \
 	} while (0)
 
+/*
+   Coefficients are packed in blocks of this many, which must be a multiple of
+   FLINT_BITS, so that each block of fields fills a whole number of limbs.
+*/
+#define F_MPZ_POLY_PACK_BLOCK 256
+
+/*
+   Packs the given fields into array, writing no more than n of the 
+   limbs (bits*length - 1)/FLINT_BITS + 1 of the result. 
+*/
+static
+void _F_mpz_poly_bit_pack_fields(mp_limb_t * array, ulong n, const ulong * fields,
+                                                  const ulong bits, const ulong length)
+{
+   ulong limbs = (bits*length - 1)/FLINT_BITS + 1;
+
+   if (limbs <= n) F_mpn_bit_pack(array, fields, length, bits, 0);
+   else
+   {
+      mp_limb_t * temp = (mp_limb_t *) flint_stack_alloc(limbs);
+      F_mpn_bit_pack(temp, fields, length, bits, 0);
+      F_mpn_copy(array, temp, n);
+      flint_stack_release();
+   }
+}
+
+/*
+   The fields are computed a block at a time as per NEXT_COEFF and then
+   packed with F_mpn_bit_pack.
+*/
 void F_mpz_poly_bit_pack(mp_limb_t * array, ulong n, const F_mpz_poly_t poly_F_mpz,
                          const ulong bits, const ulong length, const long negate)
 {   
-   ulong i, k, skip;
-   ulong * coeff_m = poly_F_mpz->coeffs;
-   mp_limb_t * end_point;
-    
-   ulong temp;
-   half_ulong lower;
+   ulong fields[F_MPZ_POLY_PACK_BLOCK];
+   ulong i, j, m, skip, limbs, borrow = 0L;
    long coeff;
-   long borrow;
-   mp_limb_t extend;
-   
-   ulong coeffs_per_limb = FLINT_BITS/bits;
-
+   F_mpz * coeffs = poly_F_mpz->coeffs;
    const ulong mask = (1UL<<bits)-1;
-      
-   k = 0; skip = 0;
-   coeff = 0; borrow = 0L; temp = 0;
-      
-   end_point = poly_F_mpz->coeffs + length;
-         
-   while (coeff_m < end_point)
+   const ulong k = (bits*length) % FLINT_BITS;
+
+   if (length == 0L)
    {
-      if ((ulong) coeff_m & 7 == 0) FLINT_PREFETCH(coeff_m, 64);
+      if (n) array[0] = 0L;
+      return;
+   }
 
-      // k is guaranteed to be less than FLINT_BITS at this point
-      while ((k < HALF_FLINT_BITS) && (coeff_m < end_point))
+   limbs = (bits*length - 1)/FLINT_BITS + 1;
+   mp_limb_t * p = (limbs <= n) ? array : (mp_limb_t *) flint_stack_alloc(limbs);
+
+   for (i = 0, skip = 0; i < length; 
+        i += F_MPZ_POLY_PACK_BLOCK, skip += (F_MPZ_POLY_PACK_BLOCK/FLINT_BITS)*bits)
+   {
+      m = FLINT_MIN(F_MPZ_POLY_PACK_BLOCK, length - i);
+      
+      for (j = 0; j < m; j++)
       {
-         NEXT_COEFF(*coeff_m, borrow, coeff, mask, negate);
-		   temp += (coeff << k);
-         coeff_m++; k += bits;
+         coeff = (coeffs[i + j] ^ negate) - negate - borrow;
+         borrow = ((ulong) coeff >> (FLINT_BITS - 1));
+         fields[j] = (coeff & mask);
       }
-         
-	   // k may exceed FLINT_BITS at this point but is less than 3*HALF_FLINT_BITS
-	   if (k > FLINT_BITS)
-      {
-         // if k > FLINT_BITS write out a whole limb and read in remaining bits of coeff
-         array[skip] = temp;
-         skip++;
-         temp = (coeff >> (bits+FLINT_BITS-k));
-         k = (k - FLINT_BITS);
-         // k < HALF_FLINT_BITS
-      } else
-      {
-         // k <= FLINT_BITS
-         if (k >= HALF_FLINT_BITS)
-         {
-            // if k >= HALF_FLINT_BITS store bottom HALF_FLINT_BITS bits
-            lower = (half_ulong) temp;
-            k -= HALF_FLINT_BITS;
-            temp >>= HALF_FLINT_BITS;
-               
-			   // k is now <= HALF_FLINT_BITS
-            while ((k < HALF_FLINT_BITS) && (coeff_m < end_point))
-            {
-               NEXT_COEFF(*coeff_m, borrow, coeff, mask, negate);
-				   //if (sign) 
-				   temp+=(coeff << k);
-               //else temp+=(__get_next_coeff_unsigned(coeff_m, &coeff) << k);
-               coeff_m++; k += bits;
-            }
 
-            // k may again exceed FLINT_BITS bits but is less than 3*HALF_FLINT_BITS
-            if (k > FLINT_BITS)
-            {
-               // if k > FLINT_BITS, write out bottom HALF_FLINT_BITS bits (along with HALF_FLINT_BITS bits from lower)
-               // read remaining bits from coeff and reduce k by HALF_FLINT_BITS
-               array[skip] = (temp << HALF_FLINT_BITS) + (ulong) lower;
-               skip++;
-               temp >>= HALF_FLINT_BITS;
-               temp += ((coeff >> (bits+FLINT_BITS-k)) << HALF_FLINT_BITS);
-               k = (k - HALF_FLINT_BITS);
-               // k < FLINT_BITS and we are ready to read next coefficient if there is one
-            } else if (k >= HALF_FLINT_BITS) 
-            {
-               // k <= FLINT_BITS
-               // if k >= HALF_FLINT_BITS write out bottom HALF_FLINT_BITS bits (along with lower)
-               // and reduce k by HALF_FLINT_BITS
-               k -= HALF_FLINT_BITS;
-               array[skip] = (temp << HALF_FLINT_BITS) + lower;
-               temp >>= HALF_FLINT_BITS;
-               skip++;
-               // k is now less than or equal to HALF_FLINT_BITS and we are now ready to read 
-               // the next coefficient if there is one
-            } else
-            {
-               // k < HALF_FLINT_BITS
-               // there isn't enough to write out a whole FLINT_BITS bits, so put it all 
-               // together in temp
-               temp = (temp << HALF_FLINT_BITS) + lower;
-               k += HALF_FLINT_BITS;
-               // k is now guaranteed to be less than FLINT_BITS and we are ready for the
-               // next coefficient if there is one
-            }
-         } // if
-      } // else
-   } // while
+      F_mpn_bit_pack(p + skip, fields, m, bits, 0);
+   }
 
    // sign extend the last FLINT_BITS bits we write out
-   if (skip < n)
+   if (borrow && k) p[limbs - 1] += (-1UL << k);
+
+   if (p != array)
    {
-      if (borrow) temp += (-1UL << k);
-      array[skip] = temp;
-      skip++;
-   } 
+      F_mpn_copy(array, p, n);
+      flint_stack_release(); // p
+   } else if ((limbs < n) && (k == 0L))
+      array[limbs] = -borrow;
 }
 
 void F_mpz_poly_bit_pack_unsigned(mp_limb_t * array, ulong n, const F_mpz_poly_t poly_F_mpz,
                                                             const ulong bits, const ulong length)
 {   
-   ulong i, k, skip;
+   if (length == 0L)
+   {
+      if (n) array[0] = 0L;
+      return;
+   }
+
+   _F_mpz_poly_bit_pack_fields(array, n, (const ulong *) poly_F_mpz->coeffs, bits, length);
+
+   ulong limbs = (bits*length - 1)/FLINT_BITS + 1;
+   if ((limbs < n) && ((bits*length) % FLINT_BITS == 0L))
+      array[limbs] = 0L;
+}
+
+/*
+   Demotes the given coefficients, which are about to be overwritten. The 
+   top bit of ~c & (c << 1) is set iff c is an mpz_t, which lets the usual 
+   case, where none of them is, be detected without a branch per coefficient.
+*/
+static inline
+void _F_mpz_poly_demote_coeffs(F_mpz * coeffs, const ulong length)
+{
+   ulong i, any = 0L;
+
+   for (i = 0; i < length; i++)
+      any |= (~coeffs[i] & (coeffs[i] << 1));
+
+   if (any >> (FLINT_BITS - 1))
+      for (i = 0; i < length; i++)
+         _F_mpz_demote(coeffs + i);
+}
+
+void F_mpz_poly_bit_unpack(F_mpz_poly_t poly_F_mpz, const mp_limb_t * array,
+                                                    const ulong length, const ulong bits)
+{
+   ulong i, t, s;
+   ulong carry = 0L;
+   F_mpz * coeffs = poly_F_mpz->coeffs;
+
+   _F_mpz_poly_demote_coeffs(coeffs, length);
+   F_mpn_bit_unpack((ulong *) coeffs, array, length, bits, 0);
+
+   // a field with its top bit set is negative and borrowed from the next field
+   for (i = 0; i < length; i++)
+   {
+      t = coeffs[i];
+      s = (t >> (bits - 1));
+      coeffs[i] = (long) (t - (s << bits) + carry);
+      carry = s;
+   }
+
+   if ((carry) && (poly_F_mpz->coeffs[length - 1] == 0))
+	{
+		_F_mpz_demote(coeffs + length);
+		coeffs[length] = 1L;
+      poly_F_mpz->length = length + 1;
+	} else
+	{
+		poly_F_mpz->length = length;
+		_F_mpz_poly_normalise(poly_F_mpz);
+	}
+}
+
+void F_mpz_poly_bit_unpack_unsigned(F_mpz_poly_t poly_F_mpz, const mp_limb_t * array, 
+                                                             const ulong length, const ulong bits)
+{
+   F_mpz * coeffs = poly_F_mpz->coeffs;
+
+   _F_mpz_poly_demote_coeffs(coeffs, length);
+   F_mpn_bit_unpack((ulong *) coeffs, array, length, bits, 0);
+
+   poly_F_mpz->length = length;
+	_F_mpz_poly_normalise(poly_F_mpz);
+}
+ 
+/*
+  Bit packing used with David Harvey's KS2 algorithm
+
+*/
+void F_mpz_poly_bit_pack2(mp_limb_t * array, mp_limb_t * array2, ulong n, const F_mpz_poly_t poly_F_mpz, 
+                              const ulong bits, const ulong length, const long negate, long negate2)
+
+{   
+   ulong k, skip;
    ulong * coeff_m = poly_F_mpz->coeffs;
-   mp_limb_t * end_point;
-    
-   ulong temp;
-   half_ulong lower;
-   long coeff;
+   
+   ulong temp, temp2;
+   half_ulong lower, lower2;
+   long coeff, coeff2;
+   long borrow, borrow2;
    
    ulong coeffs_per_limb = FLINT_BITS/bits;
 
-   k = 0; skip = 0;
-   coeff = 0; temp = 0;
+   const ulong mask = (1UL<<bits) - 1;
       
-   end_point = poly_F_mpz->coeffs + length;
+	k = 0; skip = 0;
+   coeff = 0; coeff2 = 0; borrow = 0L; borrow2 = 0L, temp = 0, temp2 = 0;
+		
+   mp_limb_t * end_point = poly_F_mpz->coeffs + length;
          
    while (coeff_m < end_point)
    {
@@ -2281,8 +2424,11 @@ void F_mpz_poly_bit_pack_unsigned(mp_limb_t * array, ulong n, const F_mpz_poly_t
       // k is guaranteed to be less than FLINT_BITS at this point
       while ((k < HALF_FLINT_BITS) && (coeff_m < end_point))
       {
-         coeff = *coeff_m;
+         NEXT_COEFF(*coeff_m, borrow, coeff, mask, negate);
+		   NEXT_COEFF(*coeff_m, borrow2, coeff2, mask, negate2);
+	      negate2 = -negate2 - 1L;
 		   temp += (coeff << k);
+         temp2 += (coeff2 << k);
          coeff_m++; k += bits;
       }
          
@@ -2291,8 +2437,10 @@ void F_mpz_poly_bit_pack_unsigned(mp_limb_t * array, ulong n, const F_mpz_poly_t
       {
          // if k > FLINT_BITS write out a whole limb and read in remaining bits of coeff
          array[skip] = temp;
+         array2[skip] = temp2;
          skip++;
          temp = (coeff >> (bits+FLINT_BITS-k));
+         temp2 = (coeff2 >> (bits+FLINT_BITS-k));
          k = (k - FLINT_BITS);
          // k < HALF_FLINT_BITS
       } else
@@ -2302,14 +2450,19 @@ void F_mpz_poly_bit_pack_unsigned(mp_limb_t * array, ulong n, const F_mpz_poly_t
          {
             // if k >= HALF_FLINT_BITS store bottom HALF_FLINT_BITS bits
             lower = (half_ulong) temp;
+            lower2 = (half_ulong) temp2;
             k -= HALF_FLINT_BITS;
             temp >>= HALF_FLINT_BITS;
+            temp2 >>= HALF_FLINT_BITS;
                
-			   // k is now <= HALF_FLINT_BITS
+		      // k is now <= HALF_FLINT_BITS
             while ((k < HALF_FLINT_BITS) && (coeff_m < end_point))
             {
-               coeff = *coeff_m;
-				   temp += (coeff << k);
+               NEXT_COEFF(*coeff_m, borrow, coeff, mask, negate);
+				   NEXT_COEFF(*coeff_m, borrow2, coeff2, mask, negate2);
+				   negate2 = -negate2 - 1L;
+				   temp+=(coeff << k);
+               temp2+=(coeff2 << k);
                coeff_m++; k += bits;
             }
 
@@ -2319,9 +2472,12 @@ void F_mpz_poly_bit_pack_unsigned(mp_limb_t * array, ulong n, const F_mpz_poly_t
                // if k > FLINT_BITS, write out bottom HALF_FLINT_BITS bits (along with HALF_FLINT_BITS bits from lower)
                // read remaining bits from coeff and reduce k by HALF_FLINT_BITS
                array[skip] = (temp << HALF_FLINT_BITS) + (ulong) lower;
+               array2[skip] = (temp2 << HALF_FLINT_BITS) + (ulong) lower2;
                skip++;
                temp >>= HALF_FLINT_BITS;
+               temp2 >>= HALF_FLINT_BITS;
                temp += ((coeff >> (bits+FLINT_BITS-k)) << HALF_FLINT_BITS);
+               temp2 += ((coeff2 >> (bits+FLINT_BITS-k)) << HALF_FLINT_BITS);
                k = (k - HALF_FLINT_BITS);
                // k < FLINT_BITS and we are ready to read next coefficient if there is one
             } else if (k >= HALF_FLINT_BITS) 
@@ -2331,7 +2487,9 @@ void F_mpz_poly_bit_pack_unsigned(mp_limb_t * array, ulong n, const F_mpz_poly_t
                // and reduce k by HALF_FLINT_BITS
                k -= HALF_FLINT_BITS;
                array[skip] = (temp << HALF_FLINT_BITS) + lower;
+               array2[skip] = (temp2 << HALF_FLINT_BITS) + lower2;
                temp >>= HALF_FLINT_BITS;
+               temp2 >>= HALF_FLINT_BITS;
                skip++;
                // k is now less than or equal to HALF_FLINT_BITS and we are now ready to read 
                // the next coefficient if there is one
@@ -2341,6 +2499,7 @@ void F_mpz_poly_bit_pack_unsigned(mp_limb_t * array, ulong n, const F_mpz_poly_t
                // there isn't enough to write out a whole FLINT_BITS bits, so put it all 
                // together in temp
                temp = (temp << HALF_FLINT_BITS) + lower;
+               temp2 = (temp2 << HALF_FLINT_BITS) + lower2;
                k += HALF_FLINT_BITS;
                // k is now guaranteed to be less than FLINT_BITS and we are ready for the
                // next coefficient if there is one
@@ -2353,287 +2512,20 @@ void F_mpz_poly_bit_pack_unsigned(mp_limb_t * array, ulong n, const F_mpz_poly_t
    if (skip < n)
    {
       array[skip] = temp;
+      array2[skip] = temp2;
       skip++;
    } 
 }
 
-void F_mpz_poly_bit_unpack(F_mpz_poly_t poly_F_mpz, const mp_limb_t * array,
-                                                    const ulong length, const ulong bits)
+void F_mpz_poly_bit_unpack2(F_mpz_poly_t poly_F_mpz,
+									 const mp_limb_t * array, const mp_limb_t * array2,
+                             const ulong length, const ulong bits)
 {
-   ulong k, skip;
+   ulong k, skip, s;
 
-   ulong temp;
-   ulong full_limb;
-   ulong carry;
-     
-   const ulong mask = (1UL << bits) - 1;
-   const ulong sign_mask = (1UL << (bits-1));
-
-   ulong s;
-   mp_limb_t * coeff_m = poly_F_mpz->coeffs;
-   mp_limb_t * end_point;
-
-   k = 0; skip = 0; carry = 0UL; temp = 0L;
-   end_point = poly_F_mpz->coeffs + length;
-      
-   while (coeff_m < end_point)
-   {
-      // read in a full limb
-      full_limb = array[skip];
-      temp += l_shift(full_limb, k);
-      s = FLINT_BITS - k;
-      k += s;
-      while ((k >= bits) && (coeff_m < end_point))
-      {
-         if (!(temp & sign_mask)) 
-         {
-            _F_mpz_demote(coeff_m);
-				*coeff_m = ((temp & mask) + carry);
-            carry = 0UL;
-         }  
-         else
-         {
-            _F_mpz_demote(coeff_m);
-				*coeff_m = -(((-temp) & mask) - carry);
-            carry = 1UL;
-         }
-         coeff_m ++;
-         temp >>= bits;
-         k -= bits;
-      }
-
-      // k is now less than bits
-      // read in remainder of full_limb
-      temp += l_shift(r_shift(full_limb, s), k);
-      k += (FLINT_BITS - s);
-       
-      while ((k >= bits) && (coeff_m < end_point))
-      {
-         if (!(temp & sign_mask)) 
-         {
-            _F_mpz_demote(coeff_m);
-				*coeff_m = ((temp & mask) + carry);
-            carry = 0UL;
-         }
-         else
-         {
-            _F_mpz_demote(coeff_m);
-				*coeff_m = -(((-temp) & mask) - carry);
-			   carry = 1UL;
-         }
-            
-		   coeff_m ++;
-         temp >>= bits;
-         k -= bits;
-      }
-
-      // k is now less than bits
-      skip++;
-   }
-
-   if ((carry) && (poly_F_mpz->coeffs[length - 1] == 0))
-	{
-		_F_mpz_demote(coeff_m);
-		*coeff_m = 1L;
-      poly_F_mpz->length = length + 1;
-	} else
-	{
-		poly_F_mpz->length = length;
-		_F_mpz_poly_normalise(poly_F_mpz);
-	}
-}
-
-void F_mpz_poly_bit_unpack_unsigned(F_mpz_poly_t poly_F_mpz, const mp_limb_t * array, 
-                                                             const ulong length, const ulong bits)
-{
-   ulong k, l, skip;
-
-   ulong temp;
-   ulong full_limb;
-    
-   const ulong mask = (1UL<<bits)-1;
-
-   ulong s;
-   ulong * coeff_m = poly_F_mpz->coeffs;
-   ulong * end_point;
-       
-   k = 0; skip = 0; temp = 0;
-   end_point = poly_F_mpz->coeffs + length;
-      
-   while (coeff_m < end_point)
-   {
-      if (skip & 7 == 0) FLINT_PREFETCH(array + skip, 64);
-      // read in a full limb
-      full_limb = array[skip];
-      temp += l_shift(full_limb, k);
-      s = FLINT_BITS - k;
-      k += s;
-         
-	   while ((k >= bits) && (coeff_m < end_point))
-      {
-         _F_mpz_demote(coeff_m);
-			*coeff_m = (temp & mask);
-         coeff_m++;
-         temp >>= bits;
-         k -= bits;
-      }
-
-      // k is now less than bits
-      // read in remainder of full_limb
-      temp += l_shift(r_shift(full_limb, s), k);
-      k += (FLINT_BITS - s);
-       
-      while ((k >= bits) && (coeff_m < end_point))
-      {
-         _F_mpz_demote(coeff_m);
-			*coeff_m = (temp & mask);
-         coeff_m++;
-         temp >>= bits;
-         l++;
-         k -= bits;
-      }
-      // k is now less than bits
-      skip++;
-   }
-
-   poly_F_mpz->length = length;
-	_F_mpz_poly_normalise(poly_F_mpz);
-}
- 
-/*
-  Bit packing used with David Harvey's KS2 algorithm
-
-*/
-void F_mpz_poly_bit_pack2(mp_limb_t * array, mp_limb_t * array2, ulong n, const F_mpz_poly_t poly_F_mpz, 
-                              const ulong bits, const ulong length, const long negate, long negate2)
-
-{   
-   ulong k, skip;
-   ulong * coeff_m = poly_F_mpz->coeffs;
-   
-   ulong temp, temp2;
-   half_ulong lower, lower2;
-   long coeff, coeff2;
-   long borrow, borrow2;
-   
-   ulong coeffs_per_limb = FLINT_BITS/bits;
-
-   const ulong mask = (1UL<<bits) - 1;
-      
-	k = 0; skip = 0;
-   coeff = 0; coeff2 = 0; borrow = 0L; borrow2 = 0L, temp = 0, temp2 = 0;
-		
-   mp_limb_t * end_point = poly_F_mpz->coeffs + length;
-         
-   while (coeff_m < end_point)
-   {
-      if ((ulong) coeff_m & 7 == 0) FLINT_PREFETCH(coeff_m, 64);
-
-      // k is guaranteed to be less than FLINT_BITS at this point
-      while ((k < HALF_FLINT_BITS) && (coeff_m < end_point))
-      {
-         NEXT_COEFF(*coeff_m, borrow, coeff, mask, negate);
-		   NEXT_COEFF(*coeff_m, borrow2, coeff2, mask, negate2);
-	      negate2 = -negate2 - 1L;
-		   temp += (coeff << k);
-         temp2 += (coeff2 << k);
-         coeff_m++; k += bits;
-      }
-         
-	   // k may exceed FLINT_BITS at this point but is less than 3*HALF_FLINT_BITS
-	   if (k > FLINT_BITS)
-      {
-         // if k > FLINT_BITS write out a whole limb and read in remaining bits of coeff
-         array[skip] = temp;
-         array2[skip] = temp2;
-         skip++;
-         temp = (coeff >> (bits+FLINT_BITS-k));
-         temp2 = (coeff2 >> (bits+FLINT_BITS-k));
-         k = (k - FLINT_BITS);
-         // k < HALF_FLINT_BITS
-      } else
-      {
-         // k <= FLINT_BITS
-         if (k >= HALF_FLINT_BITS)
-         {
-            // if k >= HALF_FLINT_BITS store bottom HALF_FLINT_BITS bits
-            lower = (half_ulong) temp;
-            lower2 = (half_ulong) temp2;
-            k -= HALF_FLINT_BITS;
-            temp >>= HALF_FLINT_BITS;
-            temp2 >>= HALF_FLINT_BITS;
-               
-		      // k is now <= HALF_FLINT_BITS
-            while ((k < HALF_FLINT_BITS) && (coeff_m < end_point))
-            {
-               NEXT_COEFF(*coeff_m, borrow, coeff, mask, negate);
-				   NEXT_COEFF(*coeff_m, borrow2, coeff2, mask, negate2);
-				   negate2 = -negate2 - 1L;
-				   temp+=(coeff << k);
-               temp2+=(coeff2 << k);
-               coeff_m++; k += bits;
-            }
-
-            // k may again exceed FLINT_BITS bits but is less than 3*HALF_FLINT_BITS
-            if (k > FLINT_BITS)
-            {
-               // if k > FLINT_BITS, write out bottom HALF_FLINT_BITS bits (along with HALF_FLINT_BITS bits from lower)
-               // read remaining bits from coeff and reduce k by HALF_FLINT_BITS
-               array[skip] = (temp << HALF_FLINT_BITS) + (ulong) lower;
-               array2[skip] = (temp2 << HALF_FLINT_BITS) + (ulong) lower2;
-               skip++;
-               temp >>= HALF_FLINT_BITS;
-               temp2 >>= HALF_FLINT_BITS;
-               temp += ((coeff >> (bits+FLINT_BITS-k)) << HALF_FLINT_BITS);
-               temp2 += ((coeff2 >> (bits+FLINT_BITS-k)) << HALF_FLINT_BITS);
-               k = (k - HALF_FLINT_BITS);
-               // k < FLINT_BITS and we are ready to read next coefficient if there is one
-            } else if (k >= HALF_FLINT_BITS) 
-            {
-               // k <= FLINT_BITS
-               // if k >= HALF_FLINT_BITS write out bottom HALF_FLINT_BITS bits (along with lower)
-               // and reduce k by HALF_FLINT_BITS
-               k -= HALF_FLINT_BITS;
-               array[skip] = (temp << HALF_FLINT_BITS) + lower;
-               array2[skip] = (temp2 << HALF_FLINT_BITS) + lower2;
-               temp >>= HALF_FLINT_BITS;
-               temp2 >>= HALF_FLINT_BITS;
-               skip++;
-               // k is now less than or equal to HALF_FLINT_BITS and we are now ready to read 
-               // the next coefficient if there is one
-            } else
-            {
-               // k < HALF_FLINT_BITS
-               // there isn't enough to write out a whole FLINT_BITS bits, so put it all 
-               // together in temp
-               temp = (temp << HALF_FLINT_BITS) + lower;
-               temp2 = (temp2 << HALF_FLINT_BITS) + lower2;
-               k += HALF_FLINT_BITS;
-               // k is now guaranteed to be less than FLINT_BITS and we are ready for the
-               // next coefficient if there is one
-            }
-         } // if
-      } // else
-   } // while
-
-   // sign extend the last FLINT_BITS bits we write out
-   if (skip < n)
-   {
-      array[skip] = temp;
-      array2[skip] = temp2;
-      skip++;
-   } 
-}
-
-void F_mpz_poly_bit_unpack2(F_mpz_poly_t poly_F_mpz,
-									 const mp_limb_t * array, const mp_limb_t * array2,
-                             const ulong length, const ulong bits)
-{
-   ulong k, skip, s;
-
-   ulong temp, temp2;
-   ulong full_limb, full_limb2;
-   ulong carry, carry2;
+   ulong temp, temp2;
+   ulong full_limb, full_limb2;
+   ulong carry, carry2;
      
    const ulong mask = (1UL << bits) - 1;
    const ulong sign_mask = (1UL << (bits-1));
@@ -4277,8 +4169,8 @@ void _F_mpz_poly_mul_SS(F_mpz_poly_t output, const F_mpz_poly_t input1, const F_
    ulong output_bits;
 	ulong log_length2 = 0;
    
-	ulong log_length = 0; // length of largest polynomial
-   while ((1<<log_length) < length1) log_length++;
+	ulong log_length = 0; // transforms are of length 2^(log_length + 1)
+   while ((2L<<log_length) < length1 + length2 - 1) log_length++;
       
 	if (!bits_in)
 	{
@@ -4358,201 +4250,851 @@ void _F_mpz_poly_mul_SS(F_mpz_poly_t output, const F_mpz_poly_t input1, const F_
    ZmodF_poly_stack_clear(poly1);
 }
 
-void F_mpz_poly_mul_SS(F_mpz_poly_t res, const F_mpz_poly_t poly1, const F_mpz_poly_t poly2)
+void F_mpz_poly_mul_SS(F_mpz_poly_t res, const F_mpz_poly_t poly1, const F_mpz_poly_t poly2)
+{
+	if ((poly1->length == 0) || (poly2->length == 0)) // special case if either poly is zero
+   {
+      F_mpz_poly_zero(res);
+      return;
+   }
+
+	if ((poly1 == res) || (poly2 == res)) // aliased inputs
+	{
+		F_mpz_poly_t output; // create temporary
+		F_mpz_poly_init2(output, poly1->length + poly2->length - 1);
+		if (poly1->length >= poly2->length) _F_mpz_poly_mul_SS(output, poly1, poly2, 0);
+		else _F_mpz_poly_mul_SS(output, poly2, poly1, 0);
+		F_mpz_poly_swap(output, res); // swap temporary with real output
+		F_mpz_poly_clear(output);
+	} else // ordinary case
+	{
+		if (poly1->length >= poly2->length) _F_mpz_poly_mul_SS(res, poly1, poly2, 0);
+		else _F_mpz_poly_mul_SS(res, poly2, poly1, 0);
+	}		
+}
+
+/*===============================================================================
+
+	Multiplication
+
+================================================================================*/
+
+void _F_mpz_poly_mul(F_mpz_poly_t output, const F_mpz_poly_t input1, const F_mpz_poly_t input2)
+{
+   if ((input1->length == 0) || (input2->length == 0)) // special case, length == 0
+   {
+      F_mpz_poly_zero(output);
+      return;
+   }
+
+   if ((input1->length <= 2) && (input2->length <= 2)) // karatsuba seems to be unconditionally faster
+   {
+      _F_mpz_poly_mul_karatsuba(output, input1, input2);
+      return;
+   }
+   
+	if (input1->length + input2->length <= 128) // we don't want to check max limbs or max bits more than once
+	{
+	   ulong limbs1 = F_mpz_poly_max_limbs(input1);
+      ulong limbs2 = F_mpz_poly_max_limbs(input2);
+
+      if (limbs1 + limbs2 <= 512/FLINT_BITS)
+      {
+         _F_mpz_poly_mul_KS(output, input1, input2, 0);
+         return;
+      }
+   
+      if (input1->length + input2->length <= 32) 
+      {
+         _F_mpz_poly_mul_karatsuba(output, input1, input2);
+         return;
+      }
+	}
+   
+   long bits2 = F_mpz_poly_max_bits(input2);
+   long bits1 = (input1 == input2) ? bits2 : F_mpz_poly_max_bits(input1);
+   
+   ulong sign = ((bits1 < 0) || (bits2 < 0)); // an extra bit if any coefficients are signed
+   ulong length = input2->length; // length of shortest poly
+   ulong log_length = 0L;
+   while ((1<<log_length) < length) log_length++;
+   ulong bits = FLINT_ABS(bits1) + FLINT_ABS(bits2) + log_length + sign; // total number of output bits
+   if (sign) bits = -bits; // coefficients are signed
+
+   bits1 = FLINT_ABS(bits1);
+   bits2 = FLINT_ABS(bits2);
+
+	if (bits1 + bits2 <= 470)
+   {
+      _F_mpz_poly_mul_KS(output, input1, input2, bits);
+      return;
+   }
+   
+   if (3*(bits1 + bits2) >= input1->length + input2->length) // the "diagonal"
+   {
+      _F_mpz_poly_mul_SS(output, input1, input2, bits);
+      return;
+   } 
+   
+   _F_mpz_poly_mul_KS(output, input1, input2, bits);     
+}
+
+void F_mpz_poly_mul(F_mpz_poly_t res, const F_mpz_poly_t poly1, const F_mpz_poly_t poly2)
+{
+	if ((poly1->length == 0) || (poly2->length == 0)) // special case if either poly is zero
+   {
+      F_mpz_poly_zero(res);
+      return;
+   }
+
+	if ((poly1 == res) || (poly2 == res)) // aliased inputs
+	{
+		F_mpz_poly_t output; // create temporary
+		F_mpz_poly_init2(output, poly1->length + poly2->length - 1);
+		if (poly1->length >= poly2->length) _F_mpz_poly_mul(output, poly1, poly2);
+		else _F_mpz_poly_mul(output, poly2, poly1);
+		F_mpz_poly_swap(output, res); // swap temporary with real output
+		F_mpz_poly_clear(output);
+	} else // ordinary case
+	{
+		F_mpz_poly_fit_length(res, poly1->length + poly2->length - 1);
+      if (poly1->length >= poly2->length) _F_mpz_poly_mul(res, poly1, poly2);
+		else _F_mpz_poly_mul(res, poly2, poly1);
+	}		
+}
+
+void _F_mpz_poly_mul_trunc_left(F_mpz_poly_t output, const F_mpz_poly_t input1, const F_mpz_poly_t input2, ulong trunc)
+{
+   if ((input1->length == 0) || (input2->length == 0) || (input1->length + input2->length <= trunc + 1)) // special case, length == 0
+   {
+      F_mpz_poly_zero(output);
+      return;
+   }
+
+   if ((input1->length <= 2) && (input2->length <= 2)) // karatsuba seems to be unconditionally faster
+   {
+      _F_mpz_poly_mul_karatsuba_trunc_left(output, input1, input2, trunc);
+      return;
+   }
+   
+	if (input1->length + input2->length <= 128) // we don't want to check max limbs or max bits more than once
+	{
+	   ulong limbs1 = F_mpz_poly_max_limbs(input1);
+      ulong limbs2 = F_mpz_poly_max_limbs(input2);
+
+      if (limbs1 + limbs2 <= 512/FLINT_BITS)
+      {
+         _F_mpz_poly_mul_KS(output, input1, input2, 0);
+         return;
+      }
+   
+      if (input1->length + input2->length <= 32) 
+      {
+         _F_mpz_poly_mul_karatsuba_trunc_left(output, input1, input2, trunc);
+         return;
+      }
+	}
+   
+   long bits2 = F_mpz_poly_max_bits(input2);
+   long bits1 = (input1 == input2) ? bits2 : F_mpz_poly_max_bits(input1);
+   
+   ulong sign = ((bits1 < 0) || (bits2 < 0)); // an extra bit if any coefficients are signed
+   ulong length = input2->length; // length of shortest poly
+   ulong log_length = 0L;
+   while ((1<<log_length) < length) log_length++;
+   ulong bits = FLINT_ABS(bits1) + FLINT_ABS(bits2) + log_length + sign; // total number of output bits
+   if (sign) bits = -bits; // coefficients are signed
+
+   bits1 = FLINT_ABS(bits1);
+   bits2 = FLINT_ABS(bits2);
+
+	if (bits1 + bits2 <= 470)
+   {
+      _F_mpz_poly_mul_KS(output, input1, input2, bits);
+      return;
+   }
+   
+   if (3*(bits1 + bits2) >= input1->length + input2->length) // the "diagonal"
+   {
+      _F_mpz_poly_mul_SS(output, input1, input2, bits);
+      return;
+   } 
+   
+   _F_mpz_poly_mul_KS(output, input1, input2, bits);     
+}
+
+void F_mpz_poly_mul_trunc_left(F_mpz_poly_t res, const F_mpz_poly_t poly1, const F_mpz_poly_t poly2, ulong trunc)
+{
+   if ((poly1->length == 0) || (poly2->length == 0) || (poly1->length + poly2->length <= trunc + 1)) // special case if either poly is zero
+   {
+      F_mpz_poly_zero(res);
+      return;
+   }
+
+	if ((poly1 == res) || (poly2 == res)) // aliased inputs
+	{
+		F_mpz_poly_t output; // create temporary
+		F_mpz_poly_init2(output, poly1->length + poly2->length - 1);
+		if (poly1->length >= poly2->length) _F_mpz_poly_mul_trunc_left(output, poly1, poly2, trunc);
+		else _F_mpz_poly_mul_trunc_left(output, poly2, poly1, trunc);
+		F_mpz_poly_swap(output, res); // swap temporary with real output
+		F_mpz_poly_clear(output);
+	} else // ordinary case
+	{
+		F_mpz_poly_fit_length(res, poly1->length + poly2->length - 1);
+      if (poly1->length >= poly2->length) _F_mpz_poly_mul_trunc_left(res, poly1, poly2, trunc);
+		else _F_mpz_poly_mul_trunc_left(res, poly2, poly1, trunc);
+	}		
+}
+
+/*===============================================================================
+
+	Multiplication with a precached operand
+
+================================================================================*/
+
+void _F_mpz_poly_mul_precache_init_KS(F_mpz_poly_precache_t pre, 
+                        const F_mpz_poly_t poly2, const long bits1, const ulong length1)
+{
+   ulong length2 = poly2->length;
+
+   pre->type = F_MPZ_POLY_KS_PRE;
+   pre->length1 = length1;
+   pre->length2 = length2;
+   pre->int2 = NULL;
+   pre->poly = NULL;
+
+   if ((length1 == 0) || (length2 == 0)) // nothing to cache
+   {
+      pre->length2 = 0;
+      return;
+   }
+
+   long bits2 = F_mpz_poly_max_bits(poly2);
+   
+   ulong sign = ((bits1 < 0) || (bits2 < 0)); // an extra bit if any coefficients are signed
+   ulong length = FLINT_MIN(length1, length2); 
+   ulong log_length = 0L;
+   while ((1L<<log_length) < length) log_length++;
+   ulong bits = FLINT_ABS(bits1) + FLINT_ABS(bits2) + log_length + sign; // total number of output bits
+   ulong bytes = ((bits - 1)>>3) + 1;
+   
+   pre->bits = sign ? -bits : bits;
+   pre->bitpack = (bits - sign <= FLINT_BITS - 2); // we want output bits to fit into a small F_mpz for bitpacking
+   
+   ulong n1, n2;
+   mp_limb_t * int2;
+
+   if (pre->bitpack)
+   {
+      pre->sign2 = 0L;
+      if (poly2->coeffs[length2 - 1] < 0L) pre->sign2 = -1L; // leading coefficient is negative
+
+      n1 = (bits*length1 - 1)/FLINT_BITS + 1; // number of limbs for large integers
+      n2 = (bits*length2 - 1)/FLINT_BITS + 1;
+      
+      int2 = (mp_limb_t *) flint_heap_alloc(n2);
+      if (sign) F_mpz_poly_bit_pack(int2, n2, poly2, bits, length2, pre->sign2);
+      else F_mpz_poly_bit_pack_unsigned(int2, n2, poly2, bits, length2);
+   } else
+   {
+      pre->sign2 = 1L;
+      if (F_mpz_sgn(poly2->coeffs + length2 - 1) < 0) pre->sign2 = -1L; // leading coeff is negative
+
+      n1 = ((bytes*length1 - 1)>>FLINT_LG_BYTES_PER_LIMB) + 1; // number of limbs for large integers
+      n2 = ((bytes*length2 - 1)>>FLINT_LG_BYTES_PER_LIMB) + 1;
+      
+      int2 = (mp_limb_t *) flint_heap_alloc(n2 + 1); // extra limb required
+      if (sign) F_mpz_poly_byte_pack(int2, poly2, length2, bytes, pre->sign2);
+      else F_mpz_poly_byte_pack_unsigned(int2, poly2, length2, bytes);
+   }
+
+   pre->limbs2 = n2;
+
+   if (n1 + n2 < 2*FLINT_FFT_LIMBS_CROSSOVER) // F_mpn_mul won't use an FFT, just keep the integer
+      pre->int2 = int2;
+   else
+   {
+      F_mpn_mul_precache_init(pre->precache, int2, n2, n1);
+      flint_heap_free(int2);
+   }
+}
+
+void _F_mpz_poly_mul_precache_init_SS(F_mpz_poly_precache_t pre, 
+                  const F_mpz_poly_t poly2, const long bits1, const ulong length1, 
+                                                                   const ulong start)
+{
+   ulong length2 = poly2->length;
+
+   pre->type = F_MPZ_POLY_SS_PRE;
+   pre->length1 = length1;
+   pre->length2 = length2;
+   pre->int2 = NULL;
+   pre->poly = NULL;
+
+   if ((length1 == 0) || (length2 == 0)) // nothing to cache
+   {
+      pre->length2 = 0;
+      return;
+   }
+
+   long bits2 = F_mpz_poly_max_bits(poly2);
+   
+   ulong sign = ((bits1 < 0) || (bits2 < 0)); // an extra bit if any coefficients are signed
+   ulong length = FLINT_MIN(length1, length2); 
+   ulong log_length2 = 0L;
+   while ((1L<<log_length2) < length) log_length2++;
+   ulong output_bits = FLINT_ABS(bits1) + FLINT_ABS(bits2) + log_length2 + sign;
+   
+   /* 
+      Coefficients which wrap around land below start, so the convolution only
+      needs to be as long as the part of the product from start onwards, but
+      must still hold all length1 coefficients of a middle product
+   */
+   ulong conv_length = FLINT_MAX(length1 + length2 - 1 - start, length1);
+   
+   ulong log_length = 0; // transforms are of length 2^(log_length + 1)
+   while ((2L<<log_length) < conv_length) log_length++;
+   
+   if ((log_length) && (output_bits <= length1)) // round up so that sqrt2 trick can be used
+      output_bits = (((output_bits - 1) >> (log_length - 1)) + 1) << (log_length - 1);
+   else // simple round up for FFT length
+      output_bits = (((output_bits - 1) >> log_length) + 1) << log_length;
+      
+   ulong n = (output_bits - 1) / FLINT_BITS + 1; // size of FFT coeffs
+
+   pre->bits = sign ? -output_bits : output_bits;
+
+   pre->poly = (ZmodF_poly_p) flint_heap_alloc_bytes(sizeof(ZmodF_poly_struct));
+   ZmodF_poly_init(pre->poly, log_length + 1, n, 1);
+   
+   F_mpz_poly_to_ZmodF_poly(pre->poly, poly2, length2, output_bits);
+   ZmodF_poly_FFT(pre->poly, FLINT_MIN(length1 + length2 - 1, 1UL<<(log_length + 1)));
+}
+
+/*
+   Sets up the precache with the algorithm _F_mpz_poly_mul would choose.
+*/
+static
+void __F_mpz_poly_mul_precache_init(F_mpz_poly_precache_t pre, 
+        const F_mpz_poly_t poly2, const long bits1, const ulong length1, const ulong start)
+{
+   ulong bits = FLINT_ABS(bits1) + FLINT_ABS(F_mpz_poly_max_bits(poly2));
+   
+   if ((bits <= 470) || (3*bits < length1 + poly2->length))
+      _F_mpz_poly_mul_precache_init_KS(pre, poly2, bits1, length1);
+   else 
+      _F_mpz_poly_mul_precache_init_SS(pre, poly2, bits1, length1, start);
+}
+
+void F_mpz_poly_mul_precache_init(F_mpz_poly_precache_t pre, 
+                        const F_mpz_poly_t poly2, const long bits1, const ulong length1)
+{
+   __F_mpz_poly_mul_precache_init(pre, poly2, bits1, length1, 0);
+}
+
+void F_mpz_poly_mul_trunc_n_precache_init(F_mpz_poly_precache_t pre, 
+                        const F_mpz_poly_t poly2, const long bits1, const ulong trunc)
+{
+   F_mpz_poly_t input2;
+   _F_mpz_poly_attach_truncate(input2, poly2, trunc);
+   
+   __F_mpz_poly_mul_precache_init(pre, input2, bits1, trunc, 0);
+}
+
+void F_mpz_poly_mul_middle_precache_init(F_mpz_poly_precache_t pre, 
+                        const F_mpz_poly_t poly2, const long bits1, const ulong trunc)
+{
+   F_mpz_poly_t input2;
+   _F_mpz_poly_attach_truncate(input2, poly2, trunc);
+   
+   __F_mpz_poly_mul_precache_init(pre, input2, bits1, trunc, trunc/2);
+}
+
+void F_mpz_poly_mul_precache_clear(F_mpz_poly_precache_t pre)
+{
+   if (pre->length2 == 0) return;
+
+   if (pre->type == F_MPZ_POLY_KS_PRE)
+   {
+      if (pre->int2) flint_heap_free(pre->int2);
+      else F_mpn_mul_precache_clear(pre->precache);
+   } else
+   {
+      ZmodF_poly_clear(pre->poly);
+      flint_heap_free(pre->poly);
+   }
+}
+
+void _F_mpz_poly_mul_KS_precache(F_mpz_poly_t output, const F_mpz_poly_t input1, 
+                           F_mpz_poly_precache_t pre, const ulong start, const ulong trunc)
+{
+   ulong length1 = input1->length;
+   
+   ulong sign = (pre->bits < 0L);
+   ulong bits = FLINT_ABS(pre->bits);
+   ulong bytes = ((bits - 1)>>3) + 1;
+
+   long sign1;
+   mp_limb_t * int1, * int3;
+   ulong n1, n2 = pre->limbs2, n3;
+
+   if (pre->bitpack)
+   {
+      sign1 = 0L;
+      if (input1->coeffs[length1 - 1] < 0L) sign1 = -1L; // leading coefficient is negative
+   
+      n1 = (bits*length1 - 1)/FLINT_BITS + 1; // number of limbs for large integer
+      int1 = (mp_limb_t *) flint_stack_alloc(n1);
+      
+      if (sign) F_mpz_poly_bit_pack(int1, n1, input1, bits, length1, sign1);
+      else F_mpz_poly_bit_pack_unsigned(int1, n1, input1, bits, length1);
+
+      n3 = (bits*trunc - 1)/FLINT_BITS + 1; // limbs of the product we need
+   } else
+   {
+      sign1 = 1L;
+      if (F_mpz_sgn(input1->coeffs + length1 - 1) < 0) sign1 = -1L; // leading coeff is negative
+   
+      n1 = ((bytes*length1 - 1)>>FLINT_LG_BYTES_PER_LIMB) + 1; // number of limbs for large integer
+      int1 = (mp_limb_t *) flint_stack_alloc(n1 + 1); // extra limb required
+      
+      if (sign) F_mpz_poly_byte_pack(int1, input1, length1, bytes, sign1);
+      else F_mpz_poly_byte_pack_unsigned(int1, input1, length1, bytes);
+
+      n3 = ((bytes*trunc - 1)>>FLINT_LG_BYTES_PER_LIMB) + 2; // unpacking reads an extra limb
+   }
+
+   int3 = (mp_limb_t *) flint_stack_alloc(n1 + n2); // allocate space for product large integer
+   
+   if (pre->int2) // below the FFT crossover, nothing to gain from truncation
+   {
+      if (n1 >= n2) int3[n1 + n2 - 1] = F_mpn_mul(int3, int1, n1, pre->int2, n2); 
+      else int3[n1 + n2 - 1] = F_mpn_mul(int3, pre->int2, n2, int1, n1);
+   } else if (n3 >= n1 + n2)
+   {
+      int3[n1 + n2 - 1] = F_mpn_mul_precache(int3, int1, n1, pre->precache);
+   } else
+      F_mpn_mul_precache_trunc(int3, int1, n1, pre->precache, n3); // clears the rest of int3
+
+   _F_mpz_poly_set_length(output, 0);
+
+   if (pre->bitpack)
+   {
+      if (sign) F_mpz_poly_bit_unpack(output, int3, trunc, bits);  // signed coeffs
+      else F_mpz_poly_bit_unpack_unsigned(output, int3, trunc, bits);  // unsigned coeffs
+   } else
+   {
+      if (sign) F_mpz_poly_byte_unpack(output, int3, trunc, bytes); // signed coeffs 
+      else F_mpz_poly_byte_unpack_unsigned(output, int3, trunc, bytes); // unsigned coeffs
+   }
+	
+   flint_stack_release(); // release int3
+   flint_stack_release(); // release int1
+
+   F_mpz_poly_truncate(output, trunc); // unpacking can leave a borrow in coefficient trunc
+
+   ulong i;
+   for (i = 0; (i < start) && (i < output->length); i++) 
+      F_mpz_zero(output->coeffs + i);
+   _F_mpz_poly_normalise(output);
+
+   if ((sign1 ^ pre->sign2) < 0L) F_mpz_poly_neg(output, output); // one of the leading coeffs was negative
+}
+
+void _F_mpz_poly_mul_SS_precache(F_mpz_poly_t output, const F_mpz_poly_t input1, 
+                           F_mpz_poly_precache_t pre, const ulong start, const ulong trunc)
+{
+   ulong length1 = input1->length;
+   ulong length = length1 + pre->length2 - 1;
+   ulong size = 1UL<<pre->poly->depth;
+   if (length > size) length = size; // product wraps around below start
+
+   ZmodF_poly_t poly1;
+   ZmodF_poly_stack_init(poly1, pre->poly->depth, pre->poly->n, 1);
+   F_mpz_poly_to_ZmodF_poly(poly1, input1, length1, FLINT_ABS(pre->bits));
+
+   ZmodF_poly_struct poly2 = *pre->poly; // the first length Fourier coefficients of the cached operand
+   poly2.length = length;
+
+   ZmodF_poly_FFT(poly1, length);
+   ZmodF_poly_pointwise_mul(poly1, poly1, &poly2);
+   ZmodF_poly_IFFT(poly1);
+   ZmodF_poly_rescale_range(poly1, start, trunc);
+
+   ZmodF_poly_struct mid = *poly1; // coefficients [start, trunc) of the convolution 
+   mid.coeffs += start;
+   mid.length = trunc - start;
+
+   F_mpz_poly_t top;
+   _F_mpz_poly_set_length(output, 0);
+   top->coeffs = output->coeffs + start;
+   top->alloc = output->alloc - start;
+   top->length = 0;
+
+   ZmodF_poly_to_F_mpz_poly(top, &mid, (pre->bits < 0L)); // write output
+
+   ulong i;
+   for (i = 0; i < start; i++) 
+      F_mpz_zero(output->coeffs + i);
+   output->length = trunc;
+   _F_mpz_poly_normalise(output);
+
+   ZmodF_poly_stack_clear(poly1);
+}
+
+/*
+   Sets res to coefficients [start, trunc) of poly1 times the cached operand.
+*/
+static
+void __F_mpz_poly_mul_precache(F_mpz_poly_t res, const F_mpz_poly_t poly1, 
+                          F_mpz_poly_precache_t pre, const ulong start, ulong trunc)
 {
-	if ((poly1->length == 0) || (poly2->length == 0)) // special case if either poly is zero
+   F_mpz_poly_t input1;
+   _F_mpz_poly_attach_truncate(input1, poly1, trunc); // higher coefficients of poly1 are not needed
+
+   if ((input1->length == 0) || (pre->length2 == 0)) // special case if either poly is zero
    {
       F_mpz_poly_zero(res);
       return;
    }
 
-	if ((poly1 == res) || (poly2 == res)) // aliased inputs
-	{
-		F_mpz_poly_t output; // create temporary
-		F_mpz_poly_init2(output, poly1->length + poly2->length - 1);
-		if (poly1->length >= poly2->length) _F_mpz_poly_mul_SS(output, poly1, poly2, 0);
-		else _F_mpz_poly_mul_SS(output, poly2, poly1, 0);
-		F_mpz_poly_swap(output, res); // swap temporary with real output
-		F_mpz_poly_clear(output);
-	} else // ordinary case
-	{
-		if (poly1->length >= poly2->length) _F_mpz_poly_mul_SS(res, poly1, poly2, 0);
-		else _F_mpz_poly_mul_SS(res, poly2, poly1, 0);
-	}		
+   ulong length = input1->length + pre->length2 - 1;
+   if (trunc > length) trunc = length;
+
+   if (start >= trunc)
+   {
+      F_mpz_poly_zero(res);
+      return;
+   }
+
+   if (poly1 == res) // aliased inputs
+   {
+      F_mpz_poly_t output; // create temporary
+      F_mpz_poly_init2(output, trunc + 1);
+      if (pre->type == F_MPZ_POLY_KS_PRE) _F_mpz_poly_mul_KS_precache(output, input1, pre, start, trunc);
+      else _F_mpz_poly_mul_SS_precache(output, input1, pre, start, trunc);
+      F_mpz_poly_swap(output, res); // swap temporary with real output
+      F_mpz_poly_clear(output);
+   } else // ordinary case
+   {
+      F_mpz_poly_fit_length(res, trunc + 1);
+      if (pre->type == F_MPZ_POLY_KS_PRE) _F_mpz_poly_mul_KS_precache(res, input1, pre, start, trunc);
+      else _F_mpz_poly_mul_SS_precache(res, input1, pre, start, trunc);
+   }
+}
+
+void F_mpz_poly_mul_precache(F_mpz_poly_t res, const F_mpz_poly_t poly1, 
+                                                       F_mpz_poly_precache_t pre)
+{
+   __F_mpz_poly_mul_precache(res, poly1, pre, 0, poly1->length + pre->length2);
+}
+
+void F_mpz_poly_mul_trunc_n_precache(F_mpz_poly_t res, const F_mpz_poly_t poly1, 
+                                   F_mpz_poly_precache_t pre, const ulong trunc)
+{
+   __F_mpz_poly_mul_precache(res, poly1, pre, 0, trunc);
+}
+
+void F_mpz_poly_mul_middle_precache(F_mpz_poly_t res, const F_mpz_poly_t poly1, 
+                                   F_mpz_poly_precache_t pre, const ulong trunc)
+{
+   __F_mpz_poly_mul_precache(res, poly1, pre, trunc/2, trunc);
 }
 
 /*===============================================================================
 
-	Multiplication
+	Dot products and matrix products
 
 ================================================================================*/
 
-void _F_mpz_poly_mul(F_mpz_poly_t output, const F_mpz_poly_t input1, const F_mpz_poly_t input2)
+/*
+   Sets R to the product of the 2x2 matrices A = [a b; c d] and B = [e f; g h]
+   of Fourier transforms, using the Strassen-Winograd formulae, i.e. 7
+   pointwise multiplications. The entries of A are used as scratch space.
+*/
+static
+void __F_mpz_poly_mat_mul_2x2_SS(ZmodF_poly_struct * R, ZmodF_poly_struct * A,
+                          ZmodF_poly_struct * B, ZmodF_poly_t x0, ZmodF_poly_t x1)
 {
-   if ((input1->length == 0) || (input2->length == 0)) // special case, length == 0
+   ZmodF_poly_struct * a = A, * b = A + 1, * c = A + 2, * d = A + 3;
+   ZmodF_poly_struct * e = B, * f = B + 1, * g = B + 2, * h = B + 3;
+
+   ZmodF_poly_sub(x0, a, c);
+   ZmodF_poly_sub(x1, h, f);
+   ZmodF_poly_pointwise_mul(R + 2, x0, x1); // (a - c)(h - f)
+
+   ZmodF_poly_add(x0, c, d);
+   ZmodF_poly_sub(x1, f, e);
+   ZmodF_poly_pointwise_mul(R + 3, x0, x1); // (c + d)(f - e)
+
+   ZmodF_poly_sub(x0, x0, a);
+   ZmodF_poly_sub(x1, h, x1);
+   ZmodF_poly_pointwise_mul(R + 1, x0, x1); // (c + d - a)(h - f + e)
+
+   ZmodF_poly_sub(c, b, x0);
+   ZmodF_poly_pointwise_mul(R, c, h); // (a + b - c - d)h
+
+   ZmodF_poly_pointwise_mul(x0, a, e);
+
+   ZmodF_poly_add(R + 1, R + 1, x0);
+   ZmodF_poly_add(R + 2, R + 2, R + 1);
+   ZmodF_poly_add(R + 1, R + 1, R + 3);
+   ZmodF_poly_add(R + 3, R + 3, R + 2);
+   ZmodF_poly_add(R + 1, R + 1, R);
+
+   ZmodF_poly_sub(x1, x1, g);
+   ZmodF_poly_pointwise_mul(R, d, x1); // d(h - f + e - g)
+   ZmodF_poly_sub(R + 2, R + 2, R);
+
+   ZmodF_poly_pointwise_mul(R, b, g);
+   ZmodF_poly_add(R, R, x0);
+}
+
+/*
+   Matrix product in the Fourier domain. Assumes C does not alias A or B,
+   that the entries of C have room for length coefficients, where length
+   is the sum of the maximum lengths of the entries of A and B less one,
+   and that bits is a bound for the coefficients of all entries of C,
+   negative if they may be negative.
+*/
+static
+void _F_mpz_poly_mat_mul_SS(F_mpz_poly_struct ** C, const F_mpz_poly_struct ** A,
+                 const F_mpz_poly_struct ** B, const ulong r, const ulong s, const ulong t,
+                                   const ulong len_A, const ulong length, const long bits)
+{
+   ulong i, j, k;
+   int dense = 1;
+
+   ulong output_bits = FLINT_ABS(bits);
+   ulong log_length = 0; // transforms are of length 2^(log_length + 1)
+   while ((2L<<log_length) < length) log_length++;
+
+   if ((log_length) && (output_bits <= len_A)) // round up so that sqrt2 trick can be used
+      output_bits = (((output_bits - 1) >> (log_length - 1)) + 1) << (log_length - 1);
+   else // simple round up for FFT length
+      output_bits = (((output_bits - 1) >> log_length) + 1) << log_length;
+
+   ulong n = (output_bits - 1) / FLINT_BITS + 1; // size of FFT coeffs
+
+   // transform every input once
+   ZmodF_poly_struct * fA = (ZmodF_poly_struct *) flint_heap_alloc_bytes(r*s*sizeof(ZmodF_poly_struct));
+   ZmodF_poly_struct * fB = (ZmodF_poly_struct *) flint_heap_alloc_bytes(s*t*sizeof(ZmodF_poly_struct));
+
+   for (i = 0; i < r*s; i++)
    {
-      F_mpz_poly_zero(output);
-      return;
+      if (A[i]->length == 0)
+      {
+         dense = 0;
+         continue;
+      }
+      ZmodF_poly_init(fA + i, log_length + 1, n, 1);
+      F_mpz_poly_to_ZmodF_poly(fA + i, A[i], A[i]->length, output_bits);
+      ZmodF_poly_FFT(fA + i, length);
    }
 
-   if ((input1->length <= 2) && (input2->length <= 2)) // karatsuba seems to be unconditionally faster
+   for (i = 0; i < s*t; i++)
    {
-      _F_mpz_poly_mul_karatsuba(output, input1, input2);
-      return;
+      if (B[i]->length == 0)
+      {
+         dense = 0;
+         continue;
+      }
+      ZmodF_poly_init(fB + i, log_length + 1, n, 1);
+      F_mpz_poly_to_ZmodF_poly(fB + i, B[i], B[i]->length, output_bits);
+      ZmodF_poly_FFT(fB + i, length);
    }
-   
-	if (input1->length + input2->length <= 128) // we don't want to check max limbs or max bits more than once
-	{
-	   ulong limbs1 = F_mpz_poly_max_limbs(input1);
-      ulong limbs2 = F_mpz_poly_max_limbs(input2);
 
-      if (limbs1 + limbs2 <= 512/FLINT_BITS)
+   ZmodF_poly_t acc, prod;
+   ZmodF_poly_stack_init(acc, log_length + 1, n, 1);
+   ZmodF_poly_stack_init(prod, log_length + 1, n, 1);
+   acc->length = length;
+   prod->length = length;
+
+   if ((r == 2) && (s == 2) && (t == 2) && dense)
+   {
+      ZmodF_poly_struct fC[4];
+      for (i = 0; i < 4; i++)
       {
-         _F_mpz_poly_mul_KS(output, input1, input2, 0);
-         return;
+         ZmodF_poly_init(fC + i, log_length + 1, n, 1);
+         fC[i].length = length;
       }
-   
-      if (input1->length + input2->length <= 32) 
+
+      __F_mpz_poly_mat_mul_2x2_SS(fC, fA, fB, acc, prod);
+
+      for (i = 0; i < 4; i++)
       {
-         _F_mpz_poly_mul_karatsuba(output, input1, input2);
-         return;
+         ZmodF_poly_normalise(fC + i);
+         ZmodF_poly_IFFT(fC + i);
+         ZmodF_poly_rescale(fC + i);
+         ZmodF_poly_to_F_mpz_poly(C[i], fC + i, (bits < 0L));
+         _F_mpz_poly_normalise(C[i]);
+         ZmodF_poly_clear(fC + i);
       }
-	}
-   
-   long bits2 = F_mpz_poly_max_bits(input2);
-   long bits1 = (input1 == input2) ? bits2 : F_mpz_poly_max_bits(input1);
-   
-   ulong sign = ((bits1 < 0) || (bits2 < 0)); // an extra bit if any coefficients are signed
-   ulong length = input2->length; // length of shortest poly
-   ulong log_length = 0L;
-   while ((1<<log_length) < length) log_length++;
-   ulong bits = FLINT_ABS(bits1) + FLINT_ABS(bits2) + log_length + sign; // total number of output bits
-   if (sign) bits = -bits; // coefficients are signed
+   } else
+   {
+      for (i = 0; i < r; i++)
+      {
+         for (j = 0; j < t; j++)
+         {
+            int empty = 1; // accumulate the products for entry (i, j)
 
-   bits1 = FLINT_ABS(bits1);
-   bits2 = FLINT_ABS(bits2);
+            for (k = 0; k < s; k++)
+            {
+               if ((A[i*s + k]->length == 0) || (B[k*t + j]->length == 0))
+                  continue;
 
-	if (bits1 + bits2 <= 470)
-   {
-      _F_mpz_poly_mul_KS(output, input1, input2, bits);
-      return;
-   }
-   
-   if (3*(bits1 + bits2) >= input1->length + input2->length) // the "diagonal"
-   {
-      _F_mpz_poly_mul_SS(output, input1, input2, bits);
-      return;
-   } 
-   
-   _F_mpz_poly_mul_KS(output, input1, input2, bits);     
-}
+               if (empty) ZmodF_poly_pointwise_mul(acc, fA + i*s + k, fB + k*t + j);
+               else
+               {
+                  ZmodF_poly_pointwise_mul(prod, fA + i*s + k, fB + k*t + j);
+                  ZmodF_poly_add(acc, acc, prod);
+               }
+               empty = 0;
+            }
 
-void F_mpz_poly_mul(F_mpz_poly_t res, const F_mpz_poly_t poly1, const F_mpz_poly_t poly2)
-{
-	if ((poly1->length == 0) || (poly2->length == 0)) // special case if either poly is zero
-   {
-      F_mpz_poly_zero(res);
-      return;
+            if (empty)
+            {
+               F_mpz_poly_zero(C[i*t + j]);
+               continue;
+            }
+
+            ZmodF_poly_normalise(acc);
+            ZmodF_poly_IFFT(acc);
+            ZmodF_poly_rescale(acc);
+            ZmodF_poly_to_F_mpz_poly(C[i*t + j], acc, (bits < 0L));
+            _F_mpz_poly_normalise(C[i*t + j]);
+         }
+      }
    }
 
-	if ((poly1 == res) || (poly2 == res)) // aliased inputs
-	{
-		F_mpz_poly_t output; // create temporary
-		F_mpz_poly_init2(output, poly1->length + poly2->length - 1);
-		if (poly1->length >= poly2->length) _F_mpz_poly_mul(output, poly1, poly2);
-		else _F_mpz_poly_mul(output, poly2, poly1);
-		F_mpz_poly_swap(output, res); // swap temporary with real output
-		F_mpz_poly_clear(output);
-	} else // ordinary case
-	{
-		F_mpz_poly_fit_length(res, poly1->length + poly2->length - 1);
-      if (poly1->length >= poly2->length) _F_mpz_poly_mul(res, poly1, poly2);
-		else _F_mpz_poly_mul(res, poly2, poly1);
-	}		
+   ZmodF_poly_stack_clear(prod);
+   ZmodF_poly_stack_clear(acc);
+
+   for (i = 0; i < s*t; i++)
+      if (B[i]->length) ZmodF_poly_clear(fB + i);
+   for (i = 0; i < r*s; i++)
+      if (A[i]->length) ZmodF_poly_clear(fA + i);
+
+   flint_heap_free(fB);
+   flint_heap_free(fA);
 }
 
-void _F_mpz_poly_mul_trunc_left(F_mpz_poly_t output, const F_mpz_poly_t input1, const F_mpz_poly_t input2, ulong trunc)
+void _F_mpz_poly_mat_mul(F_mpz_poly_struct ** C,
+                     const F_mpz_poly_struct ** A, const F_mpz_poly_struct ** B,
+                                           const ulong r, const ulong s, const ulong t)
 {
-   if ((input1->length == 0) || (input2->length == 0) || (input1->length + input2->length <= trunc + 1)) // special case, length == 0
+   ulong i, j, k;
+   ulong len_A = 0, len_B = 0;
+   long bits_A = 0, bits_B = 0;
+   ulong sign = 0;
+
+   if ((r == 0) || (t == 0)) return;
+
+   for (i = 0; i < r*s; i++)
+      len_A = FLINT_MAX(len_A, A[i]->length);
+   for (i = 0; i < s*t; i++)
+      len_B = FLINT_MAX(len_B, B[i]->length);
+
+   if ((len_A == 0) || (len_B == 0))
    {
-      F_mpz_poly_zero(output);
+      for (i = 0; i < r*t; i++) F_mpz_poly_zero(C[i]);
       return;
    }
 
-   if ((input1->length <= 2) && (input2->length <= 2)) // karatsuba seems to be unconditionally faster
+   for (i = 0; i < r*s; i++)
    {
-      _F_mpz_poly_mul_karatsuba_trunc_left(output, input1, input2, trunc);
-      return;
+      long b = F_mpz_poly_max_bits(A[i]);
+      if (b < 0L) sign = 1;
+      bits_A = FLINT_MAX(bits_A, FLINT_ABS(b));
+   }
+   for (i = 0; i < s*t; i++)
+   {
+      long b = F_mpz_poly_max_bits(B[i]);
+      if (b < 0L) sign = 1;
+      bits_B = FLINT_MAX(bits_B, FLINT_ABS(b));
    }
-   
-	if (input1->length + input2->length <= 128) // we don't want to check max limbs or max bits more than once
-	{
-	   ulong limbs1 = F_mpz_poly_max_limbs(input1);
-      ulong limbs2 = F_mpz_poly_max_limbs(input2);
 
-      if (limbs1 + limbs2 <= 512/FLINT_BITS)
-      {
-         _F_mpz_poly_mul_KS(output, input1, input2, 0);
-         return;
-      }
-   
-      if (input1->length + input2->length <= 32) 
-      {
-         _F_mpz_poly_mul_karatsuba_trunc_left(output, input1, input2, trunc);
-         return;
-      }
-	}
-   
-   long bits2 = F_mpz_poly_max_bits(input2);
-   long bits1 = (input1 == input2) ? bits2 : F_mpz_poly_max_bits(input1);
-   
-   ulong sign = ((bits1 < 0) || (bits2 < 0)); // an extra bit if any coefficients are signed
-   ulong length = input2->length; // length of shortest poly
-   ulong log_length = 0L;
-   while ((1<<log_length) < length) log_length++;
-   ulong bits = FLINT_ABS(bits1) + FLINT_ABS(bits2) + log_length + sign; // total number of output bits
-   if (sign) bits = -bits; // coefficients are signed
+   ulong length = len_A + len_B - 1;
 
-   bits1 = FLINT_ABS(bits1);
-   bits2 = FLINT_ABS(bits2);
+   // the entries of C may alias the inputs, so we work with temporaries
+   F_mpz_poly_struct * T = (F_mpz_poly_struct *) flint_heap_alloc_bytes(r*t*sizeof(F_mpz_poly_struct));
+   for (i = 0; i < r*t; i++)
+      F_mpz_poly_init2(T + i, length);
 
-	if (bits1 + bits2 <= 470)
+   if ((bits_A + bits_B > 470) && (3*(bits_A + bits_B) >= len_A + len_B))
    {
-      _F_mpz_poly_mul_KS(output, input1, input2, bits);
-      return;
+      // as for _F_mpz_poly_mul, the "diagonal" is done with SS multiplication
+      F_mpz_poly_struct ** pT = (F_mpz_poly_struct **) flint_heap_alloc_bytes(r*t*sizeof(F_mpz_poly_struct *));
+      for (i = 0; i < r*t; i++) pT[i] = T + i;
+
+      ulong log_length = 0L;
+      while ((1L<<log_length) < FLINT_MIN(len_A, len_B)) log_length++;
+      ulong log_s = 0L;
+      while ((1L<<log_s) < s) log_s++;
+      long bits = bits_A + bits_B + log_length + log_s + sign; // bound for the sums of products
+      if (sign) bits = -bits;
+
+      _F_mpz_poly_mat_mul_SS(pT, A, B, r, s, t, len_A, length, bits);
+
+      flint_heap_free(pT);
+   } else
+   {
+      F_mpz_poly_t temp;
+      F_mpz_poly_init2(temp, length);
+
+      for (i = 0; i < r; i++)
+         for (j = 0; j < t; j++)
+            for (k = 0; k < s; k++)
+            {
+               F_mpz_poly_mul(temp, A[i*s + k], B[k*t + j]);
+               F_mpz_poly_add(T + i*t + j, T + i*t + j, temp);
+            }
+
+      F_mpz_poly_clear(temp);
    }
-   
-   if (3*(bits1 + bits2) >= input1->length + input2->length) // the "diagonal"
+
+   for (i = 0; i < r*t; i++)
    {
-      _F_mpz_poly_mul_SS(output, input1, input2, bits);
-      return;
-   } 
-   
-   _F_mpz_poly_mul_KS(output, input1, input2, bits);     
+      F_mpz_poly_swap(C[i], T + i);
+      F_mpz_poly_clear(T + i);
+   }
+
+   flint_heap_free(T);
 }
 
-void F_mpz_poly_mul_trunc_left(F_mpz_poly_t res, const F_mpz_poly_t poly1, const F_mpz_poly_t poly2, ulong trunc)
+void F_mpz_poly_mat_mul(F_mpz_poly_struct * C, const F_mpz_poly_struct * A,
+                const F_mpz_poly_struct * B, const ulong r, const ulong s, const ulong t)
 {
-   if ((poly1->length == 0) || (poly2->length == 0) || (poly1->length + poly2->length <= trunc + 1)) // special case if either poly is zero
+   ulong i;
+
+   if ((r == 0) || (t == 0)) return;
+
+   if (s == 0)
    {
-      F_mpz_poly_zero(res);
+      for (i = 0; i < r*t; i++) F_mpz_poly_zero(C + i);
       return;
    }
 
-	if ((poly1 == res) || (poly2 == res)) // aliased inputs
-	{
-		F_mpz_poly_t output; // create temporary
-		F_mpz_poly_init2(output, poly1->length + poly2->length - 1);
-		if (poly1->length >= poly2->length) _F_mpz_poly_mul_trunc_left(output, poly1, poly2, trunc);
-		else _F_mpz_poly_mul_trunc_left(output, poly2, poly1, trunc);
-		F_mpz_poly_swap(output, res); // swap temporary with real output
-		F_mpz_poly_clear(output);
-	} else // ordinary case
-	{
-		F_mpz_poly_fit_length(res, poly1->length + poly2->length - 1);
-      if (poly1->length >= poly2->length) _F_mpz_poly_mul_trunc_left(res, poly1, poly2, trunc);
-		else _F_mpz_poly_mul_trunc_left(res, poly2, poly1, trunc);
-	}		
+   F_mpz_poly_struct ** pC = (F_mpz_poly_struct **) flint_heap_alloc_bytes(r*t*sizeof(F_mpz_poly_struct *));
+   const F_mpz_poly_struct ** pA = (const F_mpz_poly_struct **) flint_heap_alloc_bytes(r*s*sizeof(F_mpz_poly_struct *));
+   const F_mpz_poly_struct ** pB = (const F_mpz_poly_struct **) flint_heap_alloc_bytes(s*t*sizeof(F_mpz_poly_struct *));
+
+   for (i = 0; i < r*t; i++) pC[i] = C + i;
+   for (i = 0; i < r*s; i++) pA[i] = A + i;
+   for (i = 0; i < s*t; i++) pB[i] = B + i;
+
+   _F_mpz_poly_mat_mul(pC, pA, pB, r, s, t);
+
+   flint_heap_free(pB);
+   flint_heap_free(pA);
+   flint_heap_free(pC);
+}
+
+void F_mpz_poly_dot(F_mpz_poly_t res, const F_mpz_poly_struct * a,
+                                        const F_mpz_poly_struct * b, const ulong n)
+{
+   F_mpz_poly_mat_mul(res, a, b, 1, n, 1);
 }
 
 /*
@@ -6820,21 +7362,21 @@ void F_mpz_poly_hensel_lift(F_mpz_poly_t Gout, F_mpz_poly_t Hout, F_mpz_poly_t A
    
    //Lifting the inverses now
 
-   F_mpz_poly_t a1, b1, t1, t2, r, unity;
+   F_mpz_poly_t a1, b1, t1, r, unity;
    
    F_mpz_poly_init(a1);
    F_mpz_poly_init(b1);
    F_mpz_poly_init(t1);
-   F_mpz_poly_init(t2);
    F_mpz_poly_init(r);
    F_mpz_poly_init(unity);
 
    F_mpz_poly_set_coeff_si(unity, 0, -1);
 
-   F_mpz_poly_mul(t1, a, G);
-   F_mpz_poly_mul(t2, b, H);
+   const F_mpz_poly_struct * u[2] = {a, b};
+   const F_mpz_poly_struct * v[2] = {G, H};
+   F_mpz_poly_struct * w[1] = {t1};
+   _F_mpz_poly_mat_mul(w, u, v, 1, 2, 1); // t1 = a*G + b*H
 
-   F_mpz_poly_add(t1, t1, t2);
    F_mpz_poly_add(t1, t1, unity);
    F_mpz_poly_neg(t1, t1);
 
@@ -6875,7 +7417,6 @@ void F_mpz_poly_hensel_lift(F_mpz_poly_t Gout, F_mpz_poly_t Hout, F_mpz_poly_t A
    F_mpz_poly_clear(a1);
    F_mpz_poly_clear(b1);
    F_mpz_poly_clear(t1);
-   F_mpz_poly_clear(t2);
    F_mpz_poly_clear(r);
    F_mpz_poly_clear(unity);
 
@@ -7012,12 +7553,11 @@ void F_mpz_poly_hensel_lift_only_inverse(F_mpz_poly_t Aout, F_mpz_poly_t Bout,
    F_mpz_poly_init(A);
    F_mpz_poly_init(B);
 
-   F_mpz_poly_t a1, b1, t1, t2, r, unity;
+   F_mpz_poly_t a1, b1, t1, r, unity;
 
    F_mpz_poly_init(a1);
    F_mpz_poly_init(b1);
    F_mpz_poly_init(t1);
-   F_mpz_poly_init(t2);
    F_mpz_poly_init(r);
    F_mpz_poly_init(unity);
 
@@ -7044,10 +7584,12 @@ void F_mpz_poly_hensel_lift_only_inverse(F_mpz_poly_t Aout, F_mpz_poly_t Bout,
 
    //Lifting the inverses now
    F_mpz_poly_set_coeff_si(unity, 0, -1);
-   F_mpz_poly_mul(t1, a, G);
-   F_mpz_poly_mul(t2, b, H);
 
-   F_mpz_poly_add(t1, t1, t2);
+   const F_mpz_poly_struct * u[2] = {a, b};
+   const F_mpz_poly_struct * v[2] = {G, H};
+   F_mpz_poly_struct * w[1] = {t1};
+   _F_mpz_poly_mat_mul(w, u, v, 1, 2, 1); // t1 = a*G + b*H
+
    F_mpz_poly_add(t1, t1, unity);
    F_mpz_poly_neg(t1, t1);
 
@@ -7078,7 +7620,6 @@ void F_mpz_poly_hensel_lift_only_inverse(F_mpz_poly_t Aout, F_mpz_poly_t Bout,
    F_mpz_poly_clear(a1);
    F_mpz_poly_clear(b1);
    F_mpz_poly_clear(t1);
-   F_mpz_poly_clear(t2);
    F_mpz_poly_clear(r);
    F_mpz_poly_clear(unity);
 
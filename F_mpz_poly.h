@@ -92,6 +92,37 @@ typedef struct
 // F_mpz_poly_t allows reference-like semantics for F_mpz_poly_struct
 typedef F_mpz_poly_struct F_mpz_poly_t[1];
 
+/*****************************************************************************
+
+   F_mpz_poly_precache_t
+
+*****************************************************************************/
+
+/*
+   Stores a fixed operand of a multiplication in the form needed by the
+   multiplication algorithm, so that it need not be packed and transformed
+   again for each product. For Kronecker segmentation this is the packed
+   integer or its FFT, for Schoenhage-Strassen it is the Fourier transform
+   of the operand.
+*/
+typedef enum {F_MPZ_POLY_KS_PRE, F_MPZ_POLY_SS_PRE} F_mpz_poly_precache_type;
+
+typedef struct
+{
+   F_mpz_poly_precache_type type;
+   ulong length1; // maximum length of the other operand
+   ulong length2; // length of the cached operand
+   long bits; // bits per output coefficient, negative if the output is signed
+   long sign2; // negation used when packing the cached operand (KS)
+   int bitpack; // whether the cached operand is bit packed or byte packed (KS)
+   ulong limbs2; // number of limbs of the packed operand (KS)
+   mp_limb_t * int2; // packed operand for products below the FFT crossover (KS)
+   F_mpn_precache_t precache; // FFT of the packed operand otherwise (KS)
+   ZmodF_poly_p poly; // Fourier transform of the operand (SS)
+} F_mpz_poly_precache_struct;
+
+typedef F_mpz_poly_precache_struct F_mpz_poly_precache_t[1];
+
 /*****************************************************************************
 
    F_mpz_poly_factor_t
@@ -510,6 +541,39 @@ void F_mpz_poly_print_pretty(const F_mpz_poly_t poly, const char * x);
 */
 int F_mpz_poly_fread(F_mpz_poly_t poly, FILE * f);
 
+/** 
+   \fn     int F_mpz_poly_fwrite_bin(const F_mpz_poly_t poly, FILE * f)
+   \brief  Writes poly to the binary stream f in the binary format described 
+           in mpn_extras.h and F_mpz.h. Returns 1 on success, 0 on failure.
+*/
+int F_mpz_poly_fwrite_bin(const F_mpz_poly_t poly, FILE * f);
+
+/** 
+   \fn     int F_mpz_poly_fread_bin(F_mpz_poly_t poly, FILE * f)
+   \brief  Reads a polynomial written by F_mpz_poly_fwrite_bin from f into 
+           poly. Returns 0 if the data is not a valid polynomial, or if the
+           header is inconsistent with itself or with the length of f.
+*/
+int F_mpz_poly_fread_bin(F_mpz_poly_t poly, FILE * f);
+
+/** 
+   \fn     int F_mpz_poly_set_map(F_mpz_poly_t poly, const F_mpn_map_t map)
+   \brief  Sets poly to the polynomial in the mapped binary file. Returns 0
+           if the file is not a valid polynomial.
+*/
+int F_mpz_poly_set_map(F_mpz_poly_t poly, const F_mpn_map_t map);
+
+/** 
+   \fn     int F_mpz_poly_attach_map(F_mpz_poly_t poly, const F_mpn_map_t map)
+   \brief  Attaches the polynomial in the mapped binary file to the 
+           uninitialised poly without copying, which is only possible if 
+           the file has native byte order and all coefficients are small. 
+           Returns 0 otherwise. The coefficients may be modified in place, 
+           but poly must not be cleared or resized, and becomes invalid 
+           when the map is cleared.
+*/
+int F_mpz_poly_attach_map(F_mpz_poly_t poly, const F_mpn_map_t map);
+
 /**
    \fn     void F_mpz_poly_print(F_mpz_poly_t poly)
    \brief  Print a polynomial to stdout. Format is an integer
@@ -1006,6 +1070,165 @@ void _F_mpz_poly_mul_trunc_left(F_mpz_poly_t res, const F_mpz_poly_t poly1,
 void F_mpz_poly_mul_trunc_left(F_mpz_poly_t res, const F_mpz_poly_t poly1, 
                                               const F_mpz_poly_t poly2, const ulong trunc);
 
+/*===============================================================================
+
+	Multiplication with a precached operand
+
+================================================================================*/
+
+/**
+   \fn     void _F_mpz_poly_mul_precache_init_KS(F_mpz_poly_precache_t pre,
+                        const F_mpz_poly_t poly2, const long bits1, const ulong length1)
+   \brief  Set up pre for Kronecker segmentation multiplications of poly2 by
+           polynomials of length at most length1 whose coefficients have at most
+           |bits1| bits, where bits1 is negative if any of them may be negative
+           (as returned by F_mpz_poly_max_bits).
+*/
+void _F_mpz_poly_mul_precache_init_KS(F_mpz_poly_precache_t pre,
+                        const F_mpz_poly_t poly2, const long bits1, const ulong length1);
+
+/**
+   \fn     void _F_mpz_poly_mul_precache_init_SS(F_mpz_poly_precache_t pre,
+                  const F_mpz_poly_t poly2, const long bits1, const ulong length1,
+                                                                   const ulong start)
+   \brief  As for _F_mpz_poly_mul_precache_init_KS but for Schoenhage-Strassen
+           multiplication. If start is nonzero the transform is only made long
+           enough for the coefficients from start onwards to be correct, the lower
+           coefficients wrapping around. The precache may then only be used for
+           middle products with trunc at most length1 and trunc/2 at least start.
+*/
+void _F_mpz_poly_mul_precache_init_SS(F_mpz_poly_precache_t pre,
+                  const F_mpz_poly_t poly2, const long bits1, const ulong length1,
+                                                                   const ulong start);
+
+/**
+   \fn     void F_mpz_poly_mul_precache_init(F_mpz_poly_precache_t pre,
+                        const F_mpz_poly_t poly2, const long bits1, const ulong length1)
+   \brief  Set up pre for multiplications of poly2 by polynomials of length at
+           most length1 whose coefficients have at most |bits1| bits, bits1 being
+           negative if any of them may be negative. The algorithm is chosen as
+           for F_mpz_poly_mul. The precache may be used with any of the
+           precached multiplication functions below.
+*/
+void F_mpz_poly_mul_precache_init(F_mpz_poly_precache_t pre,
+                        const F_mpz_poly_t poly2, const long bits1, const ulong length1);
+
+/**
+   \fn     void F_mpz_poly_mul_trunc_n_precache_init(F_mpz_poly_precache_t pre,
+                        const F_mpz_poly_t poly2, const long bits1, const ulong trunc)
+   \brief  As for F_mpz_poly_mul_precache_init, but only products truncated to
+           length at most trunc (including middle products) can be computed. Only
+           the first trunc coefficients of poly2 are cached.
+*/
+void F_mpz_poly_mul_trunc_n_precache_init(F_mpz_poly_precache_t pre,
+                        const F_mpz_poly_t poly2, const long bits1, const ulong trunc);
+
+/**
+   \fn     void F_mpz_poly_mul_middle_precache_init(F_mpz_poly_precache_t pre,
+                        const F_mpz_poly_t poly2, const long bits1, const ulong trunc)
+   \brief  As for F_mpz_poly_mul_precache_init, but only middle products with the
+           given value of trunc can be computed. This allows a shorter transform
+           to be used, e.g. for the 2n x n products of Newton iteration.
+*/
+void F_mpz_poly_mul_middle_precache_init(F_mpz_poly_precache_t pre,
+                        const F_mpz_poly_t poly2, const long bits1, const ulong trunc);
+
+/**
+   \fn     void F_mpz_poly_mul_precache_clear(F_mpz_poly_precache_t pre)
+   \brief  Release the memory used by pre.
+*/
+void F_mpz_poly_mul_precache_clear(F_mpz_poly_precache_t pre);
+
+/**
+   \fn     void _F_mpz_poly_mul_KS_precache(F_mpz_poly_t output, const F_mpz_poly_t input1,
+                           F_mpz_poly_precache_t pre, const ulong start, const ulong trunc)
+   \brief  Set output to the coefficients [start, trunc) of the product of input1 by the
+           operand cached in pre, which must be a Kronecker segmentation precache. The
+           lower coefficients are set to zero. Assumes input1 is nonzero and normalised,
+           that 0 < trunc <= input1->length + pre->length2 - 1 and that output has space
+           for trunc + 1 coefficients.
+*/
+void _F_mpz_poly_mul_KS_precache(F_mpz_poly_t output, const F_mpz_poly_t input1,
+                           F_mpz_poly_precache_t pre, const ulong start, const ulong trunc);
+
+/**
+   \fn     void _F_mpz_poly_mul_SS_precache(F_mpz_poly_t output, const F_mpz_poly_t input1,
+                           F_mpz_poly_precache_t pre, const ulong start, const ulong trunc)
+   \brief  As for _F_mpz_poly_mul_KS_precache but for a Schoenhage-Strassen precache.
+*/
+void _F_mpz_poly_mul_SS_precache(F_mpz_poly_t output, const F_mpz_poly_t input1,
+                           F_mpz_poly_precache_t pre, const ulong start, const ulong trunc);
+
+/**
+   \fn     void F_mpz_poly_mul_precache(F_mpz_poly_t res, const F_mpz_poly_t poly1,
+                                                       F_mpz_poly_precache_t pre)
+   \brief  Set res to the product of poly1 by the operand cached in pre. The length
+           and coefficients of poly1 must be within the bounds given when pre was
+           initialised.
+*/
+void F_mpz_poly_mul_precache(F_mpz_poly_t res, const F_mpz_poly_t poly1,
+                                                       F_mpz_poly_precache_t pre);
+
+/**
+   \fn     void F_mpz_poly_mul_trunc_n_precache(F_mpz_poly_t res, const F_mpz_poly_t poly1,
+                                   F_mpz_poly_precache_t pre, const ulong trunc)
+   \brief  Set res to the product of poly1 by the operand cached in pre, truncated
+           to length trunc.
+*/
+void F_mpz_poly_mul_trunc_n_precache(F_mpz_poly_t res, const F_mpz_poly_t poly1,
+                                   F_mpz_poly_precache_t pre, const ulong trunc);
+
+/**
+   \fn     void F_mpz_poly_mul_middle_precache(F_mpz_poly_t res, const F_mpz_poly_t poly1,
+                                   F_mpz_poly_precache_t pre, const ulong trunc)
+   \brief  Set res to the coefficients [trunc/2, trunc) of the product of poly1 by
+           the operand cached in pre, the lower coefficients being set to zero. Only
+           the first trunc coefficients of poly1 are used. If the product is 2n x n
+           and trunc is 2n then this gives terms [n, 2n) of the product.
+*/
+void F_mpz_poly_mul_middle_precache(F_mpz_poly_t res, const F_mpz_poly_t poly1,
+                                   F_mpz_poly_precache_t pre, const ulong trunc);
+
+/*===============================================================================
+
+	Dot products and matrix products
+
+================================================================================*/
+
+/**
+   \fn     void _F_mpz_poly_mat_mul(F_mpz_poly_struct ** C,
+                     const F_mpz_poly_struct ** A, const F_mpz_poly_struct ** B,
+                                           const ulong r, const ulong s, const ulong t)
+   \brief  Set C to the product of the r x s matrix A and the s x t matrix B,
+           all given as arrays of pointers to polynomials, stored row by row.
+           The entries of C may alias entries of A and B. When the products
+           would be done by Schoenhage-Strassen multiplication each entry of A
+           and B is transformed once, the products are summed in the Fourier
+           domain and one inverse transform is done per entry of C. 2 x 2
+           products also use the Strassen-Winograd formulae in the Fourier
+           domain.
+*/
+void _F_mpz_poly_mat_mul(F_mpz_poly_struct ** C,
+                     const F_mpz_poly_struct ** A, const F_mpz_poly_struct ** B,
+                                           const ulong r, const ulong s, const ulong t);
+
+/**
+   \fn     void F_mpz_poly_mat_mul(F_mpz_poly_struct * C, const F_mpz_poly_struct * A,
+                const F_mpz_poly_struct * B, const ulong r, const ulong s, const ulong t)
+   \brief  As for _F_mpz_poly_mat_mul but with the matrices given as arrays of
+           polynomials, stored row by row.
+*/
+void F_mpz_poly_mat_mul(F_mpz_poly_struct * C, const F_mpz_poly_struct * A,
+                const F_mpz_poly_struct * B, const ulong r, const ulong s, const ulong t);
+
+/**
+   \fn     void F_mpz_poly_dot(F_mpz_poly_t res, const F_mpz_poly_struct * a,
+                                        const F_mpz_poly_struct * b, const ulong n)
+   \brief  Set res to the sum of a[i]*b[i] for i in [0, n).
+*/
+void F_mpz_poly_dot(F_mpz_poly_t res, const F_mpz_poly_struct * a,
+                                        const F_mpz_poly_struct * b, const ulong n);
+
 /*===============================================================================
 
 	Powering
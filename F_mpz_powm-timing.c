@@ -0,0 +1,157 @@
+/*============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+===============================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "F_mpz.h"
+#include "profiler.h"
+
+#define BATCH 64 // number of exponentiations timed for each modulus size
+
+/*
+   For moduli of the given number of bits and exponents of the same size,
+   prints the time in microseconds per exponentiation of mpz_powm,
+   F_mpz_powm_ctx, F_mpz_powm_fixed and F_mpz_powm_batch. The results are
+   checked against mpz_powm.
+*/
+void time_powm(ulong bits, gmp_randstate_t state)
+{
+   mpz_t n, m, r;
+   mpz_t g[BATCH], e[BATCH];
+   F_mpz_t fn;
+   F_mpz fg[BATCH], fe[BATCH], fr[BATCH];
+   F_mpz_mod_ctx_t ctx;
+   F_mpz_powm_fixed_t pre;
+   timeit_t t0, t1, t2, t3;
+   ulong i, reps = 1;
+   int ok = 1;
+
+   mpz_init(n);
+   mpz_init(m);
+   mpz_init(r);
+   F_mpz_init(fn);
+
+   mpz_urandomb(n, state, bits);
+   mpz_setbit(n, bits - 1);
+   mpz_setbit(n, 0);
+   F_mpz_set_mpz(fn, n);
+
+   for (i = 0; i < BATCH; i++)
+   {
+      mpz_init(g[i]);
+      mpz_init(e[i]);
+      mpz_urandomm(g[i], state, n);
+      mpz_urandomb(e[i], state, bits);
+      F_mpz_init(fg + i);
+      F_mpz_init(fe + i);
+      F_mpz_init(fr + i);
+      F_mpz_set_mpz(fg + i, g[i]);
+      F_mpz_set_mpz(fe + i, e[i]);
+   }
+
+   F_mpz_mod_ctx_init(ctx, fn);
+   F_mpz_powm_fixed_init(pre, fg, bits, ctx);
+
+   // repeat small cases so that the timings are meaningful
+   if (bits < 1000) reps = 1000/bits + 1;
+   reps = reps*reps;
+
+   timeit_start(t0);
+   ulong j;
+   for (j = 0; j < reps; j++)
+      for (i = 0; i < BATCH; i++)
+         mpz_powm(r, g[i], e[i], n);
+   timeit_stop(t0);
+
+   timeit_start(t1);
+   for (j = 0; j < reps; j++)
+      for (i = 0; i < BATCH; i++)
+         F_mpz_powm_ctx(fr + i, fg + i, fe + i, ctx);
+   timeit_stop(t1);
+
+   for (i = 0; i < BATCH; i++)
+   {
+      mpz_powm(r, g[i], e[i], n);
+      F_mpz_get_mpz(m, fr + i);
+      ok &= (mpz_cmp(r, m) == 0);
+   }
+
+   timeit_start(t2);
+   for (j = 0; j < reps; j++)
+      for (i = 0; i < BATCH; i++)
+         F_mpz_powm_fixed(fr + i, fe + i, pre);
+   timeit_stop(t2);
+
+   for (i = 0; i < BATCH; i++)
+   {
+      mpz_powm(r, g[0], e[i], n);
+      F_mpz_get_mpz(m, fr + i);
+      ok &= (mpz_cmp(r, m) == 0);
+   }
+
+   timeit_start(t3);
+   for (j = 0; j < reps; j++)
+      F_mpz_powm_batch(fr, fg, fe, BATCH, ctx);
+   timeit_stop(t3);
+
+   for (i = 0; i < BATCH; i++)
+   {
+      mpz_powm(r, g[i], e[i], n);
+      F_mpz_get_mpz(m, fr + i);
+      ok &= (mpz_cmp(r, m) == 0);
+   }
+
+   double scale = 1000.0/(reps*BATCH);
+   printf("bits = %6ld: mpz_powm %10.2f us, powm_ctx %10.2f us, powm_fixed %10.2f us, powm_batch %10.2f us (wall)%s\n",
+      bits, t0->cpu*scale, t1->cpu*scale, t2->cpu*scale, t3->wall*scale, ok ? "" : " FAIL!");
+
+   F_mpz_powm_fixed_clear(pre);
+   F_mpz_mod_ctx_clear(ctx);
+
+   for (i = 0; i < BATCH; i++)
+   {
+      mpz_clear(g[i]);
+      mpz_clear(e[i]);
+      F_mpz_clear(fg + i);
+      F_mpz_clear(fe + i);
+      F_mpz_clear(fr + i);
+   }
+
+   F_mpz_clear(fn);
+   mpz_clear(n);
+   mpz_clear(m);
+   mpz_clear(r);
+}
+
+int main(void)
+{
+   gmp_randstate_t state;
+   gmp_randinit_default(state);
+
+   ulong bits;
+   for (bits = 32; bits <= 8192; bits *= 2)
+      time_powm(bits, state);
+
+   gmp_randclear(state);
+   _F_mpz_cleanup();
+
+   return 0;
+}
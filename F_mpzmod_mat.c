@@ -47,10 +47,10 @@ void F_mpzmod_mat_init(F_mpzmod_mat_t mat, F_mpz_t p, ulong rows, ulong cols)
    for (i = 0; i < rows; i++)
       mat->rows[i] = mat->entries + i*cols;
 
-	ulong i;
 	for (i = 0; i < rows*cols; i++)
 		F_mpz_init(mat->entries + i);
 
+   F_mpz_init(mat->p);
    F_mpz_set(mat->p, p);
 	mat->r = rows;
    mat->c = cols;
@@ -61,6 +61,7 @@ void F_mpzmod_mat_clear(F_mpzmod_mat_t mat)
    ulong i;
    for (i = 0; i < mat->r*mat->c; i++)
 		F_mpz_clear(mat->entries + i);
+	F_mpz_clear(mat->p);
 	flint_heap_free(mat->rows);
    flint_heap_free(mat->entries);
 }
@@ -149,7 +150,6 @@ void F_mpzmod_mat_mul_classical(F_mpzmod_mat_t res, F_mpzmod_mat_t mat1, F_mpzmo
 	for (i = 0; i < c2; i++)
 		F_mpz_init(temp + i);
 	
-   ulong i;
    for (i = 0; i < r1; i++) // for each row of mat1
 	{
 		F_mpz * c = mat1->rows[i];
@@ -161,21 +161,18 @@ void F_mpzmod_mat_mul_classical(F_mpzmod_mat_t res, F_mpzmod_mat_t mat1, F_mpzmo
 		ulong j;
 		for (j = 1; j < c1; j++) // compute scalar product for rows 1 to c1 of mat2
 		{
-         ulong k;
          for (k = 0; k < c2; k++) // do scalar product of row j of mat2 by c
 		   {
             F_mpz_addmul(temp + k, mat2->rows[j] + k, c + j);
          }
 		}
 			   
-		ulong k;
 		for (k = 0; k < c2; k++) // do reduction mod p and store in result
 	   {
 		   F_mpz_mod(res->rows[i] + k, temp + k, mat1->p);
 		}
 	}
 
-	ulong i;
 	for (i = 0; i < c2; i++)
 		F_mpz_clear(temp + i);
 
@@ -470,10 +470,10 @@ void zmod_poly_test_all()
 
 #if TESTFILE
 #endif
-   /*RUN_TEST(F_zmod_mat_convert); 
+   RUN_TEST(F_zmod_mat_convert); 
    RUN_TEST(F_zmod_mat_add); 
    RUN_TEST(F_zmod_mat_sub); 
-   RUN_TEST(F_zmod_mat_neg); */
+   RUN_TEST(F_zmod_mat_neg); 
    RUN_TEST(F_zmod_mat_mul_classical); 
    //RUN_TEST(F_zmod_mat_mul_strassen); 
    
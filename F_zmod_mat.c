@@ -113,127 +113,132 @@ void F_zmod_mat_clear(F_zmod_mat_t mat)
 
 void F_zmod_mat_to_F_mpzmod_mat(F_mpzmod_mat_t res, F_zmod_mat_t mat)
 {
+	ulong * row = (ulong *) flint_stack_alloc(mat->c);
+	
 	ulong i;
 	for (i = 0; i < mat->r; i++)
 	{
-		pv_iter_s i1;
-		PV_ITER_INIT(i1, mat->arr, mat->rows[i]); // row i for mat
-      ulong d;
+		pv_get_vec(row, &mat->arr, mat->rows[i], mat->c); // row i for mat
 		
 		ulong j;
 		for (j = 0; j < mat->c; j++)
-		{
-			PV_GET_NEXT(d, i1);
-			F_mpz_set_ui(res->rows[i] + j, d);
-		}
+			F_mpz_set_ui(res->rows[i] + j, row[j]);
 	}
+
+	flint_stack_release(); // row
 }
 
 void F_mpzmod_mat_to_F_zmod_mat(F_zmod_mat_t res, F_mpzmod_mat_t mat)
 {
+	ulong * row = (ulong *) flint_stack_alloc(mat->c);
+	
 	ulong i;
 	for (i = 0; i < mat->r; i++)
 	{
-		pv_iter_s i1;
-		PV_ITER_INIT(i1, res->arr, res->rows[i]); // row i for res
-      ulong d;
-		
 		ulong j;
 		for (j = 0; j < mat->c; j++)
-		{
-			d = F_mpz_get_ui(mat->rows[i] + j);
-			PV_SET_NEXT(i1, d);	
-		}
+			row[j] = F_mpz_get_ui(mat->rows[i] + j);
+		
+		pv_set_vec(&res->arr, res->rows[i], row, mat->c); // row i for res
 	}
 
+	flint_stack_release(); // row
 }
 
 /*******************************************************************************************
 
    Arithmetic
 
+   Rows are unpacked into temporary arrays, operated on and packed again.
+
 *******************************************************************************************/
 
 void F_zmod_mat_add(F_zmod_mat_t res, F_zmod_mat_t mat1, F_zmod_mat_t mat2)
 {
 	ulong p = mat1->p;
+	ulong c = mat1->c;
+	
+	ulong * row1 = (ulong *) flint_stack_alloc(c);
+	ulong * row2 = (ulong *) flint_stack_alloc(c);
 	
 	ulong i;
 	for (i = 0; i < mat1->r; i++)
 	{
-		ulong m1, m2;
-		pv_iter_s i1, i2, i3;
-		PV_ITER_INIT(i1, mat1->arr, mat1->rows[i]); // row i for mat1
-      PV_ITER_INIT(i2, mat2->arr, mat2->rows[i]); // row i for mat2
-      PV_ITER_INIT(i3, res->arr, res->rows[i]); // row i for res
-      ulong j;
-      for (j = 0; j < mat1->c; j++)
-		{
-			PV_GET_NEXT(m1, i1);
-			PV_GET_NEXT(m2, i2);
-			PV_SET_NEXT(i3, z_addmod(m1, m2, p));
-		}
+		pv_get_vec(row1, &mat1->arr, mat1->rows[i], c); // row i for mat1
+		pv_get_vec(row2, &mat2->arr, mat2->rows[i], c); // row i for mat2
+      
+		ulong j;
+      for (j = 0; j < c; j++)
+			row1[j] = z_addmod(row1[j], row2[j], p);
+
+		pv_set_vec(&res->arr, res->rows[i], row1, c); // row i for res
 	}
+
+	flint_stack_release(); // row2
+	flint_stack_release(); // row1
 }
 
 void F_zmod_mat_sub(F_zmod_mat_t res, F_zmod_mat_t mat1, F_zmod_mat_t mat2)
 {
 	ulong p = mat1->p;
+	ulong c = mat1->c;
+	
+	ulong * row1 = (ulong *) flint_stack_alloc(c);
+	ulong * row2 = (ulong *) flint_stack_alloc(c);
 	
 	ulong i;
 	for (i = 0; i < mat1->r; i++)
 	{
-		ulong m1, m2;
-		pv_iter_s i1, i2, i3;
-		PV_ITER_INIT(i1, mat1->arr, mat1->rows[i]); // row i for mat1
-      PV_ITER_INIT(i2, mat2->arr, mat2->rows[i]); // row i for mat2
-      PV_ITER_INIT(i3, res->arr, res->rows[i]); // row i for res
-      ulong j;
-      for (j = 0; j < mat1->c; j++)
-		{
-			PV_GET_NEXT(m1, i1);
-			PV_GET_NEXT(m2, i2);
-			PV_SET_NEXT(i3, z_submod(m1, m2, p));
-		}
+		pv_get_vec(row1, &mat1->arr, mat1->rows[i], c); // row i for mat1
+		pv_get_vec(row2, &mat2->arr, mat2->rows[i], c); // row i for mat2
+      
+		ulong j;
+      for (j = 0; j < c; j++)
+			row1[j] = z_submod(row1[j], row2[j], p);
+
+		pv_set_vec(&res->arr, res->rows[i], row1, c); // row i for res
 	}
+
+	flint_stack_release(); // row2
+	flint_stack_release(); // row1
 }
 
 void F_zmod_mat_neg(F_zmod_mat_t res, F_zmod_mat_t mat1)
 {
 	ulong p = mat1->p;
+	ulong c = mat1->c;
+	
+	ulong * row1 = (ulong *) flint_stack_alloc(c);
 	
 	ulong i;
 	for (i = 0; i < mat1->r; i++)
 	{
-		ulong m1;
-		pv_iter_s i1, i2;
-		PV_ITER_INIT(i1, mat1->arr, mat1->rows[i]); // row i for mat1
-      PV_ITER_INIT(i2, res->arr, res->rows[i]); // row i for res
-      ulong j;
-      for (j = 0; j < mat1->c; j++)
-		{
-			PV_GET_NEXT(m1, i1);
-			PV_SET_NEXT(i2, z_negmod(m1, p));
-		}
+		pv_get_vec(row1, &mat1->arr, mat1->rows[i], c); // row i for mat1
+      
+		ulong j;
+      for (j = 0; j < c; j++)
+			row1[j] = z_negmod(row1[j], p);
+
+		pv_set_vec(&res->arr, res->rows[i], row1, c); // row i for res
 	}
+
+	flint_stack_release(); // row1
 }
 
 void F_zmod_mat_set(F_zmod_mat_t res, F_zmod_mat_t mat)
 {
+	ulong c = mat->c;
+	
+	ulong * row1 = (ulong *) flint_stack_alloc(c);
+	
 	ulong i;
 	for (i = 0; i < mat->r; i++)
 	{
-		ulong m1;
-		pv_iter_s i1, i2;
-		PV_ITER_INIT(i1, mat->arr, mat->rows[i]); // row i for mat1
-      PV_ITER_INIT(i2, res->arr, res->rows[i]); // row i for res
-      ulong j;
-      for (j = 0; j < mat->c; j++)
-		{
-			PV_GET_NEXT(m1, i1);
-			PV_SET_NEXT(i2, m1);
-		}
+		pv_get_vec(row1, &mat->arr, mat->rows[i], c); // row i for mat
+		pv_set_vec(&res->arr, res->rows[i], row1, c); // row i for res
 	}
+
+	flint_stack_release(); // row1
 }
 
 void F_zmod_mat_mul_classical(F_zmod_mat_t res, F_zmod_mat_t mat1, F_zmod_mat_t mat2)
@@ -315,15 +320,10 @@ void F_zmod_mat_mul_classical(F_zmod_mat_t res, F_zmod_mat_t mat1, F_zmod_mat_t
 				}
 		   }
 
-		   pv_iter_s iter3;
-		   PV_ITER_INIT(iter3, res->arr, res->rows[i]); // iterate along row i of res
-         ulong r;
-			ulong k;
-			for (k = 0; k < 2*c2; k+=2) // store row i of res
-			{
-				r = z_ll_mod_precomp(temp[k+1], temp[k], p, pinv); // reduce mod p
-			   PV_SET_NEXT(iter3, r);
-			}
+			for (k = 0; k < c2; k++) // reduce mod p
+				temp2[k] = z_ll_mod_precomp(temp[2*k+1], temp[2*k], p, pinv); 
+			
+			pv_set_vec(&res->arr, res->rows[i], temp2, c2); // store row i of res
 	   }
 		
 	   flint_stack_release(); // temp2
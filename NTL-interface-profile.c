@@ -0,0 +1,257 @@
+/*============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+===============================================================================*/
+/****************************************************************************
+
+NTL-interface-profile.c
+
+Profiling for conversion between NTL and FLINT format. Each target is run
+with the bulk converters of NTL-interface and, for comparison, with a loop
+calling ZZ_to_F_mpz or F_mpz_to_ZZ for one coefficient at a time, which is
+how polynomials were converted before the bulk converters existed.
+
+*****************************************************************************/
+
+#include <string.h>
+#include <math.h>
+#include <gmp.h>
+#include "profiler-main.h"
+#include "flint.h"
+#include "memory-manager.h"
+#include "F_mpz.h"
+#include "F_mpz_poly.h"
+#include "test-support.h"
+
+#include <NTL/ZZX.h>
+#include <NTL/ZZ.h>
+#include <stdio.h>
+
+#include "NTL-interface.h"
+
+//=============================================================================
+
+NTL_CLIENT
+
+#define CONVERT_COEFFS 0 // one coefficient at a time
+#define CONVERT_BULK 1   // the bulk converters
+
+/*
+Calls prof2d_sample(length, bits, arg) for all length, bits combinations
+such that length*bits < max_bits, with length and bits spaced out by
+the given ratio
+*/
+
+void run_triangle(unsigned long max_bits, double ratio, void * arg)
+{
+   int max_iter = (int) ceil(log((double) max_bits) / log(ratio));
+
+   unsigned long last_length = 0;
+   unsigned long i;
+   for (i = 0; i <= max_iter; i++)
+   {
+      unsigned long length = (unsigned long) floor(powl(ratio, i));
+      if (length != last_length)
+      {
+         last_length = length;
+
+         unsigned long last_bits = 0;
+         unsigned long j;
+         for (j = 0; j <= max_iter; j++)
+         {
+            unsigned long bits = (unsigned long) floor(powl(ratio, j));
+            if (bits != last_bits)
+            {
+               last_bits = bits;
+
+               if (bits * length < max_bits)
+                  prof2d_sample(length, bits, arg);
+            }
+         }
+      }
+   }
+}
+
+// ============================================================================
+
+void F_mpz_poly_random_signed(F_mpz_poly_t poly, ulong length, ulong bits)
+{
+   F_mpz_t c;
+   F_mpz_init(c);
+
+   F_mpz_poly_zero(poly);
+   for (ulong i = 0; i < length; i++)
+   {
+      F_mpz_random(c, bits);
+      if (z_randint(2)) F_mpz_neg(c, c);
+      F_mpz_poly_set_coeff(poly, i, c);
+   }
+
+   F_mpz_clear(c);
+}
+
+// ============================================================================
+
+void sample_ZZX_to_F_mpz_poly(unsigned long length, unsigned long bits,
+                          void* arg, unsigned long count)
+{
+   int type = *(int *) arg;
+   F_mpz_poly_t poly1, poly2;
+   ZZX zpoly;
+   F_mpz_t c;
+
+   F_mpz_poly_init(poly1);
+   F_mpz_poly_init(poly2);
+   F_mpz_init(c);
+
+   unsigned long r_count;    // how often to generate new random data
+
+   if (count >= 1000) r_count = 100;
+   else if (count >= 100) r_count = 10;
+   else if (count >= 20) r_count = 5;
+   else if (count >= 8) r_count = 2;
+   else r_count = 1;
+
+   unsigned long i;
+   for (i = 0; i < count; i++)
+   {
+      if (i%r_count == 0)
+      {
+         F_mpz_poly_random_signed(poly1, length, bits);
+         F_mpz_poly_to_ZZX(zpoly, poly1);
+      }
+
+      prof_start();
+      if (type == CONVERT_BULK)
+         ZZX_to_F_mpz_poly(poly2, zpoly);
+      else
+      {
+         F_mpz_poly_zero(poly2);
+         for (long j = 0; j <= deg(zpoly); j++)
+         {
+            ZZ_to_F_mpz(c, zpoly.rep[j]);
+            F_mpz_poly_set_coeff(poly2, j, c);
+         }
+      }
+      prof_stop();
+   }
+
+   F_mpz_poly_clear(poly1);
+   F_mpz_poly_clear(poly2);
+   F_mpz_clear(c);
+}
+
+char* profDriverString_ZZX_to_F_mpz_poly(char* params)
+{
+   return "ZZX_to_F_mpz_poly over various lengths and various bit sizes.\n"
+   "Parameters are: max bitsize; ratio between consecutive lengths/bitsizes;\n"
+   "1 for the bulk converter or 0 for coefficient by coefficient conversion.";
+}
+
+char* profDriverDefaultParams_ZZX_to_F_mpz_poly()
+{
+   return "1000000 1.2 1";
+}
+
+void profDriver_ZZX_to_F_mpz_poly(char* params)
+{
+   unsigned long max_bits;
+   double ratio;
+   int type;
+
+   sscanf(params, "%ld %lf %d", &max_bits, &ratio, &type);
+
+   test_support_init();
+   prof2d_set_sampler(sample_ZZX_to_F_mpz_poly);
+   run_triangle(max_bits, ratio, &type);
+   test_support_cleanup();
+}
+
+// ============================================================================
+
+void sample_F_mpz_poly_to_ZZX(unsigned long length, unsigned long bits,
+                          void* arg, unsigned long count)
+{
+   int type = *(int *) arg;
+   F_mpz_poly_t poly;
+   ZZX zpoly;
+   ZZ c;
+
+   F_mpz_poly_init(poly);
+
+   unsigned long r_count;    // how often to generate new random data
+
+   if (count >= 1000) r_count = 100;
+   else if (count >= 100) r_count = 10;
+   else if (count >= 20) r_count = 5;
+   else if (count >= 8) r_count = 2;
+   else r_count = 1;
+
+   unsigned long i;
+   for (i = 0; i < count; i++)
+   {
+      if (i%r_count == 0)
+      {
+         F_mpz_poly_random_signed(poly, length, bits);
+         zpoly = 0;
+      }
+
+      prof_start();
+      if (type == CONVERT_BULK)
+         F_mpz_poly_to_ZZX(zpoly, poly);
+      else
+      {
+         for (ulong j = 0; j < poly->length; j++)
+         {
+            F_mpz_to_ZZ(c, poly->coeffs + j);
+            SetCoeff(zpoly, j, c);
+         }
+      }
+      prof_stop();
+   }
+
+   F_mpz_poly_clear(poly);
+}
+
+char* profDriverString_F_mpz_poly_to_ZZX(char* params)
+{
+   return "F_mpz_poly_to_ZZX over various lengths and various bit sizes.\n"
+   "Parameters are: max bitsize; ratio between consecutive lengths/bitsizes;\n"
+   "1 for the bulk converter or 0 for coefficient by coefficient conversion.";
+}
+
+char* profDriverDefaultParams_F_mpz_poly_to_ZZX()
+{
+   return "1000000 1.2 1";
+}
+
+void profDriver_F_mpz_poly_to_ZZX(char* params)
+{
+   unsigned long max_bits;
+   double ratio;
+   int type;
+
+   sscanf(params, "%ld %lf %d", &max_bits, &ratio, &type);
+
+   test_support_init();
+   prof2d_set_sampler(sample_F_mpz_poly_to_ZZX);
+   run_triangle(max_bits, ratio, &type);
+   test_support_cleanup();
+}
+
+// end of file ****************************************************************
@@ -39,6 +39,7 @@ Copyright (C) 2007, William Hart
 #include "fmpz.h"
 #include "F_mpz.h"
 #include "F_mpz_mat.h"
+#include "F_mpz_poly.h"
 #include "fmpz_poly.h"
 
 #include "flint.h"
@@ -233,6 +234,169 @@ int test_ZZ_to_F_mpz()
 	return result;
 }
 
+// random F_mpz which is near the boundary between small and large values
+// with high probability
+void F_mpz_random_boundary(F_mpz_t f)
+{
+   switch (z_randint(4))
+   {
+   case 0:
+      F_mpz_set_ui(f, COEFF_MAX - z_randint(3));
+      break;
+   case 1:
+      F_mpz_set_ui(f, COEFF_MAX + z_randint(3));
+      break;
+   case 2:
+      F_mpz_set_ui(f, z_randbits(FLINT_BITS));
+      break;
+   default:
+      F_mpz_random(f, z_randint(300));
+   }
+   
+   if (z_randint(2)) F_mpz_neg(f, f);
+}
+
+int test_ZZ_vec_to_F_mpz_vec()
+{
+   int result = 1;
+   ulong n;
+   
+   for (unsigned long i = 0; (i < 20000) && (result == 1); i++)
+   {
+      n = z_randint(50);
+
+      F_mpz * vec1 = (F_mpz *) flint_heap_alloc(n + 1);
+      F_mpz * vec2 = (F_mpz *) flint_heap_alloc(n + 1);
+      
+      ZZ * zvec = new ZZ[n + 1];
+
+      for (ulong j = 0; j < n; j++)
+      {
+         F_mpz_init(vec1 + j);
+         F_mpz_init(vec2 + j);
+         F_mpz_random_boundary(vec1 + j);
+         
+         // the output may already hold a value of either size
+         F_mpz_random_boundary(vec2 + j);
+         if (z_randint(2)) F_mpz_to_ZZ(zvec[j], vec2 + j);
+      }
+
+      F_mpz_vec_to_ZZ_vec(zvec, vec1, n);
+      ZZ_vec_to_F_mpz_vec(vec2, zvec, n);
+      
+      for (ulong j = 0; (j < n) && result; j++)
+      {
+         result = F_mpz_equal(vec1 + j, vec2 + j);
+
+         // small values must be stored directly
+         if (F_mpz_bits(vec1 + j) <= FLINT_BITS - 2) 
+            result &= !COEFF_IS_MPZ(vec2[j]);
+
+         // agrees with the single conversions
+         ZZ z;
+         F_mpz_to_ZZ(z, vec1 + j);
+         result &= (z == zvec[j]);
+      }
+      
+      for (ulong j = 0; j < n; j++)
+      {
+         F_mpz_clear(vec1 + j);
+         F_mpz_clear(vec2 + j);
+      }
+      
+      delete[] zvec;
+      flint_heap_free(vec1);
+      flint_heap_free(vec2);
+   }
+
+	return result;
+}
+
+int test_ZZ_get_mpz_view()
+{
+   int result = 1;
+   mpz_t m, view, prod1, prod2;
+   F_mpz_t f;
+   
+   mpz_init(m);
+   mpz_init(prod1);
+   mpz_init(prod2);
+   F_mpz_init(f);
+
+   for (unsigned long i = 0; (i < 100000) && (result == 1); i++)
+   {
+      ZZ z;
+      
+      F_mpz_random_boundary(f);
+      if (z_randint(10) == 0) F_mpz_zero(f);
+      F_mpz_to_ZZ(z, f);
+      F_mpz_get_mpz(m, f);
+
+      ZZ_get_mpz_view(view, z);
+      result = (mpz_cmp(view, m) == 0);
+
+      const mp_limb_t * zp = ZZ_limbs_ptr(z);
+      ulong limbs = ZZ_limbs(z);
+      if (limbs == 0) result &= (zp == NULL);
+      else result &= (limbs == mpz_size(m)) && (mpn_cmp(zp, m->_mp_d, limbs) == 0);
+      
+      // the view may be used as an input
+      mpz_mul(prod1, view, view);
+      mpz_mul(prod2, m, m);
+      result &= (mpz_cmp(prod1, prod2) == 0);
+   }
+
+   mpz_clear(m);
+   mpz_clear(prod1);
+   mpz_clear(prod2);
+   F_mpz_clear(f);
+
+	return result;
+}
+
+int test_ZZX_to_F_mpz_poly()
+{
+   mpz_poly_t test_poly;
+   F_mpz_poly_t F_poly, F_poly2;
+   fmpz_poly_t f_poly;
+   int result = 1;
+   unsigned long bits, length;
+   
+   mpz_poly_init(test_poly); 
+   F_mpz_poly_init(F_poly2);
+   for (unsigned long count1 = 1; (count1 < 10000) && (result == 1) ; count1++)
+   {
+      bits = random_ulong(200) + 1;
+      length = random_ulong(100);
+
+      F_mpz_poly_init(F_poly);
+      fmpz_poly_init(f_poly);
+
+      ZZX ZZX_poly, ZZX_poly2;
+
+      randpoly(test_poly, length, bits);
+      mpz_poly_normalise(test_poly);
+      mpz_poly_to_F_mpz_poly(F_poly, test_poly);
+      mpz_poly_to_fmpz_poly(f_poly, test_poly);
+
+      F_mpz_poly_to_ZZX(ZZX_poly, F_poly);
+      fmpz_poly_to_ZZX(ZZX_poly2, f_poly);
+      result = (ZZX_poly == ZZX_poly2);
+
+      // F_poly2 holds the previous polynomial, which may be longer
+      ZZX_to_F_mpz_poly(F_poly2, ZZX_poly);
+      result &= F_mpz_poly_equal(F_poly, F_poly2);
+          
+      F_mpz_poly_clear(F_poly);
+      fmpz_poly_clear(f_poly);
+   }
+   
+   mpz_poly_clear(test_poly);
+   F_mpz_poly_clear(F_poly2);
+   
+   return result;
+}
+
 int test_ZZX_to_fmpz_poly()
 {
    mpz_poly_t test_poly;
@@ -298,7 +462,7 @@ int test_mat_ZZ_to_F_mpz_mat()
       F_mpz_mat_init(mat2, r, c);
 
 		mat_ZZ zmat;
-		zmat.SetDims(r, c);
+		if (z_randint(2)) zmat.SetDims(r, c); // otherwise set by the conversion
       
       F_mpz_randmat(mat1, r, c, bits);
       
@@ -321,7 +485,10 @@ void fmpz_poly_test_all()
 
    RUN_TEST(ZZ_to_fmpz); 
    RUN_TEST(ZZ_to_F_mpz); 
+   RUN_TEST(ZZ_vec_to_F_mpz_vec); 
+   RUN_TEST(ZZ_get_mpz_view); 
    RUN_TEST(ZZX_to_fmpz_poly); 
+   RUN_TEST(ZZX_to_F_mpz_poly); 
 	RUN_TEST(mat_ZZ_to_F_mpz_mat);
    
    printf(all_success ? "\nAll tests passed\n" :
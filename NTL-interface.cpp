@@ -39,6 +39,7 @@ Copyright (C) 2007, William Hart
 #include "fmpz.h"
 #include "F_mpz.h"
 #include "F_mpz_mat.h"
+#include "F_mpz_poly.h"
 #include "fmpz_poly.h"
 #include "NTL-interface.h"
 
@@ -70,6 +71,97 @@ unsigned long ZZX_maxlimbs(const ZZX& z)
    return maxlimbs;
 }
 
+const mp_limb_t * ZZ_limbs_ptr(const ZZ& z)
+{
+   if (z.rep && SIZE(z.rep)) return DATA(z.rep);
+   else return NULL;
+}
+
+void ZZ_get_mpz_view(mpz_t view, const ZZ& z)
+{
+   static mp_limb_t zero = 0;
+   _ntl_gbigint x = z.rep;
+
+   if (!x || SIZE(x) == 0)
+   {
+      view->_mp_d = &zero;
+      view->_mp_size = 0;
+      view->_mp_alloc = 0;
+      return;
+   }
+
+   view->_mp_d = DATA(x);
+   view->_mp_size = (int) SIZE(x);
+   view->_mp_alloc = 0;
+}
+
+/*
+   Sets f to the value of the NTL integer x. Values of at most COEFF_MAX in 
+   absolute value are stored directly, otherwise the limbs are copied into
+   the mpz of f, which is reallocated only if it is too small.
+*/
+static inline
+void __ZZ_to_F_mpz(F_mpz * f, _ntl_gbigint x)
+{
+   long size;
+
+   if (!x || (size = SIZE(x)) == 0)
+   {
+      F_mpz_zero(f);
+      return;
+   }
+
+   mp_limb_t * xp = DATA(x);
+
+   if ((size == 1L || size == -1L) && xp[0] <= (mp_limb_t) COEFF_MAX)
+   {
+      _F_mpz_demote(f);
+      *f = (size > 0) ? (long) xp[0] : -(long) xp[0];
+      return;
+   }
+
+   ulong limbs = FLINT_ABS(size);
+   __mpz_struct * mpz_ptr = _F_mpz_promote(f);
+   mp_limb_t * d = mpz_ptr->_mp_d;
+   
+   if ((ulong) mpz_ptr->_mp_alloc < limbs) 
+      d = (mp_limb_t *) _mpz_realloc(mpz_ptr, limbs);
+   F_mpn_copy(d, xp, limbs);
+   mpz_ptr->_mp_size = size;
+}
+
+/*
+   Sets the NTL integer *x to the value of f. A small f is written as a 
+   single limb without going through an mpz.
+*/
+static inline
+void __F_mpz_to_ZZ(_ntl_gbigint * x, const F_mpz * f)
+{
+   F_mpz d = *f;
+
+   if (d == 0L)
+   {
+      if (*x) SIZE(*x) = 0;
+      return;
+   }
+
+   if (!COEFF_IS_MPZ(d))
+   {
+      _ntl_gsetlength(x, 1);
+      DATA(*x)[0] = FLINT_ABS(d);
+      SIZE(*x) = (d < 0L) ? -1L : 1L;
+      return;
+   }
+
+   __mpz_struct * mpz_ptr = F_mpz_ptr_mpz(d);
+   long size = mpz_ptr->_mp_size;
+   ulong limbs = FLINT_ABS(size);
+
+   _ntl_gsetlength(x, limbs);
+   F_mpn_copy(DATA(*x), mpz_ptr->_mp_d, limbs);
+   SIZE(*x) = size;
+}
+
 void ZZ_to_fmpz(fmpz_t output, const ZZ& z)
 {
    _ntl_gbigint x = z.rep;
@@ -91,20 +183,7 @@ void ZZ_to_fmpz(fmpz_t output, const ZZ& z)
 
 void ZZ_to_F_mpz(F_mpz_t output, const ZZ& z)
 {
-   _ntl_gbigint x = z.rep;
-   
-   if (!x) 
-   {
-      F_mpz_zero(output);
-      return;
-   }
-   
-   unsigned long lw = ZZ_limbs(z);
-   mp_limb_t * xp = DATA(x);
-
-   F_mpz_set_limbs(output, xp, lw);
-   
-   if (z < 0L) F_mpz_neg(output, output);
+   __ZZ_to_F_mpz(output, z.rep);
 }
 
 void fmpz_to_ZZ(ZZ& output, const fmpz_t z)
@@ -130,23 +209,19 @@ void fmpz_to_ZZ(ZZ& output, const fmpz_t z)
 
 void F_mpz_to_ZZ(ZZ& output, const F_mpz_t z)
 {
-   mp_limb_t *xp;
-   _ntl_gbigint *x = &output.rep;
-   long lw = F_mpz_size(z);
-   
-   if (lw == 0) 
-	{
-      if (*x) SIZE(*x) = 0;
-      return;
-   }
+   __F_mpz_to_ZZ(&output.rep, z);
+}
 
-   _ntl_gsetlength(x, lw); 
-   xp = DATA(*x);
+void ZZ_vec_to_F_mpz_vec(F_mpz * res, const ZZ * vec, ulong n)
+{
+   for (ulong i = 0; i < n; i++)
+      __ZZ_to_F_mpz(res + i, vec[i].rep);
+}
 
-	F_mpz_get_limbs(xp, z);
-	
-   if (F_mpz_sgn(z) < 0) SIZE(*x) = -lw;
-   else SIZE(*x) = lw;
+void F_mpz_vec_to_ZZ_vec(ZZ * res, const F_mpz * vec, ulong n)
+{
+   for (ulong i = 0; i < n; i++)
+      __F_mpz_to_ZZ(&res[i].rep, vec + i);
 }
 
 void fmpz_poly_to_ZZX(ZZX& output, const fmpz_poly_t poly)
@@ -198,16 +273,36 @@ void ZZX_to_fmpz_poly(fmpz_poly_t output, const ZZX& poly)
    }
 }
 
+void F_mpz_poly_to_ZZX(ZZX& output, const F_mpz_poly_t poly)
+{
+   ulong length = poly->length;
+
+   if (length == 0)
+   {
+      output = 0;
+      return;
+   }
+
+   output.rep.SetLength(length);
+   F_mpz_vec_to_ZZ_vec(output.rep.elts(), poly->coeffs, length);
+}
+
+void ZZX_to_F_mpz_poly(F_mpz_poly_t output, const ZZX& poly)
+{
+   ulong length = poly.rep.length();
+
+   F_mpz_poly_fit_length(output, length);
+   ZZ_vec_to_F_mpz_vec(output->coeffs, poly.rep.elts(), length);
+   _F_mpz_poly_set_length(output, length);
+}
+
 void mat_ZZ_to_F_mpz_mat(F_mpz_mat_t output, const mat_ZZ& mat)
 {
 	ulong r = mat.NumRows();
 	ulong c = mat.NumCols();
 
 	for (ulong i = 0; i < r; i++)
-		for (ulong j = 0; j < c; j++)
-		{
-			ZZ_to_F_mpz(output->rows[i] + j, mat[i][j]);
-		}
+		ZZ_vec_to_F_mpz_vec(output->rows[i], mat[i].elts(), c);
 }
 
 void F_mpz_mat_to_mat_ZZ(mat_ZZ& output, const F_mpz_mat_t mat)
@@ -215,11 +310,11 @@ void F_mpz_mat_to_mat_ZZ(mat_ZZ& output, const F_mpz_mat_t mat)
 	ulong r = mat->r;
 	ulong c = mat->c;
 
+   if (output.NumRows() != (long) r || output.NumCols() != (long) c)
+      output.SetDims(r, c);
+
 	for (ulong i = 0; i < r; i++)
-		for (ulong j = 0; j < c; j++)
-		{
-			F_mpz_to_ZZ(output[i][j], mat->rows[i] + j);
-		}
+		F_mpz_vec_to_ZZ_vec(output[i].elts(), mat->rows[i], c);
 }
  
 
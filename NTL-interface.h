@@ -40,6 +40,7 @@ Copyright (C) 2007, William Hart
 #include "flint.h"
 #include "F_mpz.h"
 #include "F_mpz_mat.h"
+#include "F_mpz_poly.h"
 #include "fmpz.h"
 #include "fmpz_poly.h"
 
@@ -51,6 +52,24 @@ NTL_CLIENT
 
 unsigned long ZZ_limbs(const ZZ& z);
 
+/*
+   Returns a pointer to the ZZ_limbs(z) limbs of the absolute value of z, 
+   least significant first, or NULL if z is zero. The limbs may be passed
+   directly to mpn functions as an input and remain valid until z is 
+   modified or destroyed.
+*/
+
+const mp_limb_t * ZZ_limbs_ptr(const ZZ& z);
+
+/*
+   Sets view to a read only mpz_t sharing the limbs of z, which may be 
+   passed to GMP and FLINT functions wherever a const mpz_t is accepted.
+   The view must not be modified or cleared and is valid until z is 
+   modified or destroyed.
+*/
+
+void ZZ_get_mpz_view(mpz_t view, const ZZ& z);
+
 /* 
    Convert an NTL ZZ to an fmpz_t
    Assumes the fmpz_t has already been allocated to have sufficient space
@@ -76,6 +95,22 @@ void fmpz_to_ZZ(ZZ& output, const fmpz_t z);
 
 void F_mpz_to_ZZ(ZZ& output, const F_mpz_t z);
 
+/*
+   Convert the n NTL ZZ's in vec to F_mpz's in res. Values which fit in an
+   F_mpz without an mpz_t are set directly, others have their limbs copied
+   into the existing mpz_t of the output, if any, which is only 
+   reallocated if too small.
+*/
+
+void ZZ_vec_to_F_mpz_vec(F_mpz * res, const ZZ * vec, ulong n);
+
+/*
+   Convert the n F_mpz's in vec to the NTL ZZ's in res, which are only
+   reallocated if too small.
+*/
+
+void F_mpz_vec_to_ZZ_vec(ZZ * res, const F_mpz * vec, ulong n);
+
 /*
    Convert an fmpz_poly_t to an NTL ZZX
 */
@@ -88,6 +123,20 @@ void fmpz_poly_to_ZZX(ZZX& output, const fmpz_poly_t poly);
 
 void ZZX_to_fmpz_poly(fmpz_poly_t output, const ZZX& poly);
 
+/*
+   Convert an F_mpz_poly_t to an NTL ZZX, setting the length of the output
+   once and converting all coefficients with F_mpz_vec_to_ZZ_vec
+*/
+
+void F_mpz_poly_to_ZZX(ZZX& output, const F_mpz_poly_t poly);
+
+/*
+   Convert an NTL ZZX to an F_mpz_poly_t, setting the length of the output
+   once and converting all coefficients with ZZ_vec_to_F_mpz_vec
+*/
+
+void ZZX_to_F_mpz_poly(F_mpz_poly_t output, const ZZX& poly);
+
 /*
    Convert an NTL mat_ZZ to an F_mpz_mat_t
 */
@@ -95,7 +144,8 @@ void ZZX_to_fmpz_poly(fmpz_poly_t output, const ZZX& poly);
 void mat_ZZ_to_F_mpz_mat(F_mpz_mat_t output, const mat_ZZ& mat);
 
 /*
-   Convert an F_mpz_mat_t to an NTL mat_ZZ
+   Convert an F_mpz_mat_t to an NTL mat_ZZ, which is given the dimensions
+   of mat if it does not already have them
 */
 void F_mpz_mat_to_mat_ZZ(mat_ZZ& output, const F_mpz_mat_t mat);
 
@@ -29,6 +29,8 @@ Copyright (C) 2007, William Hart and David Harvey
 
 #include "profiler-main.h"
 #include "ZmodF_mul.h"
+#include "ZmodF_poly.h"
+#include "mpn_extras.h"
 #include "flint.h"
 #include <string.h>
 #include <math.h>
@@ -341,4 +343,181 @@ void profDriver_ZmodF_sqr_auto(char* params)
 }
 
 
+// ============================================================================
+
+
+typedef struct
+{
+   unsigned long depth;
+   unsigned long n;
+   int four_step;
+} ZmodF_poly_convolution_arg_t;
+
+
+void sample_ZmodF_poly_convolution(unsigned long x, void* arg, 
+                                   unsigned long count)
+{
+   ZmodF_poly_convolution_arg_t* params = (ZmodF_poly_convolution_arg_t*) arg;
+   unsigned long depth = params->depth;
+   unsigned long n = params->n;
+   unsigned long size = 1UL << depth;
+   unsigned long scratch = params->four_step ? ZmodF_poly_four_step_threads() : 1;
+   
+   ZmodF_poly_t poly1, poly2;
+   ZmodF_poly_init(poly1, depth, n, scratch);
+   ZmodF_poly_init(poly2, depth, n, scratch);
+   
+   unsigned long i;
+   for (i = 0; i < size/2; i++)
+   {
+      profiler_random_limbs(poly1->coeffs[i], n);
+      poly1->coeffs[i][n] = 0;
+      profiler_random_limbs(poly2->coeffs[i], n);
+      poly2->coeffs[i][n] = 0;
+   }
+   
+   prof_start();
+
+   for (i = 0; i < count; i++)
+   {
+      // the convolution is in place, so later iterations run on the output
+      // of earlier ones, which makes no difference to the timing
+      poly1->length = size/2;
+      poly2->length = size/2;
+      if (params->four_step)
+         ZmodF_poly_convolution_four_step(poly1, poly2);
+      else
+         ZmodF_poly_convolution(poly1, poly1, poly2);
+   }
+
+   prof_stop();
+
+   ZmodF_poly_clear(poly2);
+   ZmodF_poly_clear(poly1);
+}
+
+
+void ZmodF_poly_convolution_driver(char* params, int four_step)
+{
+   unsigned long depth_min, depth_max, n;
+   sscanf(params, "%ld %ld %ld", &depth_min, &depth_max, &n);
+
+   prof1d_set_sampler(sample_ZmodF_poly_convolution);
+   
+   ZmodF_poly_convolution_arg_t arg;
+   arg.n = n;
+   arg.four_step = four_step;
+   
+   for (arg.depth = depth_min; arg.depth <= depth_max; arg.depth++)
+   {
+      // need 4*n*FLINT_BITS divisible by 2^depth
+      if ((4*n*FLINT_BITS) % (1UL << arg.depth) == 0)
+         prof1d_sample((1UL << arg.depth)*n, &arg);
+   }
+}
+
+
+char* profDriverString_ZmodF_poly_convolution(char* params)
+{
+   return
+   "ZmodF_poly_convolution, as used by F_mpn_mul.\n"
+   "Parameters: depth_min, depth_max, n.\n"
+   "Note: x is the number of limbs of transform data, 2^depth*n, so the\n"
+   "throughput in limbs per second is x divided by the time.\n";
+}
+
+
+char* profDriverDefaultParams_ZmodF_poly_convolution()
+{
+   return "10 14 256";
+}
+
+
+void profDriver_ZmodF_poly_convolution(char* params)
+{
+   ZmodF_poly_convolution_driver(params, 0);
+}
+
+
+// ============================================================================
+
+
+char* profDriverString_ZmodF_poly_convolution_four_step(char* params)
+{
+   return
+   "ZmodF_poly_convolution_four_step, as used by F_mpn_mul for huge operands.\n"
+   "Parameters: depth_min, depth_max, n.\n"
+   "Note: x is the number of limbs of transform data, 2^depth*n, so the\n"
+   "throughput in limbs per second is x divided by the time.\n";
+}
+
+
+char* profDriverDefaultParams_ZmodF_poly_convolution_four_step()
+{
+   return "10 14 256";
+}
+
+
+void profDriver_ZmodF_poly_convolution_four_step(char* params)
+{
+   ZmodF_poly_convolution_driver(params, 1);
+}
+
+
+// ============================================================================
+
+
+void sample_F_mpn_mul(unsigned long n, void* arg, unsigned long count)
+{
+   mp_limb_t* x1 = (mp_limb_t*) malloc(n * sizeof(mp_limb_t));
+   mp_limb_t* x2 = (mp_limb_t*) malloc(n * sizeof(mp_limb_t));
+   mp_limb_t* x3 = (mp_limb_t*) malloc(2 * n * sizeof(mp_limb_t));
+
+   profiler_random_limbs(x1, n);
+   profiler_random_limbs(x2, n);
+   
+   prof_start();
+
+   unsigned long i;
+   for (i = 0; i < count; i++)
+      F_mpn_mul(x3, x1, n, x2, n);
+
+   prof_stop();
+
+   free(x3);
+   free(x2);
+   free(x1);
+}
+
+
+char* profDriverString_F_mpn_mul(char* params)
+{
+   return
+   "F_mpn_mul on operands of n limbs each.\n"
+   "Parameters: n_min, n_max, n_ratio (in percent).\n"
+   "Note: the four step convolution is used above ZMODFPOLY_FOUR_STEP_THRESHOLD\n"
+   "limbs of transform data. The throughput in limbs per second is n divided\n"
+   "by the time.\n";
+}
+
+
+char* profDriverDefaultParams_F_mpn_mul()
+{
+   return "10000 10000000 150";
+}
+
+
+void profDriver_F_mpn_mul(char* params)
+{
+   unsigned long n_min, n_max, n_ratio;
+   sscanf(params, "%ld %ld %ld", &n_min, &n_max, &n_ratio);
+
+   prof1d_set_sampler(sample_F_mpn_mul);
+   
+   unsigned long n;
+   for (n = n_min; n <= n_max; n = n*n_ratio/100 + 1)
+      prof1d_sample(n, NULL);
+}
+
+
 // end of file ****************************************************************
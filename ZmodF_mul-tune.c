@@ -22,8 +22,10 @@
    
    Program for tuning the ZmodF_mul module.
    
-   This program writes to standard output an automatically tuned version of
-   ZmodF_mul-tuning.c.
+   This program measures the ZmodF_mul crossovers, writes them to standard 
+   output and saves them in the runtime tuning profile (see flint-tuning.h). 
+   The profile file may be given on the command line, otherwise 
+   flint_tuning_filename() is used.
    
    (If DEBUG is set, it also writes logging info to standard error.)
    
@@ -37,6 +39,7 @@
 #include "profiler.h"
 #include "ZmodF_mul.h"
 #include "ZmodF_mul-tuning.h"
+#include "flint-tuning.h"
 
 
 #define DEBUG 1
@@ -254,14 +257,13 @@ int main(int argc, char* argv[])
 
    test_support_init();
 
-   fprintf(fout, "/*\n");
-   fprintf(fout, "   Tuning values for ZmodF_mul module\n");
-   fprintf(fout, "\n");
-   fprintf(fout, "   Automatically generated by ZmodF_mul-tune program\n");
-   fprintf(fout, "*/\n\n");
-   fprintf(fout, "#include \"ZmodF_mul-tuning.h\"\n");
-   fprintf(fout, "#include \"ZmodF_mul.h\"\n");
-   fprintf(fout, "\n");
+   // keep the values for the other modules
+   const char * filename = (argc > 1) ? argv[1] : flint_tuning_filename();
+   if (filename != NULL) flint_tuning_load(filename);
+
+   char cpu[FLINT_TUNING_CPU_LENGTH];
+   flint_tuning_cpu(cpu);
+   fprintf(fout, "Tuning ZmodF_mul for %s\n\n", cpu);
    fflush(fout);
 
    int squaring;
@@ -272,7 +274,7 @@ int main(int argc, char* argv[])
       // plain/threeway threshold
       unsigned long n;
       for (n = 3; algo_compare(n, squaring, 1, 0, flog); n += 3);
-      fprintf(fout, "unsigned long ZmodF_%s_plain_threeway_threshold = %ld;\n",
+      fprintf(fout, "ZmodF_%s_plain_threeway_threshold = %ld\n",
               type, n);
       fflush(fout);
 
@@ -283,7 +285,7 @@ int main(int argc, char* argv[])
 
       // plain/fft threshold
       n = algo_threshold(0, 3, squaring, 0, flog);
-      fprintf(fout, "unsigned long ZmodF_%s_plain_fft_threshold = %ld;\n",
+      fprintf(fout, "ZmodF_%s_plain_fft_threshold = %ld\n",
               type, n);
       fflush(fout);
 
@@ -294,7 +296,7 @@ int main(int argc, char* argv[])
 
       // threeway/fft threshold
       n = algo_threshold(1, 4, squaring, 0, flog);
-      fprintf(fout, "unsigned long ZmodF_%s_threeway_fft_threshold = %ld;\n",
+      fprintf(fout, "ZmodF_%s_threeway_fft_threshold = %ld\n",
               type, n);
       fflush(fout);
 
@@ -304,7 +306,7 @@ int main(int argc, char* argv[])
          ZmodF_sqr_threeway_fft_threshold = n;
 
       // fft thresholds between different depths
-      fprintf(fout, "unsigned long ZmodF_%s_fft_table[20] =\n   {", type);
+      fprintf(fout, "ZmodF_%s_fft_table = {", type);
       unsigned long depth;
       for (depth = 3; depth < 10; depth++)
       {
@@ -318,15 +320,20 @@ int main(int argc, char* argv[])
          fflush(fout);
       }
 
-      fprintf(fout, "0};\n\n");
+      fprintf(fout, "0}\n\n");
       if (!squaring)
          ZmodF_mul_fft_table[depth - 3] = 0;
       else
          ZmodF_sqr_fft_table[depth - 3] = 0;
    }
 
-   fprintf(fout, "\n");
-   fprintf(fout, "// end of file *********************************\n");
+   if (filename != NULL)
+   {
+      if (flint_tuning_save(filename))
+         fprintf(fout, "Saved to %s\n", filename);
+      else
+         fprintf(fout, "Unable to write %s\n", filename);
+   }
 
    test_support_cleanup();
    return 0;
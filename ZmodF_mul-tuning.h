@@ -24,14 +24,16 @@
    
    (C) 2007 David Harvey
 
-NOTE: the tuning values in this file are for sage.math only.
-TODO: write an automatic tuning utility!!
+The values live in the runtime tuning table, see flint-tuning.h. The 
+ZmodF_mul-tune program measures them and saves them to a profile file.
 
 */
 
 #ifndef FLINT_ZMODF_MUL_TUNING_H
 #define FLINT_ZMODF_MUL_TUNING_H
 
+#include "flint-tuning.h"
+
 #ifdef __cplusplus
  extern "C" {
 #endif
@@ -40,15 +42,15 @@ TODO: write an automatic tuning utility!!
 // first value is crossover n from depth 3 to depth 4,
 // then crossover from depth 4 to depth 5, etc.
 
-extern unsigned long ZmodF_mul_plain_threeway_threshold;
-extern unsigned long ZmodF_mul_plain_fft_threshold;
-extern unsigned long ZmodF_mul_threeway_fft_threshold;
-extern unsigned long ZmodF_mul_fft_table[];
+#define ZmodF_mul_plain_threeway_threshold (flint_tuning.ZmodF_mul_plain_threeway_thresh)
+#define ZmodF_mul_plain_fft_threshold (flint_tuning.ZmodF_mul_plain_fft_thresh)
+#define ZmodF_mul_threeway_fft_threshold (flint_tuning.ZmodF_mul_threeway_fft_thresh)
+#define ZmodF_mul_fft_table (flint_tuning.ZmodF_mul_fft_thresh)
 
-extern unsigned long ZmodF_sqr_plain_threeway_threshold;
-extern unsigned long ZmodF_sqr_plain_fft_threshold;
-extern unsigned long ZmodF_sqr_threeway_fft_threshold;
-extern unsigned long ZmodF_sqr_fft_table[];
+#define ZmodF_sqr_plain_threeway_threshold (flint_tuning.ZmodF_sqr_plain_threeway_thresh)
+#define ZmodF_sqr_plain_fft_threshold (flint_tuning.ZmodF_sqr_plain_fft_thresh)
+#define ZmodF_sqr_threeway_fft_threshold (flint_tuning.ZmodF_sqr_threeway_fft_thresh)
+#define ZmodF_sqr_fft_table (flint_tuning.ZmodF_sqr_fft_thresh)
 
 #ifdef __cplusplus
  }
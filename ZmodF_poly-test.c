@@ -985,6 +985,86 @@ int test_ZmodF_poly_convolution()
    return success;
 }
 
+int test_ZmodF_poly_convolution_four_step()
+{
+   int success = 1;
+
+   unsigned long depth;
+   for (depth = 2; depth <= 11 && success; depth++)
+   {
+      unsigned long size = 1UL << depth;
+   
+      // need 4*n*FLINT_BITS divisible by 2^depth
+      unsigned long n_skip = size / (4*FLINT_BITS);
+      if (n_skip == 0)
+         n_skip = 1;
+         
+      unsigned long n;
+      for (n = n_skip; n < 6*n_skip && success; n += n_skip)
+      {
+         unsigned long scratch = random_ulong(4) + 1;
+         ZmodF_poly_t f1, f2, g1, g2;
+         ZmodF_poly_init(f1, depth, n, 1);
+         ZmodF_poly_init(f2, depth, n, 1);
+         ZmodF_poly_init(g1, depth, n, scratch);
+         ZmodF_poly_init(g2, depth, n, scratch);
+
+#if DEBUG
+         printf("depth = %d, n = %d\n", depth, n);
+#endif
+
+         unsigned long num_trials = 20000 / ((1 << depth) * n);
+         if (num_trials == 0)
+            num_trials = 1;
+         
+         unsigned long trial;
+         for (trial = 0; trial < num_trials && success; trial++)
+         {
+            unsigned long cols_depth = random_ulong(depth - 1) + 1;
+            int sqr = (random_ulong(4) == 0);
+
+            ZmodF_poly_random(f1, 4);
+            ZmodF_poly_random(f2, 4);
+            f1->length = random_ulong(size) + 1;
+            f2->length = random_ulong(size) + 1;
+            ZmodF_poly_set(g1, f1);
+            ZmodF_poly_set(g2, f2);
+
+            if (sqr)
+            {
+               ZmodF_poly_convolution(f1, f1, f1);
+               _ZmodF_poly_convolution_four_step(g1, g1, cols_depth);
+            } else
+            {
+               ZmodF_poly_convolution(f1, f1, f2);
+               _ZmodF_poly_convolution_four_step(g1, g2, cols_depth);
+            }
+
+            ZmodF_poly_normalise(f1);
+            ZmodF_poly_normalise(g1);
+
+            unsigned long i;
+            success = (f1->length == g1->length);
+            for (i = 0; i < f1->length && success; i++)
+               if (mpn_cmp(f1->coeffs[i], g1->coeffs[i], n + 1))
+                  success = 0;
+#if DEBUG2
+            if (!success)
+               printf("Error: depth = %ld, n = %ld, cols_depth = %ld\n", 
+                      depth, n, cols_depth);
+#endif
+         }
+         
+         ZmodF_poly_clear(g2);
+         ZmodF_poly_clear(g1);
+         ZmodF_poly_clear(f2);
+         ZmodF_poly_clear(f1);
+      }
+   }
+
+   return success;
+}
+
 int test_ZmodF_poly_convolution_range()
 {
    mpz_poly_t poly1, poly2, poly3, poly4;
@@ -1256,6 +1336,7 @@ void ZmodF_poly_test_all()
    RUN_TEST(_ZmodF_poly_IFFT);
    RUN_TEST(ZmodF_poly_convolution);
    RUN_TEST(ZmodF_poly_convolution_range);
+   RUN_TEST(ZmodF_poly_convolution_four_step);
    RUN_TEST(ZmodF_poly_negacyclic_convolution);
 
    printf(all_success ? "\nAll tests passed\n" :
@@ -37,6 +37,13 @@ Copyright (C) 2007, William Hart and David Harvey
 #include "mpn_extras.h"
 #include "fmpz.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#define ZMODFPOLY_THREAD_NUM omp_get_thread_num()
+#else
+#define ZMODFPOLY_THREAD_NUM 0
+#endif
+
 /****************************************************************************
 
    Memory Management Routines
@@ -1472,6 +1479,197 @@ void ZmodF_poly_convolution_range(ZmodF_poly_t res, ZmodF_poly_t x,
 }
 
 
+/****************************************************************************
+
+   Four step convolution
+   
+****************************************************************************/
+
+
+unsigned long ZmodF_poly_four_step_threads(void)
+{
+#ifdef _OPENMP
+   return omp_get_max_threads();
+#else
+   return 1;
+#endif
+}
+
+
+/*
+   Column transforms of the four step convolution. Returns the number of
+   nonzero entries in each row afterwards.
+*/
+static
+unsigned long _ZmodF_poly_four_step_columns(ZmodF_poly_t poly, 
+             unsigned long cols_depth, unsigned long length_whole_rows, 
+             unsigned long threads)
+{
+   unsigned long rows_depth = poly->depth - cols_depth;
+   unsigned long cols = 1UL << cols_depth;
+   unsigned long root = (4*poly->n*FLINT_BITS) >> poly->depth;
+   
+   unsigned long nonzero_rows = poly->length >> cols_depth;
+   unsigned long nonzero_cols = poly->length & (cols-1);
+   unsigned long count = nonzero_rows ? cols : nonzero_cols;
+   
+#pragma omp parallel num_threads(threads)
+   {
+      ZmodF_t* scratch = poly->scratch + ZMODFPOLY_THREAD_NUM;
+      long i;
+      
+#pragma omp for
+      for (i = 0; i < count; i++)
+         _ZmodF_poly_FFT(poly->coeffs + i, rows_depth, cols, 
+                         (i < nonzero_cols) ? nonzero_rows + 1 : nonzero_rows,
+                         length_whole_rows, i*root, poly->n, scratch);
+   }
+   
+   return count;
+}
+
+
+/*
+   Inverse column transforms of the four step convolution for the columns
+   [start, end), each producing the given number of rows, which are then 
+   rescaled.
+*/
+static
+void _ZmodF_poly_four_step_inverse_columns(ZmodF_poly_t poly, 
+            unsigned long cols_depth, unsigned long start, unsigned long end,
+            unsigned long nonzero, unsigned long rows, int extra, 
+            unsigned long threads)
+{
+   unsigned long rows_depth = poly->depth - cols_depth;
+   unsigned long root = (4*poly->n*FLINT_BITS) >> poly->depth;
+   
+#pragma omp parallel num_threads(threads)
+   {
+      ZmodF_t* scratch = poly->scratch + ZMODFPOLY_THREAD_NUM;
+      long i;
+      unsigned long j;
+      
+#pragma omp for
+      for (i = start; i < end; i++)
+      {
+         _ZmodF_poly_IFFT(poly->coeffs + i, rows_depth, 1UL << cols_depth, 
+                          nonzero, rows, extra, i*root, poly->n, scratch);
+         for (j = 0; j < rows; j++)
+            ZmodF_short_div_2exp(poly->coeffs[i + (j << cols_depth)], 
+                                 poly->coeffs[i + (j << cols_depth)],
+                                 poly->depth, poly->n);
+      }
+   }
+}
+
+
+void _ZmodF_poly_convolution_four_step(ZmodF_poly_t x, ZmodF_poly_t y, 
+                                       unsigned long cols_depth)
+{
+   FLINT_ASSERT(x->depth == y->depth);
+   FLINT_ASSERT(x->n == y->n);
+   FLINT_ASSERT(cols_depth >= 1 && cols_depth < x->depth);
+   FLINT_ASSERT(x->length >= 1 && y->length >= 1);
+   FLINT_ASSERT(x->scratch_count >= 1 && y->scratch_count >= 1);
+   
+   unsigned long n = x->n;
+   unsigned long cols = 1UL << cols_depth;
+   unsigned long threads = FLINT_MIN(x->scratch_count, y->scratch_count);
+   int sqr = (x == y);
+   
+   unsigned long length = x->length + y->length - 1;
+   if (length > (1UL << x->depth))
+      length = 1UL << x->depth;
+   
+   unsigned long length_rows = length >> cols_depth;
+   unsigned long length_cols = length & (cols-1);
+   unsigned long length_whole_rows = length_cols ? 
+                                     (length_rows + 1) : length_rows;
+   
+   // forward column transforms
+   unsigned long x_nonzero = _ZmodF_poly_four_step_columns(x, cols_depth, 
+                                                length_whole_rows, threads);
+   unsigned long y_nonzero = sqr ? x_nonzero : 
+       _ZmodF_poly_four_step_columns(y, cols_depth, length_whole_rows, threads);
+   
+   // forward row transforms, pointwise products and inverse row transforms, 
+   // one row at a time so that each row is only brought into cache once
+#pragma omp parallel num_threads(threads)
+   {
+      ZmodF_t* x_scratch = x->scratch + ZMODFPOLY_THREAD_NUM;
+      ZmodF_t* y_scratch = y->scratch + ZMODFPOLY_THREAD_NUM;
+      ZmodF_mul_info_t info;
+      ZmodF_mul_info_init(info, n, sqr);
+      long i;
+      unsigned long j;
+      
+#pragma omp for
+      for (i = 0; i < length_whole_rows; i++)
+      {
+         ZmodF_t* xr = x->coeffs + (i << cols_depth);
+         ZmodF_t* yr = y->coeffs + (i << cols_depth);
+         unsigned long row_length = (i < length_rows) ? cols : length_cols;
+         
+         _ZmodF_poly_FFT(xr, cols_depth, 1, x_nonzero, row_length, 0, n, 
+                         x_scratch);
+         if (!sqr)
+            _ZmodF_poly_FFT(yr, cols_depth, 1, y_nonzero, row_length, 0, n, 
+                            y_scratch);
+         
+         for (j = 0; j < row_length; j++)
+            ZmodF_mul_info_mul(info, xr[j], xr[j], yr[j]);
+            
+         // the last row may only be partially known, it is dealt with below
+         if (i < length_rows)
+            _ZmodF_poly_IFFT(xr, cols_depth, 1, cols, cols, 0, 0, n, 
+                             x_scratch);
+      }
+      
+      ZmodF_mul_info_clear(info);
+   }
+   
+   // inverse column transforms, as per _ZmodF_poly_IFFT_factor with 
+   // nonzero = length
+   if (length_rows)
+      _ZmodF_poly_four_step_inverse_columns(x, cols_depth, length_cols, cols,
+                     length_rows, length_rows, length_cols ? 1 : 0, threads);
+   
+   if (length_cols)
+   {
+      // a single switcheroo row transform
+      _ZmodF_poly_IFFT(x->coeffs + (length_rows << cols_depth), cols_depth, 
+                       1, length_rows ? cols : length_cols, length_cols, 0, 0,
+                       n, x->scratch);
+                       
+      _ZmodF_poly_four_step_inverse_columns(x, cols_depth, 0, length_cols,
+                     length_rows + 1, length_rows + 1, 0, threads);
+   }
+   
+   x->length = length;
+}
+
+
+void ZmodF_poly_convolution_four_step(ZmodF_poly_t x, ZmodF_poly_t y)
+{
+   FLINT_ASSERT(x->depth == y->depth);
+   FLINT_ASSERT(x->n == y->n);
+
+   if (x->depth < 2 || x->length == 0 || y->length == 0)
+   {
+      ZmodF_poly_convolution(x, x, y);
+      return;
+   }
+   
+   // choose the rows to fit in L2 cache
+   unsigned long cols_depth = x->depth - 1;
+   while (cols_depth > 1 && 
+          ((1UL << cols_depth) + 1) * (x->n + 1) > ZMODFPOLY_FOUR_STEP_ROW_LIMBS)
+      cols_depth--;
+   
+   _ZmodF_poly_convolution_four_step(x, y, cols_depth);
+}
+
+
 /****************************************************************************
 
    Negacyclic Fourier Transform Routines
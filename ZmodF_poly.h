@@ -41,6 +41,7 @@ Copyright (C) 2007, William Hart and David Harvey
 #include <gmp.h>
 #include "memory-manager.h"
 #include "ZmodF.h"
+#include "flint-tuning.h"
 
 
 /****************************************************************************
@@ -301,6 +302,58 @@ void ZmodF_poly_convolution_range(ZmodF_poly_t res, ZmodF_poly_t x,
                                         ZmodF_poly_t y, unsigned long start, unsigned long n);
 
 
+/*
+Above this many limbs of transform data, F_mpn_mul uses the four step 
+convolution below. Rows of the four step convolution are chosen to have at 
+most ZMODFPOLY_FOUR_STEP_ROW_LIMBS limbs, i.e. to fit in L2 cache.
+The threshold is part of the tuning table, see flint-tuning.h.
+*/
+#define ZMODFPOLY_FOUR_STEP_THRESHOLD (flint_tuning.ZmodF_poly_four_step_thresh)
+#define ZMODFPOLY_FOUR_STEP_ROW_LIMBS 32768
+
+
+/*
+   Sets x to the convolution of x and y, exactly as ZmodF_poly_convolution(x, 
+   x, y) does, but using a four step (Bailey) algorithm.
+
+   The transform is split into 2^rows_depth columns and 2^cols_depth rows.
+   After the column transforms, the forward row transforms, pointwise 
+   products and inverse row transforms are done one row at a time, while 
+   the row is in cache. The rescaling is similarly done with the inverse 
+   column transforms. This saves several passes over memory when the data 
+   is much larger than the cache.
+
+   If compiled with OpenMP, the columns and rows are split among up to 
+   min(x.scratch_count, y.scratch_count) threads.
+
+   NOTE:
+      y will be converted to fourier representation (unless y is x).
+
+   PRECONDITIONS:
+      x and y may alias.
+      x, y must have compatible dimensions.
+      x.scratch_count >= 1
+      y.scratch_count >= 1
+*/
+void ZmodF_poly_convolution_four_step(ZmodF_poly_t x, ZmodF_poly_t y);
+
+/*
+   As above, with 2^cols_depth coefficients in each row.
+
+   PRECONDITIONS:
+      1 <= cols_depth < x.depth
+      x.length >= 1, y.length >= 1
+*/
+void _ZmodF_poly_convolution_four_step(ZmodF_poly_t x, ZmodF_poly_t y, 
+                                       unsigned long cols_depth);
+
+/*
+   Returns the number of threads ZmodF_poly_convolution_four_step() can make
+   use of. This is the number of scratch buffers its arguments should have.
+*/
+unsigned long ZmodF_poly_four_step_threads(void);
+
+
 // internal functions
 
 void _ZmodF_poly_FFT_iterative(
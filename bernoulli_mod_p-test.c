@@ -0,0 +1,357 @@
+/*============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+===============================================================================*/
+/****************************************************************************
+
+bernoulli_mod_p-test.c: Test code for bernoulli_mod_p.c and bernoulli_mod_p.h
+
+*****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <gmp.h>
+#include "flint.h"
+#include "long_extras.h"
+#include "F_mpz.h"
+#include "bernoulli_mod_p.h"
+#include "memory-manager.h"
+#include "test-support.h"
+
+#define ITER 1 // if you want all tests to run longer, increase this
+
+/*
+   Sets B[k] to the Bernoulli number B_k for 0 <= k < n, using the
+   recurrence sum_{j=0}^{k} binomial(k+1, j) B_j = 0.
+*/
+void bernoulli_table(mpq_t * B, ulong n)
+{
+   mpz_t binom;
+   mpq_t t;
+   ulong j, k;
+
+   mpz_init(binom);
+   mpq_init(t);
+
+   for (k = 0; k < n; k++)
+   {
+      mpq_set_ui(B[k], k == 0, 1);
+      if (k == 0) continue;
+
+      mpz_set_ui(binom, 1); // binomial(k+1, 0)
+      for (j = 0; j < k; j++)
+      {
+         mpq_set_z(t, binom);
+         mpq_mul(t, t, B[j]);
+         mpq_sub(B[k], B[k], t);
+         mpz_mul_ui(binom, binom, k + 1 - j);
+         mpz_divexact_ui(binom, binom, j + 1);
+      }
+      mpq_set_z(t, binom); // binomial(k+1, k) = k+1
+      mpq_div(B[k], B[k], t);
+   }
+
+   mpq_clear(t);
+   mpz_clear(binom);
+}
+
+#define BERN_TABLE 200
+
+mpq_t bern[BERN_TABLE];
+
+/*
+   Returns B_k mod p from the table.
+*/
+ulong bernoulli_table_mod_p(ulong k, ulong p)
+{
+   mpz_t n, d;
+   mpz_init(n);
+   mpz_init(d);
+
+   mpz_mod_ui(n, mpq_numref(bern[k]), p);
+   mpz_set_ui(d, p);
+   mpz_invert(d, mpq_denref(bern[k]), d);
+   mpz_mul(n, n, d);
+   ulong r = mpz_fdiv_ui(n, p);
+
+   mpz_clear(n);
+   mpz_clear(d);
+
+   return r;
+}
+
+int test_bernoulli_mod_p()
+{
+   int result = 1;
+   ulong p, i, count;
+   ulong * res;
+
+   // compare against the exact values for small primes
+   for (p = 3; (p < BERN_TABLE) && (result == 1); p = z_nextprime(p, 0))
+   {
+      res = (ulong *) malloc(sizeof(ulong)*(p - 1)/2);
+      result = bernoulli_mod_p(res, p);
+      for (i = 0; (i < (p - 1)/2) && (result == 1); i++)
+         result = (res[i] == bernoulli_table_mod_p(2*i, p));
+      if (!result) printf("Error: p = %ld, i = %ld\n", p, i);
+      free(res);
+   }
+
+   // larger primes must pass the internal check
+   for (count = 0; (count < 20*ITER) && (result == 1); count++)
+   {
+      p = z_nextprime(z_randint(100000) + 200, 0);
+      res = (ulong *) malloc(sizeof(ulong)*(p - 1)/2);
+      result = bernoulli_mod_p(res, p);
+      if (!result) printf("Error: p = %ld\n", p);
+      free(res);
+   }
+
+   return result;
+}
+
+int test_bernoulli_mod_p_index()
+{
+   int result = 1;
+   ulong p, k, r1, count;
+   ulong * res;
+
+   for (count = 0; (count < 200*ITER) && (result == 1); count++)
+   {
+      p = z_nextprime(z_randint(10000) + 5, 0);
+      res = (ulong *) malloc(sizeof(ulong)*(p - 1)/2);
+      bernoulli_mod_p(res, p);
+
+      k = 2*z_randint((p - 1)/2);
+      result = (bernoulli_mod_p_index(&r1, k, p) && r1 == res[k/2]);
+
+      // Kummer's congruence B_{k+p-1}/(k+p-1) = B_k/k mod p
+      if (result && k != 0)
+      {
+         double pinv = z_precompute_inverse(p);
+         ulong r = z_mulmod_precomp(res[k/2], k - 1, p, pinv);
+         r = z_mulmod_precomp(r, z_invert(k, p), p, pinv);
+         result = (bernoulli_mod_p_index(&r1, k + (p - 1), p) && r1 == r);
+      }
+
+      // B_k is not p-integral if p - 1 divides k
+      if (result)
+      {
+         r1 = p;
+         result = (!bernoulli_mod_p_index(&r1, (z_randint(10) + 1)*(p - 1), p) && r1 == p);
+      }
+
+      if (!result) printf("Error: p = %ld, k = %ld\n", p, k);
+      free(res);
+   }
+
+   return result;
+}
+
+typedef struct
+{
+   ulong count;
+   ulong sum;
+   int ok;
+} bernoulli_test_arg;
+
+void bernoulli_test_fn(ulong p, const ulong * res, void * arg)
+{
+   bernoulli_test_arg * a = (bernoulli_test_arg *) arg;
+   ulong * res2 = (ulong *) malloc(sizeof(ulong)*(p - 1)/2);
+   ulong i;
+
+   bernoulli_mod_p(res2, p);
+   for (i = 0; i < (p - 1)/2; i++)
+      if (res[i] != res2[i]) a->ok = 0;
+
+   a->count++;
+   a->sum += p;
+
+   free(res2);
+}
+
+int test_bernoulli_mod_p_range()
+{
+   int result = 1;
+   ulong start, end, p, count;
+   bernoulli_test_arg a;
+
+   for (count = 0; (count < 10*ITER) && (result == 1); count++)
+   {
+      start = z_randint(3000);
+      end = start + z_randint(3000);
+
+      a.count = 0;
+      a.sum = 0;
+      a.ok = 1;
+      bernoulli_mod_p_range(start, end, bernoulli_test_fn, &a);
+
+      // every prime in the range must have been seen once
+      ulong num = 0, sum = 0;
+      for (p = z_nextprime(FLINT_MAX(start, 3L) - 1, 0); p < end; p = z_nextprime(p, 0))
+      {
+         num++;
+         sum += p;
+      }
+
+      result = (a.ok && a.count == num && a.sum == sum);
+      if (!result) printf("Error: start = %ld, end = %ld, count = %ld, num = %ld\n", start, end, a.count, num);
+   }
+
+   return result;
+}
+
+int test_bernoulli_irregular_range()
+{
+   int result = 1;
+   bernoulli_irregular_t irr;
+
+   // the irregular pairs (p, k) for p < 160
+   ulong p[] = {37, 59, 67, 101, 103, 131, 149, 157, 157};
+   ulong k[] = {32, 44, 58, 68, 24, 22, 130, 62, 110};
+   ulong i;
+
+   bernoulli_irregular_init(irr);
+   bernoulli_irregular_range(irr, 0, 100);
+   bernoulli_irregular_range(irr, 100, 160);
+
+   result = (irr->length == 9);
+   for (i = 0; (i < irr->length) && result; i++)
+      result = (irr->p[i] == p[i] && irr->k[i] == k[i]);
+
+   if (!result) printf("Error: length = %ld\n", irr->length);
+
+   bernoulli_irregular_clear(irr);
+
+   return result;
+}
+
+/*
+   The primes are shared out between the threads when FLINT is built with 
+   OpenMP. Check that the irregular pairs, over several blocks of primes, do 
+   not depend on the number of threads.
+*/
+
+void set_num_threads(int threads)
+{
+#ifdef _OPENMP
+   omp_set_num_threads(threads);
+#endif
+}
+
+int test_bernoulli_irregular_threads()
+{
+   int result = 1;
+   bernoulli_irregular_t irr1, irr2;
+   ulong i;
+
+#ifdef _OPENMP
+   int max_threads = omp_get_max_threads();
+#endif
+
+   bernoulli_irregular_init(irr1);
+   bernoulli_irregular_init(irr2);
+
+   set_num_threads(1);
+   bernoulli_irregular_range(irr1, 0, 16*BERNOULLI_MOD_P_BLOCK);
+
+   set_num_threads(4);
+   bernoulli_irregular_range(irr2, 0, 16*BERNOULLI_MOD_P_BLOCK);
+
+#ifdef _OPENMP
+   omp_set_num_threads(max_threads);
+#endif
+
+   result = (irr1->length == irr2->length && irr1->length > 0);
+   for (i = 0; (i < irr1->length) && result; i++)
+      result = (irr1->p[i] == irr2->p[i] && irr1->k[i] == irr2->k[i]);
+
+   if (!result) printf("Error: length1 = %ld, length2 = %ld\n", irr1->length, irr2->length);
+
+   bernoulli_irregular_clear(irr1);
+   bernoulli_irregular_clear(irr2);
+
+   return result;
+}
+
+int test_bernoulli_number()
+{
+   int result = 1;
+   F_mpz_t num, den;
+   mpz_t n, d;
+   ulong k;
+
+   F_mpz_init(num);
+   F_mpz_init(den);
+   mpz_init(n);
+   mpz_init(d);
+
+   for (k = 0; (k < BERN_TABLE) && (result == 1); k++)
+   {
+      bernoulli_number(num, den, k);
+      F_mpz_get_mpz(n, num);
+      F_mpz_get_mpz(d, den);
+
+      result = (mpz_cmp(n, mpq_numref(bern[k])) == 0 && mpz_cmp(d, mpq_denref(bern[k])) == 0);
+      if (!result) gmp_printf("Error: k = %ld, num = %Zd, den = %Zd\n", k, n, d);
+   }
+
+   mpz_clear(n);
+   mpz_clear(d);
+   F_mpz_clear(num);
+   F_mpz_clear(den);
+
+   return result;
+}
+
+void bernoulli_mod_p_test_all()
+{
+   int success, all_success = 1;
+   ulong i;
+   printf("FLINT_BITS = %d\n", FLINT_BITS);
+
+   for (i = 0; i < BERN_TABLE; i++)
+      mpq_init(bern[i]);
+   bernoulli_table(bern, BERN_TABLE);
+
+   RUN_TEST(bernoulli_mod_p);
+   RUN_TEST(bernoulli_mod_p_index);
+   RUN_TEST(bernoulli_mod_p_range);
+   RUN_TEST(bernoulli_irregular_range);
+   RUN_TEST(bernoulli_irregular_threads);
+   RUN_TEST(bernoulli_number);
+
+   for (i = 0; i < BERN_TABLE; i++)
+      mpq_clear(bern[i]);
+
+   printf(all_success ? "\nAll tests passed\n" :
+                        "\nAt least one test FAILED!\n");
+}
+
+int main()
+{
+   test_support_init();
+   bernoulli_mod_p_test_all();
+   test_support_cleanup();
+
+   flint_stack_cleanup();
+   _F_mpz_cleanup();
+
+   return 0;
+}
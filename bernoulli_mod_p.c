@@ -0,0 +1,549 @@
+/*============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+===============================================================================*/
+/*****************************************************************************
+
+   bernoulli_mod_p.c: Bernoulli numbers modulo primes, over ranges of primes,
+                      and exact Bernoulli numbers by multimodular methods
+
+   The algorithm for a single prime is David Harvey's, from the bernoulli
+   demo program of zn_poly.
+
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <gmp.h>
+
+#include "flint.h"
+#include "long_extras.h"
+#include "F_mpz.h"
+#include "bernoulli_mod_p.h"
+#include "zn_poly/src/zn_poly.h"
+
+/*============================================================================
+
+   Workspace
+
+=============================================================================*/
+
+void bernoulli_mod_p_scratch_init(bernoulli_mod_p_scratch_t scratch)
+{
+   scratch->res = NULL;
+   scratch->G = NULL;
+   scratch->P = NULL;
+   scratch->alloc = 0;
+}
+
+void bernoulli_mod_p_scratch_clear(bernoulli_mod_p_scratch_t scratch)
+{
+   if (scratch->alloc)
+   {
+      free(scratch->res);
+      free(scratch->G);
+      free(scratch->P);
+   }
+   scratch->alloc = 0;
+}
+
+void bernoulli_mod_p_scratch_fit(bernoulli_mod_p_scratch_t scratch, ulong p)
+{
+   ulong n = (p - 1)/2;
+
+   if (n <= scratch->alloc) return;
+
+   // grow geometrically, as the primes of a range increase
+   n = FLINT_MAX(n, scratch->alloc + scratch->alloc/4);
+
+   scratch->res = (ulong *) realloc(scratch->res, sizeof(ulong)*n);
+   scratch->G = (ulong *) realloc(scratch->G, sizeof(ulong)*n);
+   scratch->P = (ulong *) realloc(scratch->P, sizeof(ulong)*2*n);
+   scratch->alloc = n;
+}
+
+/*============================================================================
+
+   A single prime
+
+=============================================================================*/
+
+int _bernoulli_mod_p(bernoulli_mod_p_scratch_t scratch,
+                                               ulong p, ulong g, ulong g_inv)
+{
+   FLINT_ASSERT(p >= 3 && p < BERNOULLI_MOD_P_MAX_PRIME);
+   FLINT_ASSERT(scratch->alloc >= (p - 1)/2);
+
+   ulong n = (p - 1)/2, i;
+   ulong * res = scratch->res, * G = scratch->G, * P = scratch->P;
+   ulong * J = res; // J(X) is built in the output and replaced by it
+
+   zn_mod_t mod;
+   zn_mod_init(mod, p);
+
+   // step 1: compute the polynomials G(X) and J(X)
+
+   // g_pow = g^(i-1), g_pow_inv = g^(-i) at the start of each iteration
+   ulong g_pow = g_inv;
+   ulong g_pow_inv = 1;
+
+   // bias = (g-1)/2 mod p
+   ulong bias = (g - 1 + ((g & 1) ? 0 : p))/2;
+
+   // fudge = g^(i^2), fudge_inv = g^(-i^2) at the start of each iteration
+   ulong fudge = 1;
+   ulong fudge_inv = 1;
+
+   for (i = 0; i < n; i++)
+   {
+      ulong prod = g*g_pow;
+
+      ulong quo = zn_mod_quotient(prod, mod);
+      ulong rem = prod - quo*p;
+
+      // h = h(g^i)/g^i mod p
+      ulong h = zn_mod_reduce(g_pow_inv*zn_mod_sub_slim(bias, quo, mod), mod);
+
+      g_pow = rem;
+      g_pow_inv = zn_mod_reduce(g_pow_inv*g_inv, mod);
+
+      // X^i coefficient of G(X) is g^(i^2) h(g^i)/g^i, that of J(X) is g^(-i^2)
+      G[i] = zn_mod_reduce(h*fudge, mod);
+      J[i] = fudge_inv;
+
+      fudge = zn_mod_reduce(fudge*g_pow, mod);
+      fudge = zn_mod_reduce(fudge*g_pow, mod);
+      fudge = zn_mod_reduce(fudge*g, mod);
+      fudge_inv = zn_mod_reduce(fudge_inv*g_pow_inv, mod);
+      fudge_inv = zn_mod_reduce(fudge_inv*g_pow_inv, mod);
+      fudge_inv = zn_mod_reduce(fudge_inv*g, mod);
+   }
+
+   J[0] = 0;
+
+   // step 2: compute the product P(X) = G(X)*J(X)
+
+   zn_array_mul(P, J, n, G, n, mod);
+
+   // step 3: extract the output from P(X), checking that
+   // sum_{i} 4^i (2i + 1) B_{2i} = -2 mod p
+
+   ulong check_accum = 1;
+   ulong check_four_pow = 4 % p;
+
+   ulong g_sqr = zn_mod_reduce(g*g, mod);
+   ulong g_sqr_inv = zn_mod_reduce(g_inv*g_inv, mod);
+
+   // J[i] = (1 - g^(2i+2))(1 - g^(2i+4)) ... (1 - g^(p-3)) for 0 <= i < n
+   ulong g_sqr_inv_pow = g_sqr_inv;
+   J[n - 1] = 1;
+   for (i = 1; i < n; i++)
+   {
+      J[n - i - 1] = zn_mod_reduce(J[n - i]*(p + 1 - g_sqr_inv_pow), mod);
+      g_sqr_inv_pow = zn_mod_reduce(g_sqr_inv_pow*g_sqr_inv, mod);
+   }
+
+   // fudge = g^(i^2) and g_sqr_pow = g^(2i) at each iteration
+   fudge = g;
+   ulong g_sqr_pow = g_sqr;
+
+   // prod_inv = [(1 - g^(2i))(1 - g^(2i+2)) ... (1 - g^(p-3))]^(-1),
+   // which is -1/2 mod p for i = 1
+   ulong prod_inv = p - 2;
+
+   for (i = 1; i < n; i++)
+   {
+      ulong val = (i == n - 1) ? 0 : P[i + n];
+      if (n & 1) val = zn_mod_neg(val, mod);
+      val = zn_mod_add_slim(val, G[i], mod);
+      val = zn_mod_add_slim(val, P[i], mod);
+
+      // multiply by 4i g^(i^2)
+      val = zn_mod_reduce(val*fudge, mod);
+      val = zn_mod_reduce(val*(2*i), mod);
+      val = zn_mod_add_slim(val, val, mod);
+
+      // divide by 1 - g^(2i)
+      val = zn_mod_reduce(val*prod_inv, mod);
+      val = zn_mod_reduce(val*J[i], mod);
+      prod_inv = zn_mod_reduce(prod_inv*(1 + p - g_sqr_pow), mod);
+
+      res[i] = val;
+
+      g_sqr_pow = zn_mod_reduce(g_sqr_pow*g, mod);
+      fudge = zn_mod_reduce(fudge*g_sqr_pow, mod);
+      g_sqr_pow = zn_mod_reduce(g_sqr_pow*g, mod);
+
+      ulong check_term = zn_mod_reduce(check_four_pow*(2*i + 1), mod);
+      check_term = zn_mod_reduce(check_term*val, mod);
+      check_accum = zn_mod_add_slim(check_accum, check_term, mod);
+      check_four_pow = zn_mod_add_slim(check_four_pow, check_four_pow, mod);
+      check_four_pow = zn_mod_add_slim(check_four_pow, check_four_pow, mod);
+   }
+
+   res[0] = 1; // J[0] occupied this slot until now
+
+   zn_mod_clear(mod);
+
+   return (check_accum == p - 2);
+}
+
+int bernoulli_mod_p(ulong * res, ulong p)
+{
+   bernoulli_mod_p_scratch_t scratch;
+   bernoulli_mod_p_scratch_init(scratch);
+   bernoulli_mod_p_scratch_fit(scratch, p);
+
+   ulong g = z_primitive_root(p);
+   int ok = _bernoulli_mod_p(scratch, p, g, z_invert(g, p));
+
+   ulong i;
+   for (i = 0; i < (p - 1)/2; i++)
+      res[i] = scratch->res[i];
+
+   bernoulli_mod_p_scratch_clear(scratch);
+
+   return ok;
+}
+
+/*
+   Voronoi's congruence: for c coprime to p with c^k != 1 mod p,
+   (c^k - 1) B_k = k c^(k-1) sum_{j=1}^{p-1} j^(k-1) floor(jc/p) mod p.
+   Taking c to be a primitive root and j = c^i, the powers j^(k-1) and
+   the quotients floor(jc/p) are both obtained by one multiplication per term.
+   Uses no FLINT functions which are not thread safe.
+*/
+static
+ulong __bernoulli_mod_p_index(ulong k, ulong p, ulong c)
+{
+   zn_mod_t mod;
+   zn_mod_init(mod, p);
+
+   ulong t = zn_mod_pow(c, (k - 1) % (p - 1), mod); // c^(k-1)
+   ulong j = 1, x = 1, i, sum;
+
+   // the terms x*floor(jc/p) are less than c*p, so can be added up until
+   // the sum reaches 2^FLINT_BITS - c*p
+   ulong bound = -(c*p), acc = 0;
+
+   for (i = 0; i < p - 1; i++)
+   {
+      ulong prod = j*c;
+      ulong quo = zn_mod_quotient(prod, mod);
+
+      acc += x*quo;
+      if (acc >= bound) acc = zn_mod_reduce(acc, mod);
+
+      j = prod - quo*p;
+      x = zn_mod_mul(x, t, mod);
+   }
+   sum = zn_mod_reduce(acc, mod);
+
+   // B_k = k c^(k-1) sum/(c^k - 1)
+   sum = zn_mod_mul(sum, t, mod);
+   sum = zn_mod_mul(sum, k % p, mod);
+   ulong d = zn_mod_sub_slim(zn_mod_mul(t, c, mod), 1, mod);
+   sum = zn_mod_mul(sum, zn_mod_pow(d, p - 2, mod), mod);
+
+   zn_mod_clear(mod);
+
+   return sum;
+}
+
+int bernoulli_mod_p_index(ulong * res, ulong k, ulong p)
+{
+   FLINT_ASSERT(p >= 3 && p < BERNOULLI_MOD_P_MAX_PRIME);
+
+   if (k == 0) (*res) = 1;
+   else if (k == 1) (*res) = (p - 1)/2; // -1/2
+   else if (k & 1) (*res) = 0;
+   else if ((k % (p - 1)) == 0) return 0; // p divides the denominator of B_k
+   else (*res) = __bernoulli_mod_p_index(k, p, z_primitive_root(p));
+
+   return 1;
+}
+
+/*============================================================================
+
+   Ranges of primes
+
+=============================================================================*/
+
+/*
+   Fills primes with up to BERNOULLI_MOD_P_BLOCK primes following last and
+   less than end, with their primitive roots and the inverses of these.
+   Returns the number of primes. This is done by a single thread as the
+   factoring code is not thread safe.
+*/
+static
+ulong __bernoulli_mod_p_block(ulong * primes, ulong * roots, ulong * roots_inv,
+                                                         ulong last, ulong end)
+{
+   ulong num = 0;
+
+   while (num < BERNOULLI_MOD_P_BLOCK)
+   {
+      last = z_nextprime(last, 0);
+      if (last >= end) break;
+
+      if (last >= BERNOULLI_MOD_P_MAX_PRIME)
+      {
+         printf("FLINT Exception: prime too large for bernoulli_mod_p\n");
+         abort();
+      }
+
+      primes[num] = last;
+      roots[num] = z_primitive_root(last);
+      roots_inv[num] = z_invert(roots[num], last);
+      num++;
+   }
+
+   return num;
+}
+
+/*
+   Runs _bernoulli_mod_p over the primes start <= p < end in blocks of
+   BERNOULLI_MOD_P_BLOCK, the primes of each block being shared out between
+   the threads, each of which has its own workspace. For each prime, if fn
+   is not NULL it is called in a critical section, and if irr is not NULL the
+   irregular indices are recorded and appended to irr in order once the
+   block is finished.
+*/
+static
+void __bernoulli_mod_p_range(ulong start, ulong end, bernoulli_mod_p_fn fn,
+                                    void * arg, bernoulli_irregular_t irr)
+{
+   ulong primes[BERNOULLI_MOD_P_BLOCK];
+   ulong roots[BERNOULLI_MOD_P_BLOCK];
+   ulong roots_inv[BERNOULLI_MOD_P_BLOCK];
+   ulong * irr_num = NULL, * irr_k = NULL;
+   ulong num = 0, last = FLINT_MAX(start, 3L) - 1;
+
+   if (irr)
+   {
+      irr_num = (ulong *) malloc(sizeof(ulong)*BERNOULLI_MOD_P_BLOCK);
+      irr_k = (ulong *) malloc(sizeof(ulong)*BERNOULLI_MOD_P_BLOCK*BERNOULLI_MOD_P_MAX_IRREGULAR);
+   }
+
+#pragma omp parallel
+   {
+      bernoulli_mod_p_scratch_t scratch;
+      bernoulli_mod_p_scratch_init(scratch);
+      long i;
+
+      while (1)
+      {
+#pragma omp single
+         {
+            num = __bernoulli_mod_p_block(primes, roots, roots_inv, last, end);
+            if (num) last = primes[num - 1];
+         }
+
+         if (num == 0) break;
+
+#pragma omp for schedule(dynamic)
+         for (i = 0; i < num; i++)
+         {
+            ulong p = primes[i], j;
+
+            bernoulli_mod_p_scratch_fit(scratch, p);
+            if (!_bernoulli_mod_p(scratch, p, roots[i], roots_inv[i]))
+            {
+               printf("FLINT Exception: bernoulli_mod_p failed its check for p = %lu\n", p);
+               abort();
+            }
+
+            if (fn)
+            {
+#pragma omp critical
+               fn(p, scratch->res, arg);
+            }
+
+            if (irr)
+            {
+               irr_num[i] = 0;
+               for (j = 1; j < (p - 1)/2; j++)
+               {
+                  if (scratch->res[j] == 0L)
+                  {
+                     if (irr_num[i] == BERNOULLI_MOD_P_MAX_IRREGULAR)
+                     {
+                        printf("FLINT Exception: too many irregular indices for p = %lu\n", p);
+                        abort();
+                     }
+                     irr_k[i*BERNOULLI_MOD_P_MAX_IRREGULAR + irr_num[i]] = 2*j;
+                     irr_num[i]++;
+                  }
+               }
+            }
+         }
+
+         if (irr)
+         {
+#pragma omp single
+            {
+               ulong j;
+               for (i = 0; i < num; i++)
+                  for (j = 0; j < irr_num[i]; j++)
+                  {
+                     if (irr->length == irr->alloc)
+                     {
+                        irr->alloc = FLINT_MAX(2*irr->alloc, 16L);
+                        irr->p = (ulong *) realloc(irr->p, sizeof(ulong)*irr->alloc);
+                        irr->k = (ulong *) realloc(irr->k, sizeof(ulong)*irr->alloc);
+                     }
+                     irr->p[irr->length] = primes[i];
+                     irr->k[irr->length] = irr_k[i*BERNOULLI_MOD_P_MAX_IRREGULAR + j];
+                     irr->length++;
+                  }
+            }
+         }
+      }
+
+      bernoulli_mod_p_scratch_clear(scratch);
+   }
+
+   if (irr)
+   {
+      free(irr_num);
+      free(irr_k);
+   }
+}
+
+void bernoulli_mod_p_range(ulong start, ulong end,
+                                         bernoulli_mod_p_fn fn, void * arg)
+{
+   __bernoulli_mod_p_range(start, end, fn, arg, NULL);
+}
+
+void bernoulli_irregular_init(bernoulli_irregular_t irr)
+{
+   irr->p = NULL;
+   irr->k = NULL;
+   irr->length = 0;
+   irr->alloc = 0;
+}
+
+void bernoulli_irregular_clear(bernoulli_irregular_t irr)
+{
+   free(irr->p);
+   free(irr->k);
+   irr->length = 0;
+   irr->alloc = 0;
+}
+
+void bernoulli_irregular_range(bernoulli_irregular_t irr, ulong start, ulong end)
+{
+   __bernoulli_mod_p_range(start, end, NULL, NULL, irr);
+}
+
+/*============================================================================
+
+   Exact Bernoulli numbers
+
+=============================================================================*/
+
+void bernoulli_denominator(F_mpz_t den, ulong n)
+{
+   ulong d;
+
+   F_mpz_set_ui(den, 1);
+
+   if (n != 1 && (n & 1)) return;
+
+   // n = 0 has no divisors
+   for (d = 1; d*d <= n; d++)
+   {
+      if (n % d) continue;
+
+      if (z_isprime(d + 1)) F_mpz_mul_ui(den, den, d + 1);
+      if (d*d != n && z_isprime(n/d + 1)) F_mpz_mul_ui(den, den, n/d + 1);
+   }
+}
+
+void bernoulli_number(F_mpz_t num, F_mpz_t den, ulong n)
+{
+   ulong i, num_primes, alloc, bits;
+   ulong * primes, * roots, * res;
+
+   bernoulli_denominator(den, n);
+
+   if (n <= 1 || (n & 1))
+   {
+      if (n == 0) F_mpz_set_ui(num, 1);
+      else if (n == 1) F_mpz_set_si(num, -1);
+      else F_mpz_zero(num);
+      return;
+   }
+
+   // |B_n| < 4 n!/(2 pi)^n, and num = B_n den
+   double lbits = (lgamma((double) n + 1) - n*1.8378770664093454)/log(2.0) + 2.0; // log(2 pi)
+   bits = (ulong) FLINT_MAX(lbits, 0.0) + F_mpz_bits(den) + 2; // and a sign bit
+
+   // primes p > n + 2, which do not divide den, with product exceeding 2^bits
+   alloc = 16;
+   primes = (ulong *) malloc(sizeof(ulong)*alloc);
+   num_primes = 0;
+   ulong p = n + 2, pbits = 0;
+   while (pbits <= bits)
+   {
+      p = z_nextprime(p, 0);
+      if (num_primes == alloc)
+      {
+         alloc *= 2;
+         primes = (ulong *) realloc(primes, sizeof(ulong)*alloc);
+      }
+      primes[num_primes++] = p;
+      pbits += FLINT_BIT_COUNT(p) - 1;
+   }
+
+   // residues of the denominator and primitive roots, which are found serially
+   F_mpz_t temp, temp2;
+   F_mpz_init(temp);
+   F_mpz_init(temp2);
+   res = (ulong *) malloc(sizeof(ulong)*2*num_primes);
+   roots = res + num_primes;
+   for (i = 0; i < num_primes; i++)
+   {
+      res[i] = F_mpz_mod_ui(temp, den, primes[i]);
+      roots[i] = z_primitive_root(primes[i]);
+   }
+
+   // the residues of the numerator are computed in parallel, p < 2^(FLINT_BITS/2)
+   long j;
+#pragma omp parallel for schedule(dynamic)
+   for (j = 0; j < num_primes; j++)
+      res[j] = (__bernoulli_mod_p_index(n, primes[j], roots[j])*res[j]) % primes[j];
+
+   F_mpz_comb_t comb;
+   F_mpz_comb_init(comb, primes, num_primes);
+   F_mpz ** comb_temp = F_mpz_comb_temp_init(comb);
+
+   F_mpz_multi_CRT_ui(num, res, comb, comb_temp, temp, temp2);
+
+   F_mpz_clear(temp);
+   F_mpz_clear(temp2);
+   F_mpz_comb_temp_free(comb, comb_temp);
+   F_mpz_comb_clear(comb);
+
+   free(res);
+   free(primes);
+}
+
+// *************** end of file
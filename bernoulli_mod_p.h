@@ -0,0 +1,209 @@
+/*============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+===============================================================================*/
+/*****************************************************************************
+
+   bernoulli_mod_p.h: Bernoulli numbers modulo primes, over ranges of primes,
+                      and exact Bernoulli numbers by multimodular methods
+
+   The algorithm for a single prime is David Harvey's, from the bernoulli
+   demo program of zn_poly.
+
+*****************************************************************************/
+
+#ifndef _BERNOULLI_MOD_P_H_
+#define _BERNOULLI_MOD_P_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <gmp.h>
+
+#include "flint.h"
+#include "F_mpz.h"
+#include "zn_poly/src/zn_poly.h"
+
+/*
+   Workspace for computing Bernoulli numbers modulo a prime, which is reused
+   from one prime to the next. Each thread has its own.
+*/
+typedef struct
+{
+   ulong * res; // the output B_0, B_2, ..., B_{p-3} mod p
+   ulong * G;   // the polynomial G(X) of length (p-1)/2
+   ulong * P;   // the product of G(X) and J(X), of length p - 2
+   ulong alloc; // (p-1)/2 for the largest prime p the workspace will hold
+} bernoulli_mod_p_scratch_struct;
+
+typedef bernoulli_mod_p_scratch_struct bernoulli_mod_p_scratch_t[1];
+
+/*
+   Irregular pairs (p, k), i.e. primes p and even indices 2 <= k <= p - 3
+   such that p divides the numerator of B_k.
+*/
+typedef struct
+{
+   ulong * p;
+   ulong * k;
+   ulong length;
+   ulong alloc;
+} bernoulli_irregular_struct;
+
+typedef bernoulli_irregular_struct bernoulli_irregular_t[1];
+
+typedef void (*bernoulli_mod_p_fn)(ulong p, const ulong * res, void * arg);
+
+#define BERNOULLI_MOD_P_MAX_PRIME (1UL << (FLINT_BITS/2)) // primes must be less than this
+
+#define BERNOULLI_MOD_P_MAX_IRREGULAR 32 // maximum index of irregularity of a prime
+
+#define BERNOULLI_MOD_P_BLOCK 256 // number of primes shared out between threads at a time
+
+/*============================================================================
+
+   Workspace
+
+=============================================================================*/
+
+/**
+   \fn     void bernoulli_mod_p_scratch_init(bernoulli_mod_p_scratch_t scratch)
+   \brief  Initialise an empty workspace.
+*/
+void bernoulli_mod_p_scratch_init(bernoulli_mod_p_scratch_t scratch);
+
+/**
+   \fn     void bernoulli_mod_p_scratch_clear(bernoulli_mod_p_scratch_t scratch)
+   \brief  Release the memory used by the workspace.
+*/
+void bernoulli_mod_p_scratch_clear(bernoulli_mod_p_scratch_t scratch);
+
+/**
+   \fn     void bernoulli_mod_p_scratch_fit(bernoulli_mod_p_scratch_t scratch,
+                                                                    ulong p)
+   \brief  Make the workspace large enough for the prime p.
+*/
+void bernoulli_mod_p_scratch_fit(bernoulli_mod_p_scratch_t scratch, ulong p);
+
+/*============================================================================
+
+   A single prime
+
+=============================================================================*/
+
+/**
+   \fn     int _bernoulli_mod_p(bernoulli_mod_p_scratch_t scratch,
+                                               ulong p, ulong g, ulong g_inv)
+   \brief  Sets scratch->res[i] to B_{2i} mod p for 0 <= i < (p-1)/2, where
+           3 <= p < BERNOULLI_MOD_P_MAX_PRIME is prime, g is a primitive root
+           mod p and g_inv its inverse. The workspace must be large enough for
+           p. Returns 1 if the result passes the check
+           sum_{i} 4^i (2i + 1) B_{2i} = -2 mod p, otherwise 0.
+*/
+int _bernoulli_mod_p(bernoulli_mod_p_scratch_t scratch,
+                                              ulong p, ulong g, ulong g_inv);
+
+/**
+   \fn     int bernoulli_mod_p(ulong * res, ulong p)
+   \brief  Sets res[i] to B_{2i} mod p for 0 <= i < (p-1)/2, where
+           3 <= p < BERNOULLI_MOD_P_MAX_PRIME is prime. Returns 1 if the
+           result passes the check of _bernoulli_mod_p, otherwise 0.
+*/
+int bernoulli_mod_p(ulong * res, ulong p);
+
+/**
+   \fn     int bernoulli_mod_p_index(ulong * res, ulong k, ulong p)
+   \brief  Sets res to B_k mod p, where p < BERNOULLI_MOD_P_MAX_PRIME is an 
+           odd prime, in time O(p), and returns 1. If k > 0 is a multiple of 
+           p - 1, then p divides the denominator of B_k, so res is left 
+           unchanged and 0 is returned. This uses Voronoi's congruence and is 
+           suitable when only one Bernoulli number is required.
+*/
+int bernoulli_mod_p_index(ulong * res, ulong k, ulong p);
+
+/*============================================================================
+
+   Ranges of primes
+
+=============================================================================*/
+
+/**
+   \fn     void bernoulli_mod_p_range(ulong start, ulong end,
+                                       bernoulli_mod_p_fn fn, void * arg)
+   \brief  For each prime 3 <= p < end with p >= start computes
+           B_0, B_2, ..., B_{p-3} mod p and calls fn(p, res, arg), where res
+           is as for bernoulli_mod_p. The primes are shared out between
+           threads if FLINT is built with OpenMP, in which case fn may be
+           called for the primes in any order, but never by two threads at
+           once. The array res is only valid during the call. Aborts if a
+           result fails the check.
+*/
+void bernoulli_mod_p_range(ulong start, ulong end,
+                                        bernoulli_mod_p_fn fn, void * arg);
+
+/**
+   \fn     void bernoulli_irregular_init(bernoulli_irregular_t irr)
+   \brief  Initialise an empty list of irregular pairs.
+*/
+void bernoulli_irregular_init(bernoulli_irregular_t irr);
+
+/**
+   \fn     void bernoulli_irregular_clear(bernoulli_irregular_t irr)
+   \brief  Release the memory used by the list of irregular pairs.
+*/
+void bernoulli_irregular_clear(bernoulli_irregular_t irr);
+
+/**
+   \fn     void bernoulli_irregular_range(bernoulli_irregular_t irr,
+                                                      ulong start, ulong end)
+   \brief  Appends the irregular pairs (p, k) with start <= p < end to irr,
+           in increasing order of p and then k. Threads are used as for
+           bernoulli_mod_p_range.
+*/
+void bernoulli_irregular_range(bernoulli_irregular_t irr, ulong start, ulong end);
+
+/*============================================================================
+
+   Exact Bernoulli numbers
+
+=============================================================================*/
+
+/**
+   \fn     void bernoulli_denominator(F_mpz_t den, ulong n)
+   \brief  Sets den to the denominator of B_n, which for even n > 0 is the
+           product of the primes q with q - 1 dividing n (von Staudt-Clausen).
+*/
+void bernoulli_denominator(F_mpz_t den, ulong n);
+
+/**
+   \fn     void bernoulli_number(F_mpz_t num, F_mpz_t den, ulong n)
+   \brief  Sets num/den to B_n in lowest terms, with den > 0. The numerator
+           is reconstructed by Chinese remaindering from B_n mod p for
+           sufficiently many primes p > n + 2, which are computed in parallel
+           if FLINT is built with OpenMP.
+*/
+void bernoulli_number(F_mpz_t num, F_mpz_t den, ulong n);
+
+#ifdef __cplusplus
+ }
+#endif
+
+#endif
+
+// *************** end of file
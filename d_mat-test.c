@@ -67,13 +67,24 @@ int test_d_mat_init_clear()
 
    double ** mat;
 
-   for (count1 = 0; count1 < 10000; count1++)
+   for (count1 = 0; count1 < 10000 && result; count1++)
    {
 	  ulong rows = z_randint(50) + 1;
       ulong cols = z_randint(50) + 1;
 
       mat = d_mat_init(rows, cols);
       random_d_mat(mat, rows, cols);
+      
+      // check rows are aligned and padding is zero
+      ulong i, j;
+      for (i = 0; i < rows && result; i++)
+      {
+         result = (((size_t) mat[i] & (D_MAT_ALIGN - 1)) == 0);
+         for (j = cols; j < D_MAT_STRIDE(cols); j++)
+            if (mat[i][j] != 0.0) result = 0;
+      }
+      if (!result) printf("Error: rows = %ld, cols = %ld\n", rows, cols);
+      
       d_mat_clear(mat);
    }
 
@@ -143,7 +154,9 @@ int test__d_vec_scalar_product()
 		 double s2 = _d_vec_scalar_product(mat[r1] + cols - 1, mat[r2] + cols - 1, 1);
 		 double s3 = _d_vec_scalar_product(mat[r1], mat[r2], cols);
 
-		 result = (fabs(s1 + s2 - s3) < 1.0e-14);
+         // the AVX2 kernels may sum in a different order
+
+		 result = (fabs(s1 + s2 - s3) < 1.0e-12);
 		 if (!result)
 		 {
 			 printf("Error: %lf, %lf, %lf, %lf\n", s1, s2, s3, (s1 + s2) - s3);
@@ -179,7 +192,9 @@ int test__d_vec_norm()
 		 double s2 = _d_vec_norm(mat[r1] + cols - 1, 1);
 		 double s3 = _d_vec_norm(mat[r1], cols);
 
-		 result = (fabs(s1 + s2 - s3) < 1.0e-14);
+         // the AVX2 kernels may sum in a different order
+
+		 result = (fabs(s1 + s2 - s3) < 1.0e-12);
 		 if (!result)
 		 {
 			 printf("Error: %lf, %lf, %lf\n", s1, s2, s3);
@@ -193,6 +208,104 @@ int test__d_vec_norm()
    return result;
 }
 
+int test__d_vec_addmul()
+{
+   int result = 1;
+   ulong count1, count2;
+
+   double ** mat;
+   double * vec, * vec2;
+
+   for (count1 = 0; count1 < 1000 && result; count1++)
+   {
+	  ulong rows = z_randint(100) + 1;
+      ulong cols = z_randint(100) + 2;
+
+      mat = d_mat_init(rows, cols);
+      random_d_mat(mat, rows, cols);
+      vec = malloc(cols*sizeof(double));
+      vec2 = malloc(cols*sizeof(double));
+
+	  for (count2 = 0; count2 < 100 && result; count2++)
+	  {
+	     ulong r1 = z_randint(rows);
+		 ulong r2 = z_randint(rows);
+         ulong i;
+         double c = random_d();
+
+         for (i = 0; i < cols; i++) 
+         {
+            vec[i] = mat[r1][i] + c*mat[r2][i];
+            vec2[i] = mat[r1][i];
+         }
+         
+         // use an unaligned start to test the tail handling
+         ulong start = z_randint(cols);
+         _d_vec_addmul(vec2 + start, mat[r2] + start, cols - start, c);
+         for (i = 0; i < start; i++) vec2[i] += c*mat[r2][i];
+
+		 result = (_d_vec_equal(vec2, vec, cols, FLINT_D_BITS - 2));
+		 if (!result)
+		 {
+			 printf("Error: rows = %ld, cols = %ld, start = %ld\n", rows, cols, start);
+			 break;
+		 }
+	  }
+
+      d_mat_clear(mat);
+      free(vec);
+      free(vec2);
+   }
+
+   return result;
+}
+
+int test__d_vec_reflect()
+{
+   int result = 1;
+   ulong count1, count2;
+
+   double ** mat;
+   double * vec;
+
+   for (count1 = 0; count1 < 1000 && result; count1++)
+   {
+	  ulong rows = z_randint(100) + 1;
+      ulong cols = z_randint(100) + 2;
+
+      mat = d_mat_init(rows, cols);
+      random_d_mat(mat, rows, cols);
+      vec = malloc(cols*sizeof(double));
+     
+	  for (count2 = 0; count2 < 100 && result; count2++)
+	  {
+	     ulong r1 = z_randint(rows);
+		 ulong r2 = z_randint(rows);
+         ulong i;
+         
+         // make a reflection vector of norm 2
+         double t = sqrt(2.0/_d_vec_norm(mat[r2], cols));
+         for (i = 0; i < cols; i++) vec[i] = t*mat[r2][i];
+
+         double s1 = _d_vec_norm(mat[r1], cols);
+         _d_vec_reflect(mat[r1], vec, cols);
+		 double s2 = _d_vec_norm(mat[r1], cols);
+
+		 result = (fabs(s1 - s2) < 1.0e-12);
+		 if (!result)
+		 {
+			 printf("Error: %lf, %lf\n", s1, s2);
+			 break;
+		 }
+	  }
+
+      d_mat_clear(mat);
+      free(vec);
+   }
+
+   return result;
+}
+
 /****************************************************************************
 
    Main test functions
@@ -207,6 +320,8 @@ void d_mat_test_all()
    RUN_TEST(_d_vec_add_sub);
    RUN_TEST(_d_vec_scalar_product);
    RUN_TEST(_d_vec_norm);
+   RUN_TEST(_d_vec_addmul);
+   RUN_TEST(_d_vec_reflect);
    
    printf(all_success ? "\nAll tests passed\n" :
                         "\nAt least one test FAILED!\n");
@@ -31,14 +31,24 @@
 
 #include "d_mat.h"
 
+#if FLINT_HAVE_AVX2_DISPATCH
+#include <immintrin.h>
+#endif
+
 double ** d_mat_init(ulong r, ulong c)
 {
    double ** B;
+   ulong stride = D_MAT_STRIDE(c);
+
+   B = (double **) malloc (r*sizeof(double*) + r*stride*sizeof(double) + D_MAT_ALIGN);
+   if (r == 0) return B;
 
-   B = (double **) malloc (r*sizeof(double*) + r*c*sizeof(double));
-   B[0] = (double *) (B + r);
+   B[0] = (double *) (((size_t) (B + r) + D_MAT_ALIGN - 1) & ~((size_t) D_MAT_ALIGN - 1));
 	long i;
-	for (i = 1; i < r; i++) B[i] = B[i-1] + c;
+	for (i = 1; i < r; i++) B[i] = B[i-1] + stride;
+   
+   for (i = 0; i < r; i++) 
+      memset(B[i] + c, 0, (stride - c)*sizeof(double));
 
 	return B;
 }
@@ -80,10 +90,87 @@ void _d_vec_sub(double * r1, double * r2, double * r3, ulong n)
 	  r1[i] = r2[i] - r3[i];
 }
 
+#if FLINT_HAVE_AVX2_DISPATCH
+
+FLINT_TARGET_AVX2
+static inline
+double _d_vec_hsum_avx2(__m256d s)
+{
+   __m128d t = _mm_add_pd(_mm256_castpd256_pd128(s), _mm256_extractf128_pd(s, 1));
+   t = _mm_add_sd(t, _mm_unpackhi_pd(t, t));
+   return _mm_cvtsd_f64(t);
+}
+
+FLINT_TARGET_AVX2
+static
+double _d_vec_scalar_product_avx2(double * vec1, double * vec2, ulong n)
+{
+   __m256d s0 = _mm256_setzero_pd();
+   __m256d s1 = _mm256_setzero_pd();
+   double sum;
+   ulong i;
+
+   for (i = 0; i + 8 <= n; i += 8)
+   {
+      s0 = _mm256_fmadd_pd(_mm256_loadu_pd(vec1 + i), _mm256_loadu_pd(vec2 + i), s0);
+      s1 = _mm256_fmadd_pd(_mm256_loadu_pd(vec1 + i + 4), _mm256_loadu_pd(vec2 + i + 4), s1);
+   }
+
+   if (i + 4 <= n)
+   {
+      s0 = _mm256_fmadd_pd(_mm256_loadu_pd(vec1 + i), _mm256_loadu_pd(vec2 + i), s0);
+      i += 4;
+   }
+
+   sum = _d_vec_hsum_avx2(_mm256_add_pd(s0, s1));
+
+   for ( ; i < n; i++)
+      sum += vec1[i] * vec2[i];
+
+   return sum;
+}
+
+FLINT_TARGET_AVX2
+static
+void _d_vec_addmul_avx2(double * r1, double * r2, ulong n, double c)
+{
+   __m256d cc = _mm256_set1_pd(c);
+   ulong i;
+
+   for (i = 0; i + 4 <= n; i += 4)
+      _mm256_storeu_pd(r1 + i, 
+         _mm256_fmadd_pd(cc, _mm256_loadu_pd(r2 + i), _mm256_loadu_pd(r1 + i)));
+
+   for ( ; i < n; i++)
+      r1[i] += c * r2[i];
+}
+
+#endif
+
+void _d_vec_addmul(double * r1, double * r2, ulong n, double c)
+{
+#if FLINT_HAVE_AVX2_DISPATCH
+   if (n >= D_VEC_AVX2_CUTOFF && flint_have_avx2())
+   {
+      _d_vec_addmul_avx2(r1, r2, n, c);
+      return;
+   }
+#endif
+
+   ulong i;
+   for (i = 0; i < n; i++)
+	  r1[i] += c * r2[i];
+}
+
 double _d_vec_scalar_product(double * vec1, double * vec2, ulong n)
 {
   double sum;
 
+#if FLINT_HAVE_AVX2_DISPATCH
+  if (n >= D_VEC_AVX2_CUTOFF && flint_have_avx2())
+     return _d_vec_scalar_product_avx2(vec1, vec2, n);
+#endif
+
   sum = vec1[0] * vec2[0];
   long i;
   for (i = 1; i < n; i++)
@@ -96,6 +183,11 @@ double _d_vec_norm(double * vec, ulong n)
 {
   double sum;
 
+#if FLINT_HAVE_AVX2_DISPATCH
+  if (n >= D_VEC_AVX2_CUTOFF && flint_have_avx2())
+     return _d_vec_scalar_product_avx2(vec, vec, n);
+#endif
+
   sum = vec[0] * vec[0];
   long i;
   for (i = 1 ; i < n ; i++)
@@ -105,3 +197,63 @@ double _d_vec_norm(double * vec, ulong n)
 } 
 
 
+void _d_vec_reflect(double * vec, double * v, ulong n)
+{
+   if (n == 0) return;
+
+   double t = _d_vec_scalar_product(v, vec, n);
+
+   _d_vec_addmul(vec, v, n, -t);
+}
+
+long double ** ld_mat_init(ulong r, ulong c)
+{
+   long double ** B;
+
+   B = (long double **) malloc (r*sizeof(long double*) + r*c*sizeof(long double));
+   B[0] = (long double *) (B + r);
+	long i;
+	for (i = 1; i < r; i++) B[i] = B[i-1] + c;
+
+	return B;
+}
+
+void ld_mat_clear(long double ** B)
+{
+   free(B);
+}
+
+long double _ld_vec_scalar_product(long double * vec1, long double * vec2, ulong n)
+{
+  long double sum = 0.0L;
+
+  long i;
+  for (i = 0; i < n; i++)
+     sum += vec1[i] * vec2[i];
+
+  return sum;
+} 
+
+long double _ld_vec_norm(long double * vec, ulong n)
+{
+  long double sum = 0.0L;
+
+  long i;
+  for (i = 0 ; i < n ; i++)
+     sum += vec[i] * vec[i];
+
+  return sum;
+}
+
+void _ld_vec_reflect(long double * vec, long double * v, ulong n)
+{
+   ulong i;
+   long double t = 0.0L;
+
+   for (i = 0; i < n; i++)
+      t += v[i] * vec[i];
+
+   for (i = 0; i < n; i++)
+      vec[i] -= t * v[i];
+}
+
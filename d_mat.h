@@ -32,7 +32,17 @@
 #endif
  
 #include "flint.h"
-#include "d_mat.h"
+#include "flint-tuning.h"
+
+/*
+   Rows of a d_mat are stored contiguously, each row starting on a 
+   D_MAT_ALIGN byte boundary. The stride between rows is c rounded up 
+   to a multiple of D_MAT_ALIGN bytes, and the padding entries are zero.
+*/
+#define D_MAT_ALIGN 32
+
+#define D_MAT_STRIDE(c) \
+   (((c) + D_MAT_ALIGN/sizeof(double) - 1) & ~(D_MAT_ALIGN/sizeof(double) - 1))
 
 double ** d_mat_init(ulong r, ulong c);
 
@@ -57,12 +67,46 @@ void _d_vec_add(double * r1, double * r2, double * r3, ulong n);
 
 void _d_vec_sub(double * r1, double * r2, double * r3, ulong n);
 
+/* 
+   Sets r1 to r1 + c*r2. 
+*/
+void _d_vec_addmul(double * r1, double * r2, ulong n, double c);
+
 void d_mat_print(double ** B, int * expo, ulong r, ulong c);
 
+/*
+   The scalar product, norm and addmul functions use AVX2/FMA versions when 
+   the machine supports them (see FLINT_HAVE_AVX2_DISPATCH in flint.h) and n 
+   is large enough for this to be worthwhile. The results may then differ in 
+   the last few bits from those of the generic versions.
+*/
+#define D_VEC_AVX2_CUTOFF (flint_tuning.d_vec_avx2_cutoff) // below this length the generic loops are used
+
 double _d_vec_scalar_product(double * vec1, double * vec2, ulong n);
 
 double _d_vec_norm(double * vec, ulong n);
 
+/* 
+   Applies the Householder reflection I - v*v^T to vec, i.e. sets vec to 
+   vec - <v, vec>*v. For this to be a reflection v must have norm 2.
+*/
+void _d_vec_reflect(double * vec, double * v, ulong n);
+
+/* 
+   Long double versions of the above, used where a few more bits of 
+   precision than a double provides are needed.
+*/
+
+long double ** ld_mat_init(ulong r, ulong c);
+
+void ld_mat_clear(long double ** B);
+
+long double _ld_vec_scalar_product(long double * vec1, long double * vec2, ulong n);
+
+long double _ld_vec_norm(long double * vec, ulong n);
+
+void _ld_vec_reflect(long double * vec, long double * v, ulong n);
+
 #ifdef __cplusplus
  }
 #endif
@@ -28,19 +28,75 @@
 #include <math.h>
 #include "flint.h"
 #include "fmpz_poly.h"
+#include "F_mpz.h"
+#include "qexp.h"
+
+/*
+   Prints the coefficient of q^(n+1) in Delta = q F(q)^8 when the block
+   containing the coefficient of q^n in F^8 arrives.
+*/
+void print_coeff(const F_mpz * coeffs, ulong start, ulong len, void * arg)
+{
+   ulong n = *((ulong *) arg);
+
+   if (n >= start && n < start + len)
+   {
+      printf("coefficient of q^%ld is ", n + 1);
+      F_mpz_print(coeffs + n - start); 
+      printf("\n");
+   }
+}
+
+/*
+   Computes the coefficient of q^N in Delta with memory proportional to the
+   block size, using the streaming q-expansion engine.
+*/
+void delta_qexp_stream(ulong N, ulong block)
+{
+   ulong last = N - 1;
+
+   // F(q) = prod (1 - q^n)^3 has at most 4N + 4 as the sum of the absolute
+   // values of its first N coefficients, which bounds the coefficients of F^8
+   qexp_ctx_t ctx;
+   qexp_ctx_init(ctx, N, FLINT_MIN(N, block), 8*FLINT_BIT_COUNT(4*N + 4) + 1);
+
+   // F^2 is generated directly from the sparse series F, F^4 is kept on
+   // disk and F^8 is only streamed
+   FILE * file = tmpfile();
+   qexp_series_t F2, F4;
+   qexp_series_init_gen(F2, qexp_gen_jacobi_sqr, NULL);
+   qexp_series_init_file(F4, file);
+
+   qexp_mul(F4, F2, F2, ctx);
+   qexp_mul_stream(print_coeff, &last, F4, F4, ctx);
+
+   qexp_series_clear(F4);
+   qexp_series_clear(F2);
+   qexp_ctx_clear(ctx);
+   fclose(file);
+
+   _F_mpz_cleanup();
+}
 
 
 int main(int argc, char* argv[])
 {
-   if (argc != 2)
+   if (argc != 2 && argc != 3)
    {
-      printf("Syntax: delta_qexp <integer>\n");
+      printf("Syntax: delta_qexp <integer> [<block>]\n");
       printf("where <integer> is the number of terms to compute\n");
+      printf("and <block> is the number of terms held in memory at once\n");
       return 0;
    }
 
    // number of terms to compute
-   long N = atoi(argv[1]);
+   long N = atol(argv[1]);
+
+   if (argc == 3)
+   {
+      delta_qexp_stream(N, atol(argv[2]));
+      return 0;
+   }
 
    // compute coefficients of F(q)^2
    long* values = malloc(sizeof(long) * N);
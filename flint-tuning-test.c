@@ -0,0 +1,465 @@
+/*============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+===============================================================================*/
+/****************************************************************************
+
+flint-tuning-test.c: test module for the runtime tuning table
+
+Copyright (C) 2010, William Hart
+
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <gmp.h>
+#include "flint.h"
+#include "flint-tuning.h"
+#include "memory-manager.h"
+#include "long_extras.h"
+#include "mpz_extras.h"
+#include "mpn_extras.h"
+#include "F_mpn_mul-tuning.h"
+#include "zmod_poly.h"
+#include "zn_poly/src/zn_poly_internal.h"
+#include "test-support.h"
+
+#define DEBUG 0    // prints debug information
+
+#define TEST_PROFILE "flint-tuning-test.tmp"
+
+/*
+   Compares the tables, ignoring the cpu string
+*/
+
+int flint_tuning_equal(flint_tuning_t * a, flint_tuning_t * b)
+{
+   return !memcmp((char *) a + FLINT_TUNING_CPU_LENGTH, (char *) b + FLINT_TUNING_CPU_LENGTH,
+                                           sizeof(flint_tuning_t) - FLINT_TUNING_CPU_LENGTH);
+}
+
+/*
+   Sets the table to random but sane values
+*/
+
+void flint_tuning_random(void)
+{
+   unsigned long i, len;
+
+   flint_tuning.fft_limbs_thresh = random_ulong(5000) + 100;
+   flint_tuning.ZmodF_mul_plain_threeway_thresh = random_ulong(100) + 3;
+   flint_tuning.ZmodF_mul_plain_fft_thresh = random_ulong(1000) + 100;
+   flint_tuning.ZmodF_mul_threeway_fft_thresh = random_ulong(1000) + 100;
+   flint_tuning.ZmodF_sqr_plain_threeway_thresh = random_ulong(100) + 3;
+   flint_tuning.ZmodF_sqr_plain_fft_thresh = random_ulong(1000) + 100;
+   flint_tuning.ZmodF_sqr_threeway_fft_thresh = random_ulong(1000) + 100;
+
+   len = random_ulong(10);
+   for (i = 0; i < len; i++)
+   {
+      flint_tuning.ZmodF_mul_fft_thresh[i] = (i + 1)*1000 + random_ulong(1000);
+      flint_tuning.ZmodF_sqr_fft_thresh[i] = (i + 1)*1000 + random_ulong(1000);
+   }
+   for ( ; i < FLINT_TUNING_TABLE_LENGTH; i++)
+      flint_tuning.ZmodF_mul_fft_thresh[i] = flint_tuning.ZmodF_sqr_fft_thresh[i] = 0;
+
+   len = random_ulong(FLINT_TUNING_TABLE_LENGTH - 1);
+   for (i = 0; i < len; i++)
+      flint_tuning.mpz_poly_kara_thresh[i] = random_ulong(10) + 3;
+   for ( ; i < FLINT_TUNING_TABLE_LENGTH; i++)
+      flint_tuning.mpz_poly_kara_thresh[i] = 0;
+   flint_tuning.mpz_poly_kara_thresh_size = len + 1;
+
+   flint_tuning.zmod_poly_div_basecase_thresh = random_ulong(500) + 1;
+   flint_tuning.zmod_poly_hgcd_thresh = random_ulong(100) + 20;
+   flint_tuning.zmod_poly_gcd_thresh = random_ulong(500) + 20;
+   flint_tuning.zmod_poly_small_gcd_thresh = random_ulong(500) + 20;
+   flint_tuning.zmod_poly_2x2_transform_thresh = random_ulong(10000) + 1;
+
+   flint_tuning.F_mpz_montgomery_thresh = random_ulong(128);
+   flint_tuning.F_mpz_mod_poly_newton_inverse_thresh = random_ulong(100) + 2;
+   flint_tuning.F_mpz_mod_poly_newton_divrem_thresh = random_ulong(200) + 2;
+   flint_tuning.F_mpz_mpoly_kronecker_ratio = random_ulong(32);
+   flint_tuning.F_mpz_mpoly_threaded_cutoff = random_ulong(200000);
+
+   flint_tuning.F_mpz_radix_digits = random_ulong(F_MPZ_RADIX_MAX_DIGITS) + 1;
+   flint_tuning.F_mpz_radix_task_digits = random_ulong(100000) + 1;
+   flint_tuning.F_mpz_radix_block = random_ulong(10000) + 1;
+
+   flint_tuning.F_mpz_mat_mul_tile_k = random_ulong(100) + 1;
+   flint_tuning.F_mpz_mat_mul_tile_j = random_ulong(300) + 1;
+
+   flint_tuning.ZmodF_poly_four_step_thresh = random_ulong(2000000);
+
+   flint_tuning.F_mpn_bit_pack_avx2_cutoff = random_ulong(1000);
+   flint_tuning.F_mpn_bit_unpack_avx2_cutoff = random_ulong(100);
+
+   flint_tuning.F_mpz_vec_block = random_ulong(100) + 1;
+
+   flint_tuning.zmod_poly_evaluate_vec_cutoff = random_ulong(10);
+   flint_tuning.zmod_poly_evaluate_vec_tree_cutoff = random_ulong(10);
+   flint_tuning.zmod_poly_tree_evaluate_cutoff = random_ulong(100) + 1;
+   flint_tuning.d_vec_avx2_cutoff = random_ulong(100);
+}
+
+/****************************************************************************
+
+   Test code for the tuning table
+
+****************************************************************************/
+
+int test_flint_tuning_save_load()
+{
+   flint_tuning_t tuning, defaults;
+   int result = 1;
+   unsigned long count1;
+
+   flint_tuning_reset();
+   defaults = flint_tuning;
+
+   result = !flint_tuning_load(TEST_PROFILE ".missing");
+
+   for (count1 = 0; count1 < 1000 && result; count1++)
+   {
+      // a section for another machine which must survive the save
+      FILE * file = fopen(TEST_PROFILE, "w");
+      fprintf(file, "[some other cpu, 12 bits]\nfft_limbs_thresh 17\n");
+      fclose(file);
+
+      flint_tuning_random();
+      tuning = flint_tuning;
+
+      result = flint_tuning_save(TEST_PROFILE);
+
+      flint_tuning_reset();
+      if (result) result = flint_tuning_equal(&flint_tuning, &defaults);
+      if (result) result = flint_tuning_load(TEST_PROFILE);
+      if (result) result = flint_tuning_equal(&flint_tuning, &tuning);
+
+      // saving again replaces our section
+      if (result) result = flint_tuning_save(TEST_PROFILE);
+
+      char line[256];
+      unsigned long others = 0, ours = 0;
+      char cpu[FLINT_TUNING_CPU_LENGTH];
+      flint_tuning_cpu(cpu);
+      file = fopen(TEST_PROFILE, "r");
+      while (fgets(line, 256, file) != NULL)
+      {
+         if (!strcmp(line, "[some other cpu, 12 bits]\n")) others++;
+         if (line[0] == '[' && !strncmp(line + 1, cpu, strlen(cpu))) ours++;
+      }
+      fclose(file);
+      if (result) result = (others == 1 && ours == 1);
+
+#if DEBUG
+      if (!result) printf("Error: count1 = %ld, others = %ld, ours = %ld\n", count1, others, ours);
+#endif
+   }
+
+   remove(TEST_PROFILE);
+   flint_tuning_reset();
+
+   return result;
+}
+
+int test_flint_tuning_load_invalid()
+{
+   flint_tuning_t defaults;
+   char cpu[FLINT_TUNING_CPU_LENGTH];
+   int result = 1;
+
+   flint_tuning_reset();
+   defaults = flint_tuning;
+   flint_tuning_cpu(cpu);
+
+   // a table which is not zero terminated
+   FILE * file = fopen(TEST_PROFILE, "w");
+   fprintf(file, "[%s]\nfft_limbs_thresh 17\nZmodF_mul_fft_thresh 100 200\n", cpu);
+   fclose(file);
+
+   result = !flint_tuning_load(TEST_PROFILE) && flint_tuning_equal(&flint_tuning, &defaults);
+
+   // a value out of range
+   file = fopen(TEST_PROFILE, "w");
+   fprintf(file, "[%s]\nfft_limbs_thresh 17\nF_mpz_mat_mul_tile_k 0\n", cpu);
+   fclose(file);
+
+   if (result)
+      result = !flint_tuning_load(TEST_PROFILE) && flint_tuning_equal(&flint_tuning, &defaults);
+
+   file = fopen(TEST_PROFILE, "w");
+   fprintf(file, "[%s]\nF_mpz_radix_digits %lu\n", cpu, F_MPZ_RADIX_MAX_DIGITS + 1UL);
+   fclose(file);
+
+   if (result)
+      result = !flint_tuning_load(TEST_PROFILE) && flint_tuning_equal(&flint_tuning, &defaults);
+
+   // a missing value
+   file = fopen(TEST_PROFILE, "w");
+   fprintf(file, "[%s]\nfft_limbs_thresh\n", cpu);
+   fclose(file);
+
+   if (result)
+      result = !flint_tuning_load(TEST_PROFILE) && flint_tuning_equal(&flint_tuning, &defaults);
+
+   // no section for this machine
+   file = fopen(TEST_PROFILE, "w");
+   fprintf(file, "[some other cpu, 12 bits]\nfft_limbs_thresh 17\n");
+   fclose(file);
+
+   if (result)
+      result = !flint_tuning_load(TEST_PROFILE) && flint_tuning_equal(&flint_tuning, &defaults);
+
+   // a partial section is fine, the other values are kept
+   file = fopen(TEST_PROFILE, "w");
+   fprintf(file, "[%s]\n# comment\nfft_limbs_thresh 17\n\n[other]\nfft_limbs_thresh 18\n", cpu);
+   fclose(file);
+
+   if (result)
+      result = flint_tuning_load(TEST_PROFILE) && (flint_tuning.fft_limbs_thresh == 17);
+   flint_tuning.fft_limbs_thresh = defaults.fft_limbs_thresh;
+   if (result) result = flint_tuning_equal(&flint_tuning, &defaults);
+
+   remove(TEST_PROFILE);
+   flint_tuning_reset();
+
+   return result;
+}
+
+/*
+   Check the dispatchers give the same results with random tuning values
+*/
+
+int test_flint_tuning_dispatch()
+{
+   zmod_poly_t a, b, q1, r1, q2, r2, g1, g2;
+   mpz_t x, y, z1, z2;
+   int result = 1;
+   unsigned long count1;
+
+   mpz_init(x);
+   mpz_init(y);
+   mpz_init(z1);
+   mpz_init(z2);
+
+   for (count1 = 0; count1 < 1000 && result; count1++)
+   {
+      unsigned long p = z_nextprime(z_randbits(random_ulong(FLINT_BITS - 4) + 2) + 2, 0);
+      unsigned long len1 = random_ulong(600) + 1;
+      unsigned long len2 = random_ulong(600) + 1;
+
+      zmod_poly_init(a, p);
+      zmod_poly_init(b, p);
+      zmod_poly_init(q1, p);
+      zmod_poly_init(r1, p);
+      zmod_poly_init(q2, p);
+      zmod_poly_init(r2, p);
+      zmod_poly_init(g1, p);
+      zmod_poly_init(g2, p);
+
+      do zmod_poly_random(a, len1); while (a->length == 0);
+      do zmod_poly_random(b, len2); while (b->length == 0);
+
+      flint_tuning_reset();
+      zmod_poly_divrem(q1, r1, a, b);
+      zmod_poly_gcd(g1, a, b);
+
+      flint_tuning_random();
+      zmod_poly_divrem(q2, r2, a, b);
+      zmod_poly_gcd(g2, a, b);
+      result = zmod_poly_equal(q1, q2) && zmod_poly_equal(r1, r2) && zmod_poly_equal(g1, g2);
+
+      unsigned long bits = random_ulong(300000) + 1;
+      mpz_rrandomb(x, randstate, bits);
+      mpz_rrandomb(y, randstate, random_ulong(bits) + 1);
+
+      flint_tuning_reset();
+      F_mpz_mul(z1, x, y);
+      flint_tuning_random();
+      F_mpz_mul(z2, x, y);
+      if (result) result = (mpz_cmp(z1, z2) == 0);
+
+      // radix conversion with the random number of digits converted directly
+      F_mpz_radix_t R;
+      char * str1 = (char *) malloc(mpz_sizeinbase(x, 10) + 2);
+      char * str2 = (char *) malloc(mpz_sizeinbase(x, 10) + 2);
+      
+      F_mpz_radix_init(R);
+      F_mpz_radix_fit(R, mpz_sizeinbase(x, 10));
+      mpz_get_str(str1, 10, x);
+      F_mpz_radix_get_str(str2, x, R);
+      if (result) result = !strcmp(str1, str2);
+      F_mpz_radix_set_str(z2, str1, strlen(str1), R);
+      if (result) result = (mpz_cmp(z2, x) == 0);
+      F_mpz_radix_clear(R);
+
+      free(str1);
+      free(str2);
+
+      // bit packing, which may or may not use the AVX2 kernels
+      unsigned long n = random_ulong(1000) + 1, fbits = random_ulong(FLINT_BITS) + 1, i;
+      unsigned long k = random_ulong(FLINT_BITS);
+      ulong * vals = (ulong *) malloc(sizeof(ulong)*2*n);
+      mp_limb_t * packed = (mp_limb_t *) malloc(sizeof(mp_limb_t)*(n + 1));
+
+      for (i = 0; i < n; i++)
+         vals[i] = (fbits == FLINT_BITS) ? random_ulong(-1UL) : random_ulong(1UL << fbits);
+      packed[0] = 0;
+      F_mpn_bit_pack(packed, vals, n, fbits, k);
+      F_mpn_bit_unpack(vals + n, packed, n, fbits, k);
+      for (i = 0; i < n && result; i++)
+         result = (vals[i] == vals[n + i]);
+      
+      free(vals);
+      free(packed);
+
+      // multipoint evaluation, which may use Horner's rule or the subproduct tree
+      ulong * points = (ulong *) malloc(sizeof(ulong)*3*len2);
+      for (i = 0; i < len2; i++)
+         points[i] = random_ulong(p);
+      zmod_poly_evaluate_vec(points + len2, a, points, len2);
+      flint_tuning_reset();
+      zmod_poly_evaluate_vec(points + 2*len2, a, points, len2);
+      for (i = 0; i < len2 && result; i++)
+         result = (points[len2 + i] == points[2*len2 + i]);
+
+      free(points);
+
+#if DEBUG
+      if (!result) printf("Error: p = %ld, len1 = %ld, len2 = %ld, bits = %ld\n", p, len1, len2, bits);
+#endif
+
+      zmod_poly_clear(a);
+      zmod_poly_clear(b);
+      zmod_poly_clear(q1);
+      zmod_poly_clear(r1);
+      zmod_poly_clear(q2);
+      zmod_poly_clear(r2);
+      zmod_poly_clear(g1);
+      zmod_poly_clear(g2);
+   }
+
+   mpz_clear(x);
+   mpz_clear(y);
+   mpz_clear(z1);
+   mpz_clear(z2);
+
+   flint_tuning_reset();
+
+   return result;
+}
+
+int test_flint_tuning_measure()
+{
+   unsigned long i;
+   int result = 1;
+
+   flint_tuning_reset();
+   flint_tuning_measure();
+
+#if DEBUG
+   printf("cpu = %s, fft_limbs_thresh = %ld, div = %ld, gcd = %ld, small gcd = %ld\n",
+      flint_tuning.cpu, flint_tuning.fft_limbs_thresh, flint_tuning.zmod_poly_div_basecase_thresh,
+      flint_tuning.zmod_poly_gcd_thresh, flint_tuning.zmod_poly_small_gcd_thresh);
+#endif
+
+   char cpu[FLINT_TUNING_CPU_LENGTH];
+   flint_tuning_cpu(cpu);
+   result = !strcmp(cpu, flint_tuning.cpu);
+
+   result &= (flint_tuning.fft_limbs_thresh >= FFT_MUL_TWK[0][0] && flint_tuning.fft_limbs_thresh <= 20000);
+   result &= (flint_tuning.ZmodF_mul_plain_threeway_thresh >= 3);
+   result &= (flint_tuning.ZmodF_sqr_plain_threeway_thresh >= 3);
+   result &= (flint_tuning.zmod_poly_div_basecase_thresh >= 16);
+   result &= (flint_tuning.zmod_poly_gcd_thresh >= 32);
+   result &= (flint_tuning.zmod_poly_small_gcd_thresh >= 32);
+   result &= (flint_tuning.zmod_poly_evaluate_vec_cutoff >= 1);
+   result &= (flint_tuning.zmod_poly_evaluate_vec_tree_cutoff >= 1);
+   result &= (flint_tuning.zmod_poly_tree_evaluate_cutoff >= 4 && flint_tuning.zmod_poly_tree_evaluate_cutoff <= 128);
+   result &= (flint_tuning.zmod_poly_hgcd_thresh >= 20 && flint_tuning.zmod_poly_hgcd_thresh <= 200);
+   result &= (flint_tuning.zmod_poly_2x2_transform_thresh >= 16);
+   result &= (flint_tuning.F_mpz_montgomery_thresh <= 127);
+   result &= (flint_tuning.F_mpz_mod_poly_newton_inverse_thresh >= 4);
+   result &= (flint_tuning.F_mpz_mod_poly_newton_divrem_thresh >= 4);
+   result &= (flint_tuning.F_mpz_radix_digits >= 64 && flint_tuning.F_mpz_radix_digits <= F_MPZ_RADIX_MAX_DIGITS);
+   result &= (flint_tuning.F_mpz_radix_block >= 1024);
+   result &= (flint_tuning.F_mpz_mat_mul_tile_k >= 16 && flint_tuning.F_mpz_mat_mul_tile_k <= 256);
+   result &= (flint_tuning.F_mpz_mat_mul_tile_j >= 32 && flint_tuning.F_mpz_mat_mul_tile_j <= 512);
+   result &= (flint_tuning.F_mpz_vec_block >= 8 && flint_tuning.F_mpz_vec_block <= 256);
+   result &= (flint_tuning.ZmodF_poly_four_step_thresh >= (1UL<<16));
+
+   // the FFT depth tables are increasing and zero terminated after depth 9
+   for (i = 0; i < 7; i++)
+   {
+      result &= (flint_tuning.ZmodF_mul_fft_thresh[i] >= 16 && flint_tuning.ZmodF_sqr_fft_thresh[i] >= 16);
+      if (i) result &= (flint_tuning.ZmodF_mul_fft_thresh[i] >= flint_tuning.ZmodF_mul_fft_thresh[i - 1]);
+      if (i) result &= (flint_tuning.ZmodF_sqr_fft_thresh[i] >= flint_tuning.ZmodF_sqr_fft_thresh[i - 1]);
+   }
+   result &= (flint_tuning.ZmodF_mul_fft_thresh[7] == 0 && flint_tuning.ZmodF_sqr_fft_thresh[7] == 0);
+
+   // the zn_poly thresholds are in order for every bitsize
+   for (i = 2; i <= FLINT_BITS; i++)
+   {
+      result &= (tuning_info[i].mul_KS2_thresh <= tuning_info[i].mul_KS4_thresh);
+      result &= (tuning_info[i].mul_KS4_thresh <= tuning_info[i].mul_fft_thresh);
+      result &= (tuning_info[i].sqr_KS2_thresh <= tuning_info[i].sqr_KS4_thresh);
+      result &= (tuning_info[i].mulmid_KS2_thresh <= tuning_info[i].mulmid_KS4_thresh);
+      result &= (tuning_info[i].nuss_mul_thresh >= 3 && tuning_info[i].nuss_sqr_thresh >= 3);
+   }
+
+   for (i = 0; i < FLINT_TUNING_TABLE_LENGTH && flint_tuning.mpz_poly_kara_thresh[i]; i++) ;
+   result &= (i < FLINT_TUNING_TABLE_LENGTH && i + 1 == flint_tuning.mpz_poly_kara_thresh_size);
+
+   flint_tuning_reset();
+
+   return result;
+}
+
+/****************************************************************************
+
+   Main test functions
+
+****************************************************************************/
+
+void flint_tuning_test_all()
+{
+   int success, all_success = 1;
+
+   RUN_TEST(flint_tuning_save_load);
+   RUN_TEST(flint_tuning_load_invalid);
+   RUN_TEST(flint_tuning_dispatch);
+   RUN_TEST(flint_tuning_measure);
+
+   printf(all_success ? "\nAll tests passed\n" :
+                        "\nAt least one test FAILED!\n");
+}
+
+int main()
+{
+   test_support_init();
+   flint_tuning_test_all();
+   test_support_cleanup();
+
+   flint_stack_cleanup();
+
+   return 0;
+}
+
+// end of file ****************************************************************
@@ -0,0 +1,1904 @@
+/*============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+===============================================================================*/
+/*
+   flint-tuning.c
+
+   Runtime tuning table, profile files and crossover measurement
+
+   Copyright (C) 2010, William Hart
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <gmp.h>
+#include "flint.h"
+#include "flint-tuning.h"
+#include "memory-manager.h"
+#include "long_extras.h"
+#include "mpn_extras.h"
+#include "F_mpn_mul-tuning.h"
+#include "ZmodF_mul.h"
+#include "mpz_poly.h"
+#include "zmod_poly.h"
+#include "mpz_extras.h"
+#include "ZmodF_poly.h"
+#include "F_mpz.h"
+#include "F_mpz_mod_poly.h"
+#include "F_mpz_mpoly.h"
+#include "F_mpz_mat.h"
+#include "d_mat.h"
+#include "zn_poly/src/zn_poly_internal.h"
+
+/*
+   The compiled in defaults. The ZmodF_mul and mpz_poly values were
+   generated by the tuning programs on sage.math.
+*/
+
+#define FLINT_TUNING_DEFAULT \
+{ \
+   "", \
+   2300, \
+   24, 265, 471, \
+   {252, 561, 1183, 2555, 5368, 14973, 60163, 0}, \
+   36, 560, 330, \
+   {153, 359, 796, 2144, 4314, 14977, 60163, 0}, \
+   {9, 7, 6, 5, 4, 4, 3, 0}, 8, \
+   170, 60, 184, 174, 6000, \
+   64, \
+   32, 96, \
+   8, 100000, \
+   512, 65536, 1048576, \
+   64, 256, \
+   1000000, \
+   256, 16, \
+   32, \
+   4, 2, 16, \
+   8 \
+}
+
+flint_tuning_t flint_tuning = FLINT_TUNING_DEFAULT;
+
+static const flint_tuning_t __flint_tuning_default = FLINT_TUNING_DEFAULT;
+
+/*
+   The zn_poly table has one entry for each bitsize from 0 to ULONG_BITS.
+   We keep a copy of the compiled in values so that they can be restored.
+*/
+
+#define FLINT_TUNING_ZN_LENGTH (ULONG_BITS + 1)
+#define FLINT_TUNING_ZN_FIELDS 13
+
+static tuning_info_t __flint_tuning_zn_default[FLINT_TUNING_ZN_LENGTH];
+static int __flint_tuning_zn_saved = 0;
+
+static void __flint_tuning_zn_save_default(void)
+{
+   if (!__flint_tuning_zn_saved)
+   {
+      memcpy(__flint_tuning_zn_default, tuning_info, sizeof(__flint_tuning_zn_default));
+      __flint_tuning_zn_saved = 1;
+   }
+}
+
+static void __flint_tuning_zn_get(size_t * out, const tuning_info_t * info)
+{
+   out[0] = info->mul_KS2_thresh;
+   out[1] = info->mul_KS4_thresh;
+   out[2] = info->mul_fft_thresh;
+   out[3] = info->sqr_KS2_thresh;
+   out[4] = info->sqr_KS4_thresh;
+   out[5] = info->sqr_fft_thresh;
+   out[6] = info->mulmid_KS2_thresh;
+   out[7] = info->mulmid_KS4_thresh;
+   out[8] = info->mulmid_fft_thresh;
+   out[9] = info->nuss_mul_thresh;
+   out[10] = info->nuss_sqr_thresh;
+   out[11] = info->mul_ntt_thresh;
+   out[12] = info->sqr_ntt_thresh;
+}
+
+static void __flint_tuning_zn_set(tuning_info_t * info, const size_t * in)
+{
+   info->mul_KS2_thresh = in[0];
+   info->mul_KS4_thresh = in[1];
+   info->mul_fft_thresh = in[2];
+   info->sqr_KS2_thresh = in[3];
+   info->sqr_KS4_thresh = in[4];
+   info->sqr_fft_thresh = in[5];
+   info->mulmid_KS2_thresh = in[6];
+   info->mulmid_KS4_thresh = in[7];
+   info->mulmid_fft_thresh = in[8];
+   info->nuss_mul_thresh = in[9];
+   info->nuss_sqr_thresh = in[10];
+   info->mul_ntt_thresh = in[11];
+   info->sqr_ntt_thresh = in[12];
+}
+
+void flint_tuning_reset(void)
+{
+   flint_tuning = __flint_tuning_default;
+
+   __flint_tuning_zn_save_default();
+   memcpy(tuning_info, __flint_tuning_zn_default, sizeof(__flint_tuning_zn_default));
+}
+
+/****************************************************************************
+
+   Profile files
+
+****************************************************************************/
+
+#define FLINT_TUNING_LINE_LENGTH 4096
+
+void flint_tuning_cpu(char * cpu)
+{
+   char line[FLINT_TUNING_LINE_LENGTH];
+   char model[FLINT_TUNING_CPU_LENGTH];
+   strcpy(model, "unknown");
+
+   FILE * file = fopen("/proc/cpuinfo", "r");
+   if (file != NULL)
+   {
+      while (fgets(line, FLINT_TUNING_LINE_LENGTH, file) != NULL)
+      {
+         if (strncmp(line, "model name", 10) && strncmp(line, "cpu model", 9)
+          && strncmp(line, "Processor", 9) && strncmp(line, "cpu\t", 4))
+            continue;
+
+         char * start = strchr(line, ':');
+         if (start == NULL) continue;
+
+         start++;
+         while (*start == ' ' || *start == '\t') start++;
+
+         // '[' and ']' delimit the sections of the profile file
+         unsigned long i;
+         for (i = 0; i < FLINT_TUNING_CPU_LENGTH - 16 && start[i] != '\0'
+                  && start[i] != '\n' && start[i] != '[' && start[i] != ']'; i++)
+            model[i] = start[i];
+         while (i && model[i - 1] == ' ') i--;
+         model[i] = '\0';
+
+         if (i) break;
+         strcpy(model, "unknown");
+      }
+      fclose(file);
+   }
+
+   sprintf(cpu, "%s, %d bits", model, FLINT_BITS);
+}
+
+/*
+   The entries of flint_tuning which are stored in the profile file. Each line
+   of a section consists of the name of an entry followed by its values.
+*/
+
+typedef struct
+{
+   const char * name;
+   unsigned long * value;
+   unsigned long count; // maximum number of values, 1 for a scalar
+   unsigned long min, max; // the range allowed for the values of a scalar
+} __flint_tuning_entry_t;
+
+#define FLINT_TUNING_ENTRIES 33
+
+static void __flint_tuning_entries(__flint_tuning_entry_t * entries, flint_tuning_t * tuning)
+{
+   __flint_tuning_entry_t e[FLINT_TUNING_ENTRIES] =
+   {
+      {"fft_limbs_thresh", &tuning->fft_limbs_thresh, 1, 0, -1UL},
+      {"ZmodF_mul_plain_threeway_thresh", &tuning->ZmodF_mul_plain_threeway_thresh, 1, 0, -1UL},
+      {"ZmodF_mul_plain_fft_thresh", &tuning->ZmodF_mul_plain_fft_thresh, 1, 0, -1UL},
+      {"ZmodF_mul_threeway_fft_thresh", &tuning->ZmodF_mul_threeway_fft_thresh, 1, 0, -1UL},
+      {"ZmodF_mul_fft_thresh", tuning->ZmodF_mul_fft_thresh, FLINT_TUNING_TABLE_LENGTH, 0, -1UL},
+      {"ZmodF_sqr_plain_threeway_thresh", &tuning->ZmodF_sqr_plain_threeway_thresh, 1, 0, -1UL},
+      {"ZmodF_sqr_plain_fft_thresh", &tuning->ZmodF_sqr_plain_fft_thresh, 1, 0, -1UL},
+      {"ZmodF_sqr_threeway_fft_thresh", &tuning->ZmodF_sqr_threeway_fft_thresh, 1, 0, -1UL},
+      {"ZmodF_sqr_fft_thresh", tuning->ZmodF_sqr_fft_thresh, FLINT_TUNING_TABLE_LENGTH, 0, -1UL},
+      {"mpz_poly_kara_thresh", tuning->mpz_poly_kara_thresh, FLINT_TUNING_TABLE_LENGTH, 0, -1UL},
+      {"zmod_poly_div_basecase_thresh", &tuning->zmod_poly_div_basecase_thresh, 1, 0, -1UL},
+      {"zmod_poly_hgcd_thresh", &tuning->zmod_poly_hgcd_thresh, 1, 0, -1UL},
+      {"zmod_poly_gcd_thresh", &tuning->zmod_poly_gcd_thresh, 1, 0, -1UL},
+      {"zmod_poly_small_gcd_thresh", &tuning->zmod_poly_small_gcd_thresh, 1, 0, -1UL},
+      {"zmod_poly_2x2_transform_thresh", &tuning->zmod_poly_2x2_transform_thresh, 1, 1, -1UL},
+      {"F_mpz_montgomery_thresh", &tuning->F_mpz_montgomery_thresh, 1, 0, -1UL},
+      {"F_mpz_mod_poly_newton_inverse_thresh", &tuning->F_mpz_mod_poly_newton_inverse_thresh, 1, 2, -1UL},
+      {"F_mpz_mod_poly_newton_divrem_thresh", &tuning->F_mpz_mod_poly_newton_divrem_thresh, 1, 2, -1UL},
+      {"F_mpz_mpoly_kronecker_ratio", &tuning->F_mpz_mpoly_kronecker_ratio, 1, 0, -1UL},
+      {"F_mpz_mpoly_threaded_cutoff", &tuning->F_mpz_mpoly_threaded_cutoff, 1, 0, -1UL},
+      {"F_mpz_radix_digits", &tuning->F_mpz_radix_digits, 1, 1, F_MPZ_RADIX_MAX_DIGITS},
+      {"F_mpz_radix_task_digits", &tuning->F_mpz_radix_task_digits, 1, 1, -1UL},
+      {"F_mpz_radix_block", &tuning->F_mpz_radix_block, 1, 1, -1UL},
+      {"F_mpz_mat_mul_tile_k", &tuning->F_mpz_mat_mul_tile_k, 1, 1, -1UL},
+      {"F_mpz_mat_mul_tile_j", &tuning->F_mpz_mat_mul_tile_j, 1, 1, -1UL},
+      {"ZmodF_poly_four_step_thresh", &tuning->ZmodF_poly_four_step_thresh, 1, 0, -1UL},
+      {"F_mpn_bit_pack_avx2_cutoff", &tuning->F_mpn_bit_pack_avx2_cutoff, 1, 0, -1UL},
+      {"F_mpn_bit_unpack_avx2_cutoff", &tuning->F_mpn_bit_unpack_avx2_cutoff, 1, 0, -1UL},
+      {"F_mpz_vec_block", &tuning->F_mpz_vec_block, 1, 1, -1UL},
+      {"zmod_poly_evaluate_vec_cutoff", &tuning->zmod_poly_evaluate_vec_cutoff, 1, 0, -1UL},
+      {"zmod_poly_evaluate_vec_tree_cutoff", &tuning->zmod_poly_evaluate_vec_tree_cutoff, 1, 0, -1UL},
+      {"zmod_poly_tree_evaluate_cutoff", &tuning->zmod_poly_tree_evaluate_cutoff, 1, 1, -1UL},
+      {"d_vec_avx2_cutoff", &tuning->d_vec_avx2_cutoff, 1, 0, -1UL}
+   };
+
+   memcpy(entries, e, sizeof(e));
+}
+
+/*
+   Returns 1 if line is the header of the section for the given cpu.
+*/
+
+static int __flint_tuning_is_section(const char * line, const char * cpu)
+{
+   unsigned long len = strlen(cpu);
+
+   return (line[0] == '[' && !strncmp(line + 1, cpu, len) && line[len + 1] == ']');
+}
+
+int flint_tuning_load(const char * filename)
+{
+   char line[FLINT_TUNING_LINE_LENGTH];
+   char cpu[FLINT_TUNING_CPU_LENGTH];
+   __flint_tuning_entry_t entries[FLINT_TUNING_ENTRIES];
+   flint_tuning_t tuning;
+   unsigned long i, j;
+   int found = 0, ok = 1;
+
+   FILE * file = fopen(filename, "r");
+   if (file == NULL) return 0;
+
+   flint_tuning_cpu(cpu);
+
+   // read into copies of the tables, so that nothing changes on failure
+   tuning = flint_tuning;
+   __flint_tuning_entries(entries, &tuning);
+   __flint_tuning_zn_save_default();
+   tuning_info_t * zn = (tuning_info_t *) malloc(sizeof(tuning_info_t)*FLINT_TUNING_ZN_LENGTH);
+   memcpy(zn, tuning_info, sizeof(tuning_info_t)*FLINT_TUNING_ZN_LENGTH);
+
+   while (ok && fgets(line, FLINT_TUNING_LINE_LENGTH, file) != NULL)
+   {
+      if (!found)
+      {
+         found = __flint_tuning_is_section(line, cpu);
+         continue;
+      }
+
+      if (line[0] == '[') break; // the next section
+
+      char * name = strtok(line, " \t\n");
+      if (name == NULL || name[0] == '#') continue;
+
+      if (!strcmp(name, "zn_poly_tuning_info"))
+      {
+         size_t values[FLINT_TUNING_ZN_FIELDS];
+         char * tok = strtok(NULL, " \t\n");
+         unsigned long bits = tok ? strtoul(tok, NULL, 10) : FLINT_TUNING_ZN_LENGTH;
+
+         for (j = 0; j < FLINT_TUNING_ZN_FIELDS && (tok = strtok(NULL, " \t\n")) != NULL; j++)
+            values[j] = (size_t) strtoul(tok, NULL, 10);
+
+         if (bits >= FLINT_TUNING_ZN_LENGTH || j != FLINT_TUNING_ZN_FIELDS) ok = 0;
+         else __flint_tuning_zn_set(zn + bits, values);
+
+         continue;
+      }
+
+      for (i = 0; i < FLINT_TUNING_ENTRIES; i++)
+      {
+         if (strcmp(name, entries[i].name)) continue;
+
+         char * tok;
+         for (j = 0; j < entries[i].count && (tok = strtok(NULL, " \t\n")) != NULL; j++)
+            entries[i].value[j] = strtoul(tok, NULL, 10);
+
+         // tables are zero terminated
+         if (j == 0 || (entries[i].count > 1 && entries[i].value[j - 1] != 0)) ok = 0;
+         else if (entries[i].count == 1 
+            && (entries[i].value[0] < entries[i].min || entries[i].value[0] > entries[i].max)) ok = 0;
+         for ( ; j < entries[i].count; j++)
+            entries[i].value[j] = 0;
+
+         break;
+      }
+   }
+
+   fclose(file);
+
+   if (found && ok)
+   {
+      for (i = 0; tuning.mpz_poly_kara_thresh[i]; i++) ;
+      tuning.mpz_poly_kara_thresh_size = i + 1;
+      strcpy(tuning.cpu, cpu);
+
+      flint_tuning = tuning;
+      memcpy(tuning_info, zn, sizeof(tuning_info_t)*FLINT_TUNING_ZN_LENGTH);
+   }
+
+   free(zn);
+
+   return (found && ok);
+}
+
+int flint_tuning_save(const char * filename)
+{
+   char line[FLINT_TUNING_LINE_LENGTH];
+   char cpu[FLINT_TUNING_CPU_LENGTH];
+   __flint_tuning_entry_t entries[FLINT_TUNING_ENTRIES];
+   unsigned long i, j;
+   int skip = 0;
+
+   flint_tuning_cpu(cpu);
+   __flint_tuning_entries(entries, &flint_tuning);
+
+   // write a new file, then move it over the old one
+   char * temp_name = (char *) malloc(strlen(filename) + 5);
+   sprintf(temp_name, "%s.tmp", filename);
+
+   FILE * out = fopen(temp_name, "w");
+   if (out == NULL)
+   {
+      free(temp_name);
+      return 0;
+   }
+
+   // copy the sections for the other cpus
+   FILE * in = fopen(filename, "r");
+   if (in != NULL)
+   {
+      while (fgets(line, FLINT_TUNING_LINE_LENGTH, in) != NULL)
+      {
+         if (line[0] == '[') skip = __flint_tuning_is_section(line, cpu);
+         if (!skip) fputs(line, out);
+      }
+      fclose(in);
+   }
+
+   fprintf(out, "[%s]\n", cpu);
+   for (i = 0; i < FLINT_TUNING_ENTRIES; i++)
+   {
+      fprintf(out, "%s", entries[i].name);
+      for (j = 0; j < entries[i].count; j++)
+      {
+         fprintf(out, " %lu", entries[i].value[j]);
+         if (entries[i].value[j] == 0) break;
+      }
+      fprintf(out, "\n");
+   }
+
+   for (i = 0; i < FLINT_TUNING_ZN_LENGTH; i++)
+   {
+      size_t values[FLINT_TUNING_ZN_FIELDS];
+      __flint_tuning_zn_get(values, tuning_info + i);
+
+      fprintf(out, "zn_poly_tuning_info %lu", i);
+      for (j = 0; j < FLINT_TUNING_ZN_FIELDS; j++)
+         fprintf(out, " %lu", (unsigned long) values[j]);
+      fprintf(out, "\n");
+   }
+
+   int ok = !ferror(out);
+   ok &= !fclose(out);
+
+   if (ok) ok = !rename(temp_name, filename);
+   else remove(temp_name);
+
+   free(temp_name);
+
+   return ok;
+}
+
+/****************************************************************************
+
+   Measuring crossovers
+
+****************************************************************************/
+
+/*
+   Each sample is timed until it takes at least this long and the best of
+   FLINT_TUNING_REPEATS runs is taken.
+*/
+
+#define FLINT_TUNING_SAMPLE_TIME (CLOCKS_PER_SEC/500)
+#define FLINT_TUNING_REPEATS 3
+
+typedef struct __flint_tuning_sample_s
+{
+   int algo;              // which algorithm to run
+   unsigned long n;       // the size of the problem
+   unsigned long algo1, algo2; // the ZmodF_mul algorithms to compare
+   int squaring;
+   int gcd;               // compare gcd algorithms rather than division
+   unsigned long p;       // the modulus for zmod_poly
+   mp_limb_t * in1, * in2, * out;
+   mpz_t * buf;
+   zmod_poly_t a, b, q, r;
+   ZmodF_mul_info_t info;
+   ulong * points, * values;
+   zmod_poly_tree_t tree;
+   zmod_poly_2x2_mat_t S, T, U;
+   zn_mod_t zn_mod;
+   unsigned zn_bits, zn_field; // the zn_poly table entry being measured
+   pmfvec_t vec1, vec2;
+   ZmodF_poly_t z1, z2;
+   F_mpz_t m, x;
+   F_mpz * vec;
+   F_mpz_mod_ctx_t ctx;
+   F_mpz_mod_poly_t fa, fb, fq, fr;
+   F_mpz_mpoly_t ma, mb, mr;
+   F_mpz_mat_t A, B, C;
+   double * d1, * d2;
+   F_mpz_radix_t R;
+   char * str;
+   FILE * file;
+   unsigned long count;    // the number of integers or vectors
+   unsigned long * field;  // the tuning entry being measured
+   unsigned long off, on;  // values of field which never and always select the algorithm
+   void (*setup)(struct __flint_tuning_sample_s *); // set up a problem of size n
+   void (*sample)(struct __flint_tuning_sample_s *, unsigned long);
+   void (*clear)(struct __flint_tuning_sample_s *);
+} __flint_tuning_sample_t;
+
+/*
+   Returns the time taken by a single call to sample, which runs the sample
+   count times.
+*/
+
+static double __flint_tuning_time(void (*sample)(__flint_tuning_sample_t *, unsigned long),
+                                  __flint_tuning_sample_t * arg)
+{
+   double best = -1.0;
+   unsigned long r;
+
+   for (r = 0; r < FLINT_TUNING_REPEATS; r++)
+   {
+      unsigned long count = 1;
+      clock_t t;
+
+      while (1)
+      {
+         t = clock();
+         sample(arg, count);
+         t = clock() - t;
+
+         if (t >= FLINT_TUNING_SAMPLE_TIME) break;
+         count *= 2;
+      }
+
+      double time = (double) t / count;
+      if (best < 0.0 || time < best) best = time;
+   }
+
+   return best;
+}
+
+/*
+   Finds the smallest n in [lo, hi], up to 10%, at which wins(n, arg)
+   becomes nonzero, assuming that it only changes once.
+*/
+
+static unsigned long __flint_tuning_crossover(int (*wins)(unsigned long, __flint_tuning_sample_t *),
+                           __flint_tuning_sample_t * arg, unsigned long lo, unsigned long hi)
+{
+   if (wins(lo, arg)) return lo;
+   if (!wins(hi, arg)) return hi;
+
+   while (10*hi > 11*lo + 10)
+   {
+      unsigned long mid = (unsigned long) sqrt((double) lo * (double) hi);
+      if (mid <= lo) mid = lo + 1;
+
+      if (wins(mid, arg)) hi = mid;
+      else lo = mid;
+   }
+
+   return hi;
+}
+
+/*
+   Sets the tuning entry being measured to value and returns its previous 
+   value. This is *arg->field or, if that is NULL, entry zn_field of the 
+   zn_poly table for moduli of zn_bits bits, in the order of 
+   __flint_tuning_zn_get.
+*/
+
+static unsigned long __flint_tuning_set(__flint_tuning_sample_t * arg, unsigned long value)
+{
+   unsigned long old;
+
+   if (arg->field != NULL)
+   {
+      old = *arg->field;
+      *arg->field = value;
+   } else
+   {
+      size_t values[FLINT_TUNING_ZN_FIELDS];
+      
+      __flint_tuning_zn_get(values, tuning_info + arg->zn_bits);
+      old = values[arg->zn_field];
+      values[arg->zn_field] = value;
+      __flint_tuning_zn_set(tuning_info + arg->zn_bits, values);
+   }
+
+   return old;
+}
+
+/*
+   Compares the algorithms selected by the tuning entry being measured on 
+   a problem of size n, set up by arg->setup, by timing arg->sample with 
+   the entry set to arg->off and to arg->on. Returns 1 if the latter is 
+   faster. The entry is left unchanged.
+*/
+
+static int __flint_tuning_field_wins(unsigned long n, __flint_tuning_sample_t * arg)
+{
+   double time1, time2;
+
+   arg->n = n;
+   arg->setup(arg);
+
+   unsigned long saved = __flint_tuning_set(arg, arg->off);
+   time1 = __flint_tuning_time(arg->sample, arg);
+   __flint_tuning_set(arg, arg->on);
+   time2 = __flint_tuning_time(arg->sample, arg);
+   __flint_tuning_set(arg, saved);
+
+   arg->clear(arg);
+
+   return (time2 < time1);
+}
+
+/*
+   Sets the tuning entry being measured to whichever of the count 
+   candidates gives the fastest run of arg->sample on a problem of size n.
+*/
+
+static void __flint_tuning_field_best(__flint_tuning_sample_t * arg, unsigned long n,
+                                      const unsigned long * candidates, unsigned long count)
+{
+   unsigned long i, best = candidates[0];
+   double time, best_time = -1.0;
+
+   arg->n = n;
+   arg->setup(arg);
+
+   for (i = 0; i < count; i++)
+   {
+      __flint_tuning_set(arg, candidates[i]);
+      time = __flint_tuning_time(arg->sample, arg);
+      if (best_time < 0.0 || time < best_time)
+      {
+         best_time = time;
+         best = candidates[i];
+      }
+   }
+
+   __flint_tuning_set(arg, best);
+   arg->clear(arg);
+}
+
+/*
+   F_mpn_mul vs mpn_mul
+*/
+
+static void __flint_tuning_sample_fft(__flint_tuning_sample_t * arg, unsigned long count)
+{
+   unsigned long i;
+
+   for (i = 0; i < count; i++)
+   {
+      if (arg->algo) F_mpn_mul(arg->out, arg->in1, arg->n, arg->in2, arg->n);
+      else mpn_mul(arg->out, arg->in1, arg->n, arg->in2, arg->n);
+   }
+}
+
+static int __flint_tuning_fft_wins(unsigned long n, __flint_tuning_sample_t * arg)
+{
+   unsigned long i;
+   double time1, time2;
+
+   arg->n = n;
+   arg->in1 = (mp_limb_t *) flint_heap_alloc(n);
+   arg->in2 = (mp_limb_t *) flint_heap_alloc(n);
+   arg->out = (mp_limb_t *) flint_heap_alloc(2*n);
+   for (i = 0; i < n; i++)
+   {
+      arg->in1[i] = z_randint(0L);
+      arg->in2[i] = z_randint(0L);
+   }
+
+   arg->algo = 0;
+   time1 = __flint_tuning_time(__flint_tuning_sample_fft, arg);
+   arg->algo = 1;
+   time2 = __flint_tuning_time(__flint_tuning_sample_fft, arg);
+
+   flint_heap_free(arg->out);
+   flint_heap_free(arg->in2);
+   flint_heap_free(arg->in1);
+
+   return (time2 < time1);
+}
+
+/*
+   ZmodF_mul algorithms, as in ZmodF_mul-tune.c: algo is 0 for the plain
+   algorithm, 1 for the threeway algorithm and the FFT depth otherwise
+*/
+
+static void __flint_tuning_sample_ZmodF(__flint_tuning_sample_t * arg, unsigned long count)
+{
+   unsigned long i;
+
+   for (i = 0; i < count; i++)
+      ZmodF_mul_info_mul(arg->info, arg->out, arg->in1, arg->squaring ? arg->in1 : arg->in2);
+}
+
+static double __flint_tuning_time_ZmodF(__flint_tuning_sample_t * arg, unsigned long algo)
+{
+   if (algo == 0)
+      ZmodF_mul_info_init_plain(arg->info, arg->n, arg->squaring);
+   else if (algo == 1)
+      ZmodF_mul_info_init_threeway(arg->info, arg->n, arg->squaring);
+   else
+      ZmodF_mul_info_init_fft(arg->info, arg->n, algo, 0, 0, arg->squaring);
+
+   double time = __flint_tuning_time(__flint_tuning_sample_ZmodF, arg);
+
+   ZmodF_mul_info_clear(arg->info);
+
+   return time;
+}
+
+static int __flint_tuning_ZmodF_wins(unsigned long n, __flint_tuning_sample_t * arg)
+{
+   unsigned long algo1 = arg->algo1, algo2 = arg->algo2;
+   unsigned long i;
+   double time1, time2;
+
+   // round n up to suit both algorithms
+   unsigned long round = 1;
+   if (algo1 == 1 || algo2 == 1)
+      round = 3;
+   if (algo1 > FLINT_LG_BITS_PER_LIMB || algo2 > FLINT_LG_BITS_PER_LIMB)
+      round <<= (FLINT_MAX(algo1, algo2) - FLINT_LG_BITS_PER_LIMB);
+   n = (((n - 1) / round) + 1) * round;
+
+   arg->n = n;
+   arg->in1 = (mp_limb_t *) flint_heap_alloc(n + 1);
+   arg->in2 = (mp_limb_t *) flint_heap_alloc(n + 1);
+   arg->out = (mp_limb_t *) flint_heap_alloc(n + 1);
+   for (i = 0; i < n; i++)
+   {
+      arg->in1[i] = z_randint(0L);
+      arg->in2[i] = z_randint(0L);
+   }
+   arg->in1[n] = arg->in2[n] = 0L;
+
+   time1 = __flint_tuning_time_ZmodF(arg, algo1);
+   time2 = __flint_tuning_time_ZmodF(arg, algo2);
+
+   flint_heap_free(arg->out);
+   flint_heap_free(arg->in2);
+   flint_heap_free(arg->in1);
+
+   return (time2 < time1);
+}
+
+/*
+   Karatsuba vs classical multiplication in mpz_poly, as in mpz_poly-tune.c
+*/
+
+static void __flint_tuning_sample_kara(__flint_tuning_sample_t * arg, unsigned long count)
+{
+   unsigned long length = arg->n;
+   unsigned long crossover = arg->algo ? length*length : 2*length*length;
+   unsigned long i;
+
+   mpz_t * in1 = arg->buf;
+   mpz_t * in2 = in1 + length;
+   mpz_t * out = in2 + length;
+   mpz_t * scratch = out + length;
+
+   for (i = 0; i < count; i++)
+      _mpz_poly_mul_kara_recursive(out, in1, length, in2, length, scratch, 1, crossover);
+}
+
+static int __flint_tuning_kara_wins(unsigned long length, unsigned long limbs)
+{
+   __flint_tuning_sample_t arg;
+   unsigned long i, j;
+   double time1, time2;
+
+   arg.n = length;
+   arg.buf = (mpz_t *) flint_heap_alloc_bytes(6*length*sizeof(mpz_t));
+   for (i = 0; i < 6*length; i++)
+      mpz_init2(arg.buf[i], 3*limbs*FLINT_BITS);
+
+   // leave a few zero high bits to prevent carries in the multiplication
+   mp_limb_t * data = (mp_limb_t *) flint_heap_alloc(limbs);
+   for (i = 0; i < 2*length; i++)
+   {
+      for (j = 0; j < limbs; j++)
+         data[j] = z_randint(0L);
+      data[limbs - 1] >>= FLINT_BITS/3;
+      mpz_import(arg.buf[i], limbs, -1, sizeof(mp_limb_t), 0, 0, data);
+   }
+   flint_heap_free(data);
+
+   arg.algo = 0;
+   time1 = __flint_tuning_time(__flint_tuning_sample_kara, &arg);
+   arg.algo = 1;
+   time2 = __flint_tuning_time(__flint_tuning_sample_kara, &arg);
+
+   for (i = 0; i < 6*length; i++)
+      mpz_clear(arg.buf[i]);
+   flint_heap_free(arg.buf);
+
+   return (time2 < time1);
+}
+
+/*
+   Basecase vs divide and conquer division and euclidean vs half gcd in
+   zmod_poly. The modulus is arg->p.
+*/
+
+static void __flint_tuning_sample_zmod_poly(__flint_tuning_sample_t * arg, unsigned long count)
+{
+   unsigned long i;
+
+   for (i = 0; i < count; i++)
+   {
+      switch (arg->algo)
+      {
+         case 0:
+            zmod_poly_divrem_basecase(arg->q, arg->r, arg->a, arg->b);
+            break;
+         case 1:
+            zmod_poly_divrem_divconquer(arg->q, arg->r, arg->a, arg->b);
+            break;
+         case 2:
+            zmod_poly_gcd_euclidean(arg->q, arg->a, arg->b);
+            break;
+         case 3:
+            zmod_poly_gcd_hgcd(arg->q, arg->a, arg->b);
+            break;
+      }
+   }
+}
+
+static int __flint_tuning_zmod_poly_wins(unsigned long n, __flint_tuning_sample_t * arg)
+{
+   unsigned long p = arg->p;
+   int gcd = arg->gcd;
+   double time1, time2;
+
+   zmod_poly_init(arg->a, p);
+   zmod_poly_init(arg->b, p);
+   zmod_poly_init(arg->q, p);
+   zmod_poly_init(arg->r, p);
+
+   do zmod_poly_random(arg->a, gcd ? n : 2*n - 1); while (arg->a->length == 0);
+   do zmod_poly_random(arg->b, n); while (arg->b->length < n);
+
+   arg->algo = 2*gcd;
+   time1 = __flint_tuning_time(__flint_tuning_sample_zmod_poly, arg);
+   arg->algo = 2*gcd + 1;
+   time2 = __flint_tuning_time(__flint_tuning_sample_zmod_poly, arg);
+
+   zmod_poly_clear(arg->a);
+   zmod_poly_clear(arg->b);
+   zmod_poly_clear(arg->q);
+   zmod_poly_clear(arg->r);
+
+   return (time2 < time1);
+}
+
+/*
+   Multipoint evaluation in zmod_poly of a polynomial of length n at n 
+   points. If arg->algo is set the subproduct tree is built in advance.
+*/
+
+static void __flint_tuning_setup_evaluate(__flint_tuning_sample_t * arg)
+{
+   unsigned long i, n = arg->n;
+
+   zmod_poly_init(arg->a, arg->p);
+   zmod_poly_random(arg->a, n);
+
+   arg->points = (ulong *) flint_heap_alloc(n);
+   arg->values = (ulong *) flint_heap_alloc(n);
+   for (i = 0; i < n; i++)
+      arg->points[i] = z_randint(arg->p);
+
+   if (arg->algo) zmod_poly_tree_init(arg->tree, arg->points, n, arg->p);
+}
+
+static void __flint_tuning_sample_evaluate(__flint_tuning_sample_t * arg, unsigned long count)
+{
+   unsigned long i;
+
+   for (i = 0; i < count; i++)
+   {
+      if (arg->algo) zmod_poly_evaluate_vec_tree(arg->values, arg->a, arg->tree);
+      else zmod_poly_evaluate_vec(arg->values, arg->a, arg->points, arg->n);
+   }
+}
+
+static void __flint_tuning_clear_evaluate(__flint_tuning_sample_t * arg)
+{
+   if (arg->algo) zmod_poly_tree_clear(arg->tree);
+
+   flint_heap_free(arg->values);
+   flint_heap_free(arg->points);
+   zmod_poly_clear(arg->a);
+}
+
+/*
+   The evaluation cutoffs compare length*n with cutoff*L*log(L)^2, see 
+   __zmod_poly_evaluate_vec_use_horner, so a crossover at length = n = L 
+   corresponds to a cutoff of L/log(L)^2.
+*/
+
+static unsigned long __flint_tuning_evaluate_cutoff(unsigned long n)
+{
+   unsigned long lg = FLINT_BIT_COUNT(n);
+
+   return FLINT_MAX((n + lg*lg/2)/(lg*lg), 1);
+}
+
+/*
+   Half gcd in zmod_poly of two polynomials of length n and products of
+   2x2 matrices whose entries have length n. The modulus is arg->p.
+*/
+
+static void __flint_tuning_setup_hgcd(__flint_tuning_sample_t * arg)
+{
+   zmod_poly_init(arg->a, arg->p);
+   zmod_poly_init(arg->b, arg->p);
+   zmod_poly_init(arg->q, arg->p);
+
+   do zmod_poly_random(arg->a, arg->n); while (arg->a->length < arg->n);
+   do zmod_poly_random(arg->b, arg->n); while (arg->b->length < arg->n);
+}
+
+static void __flint_tuning_sample_hgcd(__flint_tuning_sample_t * arg, unsigned long count)
+{
+   unsigned long i;
+
+   for (i = 0; i < count; i++)
+      zmod_poly_gcd_hgcd(arg->q, arg->a, arg->b);
+}
+
+static void __flint_tuning_clear_hgcd(__flint_tuning_sample_t * arg)
+{
+   zmod_poly_clear(arg->a);
+   zmod_poly_clear(arg->b);
+   zmod_poly_clear(arg->q);
+}
+
+static void __flint_tuning_2x2_mat_random(zmod_poly_2x2_mat_t mat, unsigned long n)
+{
+   do zmod_poly_random(mat->a, n); while (mat->a->length < n);
+   do zmod_poly_random(mat->b, n); while (mat->b->length < n);
+   do zmod_poly_random(mat->c, n); while (mat->c->length < n);
+   do zmod_poly_random(mat->d, n); while (mat->d->length < n);
+}
+
+static void __flint_tuning_setup_2x2(__flint_tuning_sample_t * arg)
+{
+   zmod_poly_2x2_mat_init(arg->S, arg->p);
+   zmod_poly_2x2_mat_init(arg->T, arg->p);
+   zmod_poly_2x2_mat_init(arg->U, arg->p);
+
+   __flint_tuning_2x2_mat_random(arg->S, arg->n);
+   __flint_tuning_2x2_mat_random(arg->T, arg->n);
+}
+
+static void __flint_tuning_sample_2x2(__flint_tuning_sample_t * arg, unsigned long count)
+{
+   unsigned long i;
+
+   for (i = 0; i < count; i++)
+      zmod_poly_2x2_mat_mul(arg->U, arg->S, arg->T);
+}
+
+static void __flint_tuning_clear_2x2(__flint_tuning_sample_t * arg)
+{
+   zmod_poly_2x2_mat_clear(arg->S);
+   zmod_poly_2x2_mat_clear(arg->T);
+   zmod_poly_2x2_mat_clear(arg->U);
+}
+
+/*
+   Modular exponentiation in F_mpz, with an odd modulus and an exponent of
+   n limbs each.
+*/
+
+static void __flint_tuning_setup_powm(__flint_tuning_sample_t * arg)
+{
+   unsigned long bits = arg->n*FLINT_BITS;
+
+   F_mpz_init(arg->m);
+   F_mpz_init(arg->x);
+   arg->vec = _F_mpz_vec_init(2);
+
+   // m = 2^(bits - 1) + 2x + 1 has exactly n limbs
+   F_mpz_random(arg->x, bits - 2);
+   F_mpz_mul_2exp(arg->x, arg->x, 1);
+   F_mpz_add_ui(arg->x, arg->x, 1L);
+   F_mpz_set_ui(arg->m, 1L);
+   F_mpz_mul_2exp(arg->m, arg->m, bits - 1);
+   F_mpz_add(arg->m, arg->m, arg->x);
+   F_mpz_mod_ctx_init(arg->ctx, arg->m);
+
+   F_mpz_random(arg->x, bits - 1);
+   F_mpz_random(arg->vec, bits);
+}
+
+static void __flint_tuning_sample_powm(__flint_tuning_sample_t * arg, unsigned long count)
+{
+   unsigned long i;
+
+   for (i = 0; i < count; i++)
+      F_mpz_powm_ctx(arg->vec + 1, arg->x, arg->vec, arg->ctx);
+}
+
+static void __flint_tuning_clear_powm(__flint_tuning_sample_t * arg)
+{
+   F_mpz_mod_ctx_clear(arg->ctx);
+   _F_mpz_vec_clear(arg->vec, 2);
+   F_mpz_clear(arg->x);
+   F_mpz_clear(arg->m);
+}
+
+/*
+   Newton inversion of a power series of length n and division of a
+   polynomial of length 2n by one of length n in F_mpz_mod_poly, modulo
+   an odd modulus of three limbs. If arg->algo is set the division is
+   timed, otherwise the inversion. For the inversion the cutoff is
+   compared with n itself, so the entry is set to n + 1 for the basecase
+   and to n for one level of Newton iteration.
+*/
+
+static void __flint_tuning_F_mpz_mod_poly_random(F_mpz_mod_poly_t poly, unsigned long length)
+{
+   unsigned long i, bits = F_mpz_bits(poly->P);
+
+   F_mpz_mod_poly_fit_length(poly, length);
+   for (i = 0; i < length; i++)
+   {
+      F_mpz_random(poly->coeffs + i, bits);
+      F_mpz_mod(poly->coeffs + i, poly->coeffs + i, poly->P);
+   }
+
+   // make the polynomial invertible as a series and monic
+   F_mpz_set_ui(poly->coeffs, 1L);
+   F_mpz_set_ui(poly->coeffs + length - 1, 1L);
+   _F_mpz_mod_poly_set_length(poly, length);
+}
+
+static void __flint_tuning_setup_newton(__flint_tuning_sample_t * arg)
+{
+   unsigned long n = arg->n;
+
+   F_mpz_init(arg->m);
+   F_mpz_random(arg->m, 3*FLINT_BITS - 1);
+   F_mpz_mul_2exp(arg->m, arg->m, 1);
+   F_mpz_add_ui(arg->m, arg->m, 1L);
+
+   F_mpz_mod_poly_init(arg->fa, arg->m);
+   F_mpz_mod_poly_init(arg->fb, arg->m);
+   F_mpz_mod_poly_init(arg->fq, arg->m);
+   F_mpz_mod_poly_init(arg->fr, arg->m);
+
+   __flint_tuning_F_mpz_mod_poly_random(arg->fa, arg->algo ? 2*n : n);
+   __flint_tuning_F_mpz_mod_poly_random(arg->fb, n);
+
+   if (!arg->algo)
+   {
+      arg->off = n + 1;
+      arg->on = n;
+   }
+}
+
+static void __flint_tuning_sample_newton(__flint_tuning_sample_t * arg, unsigned long count)
+{
+   unsigned long i;
+
+   for (i = 0; i < count; i++)
+   {
+      if (arg->algo) F_mpz_mod_poly_divrem(arg->fq, arg->fr, arg->fa, arg->fb);
+      else F_mpz_mod_poly_newton_invert(arg->fq, arg->fa, arg->n);
+   }
+}
+
+static void __flint_tuning_clear_newton(__flint_tuning_sample_t * arg)
+{
+   F_mpz_mod_poly_clear(arg->fa);
+   F_mpz_mod_poly_clear(arg->fb);
+   F_mpz_mod_poly_clear(arg->fq);
+   F_mpz_mod_poly_clear(arg->fr);
+   F_mpz_clear(arg->m);
+}
+
+/*
+   Products in F_mpz_mpoly of two univariate polynomials with n terms and
+   exponents evenly spread over [0, FLINT_TUNING_MPOLY_DEGREE). If
+   arg->algo is set F_mpz_mpoly_mul_heap is timed, otherwise F_mpz_mpoly_mul.
+*/
+
+#define FLINT_TUNING_MPOLY_DEGREE 4096
+
+static void __flint_tuning_mpoly_random(F_mpz_mpoly_t poly, unsigned long n)
+{
+   unsigned long i, exp;
+
+   F_mpz_mpoly_init2(poly, n, 1, GRLEX);
+   for (i = 0; i < n; i++)
+   {
+      F_mpz_mpoly_set_coeff_ui(poly, i, z_randint(1L<<20) + 1);
+      exp = (i*FLINT_TUNING_MPOLY_DEGREE)/n;
+      if (exp) F_mpz_mpoly_set_var_exp(poly, i, 0, exp);
+   }
+}
+
+static void __flint_tuning_setup_mpoly(__flint_tuning_sample_t * arg)
+{
+   __flint_tuning_mpoly_random(arg->ma, arg->n);
+   __flint_tuning_mpoly_random(arg->mb, arg->n);
+   F_mpz_mpoly_init2(arg->mr, 0, 1, GRLEX);
+}
+
+static void __flint_tuning_sample_mpoly(__flint_tuning_sample_t * arg, unsigned long count)
+{
+   unsigned long i;
+
+   for (i = 0; i < count; i++)
+   {
+      if (arg->algo) F_mpz_mpoly_mul_heap(arg->mr, arg->ma, arg->mb);
+      else F_mpz_mpoly_mul(arg->mr, arg->ma, arg->mb);
+   }
+}
+
+static void __flint_tuning_clear_mpoly(__flint_tuning_sample_t * arg)
+{
+   F_mpz_mpoly_clear(arg->ma);
+   F_mpz_mpoly_clear(arg->mb);
+   F_mpz_mpoly_clear(arg->mr);
+}
+
+/*
+   Both inputs have their largest exponent at (n - 1)*D/n and their
+   smallest at 0, so their Kronecker substitutions have that many
+   coefficients plus one, and the ratio at a crossover at n terms is
+   n^2 over the sum of their lengths.
+*/
+
+static unsigned long __flint_tuning_kronecker_ratio(unsigned long n)
+{
+   unsigned long len = ((n - 1)*FLINT_TUNING_MPOLY_DEGREE)/n + 1;
+
+   return (n*n)/(2*len);
+}
+
+/*
+   Decimal conversion of arg->count integers of n digits each. If arg->algo
+   is 0 the F_mpz_radix_t is set up in the sample, as the number of digits
+   converted by GMP is read when it is initialised. If it is 2 the integers
+   are written to and read from a temporary file, if one can be opened.
+*/
+
+static void __flint_tuning_mpz_random(mpz_t x, unsigned long limbs)
+{
+   unsigned long i;
+   mp_limb_t * data = (mp_limb_t *) flint_heap_alloc(limbs);
+
+   for (i = 0; i < limbs; i++)
+      data[i] = z_randint(0L);
+   mpz_import(x, limbs, -1, sizeof(mp_limb_t), 0, 0, data);
+
+   flint_heap_free(data);
+}
+
+static void __flint_tuning_setup_radix(__flint_tuning_sample_t * arg)
+{
+   // 10^n is a little under 2^(3.32n)
+   unsigned long i, limbs = (arg->n*3321)/(1000*FLINT_BITS) + 1;
+
+   arg->buf = (mpz_t *) flint_heap_alloc_bytes(2*arg->count*sizeof(mpz_t));
+   for (i = 0; i < 2*arg->count; i++)
+      mpz_init(arg->buf[i]);
+   for (i = 0; i < arg->count; i++)
+      __flint_tuning_mpz_random(arg->buf[i], limbs);
+
+   arg->str = (char *) malloc(F_mpz_radix_vec_str_size(arg->buf, arg->count));
+   arg->file = (arg->algo == 2) ? tmpfile() : NULL;
+
+   if (arg->algo) F_mpz_radix_init(arg->R);
+}
+
+static void __flint_tuning_sample_radix(__flint_tuning_sample_t * arg, unsigned long count)
+{
+   unsigned long i, n = arg->count;
+
+   for (i = 0; i < count; i++)
+   {
+      if (!arg->algo) F_mpz_radix_init(arg->R);
+
+      if (arg->file != NULL)
+      {
+         rewind(arg->file);
+         F_mpz_radix_vec_fprint(arg->file, arg->buf, n, arg->R);
+         rewind(arg->file);
+         F_mpz_radix_vec_fread(arg->buf + n, n, arg->file, arg->R);
+      } else
+      {
+         F_mpz_radix_vec_get_str(arg->str, arg->buf, n, arg->R);
+         F_mpz_radix_vec_set_str(arg->buf + n, n, arg->str, NULL, arg->R);
+      }
+
+      if (!arg->algo) F_mpz_radix_clear(arg->R);
+   }
+}
+
+static void __flint_tuning_clear_radix(__flint_tuning_sample_t * arg)
+{
+   unsigned long i;
+
+   if (arg->algo) F_mpz_radix_clear(arg->R);
+   if (arg->file != NULL) fclose(arg->file);
+   free(arg->str);
+
+   for (i = 0; i < 2*arg->count; i++)
+      mpz_clear(arg->buf[i]);
+   flint_heap_free(arg->buf);
+}
+
+/*
+   Classical multiplication of n x n matrices in F_mpz_mat and sums and
+   scalar products of vectors of length n in F_mpz, with 20 bit entries
+   so that the products are accumulated in doubles. If arg->algo is set
+   the vectors are timed, otherwise the matrices.
+*/
+
+static void __flint_tuning_setup_mat(__flint_tuning_sample_t * arg)
+{
+   unsigned long i, j, n = arg->n;
+
+   if (arg->algo)
+   {
+      F_mpz_init(arg->x);
+      arg->vec = _F_mpz_vec_init(3*n);
+      for (i = 0; i < 2*n; i++)
+         F_mpz_random(arg->vec + i, 20);
+   } else
+   {
+      F_mpz_mat_init(arg->A, n, n);
+      F_mpz_mat_init(arg->B, n, n);
+      F_mpz_mat_init(arg->C, n, n);
+      for (i = 0; i < n; i++)
+      {
+         for (j = 0; j < n; j++)
+         {
+            F_mpz_random(arg->A->rows[i] + j, 20);
+            F_mpz_random(arg->B->rows[i] + j, 20);
+         }
+      }
+   }
+}
+
+static void __flint_tuning_sample_mat(__flint_tuning_sample_t * arg, unsigned long count)
+{
+   unsigned long i, n = arg->n;
+
+   for (i = 0; i < count; i++)
+   {
+      if (arg->algo)
+      {
+         _F_mpz_vec_add(arg->vec + 2*n, arg->vec, arg->vec + n, n);
+         _F_mpz_vec_scalar_product(arg->x, arg->vec, arg->vec + n, n);
+      } else
+         _F_mpz_mat_mul_classical(arg->C, arg->A, arg->B);
+   }
+}
+
+static void __flint_tuning_clear_mat(__flint_tuning_sample_t * arg)
+{
+   if (arg->algo)
+   {
+      _F_mpz_vec_clear(arg->vec, 3*arg->n);
+      F_mpz_clear(arg->x);
+   } else
+   {
+      F_mpz_mat_clear(arg->A);
+      F_mpz_mat_clear(arg->B);
+      F_mpz_mat_clear(arg->C);
+   }
+}
+
+/*
+   Convolution of ZmodF_polys with 2^depth coefficients of n + 1 limbs,
+   where 2^depth*(n + 1) is about arg->n, by ZmodF_poly_convolution or
+   ZmodF_poly_convolution_four_step, chosen as in F_mpn_mul. The inputs
+   are restored from arg->in1 before each convolution.
+*/
+
+static void __flint_tuning_setup_four_step(__flint_tuning_sample_t * arg)
+{
+   unsigned long depth = (FLINT_BIT_COUNT(arg->n) + 1)/2;
+   unsigned long n = (arg->n >> depth) - 1;
+   unsigned long i, size, scratch = ZmodF_poly_four_step_threads();
+
+   // the coefficients must have room for the roots of unity
+   if (depth > FLINT_LG_BITS_PER_LIMB + 1)
+   {
+      unsigned long round = 1UL << (depth - FLINT_LG_BITS_PER_LIMB - 1);
+      n = FLINT_MAX(n/round, 1)*round;
+   }
+
+   ZmodF_poly_init(arg->z1, depth, n, scratch);
+   ZmodF_poly_init(arg->z2, depth, n, scratch);
+
+   size = (1UL << depth)*(n + 1);
+   arg->in1 = (mp_limb_t *) flint_heap_alloc(size);
+   for (i = 0; i < size; i++)
+      arg->in1[i] = z_randint(0L);
+   for (i = n; i < size; i += n + 1)
+      arg->in1[i] = 0L;
+}
+
+static void __flint_tuning_sample_four_step(__flint_tuning_sample_t * arg, unsigned long count)
+{
+   unsigned long i, j;
+   unsigned long n = arg->z1->n, half = 1UL << (arg->z1->depth - 1);
+
+   for (i = 0; i < count; i++)
+   {
+      for (j = 0; j < half; j++)
+      {
+         F_mpn_copy(arg->z1->coeffs[j], arg->in1 + j*(n + 1), n + 1);
+         F_mpn_copy(arg->z2->coeffs[j], arg->in1 + (half + j)*(n + 1), n + 1);
+      }
+      arg->z1->length = arg->z2->length = half;
+
+      if ((2*half)*(n + 1) > ZMODFPOLY_FOUR_STEP_THRESHOLD)
+         ZmodF_poly_convolution_four_step(arg->z1, arg->z2);
+      else
+         ZmodF_poly_convolution(arg->z1, arg->z1, arg->z2);
+   }
+}
+
+static void __flint_tuning_clear_four_step(__flint_tuning_sample_t * arg)
+{
+   flint_heap_free(arg->in1);
+   ZmodF_poly_clear(arg->z1);
+   ZmodF_poly_clear(arg->z2);
+}
+
+/*
+   Bit packing of n values of 16 bits if arg->algo is 0, unpacking if it
+   is 1, and scalar products and norms of double vectors of length n if
+   it is 2.
+*/
+
+static void __flint_tuning_setup_vec(__flint_tuning_sample_t * arg)
+{
+   unsigned long i, n = arg->n;
+
+   if (arg->algo == 2)
+   {
+      arg->d1 = (double *) flint_heap_alloc_bytes(n*sizeof(double));
+      arg->d2 = (double *) flint_heap_alloc_bytes(n*sizeof(double));
+      for (i = 0; i < n; i++)
+      {
+         arg->d1[i] = (double) z_randint(1000L)/1000.0;
+         arg->d2[i] = (double) z_randint(1000L)/1000.0;
+      }
+   } else
+   {
+      arg->points = (ulong *) flint_heap_alloc(n);
+      arg->values = (ulong *) flint_heap_alloc(n);
+      arg->out = (mp_limb_t *) flint_heap_alloc(n/4 + 2);
+      for (i = 0; i < n; i++)
+         arg->points[i] = z_randint(1L<<16);
+      F_mpn_clear(arg->out, n/4 + 2);
+      F_mpn_bit_pack(arg->out, arg->points, n, 16, 0);
+   }
+}
+
+static void __flint_tuning_sample_vec(__flint_tuning_sample_t * arg, unsigned long count)
+{
+   unsigned long i, n = arg->n;
+
+   for (i = 0; i < count; i++)
+   {
+      switch (arg->algo)
+      {
+         case 0:
+            F_mpn_bit_pack(arg->out, arg->points, n, 16, 0);
+            break;
+         case 1:
+            F_mpn_bit_unpack(arg->values, arg->out, n, 16, 0);
+            break;
+         case 2:
+            _d_vec_scalar_product(arg->d1, arg->d2, n);
+            _d_vec_norm(arg->d1, n);
+            break;
+      }
+   }
+}
+
+static void __flint_tuning_clear_vec(__flint_tuning_sample_t * arg)
+{
+   if (arg->algo == 2)
+   {
+      flint_heap_free(arg->d2);
+      flint_heap_free(arg->d1);
+   } else
+   {
+      flint_heap_free(arg->out);
+      flint_heap_free(arg->values);
+      flint_heap_free(arg->points);
+   }
+}
+
+/*
+   Products in zn_poly modulo arg->zn_mod. Depending on arg->algo these are
+   products, squares and middle products of length n (the latter of 2n by
+   n), and negacyclic products and squares of length n = 2^lgL, by
+   Nussbaumer multiplication if n is at least arg->off, otherwise via
+   zn_array_mul.
+*/
+
+static void __flint_tuning_setup_zn(__flint_tuning_sample_t * arg)
+{
+   unsigned long i, n = arg->n;
+
+   arg->points = (ulong *) flint_heap_alloc(2*n);
+   arg->values = (ulong *) flint_heap_alloc(n);
+   arg->out = (mp_limb_t *) flint_heap_alloc(4*n);
+   for (i = 0; i < 2*n; i++)
+      arg->points[i] = z_randint(arg->zn_mod->m);
+   for (i = 0; i < n; i++)
+      arg->values[i] = z_randint(arg->zn_mod->m);
+
+   if (arg->algo >= 3)
+   {
+      pmfvec_init_nuss(arg->vec1, FLINT_BIT_COUNT(n) - 1, arg->zn_mod);
+      pmfvec_init_nuss(arg->vec2, FLINT_BIT_COUNT(n) - 1, arg->zn_mod);
+   }
+}
+
+static void __flint_tuning_sample_zn(__flint_tuning_sample_t * arg, unsigned long count)
+{
+   unsigned long i, n = arg->n;
+   ulong * in1 = arg->points;
+   ulong * in2 = (arg->algo == 1 || arg->algo == 4) ? in1 : arg->values;
+
+   for (i = 0; i < count; i++)
+   {
+      switch (arg->algo)
+      {
+         case 0:
+         case 1:
+            zn_array_mul(arg->out, in1, n, in2, n, arg->zn_mod);
+            break;
+         case 2:
+            zn_array_mulmid(arg->out, in1, 2*n, in2, n, arg->zn_mod);
+            break;
+         default:
+            if (n >= arg->off)
+               nuss_mul(arg->out, in1, in2, arg->vec1, arg->vec2);
+            else
+            {
+               zn_array_mul(arg->out, in1, n, in2, n, arg->zn_mod);
+               zn_array_sub(arg->out, arg->out, arg->out + n, n, arg->zn_mod);
+            }
+      }
+   }
+}
+
+static void __flint_tuning_clear_zn(__flint_tuning_sample_t * arg)
+{
+   if (arg->algo >= 3)
+   {
+      pmfvec_clear(arg->vec2);
+      pmfvec_clear(arg->vec1);
+   }
+
+   flint_heap_free(arg->out);
+   flint_heap_free(arg->values);
+   flint_heap_free(arg->points);
+}
+
+/*
+   Compares the negacyclic product of length 2^lgL via zn_array_mul with
+   Nussbaumer multiplication. Returns 1 if the latter is faster.
+*/
+
+static int __flint_tuning_nuss_wins(unsigned long lgL, __flint_tuning_sample_t * arg)
+{
+   double time1, time2;
+
+   arg->n = 1UL << lgL;
+   arg->setup(arg);
+
+   arg->off = -1UL;
+   time1 = __flint_tuning_time(arg->sample, arg);
+   arg->off = 0;
+   time2 = __flint_tuning_time(arg->sample, arg);
+
+   arg->clear(arg);
+
+   return (time2 < time1);
+}
+
+/*
+   Measures the ZmodF_mul FFT depth table, whose entry d - 3 is the
+   crossover from depth d to depth d + 1, as in ZmodF_mul-tune.c.
+*/
+
+static void __flint_tuning_measure_ZmodF_fft(unsigned long * table, int squaring)
+{
+   __flint_tuning_sample_t arg;
+   unsigned long depth, n = 16;
+
+   arg.squaring = squaring;
+   for (depth = 3; depth < 10; depth++)
+   {
+      arg.algo1 = depth;
+      arg.algo2 = depth + 1;
+      n = __flint_tuning_crossover(__flint_tuning_ZmodF_wins, &arg, n, FLINT_MAX(8*n, 1024));
+      table[depth - 3] = n;
+   }
+   table[depth - 3] = 0;
+}
+
+/*
+   Measures the zn_poly table for bitsizes which are multiples of 8, with
+   moduli 2^(b - 1) + 1, or for the NTT an odd modulus of b bits with
+   roots of unity of order 2^lgN, and fills in the other bitsizes from
+   the nearest measured one.
+*/
+
+static void __flint_tuning_measure_zn(void)
+{
+   __flint_tuning_sample_t arg;
+   size_t values[FLINT_TUNING_ZN_FIELDS];
+   unsigned long b, f, n, lgL;
+
+   arg.setup = __flint_tuning_setup_zn;
+   arg.sample = __flint_tuning_sample_zn;
+   arg.clear = __flint_tuning_clear_zn;
+   arg.field = NULL;
+
+   for (b = 8; b <= ULONG_BITS; b += 8)
+   {
+      for (f = 0; f < FLINT_TUNING_ZN_FIELDS; f++)
+         values[f] = SIZE_MAX;
+      values[9] = values[10] = 1000;
+      __flint_tuning_zn_set(tuning_info + b, values);
+
+      arg.zn_bits = b;
+      zn_mod_init(arg.zn_mod, (1UL << (b - 1)) + 1);
+
+      // KS1 -> KS2 -> KS4 for products, squares and middle products
+      for (arg.algo = 0; arg.algo < 3; arg.algo++)
+      {
+         arg.off = -1UL;
+         arg.on = 0;
+
+         arg.zn_field = 3*arg.algo;
+         n = __flint_tuning_crossover(__flint_tuning_field_wins, &arg, 2, 2048);
+         __flint_tuning_set(&arg, n);
+
+         arg.zn_field++;
+         n = __flint_tuning_crossover(__flint_tuning_field_wins, &arg, n, 16384);
+         __flint_tuning_set(&arg, n);
+      }
+
+      // the pointwise products in the FFT use Nussbaumer multiplication if
+      // it wins twice in a row
+      for (arg.algo = 3; arg.algo < 5; arg.algo++)
+      {
+         for (lgL = 3; lgL < 13; lgL++)
+            if (__flint_tuning_nuss_wins(lgL, &arg) && __flint_tuning_nuss_wins(lgL, &arg))
+               break;
+
+         arg.zn_field = 6 + arg.algo;
+         __flint_tuning_set(&arg, (lgL == 13) ? 1000 : lgL);
+      }
+
+      // KS4 -> FFT
+      for (arg.algo = 0; arg.algo < 3; arg.algo++)
+      {
+         arg.off = -1UL;
+         arg.on = 0;
+
+         arg.zn_field = 3*arg.algo + 2;
+         __flint_tuning_zn_get(values, tuning_info + b);
+         n = __flint_tuning_crossover(__flint_tuning_field_wins, &arg, values[arg.zn_field - 1], 65536);
+         __flint_tuning_set(&arg, (n >= 65536) ? -1UL : n);
+      }
+
+      zn_mod_clear(arg.zn_mod);
+
+      // KS or FFT -> NTT, which needs 4m < B
+      if (b < 16 || b > ULONG_BITS - 2) continue;
+
+      unsigned lgN = FLINT_MIN(b - 8, 17);
+      ulong c;
+      int found = 0;
+
+      for (c = (1UL << (b - 1 - lgN)) + 1; !found && c < (1UL << (b - lgN)); c += 2)
+      {
+         zn_mod_init(arg.zn_mod, (c << lgN) + 1);
+         found = (zn_mod_ntt_root(lgN, arg.zn_mod) != 0);
+         if (!found) zn_mod_clear(arg.zn_mod);
+      }
+      if (!found) continue;
+
+      for (arg.algo = 0; arg.algo < 2; arg.algo++)
+      {
+         arg.off = -1UL;
+         arg.on = 0;
+
+         arg.zn_field = 11 + arg.algo;
+         n = __flint_tuning_crossover(__flint_tuning_field_wins, &arg, 4, 1UL << (lgN - 1));
+         __flint_tuning_set(&arg, (n >= (1UL << (lgN - 1))) ? -1UL : n);
+      }
+
+      zn_mod_clear(arg.zn_mod);
+   }
+
+   for (b = 2; b <= ULONG_BITS; b++)
+   {
+      unsigned long near = FLINT_MIN(FLINT_MAX(((b + 4)/8)*8, 8), ULONG_BITS);
+      unsigned long near_ntt = FLINT_MIN(FLINT_MAX(near, 16), ULONG_BITS - 8);
+      size_t ntt[FLINT_TUNING_ZN_FIELDS];
+
+      if (b % 8 == 0) continue;
+
+      __flint_tuning_zn_get(values, tuning_info + near);
+      __flint_tuning_zn_get(ntt, tuning_info + near_ntt);
+      if (b < 16 || b > ULONG_BITS - 2) values[11] = values[12] = SIZE_MAX;
+      else
+      {
+         values[11] = ntt[11];
+         values[12] = ntt[12];
+      }
+      __flint_tuning_zn_set(tuning_info + b, values);
+   }
+}
+
+void flint_tuning_measure(void)
+{
+   __flint_tuning_sample_t arg;
+   unsigned long limbs, length, n;
+   int squaring;
+
+   // the number of OpenMP threads, 1 unless FLINT is built with FLINT_OPENMP=1
+   unsigned long threads = F_mpz_mpoly_mul_threads();
+
+   flint_tuning_cpu(flint_tuning.cpu);
+
+   // F_mpn_mul is just mpn_mul below the start of its own tuning table
+   flint_tuning.fft_limbs_thresh =
+      __flint_tuning_crossover(__flint_tuning_fft_wins, &arg, FFT_MUL_TWK[0][0], 20000);
+
+   for (squaring = 0; squaring <= 1; squaring++)
+   {
+      unsigned long thresh[3];
+      arg.squaring = squaring;
+
+      // threeway vs plain, this one is small so just step through
+      arg.algo1 = 1;
+      arg.algo2 = 0;
+      for (n = 3; n < 300 && __flint_tuning_ZmodF_wins(n, &arg); n += 3) ;
+      thresh[0] = n;
+
+      // plain vs FFT of depth 3
+      arg.algo1 = 0;
+      arg.algo2 = 3;
+      thresh[1] = __flint_tuning_crossover(__flint_tuning_ZmodF_wins, &arg, 16, 8192);
+
+      // threeway vs FFT of depth 4
+      arg.algo1 = 1;
+      arg.algo2 = 4;
+      thresh[2] = __flint_tuning_crossover(__flint_tuning_ZmodF_wins, &arg, 16, 8192);
+
+      if (squaring)
+      {
+         flint_tuning.ZmodF_sqr_plain_threeway_thresh = thresh[0];
+         flint_tuning.ZmodF_sqr_plain_fft_thresh = thresh[1];
+         flint_tuning.ZmodF_sqr_threeway_fft_thresh = thresh[2];
+         __flint_tuning_measure_ZmodF_fft(flint_tuning.ZmodF_sqr_fft_thresh, 1);
+      } else
+      {
+         flint_tuning.ZmodF_mul_plain_threeway_thresh = thresh[0];
+         flint_tuning.ZmodF_mul_plain_fft_thresh = thresh[1];
+         flint_tuning.ZmodF_mul_threeway_fft_thresh = thresh[2];
+         __flint_tuning_measure_ZmodF_fft(flint_tuning.ZmodF_mul_fft_thresh, 0);
+      }
+   }
+
+   // the four step convolution, in terms of the size of the transform
+   arg.setup = __flint_tuning_setup_four_step;
+   arg.sample = __flint_tuning_sample_four_step;
+   arg.clear = __flint_tuning_clear_four_step;
+   arg.field = &flint_tuning.ZmodF_poly_four_step_thresh;
+   arg.off = -1UL;
+   arg.on = 0;
+   flint_tuning.ZmodF_poly_four_step_thresh =
+      __flint_tuning_crossover(__flint_tuning_field_wins, &arg, 1UL<<16, 1UL<<21);
+
+   // the karatsuba crossover for each coefficient size, until it reaches 2
+   for (limbs = 1; limbs < FLINT_TUNING_TABLE_LENGTH; limbs++)
+   {
+      for (length = 2; length < 100; length++)
+         // if karatsuba seems to win, run it twice just to check
+         if (__flint_tuning_kara_wins(length, limbs) && __flint_tuning_kara_wins(length, limbs))
+            break;
+
+      if (length == 2) break;
+      flint_tuning.mpz_poly_kara_thresh[limbs - 1] = length;
+   }
+   flint_tuning.mpz_poly_kara_thresh[limbs - 1] = 0;
+   flint_tuning.mpz_poly_kara_thresh_size = limbs;
+
+   // zn_poly, which zmod_poly multiplies with
+   __flint_tuning_measure_zn();
+
+   arg.gcd = 0;
+   arg.p = z_nextprime(1L<<(FLINT_BITS - 2), 0);
+   flint_tuning.zmod_poly_div_basecase_thresh =
+      __flint_tuning_crossover(__flint_tuning_zmod_poly_wins, &arg, 16, 2048);
+
+   // products of 2x2 matrices in the transform domain, then the half gcd
+   // basecase, among values around the default, before the gcd crossovers
+   arg.setup = __flint_tuning_setup_2x2;
+   arg.sample = __flint_tuning_sample_2x2;
+   arg.clear = __flint_tuning_clear_2x2;
+   arg.field = &flint_tuning.zmod_poly_2x2_transform_thresh;
+   arg.off = -1UL;
+   arg.on = 1;
+   flint_tuning.zmod_poly_2x2_transform_thresh =
+      __flint_tuning_crossover(__flint_tuning_field_wins, &arg, 16, 16384);
+
+   const unsigned long hgcd_cutoffs[] = {20, 30, 45, 60, 90, 130, 200};
+
+   arg.setup = __flint_tuning_setup_hgcd;
+   arg.sample = __flint_tuning_sample_hgcd;
+   arg.clear = __flint_tuning_clear_hgcd;
+   arg.field = &flint_tuning.zmod_poly_hgcd_thresh;
+   __flint_tuning_field_best(&arg, 2048, hgcd_cutoffs, 7);
+
+   arg.gcd = 1;
+   flint_tuning.zmod_poly_gcd_thresh =
+      __flint_tuning_crossover(__flint_tuning_zmod_poly_wins, &arg, 32, 4096);
+
+   arg.p = 251;
+   flint_tuning.zmod_poly_small_gcd_thresh =
+      __flint_tuning_crossover(__flint_tuning_zmod_poly_wins, &arg, 32, 4096);
+
+   // multipoint evaluation, first the degree at which to stop descending the
+   // tree, with the subproduct tree always used
+   const unsigned long tree_cutoffs[] = {4, 8, 16, 32, 64, 128};
+   unsigned long cutoff = flint_tuning.zmod_poly_evaluate_vec_tree_cutoff;
+
+   arg.p = z_nextprime(1L<<(FLINT_BITS - 2), 0);
+   arg.setup = __flint_tuning_setup_evaluate;
+   arg.sample = __flint_tuning_sample_evaluate;
+   arg.clear = __flint_tuning_clear_evaluate;
+   arg.algo = 1;
+   flint_tuning.zmod_poly_evaluate_vec_tree_cutoff = 0;
+   arg.field = &flint_tuning.zmod_poly_tree_evaluate_cutoff;
+   __flint_tuning_field_best(&arg, 1024, tree_cutoffs, 6);
+   flint_tuning.zmod_poly_evaluate_vec_tree_cutoff = cutoff;
+
+   // then Horner vs the tree, with and without the cost of building the tree
+   arg.off = -1UL;
+   arg.on = 0;
+   arg.field = &flint_tuning.zmod_poly_evaluate_vec_tree_cutoff;
+   flint_tuning.zmod_poly_evaluate_vec_tree_cutoff = __flint_tuning_evaluate_cutoff(
+      __flint_tuning_crossover(__flint_tuning_field_wins, &arg, 16, 4096));
+
+   arg.algo = 0;
+   arg.field = &flint_tuning.zmod_poly_evaluate_vec_cutoff;
+   flint_tuning.zmod_poly_evaluate_vec_cutoff = __flint_tuning_evaluate_cutoff(
+      __flint_tuning_crossover(__flint_tuning_field_wins, &arg, 16, 4096));
+
+   // Montgomery multiplication is used up to and including the cutoff
+   arg.setup = __flint_tuning_setup_powm;
+   arg.sample = __flint_tuning_sample_powm;
+   arg.clear = __flint_tuning_clear_powm;
+   arg.field = &flint_tuning.F_mpz_montgomery_thresh;
+   arg.off = -1UL;
+   arg.on = 0;
+   flint_tuning.F_mpz_montgomery_thresh =
+      __flint_tuning_crossover(__flint_tuning_field_wins, &arg, 1, 128) - 1;
+
+   // Newton inversion, where the setup sets arg.off and arg.on, and division
+   arg.setup = __flint_tuning_setup_newton;
+   arg.sample = __flint_tuning_sample_newton;
+   arg.clear = __flint_tuning_clear_newton;
+   arg.field = &flint_tuning.F_mpz_mod_poly_newton_inverse_thresh;
+   arg.algo = 0;
+   flint_tuning.F_mpz_mod_poly_newton_inverse_thresh =
+      __flint_tuning_crossover(__flint_tuning_field_wins, &arg, 4, 512);
+
+   arg.field = &flint_tuning.F_mpz_mod_poly_newton_divrem_thresh;
+   arg.algo = 1;
+   arg.off = -1UL;
+   arg.on = 2;
+   flint_tuning.F_mpz_mod_poly_newton_divrem_thresh =
+      __flint_tuning_crossover(__flint_tuning_field_wins, &arg, 4, 512);
+
+   // Kronecker substitution vs the heap, then the threaded heap
+   arg.setup = __flint_tuning_setup_mpoly;
+   arg.sample = __flint_tuning_sample_mpoly;
+   arg.clear = __flint_tuning_clear_mpoly;
+   arg.field = &flint_tuning.F_mpz_mpoly_kronecker_ratio;
+   arg.algo = 0;
+   arg.off = -1UL;
+   arg.on = 0;
+   flint_tuning.F_mpz_mpoly_kronecker_ratio = __flint_tuning_kronecker_ratio(
+      __flint_tuning_crossover(__flint_tuning_field_wins, &arg, 16, FLINT_TUNING_MPOLY_DEGREE));
+
+   if (threads > 1)
+   {
+      arg.field = &flint_tuning.F_mpz_mpoly_threaded_cutoff;
+      arg.algo = 1;
+      n = __flint_tuning_crossover(__flint_tuning_field_wins, &arg, 16, 2048);
+      flint_tuning.F_mpz_mpoly_threaded_cutoff = (n*n)/threads;
+   }
+
+   // radix conversion, where the tasks only exist in OpenMP builds
+   const unsigned long radix_digits[] = {64, 128, 256, 512, 1024, 2048, 4096};
+   const unsigned long radix_task_digits[] = {2000, 8000, 32000, 128000, 512000};
+   const unsigned long radix_blocks[] = {1024, 4096, 16384, 65536, 262144, 1048576};
+
+   arg.setup = __flint_tuning_setup_radix;
+   arg.sample = __flint_tuning_sample_radix;
+   arg.clear = __flint_tuning_clear_radix;
+   arg.field = &flint_tuning.F_mpz_radix_digits;
+   arg.algo = 0;
+   arg.count = 16;
+   __flint_tuning_field_best(&arg, 20000, radix_digits, 7);
+
+   if (threads > 1)
+   {
+      arg.field = &flint_tuning.F_mpz_radix_task_digits;
+      arg.algo = 1;
+      arg.count = 4;
+      __flint_tuning_field_best(&arg, 200000, radix_task_digits, 5);
+   }
+
+   arg.field = &flint_tuning.F_mpz_radix_block;
+   arg.algo = 2;
+   arg.count = 20000;
+   __flint_tuning_field_best(&arg, 20, radix_blocks, 6);
+
+   // tiles for matrices with small entries, and blocks for vectors
+   const unsigned long tiles_k[] = {16, 32, 64, 128, 256};
+   const unsigned long tiles_j[] = {32, 64, 128, 256, 512};
+   const unsigned long vec_blocks[] = {8, 16, 32, 64, 128, 256};
+
+   arg.setup = __flint_tuning_setup_mat;
+   arg.sample = __flint_tuning_sample_mat;
+   arg.clear = __flint_tuning_clear_mat;
+   arg.algo = 0;
+   arg.field = &flint_tuning.F_mpz_mat_mul_tile_k;
+   __flint_tuning_field_best(&arg, 256, tiles_k, 5);
+   arg.field = &flint_tuning.F_mpz_mat_mul_tile_j;
+   __flint_tuning_field_best(&arg, 256, tiles_j, 5);
+
+   arg.algo = 1;
+   arg.field = &flint_tuning.F_mpz_vec_block;
+   __flint_tuning_field_best(&arg, 4096, vec_blocks, 6);
+
+   // the AVX2 kernels, if the machine has them
+   if (flint_have_avx2())
+   {
+      arg.setup = __flint_tuning_setup_vec;
+      arg.sample = __flint_tuning_sample_vec;
+      arg.clear = __flint_tuning_clear_vec;
+      arg.off = -1UL;
+      arg.on = 0;
+
+      arg.algo = 0;
+      arg.field = &flint_tuning.F_mpn_bit_pack_avx2_cutoff;
+      flint_tuning.F_mpn_bit_pack_avx2_cutoff =
+         __flint_tuning_crossover(__flint_tuning_field_wins, &arg, 1, 4096);
+
+      arg.algo = 1;
+      arg.field = &flint_tuning.F_mpn_bit_unpack_avx2_cutoff;
+      flint_tuning.F_mpn_bit_unpack_avx2_cutoff =
+         __flint_tuning_crossover(__flint_tuning_field_wins, &arg, 1, 4096);
+
+      arg.algo = 2;
+      arg.field = &flint_tuning.d_vec_avx2_cutoff;
+      flint_tuning.d_vec_avx2_cutoff =
+         __flint_tuning_crossover(__flint_tuning_field_wins, &arg, 1, 256);
+   }
+}
+
+/****************************************************************************
+
+   Initialisation
+
+****************************************************************************/
+
+const char * flint_tuning_filename(void)
+{
+   static char filename[FLINT_TUNING_LINE_LENGTH];
+
+   const char * env = getenv("FLINT_TUNING_FILE");
+   if (env != NULL) return env;
+
+   env = getenv("HOME");
+   if (env == NULL || strlen(env) + 16 > FLINT_TUNING_LINE_LENGTH) return NULL;
+
+   sprintf(filename, "%s/.flint-tuning", env);
+   return filename;
+}
+
+static int __flint_tuning_initialised = 0;
+
+void flint_tuning_init(void)
+{
+   if (__flint_tuning_initialised) return;
+   __flint_tuning_initialised = 1;
+
+   const char * mode = getenv("FLINT_TUNING");
+   if (mode != NULL && !strcmp(mode, "off")) return;
+
+   const char * filename = flint_tuning_filename();
+   if (filename != NULL && flint_tuning_load(filename)) return;
+
+   flint_tuning_measure();
+
+   if (filename != NULL) flint_tuning_save(filename);
+}
+
+/*
+   Loads the profile for the current machine when the program starts, so
+   that programs which never call flint_tuning_init() use it too. Measuring
+   is left to flint_tuning_init(), as it takes a few seconds and writes the
+   profile file.
+*/
+
+#ifdef __GNUC__
+__attribute__((constructor))
+#endif
+static void __flint_tuning_startup(void)
+{
+   const char * mode = getenv("FLINT_TUNING");
+   if (mode != NULL && !strcmp(mode, "off")) return;
+
+   const char * filename = flint_tuning_filename();
+   if (filename != NULL) flint_tuning_load(filename);
+}
+
+// end of file ****************************************************************
@@ -0,0 +1,182 @@
+/*============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+===============================================================================*/
+/*
+   flint-tuning.h
+
+   Runtime tuning table for the algorithm crossovers used throughout FLINT.
+
+   All dispatchers read their crossovers and block sizes from the global
+   table flint_tuning (the macros in F_mpn_mul-tuning.h, ZmodF_mul-tuning.h,
+   mpz_poly-tuning.h and the module headers refer to it). The table starts
+   out with compiled in defaults. When the program starts, the section for
+   the current machine is loaded from the profile file, if there is one.
+   Calling flint_tuning_init() also measures the crossovers and creates the
+   profile if it does not exist yet.
+
+   The profile file is a text file with one section per CPU model, so a
+   single file can be shared by a heterogeneous set of machines. It also
+   stores the zn_poly tuning table, which has one entry per modulus bitsize.
+
+   Copyright (C) 2010, William Hart
+
+*/
+
+#ifndef FLINT_TUNING_H
+#define FLINT_TUNING_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#define FLINT_TUNING_CPU_LENGTH 128
+#define FLINT_TUNING_TABLE_LENGTH 20
+
+typedef struct
+{
+   char cpu[FLINT_TUNING_CPU_LENGTH]; // CPU model the values were measured on
+
+   // mpn_mul -> F_mpn_mul crossover in limbs, see F_mpn_mul-tuning.h
+   unsigned long fft_limbs_thresh;
+
+   // see ZmodF_mul-tuning.h
+   unsigned long ZmodF_mul_plain_threeway_thresh;
+   unsigned long ZmodF_mul_plain_fft_thresh;
+   unsigned long ZmodF_mul_threeway_fft_thresh;
+   unsigned long ZmodF_mul_fft_thresh[FLINT_TUNING_TABLE_LENGTH];
+   unsigned long ZmodF_sqr_plain_threeway_thresh;
+   unsigned long ZmodF_sqr_plain_fft_thresh;
+   unsigned long ZmodF_sqr_threeway_fft_thresh;
+   unsigned long ZmodF_sqr_fft_thresh[FLINT_TUNING_TABLE_LENGTH];
+
+   // see mpz_poly-tuning.h
+   unsigned long mpz_poly_kara_thresh[FLINT_TUNING_TABLE_LENGTH];
+   unsigned long mpz_poly_kara_thresh_size;
+
+   // see zmod_poly.h
+   unsigned long zmod_poly_div_basecase_thresh;
+   unsigned long zmod_poly_hgcd_thresh;
+   unsigned long zmod_poly_gcd_thresh;
+   unsigned long zmod_poly_small_gcd_thresh;
+   unsigned long zmod_poly_2x2_transform_thresh;
+
+   // see F_mpz.h
+   unsigned long F_mpz_montgomery_thresh;
+
+   // see F_mpz_mod_poly.h
+   unsigned long F_mpz_mod_poly_newton_inverse_thresh;
+   unsigned long F_mpz_mod_poly_newton_divrem_thresh;
+
+   // see F_mpz_mpoly.h
+   unsigned long F_mpz_mpoly_kronecker_ratio;
+   unsigned long F_mpz_mpoly_threaded_cutoff;
+
+   // see mpz_extras.h
+   unsigned long F_mpz_radix_digits;
+   unsigned long F_mpz_radix_task_digits;
+   unsigned long F_mpz_radix_block;
+
+   // see F_mpz_mat.h
+   unsigned long F_mpz_mat_mul_tile_k;
+   unsigned long F_mpz_mat_mul_tile_j;
+
+   // see ZmodF_poly.h
+   unsigned long ZmodF_poly_four_step_thresh;
+
+   // see mpn_extras.h
+   unsigned long F_mpn_bit_pack_avx2_cutoff;
+   unsigned long F_mpn_bit_unpack_avx2_cutoff;
+
+   // see F_mpz_mat.h
+   unsigned long F_mpz_vec_block;
+
+   // see zmod_poly.h
+   unsigned long zmod_poly_evaluate_vec_cutoff;
+   unsigned long zmod_poly_evaluate_vec_tree_cutoff;
+   unsigned long zmod_poly_tree_evaluate_cutoff;
+
+   // see d_mat.h
+   unsigned long d_vec_avx2_cutoff;
+} flint_tuning_t;
+
+extern flint_tuning_t flint_tuning;
+
+/*
+   Sets cpu to a string identifying the CPU model and word size. The string
+   is used as the key for the profile file.
+*/
+void flint_tuning_cpu(char * cpu);
+
+/*
+   Restores the compiled in defaults, including the zn_poly table.
+*/
+void flint_tuning_reset(void);
+
+/*
+   Loads the section of the given profile file for the current CPU into the
+   tuning table. Returns 1 if successful, otherwise returns 0 and leaves the
+   table unchanged. Values out of the range an entry allows, such as a zero
+   block size, make the load fail.
+*/
+int flint_tuning_load(const char * filename);
+
+/*
+   Writes the tuning table to the section of the given profile file for the
+   current CPU, keeping the sections for other CPUs. Returns 1 if successful.
+*/
+int flint_tuning_save(const char * filename);
+
+/*
+   Measures every entry of the tuning table, including the FFT depth tables 
+   for ZmodF_mul and the zn_poly table, on the current machine. This takes 
+   under a minute. The entries which only matter with several OpenMP 
+   threads, F_mpz_mpoly_threaded_cutoff and F_mpz_radix_task_digits, are 
+   only measured by builds with FLINT_OPENMP=1 running more than one 
+   thread, and the AVX2 cutoffs only on machines with AVX2, otherwise 
+   they keep their values.
+*/
+void flint_tuning_measure(void);
+
+/*
+   Returns the profile file used by flint_tuning_init(). This is the value of
+   the environment variable FLINT_TUNING_FILE if set, otherwise .flint-tuning
+   in the home directory. Returns NULL if neither is available.
+*/
+const char * flint_tuning_filename(void);
+
+/*
+   Sets up the tuning table for the current machine. The section for the
+   current CPU is loaded from flint_tuning_filename() if it exists, otherwise
+   the crossovers are measured and saved there. If the environment variable
+   FLINT_TUNING is set to "off" the compiled in defaults are kept.
+
+   The profile is loaded automatically at startup (FLINT_TUNING=off is
+   honoured there too), so this only needs to be called by programs which
+   want the crossovers measured when there is no profile yet. It should be
+   called before any other threads are started. Subsequent calls do nothing.
+*/
+void flint_tuning_init(void);
+
+#ifdef __cplusplus
+ }
+#endif
+
+#endif
+
+// end of file ****************************************************************
@@ -110,11 +110,48 @@ Cache/branch hints to speed up reads from data in memory/branches
 #define UNLIKELY(cond) (cond)
 #endif
 
+/*
+Runtime selection of SIMD kernels. If FLINT_HAVE_AVX2_DISPATCH is set, 
+functions may be compiled for AVX2/FMA with __attribute__((target(...))) and 
+selected at runtime if flint_have_avx2() is nonzero.
+*/
+#if defined(__GNUC__) && !defined(__TINYC__) && !defined(__clang__) \
+   && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)) \
+   && defined(__x86_64__) && !defined(FLINT_NO_AVX2)
+#define FLINT_HAVE_AVX2_DISPATCH 1
+#define FLINT_TARGET_AVX2 __attribute__((target("avx2,fma")))
+static inline
+int flint_have_avx2(void)
+{
+   static int have_avx2 = -1;
+
+   if (have_avx2 == -1)
+   {
+      __builtin_cpu_init();
+      have_avx2 = (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"));
+   }
+
+   return have_avx2;
+}
+#else
+#define FLINT_HAVE_AVX2_DISPATCH 0
+#define FLINT_TARGET_AVX2
+#define flint_have_avx2() 0
+#endif
+
 /*
 Thread stuff
+
+When FLINT is built with OpenMP (make FLINT_OPENMP=1) the state of the stack
+memory managers is thread local, so that each thread has its own stack.
 */
 
+#ifdef _OPENMP
+#include <omp.h>
+#define THREAD __thread
+#else
 #define THREAD
+#endif
 
 #ifdef FLINT_TEST_SUPPORT_H 
 #define FLINT_THREAD_CLEANUP \
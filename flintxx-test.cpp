@@ -0,0 +1,454 @@
+/*============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+===============================================================================*/
+/****************************************************************************
+
+flintxx-test.cpp: Test code for flintxx.h
+
+*****************************************************************************/
+
+#include <cstdio>
+#include <utility>
+
+#include "flintxx.h"
+#include "long_extras.h"
+#include "memory-manager.h"
+#include "test-support.h"
+
+#define ITER 1 // if you want all tests to run longer, increase this
+
+using namespace flint;
+
+void flintxx_test_random(F_mpz * f, ulong bits)
+{
+   mpz_t temp;
+   mpz_init(temp);
+
+   if (bits) mpz_rrandomb(temp, randstate, bits);
+   if (z_randint(2)) mpz_neg(temp, temp);
+   F_mpz_set_mpz(f, temp);
+
+   mpz_clear(temp);
+}
+
+// a random positive modulus
+void flintxx_test_random_mod(F_mpz * f, ulong bits)
+{
+   mpz_t temp;
+   mpz_init(temp);
+
+   mpz_rrandomb(temp, randstate, bits);
+   F_mpz_set_mpz(f, temp);
+
+   mpz_clear(temp);
+}
+
+void flintxx_test_random_poly(F_mpz_poly_struct * poly, ulong length, ulong bits)
+{
+   ulong i;
+
+   F_mpz_poly_zero(poly);
+   for (i = 0; i < length; i++)
+   {
+      F_mpz_t c;
+      F_mpz_init(c);
+      flintxx_test_random(c, bits);
+      F_mpz_poly_set_coeff(poly, i, c);
+      F_mpz_clear(c);
+   }
+}
+
+void flintxx_test_random_mat(F_mpz_mat_struct * mat, ulong bits)
+{
+   ulong i, j;
+
+   for (i = 0; i < mat->r; i++)
+      for (j = 0; j < mat->c; j++)
+         flintxx_test_random(mat->rows[i] + j, bits);
+}
+
+int test_F_mpzxx_arith()
+{
+   int result = 1;
+   ulong count;
+   F_mpz_t t, u;
+
+   F_mpz_init(t);
+   F_mpz_init(u);
+
+   for (count = 0; (count < 20000*ITER) && (result == 1); count++)
+   {
+      F_mpzxx a, b, c, d, m, r;
+      ulong bits = z_randint(200) + 1;
+
+      flintxx_test_random(a._F_mpz(), z_randint(bits));
+      flintxx_test_random(b._F_mpz(), z_randint(bits));
+      flintxx_test_random(c._F_mpz(), z_randint(bits));
+      flintxx_test_random(d._F_mpz(), z_randint(bits));
+      flintxx_test_random_mod(m._F_mpz(), z_randint(bits) + 1);
+
+      // a*b + c and c + a*b
+      F_mpz_mul2(t, a._F_mpz(), b._F_mpz());
+      F_mpz_add(t, t, c._F_mpz());
+      r = a*b + c;
+      result &= F_mpz_equal(t, r._F_mpz());
+      r = c + a*b;
+      result &= F_mpz_equal(t, r._F_mpz());
+
+      // c - a*b and a*b - c
+      F_mpz_mul2(t, a._F_mpz(), b._F_mpz());
+      F_mpz_sub(t, c._F_mpz(), t);
+      r = c - a*b;
+      result &= F_mpz_equal(t, r._F_mpz());
+      F_mpz_neg(t, t);
+      r = a*b - c;
+      result &= F_mpz_equal(t, r._F_mpz());
+
+      // a*b + c*d
+      F_mpz_mul2(t, a._F_mpz(), b._F_mpz());
+      F_mpz_mul2(u, c._F_mpz(), d._F_mpz());
+      F_mpz_add(t, t, u);
+      r = a*b + c*d;
+      result &= F_mpz_equal(t, r._F_mpz());
+
+      // (a*b) % m
+      F_mpz_mulmod2(t, a._F_mpz(), b._F_mpz(), m._F_mpz());
+      r = (a*b) % m;
+      result &= F_mpz_equal(t, r._F_mpz());
+
+      // (a + b)*(c - 3) + d*5, with temporaries for the operands
+      F_mpz_add(t, a._F_mpz(), b._F_mpz());
+      F_mpz_sub_ui(u, c._F_mpz(), 3);
+      F_mpz_mul2(t, t, u);
+      F_mpz_set_si(u, 5);
+      F_mpz_addmul(t, d._F_mpz(), u);
+      r = (a + b)*(c - 3) + d*5;
+      result &= F_mpz_equal(t, r._F_mpz());
+
+      // -(a - b)
+      F_mpz_sub(t, b._F_mpz(), a._F_mpz());
+      r = -(a - b);
+      result &= F_mpz_equal(t, r._F_mpz());
+
+      if (!result) printf("Error: a = %s, b = %s, c = %s, d = %s, m = %s\n",
+         a.to_string().c_str(), b.to_string().c_str(), c.to_string().c_str(),
+         d.to_string().c_str(), m.to_string().c_str());
+   }
+
+   F_mpz_clear(t);
+   F_mpz_clear(u);
+
+   return result;
+}
+
+int test_F_mpzxx_aliasing()
+{
+   int result = 1;
+   ulong count;
+   F_mpz_t t;
+
+   F_mpz_init(t);
+
+   for (count = 0; (count < 20000*ITER) && (result == 1); count++)
+   {
+      F_mpzxx a, b, m;
+      ulong bits = z_randint(200) + 1;
+
+      flintxx_test_random(a._F_mpz(), z_randint(bits));
+      flintxx_test_random(b._F_mpz(), z_randint(bits));
+      flintxx_test_random_mod(m._F_mpz(), z_randint(bits) + 1);
+
+      // a = a*b + a
+      F_mpz_set(t, a._F_mpz());
+      F_mpz_addmul(t, a._F_mpz(), b._F_mpz());
+      a = a*b + a;
+      result &= F_mpz_equal(t, a._F_mpz());
+
+      // a -= a*b
+      F_mpz_submul(t, a._F_mpz(), b._F_mpz());
+      a -= a*b;
+      result &= F_mpz_equal(t, a._F_mpz());
+
+      // b = a*b - b
+      F_mpz_mul2(t, a._F_mpz(), b._F_mpz());
+      F_mpz_sub(t, t, b._F_mpz());
+      b = a*b - b;
+      result &= F_mpz_equal(t, b._F_mpz());
+
+      // a = (a*a) % m, then m = (a*b) % m
+      F_mpz_mulmod2(t, a._F_mpz(), a._F_mpz(), m._F_mpz());
+      a = (a*a) % m;
+      result &= F_mpz_equal(t, a._F_mpz());
+
+      F_mpz_mulmod2(t, a._F_mpz(), b._F_mpz(), m._F_mpz());
+      m = (a*b) % m;
+      result &= F_mpz_equal(t, m._F_mpz());
+
+      if (!result) printf("Error: count = %ld\n", count);
+   }
+
+   F_mpz_clear(t);
+
+   return result;
+}
+
+int test_F_mpzxx_move()
+{
+   int result = 1;
+   ulong count;
+   F_mpz_t t;
+
+   F_mpz_init(t);
+
+   for (count = 0; (count < 20000*ITER) && (result == 1); count++)
+   {
+      F_mpzxx a;
+      flintxx_test_random(a._F_mpz(), z_randint(200));
+      F_mpz_set(t, a._F_mpz());
+
+      F_mpzxx b(std::move(a));
+      result &= F_mpz_equal(t, b._F_mpz()) && a.is_zero();
+
+      F_mpzxx c(17);
+      c = std::move(b);
+      result &= F_mpz_equal(t, c._F_mpz());
+
+      F_mpzxx d(c);
+      result &= (d == c) && (d.to_string() == c.to_string());
+
+      if (!result) printf("Error: count = %ld\n", count);
+   }
+
+   F_mpz_clear(t);
+
+   return result;
+}
+
+int test_F_mpz_polyxx_arith()
+{
+   int result = 1;
+   ulong count;
+   F_mpz_poly_t t, u;
+
+   F_mpz_poly_init(t);
+   F_mpz_poly_init(u);
+
+   for (count = 0; (count < 2000*ITER) && (result == 1); count++)
+   {
+      F_mpz_polyxx a, b, c, r;
+      F_mpzxx m, x;
+      ulong bits = z_randint(100) + 1;
+
+      flintxx_test_random_poly(a._poly(), z_randint(30), z_randint(bits));
+      flintxx_test_random_poly(b._poly(), z_randint(30), z_randint(bits));
+      flintxx_test_random_poly(c._poly(), z_randint(30), z_randint(bits));
+      flintxx_test_random_mod(m._F_mpz(), z_randint(bits) + 1);
+      flintxx_test_random(x._F_mpz(), z_randint(bits));
+
+      // a*b + c and c + a*b
+      F_mpz_poly_mul(t, a._poly(), b._poly());
+      F_mpz_poly_add(t, t, c._poly());
+      r = a*b + c;
+      result &= F_mpz_poly_equal(t, r._poly());
+      r = c + a*b;
+      result &= F_mpz_poly_equal(t, r._poly());
+
+      // c - a*b and a*b - c
+      F_mpz_poly_mul(t, a._poly(), b._poly());
+      F_mpz_poly_sub(t, c._poly(), t);
+      r = c - a*b;
+      result &= F_mpz_poly_equal(t, r._poly());
+      F_mpz_poly_neg(t, t);
+      r = a*b - c;
+      result &= F_mpz_poly_equal(t, r._poly());
+
+      // (a*b) % m
+      F_mpz_poly_mul(t, a._poly(), b._poly());
+      F_mpz_poly_scalar_smod(t, t, m._F_mpz());
+      r = (a*b) % m;
+      result &= F_mpz_poly_equal(t, r._poly());
+
+      // x*a - b*x + 2*c
+      F_mpz_poly_sub(t, a._poly(), b._poly());
+      F_mpz_poly_scalar_mul(t, t, x._F_mpz());
+      F_mpz_poly_add(u, c._poly(), c._poly());
+      F_mpz_poly_add(t, t, u);
+      r = x*a - b*x + 2*c;
+      result &= F_mpz_poly_equal(t, r._poly());
+
+      // a = a*b + a, then b -= a*b, then c = c*a % m
+      F_mpz_poly_mul(t, a._poly(), b._poly());
+      F_mpz_poly_add(t, t, a._poly());
+      a = a*b + a;
+      result &= F_mpz_poly_equal(t, a._poly());
+
+      F_mpz_poly_mul(t, a._poly(), b._poly());
+      F_mpz_poly_sub(t, b._poly(), t);
+      b -= a*b;
+      result &= F_mpz_poly_equal(t, b._poly());
+
+      F_mpz_poly_mul(t, c._poly(), a._poly());
+      F_mpz_poly_scalar_smod(t, t, m._F_mpz());
+      c = c*a % m;
+      result &= F_mpz_poly_equal(t, c._poly());
+
+      // c % m leaves c unchanged
+      F_mpz_poly_set(u, c._poly());
+      r = (c + c) % m;
+      result &= F_mpz_poly_equal(u, c._poly());
+
+      if (!result) printf("Error: count = %ld\n", count);
+   }
+
+   F_mpz_poly_clear(t);
+   F_mpz_poly_clear(u);
+
+   return result;
+}
+
+int test_F_mpz_polyxx_move()
+{
+   int result = 1;
+   ulong count;
+
+   for (count = 0; (count < 2000*ITER) && (result == 1); count++)
+   {
+      F_mpz_polyxx a;
+      flintxx_test_random_poly(a._poly(), z_randint(30), z_randint(200));
+
+      F_mpz_polyxx b(a);
+      F_mpz_polyxx c(std::move(b));
+      result &= (a == c) && (b.length() == 0);
+
+      F_mpz_polyxx d(a.to_string().c_str());
+      result &= (a == d);
+
+      b = std::move(d);
+      result &= (a == b);
+
+      if (!result) printf("Error: count = %ld\n", count);
+   }
+
+   return result;
+}
+
+int test_F_mpz_matxx_arith()
+{
+   int result = 1;
+   ulong count;
+   F_mpz_mat_t t;
+
+   for (count = 0; (count < 500*ITER) && (result == 1); count++)
+   {
+      ulong r = z_randint(10) + 1, c = z_randint(10) + 1, k = z_randint(10) + 1;
+      ulong bits = z_randint(100) + 1;
+
+      F_mpz_matxx A(r, k), B(k, c), C(r, c), S(r, r), R;
+      F_mpzxx m;
+
+      flintxx_test_random_mat(A._mat(), z_randint(bits));
+      flintxx_test_random_mat(B._mat(), z_randint(bits));
+      flintxx_test_random_mat(C._mat(), z_randint(bits));
+      flintxx_test_random_mat(S._mat(), z_randint(bits));
+      flintxx_test_random_mod(m._F_mpz(), z_randint(bits) + 1);
+
+      F_mpz_mat_init(t, r, c);
+
+      // A*B + C and C + A*B
+      F_mpz_mat_mul_classical(t, A._mat(), B._mat());
+      F_mpz_mat_add(t, t, C._mat());
+      R = A*B + C;
+      result &= F_mpz_mat_equal(t, R._mat());
+      R = C + A*B;
+      result &= F_mpz_mat_equal(t, R._mat());
+
+      // C - A*B and A*B - C
+      F_mpz_mat_mul_classical(t, A._mat(), B._mat());
+      F_mpz_mat_sub(t, C._mat(), t);
+      R = C - A*B;
+      result &= F_mpz_mat_equal(t, R._mat());
+      F_mpz_mat_neg(t, t);
+      R = A*B - C;
+      result &= F_mpz_mat_equal(t, R._mat());
+
+      // (A*B) % m
+      F_mpz_mat_mul_classical(t, A._mat(), B._mat());
+      F_mpz_mat_smod(t, t, m._F_mpz());
+      R = (A*B) % m;
+      result &= F_mpz_mat_equal(t, R._mat());
+
+      // C = A*B + C, then S -= S*S, then S = S*S % m
+      F_mpz_mat_mul_classical(t, A._mat(), B._mat());
+      F_mpz_mat_add(t, t, C._mat());
+      C = A*B + C;
+      result &= F_mpz_mat_equal(t, C._mat());
+
+      F_mpz_mat_clear(t);
+      F_mpz_mat_init(t, r, r);
+
+      F_mpz_mat_mul_classical(t, S._mat(), S._mat());
+      F_mpz_mat_sub(t, S._mat(), t);
+      S -= S*S;
+      result &= F_mpz_mat_equal(t, S._mat());
+
+      F_mpz_mat_mul_classical(t, S._mat(), S._mat());
+      F_mpz_mat_smod(t, t, m._F_mpz());
+      S = S*S % m;
+      result &= F_mpz_mat_equal(t, S._mat());
+
+      // moves
+      F_mpz_matxx T(S);
+      F_mpz_matxx U(std::move(T));
+      result &= (U == S) && (T.rows() == 0);
+
+      F_mpz_mat_clear(t);
+
+      if (!result) printf("Error: r = %ld, c = %ld, k = %ld\n", r, c, k);
+   }
+
+   return result;
+}
+
+void flintxx_test_all()
+{
+   int success, all_success = 1;
+   printf("FLINT_BITS = %d\n", FLINT_BITS);
+
+   RUN_TEST(F_mpzxx_arith);
+   RUN_TEST(F_mpzxx_aliasing);
+   RUN_TEST(F_mpzxx_move);
+   RUN_TEST(F_mpz_polyxx_arith);
+   RUN_TEST(F_mpz_polyxx_move);
+   RUN_TEST(F_mpz_matxx_arith);
+
+   printf(all_success ? "\nAll tests passed\n" :
+                        "\nAt least one test FAILED!\n");
+}
+
+int main()
+{
+   test_support_init();
+   flintxx_test_all();
+   test_support_cleanup();
+
+   flint_stack_cleanup();
+   _F_mpz_cleanup();
+
+   return 0;
+}
@@ -0,0 +1,953 @@
+/*============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+===============================================================================*/
+/****************************************************************************
+
+   flintxx.h: Header only C++ interface to F_mpz, F_mpz_poly and F_mpz_mat
+
+   The classes F_mpzxx, F_mpz_polyxx and F_mpz_matxx own an F_mpz_t,
+   F_mpz_poly_t and F_mpz_mat_t respectively, and may be moved as well as
+   copied (C++11 or later is required).
+
+   Arithmetic operators do not compute anything, but return small expression
+   objects which are evaluated when assigned to an object. Evaluation goes
+   directly into the destination where aliasing allows and fuses the
+   following patterns into single calls:
+
+      c + a*b, a*b + c      F_mpz_addmul, or a product then an in place add
+      c - a*b, a*b - c      F_mpz_submul, or a product then an in place sub
+      (a*b) % m             F_mpz_mulmod2, or a product then an in place
+                            F_mpz_poly_scalar_smod/F_mpz_mat_smod
+
+   Note that % gives the reduction in [0, m) for integers (F_mpz_mod) but the
+   symmetric reduction for polynomials and matrices, as for the C functions.
+
+   Any temporaries needed by subexpressions are F_mpz_t's on the stack, whose
+   limbs, if any, come from the F_mpz memory manager, or polynomials and
+   matrices which are initialised empty and grown once by the C functions.
+
+   Expressions hold pointers to their operands and so must not be stored,
+   e.g. with auto, beyond the statement which creates them.
+
+*****************************************************************************/
+
+#ifndef FLINT_FLINTXX_H
+#define FLINT_FLINTXX_H
+
+// gmp.h must be included with C++ linkage before any FLINT header
+#include <stdio.h>
+#include <gmp.h>
+#include <mpfr.h>
+
+#include <cstdlib>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "flint.h"
+#include "F_mpz.h"
+#include "F_mpz_poly.h"
+#include "F_mpz_mat.h"
+
+namespace flint {
+
+class F_mpzxx;
+class F_mpz_polyxx;
+class F_mpz_matxx;
+
+namespace detail {
+
+/*============================================================================
+
+   Kinds of value, giving the C type and the operations used to manage
+   temporaries of that type
+
+=============================================================================*/
+
+struct F_mpz_kind
+{
+   typedef F_mpz val;
+
+   static void init(F_mpz * x) { F_mpz_init(x); }
+   static void clear(F_mpz * x) { F_mpz_clear(x); }
+   static void set(F_mpz * x, const F_mpz * y) { F_mpz_set(x, y); }
+   static void swap(F_mpz * x, F_mpz * y) { F_mpz_swap(x, y); }
+};
+
+struct F_mpz_poly_kind
+{
+   typedef F_mpz_poly_struct val;
+
+   static void init(F_mpz_poly_struct * x) { F_mpz_poly_init(x); }
+   static void clear(F_mpz_poly_struct * x) { F_mpz_poly_clear(x); }
+   static void set(F_mpz_poly_struct * x, const F_mpz_poly_struct * y) { F_mpz_poly_set(x, y); }
+   static void swap(F_mpz_poly_struct * x, F_mpz_poly_struct * y) { F_mpz_poly_swap(x, y); }
+};
+
+struct F_mpz_mat_kind
+{
+   typedef F_mpz_mat_struct val;
+
+   static void init(F_mpz_mat_struct * x) { F_mpz_mat_init(x, 0, 0); }
+   static void clear(F_mpz_mat_struct * x) { F_mpz_mat_clear(x); }
+   static void swap(F_mpz_mat_struct * x, F_mpz_mat_struct * y) { F_mpz_mat_swap(x, y); }
+
+   // gives x the dimensions r x c, destroying its entries if they differ
+   static void fit(F_mpz_mat_struct * x, ulong r, ulong c)
+   {
+      if (x->r != r || x->c != c)
+      {
+         F_mpz_mat_clear(x);
+         F_mpz_mat_init(x, r, c);
+      }
+   }
+
+   static void set(F_mpz_mat_struct * x, const F_mpz_mat_struct * y)
+   {
+      if (x == y) return;
+      fit(x, y->r, y->c);
+      F_mpz_mat_set(x, y);
+   }
+};
+
+/*============================================================================
+
+   Expressions
+
+   Every expression derives from expr_base, has a member typedef kind and a
+   member function void eval(kind::val * res) const, which sets res to the
+   value of the expression. The function must be correct when res is one of
+   the operands of the expression.
+
+=============================================================================*/
+
+struct expr_base {};
+
+struct op_add {};
+struct op_sub {};
+struct op_mul {};
+struct op_mod {};
+struct op_neg {};
+
+template <class T>
+struct is_expr : std::is_base_of<expr_base, T> {};
+
+template <class T>
+struct make_void { typedef void type; };
+
+// whether T is an expression of kind K
+template <class T, class K, class Enable = void>
+struct is_expr_of : std::false_type {};
+
+template <class T, class K>
+struct is_expr_of<T, K, typename std::enable_if<is_expr<T>::value>::type>
+   : std::is_same<typename T::kind, K> {};
+
+// an object of kind K, referred to by pointer
+template <class K>
+struct leaf : expr_base
+{
+   typedef K kind;
+   const typename K::val * p;
+
+   explicit leaf(const typename K::val * q) : p(q) {}
+
+   void eval(typename K::val * res) const { if (res != p) K::set(res, p); }
+};
+
+struct si_leaf : expr_base
+{
+   typedef F_mpz_kind kind;
+   long x;
+
+   explicit si_leaf(long y) : x(y) {}
+
+   void eval(F_mpz * res) const { F_mpz_set_si(res, x); }
+};
+
+struct ui_leaf : expr_base
+{
+   typedef F_mpz_kind kind;
+   ulong x;
+
+   explicit ui_leaf(ulong y) : x(y) {}
+
+   void eval(F_mpz * res) const { F_mpz_set_ui(res, x); }
+};
+
+template <class K, class Op, class L, class R>
+struct binary_expr : expr_base
+{
+   typedef K kind;
+   L l;
+   R r;
+
+   binary_expr(const L & a, const R & b) : l(a), r(b) {}
+
+   void eval(typename K::val * res) const;
+};
+
+template <class K, class Op, class E>
+struct unary_expr : expr_base
+{
+   typedef K kind;
+   E e;
+
+   explicit unary_expr(const E & a) : e(a) {}
+
+   void eval(typename K::val * res) const;
+};
+
+/*
+   The value of an operand as a const pointer, the operand being evaluated
+   into a temporary unless it is a leaf
+*/
+template <class E>
+class arg
+{
+   typedef typename E::kind K;
+   typename K::val t[1];
+
+   arg(const arg &);
+   arg & operator=(const arg &);
+
+public:
+   explicit arg(const E & e) { K::init(t); e.eval(t); }
+   ~arg() { K::clear(t); }
+
+   const typename K::val * get() const { return t; }
+};
+
+template <class K>
+class arg< leaf<K> >
+{
+   const typename K::val * p;
+
+public:
+   explicit arg(const leaf<K> & e) : p(e.p) {}
+
+   const typename K::val * get() const { return p; }
+};
+
+/*============================================================================
+
+   Operands and the kinds of results of operators
+
+=============================================================================*/
+
+template <class T, class Enable = void>
+struct operand {};
+
+template <class T>
+struct operand<T, typename std::enable_if<is_expr<T>::value>::type>
+{
+   typedef T type;
+   typedef typename T::kind kind;
+   static const T & make(const T & x) { return x; }
+};
+
+template <class T>
+struct operand<T, typename std::enable_if<std::is_integral<T>::value
+                                           && std::is_signed<T>::value>::type>
+{
+   typedef si_leaf type;
+   typedef F_mpz_kind kind;
+   static type make(T x) { return type(x); }
+};
+
+template <class T>
+struct operand<T, typename std::enable_if<std::is_integral<T>::value
+                                           && !std::is_signed<T>::value>::type>
+{
+   typedef ui_leaf type;
+   typedef F_mpz_kind kind;
+   static type make(T x) { return type(x); }
+};
+
+// operand<F_mpzxx> etc. are defined after the classes
+
+template <class Op, class KL, class KR>
+struct result {};
+
+template <class K> struct result<op_add, K, K> { typedef K type; };
+template <class K> struct result<op_sub, K, K> { typedef K type; };
+template <class K> struct result<op_mul, K, K> { typedef K type; };
+template <class K> struct result<op_mod, K, F_mpz_kind> { typedef K type; };
+template <> struct result<op_mul, F_mpz_kind, F_mpz_poly_kind> { typedef F_mpz_poly_kind type; };
+template <> struct result<op_mul, F_mpz_poly_kind, F_mpz_kind> { typedef F_mpz_poly_kind type; };
+
+// the type of l Op r, only defined if the operation is supported
+template <class Op, class L, class R, class Enable = void>
+struct binary {};
+
+template <class Op, class L, class R>
+struct binary<Op, L, R, typename make_void<typename result<Op,
+                 typename operand<L>::kind, typename operand<R>::kind>::type>::type>
+{
+   typedef typename result<Op, typename operand<L>::kind,
+                               typename operand<R>::kind>::type kind;
+   typedef binary_expr<kind, Op, typename operand<L>::type,
+                                 typename operand<R>::type> type;
+};
+
+// whether E is a product of two values of kind K
+template <class E, class K>
+struct is_mul_of : std::false_type {};
+
+template <class K, class A, class B>
+struct is_mul_of<binary_expr<K, op_mul, A, B>, K>
+   : std::integral_constant<bool, std::is_same<typename A::kind, K>::value
+                               && std::is_same<typename B::kind, K>::value> {};
+
+/*============================================================================
+
+   Basic operations, on evaluated operands
+
+=============================================================================*/
+
+inline void apply(F_mpz * res, op_add, const F_mpz * a, const F_mpz * b) { F_mpz_add(res, a, b); }
+inline void apply(F_mpz * res, op_sub, const F_mpz * a, const F_mpz * b) { F_mpz_sub(res, a, b); }
+inline void apply(F_mpz * res, op_mul, const F_mpz * a, const F_mpz * b) { F_mpz_mul2(res, a, b); }
+
+inline void apply(F_mpz * res, op_mod, const F_mpz * a, const F_mpz * m)
+{
+   if (res == m)
+   {
+      F_mpz_t t;
+      F_mpz_init(t);
+      F_mpz_mod(t, a, m);
+      F_mpz_swap(res, t);
+      F_mpz_clear(t);
+   } else
+      F_mpz_mod(res, a, m);
+}
+
+inline void apply(F_mpz * res, op_neg, const F_mpz * a) { F_mpz_neg(res, a); }
+
+inline void apply(F_mpz_poly_struct * res, op_add, const F_mpz_poly_struct * a, const F_mpz_poly_struct * b)
+{
+   F_mpz_poly_add(res, a, b);
+}
+
+inline void apply(F_mpz_poly_struct * res, op_sub, const F_mpz_poly_struct * a, const F_mpz_poly_struct * b)
+{
+   F_mpz_poly_sub(res, a, b);
+}
+
+inline void apply(F_mpz_poly_struct * res, op_mul, const F_mpz_poly_struct * a, const F_mpz_poly_struct * b)
+{
+   F_mpz_poly_mul(res, a, b);
+}
+
+inline void apply(F_mpz_poly_struct * res, op_mul, const F_mpz * x, const F_mpz_poly_struct * a)
+{
+   F_mpz_poly_scalar_mul(res, a, x);
+}
+
+inline void apply(F_mpz_poly_struct * res, op_mul, const F_mpz_poly_struct * a, const F_mpz * x)
+{
+   F_mpz_poly_scalar_mul(res, a, x);
+}
+
+// F_mpz_poly_scalar_smod reduces its input in place, so it is only ever given res
+inline void apply(F_mpz_poly_struct * res, op_mod, const F_mpz_poly_struct * a, const F_mpz * m)
+{
+   if (res != a) F_mpz_poly_set(res, a);
+   F_mpz_poly_scalar_smod(res, res, const_cast<F_mpz *>(m));
+}
+
+inline void apply(F_mpz_poly_struct * res, op_neg, const F_mpz_poly_struct * a) { F_mpz_poly_neg(res, a); }
+
+inline void apply(F_mpz_mat_struct * res, op_add, const F_mpz_mat_struct * a, const F_mpz_mat_struct * b)
+{
+   F_mpz_mat_kind::fit(res, a->r, a->c);
+   F_mpz_mat_add(res, a, b);
+}
+
+inline void apply(F_mpz_mat_struct * res, op_sub, const F_mpz_mat_struct * a, const F_mpz_mat_struct * b)
+{
+   F_mpz_mat_kind::fit(res, a->r, a->c);
+   F_mpz_mat_sub(res, a, b);
+}
+
+inline void apply(F_mpz_mat_struct * res, op_mul, const F_mpz_mat_struct * a, const F_mpz_mat_struct * b)
+{
+   F_mpz_mat_mul_classical(res, a, b);
+}
+
+inline void apply(F_mpz_mat_struct * res, op_mod, const F_mpz_mat_struct * a, const F_mpz * m)
+{
+   F_mpz_mat_kind::fit(res, a->r, a->c);
+   F_mpz_mat_smod(res, const_cast<F_mpz_mat_struct *>(a), const_cast<F_mpz *>(m));
+}
+
+inline void apply(F_mpz_mat_struct * res, op_neg, const F_mpz_mat_struct * a)
+{
+   F_mpz_mat_kind::fit(res, a->r, a->c);
+   F_mpz_mat_neg(res, a);
+}
+
+/*============================================================================
+
+   Fused operations
+
+   muladd sets res to c + a*b, or c - a*b if sub is set, and mulmod sets res
+   to (a*b) % m.
+
+=============================================================================*/
+
+template <class C, class A, class B>
+inline void muladd(F_mpz * res, const C & c, const A & a, const B & b, bool sub)
+{
+   arg<A> x(a);
+   arg<B> y(b);
+
+   if (res == x.get() || res == y.get())
+   {
+      F_mpz_t t;
+      F_mpz_init(t);
+      c.eval(t);
+      if (sub) F_mpz_submul(t, x.get(), y.get());
+      else F_mpz_addmul(t, x.get(), y.get());
+      F_mpz_swap(res, t);
+      F_mpz_clear(t);
+   } else
+   {
+      c.eval(res);
+      if (sub) F_mpz_submul(res, x.get(), y.get());
+      else F_mpz_addmul(res, x.get(), y.get());
+   }
+}
+
+template <class C, class A, class B>
+inline void muladd(F_mpz_poly_struct * res, const C & c, const A & a, const B & b, bool sub)
+{
+   arg<A> x(a);
+   arg<B> y(b);
+   arg<C> z(c);
+
+   if (res == x.get() || res == y.get() || res == z.get())
+   {
+      F_mpz_poly_t t;
+      F_mpz_poly_init(t);
+      F_mpz_poly_mul(t, x.get(), y.get());
+      if (sub) F_mpz_poly_sub(res, z.get(), t);
+      else F_mpz_poly_add(res, z.get(), t);
+      F_mpz_poly_clear(t);
+   } else
+   {
+      F_mpz_poly_mul(res, x.get(), y.get());
+      if (sub) F_mpz_poly_sub(res, z.get(), res);
+      else F_mpz_poly_add(res, res, z.get());
+   }
+}
+
+template <class C, class A, class B>
+inline void muladd(F_mpz_mat_struct * res, const C & c, const A & a, const B & b, bool sub)
+{
+   arg<A> x(a);
+   arg<B> y(b);
+   arg<C> z(c);
+
+   F_mpz_mat_struct * p = res;
+   F_mpz_mat_t t;
+   int temp = (res == x.get() || res == y.get() || res == z.get());
+
+   if (temp)
+   {
+      F_mpz_mat_init(t, 0, 0);
+      p = t;
+   }
+
+   F_mpz_mat_mul_classical(p, x.get(), y.get());
+   if (sub) F_mpz_mat_sub(p, z.get(), p);
+   else F_mpz_mat_add(p, p, z.get());
+
+   if (temp)
+   {
+      F_mpz_mat_swap(res, t);
+      F_mpz_mat_clear(t);
+   }
+}
+
+template <class A, class B, class M>
+inline void mulmod(F_mpz * res, const A & a, const B & b, const M & m)
+{
+   arg<A> x(a);
+   arg<B> y(b);
+   arg<M> z(m);
+
+   if (res == z.get())
+   {
+      F_mpz_t t;
+      F_mpz_init(t);
+      F_mpz_mulmod2(t, x.get(), y.get(), z.get());
+      F_mpz_swap(res, t);
+      F_mpz_clear(t);
+   } else
+      F_mpz_mulmod2(res, x.get(), y.get(), z.get());
+}
+
+template <class A, class B, class M>
+inline void mulmod(F_mpz_poly_struct * res, const A & a, const B & b, const M & m)
+{
+   arg<A> x(a);
+   arg<B> y(b);
+   arg<M> z(m);
+
+   F_mpz_poly_mul(res, x.get(), y.get());
+   F_mpz_poly_scalar_smod(res, res, const_cast<F_mpz *>(z.get()));
+}
+
+template <class A, class B, class M>
+inline void mulmod(F_mpz_mat_struct * res, const A & a, const B & b, const M & m)
+{
+   arg<A> x(a);
+   arg<B> y(b);
+   arg<M> z(m);
+
+   F_mpz_mat_mul_classical(res, x.get(), y.get());
+   F_mpz_mat_smod(res, res, const_cast<F_mpz *>(z.get()));
+}
+
+/*============================================================================
+
+   Evaluation, selecting a fused operation where the shape of the expression
+   allows one
+
+=============================================================================*/
+
+template <class V, class Op, class L, class R>
+inline void eval_basic(V * res, Op, const L & l, const R & r)
+{
+   arg<L> a(l);
+   arg<R> b(r);
+   apply(res, Op(), a.get(), b.get());
+}
+
+// l + r with neither a product
+template <class K, class L, class R>
+inline void eval_add(typename K::val * res, const L & l, const R & r, std::false_type, std::false_type)
+{
+   eval_basic(res, op_add(), l, r);
+}
+
+// l + a*b
+template <class K, class L, class R, class LM>
+inline void eval_add(typename K::val * res, const L & l, const R & r, LM, std::true_type)
+{
+   muladd(res, l, r.l, r.r, false);
+}
+
+// a*b + r
+template <class K, class L, class R>
+inline void eval_add(typename K::val * res, const L & l, const R & r, std::true_type, std::false_type)
+{
+   muladd(res, r, l.l, l.r, false);
+}
+
+template <class K, class L, class R>
+inline void eval_sub(typename K::val * res, const L & l, const R & r, std::false_type, std::false_type)
+{
+   eval_basic(res, op_sub(), l, r);
+}
+
+// l - a*b
+template <class K, class L, class R, class LM>
+inline void eval_sub(typename K::val * res, const L & l, const R & r, LM, std::true_type)
+{
+   muladd(res, l, r.l, r.r, true);
+}
+
+// a*b - r = -(r - a*b)
+template <class K, class L, class R>
+inline void eval_sub(typename K::val * res, const L & l, const R & r, std::true_type, std::false_type)
+{
+   muladd(res, r, l.l, l.r, true);
+   apply(res, op_neg(), res);
+}
+
+template <class K, class L, class R>
+inline void eval_mod(typename K::val * res, const L & l, const R & r, std::false_type)
+{
+   eval_basic(res, op_mod(), l, r);
+}
+
+// (a*b) % r
+template <class K, class L, class R>
+inline void eval_mod(typename K::val * res, const L & l, const R & r, std::true_type)
+{
+   mulmod(res, l.l, l.r, r);
+}
+
+template <class K, class L, class R>
+inline void eval(typename K::val * res, op_add, const L & l, const R & r)
+{
+   eval_add<K>(res, l, r, std::integral_constant<bool, is_mul_of<L, K>::value>(),
+                          std::integral_constant<bool, is_mul_of<R, K>::value>());
+}
+
+template <class K, class L, class R>
+inline void eval(typename K::val * res, op_sub, const L & l, const R & r)
+{
+   eval_sub<K>(res, l, r, std::integral_constant<bool, is_mul_of<L, K>::value>(),
+                          std::integral_constant<bool, is_mul_of<R, K>::value>());
+}
+
+template <class K, class L, class R>
+inline void eval(typename K::val * res, op_mul, const L & l, const R & r)
+{
+   eval_basic(res, op_mul(), l, r);
+}
+
+template <class K, class L, class R>
+inline void eval(typename K::val * res, op_mod, const L & l, const R & r)
+{
+   eval_mod<K>(res, l, r, std::integral_constant<bool, is_mul_of<L, K>::value>());
+}
+
+template <class K, class Op, class L, class R>
+inline void binary_expr<K, Op, L, R>::eval(typename K::val * res) const
+{
+   detail::eval<K>(res, Op(), l, r);
+}
+
+template <class K, class Op, class E>
+inline void unary_expr<K, Op, E>::eval(typename K::val * res) const
+{
+   arg<E> a(e);
+   apply(res, Op(), a.get());
+}
+
+} // namespace detail
+
+/*============================================================================
+
+   Operators, defined for any combination of operands for which a result
+   kind is defined
+
+=============================================================================*/
+
+template <class L, class R>
+inline typename detail::binary<detail::op_add, L, R>::type
+operator+(const L & l, const R & r)
+{
+   return typename detail::binary<detail::op_add, L, R>::type(
+             detail::operand<L>::make(l), detail::operand<R>::make(r));
+}
+
+template <class L, class R>
+inline typename detail::binary<detail::op_sub, L, R>::type
+operator-(const L & l, const R & r)
+{
+   return typename detail::binary<detail::op_sub, L, R>::type(
+             detail::operand<L>::make(l), detail::operand<R>::make(r));
+}
+
+template <class L, class R>
+inline typename detail::binary<detail::op_mul, L, R>::type
+operator*(const L & l, const R & r)
+{
+   return typename detail::binary<detail::op_mul, L, R>::type(
+             detail::operand<L>::make(l), detail::operand<R>::make(r));
+}
+
+template <class L, class R>
+inline typename detail::binary<detail::op_mod, L, R>::type
+operator%(const L & l, const R & r)
+{
+   return typename detail::binary<detail::op_mod, L, R>::type(
+             detail::operand<L>::make(l), detail::operand<R>::make(r));
+}
+
+template <class E>
+inline detail::unary_expr<typename detail::operand<E>::kind, detail::op_neg,
+                          typename detail::operand<E>::type>
+operator-(const E & e)
+{
+   return detail::unary_expr<typename detail::operand<E>::kind, detail::op_neg,
+                      typename detail::operand<E>::type>(detail::operand<E>::make(e));
+}
+
+/*============================================================================
+
+   F_mpzxx
+
+=============================================================================*/
+
+class F_mpzxx
+{
+   F_mpz_t _data;
+
+public:
+   F_mpzxx() { F_mpz_init(_data); }
+   F_mpzxx(long x) { F_mpz_init(_data); F_mpz_set_si(_data, x); }
+   F_mpzxx(int x) { F_mpz_init(_data); F_mpz_set_si(_data, x); }
+   F_mpzxx(ulong x) { F_mpz_init(_data); F_mpz_set_ui(_data, x); }
+   explicit F_mpzxx(const mpz_t x) { F_mpz_init(_data); F_mpz_set_mpz(_data, x); }
+   F_mpzxx(const F_mpzxx & x) { F_mpz_init(_data); F_mpz_set(_data, x._data); }
+
+   // an mpz is referred to by index, so is simply taken over
+   F_mpzxx(F_mpzxx && x) noexcept { _data[0] = x._data[0]; x._data[0] = 0L; }
+
+   template <class E, class = typename std::enable_if<detail::is_expr_of<E, detail::F_mpz_kind>::value>::type>
+   F_mpzxx(const E & e) { F_mpz_init(_data); e.eval(_data); }
+
+   ~F_mpzxx() { F_mpz_clear(_data); }
+
+   F_mpzxx & operator=(const F_mpzxx & x) { F_mpz_set(_data, x._data); return *this; }
+   F_mpzxx & operator=(F_mpzxx && x) noexcept { F_mpz_swap(_data, x._data); return *this; }
+   F_mpzxx & operator=(long x) { F_mpz_set_si(_data, x); return *this; }
+
+   template <class E>
+   typename std::enable_if<detail::is_expr_of<E, detail::F_mpz_kind>::value, F_mpzxx &>::type
+   operator=(const E & e) { e.eval(_data); return *this; }
+
+   template <class T> F_mpzxx & operator+=(const T & x) { return *this = *this + x; }
+   template <class T> F_mpzxx & operator-=(const T & x) { return *this = *this - x; }
+   template <class T> F_mpzxx & operator*=(const T & x) { return *this = *this * x; }
+   template <class T> F_mpzxx & operator%=(const T & x) { return *this = *this % x; }
+
+   void swap(F_mpzxx & x) { F_mpz_swap(_data, x._data); }
+
+   F_mpz * _F_mpz() { return _data; }
+   const F_mpz * _F_mpz() const { return _data; }
+
+   int sgn() const { return F_mpz_sgn(_data); }
+   int is_zero() const { return F_mpz_is_zero(_data); }
+   long get_si() const { return F_mpz_get_si(_data); }
+   ulong bits() const { return F_mpz_bits(_data); }
+
+   void get_mpz(mpz_t x) const { F_mpz_get_mpz(x, _data); }
+
+   std::string to_string(int base = 10) const
+   {
+      mpz_t x;
+      mpz_init(x);
+      F_mpz_get_mpz(x, _data);
+      char * s = mpz_get_str(NULL, base, x);
+      std::string str(s);
+      void (*free_fn)(void *, size_t);
+      mp_get_memory_functions(NULL, NULL, &free_fn);
+      free_fn(s, str.length() + 1);
+      mpz_clear(x);
+      return str;
+   }
+};
+
+inline int cmp(const F_mpzxx & a, const F_mpzxx & b) { return F_mpz_cmp(a._F_mpz(), b._F_mpz()); }
+
+inline bool operator==(const F_mpzxx & a, const F_mpzxx & b) { return cmp(a, b) == 0; }
+inline bool operator!=(const F_mpzxx & a, const F_mpzxx & b) { return cmp(a, b) != 0; }
+inline bool operator<(const F_mpzxx & a, const F_mpzxx & b) { return cmp(a, b) < 0; }
+inline bool operator<=(const F_mpzxx & a, const F_mpzxx & b) { return cmp(a, b) <= 0; }
+inline bool operator>(const F_mpzxx & a, const F_mpzxx & b) { return cmp(a, b) > 0; }
+inline bool operator>=(const F_mpzxx & a, const F_mpzxx & b) { return cmp(a, b) >= 0; }
+
+inline std::ostream & operator<<(std::ostream & os, const F_mpzxx & a)
+{
+   return os << a.to_string();
+}
+
+namespace detail {
+
+template <>
+struct operand<F_mpzxx>
+{
+   typedef leaf<F_mpz_kind> type;
+   typedef F_mpz_kind kind;
+   static type make(const F_mpzxx & x) { return type(x._F_mpz()); }
+};
+
+} // namespace detail
+
+/*============================================================================
+
+   F_mpz_polyxx
+
+=============================================================================*/
+
+class F_mpz_polyxx
+{
+   F_mpz_poly_t _data;
+
+public:
+   F_mpz_polyxx() { F_mpz_poly_init(_data); }
+   explicit F_mpz_polyxx(ulong alloc) { F_mpz_poly_init2(_data, alloc); }
+   F_mpz_polyxx(const F_mpz_polyxx & x) { F_mpz_poly_init(_data); F_mpz_poly_set(_data, x._data); }
+   F_mpz_polyxx(F_mpz_polyxx && x) noexcept { F_mpz_poly_init(_data); F_mpz_poly_swap(_data, x._data); }
+
+   // parses a string in the format of F_mpz_poly_to_string, giving the zero
+   // polynomial if it is not valid
+   explicit F_mpz_polyxx(const char * s)
+   {
+      F_mpz_poly_init(_data);
+      if (!F_mpz_poly_from_string(_data, s))
+         F_mpz_poly_zero(_data);
+   }
+
+   template <class E, class = typename std::enable_if<detail::is_expr_of<E, detail::F_mpz_poly_kind>::value>::type>
+   F_mpz_polyxx(const E & e) { F_mpz_poly_init(_data); e.eval(_data); }
+
+   ~F_mpz_polyxx() { F_mpz_poly_clear(_data); }
+
+   F_mpz_polyxx & operator=(const F_mpz_polyxx & x) { F_mpz_poly_set(_data, x._data); return *this; }
+   F_mpz_polyxx & operator=(F_mpz_polyxx && x) noexcept { F_mpz_poly_swap(_data, x._data); return *this; }
+
+   template <class E>
+   typename std::enable_if<detail::is_expr_of<E, detail::F_mpz_poly_kind>::value, F_mpz_polyxx &>::type
+   operator=(const E & e) { e.eval(_data); return *this; }
+
+   template <class T> F_mpz_polyxx & operator+=(const T & x) { return *this = *this + x; }
+   template <class T> F_mpz_polyxx & operator-=(const T & x) { return *this = *this - x; }
+   template <class T> F_mpz_polyxx & operator*=(const T & x) { return *this = *this * x; }
+   template <class T> F_mpz_polyxx & operator%=(const T & x) { return *this = *this % x; }
+
+   void swap(F_mpz_polyxx & x) { F_mpz_poly_swap(_data, x._data); }
+
+   F_mpz_poly_struct * _poly() { return _data; }
+   const F_mpz_poly_struct * _poly() const { return _data; }
+
+   ulong length() const { return _data->length; }
+   long degree() const { return (long) _data->length - 1; }
+
+   F_mpzxx get_coeff(ulong n) const
+   {
+      F_mpzxx c;
+      if (n < _data->length) F_mpz_set(c._F_mpz(), _data->coeffs + n);
+      return c;
+   }
+
+   void set_coeff(ulong n, const F_mpzxx & c) { F_mpz_poly_set_coeff(_data, n, c._F_mpz()); }
+   void set_coeff(ulong n, long c) { F_mpz_poly_set_coeff_si(_data, n, c); }
+
+   std::string to_string() const
+   {
+      char * s = F_mpz_poly_to_string(_data);
+      std::string str(s);
+      free(s);
+      return str;
+   }
+};
+
+inline bool operator==(const F_mpz_polyxx & a, const F_mpz_polyxx & b)
+{
+   return F_mpz_poly_equal(a._poly(), b._poly());
+}
+
+inline bool operator!=(const F_mpz_polyxx & a, const F_mpz_polyxx & b) { return !(a == b); }
+
+inline std::ostream & operator<<(std::ostream & os, const F_mpz_polyxx & a)
+{
+   return os << a.to_string();
+}
+
+namespace detail {
+
+template <>
+struct operand<F_mpz_polyxx>
+{
+   typedef leaf<F_mpz_poly_kind> type;
+   typedef F_mpz_poly_kind kind;
+   static type make(const F_mpz_polyxx & x) { return type(x._poly()); }
+};
+
+} // namespace detail
+
+/*============================================================================
+
+   F_mpz_matxx
+
+=============================================================================*/
+
+class F_mpz_matxx
+{
+   F_mpz_mat_t _data;
+
+public:
+   F_mpz_matxx() { F_mpz_mat_init(_data, 0, 0); }
+   F_mpz_matxx(ulong r, ulong c) { F_mpz_mat_init(_data, r, c); }
+   F_mpz_matxx(const F_mpz_matxx & x) { F_mpz_mat_init(_data, x._data->r, x._data->c); F_mpz_mat_set(_data, x._data); }
+   F_mpz_matxx(F_mpz_matxx && x) noexcept { F_mpz_mat_init(_data, 0, 0); F_mpz_mat_swap(_data, x._data); }
+
+   template <class E, class = typename std::enable_if<detail::is_expr_of<E, detail::F_mpz_mat_kind>::value>::type>
+   F_mpz_matxx(const E & e) { F_mpz_mat_init(_data, 0, 0); e.eval(_data); }
+
+   ~F_mpz_matxx() { F_mpz_mat_clear(_data); }
+
+   F_mpz_matxx & operator=(const F_mpz_matxx & x) { detail::F_mpz_mat_kind::set(_data, x._data); return *this; }
+   F_mpz_matxx & operator=(F_mpz_matxx && x) noexcept { F_mpz_mat_swap(_data, x._data); return *this; }
+
+   template <class E>
+   typename std::enable_if<detail::is_expr_of<E, detail::F_mpz_mat_kind>::value, F_mpz_matxx &>::type
+   operator=(const E & e) { e.eval(_data); return *this; }
+
+   template <class T> F_mpz_matxx & operator+=(const T & x) { return *this = *this + x; }
+   template <class T> F_mpz_matxx & operator-=(const T & x) { return *this = *this - x; }
+   template <class T> F_mpz_matxx & operator*=(const T & x) { return *this = *this * x; }
+   template <class T> F_mpz_matxx & operator%=(const T & x) { return *this = *this % x; }
+
+   void swap(F_mpz_matxx & x) { F_mpz_mat_swap(_data, x._data); }
+
+   F_mpz_mat_struct * _mat() { return _data; }
+   const F_mpz_mat_struct * _mat() const { return _data; }
+
+   ulong rows() const { return _data->r; }
+   ulong cols() const { return _data->c; }
+
+   F_mpz * entry(ulong i, ulong j) { return _data->rows[i] + j; }
+   const F_mpz * entry(ulong i, ulong j) const { return _data->rows[i] + j; }
+
+   F_mpzxx get_entry(ulong i, ulong j) const
+   {
+      F_mpzxx c;
+      F_mpz_set(c._F_mpz(), entry(i, j));
+      return c;
+   }
+
+   void set_entry(ulong i, ulong j, const F_mpzxx & c) { F_mpz_set(entry(i, j), c._F_mpz()); }
+   void set_entry(ulong i, ulong j, long c) { F_mpz_set_si(entry(i, j), c); }
+};
+
+inline bool operator==(const F_mpz_matxx & a, const F_mpz_matxx & b)
+{
+   return a.rows() == b.rows() && a.cols() == b.cols()
+       && F_mpz_mat_equal(a._mat(), b._mat());
+}
+
+inline bool operator!=(const F_mpz_matxx & a, const F_mpz_matxx & b) { return !(a == b); }
+
+namespace detail {
+
+template <>
+struct operand<F_mpz_matxx>
+{
+   typedef leaf<F_mpz_mat_kind> type;
+   typedef F_mpz_mat_kind kind;
+   static type make(const F_mpz_matxx & x) { return type(x._mat()); }
+};
+
+} // namespace detail
+
+} // namespace flint
+
+#endif
+
+// *************** end of file
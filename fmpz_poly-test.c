@@ -1647,6 +1647,57 @@ int test_fmpz_poly_tofromstring()
    return result; 
 }
 
+int test_fmpz_poly_fprint()
+{
+   mpz_poly_t test_poly;
+   fmpz_poly_t test_fmpz_poly;
+   int result = 1;
+   unsigned long bits, length;
+   
+   mpz_poly_init(test_poly); 
+   
+   unsigned long count1;
+   for (count1 = 1; (count1 < 200) && (result == 1) ; count1++)
+   {
+      bits = random_ulong(300)+ 1;
+      
+      fmpz_poly_init2(test_fmpz_poly, 1, (bits-1)/FLINT_BITS+1);
+      
+      unsigned long count2;
+      for (count2 = 0; (count2 < 10) && (result == 1); count2++)
+      { 
+          length = random_ulong(100);        
+#if DEBUG
+          printf("length = %ld, bits = %ld\n",length, bits);
+#endif
+          fmpz_poly_fit_length(test_fmpz_poly, length);
+          randpoly(test_poly, length, bits); 
+
+          mpz_poly_to_fmpz_poly(test_fmpz_poly, test_poly);
+          
+          // the streamed output must match the string exactly
+          char * strbuf = fmpz_poly_to_string(test_fmpz_poly);
+          FILE * testfile = tmpfile();
+          fmpz_poly_fprint(test_fmpz_poly, testfile);
+          rewind(testfile);
+
+          unsigned long i;
+          for (i = 0; (result) && (i < strlen(strbuf)); i++)
+             result = (getc(testfile) == strbuf[i]);
+          result = result && (getc(testfile) == EOF);
+          
+          fclose(testfile);
+          free(strbuf);
+      }
+            
+      fmpz_poly_clear(test_fmpz_poly);
+   }
+   
+   mpz_poly_clear(test_poly);
+   
+   return result; 
+}
+
 int test__fmpz_poly_zero_coeffs()
 {
    mpz_poly_t test_poly;
@@ -12867,6 +12918,81 @@ int test_fmpz_poly_CRT()
    return result;
 }
 
+int test_fmpz_poly_multi_CRT_ui()
+{
+   mpz_poly_t pol1;
+   fmpz_poly_t fpol1, fpol2;
+   zmod_poly_t zpol;
+   unsigned long bits, length;
+   int result = 1;
+   
+   mpz_poly_init(pol1);
+   fmpz_poly_init(fpol1);
+   fmpz_poly_init(fpol2);
+   
+   unsigned long i, j;
+   for (i = 0; (i < 2000) && (result == 1); i++)
+   {
+       bits = random_ulong(1000)+1;
+       length = random_ulong(100)+1;
+
+       randpoly(pol1, length, bits);
+       mpz_poly_to_fmpz_poly(fpol1, pol1);
+
+#if DEBUG
+       printf("bits = %ld, length = %ld\n", bits, length);
+#endif
+      
+       // sometimes use more primes than we need
+       unsigned long num_primes = (bits + 1)/(FLINT_BITS - 2) + 1 + random_ulong(3);
+       unsigned long * primes = (unsigned long *) flint_heap_alloc(num_primes);
+       zmod_poly_p images = (zmod_poly_p) flint_heap_alloc_bytes(num_primes*sizeof(zmod_poly_struct));
+
+       primes[0] = z_nextprime(1L<<(FLINT_BITS-2), 0);
+       for (j = 1; j < num_primes; j++)
+          primes[j] = z_nextprime(primes[j - 1], 0);
+       for (j = 0; j < num_primes; j++)
+          zmod_poly_init(images + j, primes[j]);
+
+       fmpz_comb_t comb;
+       fmpz_comb_init(comb, primes, num_primes);
+       fmpz_t ** comb_temp = fmpz_comb_temp_init(comb);
+
+       fmpz_poly_multi_mod_ui(images, fpol1, comb, comb_temp);
+
+       for (j = 0; (j < num_primes) && (result == 1); j++)
+       {
+          zmod_poly_init(zpol, primes[j]);
+          fmpz_poly_to_zmod_poly(zpol, fpol1);
+          result = zmod_poly_equal(zpol, images + j);
+          zmod_poly_clear(zpol);
+       }
+
+       fmpz_poly_multi_CRT_ui(fpol2, images, comb, comb_temp);
+
+       result &= (fmpz_poly_equal(fpol1, fpol2));
+
+       if (!result)
+       {
+          fmpz_poly_print(fpol1); printf("\n\n");
+          fmpz_poly_print(fpol2); printf("\n\n");
+       }
+       
+       fmpz_comb_temp_clear(comb_temp, comb);
+       fmpz_comb_clear(comb);
+       for (j = 0; j < num_primes; j++)
+          zmod_poly_clear(images + j);
+       flint_heap_free(images);
+       flint_heap_free(primes);
+   }
+   
+   mpz_poly_clear(pol1);
+   fmpz_poly_clear(fpol1);
+   fmpz_poly_clear(fpol2);
+   
+   return result;
+}
+
 int test_fmpz_poly_invmod_modular()
 {
    mpz_poly_t test_poly, test_poly2;
@@ -13406,6 +13532,112 @@ int test_fmpz_poly_resultant()
    return result;
 }
 
+/*
+   The images modulo the primes are computed in parallel when FLINT is built
+   with OpenMP. Check that the results do not depend on the number of threads.
+*/
+
+void set_num_threads(int threads)
+{
+#ifdef _OPENMP
+   omp_set_num_threads(threads);
+#endif
+}
+
+int test_fmpz_poly_modular_threads()
+{
+   mpz_poly_t pol;
+   fmpz_poly_t f, g, h, a, b, H1, H2;
+   int result = 1;
+   unsigned long bits;
+   
+#ifdef _OPENMP
+   int max_threads = omp_get_max_threads();
+#endif
+
+   mpz_poly_init(pol);
+   fmpz_poly_init(f);
+   fmpz_poly_init(g);
+   fmpz_poly_init(h);
+   fmpz_poly_init(a);
+   fmpz_poly_init(b);
+   fmpz_poly_init(H1);
+   fmpz_poly_init(H2);
+   
+   unsigned long count1;
+   for (count1 = 0; (count1 < 300) && (result == 1); count1++)
+   {
+      bits = random_ulong(200) + 1;
+
+      do
+      {
+         randpoly(pol, random_ulong(20) + 1, bits);
+         mpz_poly_to_fmpz_poly(f, pol);
+      } while (f->length == 0);
+      
+      do
+      {
+         randpoly(pol, random_ulong(40) + 2, bits);
+         mpz_poly_to_fmpz_poly(h, pol);
+      } while (h->length < 3);
+      fmpz_set_ui(_fmpz_poly_lead(h), 1UL);
+
+      do
+      {
+         randpoly(pol, random_ulong(h->length - 2) + 2, bits);
+         mpz_poly_to_fmpz_poly(g, pol);
+      } while (g->length < 2);
+      
+      fmpz_poly_mul(a, f, g);
+      fmpz_poly_mul(b, f, h);
+      
+#if DEBUG
+      printf("length1 = %ld, length2 = %ld, bits = %ld\n", a->length, b->length, bits);
+#endif
+
+      fmpz_t r1 = fmpz_init(fmpz_poly_resultant_bound(g, h)/FLINT_BITS + 2);
+      fmpz_t r2 = fmpz_init(fmpz_poly_resultant_bound(g, h)/FLINT_BITS + 2);
+
+      set_num_threads(1);
+      fmpz_poly_gcd_modular(H1, a, b, 0, 0);
+      fmpz_poly_resultant(r1, g, h);
+      
+      set_num_threads(4);
+      fmpz_poly_gcd_modular(H2, a, b, 0, 0);
+      fmpz_poly_resultant(r2, g, h);
+
+      result = (fmpz_poly_equal(H1, H2) && fmpz_equal(r1, r2));
+
+      if (result && !fmpz_is_zero(r1)) // g is invertible modulo h
+      {
+         set_num_threads(1);
+         fmpz_poly_invmod_modular(r1, H1, g, h);
+         set_num_threads(4);
+         fmpz_poly_invmod_modular(r2, H2, g, h);
+
+         result = (fmpz_poly_equal(H1, H2) && fmpz_equal(r1, r2));
+      }
+
+      fmpz_clear(r2);
+      fmpz_clear(r1);
+   }
+   
+#ifdef _OPENMP
+   omp_set_num_threads(max_threads);
+#endif
+
+   fmpz_poly_clear(H2);
+   fmpz_poly_clear(H1);
+   fmpz_poly_clear(b);
+   fmpz_poly_clear(a);
+   fmpz_poly_clear(h);
+   fmpz_poly_clear(g);
+   fmpz_poly_clear(f);
+   mpz_poly_clear(pol);
+   
+   return result;
+}
+
 int test_fmpz_poly_xgcd_modular()
 {
    mpz_poly_t test_poly, test_poly2;
@@ -15659,6 +15891,7 @@ void fmpz_poly_test_all()
 #endif
 		
    RUN_TEST(fmpz_poly_tofromstring); 
+   RUN_TEST(fmpz_poly_fprint); 
    RUN_TEST(fmpz_poly_to_ZmodF_poly); 
    RUN_TEST(fmpz_poly_to_zmod_poly_no_red);   
    RUN_TEST(fmpz_poly_bit_pack); 
@@ -15780,11 +16013,13 @@ void fmpz_poly_test_all()
    RUN_TEST(fmpz_poly_primitive_part); 
    RUN_TEST(fmpz_poly_CRT_unsigned);
    RUN_TEST(fmpz_poly_CRT);
+   RUN_TEST(fmpz_poly_multi_CRT_ui);
    RUN_TEST(fmpz_poly_gcd_subresultant); 
    RUN_TEST(fmpz_poly_gcd_modular);
    RUN_TEST(fmpz_poly_gcd_heuristic);
    RUN_TEST(fmpz_poly_gcd); 
    RUN_TEST(fmpz_poly_resultant);
+   RUN_TEST(fmpz_poly_modular_threads);
    RUN_TEST(fmpz_poly_2norm);
    RUN_TEST(fmpz_poly_invmod_modular);
    RUN_TEST(fmpz_poly_invmod);
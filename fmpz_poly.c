@@ -1537,6 +1537,95 @@ int fmpz_poly_CRT(fmpz_poly_t res, fmpz_poly_t fpol, zmod_poly_t zpol, fmpz_t ne
 		return __fmpz_poly_CRT(res, fpol, zpol, newmod, oldmod);
 }
 
+/*
+   Multimodular reduction and reconstruction using a comb (product tree) 
+   on the primes, see fmpz_poly.h
+*/
+
+void fmpz_poly_multi_mod_ui(zmod_poly_p out, const fmpz_poly_t poly, 
+                            fmpz_comb_t comb, fmpz_t ** comb_temp)
+{
+   unsigned long num_primes = comb->num_primes;
+   unsigned long size = poly->limbs + 1;
+   unsigned long i, j;
+
+   for (j = 0; j < num_primes; j++)
+      zmod_poly_fit_length(out + j, poly->length);
+
+   unsigned long * r = (unsigned long *) flint_heap_alloc(num_primes);
+   fmpz_t top = NULL, temp = NULL;
+   if (comb->n) 
+   {
+      top = comb->comb[comb->n - 1][0];
+      temp = fmpz_init(fmpz_size(top) + 1);
+   }
+
+   fmpz_t coeff = poly->coeffs;
+   for (i = 0; i < poly->length; i++, coeff += size)
+   {
+      unsigned long csize = fmpz_size(coeff);
+      
+      if ((comb->n == 0) || (csize <= 1))
+      {
+         for (j = 0; j < num_primes; j++)
+            r[j] = fmpz_mod_ui(coeff, comb->primes[j]);
+      } else if (((long) coeff[0] < 0L) || (csize >= fmpz_size(top)))
+      {
+         // fmpz_multi_mod_ui requires 0 <= coeff < product of the primes
+         fmpz_mod(temp, coeff, top);
+         if (temp[0] == 0L)
+            for (j = 0; j < num_primes; j++)
+               r[j] = 0L;
+         else
+            fmpz_multi_mod_ui(r, temp, comb, comb_temp);
+      } else
+         fmpz_multi_mod_ui(r, coeff, comb, comb_temp);
+
+      for (j = 0; j < num_primes; j++)
+         out[j].coeffs[i] = r[j];
+   }
+
+   for (j = 0; j < num_primes; j++)
+   {
+      out[j].length = poly->length;
+      __zmod_poly_normalise(out + j);
+   }
+
+   if (comb->n) fmpz_clear(temp);
+   flint_heap_free(r);
+}
+
+void fmpz_poly_multi_CRT_ui(fmpz_poly_t res, zmod_poly_p in, 
+                            fmpz_comb_t comb, fmpz_t ** comb_temp)
+{
+   unsigned long num_primes = comb->num_primes;
+   unsigned long length = 0;
+   unsigned long i, j;
+
+   for (j = 0; j < num_primes; j++)
+      if (in[j].length > length) length = in[j].length;
+
+   // the output coefficients are bounded by the product of the primes
+   fmpz_poly_fit_length(res, length);
+   fmpz_poly_fit_limbs(res, num_primes);
+
+   unsigned long * r = (unsigned long *) flint_heap_alloc(num_primes);
+   unsigned long size = res->limbs + 1;
+
+   for (i = 0; i < length; i++)
+   {
+      for (j = 0; j < num_primes; j++)
+         r[j] = (i < in[j].length) ? in[j].coeffs[i] : 0L;
+      
+      fmpz_multi_CRT_ui(res->coeffs + i*size, r, comb, comb_temp);
+   }
+
+   res->length = length;
+   _fmpz_poly_normalise(res);
+
+   flint_heap_free(r);
+}
+
 /****************************************************************************
 
    _fmpz_poly_* layer
@@ -5162,9 +5251,22 @@ char* fmpz_poly_to_string_pretty(const fmpz_poly_t poly, const char * x)
 
 void fmpz_poly_fprint(const fmpz_poly_t poly, FILE* f)
 {
-   char* s = fmpz_poly_to_string(poly);
-   fputs(s, f);
-   free(s);
+   // written a coefficient at a time, in the format of fmpz_poly_to_string
+   fprintf(f, poly->length ? "%ld  " : "%ld ", poly->length);
+
+   mpz_t coeff;
+   mpz_init(coeff);
+
+   unsigned long i;
+   mp_limb_t* ptr = poly->coeffs;
+   for (i = 0; i < poly->length; i++, ptr += poly->limbs+1)
+   {
+      if (i) fputc(' ', f);
+      fmpz_to_mpz(coeff, ptr);
+      mpz_out_str(f, 10, coeff);
+   }
+
+   mpz_clear(coeff);
 }
 
 void fmpz_poly_fprint_pretty(const fmpz_poly_t poly, FILE* f, const char * x)
@@ -9415,6 +9517,48 @@ void fmpz_poly_gcd_subresultant(fmpz_poly_t D, const fmpz_poly_t poly1, const fm
    fmpz_clear(d); //release d
 }
 
+/*
+   Number of residues (coefficients times primes) we reduce at once in the 
+   multimodular algorithms below
+*/
+
+#define FMPZ_POLY_MULTI_MOD_BATCH 1048576L
+
+/*
+   Reduce A and B modulo each of the given primes, writing the images to a 
+   and b, which must be initialised with the corresponding moduli
+*/
+
+void __fmpz_poly_multi_mod_ui2(zmod_poly_p a, zmod_poly_p b, 
+       const fmpz_poly_t A, const fmpz_poly_t B, unsigned long * primes, unsigned long num_primes)
+{
+   fmpz_comb_t comb;
+   fmpz_comb_init(comb, primes, num_primes);
+   fmpz_t ** comb_temp = fmpz_comb_temp_init(comb);
+   
+   fmpz_poly_multi_mod_ui(a, A, comb, comb_temp);
+   fmpz_poly_multi_mod_ui(b, B, comb, comb_temp);
+   
+   fmpz_comb_temp_clear(comb_temp, comb);
+   fmpz_comb_clear(comb);
+}
+
+/*
+   Reconstruct H from the images h modulo the given primes
+*/
+
+void __fmpz_poly_multi_CRT_ui(fmpz_poly_t H, zmod_poly_p h, unsigned long * primes, unsigned long num_primes)
+{
+   fmpz_comb_t comb;
+   fmpz_comb_init(comb, primes, num_primes);
+   fmpz_t ** comb_temp = fmpz_comb_temp_init(comb);
+   
+   fmpz_poly_multi_CRT_ui(H, h, comb, comb_temp);
+   
+   fmpz_comb_temp_clear(comb_temp, comb);
+   fmpz_comb_clear(comb);
+}
+
 void fmpz_poly_gcd_modular(fmpz_poly_t H, const fmpz_poly_t poly1, 
 					    const fmpz_poly_t poly2, const ulong bits1_in1, const ulong bits2_in1)
 {
@@ -9542,156 +9686,167 @@ void fmpz_poly_gcd_modular(fmpz_poly_t H, const fmpz_poly_t poly1,
    }
 #endif
 
-   zmod_poly_t a, b, h;
+   /*
+      We compute the gcd modulo a batch of primes at a time, keeping only the 
+      images of least degree, and reconstruct from all the images we have 
+      with a single product tree CRT after each batch. The first batch is 
+      just large enough for the modulus to exceed bits_small, and after that 
+      we double the number of primes each time until the result stabilises 
+      and divides A and B, or the modulus exceeds the bound.
+   */
    
-   int first = 1;
-
-   unsigned long n = B->length;
-
-   unsigned long modsize = FLINT_MAX(A->limbs, B->limbs);
-   fmpz_t modulus = fmpz_init(modsize);
-   modulus[0] = 0L;
+   unsigned long n = B->length; // images of degree greater than n are discarded
+   unsigned long num = 0; // number of images we are keeping
+   unsigned long batch = bits_small/(pbits - 1) + 1;
+   unsigned long alloc = batch;
+   unsigned long * primes = (unsigned long *) flint_heap_alloc(alloc);
+   zmod_poly_p h = (zmod_poly_p) flint_heap_alloc_bytes(alloc*sizeof(zmod_poly_struct));
+   int stable;
+   long j;
 
-   fmpz_poly_t Q;
+   fmpz_poly_t Q, H2, P;
    fmpz_poly_init(Q);
+   fmpz_poly_init(H2); // reconstruction from the previous batch
+   fmpz_poly_init(P);
       
    for (;;)
    {
-      if (!first)
+      if (num + batch > alloc)
       {
-         zmod_poly_clear(a);
-         zmod_poly_clear(b);
-         zmod_poly_clear(h); 
-      } else first = 0;
-      do { p = z_nextprime(p, 0); }
-      while (!fmpz_mod_ui(g, p)); 
-      zmod_poly_init(a, p);
-      zmod_poly_init(b, p);
-      zmod_poly_init(h, p);
+         alloc = num + batch;
+         primes = (unsigned long *) flint_heap_realloc(primes, alloc);
+         h = (zmod_poly_p) flint_heap_realloc_bytes(h, alloc*sizeof(zmod_poly_struct));
+      }
+
+      unsigned long * bp = primes + num;
+      zmod_poly_p bh = h + num;
+      zmod_poly_p a = (zmod_poly_p) flint_heap_alloc_bytes(batch*sizeof(zmod_poly_struct));
+      zmod_poly_p b = (zmod_poly_p) flint_heap_alloc_bytes(batch*sizeof(zmod_poly_struct));
+
+      for (j = 0; j < batch; j++)
+      {
+         do { p = z_nextprime(p, 0); }
+         while (!fmpz_mod_ui(g, p)); 
+         bp[j] = p;
+         zmod_poly_init(a + j, p);
+         zmod_poly_init(b + j, p);
+         zmod_poly_init(bh + j, p);
+      }
 		
-      if (bits1 + 1 < pbits) fmpz_poly_to_zmod_poly_no_red(a, A);
-      else fmpz_poly_to_zmod_poly(a, A);
-      if (bits2 + 1 < pbits) fmpz_poly_to_zmod_poly_no_red(b, B);
-      else fmpz_poly_to_zmod_poly(b, B);
+      __fmpz_poly_multi_mod_ui2(a, b, A, B, bp, batch);
       
-      zmod_poly_gcd(h, a, b);
+      // the images are independent and, when built with OpenMP, each 
+      // thread has its own stack memory manager (see THREAD in flint.h)
+#pragma omp parallel for
+      for (j = 0; j < batch; j++)
+      {
+         zmod_poly_gcd(bh + j, a + j, b + j);
       
-      if (h->length == 1) // gcd is 1
+         if (g_pm1) zmod_poly_make_monic(bh + j, bh + j);
+         else
+         {
+            unsigned long h_inv = z_invert(bh[j].coeffs[bh[j].length-1], bh[j].p);
+            unsigned long g_mod = fmpz_mod_ui(g, bh[j].p);
+            h_inv = z_mulmod2_precomp(h_inv, g_mod, bh[j].p, bh[j].p_inv);
+            zmod_poly_scalar_mul(bh + j, bh + j, h_inv);
+         }
+      }
+
+      for (j = 0; j < batch; j++)
       {
+         zmod_poly_clear(a + j);
+         zmod_poly_clear(b + j);
+      }
+      flint_heap_free(a);
+      flint_heap_free(b);
+
+      // keep only the images of least degree
+      unsigned long deg = n;
+      for (j = 0; j < batch; j++)
+         if (bh[j].length - 1 < deg) deg = bh[j].length - 1;
+
+      if (deg == 0) // gcd is 1
+      {
+         for (j = 0; j < num + batch; j++)
+            zmod_poly_clear(h + j);
+         num = 0;
+         
          fmpz_poly_set_coeff_ui(H, 0, 1L);
          H->length = 1;
-			break; 
+         break;
       }
-      
-      if (h->length - 1 > n) // discard
-         continue;      
-      
-      if (g_pm1) zmod_poly_make_monic(h, h);
-      else
+
+      if (deg < n) // all previous images were bad
       {
-         unsigned long h_inv = z_invert(h->coeffs[h->length-1], h->p);
-         unsigned long g_mod = fmpz_mod_ui(g, h->p);
-         h_inv = z_mulmod2_precomp(h_inv, g_mod, h->p, h->p_inv);
-         zmod_poly_scalar_mul(h, h, h_inv);
+         for (j = 0; j < num; j++)
+            zmod_poly_clear(h + j);
+         num = 0;
+         n = deg;
+         fmpz_poly_zero(H2);
       }
-      
-      if (h->length - 1 < n)
+
+      for (j = 0; j < batch; j++)
       {
-         zmod_poly_to_fmpz_poly(H, h);
-         
-         if (g_pm1)
+         if (bh[j].length - 1 == n)
          {
-            if (fmpz_poly_divides_modular(Q, A, H, 0) && fmpz_poly_divides_modular(Q, B, H, 0)) 
-				{
-				   break;
-				}
+            primes[num] = bp[j];
+            h[num++] = bh[j];
          } else
-         {
-            /*
-				   Bound is easily derived from Thm 5.3 and Cor 5.4 of 
-				   http://compalg.inf.elte.hu/~tony/Informatikai-Konyvtar/03-Algorithms%20of%20Informatics%201,%202,%203/CompAlg29May.pdf
-					The + 1 is to allow for signed coefficients after Chinese Remaindering
-				*/
-				bound = h->length + FLINT_MIN(nb1, nb2) + gbits + 1;
-            if (pbits > bound)
-            { 
-               fmpz_t hc = fmpz_init(H->limbs);
-               fmpz_poly_content(hc, H);
-               fmpz_poly_scalar_div_fmpz(H, H, hc);
-               fmpz_clear(hc); // release hc
-               break;
-            }
-
-				if (pbits >= bits_small)
-				{
-               fmpz_t hc = fmpz_init(H->limbs);
-               fmpz_poly_content(hc, H);
-               fmpz_poly_scalar_div_fmpz(H, H, hc);
-               if (fmpz_poly_divides_modular(Q, A, H, 0) && fmpz_poly_divides_modular(Q, B, H, 0)) 
-					{
-						fmpz_clear(hc); // release hc
-						break;
-					}
-					fmpz_poly_scalar_mul_fmpz(H, H, hc);
-					fmpz_clear(hc); // release hc
-				}
-         }
-
-         fmpz_set_ui(modulus, p);
-         n = h->length - 1;
-         continue;
+            zmod_poly_clear(bh + j);
       }
+
+      __fmpz_poly_multi_CRT_ui(H, h, primes, num);
       
-      fmpz_t newmod = fmpz_init(modulus[0] + 1);
+      // lower bound for the number of bits of the modulus
+      unsigned long modbits = num*(pbits - 1);
+      stable = fmpz_poly_equal(H, H2);
       
       if (g_pm1)
       {
-         if ((fmpz_poly_CRT(H, H, h, newmod, modulus)) || (fmpz_bits(newmod) > bits_small))
-			{
-				if (fmpz_poly_divides_modular(Q, A, H, 0) && fmpz_poly_divides_modular(Q, B, H, 0)) 
-            {
-               fmpz_clear(newmod); // release newmod
-               break;
-            }
-			}
+         if ((stable || (modbits > bits_small)) 
+            && fmpz_poly_divides_modular(Q, A, H, 0) && fmpz_poly_divides_modular(Q, B, H, 0)) 
+            break;
       } else
       {
-         if (fmpz_poly_CRT(H, H, h, newmod, modulus) || (fmpz_bits(newmod) > bound) || (fmpz_bits(newmod) >= bits_small))
-         { 
+         /*
+            Bound is easily derived from Thm 5.3 and Cor 5.4 of 
+            http://compalg.inf.elte.hu/~tony/Informatikai-Konyvtar/03-Algorithms%20of%20Informatics%201,%202,%203/CompAlg29May.pdf
+            The + 1 is to allow for signed coefficients after Chinese Remaindering
+         */
+         bound = n + 1 + FLINT_MIN(nb1, nb2) + gbits + 1;
+         
+         if (stable || (modbits > bound) || (modbits >= bits_small))
+         {
             fmpz_t hc = fmpz_init(H->limbs);
             fmpz_poly_content(hc, H);
-            fmpz_poly_scalar_div_fmpz(H, H, hc);
-            if ((fmpz_bits(newmod) > bound) || (fmpz_poly_divides_modular(Q, A, H, 0) && fmpz_poly_divides_modular(Q, B, H, 0))) 
+            fmpz_poly_scalar_div_fmpz(P, H, hc);
+            fmpz_clear(hc); // release hc
+            
+            if ((modbits > bound) || (fmpz_poly_divides_modular(Q, A, P, 0) && fmpz_poly_divides_modular(Q, B, P, 0))) 
             {
-               fmpz_clear(newmod); // release newmod
-               fmpz_clear(hc); // release hc
+               fmpz_poly_swap(H, P);
                break;
             }
-				fmpz_poly_scalar_mul_fmpz(H, H, hc);
-				fmpz_clear(hc);
          }
       }
       
-      if (newmod[0] >= modsize) 
-      {
-         modulus = fmpz_realloc(modulus, (modsize+8));
-         modsize += 8;
-      }
-      
-      fmpz_set(modulus, newmod);
-      fmpz_clear(newmod); // release newmod
+      fmpz_poly_swap(H, H2);
+      batch = num; // double the number of primes
    }
+   
+   for (j = 0; j < num; j++)
+      zmod_poly_clear(h + j);
+   flint_heap_free(h);
+   flint_heap_free(primes);
    fmpz_clear(g); // release g
-   zmod_poly_clear(a);
-   zmod_poly_clear(b);
-   zmod_poly_clear(h); 
         
    fmpz_poly_scalar_mul_fmpz(H, H, d);
 
    fmpz_poly_clear(A);
    fmpz_poly_clear(B);
    fmpz_poly_clear(Q);
-   fmpz_clear(modulus);
+   fmpz_poly_clear(H2);
+   fmpz_poly_clear(P);
    fmpz_clear(d); //release d
 }
 
@@ -10059,97 +10214,119 @@ void fmpz_poly_invmod_modular(fmpz_t d, fmpz_poly_t H, fmpz_poly_t poly1, fmpz_p
    fmpz_poly_init(quot);
    fmpz_poly_init(rem);
    
+   /*
+      We compute r*A^-1 mod B modulo a batch of primes at a time, where r is 
+      the resultant, skipping primes for which it is zero, and reconstruct 
+      from all the images with a single product tree CRT after each batch. 
+      We double the number of primes each time until the result stabilises 
+      and its primitive part is an inverse of A up to a constant.
+   */
+
    unsigned long p = (1L<<(FLINT_BITS-2));
+   unsigned long num = 0; // number of good images
+   unsigned long batch = 2;
+   unsigned long alloc = batch;
+   unsigned long * primes = (unsigned long *) flint_heap_alloc(alloc);
+   zmod_poly_p h = (zmod_poly_p) flint_heap_alloc_bytes(alloc*sizeof(zmod_poly_struct));
+   long j;
    
-   zmod_poly_t a, b, h;
-   
-   int first = 1;
-
-   unsigned long n = B->length;
+   fmpz_poly_t H2, P;
+   fmpz_poly_init(H2); // reconstruction from the previous batch
+   fmpz_poly_init(P);
 
-   unsigned long modsize = FLINT_MAX(A->limbs, B->limbs);
-   fmpz_t modulus = fmpz_init(modsize);
-   modulus[0] = 0L;
-
-   fmpz_poly_t Q;
-   fmpz_poly_init(Q);
    for (;;)
    {
-      if (!first)
+      if (num + batch > alloc)
       {
-         zmod_poly_clear(a);
-         zmod_poly_clear(b);
-         zmod_poly_clear(h); 
-      } 
-      p = z_nextprime(p, 0);  
-      zmod_poly_init(a, p);
-      zmod_poly_init(b, p);
-      zmod_poly_init(h, p);
+         alloc = num + batch;
+         primes = (unsigned long *) flint_heap_realloc(primes, alloc);
+         h = (zmod_poly_p) flint_heap_realloc_bytes(h, alloc*sizeof(zmod_poly_struct));
+      }
 
-      fmpz_poly_to_zmod_poly(a, A);
-      fmpz_poly_to_zmod_poly(b, B);
-      
-      unsigned long r = zmod_poly_resultant(a, b);
+      unsigned long * bp = primes + num;
+      zmod_poly_p bh = h + num;
+      zmod_poly_p a = (zmod_poly_p) flint_heap_alloc_bytes(batch*sizeof(zmod_poly_struct));
+      zmod_poly_p b = (zmod_poly_p) flint_heap_alloc_bytes(batch*sizeof(zmod_poly_struct));
+      int * good = (int *) flint_heap_alloc_bytes(batch*sizeof(int));
 
-      if ((fmpz_mod_ui(_fmpz_poly_lead(A), p) == 0L) || (r == 0L))
+      for (j = 0; j < batch; j++)
       {
-         continue;
+         do { p = z_nextprime(p, 0); }
+         while (fmpz_mod_ui(_fmpz_poly_lead(A), p) == 0L); 
+         bp[j] = p;
+         zmod_poly_init(a + j, p);
+         zmod_poly_init(b + j, p);
+         zmod_poly_init(bh + j, p);
       }
 
-      unsigned long coprime = zmod_poly_gcd_invert(h, a, b);
-      if (!coprime) 
+      __fmpz_poly_multi_mod_ui2(a, b, A, B, bp, batch);
+      
+      // each thread has its own stack, see fmpz_poly_gcd_modular
+#pragma omp parallel for
+      for (j = 0; j < batch; j++)
       {
-         continue;
+         unsigned long r = zmod_poly_resultant(a + j, b + j);
+
+         good[j] = ((r != 0L) && zmod_poly_gcd_invert(bh + j, a + j, b + j));
+         if (good[j]) zmod_poly_scalar_mul(bh + j, bh + j, r);
       }
 
-      zmod_poly_scalar_mul(h, h, r);
+      for (j = 0; j < batch; j++)
+      {
+         zmod_poly_clear(a + j);
+         zmod_poly_clear(b + j);
+      }
+      flint_heap_free(a);
+      flint_heap_free(b);
 
-      if (first)
+      for (j = 0; j < batch; j++)
       {
-         zmod_poly_to_fmpz_poly(H, h);
-         fmpz_set_ui(modulus, p);
-         first = 0;
-         continue;
-      } 
-      fmpz_t newmod = fmpz_init(modulus[0] + 1);
+         if (good[j])
+         {
+            primes[num] = bp[j];
+            h[num++] = bh[j];
+         } else
+            zmod_poly_clear(bh + j);
+      }
+      flint_heap_free(good);
+
+      if (num == 0) continue;
+      
+      __fmpz_poly_multi_CRT_ui(H, h, primes, num);
       
-      if (fmpz_poly_CRT(H, H, h, newmod, modulus))
+      if (fmpz_poly_equal(H, H2))
       {
          fmpz_t hc = fmpz_init(H->limbs);
          fmpz_poly_content(hc, H);
-         fmpz_poly_scalar_div_fmpz(H, H, hc);
+         fmpz_poly_scalar_div_fmpz(P, H, hc);
          fmpz_clear(hc); // release hc
-         fmpz_clear(newmod); // release newmod
-         fmpz_poly_mul(prod, H, poly1);
+         fmpz_poly_mul(prod, P, poly1);
          fmpz_poly_divrem(quot, rem, prod, poly2);
          if (rem->length == 1)
          {
             fmpz_set(d, rem->coeffs);
+            fmpz_poly_swap(H, P);
             break;
          }
       }
       
-      if (newmod[0] >= modsize) 
-      {
-         modulus = fmpz_realloc(modulus, (modsize+8));
-         modsize += 8;
-      }
-      
-      fmpz_set(modulus, newmod);
-      fmpz_clear(newmod); // release newmod
+      fmpz_poly_swap(H, H2);
+      batch = num; // double the number of primes
    }
-   zmod_poly_clear(a);
-   zmod_poly_clear(b);
-   zmod_poly_clear(h); 
+
+   for (j = 0; j < num; j++)
+      zmod_poly_clear(h + j);
+   flint_heap_free(h);
+   flint_heap_free(primes);
        
    fmpz_poly_clear(quot);
    fmpz_poly_clear(rem);
    fmpz_poly_clear(prod);
+   fmpz_poly_clear(H2);
+   fmpz_poly_clear(P);
    
    fmpz_poly_clear(A);
    fmpz_poly_clear(B);
-   fmpz_poly_clear(Q);
-   fmpz_clear(modulus);
 }
 
 void fmpz_poly_xgcd_modular(fmpz_t r, fmpz_poly_t s, fmpz_poly_t t, fmpz_poly_t a, fmpz_poly_t b)
@@ -10352,58 +10529,69 @@ void fmpz_poly_resultant(fmpz_t res, fmpz_poly_t a, fmpz_poly_t b)
 
    unsigned long bound = fmpz_poly_resultant_bound(a, b)+2;
    
-   fmpz_t prod = fmpz_init(bound/FLINT_BITS + 2);
+   // pick all the primes up front, each of which has more than FLINT_BITS - 2 bits
+   unsigned long num_primes = bound/(FLINT_BITS - 2) + 1;
+   unsigned long * primes = (unsigned long *) flint_heap_alloc(num_primes);
+   unsigned long * r = (unsigned long *) flint_heap_alloc(num_primes);
    
-   fmpz_set_ui(res, 0L);
-   fmpz_set_ui(prod, 1L);
-
    unsigned long p = (1L<<(FLINT_BITS-2));
-   unsigned long t;
-
-   int first = 1;
-
-   for (;;) {
-      if (fmpz_bits(prod) > bound)
-         break;
+   unsigned long i;
+   long j;
 
+   for (i = 0; i < num_primes; )
+   {
       p = z_nextprime(p, 0);
 
-      if ((fmpz_mod_ui(_fmpz_poly_lead(a), p) == 0L) || (fmpz_mod_ui(_fmpz_poly_lead(b), p) == 0L))
-         continue;
+      if ((fmpz_mod_ui(_fmpz_poly_lead(a), p) != 0L) && (fmpz_mod_ui(_fmpz_poly_lead(b), p) != 0L))
+         primes[i++] = p;
+   }
 
-      zmod_poly_t A, B;
-      zmod_poly_init(A, p);
-      zmod_poly_init(B, p);
+   // compute the resultant modulo each prime, reducing a batch at a time
+   unsigned long batch = FMPZ_POLY_MULTI_MOD_BATCH/(a->length + b->length) + 1;
+   zmod_poly_p A = (zmod_poly_p) flint_heap_alloc_bytes(FLINT_MIN(batch, num_primes)*sizeof(zmod_poly_struct));
+   zmod_poly_p B = (zmod_poly_p) flint_heap_alloc_bytes(FLINT_MIN(batch, num_primes)*sizeof(zmod_poly_struct));
 
-      fmpz_poly_to_zmod_poly(A, a);
-      fmpz_poly_to_zmod_poly(B, b);
-
-      t = zmod_poly_resultant(A, B);
+   for (i = 0; i < num_primes; i += batch)
+   {
+      long num = FLINT_MIN(batch, num_primes - i);
       
-      if (first)
-      {
-         fmpz_set_ui(prod, p);
-         fmpz_set_ui(res, t);
-         first = 0;
-      } else
+      for (j = 0; j < num; j++)
       {
-         unsigned long c = fmpz_mod_ui(prod, p);
-         c = z_invert(c, p);
-         fmpz_CRT_ui2_precomp(res, res, prod, t, p, c, A->p_inv);
-      
-         fmpz_mul_ui(prod, prod, p);
+         zmod_poly_init(A + j, primes[i + j]);
+         zmod_poly_init(B + j, primes[i + j]);
       }
 
-      zmod_poly_clear(A);
-      zmod_poly_clear(B);
+      __fmpz_poly_multi_mod_ui2(A, B, a, b, primes + i, num);
+
+      // each thread has its own stack, see fmpz_poly_gcd_modular
+#pragma omp parallel for
+      for (j = 0; j < num; j++)
+         r[i + j] = zmod_poly_resultant(A + j, B + j);
+
+      for (j = 0; j < num; j++)
+      {
+         zmod_poly_clear(A + j);
+         zmod_poly_clear(B + j);
+      }
    }
 
-   fmpz_t proddiv2 = fmpz_init(prod[0]);
-   fmpz_div_2exp(proddiv2, prod, 1);
-   if (fmpz_cmpabs(res, proddiv2) > 0L) 
-      fmpz_sub(res, res, prod);
-   fmpz_clear(proddiv2);
-   fmpz_clear(prod);
+   flint_heap_free(B);
+   flint_heap_free(A);
+
+   // reconstruct with a single product tree CRT
+   fmpz_comb_t comb;
+   fmpz_comb_init(comb, primes, num_primes);
+   fmpz_t ** comb_temp = fmpz_comb_temp_init(comb);
+   fmpz_t temp = fmpz_init(num_primes + 1);
+   
+   fmpz_multi_CRT_ui(temp, r, comb, comb_temp);
+   fmpz_set(res, temp);
+   
+   fmpz_clear(temp);
+   fmpz_comb_temp_clear(comb_temp, comb);
+   fmpz_comb_clear(comb);
+   flint_heap_free(r);
+   flint_heap_free(primes);
 }
 
 /****************************************************************************
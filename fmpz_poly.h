@@ -333,6 +333,26 @@ int fmpz_poly_CRT(fmpz_poly_t res, fmpz_poly_t fpol, zmod_poly_t zpol, fmpz_t ne
 
 int fmpz_poly_CRT_unsigned(fmpz_poly_t res, fmpz_poly_t fpol, zmod_poly_t zpol, fmpz_t newmod, fmpz_t oldmod);
 
+/*
+   Set out[j] to the reduction of poly modulo the j-th prime of the comb, for 
+   all the primes of the comb. The zmod_polys must be initialised with the 
+   corresponding moduli. Coefficients of more than a limb are reduced with 
+   the comb rather than one prime at a time.
+*/
+
+void fmpz_poly_multi_mod_ui(zmod_poly_p out, const fmpz_poly_t poly, 
+                            fmpz_comb_t comb, fmpz_t ** comb_temp);
+
+/*
+   Set res to the polynomial whose coefficients are congruent to those of 
+   in[j] modulo the j-th prime of the comb, normalised to [-P/2, P/2] where 
+   P is the product of the primes. This is a single product tree CRT per 
+   coefficient, rather than one fmpz_poly_CRT per prime.
+*/
+
+void fmpz_poly_multi_CRT_ui(fmpz_poly_t res, zmod_poly_p in, 
+                            fmpz_comb_t comb, fmpz_t ** comb_temp);
+
 /*============================================================================
   
     Functions in _fmpz_poly_* layer
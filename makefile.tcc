@@ -12,8 +12,8 @@ SOURCES = zn_poly/src/zn_mod.c zn_poly/src/misc.o zn_poly/src/mul_ks.o \
           zn_poly/src/pmfvec_fft.o zn_poly/src/tuning.o zn_poly/src/mul_fft.o \
           zn_poly/src/mul_fft_dft.o zn_poly/src/array.o zn_poly/src/invert.o \
           fmpz.c fmpz_poly.c long_extras.c memory-manager.c mpn_extras.c \
-          mpz_extras.c mpz_mat.c mpz_poly.c mpz_poly-tuning.c zmod_mat.c \
-          zmod_poly.c ZmodF.c ZmodF_mul.c ZmodF_mul-tuning.c ZmodF_poly.c \
+          mpz_extras.c mpz_mat.c mpz_poly.c flint-tuning.c zmod_mat.c \
+          zmod_poly.c ZmodF.c ZmodF_mul.c ZmodF_poly.c \
           F_mpz.c
 
 TESTS = F_mpz-test.exe mpn_extras-test.exe long_extras-test.exe \
@@ -167,6 +167,74 @@ int test_F_mpn_splitcombine_bits()
     return result;
 }
 
+int test_F_mpn_bit_pack()
+{
+   mp_limb_t * fields, * fields2, * array, * array2;
+   int result = 1;
+   
+   unsigned long count;
+   for (count = 0; (count < 20000) && (result == 1); count++)
+   {
+      unsigned long bits = randint(FLINT_BITS) + 1;
+      unsigned long k = randint(FLINT_BITS);
+      unsigned long n = randint(count % 10 ? 100 : 2000);
+      unsigned long limbs = (k + n*bits + FLINT_BITS - 1)/FLINT_BITS + 1;
+      unsigned long i, j, written;
+      
+      fields = (mp_limb_t *) malloc(sizeof(mp_limb_t)*(n + 1));
+      fields2 = (mp_limb_t *) malloc(sizeof(mp_limb_t)*(n + 1));
+      array = (mp_limb_t *) malloc(sizeof(mp_limb_t)*limbs);
+      array2 = (mp_limb_t *) malloc(sizeof(mp_limb_t)*limbs);
+      
+      mpn_random2(fields, n + 1);
+      if (bits < FLINT_BITS)
+         for (i = 0; i < n; i++)
+            fields[i] &= ((1UL << bits) - 1);
+      
+      mpn_random2(array, limbs);
+      F_mpn_copy(array2, array, limbs);
+      
+      written = F_mpn_bit_pack(array, fields, n, bits, k);
+      
+      if (n == 0) result = (written == 0);
+      else result = (written == limbs - 1);
+
+      // compare with packing one bit at a time
+      for (i = 0; (i < n*bits) && result; i++)
+      {
+         j = k + i;
+         result = (((array[j/FLINT_BITS] >> (j%FLINT_BITS)) & 1UL) == 
+                   ((fields[i/bits] >> (i%bits)) & 1UL));
+      }
+      
+      // low k bits are preserved, high bits of the last limb are zero
+      if (n && result)
+      {
+         if (k) result = ((array[0] << (FLINT_BITS - k)) == (array2[0] << (FLINT_BITS - k)));
+         j = (k + n*bits) % FLINT_BITS;
+         if (j && result) result = ((array[limbs - 2] >> j) == 0L);
+         if (result) result = (array[limbs - 1] == array2[limbs - 1]);
+      }
+      
+      if (result)
+      {
+         fields2[n] = fields[n];
+         F_mpn_bit_unpack(fields2, array, n, bits, k);
+         for (i = 0; (i <= n) && result; i++)
+            result = (fields[i] == fields2[i]);
+      }
+      
+      if (!result) printf("Error: bits = %ld, k = %ld, n = %ld\n", bits, k, n);
+      
+      free(array2);
+      free(array);
+      free(fields2);
+      free(fields);
+   }
+   
+   return result;
+}
+
 int test_F_mpn_mul_precache()
 {
    mp_limb_t * int1, * int2, * product, * product2;
@@ -340,6 +408,99 @@ int test_F_mpn_mul()
    return result;
 }
 
+/*
+   Tests __F_mpn_mul directly with a range of transform depths and 
+   unbalanced operands, including operands which are too short for 
+   F_mpn_mul to use the FFT. Then tests F_mpn_mul on operands large
+   enough to use the four step convolution.
+*/
+
+int test___F_mpn_mul()
+{
+   mp_limb_t * int1, * int2, * product, * product2;
+   mp_limb_t msl;
+   int result = 1;
+   
+   unsigned long count;
+   for (count = 0; (count < 3000) && (result == 1); count++)
+   {
+      unsigned long limbs1 = randint(4000)+1;
+      unsigned long limbs2 = randint(randint(2) ? limbs1 : 100)+1;
+      if (randint(2)) 
+      {
+         unsigned long t = limbs1;
+         limbs1 = limbs2;
+         limbs2 = t;
+      }
+      unsigned long log_length = randint(11) + 2;
+
+#if DEBUG
+      printf("%ld, %ld, %ld\n", limbs1, limbs2, log_length);
+#endif
+      
+      int1 = (mp_limb_t *) malloc(sizeof(mp_limb_t)*limbs1);
+      int2 = (mp_limb_t *) malloc(sizeof(mp_limb_t)*limbs2);
+      product = (mp_limb_t *) malloc(sizeof(mp_limb_t)*(limbs1+limbs2));
+      product2 = (mp_limb_t *) malloc(sizeof(mp_limb_t)*(limbs1+limbs2));
+      
+      mpn_random2(int1, limbs1);
+      mpn_random2(int2, limbs2);
+      
+      msl = __F_mpn_mul(product, int1, limbs1, int2, limbs2, log_length);
+      if (limbs1 >= limbs2) mpn_mul(product2, int1, limbs1, int2, limbs2);
+      else mpn_mul(product2, int2, limbs2, int1, limbs1);
+      
+      unsigned long j;
+      for (j = 0; j < limbs1+limbs2 - (msl == 0); j++)
+      {
+         if (product[j] != product2[j]) result = 0;
+      }
+      
+#if DEBUG2
+      if (!result) printf("Error: limbs1 = %ld, limbs2 = %ld, log_length = %ld\n", limbs1, limbs2, log_length);
+#endif
+      
+      free(product2);
+      free(product);
+      free(int2);
+      free(int1);
+   }
+   
+   // operands large enough for the four step convolution to be used
+   for (count = 0; (count < 2) && (result == 1); count++)
+   {
+      unsigned long limbs1 = randint(200000) + 600000;
+      unsigned long limbs2 = count ? limbs1 : randint(200000) + 600000;
+      
+      int1 = (mp_limb_t *) malloc(sizeof(mp_limb_t)*limbs1);
+      int2 = (mp_limb_t *) malloc(sizeof(mp_limb_t)*limbs2);
+      product = (mp_limb_t *) malloc(sizeof(mp_limb_t)*(limbs1+limbs2));
+      product2 = (mp_limb_t *) malloc(sizeof(mp_limb_t)*(limbs1+limbs2));
+      
+      mpn_random2(int1, limbs1);
+      if (count) F_mpn_copy(int2, int1, limbs1);
+      else mpn_random2(int2, limbs2);
+      
+      if (count) msl = F_mpn_mul(product, int1, limbs1, int1, limbs1);
+      else msl = F_mpn_mul(product, int1, limbs1, int2, limbs2);
+      if (limbs1 >= limbs2) mpn_mul(product2, int1, limbs1, int2, limbs2);
+      else mpn_mul(product2, int2, limbs2, int1, limbs1);
+      
+      unsigned long j;
+      for (j = 0; j < limbs1+limbs2 - (msl == 0); j++)
+      {
+         if (product[j] != product2[j]) result = 0;
+      }
+      
+      free(product2);
+      free(product);
+      free(int2);
+      free(int1);
+   }
+   
+   return result;
+}
+
 int test_F_mpn_mul_trunc()
 {
    mp_limb_t * int1, * int2, * product, * product2;
@@ -403,7 +564,9 @@ void F_mpn_test_all()
    int success, all_success = 1;
 
    RUN_TEST(F_mpn_splitcombine_bits);
+   RUN_TEST(F_mpn_bit_pack);
    RUN_TEST(F_mpn_mul);
+   RUN_TEST(__F_mpn_mul);
    RUN_TEST(F_mpn_mul_trunc);
    RUN_TEST(F_mpn_mul_precache);
    RUN_TEST(F_mpn_mul_precache_trunc);
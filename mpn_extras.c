@@ -33,6 +33,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 #include "flint.h"
 #include "longlong_wrapper.h"
 #include "longlong.h"
@@ -43,6 +47,10 @@
 #include "ZmodF_mul.h"
 #include "F_mpn_mul-tuning.h"
 
+#if FLINT_HAVE_AVX2_DISPATCH
+#include <immintrin.h>
+#endif
+
 #define DEBUG2 1
 
 /*=======================================================================================
@@ -560,10 +568,16 @@ mp_limb_t __F_mpn_mul(mp_limb_t * res, const mp_limb_t * data1, const unsigned l
    unsigned log_length2 = 1;
 
    unsigned long bits;
-      
+   
+   /* 
+      Split the inputs so that the output only just fits in the transform, 
+      i.e. length1 + length2 - 1 <= 2^log_length. The transforms are truncated,
+      so unbalanced inputs get smaller coefficients rather than a transform 
+      which is half unused.
+   */
    do
    {
-      bits = (((limbs1 << FLINT_LG_BITS_PER_LIMB)-1) >> (log_length-1)) + 1;
+      bits = (((coeff_limbs << FLINT_LG_BITS_PER_LIMB)-1) >> log_length) + 1;
       output_bits = 2*bits + log_length2;
       output_bits = (((output_bits - 1) >> (log_length-1)) + 1) << (log_length-1);
    
@@ -571,40 +585,62 @@ mp_limb_t __F_mpn_mul(mp_limb_t * res, const mp_limb_t * data1, const unsigned l
       length1 = ((limbs1 << FLINT_LG_BITS_PER_LIMB)-1)/bits + 1;
       length2 = ((limbs2 << FLINT_LG_BITS_PER_LIMB)-1)/bits + 1;
       log_length2++;
-   } while ((length2 > (1L<<(log_length2-1))) || (length1 > (1L<<(log_length-1))));
+   } while ((FLINT_MIN(length1, length2) > (1L<<(log_length2-1))) || (length1 + length2 - 1 > (1L<<log_length)));
    
    n = (output_bits-1)/FLINT_BITS+1;
 #if DEBUG
    printf("%ld, %ld, %ld, %ld, %ld, %ld, %ld\n", bits, length1, length2, output_bits, coeff_limbs, n, log_length);
 #endif   
    ZmodF_poly_t poly1;
-   ZmodF_poly_init(poly1, log_length, n, 1);
+   
+   // for huge operands use the four step convolution, to save passes over
+   // memory, and give it a scratch buffer for each thread
+   int four_step = ((1UL << log_length)*(n + 1) > ZMODFPOLY_FOUR_STEP_THRESHOLD);
+   ulong scratch = four_step ? ZmodF_poly_four_step_threads() : 1;
+   
+   ZmodF_poly_init(poly1, log_length, n, scratch);
    F_mpn_FFT_split_bits(poly1, data1, limbs1, bits, n);
    
-   ulong length = length1 + length2 - 1;
-   ulong size = 1UL << log_length;
-   if (length > size)
-   length = size;
+   if (four_step)
+   {
+      if ((data1 == data2) && (limbs1 == limbs2))
+         ZmodF_poly_convolution_four_step(poly1, poly1);
+      else
+      {
+         ZmodF_poly_t poly2;
+         ZmodF_poly_init(poly2, log_length, n, scratch);
+         F_mpn_FFT_split_bits(poly2, data2, limbs2, bits, n);
+         
+         ZmodF_poly_convolution_four_step(poly1, poly2);
+         ZmodF_poly_clear(poly2);
+      }
+   } else
+   {
+      ulong length = length1 + length2 - 1;
+      ulong size = 1UL << log_length;
+      if (length > size)
+         length = size;
 
-   ZmodF_poly_FFT(poly1, length);
+      ZmodF_poly_FFT(poly1, length);
    
-	if ((data1 == data2) && (limbs1 == limbs2))
-   {
-      ZmodF_poly_pointwise_mul(poly1, poly1, poly1);
-	} else
-	{
-		ZmodF_poly_t poly2;
-      ZmodF_poly_init(poly2, log_length, n, 1);
-      F_mpn_FFT_split_bits(poly2, data2, limbs2, bits, n);
+      if ((data1 == data2) && (limbs1 == limbs2))
+      {
+         ZmodF_poly_pointwise_mul(poly1, poly1, poly1);
+      } else
+      {
+         ZmodF_poly_t poly2;
+         ZmodF_poly_init(poly2, log_length, n, 1);
+         F_mpn_FFT_split_bits(poly2, data2, limbs2, bits, n);
 
-      ZmodF_poly_FFT(poly2, length);
+         ZmodF_poly_FFT(poly2, length);
       
-      ZmodF_poly_pointwise_mul(poly1, poly1, poly2);
-	   ZmodF_poly_clear(poly2);
-	}	
-		
-   ZmodF_poly_IFFT(poly1);
-   ZmodF_poly_rescale(poly1);   
+         ZmodF_poly_pointwise_mul(poly1, poly1, poly2);
+         ZmodF_poly_clear(poly2);
+      }
+      
+      ZmodF_poly_IFFT(poly1);
+      ZmodF_poly_rescale(poly1);
+   }
    
    ZmodF_poly_normalise(poly1);
    
@@ -1131,3 +1167,424 @@ mp_limb_t __F_mpn_mul_middle_precache(mp_limb_t * res, mp_limb_t * data1, unsign
 
 
 
+
+/*============================================================================
+
+   Bit packing
+
+   A vector of n fields of b bits (1 <= b <= FLINT_BITS) is stored in an mpn
+   with field i occupying bits k + i*b, ..., k + (i + 1)*b - 1, where 
+   0 <= k < FLINT_BITS is a leading offset.
+
+=============================================================================*/
+
+/*
+   State for packing a stream of fields into an mpn. "acc" holds the 
+   "filled" bits of the limb currently being assembled, which is written 
+   to "res" once it is full.
+*/
+
+typedef struct
+{
+   mp_limb_t * res;
+   mp_limb_t acc;
+   ulong filled;
+} F_mpn_packer_s;
+
+static inline
+void F_mpn_packer_init(F_mpn_packer_s * p, mp_limb_t * res, ulong k)
+{
+   p->res = res;
+   p->acc = k ? (res[0] & ((1UL << k) - 1)) : 0L;
+   p->filled = k;
+}
+
+static inline
+void F_mpn_packer_put(F_mpn_packer_s * p, const ulong * op, ulong n, ulong bits)
+{
+   mp_limb_t * res = p->res;
+   mp_limb_t acc = p->acc;
+   ulong filled = p->filled;
+   ulong i, x;
+
+   for (i = 0; i < n; i++)
+   {
+      x = op[i];
+      acc |= (x << filled);
+      filled += bits;
+      if (filled >= FLINT_BITS)
+      {
+         *res++ = acc;
+         filled -= FLINT_BITS;
+         // the top bits of x which did not fit, if any
+         acc = filled ? (x >> (bits - filled)) : 0L;
+      }
+   }
+
+   p->res = res;
+   p->acc = acc;
+   p->filled = filled;
+}
+
+static inline
+void F_mpn_packer_finish(F_mpn_packer_s * p)
+{
+   if (p->filled) *p->res++ = p->acc;
+}
+
+static
+void _F_mpn_bit_unpack_generic(ulong * res, const mp_limb_t * op, ulong n, 
+                                                         ulong bits, ulong k)
+{
+   ulong i, x;
+   
+   if (n == 0) return;
+
+   if (bits == FLINT_BITS)
+   {
+      if (k == 0) F_mpn_copy(res, op, n);
+      else 
+         for (i = 0; i < n; i++)
+            res[i] = (op[i] >> k) | (op[i + 1] << (FLINT_BITS - k));
+
+      return;
+   }
+
+   const ulong mask = (1UL << bits) - 1;
+   mp_limb_t cur = (*op) >> k; // the unread bits of the current limb
+   ulong avail = FLINT_BITS - k; // the number of unread bits of the current limb
+   
+   for (i = 0; i < n; i++)
+   {
+      if (avail >= bits)
+      {
+         x = cur;
+         cur >>= bits;
+         avail -= bits;
+      } else // the field straddles a limb boundary, read the next limb
+      {
+         mp_limb_t next = *++op;
+         x = cur | (next << avail);
+         cur = next >> (bits - avail);
+         avail += FLINT_BITS - bits;
+      }
+
+      res[i] = x & mask;
+   }
+}
+
+#if FLINT_HAVE_AVX2_DISPATCH
+
+/*
+   Fields are packed by merging adjacent pairs in vector registers, doubling
+   the field width until it exceeds half a limb, in blocks of this many 
+   fields, which must be a multiple of 2^6.
+*/
+#define F_MPN_PACK_BLOCK 256
+
+FLINT_TARGET_AVX2
+static
+void _F_mpn_bit_pack_avx2(F_mpn_packer_s * p, const ulong * op, ulong n, ulong bits)
+{
+   ulong t[F_MPN_PACK_BLOCK/2];
+   ulong i, j, m, w;
+   const ulong * src;
+
+   for (i = 0; i + F_MPN_PACK_BLOCK <= n; i += F_MPN_PACK_BLOCK)
+   {
+      src = op + i;
+      m = F_MPN_PACK_BLOCK;
+      
+      for (w = bits; 2*w <= FLINT_BITS; w *= 2, m /= 2, src = t)
+      {
+         __m128i cnt = _mm_cvtsi64_si128(w);
+
+         for (j = 0; j < m; j += 8)
+         {
+            __m256i a = _mm256_loadu_si256((const __m256i *) (src + j));
+            __m256i b = _mm256_loadu_si256((const __m256i *) (src + j + 4));
+            // lo = x0, x4, x2, x6 and hi = x1, x5, x3, x7
+            __m256i lo = _mm256_unpacklo_epi64(a, b);
+            __m256i hi = _mm256_unpackhi_epi64(a, b);
+            __m256i v = _mm256_or_si256(lo, _mm256_sll_epi64(hi, cnt));
+            _mm256_storeu_si256((__m256i *) (t + j/2), _mm256_permute4x64_epi64(v, 0xD8));
+         }
+      }
+
+      F_mpn_packer_put(p, t, m, w);
+   }
+
+   F_mpn_packer_put(p, op + i, n - i, bits);
+}
+
+/*
+   Fields are unpacked 8 at a time, each half of a group of 8 being gathered
+   from a single 16 byte load with a byte shuffle. This requires the bits of 
+   each half to fit into 16 bytes.
+*/
+static inline
+int _F_mpn_bit_unpack_avx2_fits(ulong bits, ulong k)
+{
+   return (bits <= 32 && (k & 7) + 4*bits <= 128 
+                      && ((k + 4*bits) & 7) + 4*bits <= 128);
+}
+
+FLINT_TARGET_AVX2
+static
+void _F_mpn_bit_unpack_avx2(ulong * res, const mp_limb_t * op, ulong n, 
+                                                         ulong bits, ulong k)
+{
+   const unsigned char * bytes = (const unsigned char *) op;
+   // the number of bytes which may be read
+   const ulong total = ((k + n*bits - 1)/FLINT_BITS + 1)*sizeof(mp_limb_t);
+   
+   unsigned char ctrl[2][32];
+   long long shift[2][4];
+   ulong off[2];
+   ulong h, i, j, t, pos;
+
+   for (h = 0; h < 2; h++)
+   {
+      pos = k + 4*h*bits; // first bit of fields 4h, ..., 4h + 3 of a group
+      off[h] = pos/8;
+      pos &= 7;
+      
+      for (j = 0; j < 4; j++)
+      {
+         ulong b = pos + j*bits;
+         shift[h][j] = (b & 7);
+         for (t = 0; t < 8; t++)
+            ctrl[h][8*j + t] = (b/8 + t < 16) ? (b/8 + t) : 0x80;
+      }
+   }
+
+   const __m256i c0 = _mm256_loadu_si256((const __m256i *) ctrl[0]);
+   const __m256i c1 = _mm256_loadu_si256((const __m256i *) ctrl[1]);
+   const __m256i s0 = _mm256_loadu_si256((const __m256i *) shift[0]);
+   const __m256i s1 = _mm256_loadu_si256((const __m256i *) shift[1]);
+   const __m256i mask = _mm256_set1_epi64x((1L << bits) - 1);
+
+   // a group of 8 fields is exactly bits bytes long
+   for (i = 0; i + 8 <= n && (i/8)*bits + off[1] + 16 <= total; i += 8)
+   {
+      const unsigned char * base = bytes + (i/8)*bits;
+      __m256i v0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) (base + off[0])));
+      __m256i v1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) (base + off[1])));
+      
+      v0 = _mm256_and_si256(_mm256_srlv_epi64(_mm256_shuffle_epi8(v0, c0), s0), mask);
+      v1 = _mm256_and_si256(_mm256_srlv_epi64(_mm256_shuffle_epi8(v1, c1), s1), mask);
+      
+      _mm256_storeu_si256((__m256i *) (res + i), v0);
+      _mm256_storeu_si256((__m256i *) (res + i + 4), v1);
+   }
+
+   pos = k + i*bits;
+   _F_mpn_bit_unpack_generic(res + i, op + pos/FLINT_BITS, n - i, bits, pos%FLINT_BITS);
+}
+
+#endif
+
+ulong F_mpn_bit_pack(mp_limb_t * res, const ulong * op, ulong n, ulong bits, ulong k)
+{
+   F_mpn_packer_s p;
+
+   if (n == 0) return 0L;
+
+   if (bits == FLINT_BITS && k == 0)
+   {
+      F_mpn_copy(res, op, n);
+      return n;
+   }
+
+   F_mpn_packer_init(&p, res, k);
+
+#if FLINT_HAVE_AVX2_DISPATCH
+   if (n >= F_MPN_BIT_PACK_AVX2_CUTOFF && 2*bits <= FLINT_BITS && flint_have_avx2())
+      _F_mpn_bit_pack_avx2(&p, op, n, bits);
+   else
+#endif
+      F_mpn_packer_put(&p, op, n, bits);
+
+   F_mpn_packer_finish(&p);
+
+   return p.res - res;
+}
+
+void F_mpn_bit_unpack(ulong * res, const mp_limb_t * op, ulong n, ulong bits, ulong k)
+{
+#if FLINT_HAVE_AVX2_DISPATCH
+   if (n >= F_MPN_BIT_UNPACK_AVX2_CUTOFF && _F_mpn_bit_unpack_avx2_fits(bits, k) 
+                                                          && flint_have_avx2())
+   {
+      _F_mpn_bit_unpack_avx2(res, op, n, bits, k);
+      return;
+   }
+#endif
+
+   _F_mpn_bit_unpack_generic(res, op, n, bits, k);
+}
+
+/*===========================================================================
+
+   Binary files
+
+============================================================================*/
+
+void F_mpn_byte_swap(mp_limb_t * x, ulong n)
+{
+   ulong i;
+
+   for (i = 0; i < n; i++)
+   {
+#if defined(__GNUC__) && FLINT_BITS == 64
+      x[i] = __builtin_bswap64(x[i]);
+#elif defined(__GNUC__) && FLINT_BITS == 32
+      x[i] = __builtin_bswap32(x[i]);
+#else
+      mp_limb_t t = x[i], r = 0;
+      ulong j;
+      for (j = 0; j < sizeof(mp_limb_t); j++, t >>= 8)
+         r = (r << 8) | (t & 0xFFUL);
+      x[i] = r;
+#endif
+   }
+}
+
+int F_mpn_fwrite_bin_header(const F_mpn_bin_header_t hdr, FILE * f)
+{
+   mp_limb_t buf[FLINT_BIN_HEADER_LIMBS];
+
+   buf[0] = FLINT_BIN_MAGIC;
+   buf[1] = FLINT_BIN_VERSION;
+   buf[2] = hdr->type;
+   buf[3] = FLINT_BITS;
+   buf[4] = hdr->flags;
+   buf[5] = hdr->dim1;
+   buf[6] = hdr->dim2;
+   buf[7] = hdr->limbs;
+
+   return (fwrite(buf, sizeof(mp_limb_t), FLINT_BIN_HEADER_LIMBS, f) == FLINT_BIN_HEADER_LIMBS);
+}
+
+/*
+   Parses the header in buf, byte swapping it in place if necessary
+*/
+static
+int _F_mpn_parse_bin_header(F_mpn_bin_header_t hdr, mp_limb_t * buf)
+{
+   hdr->swap = 0;
+   if (buf[0] != FLINT_BIN_MAGIC)
+   {
+      F_mpn_byte_swap(buf, FLINT_BIN_HEADER_LIMBS);
+      if (buf[0] != FLINT_BIN_MAGIC) return 0;
+      hdr->swap = 1;
+   }
+
+   if (buf[1] != FLINT_BIN_VERSION || buf[3] != FLINT_BITS) return 0;
+
+   hdr->type = buf[2];
+   hdr->flags = buf[4];
+   hdr->dim1 = buf[5];
+   hdr->dim2 = buf[6];
+   hdr->limbs = buf[7];
+
+   return 1;
+}
+
+/*
+   Returns 0 if f is seekable and fewer than limbs limbs remain in it. The
+   position of f is left unchanged.
+*/
+static
+int _F_mpn_bin_payload_fits(FILE * f, ulong limbs)
+{
+   long pos, end;
+
+   pos = ftell(f);
+   if (pos == -1L) return 1; // not seekable, e.g. a pipe, so we cannot tell
+
+   if (fseek(f, 0L, SEEK_END) != 0) return 1;
+   end = ftell(f);
+   if (fseek(f, pos, SEEK_SET) != 0 || end < pos) return 0;
+
+   return ((ulong) (end - pos)/sizeof(mp_limb_t) >= limbs);
+}
+
+int F_mpn_fread_bin_header(F_mpn_bin_header_t hdr, FILE * f)
+{
+   mp_limb_t buf[FLINT_BIN_HEADER_LIMBS];
+
+   if (fread(buf, sizeof(mp_limb_t), FLINT_BIN_HEADER_LIMBS, f) != FLINT_BIN_HEADER_LIMBS)
+      return 0;
+
+   if (!_F_mpn_parse_bin_header(hdr, buf)) return 0;
+
+   return _F_mpn_bin_payload_fits(f, hdr->limbs);
+}
+
+int F_mpn_bin_header_check(const F_mpn_bin_header_t hdr, ulong entries)
+{
+   if (hdr->flags & FLINT_BIN_SMALL) return (hdr->limbs == entries);
+
+   return (hdr->limbs >= entries);
+}
+
+int F_mpn_get_bin_header(F_mpn_bin_header_t hdr, const mp_limb_t * data, ulong limbs)
+{
+   mp_limb_t buf[FLINT_BIN_HEADER_LIMBS];
+
+   if (limbs < FLINT_BIN_HEADER_LIMBS) return 0;
+
+   F_mpn_copy(buf, data, FLINT_BIN_HEADER_LIMBS);
+   if (!_F_mpn_parse_bin_header(hdr, buf)) return 0;
+
+   return (hdr->limbs == limbs - FLINT_BIN_HEADER_LIMBS);
+}
+
+int F_mpn_fread_bin(mp_limb_t * x, ulong n, FILE * f, int swap)
+{
+   if (fread(x, sizeof(mp_limb_t), n, f) != n) return 0;
+
+   if (swap) F_mpn_byte_swap(x, n);
+
+   return 1;
+}
+
+int F_mpn_map_init(F_mpn_map_t map, const char * name)
+{
+   struct stat st;
+   void * addr;
+   int fd;
+
+   map->data = NULL;
+   map->limbs = 0;
+
+   fd = open(name, O_RDONLY);
+   if (fd == -1) return 0;
+
+   if (fstat(fd, &st) == -1 || st.st_size == 0 || (st.st_size % sizeof(mp_limb_t)) != 0)
+   {
+      close(fd);
+      return 0;
+   }
+
+   // private and writable, so that attached objects may be modified in place
+   addr = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+   close(fd);
+
+   if (addr == MAP_FAILED) return 0;
+
+   map->data = (mp_limb_t *) addr;
+   map->limbs = st.st_size/sizeof(mp_limb_t);
+
+   return 1;
+}
+
+void F_mpn_map_clear(F_mpn_map_t map)
+{
+   if (map->data != NULL) 
+      munmap(map->data, map->limbs*sizeof(mp_limb_t));
+
+   map->data = NULL;
+   map->limbs = 0;
+}
@@ -24,6 +24,7 @@
 
 #include "flint.h"
 #include "ZmodF_poly.h"
+#include "flint-tuning.h"
 
 #include "longlong_wrapper.h"
 #include "longlong.h"
@@ -152,6 +153,137 @@ void F_mpn_printx(mp_limb_t * mpn, unsigned long count)
          printf("%lx ", mpn[i]);
 }
                                       
+/*
+   Bit packing of vectors of fields of 1 <= bits <= FLINT_BITS bits, the 
+   i-th field occupying bits k + i*bits, ..., k + (i+1)*bits - 1 of the 
+   mpn, where 0 <= k < FLINT_BITS. AVX2 kernels are selected at runtime 
+   where available.
+*/
+
+/* 
+   Below this number of fields the generic loops are used. The cutoffs are 
+   part of the tuning table, see flint-tuning.h.
+*/
+#define F_MPN_BIT_PACK_AVX2_CUTOFF (flint_tuning.F_mpn_bit_pack_avx2_cutoff)
+#define F_MPN_BIT_UNPACK_AVX2_CUTOFF (flint_tuning.F_mpn_bit_unpack_avx2_cutoff)
+
+/*
+   Packs the n entries of op, each of which must be less than 2^bits, into
+   res. The low k bits of res[0] are preserved and the bits above the last
+   field in the final limb written are set to zero. Returns the number of
+   limbs written, i.e. ceil((k + n*bits)/FLINT_BITS), or 0 if n is zero.
+*/
+ulong F_mpn_bit_pack(mp_limb_t * res, const ulong * op, ulong n, ulong bits, ulong k);
+
+/*
+   Sets res[i] to the i-th field of op for 0 <= i < n. Only the limbs of op
+   containing bits of some field are read.
+*/
+void F_mpn_bit_unpack(ulong * res, const mp_limb_t * op, ulong n, ulong bits, ulong k);
+
+/*
+   Binary files. A file consists of a header of FLINT_BIN_HEADER_LIMBS limbs
+   followed by a payload of limbs, all in the byte order of the writer:
+
+      0:    FLINT_BIN_MAGIC, from which the byte order is detected
+      1:    FLINT_BIN_VERSION
+      2:    the type of object stored (FLINT_BIN_ZMOD_POLY, etc.)
+      3:    FLINT_BITS of the writer, which must match that of the reader
+      4:    flags, FLINT_BIN_SMALL if all integers are stored inline
+      5, 6: dimensions, i.e. length and modulus or rows and columns
+      7:    the number of limbs in the payload
+
+   The stream functions byte swap as necessary. Mapped files must have
+   native byte order. As the header is a whole number of cache lines, the
+   payload of a mapped file is suitably aligned for any vector instructions.
+*/
+
+#define FLINT_BIN_MAGIC 0x464C4E54UL // "FLNT"
+#define FLINT_BIN_VERSION 1UL
+#define FLINT_BIN_HEADER_LIMBS 8
+
+#define FLINT_BIN_ZMOD_POLY 1UL
+#define FLINT_BIN_F_MPZ_POLY 2UL
+#define FLINT_BIN_F_MPZ_MAT 3UL
+
+#define FLINT_BIN_SMALL 1UL
+
+typedef struct
+{
+   ulong type;
+   ulong flags;
+   ulong dim1;
+   ulong dim2;
+   ulong limbs; // number of limbs in the payload
+   int swap; // whether the data has the opposite byte order to ours
+} F_mpn_bin_header_struct;
+
+typedef F_mpn_bin_header_struct F_mpn_bin_header_t[1];
+
+/*
+   A file mapped into memory, copy on write, so that the data may be
+   modified without affecting the file.
+*/
+
+typedef struct
+{
+   mp_limb_t * data;
+   ulong limbs; // size of the file in limbs
+} F_mpn_map_struct;
+
+typedef F_mpn_map_struct F_mpn_map_t[1];
+
+/*
+   Reverses the byte order of each of the n limbs of x.
+*/
+void F_mpn_byte_swap(mp_limb_t * x, ulong n);
+
+/*
+   Writes the header for the given type, flags, dimensions and payload size
+   to f. The swap field is ignored. Returns 1 on success, 0 on failure.
+*/
+int F_mpn_fwrite_bin_header(const F_mpn_bin_header_t hdr, FILE * f);
+
+/*
+   Reads a header from f. Returns 0 if it cannot be read or is not a header
+   of the current version written with our FLINT_BITS. If f is seekable, 
+   also returns 0 if fewer limbs remain in f than the payload size given by 
+   the header, so that a corrupt header cannot cause a huge allocation.
+*/
+int F_mpn_fread_bin_header(F_mpn_bin_header_t hdr, FILE * f);
+
+/*
+   Returns 1 if the payload size given by the header is consistent with
+   the given number of entries, each of which takes at least one limb, 
+   and exactly one if the header has the FLINT_BIN_SMALL flag. Otherwise 
+   returns 0.
+*/
+int F_mpn_bin_header_check(const F_mpn_bin_header_t hdr, ulong entries);
+
+/*
+   As for F_mpn_fread_bin_header, but parses the header from the first
+   limbs of data, and also fails if data does not have exactly the number
+   of payload limbs given by the header.
+*/
+int F_mpn_get_bin_header(F_mpn_bin_header_t hdr, const mp_limb_t * data, ulong limbs);
+
+/*
+   Reads n limbs from f into x, byte swapping them if swap is set. Returns
+   1 on success, 0 on failure.
+*/
+int F_mpn_fread_bin(mp_limb_t * x, ulong n, FILE * f, int swap);
+
+/*
+   Maps the named file, which must be a nonzero whole number of limbs long, 
+   into memory. Returns 1 on success, 0 on failure.
+*/
+int F_mpn_map_init(F_mpn_map_t map, const char * name);
+
+/*
+   Unmaps the file. Any objects attached to the data become invalid.
+*/
+void F_mpn_map_clear(F_mpn_map_t map);
+
 /* 
    Large integer multiplication
 */
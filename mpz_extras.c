@@ -23,6 +23,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <gmp.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "mpz_extras.h"
 #include "flint.h"
 #include "mpn_extras.h"
@@ -668,3 +671,436 @@ void F_mpz_mul(mpz_t res, mpz_t a, mpz_t b)
    } else mpz_mul(res, a, b);
 }
 
+
+/*===================================================================================
+
+   Radix conversion
+
+====================================================================================*/
+
+#define RADIX_WHITESPACE " \t\n\r"
+
+void F_mpz_radix_init(F_mpz_radix_t R)
+{
+   R->digits = FLINT_MAX(FLINT_MIN(F_MPZ_RADIX_DIGITS, F_MPZ_RADIX_MAX_DIGITS), 1);
+   R->pow = NULL;
+   R->length = 0;
+   R->alloc = 0;
+}
+
+void F_mpz_radix_clear(F_mpz_radix_t R)
+{
+   unsigned long i;
+   for (i = 0; i < R->length; i++)
+      mpz_clear(R->pow[i]);
+   if (R->pow) free(R->pow);
+}
+
+void F_mpz_radix_fit(F_mpz_radix_t R, unsigned long digits)
+{
+   // pow[j] is used to split integers of more than D*2^j digits
+   while ((R->digits << R->length) < digits)
+   {
+      if (R->length == R->alloc)
+      {
+         R->alloc = R->alloc ? 2*R->alloc : 8;
+         R->pow = (mpz_t *) realloc(R->pow, R->alloc*sizeof(mpz_t));
+      }
+
+      mpz_init(R->pow[R->length]);
+      if (R->length == 0) mpz_ui_pow_ui(R->pow[0], 5, R->digits);
+      else mpz_mul(R->pow[R->length], R->pow[R->length - 1], R->pow[R->length - 1]);
+      R->length++;
+   }
+}
+
+/*
+   Returns the largest j such that D*2^j < len, assuming len > D, where D is
+   the number of digits converted directly
+*/
+static inline
+unsigned long __F_mpz_radix_level(unsigned long len, const F_mpz_radix_t R)
+{
+   unsigned long j = 0;
+   while ((R->digits << (j + 1)) < len) j++;
+   return j;
+}
+
+/*
+   Writes the nonnegative integer x, of at most len digits, to s as exactly 
+   len digits, padding with leading zeroes, without a terminator. The value 
+   of x is destroyed.
+*/
+static
+void __F_mpz_radix_get_str(char * s, mpz_t x, unsigned long len, const F_mpz_radix_t R)
+{
+   if (len <= R->digits)
+   {
+      char t[F_MPZ_RADIX_MAX_DIGITS + 2];
+      unsigned long n = 0;
+      
+      if (mpz_sgn(x)) 
+      {
+         mpz_get_str(t, 10, x);
+         n = strlen(t);
+      }
+      memset(s, '0', len - n);
+      memcpy(s + len - n, t, n);
+      
+      return;
+   }
+
+   unsigned long j = __F_mpz_radix_level(len, R);
+   unsigned long k = R->digits << j;
+   mpz_t hi, r;
+   mpz_init(hi);
+   mpz_init(r);
+
+   // x = hi*10^k + lo where lo = r*2^k + (x mod 2^k)
+   mpz_tdiv_q_2exp(hi, x, k);
+   mpz_tdiv_qr(hi, r, hi, R->pow[j]);
+   mpz_tdiv_r_2exp(x, x, k);
+   mpz_mul_2exp(r, r, k);
+   mpz_ior(x, x, r);
+   mpz_clear(r);
+
+#pragma omp task shared(hi) if (k >= F_MPZ_RADIX_TASK_DIGITS)
+   __F_mpz_radix_get_str(s, hi, len - k, R);
+   
+   __F_mpz_radix_get_str(s + len - k, x, k, R);
+
+#pragma omp taskwait
+   mpz_clear(hi);
+}
+
+/*
+   Writes x to s as a sign, if x is negative, followed by exactly 
+   mpz_sizeinbase(x, 10) digits, of which the first may be a superfluous
+   zero, without a terminator. Returns the number of characters written.
+*/
+static
+unsigned long __F_mpz_radix_get_str_padded(char * s, mpz_t x, const F_mpz_radix_t R)
+{
+   unsigned long len = mpz_sizeinbase(x, 10);
+   unsigned long neg = (mpz_sgn(x) < 0);
+   mpz_t t;
+
+   if (neg) s[0] = '-';
+   
+   mpz_init(t);
+   mpz_abs(t, x); // the conversion destroys its input
+   __F_mpz_radix_get_str(s + neg, t, len, R);
+   mpz_clear(t);
+
+   return len + neg;
+}
+
+/*
+   Removes any superfluous zero from the start of the digits of the padded
+   integer of len characters at s, moving it to d, which may overlap s, 
+   provided d <= s. Returns the new length.
+*/
+static
+unsigned long __F_mpz_radix_strip(char * d, const char * s, unsigned long len)
+{
+   unsigned long neg = (s[0] == '-');
+
+   if (neg) *d++ = '-';
+   if (len - neg > 1 && s[neg] == '0') 
+   {
+      len--;
+      s++;
+   }
+   memmove(d, s + neg, len - neg);
+
+   return len;
+}
+
+unsigned long F_mpz_radix_get_str(char * s, mpz_t x, const F_mpz_radix_t R)
+{
+   unsigned long len = mpz_sizeinbase(x, 10);
+
+   if (len <= R->digits || (R->digits << R->length) < len)
+   {
+      mpz_get_str(s, 10, x);
+      return strlen(s);
+   }
+
+   len = __F_mpz_radix_get_str_padded(s, x, R);
+   len = __F_mpz_radix_strip(s, s, len);
+   s[len] = 0;
+
+   return len;
+}
+
+/*
+   Sets x to the integer given by the len digits at s
+*/
+static
+void __F_mpz_radix_set_str(mpz_t x, const char * s, unsigned long len, const F_mpz_radix_t R)
+{
+   if (len < 2*sizeof(unsigned long)) // fits in a limb
+   {
+      unsigned long i, c = 0;
+      for (i = 0; i < len; i++)
+         c = 10*c + (s[i] - '0');
+      mpz_set_ui(x, c);
+
+      return;
+   }
+
+   if (len <= R->digits)
+   {
+      char t[F_MPZ_RADIX_MAX_DIGITS + 1];
+      memcpy(t, s, len);
+      t[len] = 0;
+      mpz_set_str(x, t, 10);
+
+      return;
+   }
+
+   unsigned long j = __F_mpz_radix_level(len, R);
+   unsigned long k = R->digits << j;
+   mpz_t lo;
+   mpz_init(lo);
+
+#pragma omp task shared(x) if (k >= F_MPZ_RADIX_TASK_DIGITS)
+   __F_mpz_radix_set_str(x, s, len - k, R);
+
+   __F_mpz_radix_set_str(lo, s + len - k, k, R);
+
+#pragma omp taskwait
+   
+   // x = hi*5^k*2^k + lo
+   mpz_mul(x, x, R->pow[j]);
+   mpz_mul_2exp(x, x, k);
+   mpz_add(x, x, lo);
+   mpz_clear(lo);
+}
+
+void F_mpz_radix_set_str(mpz_t x, const char * s, unsigned long len, const F_mpz_radix_t R)
+{
+   __F_mpz_radix_set_str(x, s, len, R);
+}
+
+unsigned long F_mpz_radix_vec_str_size(mpz_t * vec, unsigned long n)
+{
+   unsigned long i, size = 1;
+
+   // +2 is for the sign and a space
+   for (i = 0; i < n; i++)
+      size += mpz_sizeinbase(vec[i], 10) + 2;
+
+   return size;
+}
+
+unsigned long F_mpz_radix_vec_get_str(char * s, mpz_t * vec, unsigned long n, F_mpz_radix_t R)
+{
+   unsigned long i, len, max = 0;
+
+   if (n == 0)
+   {
+      s[0] = 0;
+      return 0;
+   }
+
+   // each integer is written padded to a known length, at a known position
+   unsigned long * pos = (unsigned long *) malloc((n + 1)*sizeof(unsigned long));
+
+   pos[0] = 0;
+   for (i = 0; i < n; i++)
+   {
+      len = mpz_sizeinbase(vec[i], 10);
+      if (len > max) max = len;
+      pos[i + 1] = pos[i] + len + (mpz_sgn(vec[i]) < 0) + 1;
+   }
+
+   F_mpz_radix_fit(R, max);
+
+   // R is only read from here on, and each task writes its own characters
+#pragma omp parallel
+   {
+#pragma omp single
+      {
+         unsigned long start, end;
+
+         // one task for each block of integers of about F_MPZ_RADIX_BLOCK characters
+         for (start = 0; start < n; start = end)
+         {
+            for (end = start + 1; end < n && pos[end] - pos[start] < F_MPZ_RADIX_BLOCK; end++)
+               ;
+
+#pragma omp task firstprivate(start, end)
+            {
+               unsigned long t;
+               for (t = start; t < end; t++)
+                  __F_mpz_radix_get_str_padded(s + pos[t], vec[t], R);
+            }
+         }
+      }
+   }
+
+   // remove superfluous zeroes and separate with spaces
+   len = 0;
+   for (i = 0; i < n; i++)
+   {
+      len += __F_mpz_radix_strip(s + len, s + pos[i], pos[i + 1] - pos[i] - 1);
+      s[len++] = ' ';
+   }
+   s[--len] = 0;
+
+   free(pos);
+
+   return len;
+}
+
+int F_mpz_radix_vec_set_str(mpz_t * vec, unsigned long n, const char * s, 
+                                             const char ** end, F_mpz_radix_t R)
+{
+   unsigned long i, max = 0;
+   int ok = 1;
+
+   // tokenise, then convert in parallel
+   const char ** start = (const char **) malloc(n*sizeof(const char *));
+   unsigned long * len = (unsigned long *) malloc(n*sizeof(unsigned long));
+   int * neg = (int *) malloc(n*sizeof(int));
+
+   for (i = 0; i < n; i++)
+   {
+      s += strspn(s, RADIX_WHITESPACE);
+      
+      neg[i] = (*s == '-');
+      if (*s == '-' || *s == '+') s++;
+      
+      start[i] = s;
+      len[i] = strspn(s, "0123456789");
+      if (len[i] == 0)
+      {
+         ok = 0;
+         break;
+      }
+      if (len[i] > max) max = len[i];
+
+      // the digits must be followed by whitespace or the end of the string
+      s += len[i];
+      if (*s != 0 && strchr(RADIX_WHITESPACE, *s) == NULL)
+      {
+         ok = 0;
+         break;
+      }
+   }
+
+   if (end != NULL) *end = s;
+
+   if (ok)
+   {
+      F_mpz_radix_fit(R, max);
+
+      // R is only read from here on, and each task writes its own integers
+#pragma omp parallel
+      {
+#pragma omp single
+         {
+            unsigned long first, last, size;
+
+            for (first = 0; first < n; first = last)
+            {
+               size = len[first];
+               for (last = first + 1; last < n && size < F_MPZ_RADIX_BLOCK; last++)
+                  size += len[last];
+
+#pragma omp task firstprivate(first, last)
+               {
+                  unsigned long t;
+                  for (t = first; t < last; t++)
+                  {
+                     __F_mpz_radix_set_str(vec[t], start[t], len[t], R);
+                     if (neg[t]) mpz_neg(vec[t], vec[t]);
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   free(start);
+   free(len);
+   free(neg);
+
+   return ok;
+}
+
+int F_mpz_radix_vec_fprint(FILE * f, mpz_t * vec, unsigned long n, F_mpz_radix_t R)
+{
+   unsigned long i, j, size, alloc = 0;
+   char * buf = NULL;
+   int ok = 1;
+
+   for (i = 0; i < n && ok; i = j)
+   {
+      // convert a block of integers to a buffer and write it
+      size = mpz_sizeinbase(vec[i], 10) + 3;
+      for (j = i + 1; j < n && size < F_MPZ_RADIX_BLOCK; j++)
+         size += mpz_sizeinbase(vec[j], 10) + 2;
+
+      if (size > alloc)
+      {
+         alloc = size;
+         buf = (char *) realloc(buf, alloc);
+      }
+
+      size = F_mpz_radix_vec_get_str(buf, vec + i, j - i, R);
+      
+      if (i > 0) ok = (fputc(' ', f) != EOF);
+      if (ok) ok = (fwrite(buf, 1, size, f) == size);
+   }
+
+   if (buf) free(buf);
+
+   return ok;
+}
+
+int F_mpz_radix_vec_fread(mpz_t * vec, unsigned long n, FILE * f, F_mpz_radix_t R)
+{
+   unsigned long i, j, size, alloc = 1024;
+   char * buf = (char *) malloc(alloc);
+   int c, ok = 1;
+
+   for (i = 0; i < n && ok; i = j)
+   {
+      // read a block of integers into the buffer, separated by spaces
+      for (j = i, size = 0; j < n && size < F_MPZ_RADIX_BLOCK; j++)
+      {
+         do c = getc(f); while (c == ' ' || c == '\t' || c == '\n' || c == '\r');
+
+         unsigned long first = size;
+         for ( ; (c >= '0' && c <= '9') || (size == first && (c == '-' || c == '+')); c = getc(f))
+         {
+            if (size + 2 > alloc)
+            {
+               alloc *= 2;
+               buf = (char *) realloc(buf, alloc);
+            }
+            buf[size++] = c;
+         }
+         if (c != EOF) ungetc(c, f);
+         
+         if (size == first || buf[size - 1] < '0') // no digits
+         {
+            ok = 0;
+            break;
+         }
+         buf[size++] = ' ';
+      }
+      
+      if (ok)
+      {
+         buf[size] = 0;
+         ok = F_mpz_radix_vec_set_str(vec + i, j - i, buf, NULL, R);
+      }
+   }
+
+   free(buf);
+
+   return ok;
+}
@@ -24,6 +24,7 @@
 #include <string.h>
 #include <stdint.h>
 #include <gmp.h>
+#include "flint-tuning.h"
 
 #ifndef FLINT_MPZ_EXTRAS_H
 #define FLINT_MPZ_EXTRAS_H
@@ -120,6 +121,103 @@ void F_mpz_mul(mpz_t res, mpz_t a, mpz_t b);
 
 void __F_mpz_mul(mpz_t res, mpz_t a, mpz_t b, unsigned long twk);
 
+/*===================================================================================
+
+   Radix conversion
+
+   Divide and conquer conversion between binary and decimal. A number of at
+   most len digits is split as hi*10^k + lo with k = D*2^j the largest such
+   value less than len, and as 10^k = 5^k*2^k, only the powers 5^k need to 
+   be stored. These are kept in an F_mpz_radix_t, which can be shared by 
+   the conversions of any number of integers. The number D of digits 
+   converted by GMP directly is F_MPZ_RADIX_DIGITS at the time the 
+   F_mpz_radix_t is initialised, at most F_MPZ_RADIX_MAX_DIGITS.
+
+   The vector functions convert blocks of about F_MPZ_RADIX_BLOCK 
+   characters as OpenMP tasks, and conversions of more than 
+   F_MPZ_RADIX_TASK_DIGITS digits are split into further tasks. The 
+   pragmas only take effect if FLINT is built with FLINT_OPENMP=1; 
+   otherwise they are ignored and all conversions are serial. The tasks 
+   only read R, which is fitted before any are created, and each writes 
+   its own integers or its own range of characters, so that they are 
+   safe provided GMP uses a thread safe allocator, as it does by default.
+
+====================================================================================*/
+
+#define F_MPZ_RADIX_MAX_DIGITS 4096
+#define F_MPZ_RADIX_DIGITS (flint_tuning.F_mpz_radix_digits) // number of digits converted by GMP directly
+#define F_MPZ_RADIX_TASK_DIGITS (flint_tuning.F_mpz_radix_task_digits)
+#define F_MPZ_RADIX_BLOCK (flint_tuning.F_mpz_radix_block) // number of characters buffered by the vector I/O
+
+typedef struct
+{
+   unsigned long digits; // D, the number of digits converted by GMP directly
+   mpz_t * pow; // pow[j] = 5^(D*2^j)
+   unsigned long length;
+   unsigned long alloc;
+} F_mpz_radix_struct;
+
+typedef F_mpz_radix_struct F_mpz_radix_t[1];
+
+void F_mpz_radix_init(F_mpz_radix_t R);
+
+void F_mpz_radix_clear(F_mpz_radix_t R);
+
+/*
+   Computes the powers required to convert integers of up to the given
+   number of decimal digits. This must not be called while another thread 
+   uses R.
+*/
+void F_mpz_radix_fit(F_mpz_radix_t R, unsigned long digits);
+
+/*
+   Writes x to s in decimal, with a null terminator, as per mpz_get_str, and
+   returns the number of characters written, excluding the terminator. If R
+   has not been fitted to the size of x, GMP is used instead.
+*/
+unsigned long F_mpz_radix_get_str(char * s, mpz_t x, const F_mpz_radix_t R);
+
+/*
+   Sets x to the integer given by the len decimal digits at s, which must 
+   all be in the range '0' to '9'. R must have been fitted to len digits.
+*/
+void F_mpz_radix_set_str(mpz_t x, const char * s, unsigned long len, const F_mpz_radix_t R);
+
+/*
+   Returns an upper bound for the number of characters written by
+   F_mpz_radix_vec_get_str, including the terminator.
+*/
+unsigned long F_mpz_radix_vec_str_size(mpz_t * vec, unsigned long n);
+
+/*
+   Writes the n integers of vec to s in decimal, separated by single 
+   spaces and followed by a null terminator. Returns the number of 
+   characters written, excluding the terminator. R is fitted as required.
+*/
+unsigned long F_mpz_radix_vec_get_str(char * s, mpz_t * vec, unsigned long n, F_mpz_radix_t R);
+
+/*
+   Reads n whitespace separated, optionally signed, decimal integers from s 
+   into vec. The digits of each integer must be followed by whitespace or 
+   the end of the string. Returns 1 on success, 0 if fewer than n 
+   integers could be read. If end is not NULL, it is set to point after 
+   the last integer read. R is fitted as required.
+*/
+int F_mpz_radix_vec_set_str(mpz_t * vec, unsigned long n, const char * s, 
+                                             const char ** end, F_mpz_radix_t R);
+
+/*
+   As per F_mpz_radix_vec_get_str, but writes to f, a block at a time,
+   without a terminator. Returns 1 on success, 0 on failure.
+*/
+int F_mpz_radix_vec_fprint(FILE * f, mpz_t * vec, unsigned long n, F_mpz_radix_t R);
+
+/*
+   As per F_mpz_radix_vec_set_str, but reads from f, a block at a time. The
+   character following the last integer is not consumed.
+*/
+int F_mpz_radix_vec_fread(mpz_t * vec, unsigned long n, FILE * f, F_mpz_radix_t R);
+
 #ifdef __cplusplus
  }
 #endif
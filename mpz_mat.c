@@ -31,6 +31,7 @@ Copyright (C) 2008, William Hart
 #include <stdio.h>
 #include "flint.h"
 #include "mpz_mat.h"
+#include "mpz_extras.h"
 
 /****************************************************************************
 
@@ -122,22 +123,12 @@ int mpz_mat_from_string(mpz_mat_t mat, const char *s)
    mpz_mat_clear(mat);
    mpz_mat_init(mat,r,c);
 
-   unsigned long i;
-   for (i = 0; i < r*c; i++)
-   {
-
-      // skip whitespace
-      s += strspn(s, whitespace);
+   F_mpz_radix_t R;
+   F_mpz_radix_init(R);
+   int ok = F_mpz_radix_vec_set_str(mat->entries, r*c, s, NULL, R);
+   F_mpz_radix_clear(R);
 
-      if (!gmp_sscanf(s, "%Zd", mat->entries[i]))
-         return 0;
-
-      // jump to next whitespace
-      s += strcspn(s, whitespace);
-
-   }
-
-   return 1;
+   return ok;
 }
 
 char* mpz_mat_to_string(mpz_mat_t mat)
@@ -153,16 +144,14 @@ char* mpz_mat_to_string(mpz_mat_t mat)
    // write the string
    char* buf = (char*) malloc(size);
    char* ptr = buf + sprintf(buf, "%ld %ld  ", mat->r, mat->c);
-   for (i = 0; i < mat->r * mat->c; i++)
+   if (mat->r && mat->c)
    {
-      mpz_get_str(ptr, 10, mat->entries[i]);
-      ptr += strlen(ptr);
-      *ptr = ' ';
-      ptr++;
-   }
-   
-   ptr--;
-   *ptr = 0;
+      F_mpz_radix_t R;
+      F_mpz_radix_init(R);
+      F_mpz_radix_vec_get_str(ptr, mat->entries, mat->r * mat->c, R);
+      F_mpz_radix_clear(R);
+   } else
+      ptr[-1] = 0;
    
    return buf;
 }
@@ -285,9 +274,13 @@ char* mpz_mat_to_string_pretty(mpz_mat_t mat)
 
 void mpz_mat_fprint(mpz_mat_t mat, FILE* f)
 {
-   char* s = mpz_mat_to_string(mat);
-   fputs(s, f);
-   free(s);
+   // written a block of entries at a time, in the format of mpz_mat_to_string
+   fprintf(f, (mat->r && mat->c) ? "%ld %ld  " : "%ld %ld ", mat->r, mat->c);
+   
+   F_mpz_radix_t R;
+   F_mpz_radix_init(R);
+   F_mpz_radix_vec_fprint(f, mat->entries, mat->r * mat->c, R);
+   F_mpz_radix_clear(R);
 }
 
 void mpz_mat_fprint_pretty(mpz_mat_t mat, FILE* f)
@@ -310,13 +303,12 @@ int mpz_mat_fread(mpz_mat_t mat, FILE* f)
    mpz_mat_clear(mat);
    mpz_mat_init(mat,r,c);
 
-   unsigned long i;
-   for (i = 0; i < r*c; i++)
-   {
-      if (!mpz_inp_str(mat->entries[i], f, 10))
-         return 0;
-   }
-   return 1;
+   F_mpz_radix_t R;
+   F_mpz_radix_init(R);
+   int ok = F_mpz_radix_vec_fread(mat->entries, r*c, f, R);
+   F_mpz_radix_clear(R);
+
+   return ok;
 }
 
 int mpz_mat_fread_pretty(mpz_mat_t mat, FILE* f)
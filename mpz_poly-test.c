@@ -29,8 +29,13 @@ Copyright (C) 2007, William Hart and David Harvey
 #include <string.h>
 #include "flint.h"
 #include "mpz_poly.h"
+#include "mpz_extras.h"
 #include "test-support.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 
 // tests whether the given polynomial is equal to the one given by the string
@@ -381,6 +386,319 @@ int test_mpz_poly_fread()
 }
 
 
+// sets x to a random integer of up to bits bits, often of the form 10^k or 10^k - 1
+void radix_test_randint(mpz_t x, unsigned long bits)
+{
+   switch (random_ulong(4))
+   {
+      case 0: 
+         mpz_ui_pow_ui(x, 10, random_ulong(bits/3 + 1)); 
+         break;
+      case 1: 
+         mpz_ui_pow_ui(x, 10, random_ulong(bits/3 + 1)); 
+         mpz_sub_ui(x, x, 1); 
+         break;
+      default: 
+         mpz_rrandomb(x, randstate, random_ulong(bits) + 1);
+   }
+   
+   if (random_ulong(2)) mpz_neg(x, x);
+}
+
+int test_F_mpz_radix_get_set_str()
+{
+   int result = 1;
+   unsigned long count, len;
+   mpz_t x, y;
+   F_mpz_radix_t R;
+   mpz_init(x);
+   mpz_init(y);
+
+   for (count = 0; (count < 300) && (result == 1); count++)
+   {
+      F_mpz_radix_init(R);
+      radix_test_randint(x, random_ulong(2) ? 100000 : 5000);
+      
+      char * s1 = mpz_get_str(NULL, 10, x);
+      char * s2 = (char *) malloc(mpz_sizeinbase(x, 10) + 2);
+      
+      // R is not always large enough, in which case GMP is used
+      F_mpz_radix_fit(R, random_ulong(mpz_sizeinbase(x, 10) + 1000));
+      len = F_mpz_radix_get_str(s2, x, R);
+      result = (len == strlen(s1) && strcmp(s1, s2) == 0);
+
+      if (result)
+      {
+         F_mpz_radix_fit(R, len);
+         F_mpz_radix_set_str(y, s1 + (s1[0] == '-'), len - (s1[0] == '-'), R);
+         mpz_abs(x, x);
+         result = (mpz_cmp(x, y) == 0);
+      }
+
+      if (!result) printf("Error: len = %ld\n", len);
+
+      free(s1);
+      free(s2);
+      F_mpz_radix_clear(R);
+   }
+
+   mpz_clear(x);
+   mpz_clear(y);
+
+   return result;
+}
+
+int test_F_mpz_radix_vec()
+{
+   int result = 1;
+   unsigned long count, n, i, bits;
+   F_mpz_radix_t R;
+
+   for (count = 0; (count < 100) && (result == 1); count++)
+   {
+      // the last iteration is large enough to be converted in several blocks
+      n = (count == 99) ? 30 : random_ulong(50);
+      bits = (count == 99) ? 140000 : random_ulong(20000) + 1;
+      
+      mpz_t * vec1 = (mpz_t *) malloc((n + 1)*sizeof(mpz_t));
+      mpz_t * vec2 = (mpz_t *) malloc((n + 1)*sizeof(mpz_t));
+      for (i = 0; i < n; i++)
+      {
+         mpz_init(vec1[i]);
+         mpz_init(vec2[i]);
+         if (random_ulong(4)) radix_test_randint(vec1[i], bits);
+      }
+
+      // compare with GMP
+      unsigned long size = F_mpz_radix_vec_str_size(vec1, n);
+      char * s1 = (char *) malloc(size);
+      char * s2 = (char *) malloc(size);
+      char * ptr = s1;
+      for (i = 0; i < n; i++)
+      {
+         mpz_get_str(ptr, 10, vec1[i]);
+         ptr += strlen(ptr);
+         *ptr++ = ' ';
+      }
+      if (n) ptr--;
+      *ptr = 0;
+
+      F_mpz_radix_init(R);
+      unsigned long len = F_mpz_radix_vec_get_str(s2, vec1, n, R);
+      result = (len == strlen(s1) && strcmp(s1, s2) == 0);
+
+      // and back again
+      const char * end;
+      if (result) 
+         result = F_mpz_radix_vec_set_str(vec2, n, s2, &end, R) && (end == s2 + len);
+      for (i = 0; (i < n) && result; i++)
+         result = (mpz_cmp(vec1[i], vec2[i]) == 0);
+      
+      // a character other than whitespace after the digits is rejected
+      if (result && n)
+      {
+         char * s3 = (char *) malloc(len + 2);
+         strcpy(s3, s2);
+         i = random_ulong(n);
+         ptr = s3;
+         for ( ; i > 0; i--) ptr = strchr(ptr, ' ') + 1;
+         ptr += strspn(ptr, "-0123456789");
+         memmove(ptr + 1, ptr, strlen(ptr) + 1);
+         *ptr = random_ulong(2) ? 'x' : '-';
+         result = !F_mpz_radix_vec_set_str(vec2, n, s3, NULL, R);
+         free(s3);
+      }
+
+      // n + 1 integers cannot be read
+      if (result)
+      {
+         mpz_init(vec2[n]);
+         result = !F_mpz_radix_vec_set_str(vec2, n + 1, s2, NULL, R);
+         mpz_clear(vec2[n]);
+      }
+
+      // via a file, with a trailing character which must not be consumed
+      if (result)
+      {
+         FILE * f = tmpfile();
+         result = F_mpz_radix_vec_fprint(f, vec1, n, R);
+         fputs("\n", f);
+         rewind(f);
+         for (i = 0; i < n; i++)
+            mpz_set_ui(vec2[i], 1);
+         result = result && F_mpz_radix_vec_fread(vec2, n, f, R) && (getc(f) == '\n');
+         for (i = 0; (i < n) && result; i++)
+            result = (mpz_cmp(vec1[i], vec2[i]) == 0);
+         fclose(f);
+      }
+
+      if (!result) printf("Error: n = %ld, bits = %ld\n", n, bits);
+
+      F_mpz_radix_clear(R);
+      free(s1);
+      free(s2);
+      for (i = 0; i < n; i++)
+      {
+         mpz_clear(vec1[i]);
+         mpz_clear(vec2[i]);
+      }
+      free(vec1);
+      free(vec2);
+   }
+
+   return result;
+}
+
+/*
+   The vector conversions use OpenMP tasks when FLINT is built with 
+   FLINT_OPENMP=1. The tuning parameters are lowered so that small 
+   inputs are split into many tasks, and the results for 1 to 4 
+   threads are compared with GMP.
+*/
+void set_num_threads(int threads)
+{
+#ifdef _OPENMP
+   omp_set_num_threads(threads);
+#endif
+}
+
+int get_max_threads(void)
+{
+#ifdef _OPENMP
+   return omp_get_max_threads();
+#else
+   return 1;
+#endif
+}
+
+int test_F_mpz_radix_vec_threads()
+{
+   int result = 1;
+   unsigned long count, n, i;
+   F_mpz_radix_t R;
+   flint_tuning_t saved = flint_tuning;
+   int max_threads = get_max_threads();
+
+   for (count = 0; (count < 100) && (result == 1); count++)
+   {
+      set_num_threads(random_ulong(4) + 1);
+      flint_tuning.F_mpz_radix_digits = random_ulong(100) + 1;
+      flint_tuning.F_mpz_radix_task_digits = random_ulong(1000) + 1;
+      flint_tuning.F_mpz_radix_block = random_ulong(3000) + 1;
+
+      n = random_ulong(100);
+      
+      mpz_t * vec1 = (mpz_t *) malloc((n + 1)*sizeof(mpz_t));
+      mpz_t * vec2 = (mpz_t *) malloc((n + 1)*sizeof(mpz_t));
+      for (i = 0; i < n; i++)
+      {
+         mpz_init(vec1[i]);
+         mpz_init(vec2[i]);
+         radix_test_randint(vec1[i], 10000);
+      }
+
+      unsigned long size = F_mpz_radix_vec_str_size(vec1, n);
+      char * s1 = (char *) malloc(size);
+      char * s2 = (char *) malloc(size);
+      char * ptr = s1;
+      for (i = 0; i < n; i++)
+      {
+         mpz_get_str(ptr, 10, vec1[i]);
+         ptr += strlen(ptr);
+         *ptr++ = ' ';
+      }
+      if (n) ptr--;
+      *ptr = 0;
+
+      F_mpz_radix_init(R);
+      unsigned long len = F_mpz_radix_vec_get_str(s2, vec1, n, R);
+      result = (len == strlen(s1) && strcmp(s1, s2) == 0);
+
+      if (result) 
+         result = F_mpz_radix_vec_set_str(vec2, n, s2, NULL, R);
+      for (i = 0; (i < n) && result; i++)
+         result = (mpz_cmp(vec1[i], vec2[i]) == 0);
+
+      if (!result) printf("Error: n = %ld, threads = %d\n", n, get_max_threads());
+
+      F_mpz_radix_clear(R);
+      free(s1);
+      free(s2);
+      for (i = 0; i < n; i++)
+      {
+         mpz_clear(vec1[i]);
+         mpz_clear(vec2[i]);
+      }
+      free(vec1);
+      free(vec2);
+   }
+
+   flint_tuning = saved;
+   set_num_threads(max_threads);
+
+   return result;
+}
+
+int test_mpz_poly_tofromstring_radix()
+{
+   int result = 1;
+   unsigned long count, i, n;
+   mpz_poly_t poly1, poly2;
+
+   for (count = 0; (count < 100) && (result == 1); count++)
+   {
+      n = random_ulong(30);
+      mpz_poly_init(poly1);
+      mpz_poly_init(poly2);
+      mpz_poly_ensure_alloc(poly1, n);
+      for (i = 0; i < n; i++)
+         radix_test_randint(poly1->coeffs[i], 3000);
+      poly1->length = n;
+      mpz_poly_normalise(poly1);
+
+      // the format must be unchanged
+      char * s1 = mpz_poly_to_string(poly1);
+      char * s2 = (char *) malloc(strlen(s1) + 1);
+      char * ptr = s2 + sprintf(s2, "%ld  ", poly1->length);
+      for (i = 0; i < poly1->length; i++)
+      {
+         mpz_get_str(ptr, 10, poly1->coeffs[i]);
+         ptr += strlen(ptr);
+         *ptr++ = ' ';
+      }
+      ptr[-1] = 0;
+      result = (strcmp(s1, s2) == 0);
+
+      if (result)
+      {
+         result = mpz_poly_from_string(poly2, s1) && mpz_poly_equal(poly1, poly2);
+      }
+
+      if (result)
+      {
+         FILE * f = tmpfile();
+         mpz_poly_fprint(poly1, f);
+         rewind(f);
+         result = mpz_poly_fread(poly2, f) && mpz_poly_equal(poly1, poly2);
+         rewind(f);
+         for (i = 0; (result) && (i < strlen(s1)); i++)
+            result = (getc(f) == s1[i]);
+         result = result && (getc(f) == EOF);
+         fclose(f);
+      }
+
+      if (!result) printf("Error: n = %ld\n", n);
+
+      free(s1);
+      free(s2);
+      mpz_poly_clear(poly1);
+      mpz_poly_clear(poly2);
+   }
+
+   return result;
+}
+
+
 /****************************************************************************
 
    Length and degree
@@ -1206,6 +1524,10 @@ void mpz_poly_test_all()
 //   RUN_TEST(mpz_poly_to_string);
 //   RUN_TEST(mpz_poly_fprint);
 //   RUN_TEST(mpz_poly_fread);
+   RUN_TEST(F_mpz_radix_get_set_str);
+   RUN_TEST(F_mpz_radix_vec);
+   RUN_TEST(F_mpz_radix_vec_threads);
+   RUN_TEST(mpz_poly_tofromstring_radix);
 //   RUN_TEST(mpz_poly_normalise);
 //   RUN_TEST(mpz_poly_normalised);
 //   RUN_TEST(mpz_poly_pad);
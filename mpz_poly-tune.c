@@ -22,8 +22,10 @@
    
    Program for tuning the mpz_poly module.
    
-   This program writes to standard output an automatically tuned version of
-   mpz_poly-tuning.c.
+   This program measures the karatsuba crossovers for mpz_poly, writes them
+   to standard output and saves them in the runtime tuning profile (see 
+   flint-tuning.h). The profile file may be given on the command line, 
+   otherwise flint_tuning_filename() is used.
    
    (If DEBUG is set, it also writes logging info to standard error.)
    
@@ -37,6 +39,7 @@
 #include "profiler.h"
 #include "mpz_poly.h"
 #include "mpz_poly-tuning.h"
+#include "flint-tuning.h"
 
 
 #define DEBUG 1
@@ -153,32 +156,38 @@ int main(int argc, char* argv[])
 
    test_support_init();
 
-   fprintf(fout, "/*\n");
-   fprintf(fout, "   Tuning values for mpz_poly module\n");
-   fprintf(fout, "\n");
-   fprintf(fout, "   Automatically generated by mpz_poly-tune program\n");
-   fprintf(fout, "*/\n\n");
-   fprintf(fout, "#include \"mpz_poly-tuning.h\"\n");
-   fprintf(fout, "#include \"mpz_poly.h\"\n");
-   fprintf(fout, "\n");
-   fprintf(fout, "unsigned long mpz_poly_kara_crossover_table[] = {");
+   // keep the values for the other modules
+   const char * filename = (argc > 1) ? argv[1] : flint_tuning_filename();
+   if (filename != NULL) flint_tuning_load(filename);
+
+   char cpu[FLINT_TUNING_CPU_LENGTH];
+   flint_tuning_cpu(cpu);
+   fprintf(fout, "Tuning mpz_poly for %s\n\n", cpu);
+   fprintf(fout, "mpz_poly_kara_crossover_table = {");
    fflush(fout);
 
    unsigned long limbs;
-   for (limbs = 1; ; limbs++)
+   for (limbs = 1; limbs < FLINT_TUNING_TABLE_LENGTH; limbs++)
    {
       unsigned long crossover = crossover_kara(limbs, flog);
       if (crossover == 2)
          break;
+      mpz_poly_kara_crossover_table[limbs - 1] = crossover;
       fprintf(fout, "%ld, ", crossover);
       fflush(fout);
    }
-   fprintf(fout, "0};\n");
-   fprintf(fout, "unsigned long mpz_poly_kara_crossover_table_size = %ld;\n",
-           limbs);
+   mpz_poly_kara_crossover_table[limbs - 1] = 0;
+   mpz_poly_kara_crossover_table_size = limbs;
+   fprintf(fout, "0}\n");
+   fprintf(fout, "mpz_poly_kara_crossover_table_size = %ld\n\n", limbs);
    
-   fprintf(fout, "\n\n");
-   fprintf(fout, "// end of file *********************************\n");
+   if (filename != NULL)
+   {
+      if (flint_tuning_save(filename))
+         fprintf(fout, "Saved to %s\n", filename);
+      else
+         fprintf(fout, "Unable to write %s\n", filename);
+   }
 
    test_support_cleanup();
    return 0;
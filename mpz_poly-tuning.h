@@ -24,14 +24,16 @@
    
    (C) 2007 David Harvey
 
-NOTE: the tuning values in this file are for sage.math only.
-TODO: write an automatic tuning utility!!
+The values live in the runtime tuning table, see flint-tuning.h. The 
+mpz_poly-tune program measures them and saves them to a profile file.
 
 */
 
 #ifndef FLINT_MPZ_POLY_TUNING_H
 #define FLINT_MPZ_POLY_TUNING_H
 
+#include "flint-tuning.h"
+
 #ifdef __cplusplus
  extern "C" {
 #endif
@@ -41,8 +43,8 @@ TODO: write an automatic tuning utility!!
    karatsuba should be used when the coefficients have k+1 limbs.
    The number of entries in the table is mpz_poly_kara_crossover_table_size.
 */
-extern unsigned long mpz_poly_kara_crossover_table[];
-extern unsigned long mpz_poly_kara_crossover_table_size;
+#define mpz_poly_kara_crossover_table (flint_tuning.mpz_poly_kara_thresh)
+#define mpz_poly_kara_crossover_table_size (flint_tuning.mpz_poly_kara_thresh_size)
 
 #ifdef __cplusplus
  extern "C" {
@@ -32,6 +32,7 @@ Copyright (C) 2007, William Hart and David Harvey
 #include "mpz_poly-tuning.h"
 #include "fmpz.h"
 #include "fmpz_poly.h"
+#include "mpz_extras.h"
 
 
 /****************************************************************************
@@ -295,20 +296,13 @@ int mpz_poly_from_string(mpz_poly_t poly, const char* s)
    poly->length = 0;
    mpz_poly_ensure_alloc(poly, length);
 
-   unsigned long i;
-   for (i = 0; i < length; i++)
-   {
-      // skip whitespace
-      s += strspn(s, whitespace);
-      
-      if (!gmp_sscanf(s, "%Zd", poly->coeffs[i]))
-         return 0;
-      poly->length++;
-
-      // jump to next whitespace
-      s += strcspn(s, whitespace);
-   }
+   F_mpz_radix_t R;
+   F_mpz_radix_init(R);
+   int ok = F_mpz_radix_vec_set_str(poly->coeffs, length, s, NULL, R);
+   F_mpz_radix_clear(R);
+   if (!ok) return 0;
    
+   poly->length = length;
    mpz_poly_normalise(poly);
    
    return 1;
@@ -328,16 +322,14 @@ char* mpz_poly_to_string(mpz_poly_t poly)
    // write the string
    char* buf = (char*) malloc(size);
    char* ptr = buf + sprintf(buf, "%ld  ", poly->length);
-   for (i = 0; i < poly->length; i++)
+   if (poly->length)
    {
-      mpz_get_str(ptr, 10, poly->coeffs[i]);
-      ptr += strlen(ptr);
-      *ptr = ' ';
-      ptr++;
-   }
-   
-   ptr--;
-   *ptr = 0;
+      F_mpz_radix_t R;
+      F_mpz_radix_init(R);
+      F_mpz_radix_vec_get_str(ptr, poly->coeffs, poly->length, R);
+      F_mpz_radix_clear(R);
+   } else
+      ptr[-1] = 0;
    
    return buf;
 }
@@ -505,9 +497,13 @@ char* mpz_poly_to_string_pretty(mpz_poly_t poly, const char * x)
 
 void mpz_poly_fprint(mpz_poly_t poly, FILE* f)
 {
-   char* s = mpz_poly_to_string(poly);
-   fputs(s, f);
-   free(s);
+   // written a block of coefficients at a time, in the format of mpz_poly_to_string
+   fprintf(f, poly->length ? "%ld  " : "%ld ", poly->length);
+   
+   F_mpz_radix_t R;
+   F_mpz_radix_init(R);
+   F_mpz_radix_vec_fprint(f, poly->coeffs, poly->length, R);
+   F_mpz_radix_clear(R);
 }
 
 void mpz_poly_fprint_pretty(mpz_poly_t poly, FILE* f, const char * x)
@@ -540,14 +536,13 @@ int mpz_poly_fread(mpz_poly_t poly, FILE* f)
    mpz_poly_ensure_alloc(poly, length);
 
    // read coefficients
-   unsigned long i;
-   for (i = 0; i < length; i++)
-   {
-      if (!mpz_inp_str(poly->coeffs[i], f, 10))
-         return 0;
-      poly->length++;
-   }
-
+   F_mpz_radix_t R;
+   F_mpz_radix_init(R);
+   int ok = F_mpz_radix_vec_fread(poly->coeffs, length, f, R);
+   F_mpz_radix_clear(R);
+   if (!ok) return 0;
+   
+   poly->length = length;
    mpz_poly_normalise(poly);
    
    return 1;
@@ -237,6 +237,70 @@ int test_pv_set_bits()
 	return result;
 }
 
+int test_pv_get_set_vec()
+{
+   int result = 1;
+	pv_s pv;
+   mp_limb_t * vec, * vec2, * vec3;
+	ulong temp, i;
+
+   ulong count1;
+   for (count1 = 0; (count1 < 20000*ITER) && (result == 1); count1++)
+	{
+      ulong bits = z_randint(FLINT_BITS) + 1;
+		ulong length = z_randint(1000) + 1;
+		ulong start = z_randint(length);
+		ulong n = z_randint(length - start + 1);
+		
+		vec = (mp_limb_t *) flint_heap_alloc(length);
+		vec2 = (mp_limb_t *) flint_heap_alloc(length);
+		vec3 = (mp_limb_t *) flint_heap_alloc(length);
+		randarray(vec, length, bits);
+		randarray(vec2, length, bits);
+
+      pv_init(&pv, length, pv_bit_fit(bits));
+
+		pv_iter_s iter;
+		PV_ITER_INIT(iter, pv, 0);
+
+		for (i = 0; i < length; i++)
+		{
+			PV_SET_NEXT(iter, vec[i]);
+		}
+
+		pv_set_vec(&pv, start, vec2, n);
+		for (i = start; i < start + n; i++)
+			vec[i] = vec2[i - start];
+
+		PV_ITER_INIT(iter, pv, 0);
+
+		for (i = 0; (i < length) && (result == 1); i++)
+		{
+			PV_GET_NEXT(temp, iter);
+			result = (temp == vec[i]);
+		}
+      
+		if (result)
+		{
+			pv_get_vec(vec3, &pv, start, n);
+			for (i = 0; (i < n) && (result == 1); i++)
+				result = (vec3[i] == vec2[i]);
+		}
+
+		if (!result)
+		{
+			printf("bits = %ld, length = %ld, start = %ld, n = %ld\n", bits, length, start, n);
+		}
+
+		pv_clear(&pv);
+		flint_heap_free(vec3);
+		flint_heap_free(vec2);
+		flint_heap_free(vec);
+	}
+
+	return result;
+}
+
 void zmod_poly_test_all()
 {
    int success, all_success = 1;
@@ -245,6 +309,7 @@ void zmod_poly_test_all()
    RUN_TEST(PV_GET_SET_PREV); 
    RUN_TEST(PV_GET_SET_ENTRY); 
    RUN_TEST(pv_set_bits); 
+   RUN_TEST(pv_get_set_vec); 
 
    printf(all_success ? "\nAll tests passed\n" :
                         "\nAt least one test FAILED!\n");
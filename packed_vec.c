@@ -46,8 +46,8 @@ void pv_init(pv_s * vec, ulong entries, int bits)
 		vec->log_bits = FLINT_BIT_COUNT(bits) - 1;
 		vec->pack = FLINT_BITS/bits;
 		vec->log_pack = FLINT_BIT_COUNT(vec->pack) - 1;
-		vec->length = 0;
 #endif
+		vec->length = 0;
 	} else
 	{
 		vec->entries = NULL;
@@ -97,93 +97,86 @@ void pv_realloc(pv_s * vec, ulong entries)
             vec->entries = (mp_limb_t *) flint_heap_alloc(limbs);
 
 		   vec->alloc = (limbs*FLINT_BITS)/vec->bits;
-		}
+		} else vec->alloc = entries;
+
+		if (vec->length > vec->alloc) vec->length = vec->alloc;
 	} else
 	{
 		if (vec->entries) flint_heap_free(vec->entries);
 		vec->entries = NULL;
 		vec->alloc = 0;
+		vec->length = 0;
 	}
 }
 
+/*
+   Entries are converted this many at a time by pv_set_bits.
+*/
+#define PV_BLOCK 256
+
 void pv_set_bits(pv_s * vec, int bits)
 {
 	if (bits == vec->bits) return; // nothing to do
 
-	if (bits == FLINT_BITS)
-	{
-		pv_iter_s iter;
-      PV_ITER_INIT(iter, *vec, 0);
-
-		mp_limb_t * temp = (mp_limb_t *) flint_heap_alloc(vec->alloc);
-
-		ulong i;
-		for (i = 0; i < vec->length; i++)
-		   PV_GET_NEXT(temp[i], iter);
-
-		if (vec->entries) flint_heap_free(vec->entries);
-		vec->entries = temp;
-		vec->alloc = vec->alloc;
+	pv_s old = *vec;
+	ulong temp[PV_BLOCK];
 
-		vec->bits = bits;
-#if BIT_FIDDLE
-		vec->log_bits = FLINT_LG_BITS_PER_LIMB;
-		vec->pack = 1;
-		vec->log_pack = 0;
-#endif
-	} else if (vec->bits == FLINT_BITS)
-	{ 
-		mp_limb_t * temp = vec->entries;
-			
+	if (vec->alloc)
+	{
 		ulong limbs = (vec->alloc*bits - 1)/FLINT_BITS + 1;
 		vec->entries = (mp_limb_t *) flint_heap_alloc(limbs);
       vec->alloc = (limbs*FLINT_BITS)/bits;
+	} else vec->entries = NULL;
 
-		vec->bits = bits;
+	vec->bits = bits;
 #if BIT_FIDDLE
-		vec->log_bits = FLINT_BIT_COUNT(bits) - 1;
-		vec->pack = FLINT_BITS/bits;
-		vec->log_pack = FLINT_BIT_COUNT(vec->pack) - 1;
+	vec->log_bits = FLINT_BIT_COUNT(bits) - 1;
+	vec->pack = FLINT_BITS/bits;
+	vec->log_pack = FLINT_BIT_COUNT(vec->pack) - 1;
 #endif
-      
-		pv_iter_s iter;
-      PV_ITER_INIT(iter, *vec, 0);
 
-		ulong i;
-		for (i = 0; i < vec->length; i++)
-		{
-			PV_SET_NEXT(iter, temp[i]);
-		}
-		
-		flint_heap_free(temp);
-	} else
+	ulong i, n;
+	for (i = 0; i < vec->length; i += n)
 	{
-		pv_iter_s iter1, iter2;
-		PV_ITER_INIT(iter1, *vec, 0);
+		n = FLINT_MIN(PV_BLOCK, vec->length - i);
+		pv_get_vec(temp, &old, i, n);
+		pv_set_vec(vec, i, temp, n);
+	}
+	
+	if (old.entries) flint_heap_free(old.entries);
+}
 
-		ulong limbs = (vec->alloc*bits - 1)/FLINT_BITS + 1;
-		vec->entries = (mp_limb_t *) flint_heap_alloc(limbs);
-      vec->alloc = (limbs*FLINT_BITS)/bits;
+/*
+   In both representations the entries are stored as consecutive fields of 
+	bits bits in an array of limbs, least significant first on the 
+	little-endian machines FLINT supports, so the mpn bit packing routines 
+	can be used.
+*/
 
-		vec->bits = bits;
-#if BIT_FIDDLE
-		vec->log_bits = FLINT_BIT_COUNT(bits) - 1;
-		vec->pack = FLINT_BITS/bits;
-		vec->log_pack = FLINT_BIT_COUNT(vec->pack) - 1;
-#endif
-		PV_ITER_INIT(iter2, *vec, 0);
-     
-      ulong temp;
-		
-		ulong i;
-		for (i = 0; i < vec->length; i++)
-		{   
-			PV_GET_NEXT(temp, iter1);
-			PV_SET_NEXT(iter2, temp);
-		}
-      
-		if (vec->entries) flint_heap_free(iter1.entries);
-	}
+void pv_get_vec(ulong * res, const pv_s * vec, ulong start, ulong n)
+{
+	ulong pos = start*vec->bits;
+	
+	F_mpn_bit_unpack(res, vec->entries + pos/FLINT_BITS, n, vec->bits, pos%FLINT_BITS);
+}
+
+void pv_set_vec(pv_s * vec, ulong start, const ulong * op, ulong n)
+{
+	if (n == 0) return;
+	
+	ulong pos = start*vec->bits;
+	mp_limb_t * entries = vec->entries + pos/FLINT_BITS;
+	ulong k = pos%FLINT_BITS;
+	ulong end = (k + n*vec->bits)%FLINT_BITS;
+	ulong last = (k + n*vec->bits - 1)/FLINT_BITS;
+	mp_limb_t high = 0L;
+	
+	// the entries following the last one set must be preserved
+	if (end) high = entries[last] & (-1UL << end);
+	
+	F_mpn_bit_pack(entries, op, n, vec->bits, k);
+
+	entries[last] |= high;
 }
 
 
@@ -432,7 +432,7 @@ void pv_stack_init(pv_s * vec, ulong entries, int bits);
 
 /*
    Reallocate the packed vector pointed to by vec to have space for at least the
-	given number of entries.
+	given number of entries. The length is truncated to the new allocation.
 */
 
 void pv_realloc(pv_s * vec, ulong entries);
@@ -485,6 +485,21 @@ void pv_stack_clear(pv_s * vec)
 
 void pv_set_bits(pv_s * vec, int bits);
 
+/*
+   Set res[i] to entry start + i of the given packed vector for 
+	0 <= i < n.
+*/
+
+void pv_get_vec(ulong * res, const pv_s * vec, ulong start, ulong n);
+
+/*
+   Set entry start + i of the given packed vector to op[i] for 
+	0 <= i < n. Each op[i] must fit into the number of bits per entry. 
+	The other entries of the vector are not changed.
+*/
+
+void pv_set_vec(pv_s * vec, ulong start, const ulong * op, ulong n);
+
 #ifdef __cplusplus
  }
 #endif
@@ -0,0 +1,396 @@
+/*============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+===============================================================================*/
+/****************************************************************************
+
+qexp-test.c: Test code for qexp.c and qexp.h
+
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "flint.h"
+#include "long_extras.h"
+#include "F_mpz.h"
+#include "theta.h"
+#include "qexp.h"
+#include "memory-manager.h"
+#include "test-support.h"
+
+#define ITER 1 // if you want all tests to run longer, increase this
+
+/*
+   A generator whose coefficients are pseudo-random functions of their index,
+   of absolute value less than 2^bits.
+*/
+typedef struct
+{
+   ulong seed;
+   ulong bits;
+} qexp_test_rand;
+
+void qexp_gen_rand(long * out, ulong start, ulong len, void * arg)
+{
+   qexp_test_rand * r = (qexp_test_rand *) arg;
+   ulong i;
+
+   for (i = 0; i < len; i++)
+   {
+      ulong x = (start + i)*0x9E3779B97F4A7C15UL + r->seed;
+      x = (x ^ (x >> 30))*0xBF58476D1CE4E5B9UL;
+      x = (x ^ (x >> 27))*0x94D049BB133111EBUL;
+      x ^= (x >> 31);
+
+      long c = (long) (x >> (FLINT_BITS - r->bits));
+      out[i] = (x & 1) ? -c : c;
+   }
+}
+
+/*
+   Collects the coefficients passed to a block callback as mpz_t's.
+*/
+typedef struct
+{
+   mpz_t * coeffs;
+   ulong next; // the start of the next block expected
+   int ok;
+} qexp_test_collect;
+
+void qexp_test_collect_fn(const F_mpz * coeffs, ulong start, ulong len, void * arg)
+{
+   qexp_test_collect * c = (qexp_test_collect *) arg;
+   ulong i;
+
+   if (start != c->next) c->ok = 0;
+   c->next = start + len;
+
+   for (i = 0; i < len; i++)
+      F_mpz_get_mpz(c->coeffs[start + i], coeffs + i);
+}
+
+/*
+   Products are computed by several threads when FLINT is built with OpenMP.
+   The tests of products use between 1 and 4 threads, whatever the number 
+   of cores.
+*/
+void set_num_threads(int threads)
+{
+#ifdef _OPENMP
+   omp_set_num_threads(threads);
+#endif
+}
+
+int get_max_threads(void)
+{
+#ifdef _OPENMP
+   return omp_get_max_threads();
+#else
+   return 1;
+#endif
+}
+
+int test_qexp_gen_jacobi()
+{
+   int result = 1;
+   ulong count, n, i, j, start, len;
+
+   for (count = 0; (count < 1000*ITER) && (result == 1); count++)
+   {
+      n = z_randint(300) + 1;
+
+      // prod_{k >= 1} (1 - q^k)^3 computed naively
+      long * prod = (long *) flint_heap_alloc(n);
+      long * sqr = (long *) flint_heap_alloc(n);
+      long * out = (long *) flint_heap_alloc(n);
+
+      for (i = 0; i < n; i++)
+         prod[i] = (i == 0);
+      ulong k, e;
+      for (k = 1; k < n; k++)
+         for (e = 0; e < 3; e++)
+            for (i = n - 1; i >= k; i--)
+               prod[i] -= prod[i - k];
+
+      for (i = 0; i < n; i++)
+      {
+         sqr[i] = 0;
+         for (j = 0; j <= i; j++)
+            sqr[i] += prod[j]*prod[i - j];
+      }
+
+      start = z_randint(n);
+      len = z_randint(n - start) + 1;
+
+      qexp_gen_jacobi(out, start, len, NULL);
+      for (i = 0; (i < len) && result; i++)
+         result = (out[i] == prod[start + i]);
+
+      qexp_gen_jacobi_sqr(out, start, len, NULL);
+      for (i = 0; (i < len) && result; i++)
+         result = (out[i] == sqr[start + i]);
+
+      if (!result) printf("Error: n = %ld, start = %ld, len = %ld\n", n, start, len);
+
+      flint_heap_free(prod);
+      flint_heap_free(sqr);
+      flint_heap_free(out);
+   }
+
+   return result;
+}
+
+int test_qexp_mul_stream()
+{
+   int result = 1;
+   ulong count, n, block, i, j;
+   qexp_ctx_t ctx;
+   qexp_series_t f, g;
+   qexp_test_rand r1, r2;
+   qexp_test_collect c;
+   int max_threads = get_max_threads();
+
+   for (count = 0; (count < 100*ITER) && (result == 1); count++)
+   {
+      set_num_threads(z_randint(4) + 1);
+
+      n = z_randint(200) + 1;
+      block = z_randint(n + 10) + 1;
+      r1.seed = z_randbits(FLINT_BITS);
+      r2.seed = z_randbits(FLINT_BITS);
+      r1.bits = z_randint(FLINT_BITS - 2) + 1;
+      r2.bits = z_randint(FLINT_BITS - 2) + 1;
+
+      long * a = (long *) flint_heap_alloc(n);
+      long * b = (long *) flint_heap_alloc(n);
+      mpz_t * prod = (mpz_t *) malloc(sizeof(mpz_t)*n);
+      c.coeffs = (mpz_t *) malloc(sizeof(mpz_t)*n);
+      for (i = 0; i < n; i++)
+      {
+         mpz_init(prod[i]);
+         mpz_init(c.coeffs[i]);
+      }
+
+      qexp_gen_rand(a, 0, n, &r1);
+      qexp_gen_rand(b, 0, n, &r2);
+
+      mpz_t t;
+      mpz_init(t);
+      for (i = 0; i < n; i++)
+         for (j = 0; i + j < n; j++)
+         {
+            mpz_set_si(t, a[i]);
+            mpz_mul_si(t, t, b[j]);
+            mpz_add(prod[i + j], prod[i + j], t);
+         }
+      mpz_clear(t);
+
+      qexp_ctx_init(ctx, n, block, r1.bits + r2.bits + FLINT_BIT_COUNT(n));
+      qexp_series_init_gen(f, qexp_gen_rand, &r1);
+      qexp_series_init_gen(g, qexp_gen_rand, &r2);
+
+      c.next = 0;
+      c.ok = 1;
+      qexp_mul_stream(qexp_test_collect_fn, &c, f, g, ctx);
+
+      result = (c.ok && c.next == n);
+      for (i = 0; (i < n) && result; i++)
+         result = (mpz_cmp(prod[i], c.coeffs[i]) == 0);
+
+      if (!result) printf("Error: n = %ld, block = %ld, i = %ld\n", n, block, i);
+
+      qexp_series_clear(f);
+      qexp_series_clear(g);
+      qexp_ctx_clear(ctx);
+
+      for (i = 0; i < n; i++)
+      {
+         mpz_clear(prod[i]);
+         mpz_clear(c.coeffs[i]);
+      }
+      free(prod);
+      free(c.coeffs);
+      flint_heap_free(a);
+      flint_heap_free(b);
+   }
+
+   set_num_threads(max_threads);
+
+   return result;
+}
+
+int test_qexp_mul_file()
+{
+   int result = 1;
+   ulong count, n, block, i;
+   qexp_ctx_t ctx;
+   qexp_series_t theta1, theta2, file1, file2;
+   qexp_series_fn fn = theta;
+   qexp_test_collect c;
+   int max_threads = get_max_threads();
+
+   for (count = 0; (count < 20*ITER) && (result == 1); count++)
+   {
+      set_num_threads(z_randint(4) + 1);
+
+      n = z_randint(1000) + 1;
+      block = z_randint(n + 10) + 1;
+
+      long * t4 = (long *) flint_heap_alloc(n);
+      c.coeffs = (mpz_t *) malloc(sizeof(mpz_t)*n);
+      for (i = 0; i < n; i++)
+         mpz_init(c.coeffs[i]);
+
+      // theta^4 gives the number of representations as a sum of four
+      // squares, which is 8 times the sum of the divisors of m not divisible
+      // by 4
+      ulong m, d;
+      t4[0] = 1;
+      for (m = 1; m < n; m++)
+      {
+         t4[m] = 0;
+         for (d = 1; d <= m; d++)
+            if ((m % d) == 0 && (d % 4) != 0) t4[m] += 8*d;
+      }
+
+      FILE * f1 = tmpfile();
+      FILE * f2 = tmpfile();
+
+      qexp_ctx_init(ctx, n, block, FLINT_BIT_COUNT(n) + 8);
+      qexp_series_init_gen(theta1, qexp_gen_series, &fn);
+      qexp_series_init_gen(theta2, qexp_gen_series, &fn);
+      qexp_series_init_file(file1, f1);
+      qexp_series_init_file(file2, f2);
+
+      qexp_mul(file1, theta1, theta2, ctx); // theta^2 on disk
+      qexp_mul(file2, file1, file1, ctx);   // theta^4 on disk
+
+      c.next = 0;
+      c.ok = 1;
+      qexp_stream(qexp_test_collect_fn, &c, file2, ctx);
+
+      result = (c.ok && c.next == n);
+      for (i = 0; (i < n) && result; i++)
+         result = (mpz_cmp_si(c.coeffs[i], t4[i]) == 0);
+
+      if (!result) printf("Error: n = %ld, block = %ld, i = %ld\n", n, block, i);
+
+      qexp_series_clear(theta1);
+      qexp_series_clear(theta2);
+      qexp_series_clear(file1);
+      qexp_series_clear(file2);
+      qexp_ctx_clear(ctx);
+
+      fclose(f1);
+      fclose(f2);
+
+      for (i = 0; i < n; i++)
+         mpz_clear(c.coeffs[i]);
+      free(c.coeffs);
+      flint_heap_free(t4);
+   }
+
+   set_num_threads(max_threads);
+
+   return result;
+}
+
+int test_qexp_delta()
+{
+   int result = 1;
+   ulong n = 1000, i;
+   qexp_ctx_t ctx;
+   qexp_series_t F2, F4;
+   qexp_test_collect c;
+
+   // Ramanujan's tau(m) for 1 <= m <= 10, the coefficients of Delta = q F^8
+   long tau[] = {1, -24, 252, -1472, 4830, -6048, -16744, 84480, -113643, -115920};
+
+   c.coeffs = (mpz_t *) malloc(sizeof(mpz_t)*n);
+   for (i = 0; i < n; i++)
+      mpz_init(c.coeffs[i]);
+
+   FILE * f4 = tmpfile();
+
+   qexp_ctx_init(ctx, n, 128, 8*FLINT_BIT_COUNT(4*n + 4) + 1);
+   qexp_series_init_gen(F2, qexp_gen_jacobi_sqr, NULL);
+   qexp_series_init_file(F4, f4);
+
+   qexp_mul(F4, F2, F2, ctx);
+
+   c.next = 0;
+   c.ok = 1;
+   qexp_mul_stream(qexp_test_collect_fn, &c, F4, F4, ctx);
+
+   result = (c.ok && c.next == n);
+   for (i = 0; (i < 10) && result; i++)
+      result = (mpz_cmp_si(c.coeffs[i], tau[i]) == 0);
+
+   // multiplicativity tau(mn) = tau(m) tau(n) for coprime m, n
+   mpz_t t;
+   mpz_init(t);
+   ulong a, b;
+   for (a = 2; (a < 30) && result; a++)
+      for (b = 2; (a*b <= n) && result; b++)
+         if (z_gcd(a, b) == 1)
+         {
+            mpz_mul(t, c.coeffs[a - 1], c.coeffs[b - 1]);
+            result = (mpz_cmp(t, c.coeffs[a*b - 1]) == 0);
+         }
+   mpz_clear(t);
+
+   if (!result) printf("Error: i = %ld\n", i);
+
+   qexp_series_clear(F2);
+   qexp_series_clear(F4);
+   qexp_ctx_clear(ctx);
+   fclose(f4);
+
+   for (i = 0; i < n; i++)
+      mpz_clear(c.coeffs[i]);
+   free(c.coeffs);
+
+   return result;
+}
+
+void qexp_test_all()
+{
+   int success, all_success = 1;
+   printf("FLINT_BITS = %d\n", FLINT_BITS);
+
+   RUN_TEST(qexp_gen_jacobi);
+   RUN_TEST(qexp_mul_stream);
+   RUN_TEST(qexp_mul_file);
+   RUN_TEST(qexp_delta);
+
+   printf(all_success ? "\nAll tests passed\n" :
+                        "\nAt least one test FAILED!\n");
+}
+
+int main()
+{
+   test_support_init();
+   qexp_test_all();
+   test_support_cleanup();
+
+   flint_stack_cleanup();
+   _F_mpz_cleanup();
+
+   return 0;
+}
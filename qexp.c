@@ -0,0 +1,477 @@
+/*============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+===============================================================================*/
+/*****************************************************************************
+
+   qexp.c: Streaming computation of truncated products of q-expansions
+
+*****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+
+#include "flint.h"
+#include "long_extras.h"
+#include "F_mpz.h"
+#include "qexp.h"
+#include "zn_poly/src/zn_poly.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*
+   Series stored in a file are kept as residues, block by block. Within
+   block b the residues of its coefficients modulo primes[i] occupy the
+   ctx->block limbs starting at limb (b*num_primes + i)*ctx->block.
+*/
+
+/*============================================================================
+
+   Context and series
+
+=============================================================================*/
+
+void qexp_ctx_init(qexp_ctx_t ctx, ulong length, ulong block, ulong bits)
+{
+   ulong i;
+
+   ctx->length = length;
+   ctx->block = block;
+   ctx->num_blocks = (length + block - 1)/block;
+
+   // the primes have at least FLINT_BITS - 2 bits, and we need a product
+   // of more than 2^(bits + 1) to recover signed coefficients
+   ctx->num_primes = (bits + 1)/(FLINT_BITS - 2) + 1;
+   ctx->primes = (ulong *) flint_heap_alloc(ctx->num_primes);
+
+   ulong p = z_nextprime((1UL << (FLINT_BITS-1)) - 10000000L, 0);
+   for (i = 0; i < ctx->num_primes; i++)
+   {
+      ctx->primes[i] = p;
+      p = z_nextprime(p, 0);
+   }
+
+   F_mpz_comb_init(ctx->comb, ctx->primes, ctx->num_primes);
+}
+
+void qexp_ctx_clear(qexp_ctx_t ctx)
+{
+   F_mpz_comb_clear(ctx->comb);
+   flint_heap_free(ctx->primes);
+}
+
+void qexp_series_init_gen(qexp_series_t series, qexp_gen_fn gen, void * arg)
+{
+   series->type = QEXP_GEN;
+   series->gen = gen;
+   series->arg = arg;
+   series->file = NULL;
+}
+
+void qexp_series_init_file(qexp_series_t series, FILE * file)
+{
+   series->type = QEXP_FILE;
+   series->gen = NULL;
+   series->arg = NULL;
+   series->file = file;
+}
+
+void qexp_series_clear(qexp_series_t series)
+{
+   series->gen = NULL;
+   series->file = NULL;
+}
+
+/*============================================================================
+
+   Generators
+
+=============================================================================*/
+
+void qexp_gen_series(long * out, ulong start, ulong len, void * arg)
+{
+   (*((qexp_series_fn *) arg))(out, start, len);
+}
+
+/*
+   Returns the least i such that i(i+1)/2 >= m.
+*/
+static inline
+ulong __qexp_tri_index(ulong m)
+{
+   ulong i = (z_intsqrt(8*m + 1) - 1)/2;
+
+   while (i*(i + 1)/2 < m) i++;
+   while (i && (i - 1)*i/2 >= m) i--;
+
+   return i;
+}
+
+void qexp_gen_jacobi(long * out, ulong start, ulong len, void * arg)
+{
+   ulong i, t;
+
+   for (i = 0; i < len; i++)
+      out[i] = 0;
+
+   for (i = __qexp_tri_index(start); (t = i*(i + 1)/2) < start + len; i++)
+      out[t - start] = (i & 1) ? -(2*i + 1) : (2*i + 1);
+}
+
+void qexp_gen_jacobi_sqr(long * out, ulong start, ulong len, void * arg)
+{
+   ulong i, j, ti, tj;
+
+   for (i = 0; i < len; i++)
+      out[i] = 0;
+
+   // each pair i, j with T_i + T_j in [start, start + len), T_k = k(k+1)/2
+   for (i = 0; (ti = i*(i + 1)/2) < start + len; i++)
+   {
+      long vi = (i & 1) ? -(2*i + 1) : (2*i + 1);
+
+      j = (ti >= start) ? 0 : __qexp_tri_index(start - ti);
+      for ( ; (tj = j*(j + 1)/2) + ti < start + len; j++)
+         out[ti + tj - start] += vi*((j & 1) ? -(2*j + 1) : (2*j + 1));
+   }
+}
+
+/*============================================================================
+
+   Reading blocks of residues
+
+=============================================================================*/
+
+/*
+   Sets out[0, len) to the residues of the coefficients of q^start, ...,
+   q^(start+len-1) of the file series, modulo the prime with the given index,
+   where start + len <= ctx->num_blocks*ctx->block.
+*/
+static
+void __qexp_read_file(ulong * out, FILE * file, ulong start, ulong len,
+                                                   ulong prime, qexp_ctx_t ctx)
+{
+   ulong B = ctx->block;
+
+   while (len)
+   {
+      ulong b = start/B;
+      ulong off = start - b*B;
+      ulong n = FLINT_MIN(len, B - off);
+      long pos = ((b*ctx->num_primes + prime)*B + off)*sizeof(ulong);
+      ulong read;
+
+#pragma omp critical(qexp_io)
+      {
+         fseek(file, pos, SEEK_SET);
+         read = fread(out, sizeof(ulong), n, file);
+      }
+
+      if (read != n)
+      {
+         printf("FLINT Exception: unable to read series from file\n");
+         abort();
+      }
+
+      out += n;
+      start += n;
+      len -= n;
+   }
+}
+
+/*
+   Sets out[0, len) to the residues of the coefficients of q^start, ...,
+   q^(start+len-1) of op modulo the prime with the given index. Coefficients
+   with negative index or index at least ctx->length are taken to be zero.
+   The array temp must have space for len longs.
+*/
+static
+void __qexp_read(ulong * out, qexp_series_t op, long start, ulong len,
+                                     ulong prime, qexp_ctx_t ctx, long * temp)
+{
+   ulong i, p = ctx->primes[prime];
+
+   // zero pad on the left
+   if (start < 0)
+   {
+      ulong z = FLINT_MIN((ulong) -start, len);
+      for (i = 0; i < z; i++)
+         out[i] = 0;
+      out += z;
+      len -= z;
+      start = 0;
+   }
+
+   // zero pad on the right
+   if ((ulong) start >= ctx->length) i = 0;
+   else i = FLINT_MIN(len, ctx->length - start);
+   for ( ; i < len; i++)
+      out[i] = 0;
+   len = ((ulong) start >= ctx->length) ? 0 : FLINT_MIN(len, ctx->length - start);
+
+   if (len == 0) return;
+
+   if (op->type == QEXP_FILE)
+   {
+      __qexp_read_file(out, op->file, start, len, prime, ctx);
+      return;
+   }
+
+   op->gen(temp, start, len, op->arg);
+
+   for (i = 0; i < len; i++)
+   {
+      if (temp[i] >= 0L) out[i] = ((ulong) temp[i]) % p;
+      else
+      {
+         ulong r = ((ulong) -temp[i]) % p;
+         out[i] = r ? p - r : 0;
+      }
+   }
+}
+
+/*============================================================================
+
+   Products
+
+=============================================================================*/
+
+/*
+   Workspace for one thread: a block of the first input, 2*block - 1
+   coefficients of the second, a middle product and space for a generator.
+*/
+typedef struct
+{
+   ulong * f;
+   ulong * g;
+   ulong * prod;
+   long * temp;
+} __qexp_scratch_struct;
+
+static
+void __qexp_scratch_init(__qexp_scratch_struct * scratch, qexp_ctx_t ctx)
+{
+   ulong B = ctx->block;
+
+   scratch->f = (ulong *) flint_heap_alloc(B);
+   scratch->g = (ulong *) flint_heap_alloc(2*B - 1);
+   scratch->prod = (ulong *) flint_heap_alloc(B);
+   scratch->temp = (long *) flint_heap_alloc(2*B - 1);
+}
+
+static
+void __qexp_scratch_clear(__qexp_scratch_struct * scratch)
+{
+   flint_heap_free(scratch->f);
+   flint_heap_free(scratch->g);
+   flint_heap_free(scratch->prod);
+   flint_heap_free(scratch->temp);
+}
+
+/*
+   Sets out[0, B) to block k of the product of op1 and op2 modulo the prime
+   with the given index, B being the block size. Writing f_i for block i of
+   op1 and g for op2, block k of the product is the sum over i <= k of the
+   middle products of g[(k-i-1)B + 1, (k-i+1)B) by f_i.
+*/
+static
+void __qexp_mul_block(ulong * out, ulong k, ulong prime, qexp_series_t op1,
+         qexp_series_t op2, qexp_ctx_t ctx, __qexp_scratch_struct * scratch)
+{
+   ulong B = ctx->block, i, j;
+   const zn_mod_struct * mod = ctx->comb->mod[prime];
+
+   for (j = 0; j < B; j++)
+      out[j] = 0;
+
+   for (i = 0; i <= k; i++)
+   {
+      __qexp_read(scratch->f, op1, i*B, B, prime, ctx, scratch->temp);
+      __qexp_read(scratch->g, op2, (long) ((k - i)*B) - (long) B + 1, 2*B - 1,
+                                                  prime, ctx, scratch->temp);
+
+      zn_array_mulmid(scratch->prod, scratch->g, 2*B - 1, scratch->f, B, mod);
+
+      for (j = 0; j < B; j++)
+         out[j] = zn_mod_add(out[j], scratch->prod[j], mod);
+   }
+}
+
+/*
+   Number of consecutive output blocks computed at once. There is one task
+   per block and prime, and we want at least one task for each thread.
+*/
+static
+ulong __qexp_window(qexp_ctx_t ctx)
+{
+   ulong threads = 1;
+#ifdef _OPENMP
+   threads = omp_get_max_threads();
+#endif
+   return (threads + ctx->num_primes - 1)/ctx->num_primes;
+}
+
+/*
+   Reconstructs the signed coefficients of blocks k0, ..., k0 + w - 1 from
+   the residues in buf, laid out as in a file, and passes them to fn.
+*/
+static
+void __qexp_stream_blocks(qexp_block_fn fn, void * arg, const ulong * buf,
+             ulong k0, ulong w, F_mpz * coeffs, ulong * residues, qexp_ctx_t ctx)
+{
+   ulong B = ctx->block, np = ctx->num_primes, b, j, i;
+   F_mpz ** comb_temp = F_mpz_comb_temp_init(ctx->comb);
+   F_mpz_t temp, temp2;
+   F_mpz_init(temp);
+   F_mpz_init(temp2);
+
+   for (b = 0; b < w; b++)
+   {
+      ulong start = (k0 + b)*B;
+      ulong len = FLINT_MIN(B, ctx->length - start);
+
+      for (j = 0; j < len; j++)
+      {
+         for (i = 0; i < np; i++)
+            residues[i] = buf[(b*np + i)*B + j];
+         F_mpz_multi_CRT_ui(coeffs + j, residues, ctx->comb, comb_temp, temp, temp2);
+      }
+
+      fn(coeffs, start, len, arg);
+   }
+
+   F_mpz_clear(temp);
+   F_mpz_clear(temp2);
+   F_mpz_comb_temp_free(ctx->comb, comb_temp);
+}
+
+/*
+   Computes the product of op1 and op2 a window of blocks at a time, and
+   either writes each window to res or, if res is NULL, passes the
+   coefficients to fn.
+*/
+static
+void __qexp_mul(qexp_series_t res, qexp_block_fn fn, void * arg,
+                      qexp_series_t op1, qexp_series_t op2, qexp_ctx_t ctx)
+{
+   ulong B = ctx->block, np = ctx->num_primes, k0, i;
+   ulong W = __qexp_window(ctx);
+   ulong * buf = (ulong *) flint_heap_alloc(W*np*B);
+   F_mpz * coeffs = NULL;
+   ulong * residues = NULL;
+
+   if (res == NULL)
+   {
+      coeffs = (F_mpz *) flint_heap_alloc(B);
+      for (i = 0; i < B; i++)
+         F_mpz_init(coeffs + i);
+      residues = (ulong *) flint_heap_alloc(np);
+   }
+
+   for (k0 = 0; k0 < ctx->num_blocks; k0 += W)
+   {
+      ulong w = FLINT_MIN(W, ctx->num_blocks - k0);
+      long tasks = w*np;
+
+#pragma omp parallel
+      {
+         __qexp_scratch_struct scratch;
+         __qexp_scratch_init(&scratch, ctx);
+         long t;
+
+#pragma omp for schedule(dynamic)
+         for (t = 0; t < tasks; t++)
+            __qexp_mul_block(buf + t*B, k0 + t/np, t % np, op1, op2, ctx, &scratch);
+
+         __qexp_scratch_clear(&scratch);
+      }
+
+      if (res == NULL)
+      {
+         __qexp_stream_blocks(fn, arg, buf, k0, w, coeffs, residues, ctx);
+         continue;
+      }
+
+      if (fseek(res->file, (long) (k0*np*B*sizeof(ulong)), SEEK_SET)
+         || fwrite(buf, sizeof(ulong), w*np*B, res->file) != w*np*B)
+      {
+         printf("FLINT Exception: unable to write series to file\n");
+         abort();
+      }
+   }
+
+   if (res != NULL) fflush(res->file);
+   else
+   {
+      for (i = 0; i < B; i++)
+         F_mpz_clear(coeffs + i);
+      flint_heap_free(coeffs);
+      flint_heap_free(residues);
+   }
+
+   flint_heap_free(buf);
+}
+
+void qexp_mul(qexp_series_t res, qexp_series_t op1,
+                                        qexp_series_t op2, qexp_ctx_t ctx)
+{
+   if (res->type != QEXP_FILE || res == op1 || res == op2)
+   {
+      printf("FLINT Exception: output of qexp_mul must be a new file series\n");
+      abort();
+   }
+
+   __qexp_mul(res, NULL, NULL, op1, op2, ctx);
+}
+
+void qexp_mul_stream(qexp_block_fn fn, void * arg,
+                      qexp_series_t op1, qexp_series_t op2, qexp_ctx_t ctx)
+{
+   __qexp_mul(NULL, fn, arg, op1, op2, ctx);
+}
+
+void qexp_stream(qexp_block_fn fn, void * arg, qexp_series_t op, qexp_ctx_t ctx)
+{
+   ulong B = ctx->block, np = ctx->num_primes, b, i;
+   ulong * buf = (ulong *) flint_heap_alloc(np*B);
+   ulong * residues = (ulong *) flint_heap_alloc(np);
+   long * temp = (long *) flint_heap_alloc(B);
+   F_mpz * coeffs = (F_mpz *) flint_heap_alloc(B);
+
+   for (i = 0; i < B; i++)
+      F_mpz_init(coeffs + i);
+
+   for (b = 0; b < ctx->num_blocks; b++)
+   {
+      for (i = 0; i < np; i++)
+         __qexp_read(buf + i*B, op, b*B, B, i, ctx, temp);
+
+      __qexp_stream_blocks(fn, arg, buf, b, 1, coeffs, residues, ctx);
+   }
+
+   for (i = 0; i < B; i++)
+      F_mpz_clear(coeffs + i);
+
+   flint_heap_free(coeffs);
+   flint_heap_free(temp);
+   flint_heap_free(residues);
+   flint_heap_free(buf);
+}
@@ -0,0 +1,208 @@
+/*============================================================================
+
+    This file is part of FLINT.
+
+    FLINT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    FLINT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FLINT; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301 USA
+
+===============================================================================*/
+/*****************************************************************************
+
+   qexp.h: Streaming computation of truncated products of q-expansions
+
+   Series of a fixed length are handled a block of coefficients at a time,
+   either generated on demand or stored on disk as residues modulo a set of
+   primes, so that the memory used depends only on the block size.
+
+   The price is paid in time. Block k of a product needs a middle product
+   with each of the blocks 0, ..., k of the first input, so a product of 
+   N terms in blocks of B takes (N/B)(N/B + 1)/2 middle products of B by 
+   2B - 1 coefficients for each prime, i.e. O((N/B)^2 M(B)), against 
+   O(M(N)) for a product done in memory. The inputs are also generated or 
+   read from disk about N/B times over. The block size should therefore be 
+   as large as memory allows.
+
+*****************************************************************************/
+
+#ifndef _QEXP_H_
+#define _QEXP_H_
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+#include <stdio.h>
+#include <gmp.h>
+
+#include "flint.h"
+#include "F_mpz.h"
+#include "zn_poly/src/zn_poly.h"
+
+/*
+   A generator sets out[i] to the coefficient of q^(start + i) for
+   0 <= i < len. It may be called by several threads at once.
+*/
+typedef void (*qexp_gen_fn)(long * out, ulong start, ulong len, void * arg);
+
+/*
+   A block callback receives the coefficients of q^start, ..., q^(start+len-1).
+   Blocks are passed in order, by one thread.
+*/
+typedef void (*qexp_block_fn)(const F_mpz * coeffs, ulong start, ulong len, void * arg);
+
+/*
+   Functions such as theta and theta_2d, which can be turned into generators
+   by qexp_gen_series.
+*/
+typedef void (*qexp_series_fn)(long * out, ulong start, ulong len);
+
+typedef struct
+{
+   ulong length;     // coefficients of q^0, ..., q^(length-1) are computed
+   ulong block;      // number of coefficients in a block
+   ulong num_blocks; // ceil(length/block)
+   ulong num_primes;
+   ulong * primes;
+   F_mpz_comb_t comb;
+} qexp_ctx_struct;
+
+typedef qexp_ctx_struct qexp_ctx_t[1];
+
+#define QEXP_GEN 0  // coefficients produced on demand by a generator
+#define QEXP_FILE 1 // residues stored in a file
+
+typedef struct
+{
+   int type;
+   qexp_gen_fn gen;
+   void * arg;
+   FILE * file;
+} qexp_series_struct;
+
+typedef qexp_series_struct qexp_series_t[1];
+
+/*============================================================================
+
+   Context and series
+
+=============================================================================*/
+
+/**
+   \fn     void qexp_ctx_init(qexp_ctx_t ctx, ulong length, ulong block,
+                                                                  ulong bits)
+   \brief  Initialise a context for series of the given length, processed in
+           blocks of the given number of coefficients. All coefficients of
+           all series used with the context must be less than 2^bits in
+           absolute value.
+*/
+void qexp_ctx_init(qexp_ctx_t ctx, ulong length, ulong block, ulong bits);
+
+/**
+   \fn     void qexp_ctx_clear(qexp_ctx_t ctx)
+   \brief  Release the memory used by the context.
+*/
+void qexp_ctx_clear(qexp_ctx_t ctx);
+
+/**
+   \fn     void qexp_series_init_gen(qexp_series_t series, qexp_gen_fn gen,
+                                                                void * arg)
+   \brief  Initialise a series whose coefficients are produced by gen.
+*/
+void qexp_series_init_gen(qexp_series_t series, qexp_gen_fn gen, void * arg);
+
+/**
+   \fn     void qexp_series_init_file(qexp_series_t series, FILE * file)
+   \brief  Initialise a series stored in the given file, which must be open
+           for reading and writing in binary mode. The series has no
+           coefficients until it is written by qexp_mul.
+*/
+void qexp_series_init_file(qexp_series_t series, FILE * file);
+
+/**
+   \fn     void qexp_series_clear(qexp_series_t series)
+   \brief  Release the series. A file is not closed.
+*/
+void qexp_series_clear(qexp_series_t series);
+
+/*============================================================================
+
+   Generators
+
+=============================================================================*/
+
+/**
+   \fn     void qexp_gen_series(long * out, ulong start, ulong len, void * arg)
+   \brief  Generator for the series computed by the function of type
+           qexp_series_fn pointed to by arg, e.g. theta or theta_2d.
+*/
+void qexp_gen_series(long * out, ulong start, ulong len, void * arg);
+
+/**
+   \fn     void qexp_gen_jacobi(long * out, ulong start, ulong len, void * arg)
+   \brief  Generator for prod_{n >= 1} (1 - q^n)^3, which by Jacobi's
+           identity is sum_{i >= 0} (-1)^i (2i + 1) q^(i(i+1)/2). The
+           argument is ignored.
+*/
+void qexp_gen_jacobi(long * out, ulong start, ulong len, void * arg);
+
+/**
+   \fn     void qexp_gen_jacobi_sqr(long * out, ulong start, ulong len,
+                                                                void * arg)
+   \brief  Generator for the square of the series of qexp_gen_jacobi,
+           computed directly from its sparse representation. The argument
+           is ignored.
+*/
+void qexp_gen_jacobi_sqr(long * out, ulong start, ulong len, void * arg);
+
+/*============================================================================
+
+   Products
+
+=============================================================================*/
+
+/**
+   \fn     void qexp_mul(qexp_series_t res, qexp_series_t op1,
+                                       qexp_series_t op2, qexp_ctx_t ctx)
+   \brief  Writes the product of op1 and op2, truncated to ctx->length
+           terms, to the file series res, which must not be one of the
+           inputs. This takes O((N/B)^2) middle products of blocks, see 
+           above. Output blocks are computed in parallel if FLINT is built
+           with OpenMP (make FLINT_OPENMP=1).
+*/
+void qexp_mul(qexp_series_t res, qexp_series_t op1,
+                                        qexp_series_t op2, qexp_ctx_t ctx);
+
+/**
+   \fn     void qexp_mul_stream(qexp_block_fn fn, void * arg,
+                     qexp_series_t op1, qexp_series_t op2, qexp_ctx_t ctx)
+   \brief  As for qexp_mul, but passes the coefficients of the product to fn,
+           one block at a time, instead of writing them to a file.
+*/
+void qexp_mul_stream(qexp_block_fn fn, void * arg,
+                      qexp_series_t op1, qexp_series_t op2, qexp_ctx_t ctx);
+
+/**
+   \fn     void qexp_stream(qexp_block_fn fn, void * arg, qexp_series_t op,
+                                                              qexp_ctx_t ctx)
+   \brief  Passes the coefficients of op to fn, one block at a time.
+*/
+void qexp_stream(qexp_block_fn fn, void * arg, qexp_series_t op, qexp_ctx_t ctx);
+
+#ifdef __cplusplus
+ }
+#endif
+
+#endif
+
+// *************** end of file
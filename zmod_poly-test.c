@@ -388,6 +388,75 @@ int test_zmod_poly_fprint_fread()
    return result; 
 }
   
+int test_zmod_poly_fwrite_bin()
+{
+   zmod_poly_t poly, poly2, poly3, poly4;
+   F_mpn_map_t map;
+   int result = 1;
+   unsigned long bits, length;
+	
+   unsigned long count1;
+   for (count1 = 0; (count1 < 5000) && (result == 1) ; count1++)
+   {
+      bits = randint(FLINT_BITS-1)+2;
+      unsigned long modulus;
+      
+      do {modulus = randbits(bits);} while (modulus < 2);
+      
+      zmod_poly_init(poly, modulus);
+      
+      length = randint(100);
+
+#if DEBUG
+      printf("length = %ld, bits = %ld\n", length, bits);
+#endif
+
+      randpoly(poly, length, modulus); 
+                
+      FILE * file = fopen("tmp", "w+b");
+		result = zmod_poly_fwrite_bin(poly, file);
+		fflush(file);
+      rewind(file);
+		result &= zmod_poly_fread_bin(poly2, file);
+		fclose(file);
+           
+      result &= zmod_poly_equal(poly2, poly) && (poly2->p == poly->p);
+
+      // attach the file without copying
+      if (result) result = F_mpn_map_init(map, "tmp");
+      if (result)
+      {
+         result = zmod_poly_attach_map(poly3, map);
+         if (result) result = zmod_poly_equal(poly3, poly) && (poly3->p == poly->p);
+         
+         // a product computed from the attached polynomial
+         if (result)
+         {
+            zmod_poly_init(poly4, modulus);
+            zmod_poly_mul(poly2, poly3, poly3);
+            zmod_poly_mul(poly4, poly, poly);
+            result = zmod_poly_equal(poly2, poly4);
+            zmod_poly_clear(poly4);
+         }
+
+         F_mpn_map_clear(map);
+      }
+
+		if (!result)
+		{
+			zmod_poly_print(poly); printf("\n\n");
+         zmod_poly_print(poly2); printf("\n\n");
+		}
+      
+      zmod_poly_clear(poly);
+      zmod_poly_clear(poly2);
+   }
+
+   remove("tmp");
+         
+   return result; 
+}
+  
 int test_zmod_poly_addsub()
 {
    int result = 1;
@@ -8600,6 +8669,147 @@ int test_zmod_poly_2x2_mat_mul()
    return result;
 }
 
+int test_zmod_poly_2x2_mat_mul_transform()
+{
+   int result = 1;
+   zmod_poly_2x2_mat_t A, B, R1, R2;
+   unsigned long bits;
+   
+   unsigned long count1;
+   for (count1 = 0; (count1 < 100) && (result == 1); count1++)
+   {
+      bits = randint(FLINT_BITS-2)+2;
+      unsigned long modulus;
+      
+      do {modulus = randbits(bits);} while (modulus < 2);
+      
+      zmod_poly_2x2_mat_init(A, modulus);
+      zmod_poly_2x2_mat_init(B, modulus);
+      zmod_poly_2x2_mat_init(R1, modulus);
+      zmod_poly_2x2_mat_init(R2, modulus);
+      
+      unsigned long count2;
+      for (count2 = 0; (count2 < 10) && (result == 1); count2++)
+      {
+         // occasionally make the lengths large enough for the FFT
+         unsigned long length = (count2 == 0) ? randint(8000)+1 : randint(100)+1;
+         
+         randpoly(A->a, randint(length), modulus);
+         randpoly(A->b, randint(length), modulus);
+         randpoly(A->c, randint(length), modulus);
+         randpoly(A->d, randint(length), modulus);
+         
+         randpoly(B->a, randint(length), modulus);
+         randpoly(B->b, randint(length), modulus);
+         randpoly(B->c, randint(length), modulus);
+         randpoly(B->d, randint(length), modulus);
+         
+         zmod_poly_2x2_mat_mul_classical(R1, A, B);
+         if (count2 & 1) 
+         {
+            zmod_poly_2x2_mat_mul_transform(A, A, B);
+            zmod_poly_swap(A->a, R2->a);
+            zmod_poly_swap(A->b, R2->b);
+            zmod_poly_swap(A->c, R2->c);
+            zmod_poly_swap(A->d, R2->d);
+         } else
+            zmod_poly_2x2_mat_mul_transform(R2, A, B);
+
+         result &= zmod_poly_equal(R1->a, R2->a);
+         result &= zmod_poly_equal(R1->b, R2->b);
+         result &= zmod_poly_equal(R1->c, R2->c);
+         result &= zmod_poly_equal(R1->d, R2->d);
+         
+         if (!result)
+         {
+				printf("modulus = %ld, length = %ld\n", modulus, length);
+         }
+      }
+      
+      zmod_poly_2x2_mat_clear(A);
+      zmod_poly_2x2_mat_clear(B);
+      zmod_poly_2x2_mat_clear(R1);
+      zmod_poly_2x2_mat_clear(R2);
+   }
+   
+   return result;
+}
+
+int test_zmod_poly_mat_mul()
+{
+   int result = 1;
+   unsigned long bits, i, j, k;
+   zmod_poly_struct A[9], B[9], C[9], D[9];
+   zmod_poly_t temp;
+   
+   unsigned long count1;
+   for (count1 = 0; (count1 < 2000) && (result == 1); count1++)
+   {
+      bits = randint(FLINT_BITS-2)+2;
+      unsigned long modulus;
+      
+      do {modulus = randbits(bits);} while (modulus < 2);
+      
+      unsigned long r = randint(3)+1;
+      unsigned long s = randint(3)+1;
+      unsigned long t = randint(3)+1;
+      unsigned long length = (count1 % 100 == 0) ? randint(6000)+1 : randint(100)+1;
+
+      zmod_poly_init(temp, modulus);
+      for (i = 0; i < 9; i++)
+      {
+         zmod_poly_init(A + i, modulus);
+         zmod_poly_init(B + i, modulus);
+         zmod_poly_init(C + i, modulus);
+         zmod_poly_init(D + i, modulus);
+      }
+
+      for (i = 0; i < r*s; i++) randpoly(A + i, randint(length), modulus);
+      for (i = 0; i < s*t; i++) randpoly(B + i, randint(length), modulus);
+      
+      for (i = 0; i < r; i++)
+         for (j = 0; j < t; j++)
+         {
+            zmod_poly_zero(D + i*t + j);
+            for (k = 0; k < s; k++)
+            {
+               zmod_poly_mul(temp, A + i*s + k, B + k*t + j);
+               zmod_poly_add(D + i*t + j, D + i*t + j, temp);
+            }
+         }
+      
+      zmod_poly_mat_mul(C, A, B, r, s, t);
+      
+      for (i = 0; i < r*t; i++)
+         result &= zmod_poly_equal(C + i, D + i);
+
+      // check the dot product of the first row and column
+      zmod_poly_t dot;
+      zmod_poly_init(dot, modulus);
+      zmod_poly_struct * col = C + 3; // scratch space for the column of B
+      for (k = 0; k < s; k++) zmod_poly_set(col + k, B + k*t);
+      zmod_poly_dot(dot, A, col, s);
+      result &= zmod_poly_equal(dot, D);
+      zmod_poly_clear(dot);
+
+      if (!result)
+      {
+         printf("modulus = %ld, r = %ld, s = %ld, t = %ld, length = %ld\n", modulus, r, s, t, length);
+      }
+      
+      for (i = 0; i < 9; i++)
+      {
+         zmod_poly_clear(A + i);
+         zmod_poly_clear(B + i);
+         zmod_poly_clear(C + i);
+         zmod_poly_clear(D + i);
+      }
+      zmod_poly_clear(temp);
+   }
+   
+   return result;
+}
+
 int test_zmod_poly_half_gcd()
 {
    int result = 1;
@@ -9252,6 +9462,166 @@ int test_zmod_poly_evaluate()
    return result;
 }
 
+int test_zmod_poly_evaluate_vec()
+{
+   int result = 1;
+   zmod_poly_t pol1;
+   unsigned long bits, i;
+   
+   unsigned long count1;
+   for (count1 = 0; (count1 < 200) && (result == 1); count1++)
+   {
+      bits = randint(FLINT_BITS-2)+2;
+      unsigned long modulus;
+      
+      do {modulus = randprime(bits);} while (modulus < 2);
+      
+      zmod_poly_init(pol1, modulus);
+      
+      unsigned long length1 = randint(1000);
+      unsigned long n = randint(1000);
+      if (randint(4) == 0) length1 = randint(40);
+      if (randint(4) == 0) n = randint(40);
+
+#if DEBUG
+      printf("length1 = %ld, n = %ld, bits = %ld, modulus = %ld\n", length1, n, bits, modulus);
+#endif
+      
+      unsigned long * points = (unsigned long *) flint_heap_alloc(n + 1);
+      unsigned long * val1 = (unsigned long *) flint_heap_alloc(n + 1);
+      unsigned long * val2 = (unsigned long *) flint_heap_alloc(n + 1);
+      
+      randpoly(pol1, length1, modulus);
+      for (i = 0; i < n; i++)
+         points[i] = z_randint(modulus);
+      if (n > 2) points[n - 1] = points[0]; // repeated points are allowed
+
+      zmod_poly_evaluate_vec_horner(val1, pol1, points, n);
+      zmod_poly_evaluate_vec(val2, pol1, points, n);
+
+      for (i = 0; i < n; i++)
+         if (val1[i] != val2[i]) result = 0;
+      
+      if (!result)
+         printf("Error: length1 = %ld, n = %ld, modulus = %ld\n", length1, n, modulus);
+      
+      flint_heap_free(val2);
+      flint_heap_free(val1);
+      flint_heap_free(points);
+      zmod_poly_clear(pol1);
+   }
+   
+   // reuse a tree for several polynomials
+   for (count1 = 0; (count1 < 20) && (result == 1); count1++)
+   {
+      bits = randint(FLINT_BITS-2)+2;
+      unsigned long modulus;
+      
+      do {modulus = randprime(bits);} while (modulus < 2);
+      
+      unsigned long n = randint(2000) + 1;
+      unsigned long * points = (unsigned long *) flint_heap_alloc(n);
+      unsigned long * val1 = (unsigned long *) flint_heap_alloc(n);
+      unsigned long * val2 = (unsigned long *) flint_heap_alloc(n);
+      
+      for (i = 0; i < n; i++)
+         points[i] = z_randint(modulus);
+
+      zmod_poly_tree_t tree;
+      zmod_poly_tree_init(tree, points, n, modulus);
+      zmod_poly_init(pol1, modulus);
+      
+      unsigned long count2;
+      for (count2 = 0; (count2 < 5) && (result == 1); count2++)
+      {
+         randpoly(pol1, randint(2*n), modulus);
+      
+         zmod_poly_evaluate_vec_horner(val1, pol1, points, n);
+         zmod_poly_evaluate_vec_tree(val2, pol1, tree);
+
+         for (i = 0; i < n; i++)
+            if (val1[i] != val2[i]) result = 0;
+      
+         if (!result)
+            printf("Error: length1 = %ld, n = %ld, modulus = %ld\n", pol1->length, n, modulus);
+      }
+
+      zmod_poly_clear(pol1);
+      zmod_poly_tree_clear(tree);
+      flint_heap_free(val2);
+      flint_heap_free(val1);
+      flint_heap_free(points);
+   }
+   
+   return result;
+}
+
+int test_zmod_poly_interpolate()
+{
+   int result = 1;
+   zmod_poly_t pol1, pol2;
+   unsigned long bits, i;
+   
+   unsigned long count1;
+   for (count1 = 0; (count1 < 200) && (result == 1); count1++)
+   {
+      bits = randint(FLINT_BITS-2)+2;
+      unsigned long modulus;
+      
+      do {modulus = randprime(bits);} while (modulus < 2);
+      
+      zmod_poly_init(pol1, modulus);
+      zmod_poly_init(pol2, modulus);
+      
+      unsigned long n = randint(1000) + 1;
+      if (n > modulus) n = modulus;
+      
+#if DEBUG
+      printf("n = %ld, bits = %ld, modulus = %ld\n", n, bits, modulus);
+#endif
+      
+      unsigned long * xs = (unsigned long *) flint_heap_alloc(n);
+      unsigned long * ys = (unsigned long *) flint_heap_alloc(n);
+      
+      // distinct points in arithmetic progression, then shuffled
+      unsigned long a = z_randint(modulus);
+      unsigned long s = z_randint(modulus - 1) + 1;
+      for (i = 0; i < n; i++)
+         xs[i] = z_addmod(a, z_mulmod2_precomp(i, s, modulus, pol1->p_inv), modulus);
+      for (i = n - 1; i > 0; i--)
+      {
+         unsigned long j = z_randint(i + 1);
+         unsigned long t = xs[i];
+         xs[i] = xs[j];
+         xs[j] = t;
+      }
+      
+      randpoly(pol1, randint(n + 1), modulus);
+      zmod_poly_evaluate_vec(ys, pol1, xs, n);
+      result = zmod_poly_interpolate(pol2, xs, ys, n);
+
+      result &= zmod_poly_equal(pol1, pol2);
+      
+      // repeated points are rejected and pol2 is left alone
+      if (result && n >= 2)
+      {
+         xs[n - 1] = xs[z_randint(n - 1)];
+         result = !zmod_poly_interpolate(pol2, xs, ys, n);
+         result &= zmod_poly_equal(pol1, pol2);
+      }
+
+      if (!result)
+         printf("Error: length1 = %ld, n = %ld, modulus = %ld\n", pol1->length, n, modulus);
+      
+      flint_heap_free(ys);
+      flint_heap_free(xs);
+      zmod_poly_clear(pol2);
+      zmod_poly_clear(pol1);
+   }
+   
+   return result;
+}
+
 int test_zmod_poly_compose_horner()
 {
    int result = 1;
@@ -9583,6 +9953,7 @@ void zmod_poly_test_all()
 	RUN_TEST(zmod_poly_fprint_fread); 
 #endif
    RUN_TEST(zmod_poly_to_from_string); 
+   RUN_TEST(zmod_poly_fwrite_bin); 
    RUN_TEST(__zmod_poly_normalise); 
    RUN_TEST(zmod_poly_truncate); 
    RUN_TEST(zmod_poly_reverse); 
@@ -9653,6 +10024,8 @@ void zmod_poly_test_all()
    RUN_TEST(zmod_poly_mulmod); 
    RUN_TEST(zmod_poly_powmod); 
    RUN_TEST(zmod_poly_evaluate); 
+   RUN_TEST(zmod_poly_evaluate_vec); 
+   RUN_TEST(zmod_poly_interpolate); 
    RUN_TEST(zmod_poly_compose_horner); 
    RUN_TEST(zmod_poly_isirreducible); 
    RUN_TEST(zmod_poly_factor_berlekamp); 
@@ -9662,6 +10035,8 @@ void zmod_poly_test_all()
    RUN_TEST(zmod_poly_factor); 
    RUN_TEST(zmod_poly_2x2_mat_mul_classical_strassen); 
    RUN_TEST(zmod_poly_2x2_mat_mul);
+   RUN_TEST(zmod_poly_2x2_mat_mul_transform);
+   RUN_TEST(zmod_poly_mat_mul);
    
    printf(all_success ? "\nAll tests passed\n" :
                         "\nAt least one test FAILED!\n");
@@ -354,6 +354,68 @@ int zmod_poly_read(zmod_poly_t poly)
    return zmod_poly_fread(poly, stdin);
 }
 
+int zmod_poly_fwrite_bin(zmod_poly_t poly, FILE* f)
+{
+   F_mpn_bin_header_t hdr;
+
+   hdr->type = FLINT_BIN_ZMOD_POLY;
+   hdr->flags = FLINT_BIN_SMALL;
+   hdr->dim1 = poly->length;
+   hdr->dim2 = poly->p;
+   hdr->limbs = poly->length;
+
+   if (!F_mpn_fwrite_bin_header(hdr, f)) return 0;
+
+   return (fwrite(poly->coeffs, sizeof(unsigned long), poly->length, f) == poly->length);
+}
+
+int zmod_poly_fread_bin(zmod_poly_t poly, FILE* f)
+{
+   F_mpn_bin_header_t hdr;
+   unsigned long i;
+
+   if (!F_mpn_fread_bin_header(hdr, f) || hdr->type != FLINT_BIN_ZMOD_POLY || hdr->dim2 < 2
+         || hdr->limbs != hdr->dim1)
+   {
+      zmod_poly_init(poly, 2);
+      return 0;
+   }
+
+   zmod_poly_init(poly, hdr->dim2);
+   zmod_poly_fit_length(poly, hdr->dim1);
+
+   if (!F_mpn_fread_bin(poly->coeffs, hdr->dim1, f, hdr->swap))
+      return 0;
+
+   for (i = 0; i < hdr->dim1; i++)
+      if (poly->coeffs[i] >= poly->p) return 0;
+
+   poly->length = hdr->dim1;
+   __zmod_poly_normalise(poly);
+
+   return 1;
+}
+
+int zmod_poly_attach_map(zmod_poly_t poly, const F_mpn_map_t map)
+{
+   F_mpn_bin_header_t hdr;
+
+   if (!F_mpn_get_bin_header(hdr, map->data, map->limbs) || hdr->type != FLINT_BIN_ZMOD_POLY
+         || hdr->swap || hdr->dim2 < 2 || hdr->limbs != hdr->dim1)
+      return 0;
+
+   poly->coeffs = map->data + FLINT_BIN_HEADER_LIMBS;
+   poly->alloc = hdr->dim1;
+   poly->length = hdr->dim1;
+   poly->p = hdr->dim2;
+   poly->p_inv = z_precompute_inverse(hdr->dim2);
+#if USE_ZN_POLY
+   zn_mod_init(poly->mod, hdr->dim2);
+#endif
+
+   return 1;
+}
+
 
 /****************************************************************************
 
@@ -2259,56 +2321,7 @@ void _zmod_poly_bit_pack(mp_limb_t * res, zmod_poly_t poly, unsigned long bits,
    
    if (bits < FLINT_BITS)
    {
-      unsigned long boundary_limit_bit = FLINT_BITS - bits;
-
-      //printf("Packing polynomial ****************************************\n");
-      //print_limb("res[0]", res[0]);
-
-      unsigned long i;
-      for (i = 0; i < length; i++)
-      {
-         if (current_bit > boundary_limit_bit)
-         {
-            // the coefficient will be added accross a limb boundary,
-            // so need the lower and upper parts (lower for limb with
-            // lower index).
-            //printf("coeff won't fit in limb...\n");
-            //print_limb("poly->coeffs[i]                ", poly->coeffs[i]);
-
-            // the part of the coeff that will be in the current limb
-            temp_lower = (poly->coeffs[i] << current_bit);
-            //print_limb("temp_lower                     ", temp_lower);
-            // the part of the coeff that will be in the next limb
-            temp_upper = (poly->coeffs[i] >> (FLINT_BITS - current_bit));
-            //print_limb("temp_upper                     ", temp_upper);
-            //print_limb("res[current_limb]              ", res[current_limb]);
-            res[current_limb] |= temp_lower;
-            //print_limb("res[current_limb] |= temp_lower", res[current_limb]);
-            current_limb++;
-            res[current_limb] = temp_upper;
-            //print_limb("res[current_limb+1]            ", res[current_limb]);
-            current_bit = bits + current_bit - FLINT_BITS;
-         }
-         else
-         {
-            // the coefficient will fit in the current limb
-            //printf("coeff will fit in limb...\n");
-            temp_lower = poly->coeffs[i] << current_bit;
-            //print_limb("poly->coeffs[i]                ", poly->coeffs[i]);
-            //print_limb("temp_lower                     ", temp_lower);
-            //print_limb("res[current_limb]              ", res[current_limb]);
-            res[current_limb] |= temp_lower;
-            //print_limb("res[current_limb] |= temp_lower", res[current_limb]);
-            current_bit += bits;
-         }
-
-         if (current_bit >= FLINT_BITS)
-         {
-            current_limb++;
-            if (current_limb < total_limbs) res[current_limb] = 0L;
-            current_bit -= FLINT_BITS;
-         }
-      }
+      F_mpn_bit_pack(res, poly->coeffs, length, bits, 0);
    }
    else if (bits == FLINT_BITS)
    {
@@ -2418,85 +2431,19 @@ void _zmod_poly_bit_unpack(zmod_poly_t res, mp_limb_t * mpn, unsigned long lengt
 
    if (bits < FLINT_BITS)
    {
-      unsigned long current_limb = 0;
-      unsigned long current_bit = 0;
+      // unpack all the coefficients, then reduce them in place
+      F_mpn_bit_unpack(res->coeffs, mpn, length, bits, 0);
 
-      unsigned long boundary_limit_bit = FLINT_BITS - bits;
-
-      unsigned long temp_lower;
-      unsigned long temp_upper;
-      
-      
-      unsigned long mask;
-      mask = 1L;
-      i = bits - 1;
-      while(i)
-      {
-         mask <<= 1;
-         mask |= 1L;
-         i--;
-      }
-      
-      for (i = 0; i < length; i++)
-      {
-          if (current_bit > boundary_limit_bit)
-          {
-             // the coeff will be across a limb boundary...
-             //printf("coeff won't only be in current limb...\n");
-
-             // temp lower contains the part in the current limb
-             temp_lower = mpn[current_limb];
-             //print_limb("mpn[current_limb]       ", temp_lower);
-
-             // need (bits - (FLINT_BITS - current_bit)) bits 
-             // from the LSB side of this limb to complete the coeff...
-             current_limb++;
-             //print_limb("mpn[current_limb+1]     ", mpn[current_limb]);
-             // so shift them up, OR with the lower part and apply the mask
-             temp_upper = mpn[current_limb] << (FLINT_BITS - current_bit);
-             //print_limb("temp_upper              ", temp_upper);
-             temp_upper |= temp_lower;
-             //print_limb("temp_upper |= temp_lower", temp_upper);
-             temp_upper &= mask;
-             //print_limb("temp_upper &= mask      ", temp_upper);
 #if FLINT_BITS == 64
-             if (bits <= FLINT_D_BITS)
-                _zmod_poly_set_coeff_ui(res, i, z_mod_precomp(temp_upper, res->p, res->p_inv));
-             else 
-#endif
-                _zmod_poly_set_coeff_ui(res, i, z_mod2_precomp(temp_upper, res->p, res->p_inv));
-             
-             current_bit = bits + current_bit - FLINT_BITS;
-             mpn[current_limb] = mpn[current_limb] >> current_bit;
-             //print_limb("mpn[current_limb+1]     ", mpn[current_limb]);
-          }
-          else
-          {
-             // the coeff will fit in the current limb...
-             //printf("coeff will be in current limb...\n");
-             //print_limb("mpn[current_limb]       ", mpn[current_limb]);
-             temp_lower = mpn[current_limb] & mask;
-             //print_limb("temp_lower              ", temp_lower);
-             // less than a limb in size, so must be smaller than an unsigned long...
-
-             //zmod_poly_set_coeff_ui(res, i, temp_lower);
-#if FLINT_BITS == 64
-             if (bits <= FLINT_D_BITS)
-                _zmod_poly_set_coeff_ui(res, i, z_mod_precomp(temp_lower, res->p, res->p_inv));
-             else 
+      if (bits <= FLINT_D_BITS)
+      {
+         for (i = 0; i < length; i++)
+            _zmod_poly_set_coeff_ui(res, i, z_mod_precomp(res->coeffs[i], res->p, res->p_inv));
+      } else 
 #endif
-                _zmod_poly_set_coeff_ui(res, i, z_mod2_precomp(temp_lower, res->p, res->p_inv));
-                
-             mpn[current_limb] = mpn[current_limb] >> bits;
-             //print_limb("mpn[current_limb]       ", mpn[current_limb]);
-             current_bit += bits;
-          }
-
-          if(current_bit == FLINT_BITS)
-          {
-             current_bit = 0;
-             current_limb++;
-          }
+      {
+         for (i = 0; i < length; i++)
+            _zmod_poly_set_coeff_ui(res, i, z_mod2_precomp(res->coeffs[i], res->p, res->p_inv));
       }
    }
    else if (bits == FLINT_BITS)
@@ -7252,17 +7199,20 @@ unsigned long zmod_poly_factor(zmod_poly_factor_t result, zmod_poly_t input)
 
 **************************************************************************************************/
 
-ulong zmod_poly_evaluate(zmod_poly_t poly, ulong c)
+/*
+   Evaluate the polynomial with the given length and coefficients at c 
+   using Horner's rule
+*/
+
+ulong _zmod_poly_evaluate(ulong * coeffs, ulong length, ulong c, ulong p, double p_inv)
 {
-	if (poly->length == 0) return 0L;
+	if (length == 0) return 0L;
 
-	if ((poly->length == 1) || (c == 0)) return poly->coeffs[0];
+	if ((length == 1) || (c == 0)) return coeffs[0];
 
-	long n = poly->length - 1;
-	ulong p = poly->p;
-	double p_inv = poly->p_inv;
+	long n = length - 1;
 
-    ulong val = poly->coeffs[n];
+    ulong val = coeffs[n];
 
 #if FLINT_BITS == 64
 	ulong bits = FLINT_BIT_COUNT(p);
@@ -7272,7 +7222,7 @@ ulong zmod_poly_evaluate(zmod_poly_t poly, ulong c)
 	   for ( ; n > 0L; n--)
 	   {
           val = z_mulmod2_precomp(val, c, p, p_inv);
-	      val = z_addmod(val, poly->coeffs[n - 1], p);
+	      val = z_addmod(val, coeffs[n - 1], p);
 	   }
 	} else
 	{
@@ -7280,7 +7230,7 @@ ulong zmod_poly_evaluate(zmod_poly_t poly, ulong c)
 	   for ( ; n > 0L; n--)
 	   {
           val = z_mulmod_precomp(val, c, p, p_inv);
-	      val = z_addmod(val, poly->coeffs[n - 1], p);
+	      val = z_addmod(val, coeffs[n - 1], p);
 	   }
 #if FLINT_BITS == 64
 	}
@@ -7289,6 +7239,426 @@ ulong zmod_poly_evaluate(zmod_poly_t poly, ulong c)
 	return val;
 }
 
+ulong zmod_poly_evaluate(zmod_poly_t poly, ulong c)
+{
+	return _zmod_poly_evaluate(poly->coeffs, poly->length, c, poly->p, poly->p_inv);
+}
+
+/**************************************************************************************************
+
+   Subproduct trees
+
+**************************************************************************************************/
+
+/*
+   Number of nodes at level k of a subproduct tree on n points
+*/
+
+#define ZMOD_POLY_TREE_COUNT(n, k) (((n) + (1UL << (k)) - 1) >> (k))
+
+/*
+   Build the subproduct tree of the n given points, which must be reduced 
+   modulo p. Level 0 consists of the linear factors x - points[i] and each 
+   node of level k + 1 is the product of two adjacent nodes of level k. If a 
+   level has an odd number of nodes, the last one is copied up unchanged. 
+   Thus node i of level k is the product of the factors for the points 
+   points[i*2^k], ..., points[min((i+1)*2^k, n) - 1] and the root, node 0 of 
+   level height - 1, is the product of all the factors.
+*/
+
+void zmod_poly_tree_init(zmod_poly_tree_t tree, ulong * points, ulong n, ulong p)
+{
+   ulong i, k;
+
+   tree->length = n;
+   tree->p = p;
+
+   if (n == 0)
+   {
+      tree->height = 0;
+      tree->points = NULL;
+      tree->levels = NULL;
+      return;
+   }
+
+   tree->height = ceil_log2(n) + 1;
+   tree->points = (ulong *) flint_heap_alloc(n);
+   tree->levels = (zmod_poly_p *) flint_heap_alloc_bytes(tree->height*sizeof(zmod_poly_p));
+
+   for (k = 0; k < tree->height; k++)
+      tree->levels[k] = (zmod_poly_p) flint_heap_alloc_bytes(ZMOD_POLY_TREE_COUNT(n, k)*sizeof(zmod_poly_struct));
+
+   zmod_poly_p level = tree->levels[0];
+   for (i = 0; i < n; i++)
+   {
+      tree->points[i] = points[i];
+      zmod_poly_init2(level + i, p, 2);
+      level[i].coeffs[0] = (points[i] == 0L) ? 0L : p - points[i];
+      level[i].coeffs[1] = 1L;
+      level[i].length = 2;
+   }
+
+   for (k = 1; k < tree->height; k++)
+   {
+      ulong count = ZMOD_POLY_TREE_COUNT(n, k);
+      ulong count_below = ZMOD_POLY_TREE_COUNT(n, k - 1);
+      zmod_poly_p below = tree->levels[k - 1];
+      level = tree->levels[k];
+
+      for (i = 0; i < count; i++)
+      {
+         if (2*i + 1 < count_below)
+         {
+            zmod_poly_init2(level + i, p, below[2*i].length + below[2*i + 1].length - 1);
+            zmod_poly_mul(level + i, below + 2*i, below + 2*i + 1);
+         } else
+         {
+            zmod_poly_init2(level + i, p, below[2*i].length);
+            zmod_poly_set(level + i, below + 2*i);
+         }
+      }
+   }
+}
+
+void zmod_poly_tree_clear(zmod_poly_tree_t tree)
+{
+   ulong i, k;
+
+   for (k = 0; k < tree->height; k++)
+   {
+      for (i = 0; i < ZMOD_POLY_TREE_COUNT(tree->length, k); i++)
+         zmod_poly_clear(tree->levels[k] + i);
+      flint_heap_free(tree->levels[k]);
+   }
+
+   if (tree->length)
+   {
+      flint_heap_free(tree->levels);
+      flint_heap_free(tree->points);
+   }
+}
+
+/**************************************************************************************************
+
+   Multipoint evaluation
+
+**************************************************************************************************/
+
+static inline
+int __zmod_poly_evaluate_vec_use_horner(ulong length, ulong n, ulong cutoff)
+{
+   ulong L = FLINT_MAX(length, n);
+   ulong lg = FLINT_BIT_COUNT(L);
+
+   return ((double) length * (double) n < (double) cutoff * (double) L * (double) (lg * lg));
+}
+
+void zmod_poly_evaluate_vec_horner(ulong * res, zmod_poly_t poly, ulong * points, ulong n)
+{
+   ulong i;
+
+   for (i = 0; i < n; i++)
+      res[i] = _zmod_poly_evaluate(poly->coeffs, poly->length, points[i], poly->p, poly->p_inv);
+}
+
+#if USE_ZN_POLY
+
+/*
+   Transposed evaluation down the subproduct tree. On input U[0, d) are the 
+   coefficients of x^-1, ..., x^-d of the Laurent series (f mod P)/P, where 
+   P is node i of level k and d is its degree. For a node with children L and 
+   R, the corresponding series for L is (f mod P)/P * R to precision deg(L), 
+   which is a middle product of U with the reversal of R, and likewise for R. 
+   At a leaf x - a the first coefficient is f(a). Below 
+   ZMOD_POLY_TREE_EVALUATE_CUTOFF we recover f mod P, which is the polynomial 
+   part of U*P, and switch to Horner's rule.
+*/
+
+void __zmod_poly_evaluate_vec_tree(ulong * res, ulong * U, zmod_poly_tree_t tree, ulong k, ulong i)
+{
+   // skip nodes that were copied up unchanged
+   while (k > 0 && 2*i + 1 >= ZMOD_POLY_TREE_COUNT(tree->length, k - 1))
+   {
+      k--;
+      i *= 2;
+   }
+
+   zmod_poly_p P = tree->levels[k] + i;
+   ulong d = P->length - 1;
+   ulong p = P->p;
+   ulong j, t;
+
+   if (k == 0 || d <= ZMOD_POLY_TREE_EVALUATE_CUTOFF)
+   {
+      ulong * g = (ulong *) flint_heap_alloc(d);
+      ulong * points = tree->points + (i << k);
+
+      for (t = 0; t < d; t++)
+      {
+         g[t] = U[d - t - 1]; // P is monic
+         for (j = t + 1; j < d; j++)
+            g[t] = z_addmod(g[t], z_mulmod2_precomp(P->coeffs[j], U[j - t - 1], p, P->p_inv), p);
+      }
+
+      for (j = 0; j < d; j++)
+         res[j] = _zmod_poly_evaluate(g, d, points[j], p, P->p_inv);
+
+      flint_heap_free(g);
+
+      return;
+   }
+
+   zmod_poly_p L = tree->levels[k - 1] + 2*i;
+   zmod_poly_p R = L + 1;
+   ulong dL = L->length - 1;
+   ulong dR = R->length - 1;
+
+   ulong * V = (ulong *) flint_heap_alloc(d);
+   ulong * rev = (ulong *) flint_heap_alloc(FLINT_MAX(dL, dR) + 1);
+
+   for (j = 0; j <= dR; j++)
+      rev[j] = R->coeffs[dR - j];
+   zn_array_mulmid(V, U, d, rev, dR + 1, P->mod);
+
+   for (j = 0; j <= dL; j++)
+      rev[j] = L->coeffs[dL - j];
+   zn_array_mulmid(V + dL, U, d, rev, dL + 1, P->mod);
+
+   flint_heap_free(rev);
+
+   __zmod_poly_evaluate_vec_tree(res, V, tree, k - 1, 2*i);
+   __zmod_poly_evaluate_vec_tree(res + dL, V + dL, tree, k - 1, 2*i + 1);
+
+   flint_heap_free(V);
+}
+
+#endif
+
+/*
+   Set res[i] to the value of poly at the i-th point of the given subproduct 
+   tree. We use the transposed algorithm of Bostan, Lecerf and Schost: if M 
+   is the root of the tree, of degree m, and f has length n, the coefficients 
+   of x^-1, ..., x^-m of f/M are obtained from the power series 
+   1/rev(M) mod x^n by a single middle product, and these are pushed down the 
+   tree by __zmod_poly_evaluate_vec_tree.
+*/
+
+void zmod_poly_evaluate_vec_tree(ulong * res, zmod_poly_t poly, zmod_poly_tree_t tree)
+{
+   ulong m = tree->length;
+   ulong n = poly->length;
+   ulong j;
+
+   if (n == 0)
+   {
+      for (j = 0; j < m; j++)
+         res[j] = 0L;
+      return;
+   }
+
+#if USE_ZN_POLY
+   if (__zmod_poly_evaluate_vec_use_horner(n, m, ZMOD_POLY_EVALUATE_VEC_TREE_CUTOFF))
+   {
+#endif
+      zmod_poly_evaluate_vec_horner(res, poly, tree->points, m);
+#if USE_ZN_POLY
+      return;
+   }
+
+   zmod_poly_p M = tree->levels[tree->height - 1];
+
+   // S = m - 1 zeroes followed by 1/rev(M) mod x^n
+   ulong * S = (ulong *) flint_heap_alloc(n + m - 1);
+   ulong * rev = (ulong *) flint_heap_alloc(n);
+   ulong * U = (ulong *) flint_heap_alloc(m);
+
+   for (j = 0; j < n; j++)
+      rev[j] = (j <= m) ? M->coeffs[m - j] : 0L;
+   zn_array_invert(S + m - 1, rev, n, M->mod);
+   for (j = 0; j < m - 1; j++)
+      S[j] = 0L;
+
+   for (j = 0; j < n; j++)
+      rev[j] = poly->coeffs[n - j - 1];
+   zn_array_mulmid(U, S, n + m - 1, rev, n, M->mod);
+
+   flint_heap_free(rev);
+   flint_heap_free(S);
+
+   __zmod_poly_evaluate_vec_tree(res, U, tree, tree->height - 1, 0);
+
+   flint_heap_free(U);
+#endif
+}
+
+/*
+   Evaluate poly at the n given points. If there are more points than 
+   coefficients we build a tree on each block of length(poly) points, since 
+   a tree on all the points would cost more per point.
+*/
+
+void zmod_poly_evaluate_vec(ulong * res, zmod_poly_t poly, ulong * points, ulong n)
+{
+   ulong block = FLINT_MIN(n, FLINT_MAX(poly->length, 1));
+   ulong i;
+
+   for (i = 0; i < n; i += block)
+   {
+      ulong m = FLINT_MIN(block, n - i);
+      
+      if (__zmod_poly_evaluate_vec_use_horner(poly->length, m, ZMOD_POLY_EVALUATE_VEC_CUTOFF))
+         zmod_poly_evaluate_vec_horner(res + i, poly, points + i, m);
+      else
+      {
+         zmod_poly_tree_t tree;
+         zmod_poly_tree_init(tree, points + i, m, poly->p);
+         zmod_poly_evaluate_vec_tree(res + i, poly, tree);
+         zmod_poly_tree_clear(tree);
+      }
+   }
+}
+
+/**************************************************************************************************
+
+   Interpolation
+
+**************************************************************************************************/
+
+/*
+   Set poly to the unique polynomial of length at most n = tree->length 
+   taking the value ys[i] at the i-th point of the tree. The points must be 
+   distinct. We evaluate the derivative of the root M at the points to get 
+   the weights w_i = prod_{j != i} (x_i - x_j), then combine the terms 
+   ys[i]/w_i * M/(x - x_i) up the tree, setting f = f_L*R + f_R*L at a node 
+   with children L and R. Returns 0, leaving poly unchanged, if the points 
+   are not distinct, which is the case exactly when some weight is zero.
+*/
+
+int zmod_poly_interpolate_tree(zmod_poly_t poly, zmod_poly_tree_t tree, ulong * ys)
+{
+   ulong n = tree->length;
+   ulong p = tree->p;
+   ulong i, k;
+
+   if (n == 0)
+   {
+      zmod_poly_zero(poly);
+      return 1;
+   }
+
+   zmod_poly_p M = tree->levels[tree->height - 1];
+   double p_inv = M->p_inv;
+
+   zmod_poly_t dM;
+   zmod_poly_init(dM, p);
+   zmod_poly_derivative(dM, M);
+
+   ulong * w = (ulong *) flint_heap_alloc(n);
+   ulong * c = (ulong *) flint_heap_alloc(n);
+   zmod_poly_evaluate_vec_tree(w, dM, tree);
+   zmod_poly_clear(dM);
+
+   // invert the weights using Montgomery's trick
+   c[0] = w[0];
+   for (i = 1; i < n; i++)
+      c[i] = z_mulmod2_precomp(c[i - 1], w[i], p, p_inv);
+
+   if (c[n - 1] == 0L)
+   {
+      flint_heap_free(c);
+      flint_heap_free(w);
+      return 0;
+   }
+
+   ulong inv = z_invert(c[n - 1], p);
+   for (i = n - 1; i > 0; i--)
+   {
+      c[i] = z_mulmod2_precomp(inv, c[i - 1], p, p_inv);
+      inv = z_mulmod2_precomp(inv, w[i], p, p_inv);
+   }
+   c[0] = inv;
+
+   for (i = 0; i < n; i++)
+      c[i] = z_mulmod2_precomp(c[i], ys[i], p, p_inv);
+
+   flint_heap_free(w);
+
+   if (n == 1)
+   {
+      zmod_poly_zero(poly);
+      zmod_poly_set_coeff_ui(poly, 0, c[0]);
+      flint_heap_free(c);
+      return 1;
+   }
+
+   // level 1 directly: c0*(x - x1) + c1*(x - x0)
+   ulong count = ZMOD_POLY_TREE_COUNT(n, 1);
+   zmod_poly_p cur = (zmod_poly_p) flint_heap_alloc_bytes(count*sizeof(zmod_poly_struct));
+   ulong * x = tree->points;
+
+   for (i = 0; i < count; i++)
+   {
+      zmod_poly_init2(cur + i, p, 2);
+      if (2*i + 1 < n)
+      {
+         ulong t = z_addmod(z_mulmod2_precomp(c[2*i], x[2*i + 1], p, p_inv), 
+                            z_mulmod2_precomp(c[2*i + 1], x[2*i], p, p_inv), p);
+         cur[i].coeffs[0] = (t == 0L) ? 0L : p - t;
+         cur[i].coeffs[1] = z_addmod(c[2*i], c[2*i + 1], p);
+         cur[i].length = 2;
+      } else
+      {
+         cur[i].coeffs[0] = c[2*i];
+         cur[i].length = 1;
+      }
+      __zmod_poly_normalise(cur + i);
+   }
+
+   flint_heap_free(c);
+
+   zmod_poly_t temp;
+   zmod_poly_init(temp, p);
+
+   for (k = 2; k < tree->height; k++)
+   {
+      ulong count_below = count;
+      zmod_poly_p below = tree->levels[k - 1];
+      count = ZMOD_POLY_TREE_COUNT(n, k);
+
+      for (i = 0; i < count; i++)
+      {
+         if (2*i + 1 < count_below)
+         {
+            zmod_poly_mul(temp, cur + 2*i, below + 2*i + 1);
+            zmod_poly_mul(cur + 2*i + 1, cur + 2*i + 1, below + 2*i);
+            zmod_poly_add(cur + 2*i, temp, cur + 2*i + 1);
+            zmod_poly_clear(cur + 2*i + 1);
+         }
+         
+         // slot i has already been consumed by node i/2
+         if (i != 0) cur[i] = cur[2*i];
+      }
+   }
+
+   zmod_poly_clear(temp);
+
+   zmod_poly_swap(poly, cur);
+   zmod_poly_clear(cur);
+   flint_heap_free(cur);
+
+   return 1;
+}
+
+int zmod_poly_interpolate(zmod_poly_t poly, ulong * xs, ulong * ys, ulong n)
+{
+   zmod_poly_tree_t tree;
+   zmod_poly_tree_init(tree, xs, n, poly->p);
+   int ok = zmod_poly_interpolate_tree(poly, tree, ys);
+   zmod_poly_tree_clear(tree);
+
+   return ok;
+}
+
 /**************************************************************************************************
 
    Composition
@@ -7450,6 +7820,156 @@ void zmod_poly_2x2_mat_mul_strassen(zmod_poly_2x2_mat_t R, zmod_poly_2x2_mat_t A
 	zmod_poly_clear(x1);
 }
 
+void _zmod_poly_mat_mul(zmod_poly_p * C, zmod_poly_p * A, zmod_poly_p * B, 
+                                       unsigned long r, unsigned long s, unsigned long t)
+{
+   unsigned long i;
+   unsigned long max_A = 0, max_B = 0;
+
+   if (!r || !t) return;
+
+   for (i = 0; i < r*s; i++)
+      max_A = FLINT_MAX(max_A, A[i]->length);
+   for (i = 0; i < s*t; i++)
+      max_B = FLINT_MAX(max_B, B[i]->length);
+
+   if (!max_A || !max_B)
+   {
+      for (i = 0; i < r*t; i++) zmod_poly_zero(C[i]);
+      return;
+   }
+
+   unsigned long length = max_A + max_B - 1;
+   unsigned long p = A[0]->p;
+   double p_inv = A[0]->p_inv;
+
+   // the entries of C may alias the inputs, so we work with temporaries
+   zmod_poly_struct * T = (zmod_poly_struct *) flint_heap_alloc_bytes(r*t*sizeof(zmod_poly_struct));
+   for (i = 0; i < r*t; i++)
+      zmod_poly_init2_precomp(T + i, p, p_inv, length);
+
+#if USE_ZN_POLY
+   // let zn_poly transform each input once and accumulate the products
+   const unsigned long ** op1 = (const unsigned long **) flint_heap_alloc_bytes(r*s*sizeof(unsigned long *));
+   const unsigned long ** op2 = (const unsigned long **) flint_heap_alloc_bytes(s*t*sizeof(unsigned long *));
+   unsigned long ** res = (unsigned long **) flint_heap_alloc_bytes(r*t*sizeof(unsigned long *));
+   size_t * n1 = (size_t *) flint_heap_alloc_bytes(r*s*sizeof(size_t));
+   size_t * n2 = (size_t *) flint_heap_alloc_bytes(s*t*sizeof(size_t));
+
+   for (i = 0; i < r*s; i++)
+   {
+      op1[i] = A[i]->coeffs;
+      n1[i] = A[i]->length;
+   }
+   for (i = 0; i < s*t; i++)
+   {
+      op2[i] = B[i]->coeffs;
+      n2[i] = B[i]->length;
+   }
+   for (i = 0; i < r*t; i++)
+      res[i] = T[i].coeffs;
+
+   zn_array_mat_mul(res, op1, n1, op2, n2, r, s, t, A[0]->mod);
+
+   for (i = 0; i < r*t; i++)
+   {
+      T[i].length = length;
+      __zmod_poly_normalise(T + i);
+   }
+
+   flint_heap_free(n2);
+   flint_heap_free(n1);
+   flint_heap_free(res);
+   flint_heap_free(op2);
+   flint_heap_free(op1);
+#else
+   unsigned long j, k;
+   zmod_poly_t temp;
+   zmod_poly_init2_precomp(temp, p, p_inv, length);
+
+   for (i = 0; i < r; i++)
+      for (j = 0; j < t; j++)
+         for (k = 0; k < s; k++)
+         {
+            zmod_poly_mul(temp, A[i*s + k], B[k*t + j]);
+            zmod_poly_add(T + i*t + j, T + i*t + j, temp);
+         }
+
+   zmod_poly_clear(temp);
+#endif
+
+   for (i = 0; i < r*t; i++)
+   {
+      zmod_poly_swap(C[i], T + i);
+      zmod_poly_clear(T + i);
+   }
+
+   flint_heap_free(T);
+}
+
+void zmod_poly_mat_mul(zmod_poly_struct * C, zmod_poly_struct * A, zmod_poly_struct * B, 
+                                       unsigned long r, unsigned long s, unsigned long t)
+{
+   unsigned long i;
+
+   if (!r || !t) return;
+
+   if (!s)
+   {
+      for (i = 0; i < r*t; i++) zmod_poly_zero(C + i);
+      return;
+   }
+
+   zmod_poly_p * pC = (zmod_poly_p *) flint_heap_alloc_bytes(r*t*sizeof(zmod_poly_p));
+   zmod_poly_p * pA = (zmod_poly_p *) flint_heap_alloc_bytes(r*s*sizeof(zmod_poly_p));
+   zmod_poly_p * pB = (zmod_poly_p *) flint_heap_alloc_bytes(s*t*sizeof(zmod_poly_p));
+
+   for (i = 0; i < r*t; i++) pC[i] = C + i;
+   for (i = 0; i < r*s; i++) pA[i] = A + i;
+   for (i = 0; i < s*t; i++) pB[i] = B + i;
+
+   _zmod_poly_mat_mul(pC, pA, pB, r, s, t);
+
+   flint_heap_free(pB);
+   flint_heap_free(pA);
+   flint_heap_free(pC);
+}
+
+void zmod_poly_dot(zmod_poly_t res, zmod_poly_struct * a, zmod_poly_struct * b, unsigned long n)
+{
+   unsigned long i;
+
+   if (!n)
+   {
+      zmod_poly_zero(res);
+      return;
+   }
+
+   zmod_poly_p pC[1] = {res};
+   zmod_poly_p * pA = (zmod_poly_p *) flint_heap_alloc_bytes(n*sizeof(zmod_poly_p));
+   zmod_poly_p * pB = (zmod_poly_p *) flint_heap_alloc_bytes(n*sizeof(zmod_poly_p));
+
+   for (i = 0; i < n; i++)
+   {
+      pA[i] = a + i;
+      pB[i] = b + i;
+   }
+
+   _zmod_poly_mat_mul(pC, pA, pB, 1, n, 1);
+
+   flint_heap_free(pB);
+   flint_heap_free(pA);
+}
+
+void zmod_poly_2x2_mat_mul_transform(zmod_poly_2x2_mat_t R, zmod_poly_2x2_mat_t A, zmod_poly_2x2_mat_t B)
+{
+   zmod_poly_p pR[4] = {R->a, R->b, R->c, R->d};
+   zmod_poly_p pA[4] = {A->a, A->b, A->c, A->d};
+   zmod_poly_p pB[4] = {B->a, B->b, B->c, B->d};
+
+   _zmod_poly_mat_mul(pR, pA, pB, 2, 2, 2);
+}
+
 #define ZMOD_POLY_2X2_STRASSEN_CUTOFF 20
 
 void zmod_poly_2x2_mat_mul(zmod_poly_2x2_mat_t R, zmod_poly_2x2_mat_t A, 
@@ -7458,6 +7978,15 @@ void zmod_poly_2x2_mat_mul(zmod_poly_2x2_mat_t R, zmod_poly_2x2_mat_t A,
 	ulong min_A = FLINT_MIN(FLINT_MIN(A->a->length, A->b->length), FLINT_MIN(A->c->length, A->d->length));
    ulong min_B = FLINT_MIN(FLINT_MIN(B->a->length, B->b->length), FLINT_MIN(B->c->length, B->d->length));
 
+#if USE_ZN_POLY
+   // share the transforms between the products, this handles aliasing itself
+   if (FLINT_MIN(min_A, min_B) >= ZMOD_POLY_2X2_TRANSFORM_CUTOFF)
+   {
+      zmod_poly_2x2_mat_mul_transform(R, A, B);
+      return;
+   }
+#endif
+
 	if ((R == A) || (R == B))
 	{
 		zmod_poly_2x2_mat_t T;
@@ -38,6 +38,7 @@
 #include "memory-manager.h"
 #include "mpn_extras.h"
 #include "long_extras.h"
+#include "flint-tuning.h"
 #include "zn_poly/src/zn_poly.h"
 
 #ifndef _ZMOD_POLY_H_
@@ -84,6 +85,21 @@ typedef struct
 
 typedef zmod_poly_2x2_mat_struct zmod_poly_2x2_mat_t[1];
 
+/*
+   Subproduct tree on a set of points: levels[0] holds the linear factors 
+   x - points[i] and levels[height - 1][0] is their product
+*/
+typedef struct
+{
+   zmod_poly_p * levels;
+   unsigned long * points;
+   unsigned long length;
+   unsigned long height;
+   unsigned long p;
+} zmod_poly_tree_struct;
+
+typedef zmod_poly_tree_struct zmod_poly_tree_t[1];
+
 /**
  * This is the data type for storing factors for a polynomial
  * It contains an array of polynomials <code>factors</code> that contains the factors of the polynomial.
@@ -192,6 +208,23 @@ void zmod_poly_fprint(zmod_poly_t poly, FILE* f);
 int zmod_poly_read(zmod_poly_t poly);
 int zmod_poly_fread(zmod_poly_t poly, FILE* f);
 
+/*
+   Binary I/O in the format described in mpn_extras.h, the coefficients
+   being stored as is. As for zmod_poly_fread, zmod_poly_fread_bin
+   initialises poly, with the modulus given in the file.
+*/
+int zmod_poly_fwrite_bin(zmod_poly_t poly, FILE* f);
+int zmod_poly_fread_bin(zmod_poly_t poly, FILE* f);
+
+/*
+   Attach the polynomial in a mapped binary file of native byte order to
+   the uninitialised poly without copying, returning 0 if this is not
+   possible. The coefficients are not checked. They may be modified in
+   place, but poly must not be cleared or resized, and becomes invalid when
+   the map is cleared.
+*/
+int zmod_poly_attach_map(zmod_poly_t poly, const F_mpn_map_t map);
+
 
 // ------------------------------------------------------
 // Length and degree
@@ -507,7 +540,7 @@ void zmod_poly_divrem_q0(zmod_poly_t Q, zmod_poly_t R, zmod_poly_t A, zmod_poly_
 void zmod_poly_divrem_q1(zmod_poly_t Q, zmod_poly_t R, zmod_poly_t A, zmod_poly_t B);
 void zmod_poly_rem_q1(zmod_poly_t R, zmod_poly_t A, zmod_poly_t B);
 
-#define ZMOD_DIV_BASECASE_CUTOFF 170
+#define ZMOD_DIV_BASECASE_CUTOFF (flint_tuning.zmod_poly_div_basecase_thresh)
 
 static inline
 void zmod_poly_divrem(zmod_poly_t Q, zmod_poly_t R, zmod_poly_t A, zmod_poly_t B)
@@ -630,9 +663,9 @@ ulong zmod_poly_resultant(zmod_poly_t u, zmod_poly_t v);
    GCD
 */
 
-#define FLINT_ZMOD_POLY_HGCD_CUTOFF 60 // cutoff between iterative basecase and recursive hgcd
-#define FLINT_ZMOD_POLY_GCD_CUTOFF 184 // cutoff between hgcd and euclidean
-#define FLINT_ZMOD_POLY_SMALL_GCD_CUTOFF 174 // cutoff between hgcd and euclidean for small moduli
+#define FLINT_ZMOD_POLY_HGCD_CUTOFF (flint_tuning.zmod_poly_hgcd_thresh) // cutoff between iterative basecase and recursive hgcd
+#define FLINT_ZMOD_POLY_GCD_CUTOFF (flint_tuning.zmod_poly_gcd_thresh) // cutoff between hgcd and euclidean
+#define FLINT_ZMOD_POLY_SMALL_GCD_CUTOFF (flint_tuning.zmod_poly_small_gcd_thresh) // cutoff between hgcd and euclidean for small moduli
 
 void zmod_poly_gcd_euclidean(zmod_poly_t res, zmod_poly_t poly1, zmod_poly_t poly2);
 
@@ -770,8 +803,45 @@ void zmod_poly_powmod_mpz(zmod_poly_t res, zmod_poly_t pol, mpz_t exp, zmod_poly
 
 **************************************************************************************************/
 
+ulong _zmod_poly_evaluate(ulong * coeffs, ulong length, ulong c, ulong p, double p_inv);
+
 ulong zmod_poly_evaluate(zmod_poly_t poly, ulong c);
 
+/**************************************************************************************************
+
+   Subproduct trees, multipoint evaluation and interpolation
+
+**************************************************************************************************/
+
+/*
+   Horner's rule takes length*n multiplications to evaluate at n points, the 
+   subproduct tree roughly L*log(L)^2 for L = max(length, n). We use Horner 
+   when the former is less than CUTOFF times the latter, with a smaller 
+   cutoff when the tree is already built.
+*/
+#define ZMOD_POLY_EVALUATE_VEC_CUTOFF (flint_tuning.zmod_poly_evaluate_vec_cutoff)
+#define ZMOD_POLY_EVALUATE_VEC_TREE_CUTOFF (flint_tuning.zmod_poly_evaluate_vec_tree_cutoff)
+#define ZMOD_POLY_TREE_EVALUATE_CUTOFF (flint_tuning.zmod_poly_tree_evaluate_cutoff) // stop descending the tree at nodes of this degree
+
+void zmod_poly_tree_init(zmod_poly_tree_t tree, ulong * points, ulong n, ulong p);
+
+void zmod_poly_tree_clear(zmod_poly_tree_t tree);
+
+void zmod_poly_evaluate_vec_horner(ulong * res, zmod_poly_t poly, ulong * points, ulong n);
+
+void zmod_poly_evaluate_vec_tree(ulong * res, zmod_poly_t poly, zmod_poly_tree_t tree);
+
+void zmod_poly_evaluate_vec(ulong * res, zmod_poly_t poly, ulong * points, ulong n);
+
+/*
+   Set poly to the polynomial of length at most n taking the values ys at the
+   n points. Returns 1 if successful, or 0, leaving poly unchanged, if the 
+   points are not distinct.
+*/
+int zmod_poly_interpolate_tree(zmod_poly_t poly, zmod_poly_tree_t tree, ulong * ys);
+
+int zmod_poly_interpolate(zmod_poly_t poly, ulong * xs, ulong * ys, ulong n);
+
 /**************************************************************************************************
 
    Composition
@@ -910,15 +980,42 @@ unsigned long zmod_poly_factor(zmod_poly_factor_t result, zmod_poly_t input);
    zmod_poly matrix routines
 */
 
+#define ZMOD_POLY_2X2_TRANSFORM_CUTOFF (flint_tuning.zmod_poly_2x2_transform_thresh) // minimum length for which 2x2 products are done in the transform domain
+
 void zmod_poly_2x2_mat_mul_classical(zmod_poly_2x2_mat_t R, zmod_poly_2x2_mat_t A, 
 												                        zmod_poly_2x2_mat_t B);
 
 void zmod_poly_2x2_mat_mul_strassen(zmod_poly_2x2_mat_t R, zmod_poly_2x2_mat_t A, 
 												                        zmod_poly_2x2_mat_t B);
 
+void zmod_poly_2x2_mat_mul_transform(zmod_poly_2x2_mat_t R, zmod_poly_2x2_mat_t A, 
+												                        zmod_poly_2x2_mat_t B);
+
 void zmod_poly_2x2_mat_mul(zmod_poly_2x2_mat_t R, zmod_poly_2x2_mat_t A, 
 									                         zmod_poly_2x2_mat_t B);
 
+/*
+   Sets C to the product of the r x s matrix A and the s x t matrix B, all 
+   given as arrays of pointers to polynomials stored row by row. The entries 
+   of C may alias entries of A and B. Each input is transformed only once and 
+   the products are summed in the transform domain, so one inverse transform 
+   is done per entry of C.
+*/
+void _zmod_poly_mat_mul(zmod_poly_p * C, zmod_poly_p * A, zmod_poly_p * B, 
+                                       unsigned long r, unsigned long s, unsigned long t);
+
+/*
+   As above, but with the matrices given as arrays of polynomials, stored 
+   row by row.
+*/
+void zmod_poly_mat_mul(zmod_poly_struct * C, zmod_poly_struct * A, zmod_poly_struct * B, 
+                                       unsigned long r, unsigned long s, unsigned long t);
+
+/*
+   Sets res to the sum of a[i]*b[i] for i in [0, n).
+*/
+void zmod_poly_dot(zmod_poly_t res, zmod_poly_struct * a, zmod_poly_struct * b, unsigned long n);
+
 #ifdef __cplusplus
  }
 #endif
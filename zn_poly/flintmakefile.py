@@ -13,14 +13,14 @@ version = "0.9"
 # compiled in both optimised and debug modes.
 lib_modules = ["array", "invert", "ks_support", "mulmid", "mulmid_ks", "misc",
                "mpn_mulmid", "mul", "mul_fft", "mul_fft_dft", "mul_ks",
-               "nuss", "pack", "pmf", "pmfvec_fft", "tuning", "zn_mod"]
+               "nuss", "ntt", "pack", "pmf", "pmfvec_fft", "tuning", "zn_mod"]
 lib_modules = ["src/" + x for x in lib_modules]
 
 # These are modules containing various test routines. They get compiled
 # in debug mode only.
 test_modules = ["test", "ref_mul", "invert-test", "pmfvec_fft-test",
                 "mulmid_ks-test", "mpn_mulmid-test", "mul_fft-test",
-                "mul_ks-test", "nuss-test", "pack-test"]
+                "mul_ks-test", "nuss-test", "ntt-test", "pack-test"]
 test_modules = ["test/" + x for x in test_modules]
 
 # These are modules containing various profiling routines. They get compiled
@@ -92,6 +92,16 @@ ulong
 random_modulus (unsigned b, int require_odd);
 
 
+/*
+   Returns random prime p with exactly b bits, such that 2^lgN divides p - 1.
+   
+   Must have lgN + 8 <= b <= ULONG_BITS (so that there are plenty of
+   candidates to choose from).
+*/
+ulong
+random_ntt_prime (unsigned b, unsigned lgN);
+
+
 /*
    Prints array to stdout, in format e.g. "[2 3 7]".
 */
@@ -207,6 +217,11 @@ tune_nuss (FILE* flog, int sqr, int verbose);
 void
 tune_mul (FILE* flog, int sqr, int verbose);
 
+#define tune_mul_ntt \
+    ZNP_tune_mul_ntt
+void
+tune_mul_ntt (FILE* flog, int sqr, int verbose);
+
 #define tune_mulmid \
     ZNP_tune_mulmid
 void
@@ -275,6 +290,7 @@ enum
    ALGO_MUL_KS4,
    ALGO_MUL_KS4_REDC,
    ALGO_MUL_FFT,
+   ALGO_MUL_NTT,
    ALGO_MUL_NTL,
 };
 
@@ -50,20 +50,29 @@ do_line (int* active, unsigned b, size_t n, int sqr)
    char* names[] = {"best",
                     "ks1", "ks1_redc", "ks2", "ks2_redc",
                     "ks3", "ks3_redc", "ks4", "ks4_redc",
-                    "fft", "ntl"};
+                    "fft", "ntt", "ntl"};
 
    profile_info_t info;
    info->n1 = info->n2 = n;
 
-   // choose an odd modulus exactly b bits long
-   info->m = (1UL << (b - 1)) + 2 * random_ulong (1UL << (b - 2)) + 1;
+   // choose an odd modulus exactly b bits long; if the NTT is being
+   // profiled, it must support a transform of length 2n - 1
+   unsigned lgN = ceil_lg (2 * n - 1);
+   if (active[ALGO_MUL_NTT])
+   {
+      if (b < lgN + 8 || b > ULONG_BITS - 2)
+         return;
+      info->m = random_ntt_prime (b, lgN);
+   }
+   else
+      info->m = (1UL << (b - 1)) + 2 * random_ulong (1UL << (b - 2)) + 1;
    info->sqr = sqr;
 
    printf ("len = %5lu, bits = %2u", n, b);
    fflush (stdout);
 
    int algo;
-   for (algo = 0; algo < 11; algo++)
+   for (algo = 0; algo < 12; algo++)
    {
       if (active[algo])
       {
@@ -90,7 +99,7 @@ prof_main (int argc, char* argv[])
    // read command line arguments
    
    // can include the strings "best", "ks1", "ks1_redc", "ks2", "ks2_redc",
-   // "ks3", "ks3_redc", "ks4", "ks4_redc", "fft", "ntl"
+   // "ks3", "ks3_redc", "ks4", "ks4_redc", "fft", "ntt", "ntl"
    // to select various algorithms
    
    // can also include "sqr" anywhere, which means to profile squaring
@@ -101,7 +110,7 @@ prof_main (int argc, char* argv[])
    // if you do "length <nnn>" then only that length will be profiled
    // otherwise it ranges over various lengths
 
-   int active[11] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+   int active[12] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
    int any_active = 0;
    int sqr = 0;
    
@@ -134,6 +143,8 @@ prof_main (int argc, char* argv[])
          active[ALGO_MUL_KS4_REDC] = any_active = 1;
       else if (!strcmp (argv[i], "fft"))
          active[ALGO_MUL_FFT] = any_active = 1;
+      else if (!strcmp (argv[i], "ntt"))
+         active[ALGO_MUL_NTT] = any_active = 1;
       else if (!strcmp (argv[i], "ntl"))
          active[ALGO_MUL_NTL] = any_active = 1;
 
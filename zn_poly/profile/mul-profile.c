@@ -29,8 +29,8 @@
 
 
 /*
-   Wrapper functions to make zn_array_mul and zn_array_mul_fft look as if
-   they have a redc flag.
+   Wrapper functions to make zn_array_mul, zn_array_mul_fft and
+   zn_array_mul_ntt look as if they have a redc flag.
 */
 
 void
@@ -56,6 +56,21 @@ zn_array_mul_fft_wrapper (ulong* res,
 }
 
 
+void
+zn_array_mul_ntt_wrapper (ulong* res,
+                          const ulong* op1, size_t n1,
+                          const ulong* op2, size_t n2,
+                          int redc, const zn_mod_t mod)
+{
+   // includes the cost of computing the twiddle factors
+   ntt_t ntt;
+   if (!ntt_init (ntt, ceil_lg (n1 + n2 - 1), mod))
+      abort ();
+   zn_array_mul_ntt (res, op1, n1, op2, n2, ntt);
+   ntt_clear (ntt);
+}
+
+
 double
 profile_mul (void* arg, unsigned long count)
 {
@@ -99,6 +114,8 @@ profile_mul (void* arg, unsigned long count)
       case ALGO_MUL_KS4_REDC:  target = zn_array_mul_KS4; redc = 1; break;
       case ALGO_MUL_FFT:       target = zn_array_mul_fft_wrapper; redc = 0;
                                break;
+      case ALGO_MUL_NTT:       target = zn_array_mul_ntt_wrapper; redc = 0;
+                               break;
       default: abort ();
    }
    
@@ -23,6 +23,22 @@
 #include "zn_poly_internal.h"
 
 
+/*
+   Returns nonzero if the n1 x n2 product should be done via the
+   number-theoretic transform (see ntt.c).
+*/
+int
+zn_array_mul_use_ntt (size_t n1, size_t n2, int sqr, const zn_mod_t mod)
+{
+   tuning_info_t* i = &tuning_info[mod->bits];
+
+   if (n2 < (sqr ? i->sqr_ntt_thresh : i->mul_ntt_thresh))
+      return 0;
+
+   return ntt_cache_root (ceil_lg (n1 + n2 - 1), mod) != 0;
+}
+
+
 ulong
 _zn_array_mul_fudge (size_t n1, size_t n2, int sqr, const zn_mod_t mod)
 {
@@ -33,6 +49,10 @@ _zn_array_mul_fudge (size_t n1, size_t n2, int sqr, const zn_mod_t mod)
       // no fudge if the modulus is even.
       return 1;
 
+   if (zn_array_mul_use_ntt (n1, n2, sqr, mod))
+      // no fudge for the number-theoretic transform either
+      return 1;
+
    tuning_info_t* i = &tuning_info[mod->bits];
 
    if (!sqr)
@@ -77,8 +97,18 @@ _zn_array_mul (ulong* res,
    }
 
    tuning_info_t* i = &tuning_info[mod->bits];
+   int sqr = (op1 == op2  &&  n1 == n2);
+
+   if (zn_array_mul_use_ntt (n1, n2, sqr, mod))
+   {
+      // FFT-friendly modulus; the NTT is exact, so ignore fastred. The
+      // check above has already cached the root for this length.
+      zn_array_mul_ntt (res, op1, n1, op2, n2,
+                        ntt_cache_get (ceil_lg (n1 + n2 - 1), mod));
+      return;
+   }
    
-   if (op1 != op2  ||  n1 != n2)
+   if (!sqr)
    {
       // multiplying two distinct inputs
       
@@ -129,4 +159,65 @@ zn_array_mul (ulong* res,
 }
 
 
+void
+zn_array_mat_mul (ulong** res,
+                  const ulong* const* op1, const size_t* n1,
+                  const ulong* const* op2, const size_t* n2,
+                  unsigned r, unsigned s, unsigned t, const zn_mod_t mod)
+{
+   ulong i, j, k;
+   size_t N1 = 0, N2 = 0;
+
+   for (i = 0; i < (ulong) r * s; i++)
+      N1 = ZNP_MAX (N1, n1[i]);
+   for (i = 0; i < (ulong) s * t; i++)
+      N2 = ZNP_MAX (N2, n2[i]);
+
+   if (N1 == 0 || N2 == 0)
+      return;
+
+   size_t n3 = N1 + N2 - 1;
+   size_t lo = ZNP_MIN (N1, N2), hi = ZNP_MAX (N1, N2);
+   tuning_info_t* info = &tuning_info[mod->bits];
+
+   if ((mod->m & 1) && lo >= info->mul_fft_thresh
+                    && !zn_array_mul_use_ntt (hi, lo, 0, mod))
+   {
+      // accumulate in the fourier domain
+      ulong x = zn_array_mul_fft_fudge (N1, N2, 0, mod);
+      zn_array_mat_mul_fft (res, op1, n1, op2, n2, r, s, t, x, mod);
+      return;
+   }
+
+   // otherwise just add up the individual products
+   ulong* temp = (ulong*) malloc (sizeof (ulong) * n3);
+
+   for (i = 0; i < r; i++)
+   for (j = 0; j < t; j++)
+   {
+      ulong* dest = res[i * t + j];
+      zn_array_zero (dest, n3);
+
+      for (k = 0; k < s; k++)
+      {
+         const ulong* a = op1[i * s + k];
+         const ulong* b = op2[k * t + j];
+         size_t na = n1[i * s + k], nb = n2[k * t + j];
+
+         if (na == 0 || nb == 0)
+            continue;
+
+         if (na >= nb)
+            zn_array_mul (temp, a, na, b, nb, mod);
+         else
+            zn_array_mul (temp, b, nb, a, na, mod);
+
+         zn_array_add_inplace (dest, temp, na + nb - 1, mod);
+      }
+   }
+
+   free (temp);
+}
+
+
 // end of file ****************************************************************
@@ -490,6 +490,229 @@ void zn_array_mul_fft (ulong* res,
 
 
 
+/*
+   The following helpers operate on the first n coefficients of pmfvec_t's
+   with identical parameters.
+
+   res := op1 + op2 (res may alias op1 but not op2)
+*/
+static void
+pmfvec_add_n (pmfvec_t res, const pmfvec_t op1, const pmfvec_t op2, ulong n)
+{
+   ulong i;
+   for (i = 0; i < n; i++)
+   {
+      pmf_t p = res->data + i * res->skip;
+      if (res != op1)
+         pmf_set (p, op1->data + i * op1->skip, op1->M);
+      pmf_add (p, op2->data + i * op2->skip, res->M, res->mod);
+   }
+}
+
+/*
+   res := op1 - op2 (res may alias either input)
+*/
+static void
+pmfvec_sub_n (pmfvec_t res, const pmfvec_t op1, const pmfvec_t op2, ulong n)
+{
+   ulong i;
+   for (i = 0; i < n; i++)
+   {
+      pmf_t p = res->data + i * res->skip;
+      if (res == op2)
+      {
+         // compute op2 - op1, then negate by rotating through Y^M = -1
+         pmf_sub (p, op1->data + i * op1->skip, res->M, res->mod);
+         pmf_rotate (p, res->M);
+         continue;
+      }
+      if (res != op1)
+         pmf_set (p, op1->data + i * op1->skip, op1->M);
+      pmf_sub (p, op2->data + i * op2->skip, res->M, res->mod);
+   }
+}
+
+
+/*
+   2 x 2 product in the fourier domain, using the Strassen-Winograd formulae
+   on the transformed entries of A = [a b; c d] and B = [e f; g h]. This needs
+   7 pointwise multiplications instead of 8. The transforms are all of
+   length n; the transforms of A are used as scratch space.
+*/
+static void
+mat_mul_2x2_fft (pmfvec_struct* R, pmfvec_struct* A, const pmfvec_struct* B,
+                 pmfvec_t x0, pmfvec_t x1, ulong n)
+{
+   pmfvec_struct *a = A, *b = A + 1, *c = A + 2, *d = A + 3;
+   const pmfvec_struct *e = B, *f = B + 1, *g = B + 2, *h = B + 3;
+   pmfvec_struct *Ra = R, *Rb = R + 1, *Rc = R + 2, *Rd = R + 3;
+
+   pmfvec_sub_n (x0, a, c, n);
+   pmfvec_sub_n (x1, h, f, n);
+   pmfvec_mul (Rc, x0, x1, n, 1);                  // (a - c)(h - f)
+
+   pmfvec_add_n (x0, c, d, n);
+   pmfvec_sub_n (x1, f, e, n);
+   pmfvec_mul (Rd, x0, x1, n, 1);                  // (c + d)(f - e)
+
+   pmfvec_sub_n (x0, x0, a, n);
+   pmfvec_sub_n (x1, h, x1, n);
+   pmfvec_mul (Rb, x0, x1, n, 1);                  // (c + d - a)(h - f + e)
+
+   pmfvec_sub_n (c, b, x0, n);
+   pmfvec_mul (Ra, c, h, n, 1);                    // (a + b - c - d) h
+
+   pmfvec_mul (x0, a, e, n, 1);                    // a e
+
+   pmfvec_add_n (Rb, Rb, x0, n);
+   pmfvec_add_n (Rc, Rc, Rb, n);
+   pmfvec_add_n (Rb, Rb, Rd, n);
+   pmfvec_add_n (Rd, Rd, Rc, n);
+   pmfvec_add_n (Rb, Rb, Ra, n);
+
+   pmfvec_sub_n (x1, x1, g, n);
+   pmfvec_mul (Ra, d, x1, n, 1);                   // d (h - f + e - g)
+   pmfvec_sub_n (Rc, Rc, Ra, n);
+
+   pmfvec_mul (Ra, b, g, n, 1);                    // b g
+   pmfvec_add_n (Ra, Ra, x0, n);
+}
+
+
+
+void zn_array_mat_mul_fft (ulong** res,
+                           const ulong* const* op1, const size_t* n1,
+                           const ulong* const* op2, const size_t* n2,
+                           unsigned r, unsigned s, unsigned t,
+                           ulong x, const zn_mod_t mod)
+{
+   ZNP_ASSERT (mod->m & 1);
+
+   ulong i, j, k, l;
+   size_t N1 = 0, N2 = 0;
+   int dense = 1;
+
+   for (i = 0; i < (ulong) r * s; i++)
+   {
+      N1 = ZNP_MAX (N1, n1[i]);
+      dense = dense && n1[i];
+   }
+   for (i = 0; i < (ulong) s * t; i++)
+   {
+      N2 = ZNP_MAX (N2, n2[i]);
+      dense = dense && n2[i];
+   }
+
+   ZNP_ASSERT (N1 >= 1 && N2 >= 1);
+
+   // all products share the transform parameters of the largest one
+   unsigned lgK, lgM;
+   ulong m1, m2;
+   mul_fft_params (&lgK, &lgM, &m1, &m2, N1, N2);
+
+   ulong m3 = m1 + m2 - 1;
+   ulong M = 1UL << lgM;
+   ptrdiff_t skip = M + 1;
+   size_t n3 = N1 + N2 - 1;
+
+   // split inputs into pmf_t's and perform FFTs, once per input;
+   // the fudge factor is applied to the entries of op2
+   pmfvec_struct* vec1 = (pmfvec_struct*) malloc (sizeof (pmfvec_struct)
+                                                  * r * s);
+   pmfvec_struct* vec2 = (pmfvec_struct*) malloc (sizeof (pmfvec_struct)
+                                                  * s * t);
+
+   for (i = 0; i < (ulong) r * s; i++)
+   {
+      if (n1[i] == 0)
+         continue;
+      pmfvec_init (vec1 + i, lgK, skip, lgM, mod);
+      fft_split (vec1 + i, op1[i], n1[i], 0, 1, 0);
+      pmfvec_fft (vec1 + i, m3, CEIL_DIV_2EXP (n1[i], lgM - 1), 0);
+   }
+
+   for (i = 0; i < (ulong) s * t; i++)
+   {
+      if (n2[i] == 0)
+         continue;
+      pmfvec_init (vec2 + i, lgK, skip, lgM, mod);
+      fft_split (vec2 + i, op2[i], n2[i], 0, x, 0);
+      pmfvec_fft (vec2 + i, m3, CEIL_DIV_2EXP (n2[i], lgM - 1), 0);
+   }
+
+   pmfvec_t acc, prod;
+   pmfvec_init (acc, lgK, skip, lgM, mod);
+   pmfvec_init (prod, lgK, skip, lgM, mod);
+
+   if (r == 2 && s == 2 && t == 2 && dense)
+   {
+      pmfvec_struct R[4];
+      for (i = 0; i < 4; i++)
+         pmfvec_init (R + i, lgK, skip, lgM, mod);
+
+      mat_mul_2x2_fft (R, vec1, vec2, acc, prod, m3);
+
+      // inverse FFTs, and write output
+      for (i = 0; i < 4; i++)
+      {
+         pmfvec_ifft (R + i, m3, 0, m3, 0);
+         fft_combine (res[i], n3, R + i, m3, 0);
+         pmfvec_clear (R + i);
+      }
+   }
+   else
+   {
+      for (i = 0; i < r; i++)
+      for (j = 0; j < t; j++)
+      {
+         // accumulate the pointwise products for entry (i, j)
+         int empty = 1;
+
+         for (k = 0; k < s; k++)
+         {
+            if (n1[i * s + k] == 0 || n2[k * t + j] == 0)
+               continue;
+
+            if (empty)
+               pmfvec_mul (acc, vec1 + i * s + k, vec2 + k * t + j, m3, 1);
+            else
+            {
+               pmfvec_mul (prod, vec1 + i * s + k, vec2 + k * t + j, m3, 1);
+               for (l = 0; l < m3; l++)
+                  pmf_add (acc->data + l * skip, prod->data + l * skip, M,
+                           mod);
+            }
+            empty = 0;
+         }
+
+         if (empty)
+         {
+            zn_array_zero (res[i * t + j], n3);
+            continue;
+         }
+
+         // inverse FFT, and write output
+         pmfvec_ifft (acc, m3, 0, m3, 0);
+         fft_combine (res[i * t + j], n3, acc, m3, 0);
+      }
+   }
+
+   pmfvec_clear (prod);
+   pmfvec_clear (acc);
+
+   for (i = 0; i < (ulong) s * t; i++)
+      if (n2[i])
+         pmfvec_clear (vec2 + i);
+   for (i = 0; i < (ulong) r * s; i++)
+      if (n1[i])
+         pmfvec_clear (vec1 + i);
+
+   free (vec2);
+   free (vec1);
+}
+
+
+
 /* ============================================================================
 
      middle product routines
@@ -0,0 +1,765 @@
+/*
+   ntt.c:  number-theoretic transforms for FFT-friendly moduli
+
+   Copyright (C) 2010, William Hart
+
+   This file is part of the zn_poly library (version 0.9).
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) version 3 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/*
+   If the modulus is p = k*2^v + 1, the multiplicative group contains
+   2^v-th roots of unity, and we can multiply polynomials with a plain
+   length 2^lgN transform over Z/pZ for any lgN <= v, instead of going
+   through the Schonhage/Nussbaumer pmf machinery.
+
+   The transforms use "lazy" butterflies: each twiddle factor w comes with
+   the precomputed value w' = floor(w * B / p) (Shoup's trick, as used in
+   NTL), so that x * w mod p may be computed with two multiplications, into
+   the range [0, 2p), for any x < B. The forward transform (Gentleman-Sande,
+   decimation in frequency) keeps its values in [0, 2p); the inverse
+   transform (Cooley-Tukey, decimation in time) keeps them in [0, 4p). This
+   requires 4p < B, i.e. p must have at most ULONG_BITS - 2 bits.
+
+   Pairs of layers are fused into radix-4 passes, to halve the number of
+   trips through memory.
+
+   If p < 2^30 and the machine supports AVX2, the radix-4 passes use 4-way
+   vector versions of the butterflies, with 32-bit Shoup precomputations
+   (namely w' >> (ULONG_BITS - 32)).
+*/
+
+#include "zn_poly_internal.h"
+
+#if FLINT_HAVE_AVX2_DISPATCH
+#include <immintrin.h>
+#endif
+
+
+/*
+   We give up looking for a 2^v-th root of unity after trying this many
+   candidate generators (only relevant if the modulus isn't prime).
+*/
+#define NTT_ROOT_SEARCH_LIMIT 256
+
+
+/*
+   Returns floor(w * B / m), where w is in [0, m) and m is odd.
+
+   Since w * B - (w * B mod m) is exactly divisible by m, and the quotient is
+   less than B, we can compute it by multiplying by m^(-1) mod B.
+*/
+ZNP_INLINE ulong
+ntt_shoup_pre (ulong w, const zn_mod_t mod)
+{
+   ulong r = zn_mod_reduce_wide (w, 0, mod);
+   return -r * mod->inv3;
+}
+
+
+/*
+   Returns x * w mod p, in the range [0, 2p). Any x < B is allowed; w must be
+   in [0, p), and wpre must be ntt_shoup_pre(w).
+*/
+#define NTT_MULMOD_SHOUP(rrr, xxx, www, wpre, ppp)                           \
+   do {                                                                     \
+      ulong __q;                                                            \
+      ZNP_MUL_HI (__q, (xxx), (wpre));                                      \
+      (rrr) = (xxx) * (www) - __q * (ppp);                                  \
+   } while (0)
+
+
+/*
+   Gentleman-Sande butterfly: (X, Y) -> (X + Y, (X - Y) * w).
+   Inputs and outputs in [0, 2p). p2 = 2p.
+*/
+#define NTT_BUTTERFLY_GS(XXX, YYY, www, wpre, ppp, p2)                       \
+   do {                                                                     \
+      ulong __x = (XXX), __y = (YYY), __t;                                  \
+      __t = __x + __y;                                                      \
+      if (__t >= (p2))                                                      \
+         __t -= (p2);                                                       \
+      __x = __x - __y + (p2);                                               \
+      NTT_MULMOD_SHOUP (YYY, __x, www, wpre, ppp);                          \
+      (XXX) = __t;                                                          \
+   } while (0)
+
+
+/*
+   Cooley-Tukey butterfly: (X, Y) -> (X + Y * w, X - Y * w).
+   Inputs and outputs in [0, 4p). p2 = 2p.
+*/
+#define NTT_BUTTERFLY_CT(XXX, YYY, www, wpre, ppp, p2)                       \
+   do {                                                                     \
+      ulong __x = (XXX), __t;                                               \
+      if (__x >= (p2))                                                      \
+         __x -= (p2);                                                       \
+      NTT_MULMOD_SHOUP (__t, (YYY), www, wpre, ppp);                        \
+      (XXX) = __x + __t;                                                    \
+      (YYY) = __x - __t + (p2);                                             \
+   } while (0)
+
+
+
+ulong
+zn_mod_ntt_root (unsigned lgN, const zn_mod_t mod)
+{
+   ulong m = mod->m;
+
+   // need m odd, and 4m < B for the lazy butterflies
+   if (!(m & 1) || mod->bits > ULONG_BITS - 2)
+      return 0;
+
+   // write m - 1 = t * 2^v with t odd
+   ulong t = m - 1;
+   unsigned v = 0;
+   while (!(t & 1))
+   {
+      t >>= 1;
+      v++;
+   }
+
+   if (lgN > v)
+      return 0;
+
+   ulong g;
+   unsigned i;
+
+   for (g = 2; g < m && g < NTT_ROOT_SEARCH_LIMIT; g++)
+   {
+      // w = g^t has order dividing 2^v; it has order exactly 2^v if and only
+      // if w^(2^(v-1)) = -1. In that case, if w_N = w^(2^(v-lgN)), we have
+      // w_N^(N/2) = -1, which makes w_N a principal N-th root of unity
+      // (even if m isn't prime), which is all the convolution theorem needs.
+      ulong w = zn_mod_pow (g, t, mod);
+      ulong x = w;
+      for (i = 1; i < v; i++)
+         x = zn_mod_mul (x, x, mod);
+
+      if (x == m - 1)
+      {
+         for (i = lgN; i < v; i++)
+            w = zn_mod_mul (w, w, mod);
+         return w;
+      }
+   }
+
+   return 0;
+}
+
+
+
+/*
+   As ntt_init(), given the root w = zn_mod_ntt_root (lgN, mod), which must
+   be nonzero.
+*/
+static void
+ntt_init_root (ntt_t res, unsigned lgN, ulong w, const zn_mod_t mod)
+{
+   ulong m = mod->m;
+   ulong N = 1UL << lgN;
+   ulong half = N / 2;
+
+   res->mod = mod;
+   res->lgN = lgN;
+
+   res->w = (ulong*) malloc (4 * N * sizeof (ulong));
+   res->wpre = res->w + N;
+   res->wi = res->w + 2 * N;
+   res->wipre = res->w + 3 * N;
+
+   // top layer: w[N/2 + j] = w_N^j for 0 <= j < N/2
+   ulong wpre = ntt_shoup_pre (w, mod);
+   ulong x = 1, j;
+   for (j = 0; j < half; j++)
+   {
+      res->w[half + j] = x;
+      res->wpre[half + j] = ntt_shoup_pre (x, mod);
+      NTT_MULMOD_SHOUP (x, x, w, wpre, m);
+      if (x >= m)
+         x -= m;
+   }
+
+   // inverse roots: w_N^(-j) = -w_N^(N/2 - j) for 0 < j < N/2. For w != 0,
+   // floor((m - w) * B / m) = B - 1 - floor(w * B / m), since m is odd.
+   res->wi[half] = 1;
+   res->wipre[half] = res->wpre[half];
+   for (j = 1; j < half; j++)
+   {
+      res->wi[half + j] = m - res->w[N - j];
+      res->wipre[half + j] = ~res->wpre[N - j];
+   }
+
+   // lower layers: w[h + j] = w_{2h}^j = w_N^(j * N/(2h))
+   ulong h;
+   unsigned s = 1;
+   for (h = half / 2; h >= 1; h /= 2, s++)
+   {
+      for (j = 0; j < h; j++)
+      {
+         res->w[h + j] = res->w[half + (j << s)];
+         res->wpre[h + j] = res->wpre[half + (j << s)];
+         res->wi[h + j] = res->wi[half + (j << s)];
+         res->wipre[h + j] = res->wipre[half + (j << s)];
+      }
+   }
+
+   // 1/N mod m
+   res->Ninv = zn_mod_invert (N % m, mod);
+   res->Ninv_pre = ntt_shoup_pre (res->Ninv, mod);
+
+   res->avx2 = (FLINT_HAVE_AVX2_DISPATCH && mod->bits <= 30
+                && flint_have_avx2 ());
+}
+
+
+
+int
+ntt_init (ntt_t res, unsigned lgN, const zn_mod_t mod)
+{
+   ZNP_ASSERT (lgN >= 1);
+
+   ulong w = zn_mod_ntt_root (lgN, mod);
+   if (w == 0)
+      return 0;
+
+   ntt_init_root (res, lgN, w, mod);
+   return 1;
+}
+
+
+
+void
+ntt_clear (ntt_t op)
+{
+   free (op->w);
+}
+
+
+
+/* ============================================================================
+
+     cached transforms
+
+============================================================================ */
+
+/*
+   Each thread caches the roots and tables for the last NTT_CACHE_SIZE
+   moduli and lengths it used, so that repeated products modulo the same m
+   neither search for a root nor rebuild the tables. The cache is thread
+   local (see THREAD in flint.h), so it needs no locking under OpenMP.
+
+   An entry keeps its own copy of the modulus, for its tables to point to,
+   and only builds the tables when they are first asked for. Unused entries
+   have m = 0.
+*/
+#define NTT_CACHE_SIZE 4
+
+typedef struct
+{
+   zn_mod_t mod;
+   unsigned lgN;
+   ulong w;       // zn_mod_ntt_root (lgN, mod)
+   ntt_t ntt;     // the tables, if ntt->w is not NULL
+}
+ntt_cache_entry_t;
+
+static THREAD ntt_cache_entry_t ntt_cache[NTT_CACHE_SIZE];
+static THREAD unsigned ntt_cache_next = 0;
+
+
+/*
+   Returns the entry for lgN and mod, replacing the oldest entry if there
+   isn't one yet.
+*/
+static ntt_cache_entry_t*
+ntt_cache_lookup (unsigned lgN, const zn_mod_t mod)
+{
+   unsigned i;
+   for (i = 0; i < NTT_CACHE_SIZE; i++)
+      if (ntt_cache[i].mod->m == mod->m && ntt_cache[i].lgN == lgN)
+         return ntt_cache + i;
+
+   ntt_cache_entry_t* entry = ntt_cache + ntt_cache_next;
+   ntt_cache_next = (ntt_cache_next + 1) % NTT_CACHE_SIZE;
+
+   if (entry->ntt->w != NULL)
+   {
+      ntt_clear (entry->ntt);
+      entry->ntt->w = NULL;
+   }
+
+   entry->mod[0] = mod[0];
+   entry->lgN = lgN;
+   entry->w = zn_mod_ntt_root (lgN, mod);
+
+   return entry;
+}
+
+
+ulong
+ntt_cache_root (unsigned lgN, const zn_mod_t mod)
+{
+   return ntt_cache_lookup (lgN, mod)->w;
+}
+
+
+const ntt_struct*
+ntt_cache_get (unsigned lgN, const zn_mod_t mod)
+{
+   ZNP_ASSERT (lgN >= 1);
+
+   ntt_cache_entry_t* entry = ntt_cache_lookup (lgN, mod);
+   if (entry->w == 0)
+      return NULL;
+
+   if (entry->ntt->w == NULL)
+      ntt_init_root (entry->ntt, lgN, entry->w, entry->mod);
+
+   return entry->ntt;
+}
+
+
+
+/* ============================================================================
+
+     scalar transform layers
+
+============================================================================ */
+
+/*
+   One layer of the forward transform, with butterflies of span h.
+*/
+ZNP_INLINE void
+ntt_fft_radix2 (ulong* op, ulong h, const ntt_t ntt)
+{
+   ulong N = 1UL << ntt->lgN;
+   ulong p = ntt->mod->m, p2 = 2 * p;
+   const ulong* w = ntt->w + h;
+   const ulong* wpre = ntt->wpre + h;
+   ulong b, j;
+
+   for (b = 0; b < N; b += 2 * h)
+   {
+      ulong* x = op + b;
+      for (j = 0; j < h; j++)
+         NTT_BUTTERFLY_GS (x[j], x[j + h], w[j], wpre[j], p, p2);
+   }
+}
+
+
+/*
+   Two layers of the forward transform, with butterflies of span 2q and q,
+   for j in [start, q) within each block of length 4q.
+*/
+ZNP_INLINE void
+ntt_fft_radix4_block (ulong* x, ulong q, ulong start, const ntt_t ntt)
+{
+   ulong p = ntt->mod->m, p2 = 2 * p;
+   const ulong* w1 = ntt->w + 2 * q;
+   const ulong* w1pre = ntt->wpre + 2 * q;
+   const ulong* w2 = ntt->w + q;
+   const ulong* w2pre = ntt->wpre + q;
+   ulong j;
+
+   for (j = start; j < q; j++)
+   {
+      ulong x0 = x[j], x1 = x[j + q], x2 = x[j + 2*q], x3 = x[j + 3*q];
+
+      NTT_BUTTERFLY_GS (x0, x2, w1[j], w1pre[j], p, p2);
+      NTT_BUTTERFLY_GS (x1, x3, w1[j + q], w1pre[j + q], p, p2);
+      NTT_BUTTERFLY_GS (x0, x1, w2[j], w2pre[j], p, p2);
+      NTT_BUTTERFLY_GS (x2, x3, w2[j], w2pre[j], p, p2);
+
+      x[j] = x0;
+      x[j + q] = x1;
+      x[j + 2*q] = x2;
+      x[j + 3*q] = x3;
+   }
+}
+
+
+/*
+   One layer of the inverse transform, with butterflies of span h.
+*/
+ZNP_INLINE void
+ntt_ifft_radix2 (ulong* op, ulong h, const ntt_t ntt)
+{
+   ulong N = 1UL << ntt->lgN;
+   ulong p = ntt->mod->m, p2 = 2 * p;
+   const ulong* w = ntt->wi + h;
+   const ulong* wpre = ntt->wipre + h;
+   ulong b, j;
+
+   for (b = 0; b < N; b += 2 * h)
+   {
+      ulong* x = op + b;
+      for (j = 0; j < h; j++)
+         NTT_BUTTERFLY_CT (x[j], x[j + h], w[j], wpre[j], p, p2);
+   }
+}
+
+
+/*
+   Two layers of the inverse transform, with butterflies of span q and 2q,
+   for j in [start, q) within each block of length 4q.
+*/
+ZNP_INLINE void
+ntt_ifft_radix4_block (ulong* x, ulong q, ulong start, const ntt_t ntt)
+{
+   ulong p = ntt->mod->m, p2 = 2 * p;
+   const ulong* w1 = ntt->wi + q;
+   const ulong* w1pre = ntt->wipre + q;
+   const ulong* w2 = ntt->wi + 2 * q;
+   const ulong* w2pre = ntt->wipre + 2 * q;
+   ulong j;
+
+   for (j = start; j < q; j++)
+   {
+      ulong x0 = x[j], x1 = x[j + q], x2 = x[j + 2*q], x3 = x[j + 3*q];
+
+      NTT_BUTTERFLY_CT (x0, x1, w1[j], w1pre[j], p, p2);
+      NTT_BUTTERFLY_CT (x2, x3, w1[j], w1pre[j], p, p2);
+      NTT_BUTTERFLY_CT (x0, x2, w2[j], w2pre[j], p, p2);
+      NTT_BUTTERFLY_CT (x1, x3, w2[j + q], w2pre[j + q], p, p2);
+
+      x[j] = x0;
+      x[j + q] = x1;
+      x[j + 2*q] = x2;
+      x[j + 3*q] = x3;
+   }
+}
+
+
+
+/* ============================================================================
+
+     AVX2 transform layers
+
+============================================================================ */
+
+#if FLINT_HAVE_AVX2_DISPATCH
+
+/*
+   x * w mod p in [0, 2p), where x < 2^32, w < p < 2^30, and wpre holds
+   floor(w * 2^32 / p).
+*/
+FLINT_TARGET_AVX2 static inline __m256i
+ntt_mulmod_shoup_avx2 (__m256i x, __m256i w, __m256i wpre, __m256i p)
+{
+   __m256i q = _mm256_srli_epi64 (_mm256_mul_epu32 (x, wpre), 32);
+   return _mm256_sub_epi64 (_mm256_mul_epu32 (x, w), _mm256_mul_epu32 (q, p));
+}
+
+
+/*
+   Returns x - 2p if x >= 2p, else x, for x < 2^32 and 2p < 2^31. If x < 2p,
+   the low half of x - 2p wraps around to something bigger than x, and the
+   high half becomes all ones; so an unsigned 32-bit minimum does the job.
+*/
+FLINT_TARGET_AVX2 static inline __m256i
+ntt_reduce_2p_avx2 (__m256i x, __m256i p2)
+{
+   return _mm256_min_epu32 (x, _mm256_sub_epi64 (x, p2));
+}
+
+
+FLINT_TARGET_AVX2 static inline __m256i
+ntt_load_pre_avx2 (const ulong* wpre)
+{
+   return _mm256_srli_epi64 (_mm256_loadu_si256 ((const __m256i*) wpre),
+                             ULONG_BITS - 32);
+}
+
+
+FLINT_TARGET_AVX2 static void
+ntt_fft_radix4_avx2 (ulong* op, ulong q, const ntt_t ntt)
+{
+   ulong N = 1UL << ntt->lgN;
+   __m256i p = _mm256_set1_epi64x (ntt->mod->m);
+   __m256i p2 = _mm256_set1_epi64x (2 * ntt->mod->m);
+   const ulong* w1 = ntt->w + 2 * q;
+   const ulong* w1pre = ntt->wpre + 2 * q;
+   const ulong* w2 = ntt->w + q;
+   const ulong* w2pre = ntt->wpre + q;
+   ulong b, j;
+
+   for (b = 0; b < N; b += 4 * q)
+   {
+      ulong* x = op + b;
+
+      for (j = 0; j + 4 <= q; j += 4)
+      {
+         __m256i x0 = _mm256_loadu_si256 ((__m256i*) (x + j));
+         __m256i x1 = _mm256_loadu_si256 ((__m256i*) (x + j + q));
+         __m256i x2 = _mm256_loadu_si256 ((__m256i*) (x + j + 2*q));
+         __m256i x3 = _mm256_loadu_si256 ((__m256i*) (x + j + 3*q));
+         __m256i wa = _mm256_loadu_si256 ((const __m256i*) (w1 + j));
+         __m256i wb = _mm256_loadu_si256 ((const __m256i*) (w1 + j + q));
+         __m256i wc = _mm256_loadu_si256 ((const __m256i*) (w2 + j));
+         __m256i wapre = ntt_load_pre_avx2 (w1pre + j);
+         __m256i wbpre = ntt_load_pre_avx2 (w1pre + j + q);
+         __m256i wcpre = ntt_load_pre_avx2 (w2pre + j);
+         __m256i t;
+
+         // layer of span 2q
+         t = ntt_reduce_2p_avx2 (_mm256_add_epi64 (x0, x2), p2);
+         x2 = _mm256_add_epi64 (_mm256_sub_epi64 (x0, x2), p2);
+         x2 = ntt_mulmod_shoup_avx2 (x2, wa, wapre, p);
+         x0 = t;
+
+         t = ntt_reduce_2p_avx2 (_mm256_add_epi64 (x1, x3), p2);
+         x3 = _mm256_add_epi64 (_mm256_sub_epi64 (x1, x3), p2);
+         x3 = ntt_mulmod_shoup_avx2 (x3, wb, wbpre, p);
+         x1 = t;
+
+         // layer of span q
+         t = ntt_reduce_2p_avx2 (_mm256_add_epi64 (x0, x1), p2);
+         x1 = _mm256_add_epi64 (_mm256_sub_epi64 (x0, x1), p2);
+         x1 = ntt_mulmod_shoup_avx2 (x1, wc, wcpre, p);
+         x0 = t;
+
+         t = ntt_reduce_2p_avx2 (_mm256_add_epi64 (x2, x3), p2);
+         x3 = _mm256_add_epi64 (_mm256_sub_epi64 (x2, x3), p2);
+         x3 = ntt_mulmod_shoup_avx2 (x3, wc, wcpre, p);
+         x2 = t;
+
+         _mm256_storeu_si256 ((__m256i*) (x + j), x0);
+         _mm256_storeu_si256 ((__m256i*) (x + j + q), x1);
+         _mm256_storeu_si256 ((__m256i*) (x + j + 2*q), x2);
+         _mm256_storeu_si256 ((__m256i*) (x + j + 3*q), x3);
+      }
+
+      ntt_fft_radix4_block (x, q, j, ntt);
+   }
+}
+
+
+FLINT_TARGET_AVX2 static void
+ntt_ifft_radix4_avx2 (ulong* op, ulong q, const ntt_t ntt)
+{
+   ulong N = 1UL << ntt->lgN;
+   __m256i p = _mm256_set1_epi64x (ntt->mod->m);
+   __m256i p2 = _mm256_set1_epi64x (2 * ntt->mod->m);
+   const ulong* w1 = ntt->wi + q;
+   const ulong* w1pre = ntt->wipre + q;
+   const ulong* w2 = ntt->wi + 2 * q;
+   const ulong* w2pre = ntt->wipre + 2 * q;
+   ulong b, j;
+
+   for (b = 0; b < N; b += 4 * q)
+   {
+      ulong* x = op + b;
+
+      for (j = 0; j + 4 <= q; j += 4)
+      {
+         __m256i x0 = _mm256_loadu_si256 ((__m256i*) (x + j));
+         __m256i x1 = _mm256_loadu_si256 ((__m256i*) (x + j + q));
+         __m256i x2 = _mm256_loadu_si256 ((__m256i*) (x + j + 2*q));
+         __m256i x3 = _mm256_loadu_si256 ((__m256i*) (x + j + 3*q));
+         __m256i wa = _mm256_loadu_si256 ((const __m256i*) (w1 + j));
+         __m256i wb = _mm256_loadu_si256 ((const __m256i*) (w2 + j));
+         __m256i wc = _mm256_loadu_si256 ((const __m256i*) (w2 + j + q));
+         __m256i wapre = ntt_load_pre_avx2 (w1pre + j);
+         __m256i wbpre = ntt_load_pre_avx2 (w2pre + j);
+         __m256i wcpre = ntt_load_pre_avx2 (w2pre + j + q);
+         __m256i t;
+
+         // layer of span q
+         x0 = ntt_reduce_2p_avx2 (x0, p2);
+         t = ntt_mulmod_shoup_avx2 (x1, wa, wapre, p);
+         x1 = _mm256_add_epi64 (_mm256_sub_epi64 (x0, t), p2);
+         x0 = _mm256_add_epi64 (x0, t);
+
+         x2 = ntt_reduce_2p_avx2 (x2, p2);
+         t = ntt_mulmod_shoup_avx2 (x3, wa, wapre, p);
+         x3 = _mm256_add_epi64 (_mm256_sub_epi64 (x2, t), p2);
+         x2 = _mm256_add_epi64 (x2, t);
+
+         // layer of span 2q
+         x0 = ntt_reduce_2p_avx2 (x0, p2);
+         t = ntt_mulmod_shoup_avx2 (x2, wb, wbpre, p);
+         x2 = _mm256_add_epi64 (_mm256_sub_epi64 (x0, t), p2);
+         x0 = _mm256_add_epi64 (x0, t);
+
+         x1 = ntt_reduce_2p_avx2 (x1, p2);
+         t = ntt_mulmod_shoup_avx2 (x3, wc, wcpre, p);
+         x3 = _mm256_add_epi64 (_mm256_sub_epi64 (x1, t), p2);
+         x1 = _mm256_add_epi64 (x1, t);
+
+         _mm256_storeu_si256 ((__m256i*) (x + j), x0);
+         _mm256_storeu_si256 ((__m256i*) (x + j + q), x1);
+         _mm256_storeu_si256 ((__m256i*) (x + j + 2*q), x2);
+         _mm256_storeu_si256 ((__m256i*) (x + j + 3*q), x3);
+      }
+
+      ntt_ifft_radix4_block (x, q, j, ntt);
+   }
+}
+
+#endif
+
+
+
+/* ============================================================================
+
+     transforms and multiplication
+
+============================================================================ */
+
+/*
+   Two layers of the forward transform, with butterflies of span 2q and q.
+*/
+ZNP_INLINE void
+ntt_fft_radix4 (ulong* op, ulong q, const ntt_t ntt)
+{
+#if FLINT_HAVE_AVX2_DISPATCH
+   if (ntt->avx2 && q >= 4)
+   {
+      ntt_fft_radix4_avx2 (op, q, ntt);
+      return;
+   }
+#endif
+
+   ulong N = 1UL << ntt->lgN;
+   ulong b;
+   for (b = 0; b < N; b += 4 * q)
+      ntt_fft_radix4_block (op + b, q, 0, ntt);
+}
+
+
+/*
+   Two layers of the inverse transform, with butterflies of span q and 2q.
+*/
+ZNP_INLINE void
+ntt_ifft_radix4 (ulong* op, ulong q, const ntt_t ntt)
+{
+#if FLINT_HAVE_AVX2_DISPATCH
+   if (ntt->avx2 && q >= 4)
+   {
+      ntt_ifft_radix4_avx2 (op, q, ntt);
+      return;
+   }
+#endif
+
+   ulong N = 1UL << ntt->lgN;
+   ulong b;
+   for (b = 0; b < N; b += 4 * q)
+      ntt_ifft_radix4_block (op + b, q, 0, ntt);
+}
+
+
+
+void
+ntt_fft (ulong* op, const ntt_t ntt)
+{
+   unsigned lgN = ntt->lgN;
+   ulong q = 1UL << lgN;
+
+   // if there are an odd number of layers, do the first one on its own
+   if (lgN & 1)
+   {
+      q /= 2;
+      ntt_fft_radix2 (op, q, ntt);
+   }
+
+   for (q /= 4; q >= 1; q /= 4)
+      ntt_fft_radix4 (op, q, ntt);
+}
+
+
+
+void
+ntt_ifft (ulong* op, const ntt_t ntt)
+{
+   unsigned lgN = ntt->lgN;
+   ulong N = 1UL << lgN;
+   ulong q;
+
+   for (q = 1; 4 * q <= N; q *= 4)
+      ntt_ifft_radix4 (op, q, ntt);
+
+   // if there are an odd number of layers, do the last one on its own
+   if (lgN & 1)
+      ntt_ifft_radix2 (op, N / 2, ntt);
+}
+
+
+
+void
+zn_array_mul_ntt (ulong* res,
+                  const ulong* op1, size_t n1,
+                  const ulong* op2, size_t n2,
+                  const ntt_t ntt)
+{
+   const zn_mod_struct* mod = ntt->mod;
+   ulong p = mod->m, p2 = 2 * p;
+   ulong N = 1UL << ntt->lgN;
+   int sqr = (op1 == op2) && (n1 == n2);
+   size_t i;
+
+   ZNP_ASSERT (n2 >= 1);
+   ZNP_ASSERT (n1 + n2 - 1 <= N);
+
+   ulong* buf1 = (ulong*) malloc ((sqr ? 1 : 2) * N * sizeof (ulong));
+   ulong* buf2 = sqr ? buf1 : buf1 + N;
+
+   for (i = 0; i < n1; i++)
+      buf1[i] = op1[i];
+   for (; i < N; i++)
+      buf1[i] = 0;
+   ntt_fft (buf1, ntt);
+
+   if (!sqr)
+   {
+      for (i = 0; i < n2; i++)
+         buf2[i] = op2[i];
+      for (; i < N; i++)
+         buf2[i] = 0;
+      ntt_fft (buf2, ntt);
+   }
+
+   // pointwise multiplications, scaled by 1/N; the transforms produce
+   // output in [0, 2p), and the results are in [0, 2p) too
+   for (i = 0; i < N; i++)
+   {
+      ulong x = buf1[i], y = buf2[i];
+      if (x >= p)
+         x -= p;
+      if (y >= p)
+         y -= p;
+      x = zn_mod_mul (x, y, mod);
+      NTT_MULMOD_SHOUP (buf1[i], x, ntt->Ninv, ntt->Ninv_pre, p);
+   }
+
+   ntt_ifft (buf1, ntt);
+
+   // reduce from [0, 4p) into [0, p)
+   for (i = 0; i < n1 + n2 - 1; i++)
+   {
+      ulong x = buf1[i];
+      if (x >= p2)
+         x -= p2;
+      if (x >= p)
+         x -= p;
+      res[i] = x;
+   }
+
+   free (buf1);
+}
+
+
+// end of file ****************************************************************
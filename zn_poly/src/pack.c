@@ -46,33 +46,43 @@ zn_array_pack1 (mp_limb_t* res, const ulong* op, size_t n, ptrdiff_t s,
       k -= ULONG_BITS;
    }
 
-   // limb currently being filled
-   mp_limb_t buf = 0;
-   // number of bits used in buf; always in [0, ULONG_BITS)
-   unsigned buf_b = k;
-   unsigned buf_b_old;
-   
-   for (; n > 0; n--, op += s)
+   if (s == 1  &&  n > 0)
    {
-      ZNP_ASSERT (b >= ULONG_BITS  ||  *op < (1UL << b));
-      
-      // put low bits of current input into buffer
-      buf += *op << buf_b;
-      buf_b_old = buf_b;
-      buf_b += b;
-      if (buf_b >= ULONG_BITS)
+      // contiguous input; use FLINT's bulk packing routine
+      if (k)
+         *dest = 0;
+      dest += F_mpn_bit_pack (dest, op, n, b, k);
+   }
+   else
+   {
+      // limb currently being filled
+      mp_limb_t buf = 0;
+      // number of bits used in buf; always in [0, ULONG_BITS)
+      unsigned buf_b = k;
+      unsigned buf_b_old;
+   
+      for (; n > 0; n--, op += s)
       {
-         // buffer is full; flush it
-         *dest++ = buf;
-         buf_b -= ULONG_BITS;
-         // put remaining bits of current input into buffer
-         buf = buf_b_old ? (*op >> (ULONG_BITS - buf_b_old)) : 0;
+         ZNP_ASSERT (b >= ULONG_BITS  ||  *op < (1UL << b));
+      
+         // put low bits of current input into buffer
+         buf += *op << buf_b;
+         buf_b_old = buf_b;
+         buf_b += b;
+         if (buf_b >= ULONG_BITS)
+         {
+            // buffer is full; flush it
+            *dest++ = buf;
+            buf_b -= ULONG_BITS;
+            // put remaining bits of current input into buffer
+            buf = buf_b_old ? (*op >> (ULONG_BITS - buf_b_old)) : 0;
+         }
       }
-   }
    
-   // write last limb if it's non-empty
-   if (buf_b)
-      *dest++ = buf;
+      // write last limb if it's non-empty
+      if (buf_b)
+         *dest++ = buf;
+   }
 
    // zero-pad up to requested length
    if (r)
@@ -185,11 +195,6 @@ zn_array_unpack1 (ulong* res, const mp_limb_t* op, size_t n, unsigned b,
    
 #if GMP_NAIL_BITS == 0  &&  ULONG_BITS == GMP_NUMB_BITS
 
-   // limb we're currently extracting bits from
-   mp_limb_t buf = 0;
-   // number of bits currently in buf; always in [0, ULONG_BITS)
-   unsigned buf_b = 0;
-   
    // skip over k leading bits
    while (k >= GMP_NUMB_BITS)
    {
@@ -197,57 +202,8 @@ zn_array_unpack1 (ulong* res, const mp_limb_t* op, size_t n, unsigned b,
       op++;
    }
 
-   if (k)
-   {
-      buf = *op++;
-      buf >>= k;
-      buf_b = ULONG_BITS - k;
-   }
-
-   if (b == ULONG_BITS)
-   {
-      // various special cases
-      if (buf_b)
-      {
-         for (; n > 0; n--)
-         {
-            // we need bits from both sides of a limb boundary
-            ulong temp = buf;
-            buf = *op++;
-            *res++ = temp + (buf << buf_b);
-            buf >>= (ULONG_BITS - buf_b);
-         }
-      }
-      else
-      {
-         for (; n > 0; n--)
-            *res++ = *op++;
-      }
-   }
-   else
-   {
-      ulong mask = (1UL << b) - 1;
-
-      for (; n > 0; n--)
-      {
-         if (b <= buf_b)
-         {
-            // buf contains all the bits we need
-            *res++ = buf & mask;
-            buf >>= b;
-            buf_b -= b;
-         }
-         else
-         {
-            // we need bits from both sides of a limb boundary
-            ulong temp = buf;
-            buf = *op++;
-            *res++ = temp + ((buf << buf_b) & mask);
-            buf >>= (b - buf_b);
-            buf_b = ULONG_BITS - (b - buf_b);
-         }
-      }
-   }
+   // use FLINT's bulk unpacking routine
+   F_mpn_bit_unpack (res, op, n, b, k);
    
 #else
 #error Not nails-safe yet
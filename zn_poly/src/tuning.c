@@ -47,7 +47,9 @@ tuning_info_t tuning_info[] =
        1053,   // KS2 -> KS4 middle product threshold
       21569,   // KS4 -> FFT middle product threshold
          13,   // nussbaumer multiplication threshold
-         12    // nussbaumer squaring threshold
+         12,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
    {  // bits = 3
         132,   // KS1 -> KS2 multiplication threshold
@@ -60,7 +62,9 @@ tuning_info_t tuning_info[] =
         963,   // KS2 -> KS4 middle product threshold
       17119,   // KS4 -> FFT middle product threshold
          12,   // nussbaumer multiplication threshold
-         12    // nussbaumer squaring threshold
+         12,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
    {  // bits = 4
          80,   // KS1 -> KS2 multiplication threshold
@@ -73,7 +77,9 @@ tuning_info_t tuning_info[] =
        1053,   // KS2 -> KS4 middle product threshold
       12720,   // KS4 -> FFT middle product threshold
          12,   // nussbaumer multiplication threshold
-         11    // nussbaumer squaring threshold
+         11,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
    {  // bits = 5
          86,   // KS1 -> KS2 multiplication threshold
@@ -86,7 +92,9 @@ tuning_info_t tuning_info[] =
         482,   // KS2 -> KS4 middle product threshold
       14044,   // KS4 -> FFT middle product threshold
          11,   // nussbaumer multiplication threshold
-         11    // nussbaumer squaring threshold
+         11,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
    {  // bits = 6
          78,   // KS1 -> KS2 multiplication threshold
@@ -99,7 +107,9 @@ tuning_info_t tuning_info[] =
         674,   // KS2 -> KS4 middle product threshold
       10785,   // KS4 -> FFT middle product threshold
          12,   // nussbaumer multiplication threshold
-         11    // nussbaumer squaring threshold
+         11,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
    {  // bits = 7
          70,   // KS1 -> KS2 multiplication threshold
@@ -112,7 +122,9 @@ tuning_info_t tuning_info[] =
         282,   // KS2 -> KS4 middle product threshold
       10785,   // KS4 -> FFT middle product threshold
          11,   // nussbaumer multiplication threshold
-         11    // nussbaumer squaring threshold
+         11,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
    {  // bits = 8
          56,   // KS1 -> KS2 multiplication threshold
@@ -125,7 +137,9 @@ tuning_info_t tuning_info[] =
         288,   // KS2 -> KS4 middle product threshold
        7753,   // KS4 -> FFT middle product threshold
          11,   // nussbaumer multiplication threshold
-         11    // nussbaumer squaring threshold
+         11,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
    {  // bits = 9
          57,   // KS1 -> KS2 multiplication threshold
@@ -138,7 +152,9 @@ tuning_info_t tuning_info[] =
         247,   // KS2 -> KS4 middle product threshold
        8560,   // KS4 -> FFT middle product threshold
          11,   // nussbaumer multiplication threshold
-         11    // nussbaumer squaring threshold
+         11,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
    {  // bits = 10
          62,   // KS1 -> KS2 multiplication threshold
@@ -151,7 +167,9 @@ tuning_info_t tuning_info[] =
         173,   // KS2 -> KS4 middle product threshold
        6154,   // KS4 -> FFT middle product threshold
          11,   // nussbaumer multiplication threshold
-         11    // nussbaumer squaring threshold
+         11,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
    {  // bits = 11
          47,   // KS1 -> KS2 multiplication threshold
@@ -164,7 +182,9 @@ tuning_info_t tuning_info[] =
         161,   // KS2 -> KS4 middle product threshold
        7022,   // KS4 -> FFT middle product threshold
          11,   // nussbaumer multiplication threshold
-         11    // nussbaumer squaring threshold
+         11,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
    {  // bits = 12
          43,   // KS1 -> KS2 multiplication threshold
@@ -177,7 +197,9 @@ tuning_info_t tuning_info[] =
         151,   // KS2 -> KS4 middle product threshold
        5393,   // KS4 -> FFT middle product threshold
          11,   // nussbaumer multiplication threshold
-         11    // nussbaumer squaring threshold
+         11,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
    {  // bits = 13
          43,   // KS1 -> KS2 multiplication threshold
@@ -190,7 +212,9 @@ tuning_info_t tuning_info[] =
         141,   // KS2 -> KS4 middle product threshold
        6154,   // KS4 -> FFT middle product threshold
          11,   // nussbaumer multiplication threshold
-         10    // nussbaumer squaring threshold
+         10,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
    {  // bits = 14
          48,   // KS1 -> KS2 multiplication threshold
@@ -203,7 +227,9 @@ tuning_info_t tuning_info[] =
         101,   // KS2 -> KS4 middle product threshold
        4726,   // KS4 -> FFT middle product threshold
          10,   // nussbaumer multiplication threshold
-         10    // nussbaumer squaring threshold
+         10,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
    {  // bits = 15
          38,   // KS1 -> KS2 multiplication threshold
@@ -216,7 +242,9 @@ tuning_info_t tuning_info[] =
         132,   // KS2 -> KS4 middle product threshold
        4280,   // KS4 -> FFT middle product threshold
          11,   // nussbaumer multiplication threshold
-         10    // nussbaumer squaring threshold
+         10,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
    {  // bits = 16
          35,   // KS1 -> KS2 multiplication threshold
@@ -229,7 +257,9 @@ tuning_info_t tuning_info[] =
         116,   // KS2 -> KS4 middle product threshold
        4726,   // KS4 -> FFT middle product threshold
          10,   // nussbaumer multiplication threshold
-         10    // nussbaumer squaring threshold
+         10,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
    {  // bits = 17
          33,   // KS1 -> KS2 multiplication threshold
@@ -242,7 +272,9 @@ tuning_info_t tuning_info[] =
         116,   // KS2 -> KS4 middle product threshold
        4280,   // KS4 -> FFT middle product threshold
          10,   // nussbaumer multiplication threshold
-         10    // nussbaumer squaring threshold
+         10,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
    {  // bits = 18
          31,   // KS1 -> KS2 multiplication threshold
@@ -255,7 +287,9 @@ tuning_info_t tuning_info[] =
          94,   // KS2 -> KS4 middle product threshold
        3877,   // KS4 -> FFT middle product threshold
          10,   // nussbaumer multiplication threshold
-         10    // nussbaumer squaring threshold
+         10,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
    {  // bits = 19
          33,   // KS1 -> KS2 multiplication threshold
@@ -268,7 +302,9 @@ tuning_info_t tuning_info[] =
          86,   // KS2 -> KS4 middle product threshold
        3511,   // KS4 -> FFT middle product threshold
          10,   // nussbaumer multiplication threshold
-         10    // nussbaumer squaring threshold
+         10,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+        841    // KS -> NTT squaring threshold
    },
    {  // bits = 20
          29,   // KS1 -> KS2 multiplication threshold
@@ -281,7 +317,9 @@ tuning_info_t tuning_info[] =
          78,   // KS2 -> KS4 middle product threshold
        3511,   // KS4 -> FFT middle product threshold
           9,   // nussbaumer multiplication threshold
-         10    // nussbaumer squaring threshold
+         10,   // nussbaumer squaring threshold
+        813,   // KS -> NTT multiplication threshold
+        604    // KS -> NTT squaring threshold
    },
    {  // bits = 21
          27,   // KS1 -> KS2 multiplication threshold
@@ -294,7 +332,9 @@ tuning_info_t tuning_info[] =
          86,   // KS2 -> KS4 middle product threshold
        3180,   // KS4 -> FFT middle product threshold
          10,   // nussbaumer multiplication threshold
-         10    // nussbaumer squaring threshold
+         10,   // nussbaumer squaring threshold
+        869,   // KS -> NTT multiplication threshold
+        449    // KS -> NTT squaring threshold
    },
    {  // bits = 22
          31,   // KS1 -> KS2 multiplication threshold
@@ -307,7 +347,9 @@ tuning_info_t tuning_info[] =
          75,   // KS2 -> KS4 middle product threshold
        3180,   // KS4 -> FFT middle product threshold
           9,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+        841,   // KS -> NTT multiplication threshold
+        407    // KS -> NTT squaring threshold
    },
    {  // bits = 23
          29,   // KS1 -> KS2 multiplication threshold
@@ -320,7 +362,9 @@ tuning_info_t tuning_info[] =
          80,   // KS2 -> KS4 middle product threshold
        3077,   // KS4 -> FFT middle product threshold
           9,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+        841,   // KS -> NTT multiplication threshold
+        566    // KS -> NTT squaring threshold
    },
    {  // bits = 24
          29,   // KS1 -> KS2 multiplication threshold
@@ -333,7 +377,9 @@ tuning_info_t tuning_info[] =
          75,   // KS2 -> KS4 middle product threshold
        3077,   // KS4 -> FFT middle product threshold
           9,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+        421,   // KS -> NTT multiplication threshold
+        394    // KS -> NTT squaring threshold
    },
    {  // bits = 25
          25,   // KS1 -> KS2 multiplication threshold
@@ -346,7 +392,9 @@ tuning_info_t tuning_info[] =
          66,   // KS2 -> KS4 middle product threshold
        2697,   // KS4 -> FFT middle product threshold
           9,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+        421,   // KS -> NTT multiplication threshold
+        394    // KS -> NTT squaring threshold
    },
    {  // bits = 26
          29,   // KS1 -> KS2 multiplication threshold
@@ -359,7 +407,9 @@ tuning_info_t tuning_info[] =
          66,   // KS2 -> KS4 middle product threshold
        2697,   // KS4 -> FFT middle product threshold
           9,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+        407,   // KS -> NTT multiplication threshold
+        345    // KS -> NTT squaring threshold
    },
    {  // bits = 27
          25,   // KS1 -> KS2 multiplication threshold
@@ -372,7 +422,9 @@ tuning_info_t tuning_info[] =
          61,   // KS2 -> KS4 middle product threshold
        2140,   // KS4 -> FFT middle product threshold
           9,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+        394,   // KS -> NTT multiplication threshold
+        240    // KS -> NTT squaring threshold
    },
    {  // bits = 28
          27,   // KS1 -> KS2 multiplication threshold
@@ -385,7 +437,9 @@ tuning_info_t tuning_info[] =
          57,   // KS2 -> KS4 middle product threshold
        2140,   // KS4 -> FFT middle product threshold
           9,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+        381,   // KS -> NTT multiplication threshold
+        240    // KS -> NTT squaring threshold
    },
    {  // bits = 29
          25,   // KS1 -> KS2 multiplication threshold
@@ -398,7 +452,9 @@ tuning_info_t tuning_info[] =
          61,   // KS2 -> KS4 middle product threshold
        2140,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        464,   // KS -> NTT multiplication threshold
+        265    // KS -> NTT squaring threshold
    },
    {  // bits = 30
          21,   // KS1 -> KS2 multiplication threshold
@@ -411,7 +467,9 @@ tuning_info_t tuning_info[] =
          61,   // KS2 -> KS4 middle product threshold
        2363,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        240,   // KS -> NTT multiplication threshold
+        225    // KS -> NTT squaring threshold
    },
    {  // bits = 31
          24,   // KS1 -> KS2 multiplication threshold
@@ -424,7 +482,9 @@ tuning_info_t tuning_info[] =
          51,   // KS2 -> KS4 middle product threshold
        2140,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+        480,   // KS -> NTT multiplication threshold
+        421    // KS -> NTT squaring threshold
    },
    {  // bits = 32
          24,   // KS1 -> KS2 multiplication threshold
@@ -437,7 +497,9 @@ tuning_info_t tuning_info[] =
          51,   // KS2 -> KS4 middle product threshold
        2140,   // KS4 -> FFT middle product threshold
           9,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+        787,   // KS -> NTT multiplication threshold
+        394    // KS -> NTT squaring threshold
    },
    {  // bits = 33
          21,   // KS1 -> KS2 multiplication threshold
@@ -450,7 +512,9 @@ tuning_info_t tuning_info[] =
          50,   // KS2 -> KS4 middle product threshold
        1939,   // KS4 -> FFT middle product threshold
           9,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+        787,   // KS -> NTT multiplication threshold
+        369    // KS -> NTT squaring threshold
    },
    {  // bits = 34
          21,   // KS1 -> KS2 multiplication threshold
@@ -463,7 +527,9 @@ tuning_info_t tuning_info[] =
          43,   // KS2 -> KS4 middle product threshold
        1939,   // KS4 -> FFT middle product threshold
           9,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+        646,   // KS -> NTT multiplication threshold
+        232    // KS -> NTT squaring threshold
    },
    {  // bits = 35
          21,   // KS1 -> KS2 multiplication threshold
@@ -476,7 +542,9 @@ tuning_info_t tuning_info[] =
          40,   // KS2 -> KS4 middle product threshold
        1539,   // KS4 -> FFT middle product threshold
           9,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+        512,   // KS -> NTT multiplication threshold
+        232    // KS -> NTT squaring threshold
    },
    {  // bits = 36
          21,   // KS1 -> KS2 multiplication threshold
@@ -489,7 +557,9 @@ tuning_info_t tuning_info[] =
          38,   // KS2 -> KS4 middle product threshold
        1756,   // KS4 -> FFT middle product threshold
           9,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+        435,   // KS -> NTT multiplication threshold
+        248    // KS -> NTT squaring threshold
    },
    {  // bits = 37
          17,   // KS1 -> KS2 multiplication threshold
@@ -502,7 +572,9 @@ tuning_info_t tuning_info[] =
          40,   // KS2 -> KS4 middle product threshold
        1539,   // KS4 -> FFT middle product threshold
           9,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+        421,   // KS -> NTT multiplication threshold
+        369    // KS -> NTT squaring threshold
    },
    {  // bits = 38
          19,   // KS1 -> KS2 multiplication threshold
@@ -515,7 +587,9 @@ tuning_info_t tuning_info[] =
          35,   // KS2 -> KS4 middle product threshold
        1590,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        464,   // KS -> NTT multiplication threshold
+        240    // KS -> NTT squaring threshold
    },
    {  // bits = 39
          19,   // KS1 -> KS2 multiplication threshold
@@ -528,7 +602,9 @@ tuning_info_t tuning_info[] =
          35,   // KS2 -> KS4 middle product threshold
        1349,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        449,   // KS -> NTT multiplication threshold
+        211    // KS -> NTT squaring threshold
    },
    {  // bits = 40
          19,   // KS1 -> KS2 multiplication threshold
@@ -541,7 +617,9 @@ tuning_info_t tuning_info[] =
          39,   // KS2 -> KS4 middle product threshold
        1539,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        449,   // KS -> NTT multiplication threshold
+        323    // KS -> NTT squaring threshold
    },
    {  // bits = 41
          17,   // KS1 -> KS2 multiplication threshold
@@ -554,7 +632,9 @@ tuning_info_t tuning_info[] =
          33,   // KS2 -> KS4 middle product threshold
        1349,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+        421,   // KS -> NTT multiplication threshold
+        218    // KS -> NTT squaring threshold
    },
    {  // bits = 42
          17,   // KS1 -> KS2 multiplication threshold
@@ -567,7 +647,9 @@ tuning_info_t tuning_info[] =
          33,   // KS2 -> KS4 middle product threshold
        1440,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+        464,   // KS -> NTT multiplication threshold
+        211    // KS -> NTT squaring threshold
    },
    {  // bits = 43
          16,   // KS1 -> KS2 multiplication threshold
@@ -580,7 +662,9 @@ tuning_info_t tuning_info[] =
          31,   // KS2 -> KS4 middle product threshold
        1305,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+        369,   // KS -> NTT multiplication threshold
+        185    // KS -> NTT squaring threshold
    },
    {  // bits = 44
          17,   // KS1 -> KS2 multiplication threshold
@@ -593,7 +677,9 @@ tuning_info_t tuning_info[] =
          29,   // KS2 -> KS4 middle product threshold
        1349,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+        421,   // KS -> NTT multiplication threshold
+        211    // KS -> NTT squaring threshold
    },
    {  // bits = 45
          16,   // KS1 -> KS2 multiplication threshold
@@ -606,7 +692,9 @@ tuning_info_t tuning_info[] =
          29,   // KS2 -> KS4 middle product threshold
        1182,   // KS4 -> FFT middle product threshold
           9,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        394,   // KS -> NTT multiplication threshold
+        211    // KS -> NTT squaring threshold
    },
    {  // bits = 46
          17,   // KS1 -> KS2 multiplication threshold
@@ -619,7 +707,9 @@ tuning_info_t tuning_info[] =
          31,   // KS2 -> KS4 middle product threshold
        1305,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        240,   // KS -> NTT multiplication threshold
+        124    // KS -> NTT squaring threshold
    },
    {  // bits = 47
          16,   // KS1 -> KS2 multiplication threshold
@@ -632,7 +722,9 @@ tuning_info_t tuning_info[] =
          25,   // KS2 -> KS4 middle product threshold
        1305,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        496,   // KS -> NTT multiplication threshold
+        116    // KS -> NTT squaring threshold
    },
    {  // bits = 48
          17,   // KS1 -> KS2 multiplication threshold
@@ -645,7 +737,9 @@ tuning_info_t tuning_info[] =
          29,   // KS2 -> KS4 middle product threshold
        1349,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        232,   // KS -> NTT multiplication threshold
+        185    // KS -> NTT squaring threshold
    },
    {  // bits = 49
          14,   // KS1 -> KS2 multiplication threshold
@@ -658,7 +752,9 @@ tuning_info_t tuning_info[] =
          27,   // KS2 -> KS4 middle product threshold
        1182,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        232,   // KS -> NTT multiplication threshold
+        113    // KS -> NTT squaring threshold
    },
    {  // bits = 50
          14,   // KS1 -> KS2 multiplication threshold
@@ -671,7 +767,9 @@ tuning_info_t tuning_info[] =
          27,   // KS2 -> KS4 middle product threshold
        1305,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        394,   // KS -> NTT multiplication threshold
+        185    // KS -> NTT squaring threshold
    },
    {  // bits = 51
          14,   // KS1 -> KS2 multiplication threshold
@@ -684,7 +782,9 @@ tuning_info_t tuning_info[] =
          25,   // KS2 -> KS4 middle product threshold
        1182,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        225,   // KS -> NTT multiplication threshold
+        113    // KS -> NTT squaring threshold
    },
    {  // bits = 52
          14,   // KS1 -> KS2 multiplication threshold
@@ -697,7 +797,9 @@ tuning_info_t tuning_info[] =
          27,   // KS2 -> KS4 middle product threshold
        1070,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        225,   // KS -> NTT multiplication threshold
+        197    // KS -> NTT squaring threshold
    },
    {  // bits = 53
          13,   // KS1 -> KS2 multiplication threshold
@@ -710,7 +812,9 @@ tuning_info_t tuning_info[] =
          25,   // KS2 -> KS4 middle product threshold
         970,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        211,   // KS -> NTT multiplication threshold
+        109    // KS -> NTT squaring threshold
    },
    {  // bits = 54
          14,   // KS1 -> KS2 multiplication threshold
@@ -723,7 +827,9 @@ tuning_info_t tuning_info[] =
          23,   // KS2 -> KS4 middle product threshold
        1182,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        211,   // KS -> NTT multiplication threshold
+        109    // KS -> NTT squaring threshold
    },
    {  // bits = 55
          13,   // KS1 -> KS2 multiplication threshold
@@ -736,7 +842,9 @@ tuning_info_t tuning_info[] =
          23,   // KS2 -> KS4 middle product threshold
        1182,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        185,   // KS -> NTT multiplication threshold
+        116    // KS -> NTT squaring threshold
    },
    {  // bits = 56
          13,   // KS1 -> KS2 multiplication threshold
@@ -749,7 +857,9 @@ tuning_info_t tuning_info[] =
          21,   // KS2 -> KS4 middle product threshold
        1070,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        248,   // KS -> NTT multiplication threshold
+        102    // KS -> NTT squaring threshold
    },
    {  // bits = 57
          13,   // KS1 -> KS2 multiplication threshold
@@ -762,7 +872,9 @@ tuning_info_t tuning_info[] =
          23,   // KS2 -> KS4 middle product threshold
         970,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        197,   // KS -> NTT multiplication threshold
+         99    // KS -> NTT squaring threshold
    },
    {  // bits = 58
          13,   // KS1 -> KS2 multiplication threshold
@@ -775,7 +887,9 @@ tuning_info_t tuning_info[] =
          23,   // KS2 -> KS4 middle product threshold
         970,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        151,   // KS -> NTT multiplication threshold
+        185    // KS -> NTT squaring threshold
    },
    {  // bits = 59
          13,   // KS1 -> KS2 multiplication threshold
@@ -788,7 +902,9 @@ tuning_info_t tuning_info[] =
          21,   // KS2 -> KS4 middle product threshold
         970,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        124,   // KS -> NTT multiplication threshold
+        109    // KS -> NTT squaring threshold
    },
    {  // bits = 60
          13,   // KS1 -> KS2 multiplication threshold
@@ -801,7 +917,9 @@ tuning_info_t tuning_info[] =
          21,   // KS2 -> KS4 middle product threshold
         878,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        113,   // KS -> NTT multiplication threshold
+        106    // KS -> NTT squaring threshold
    },
    {  // bits = 61
          13,   // KS1 -> KS2 multiplication threshold
@@ -814,7 +932,9 @@ tuning_info_t tuning_info[] =
          21,   // KS2 -> KS4 middle product threshold
         878,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        113,   // KS -> NTT multiplication threshold
+         99    // KS -> NTT squaring threshold
    },
    {  // bits = 62
          13,   // KS1 -> KS2 multiplication threshold
@@ -827,7 +947,9 @@ tuning_info_t tuning_info[] =
          24,   // KS2 -> KS4 middle product threshold
        1182,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+        109,   // KS -> NTT multiplication threshold
+        102    // KS -> NTT squaring threshold
    },
    {  // bits = 63
          13,   // KS1 -> KS2 multiplication threshold
@@ -840,7 +962,9 @@ tuning_info_t tuning_info[] =
          25,   // KS2 -> KS4 middle product threshold
        1070,   // KS4 -> FFT middle product threshold
           8,   // nussbaumer multiplication threshold
-          8    // nussbaumer squaring threshold
+          8,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
    {  // bits = 64
          13,   // KS1 -> KS2 multiplication threshold
@@ -853,7 +977,9 @@ tuning_info_t tuning_info[] =
          23,   // KS2 -> KS4 middle product threshold
        1756,   // KS4 -> FFT middle product threshold
           9,   // nussbaumer multiplication threshold
-          9    // nussbaumer squaring threshold
+          9,   // nussbaumer squaring threshold
+   SIZE_MAX,   // KS -> NTT multiplication threshold
+   SIZE_MAX    // KS -> NTT squaring threshold
    },
 };
 
@@ -589,6 +589,28 @@ zn_array_mul (ulong* res,
               const zn_mod_t mod);
 
 
+/*
+   Matrix product of polynomials. op1 is an r x s matrix and op2 is an s x t
+   matrix, both stored row by row: entry (i, k) of op1 is the polynomial
+   op1[i*s + k][0, n1[i*s + k]), and similarly for op2. Lengths may be zero.
+
+   Stores entry (i, j) of the product in res[i*t + j][0, n3), where
+   n3 = N1 + N2 - 1, N1 and N2 being the maximum lengths in op1 and op2,
+   zero-padding as necessary. If N1 or N2 is zero, nothing is written.
+
+   None of the output buffers may overlap the inputs.
+
+   For large enough inputs, each input is transformed only once, the
+   pointwise products are accumulated in the transform domain and only one
+   inverse transform is done per output entry.
+*/
+void
+zn_array_mat_mul (ulong** res,
+                  const ulong* const* op1, const size_t* n1,
+                  const ulong* const* op2, const size_t* n2,
+                  unsigned r, unsigned s, unsigned t, const zn_mod_t mod);
+
+
 /*
    Middle product of op1[0, n1) and op2[0, n2), stores result in
    res[0, n1 - n2 + 1).
@@ -207,6 +207,11 @@ typedef struct
    unsigned nuss_mul_thresh;
    // ditto for nussbaumer squaring
    unsigned nuss_sqr_thresh;
+
+   // switch to the number-theoretic transform (ntt.c) when the modulus
+   // supports it, and the shorter input reaches this length
+   size_t mul_ntt_thresh;
+   size_t sqr_ntt_thresh;
    
 }
 tuning_info_t;
@@ -311,6 +316,17 @@ ulong
 _zn_array_mul_fudge (size_t n1, size_t n2, int sqr, const zn_mod_t mod);
 
 
+/*
+   Returns nonzero if _zn_array_mul() will use the number-theoretic transform
+   for an n1 x n2 product (i.e. the modulus admits a transform of length
+   n1 + n2 - 1, and n2 is above the relevant tuning threshold).
+*/
+#define zn_array_mul_use_ntt \
+    ZNP_zn_array_mul_use_ntt
+int
+zn_array_mul_use_ntt (size_t n1, size_t n2, int sqr, const zn_mod_t mod);
+
+
 
 /* ============================================================================
 
@@ -1224,6 +1240,32 @@ ulong
 zn_array_mul_fft_fudge (size_t n1, size_t n2, int sqr, const zn_mod_t mod);
 
 
+/*
+   Same as zn_array_mat_mul(), but always uses the Schonhage/Nussbaumer FFT
+   algorithm, with transform parameters chosen for the maximum input lengths
+   N1 and N2 (which must both be nonzero).
+
+   Each input is transformed once, the pointwise products for each output
+   entry are accumulated in the transform domain, and each output entry is
+   inverse transformed once.
+
+   The modulus must be odd.
+
+   The output will come out divided by the fudge factor
+   zn_array_mul_fft_fudge(N1, N2, 0, mod).
+
+   If x != 1, the output is further multiplied by x.
+*/
+#define zn_array_mat_mul_fft \
+    ZNP_zn_array_mat_mul_fft
+void
+zn_array_mat_mul_fft (ulong** res,
+                      const ulong* const* op1, const size_t* n1,
+                      const ulong* const* op2, const size_t* n2,
+                      unsigned r, unsigned s, unsigned t,
+                      ulong x, const zn_mod_t mod);
+
+
 /*
    Computes the best lgK, lgM, m1, m2 such that polynomials of length n1 and
    n2 may be multiplied with fourier transform parameters lgK and lgM, and
@@ -1364,6 +1406,137 @@ zn_array_mulmid_fft_precomp1_clear (zn_array_mulmid_fft_precomp1_t op);
 
 
 
+/* ============================================================================
+
+     stuff from ntt.c
+
+============================================================================ */
+
+/*
+   Precomputed data for number-theoretic transforms of length N = 2^lgN
+   over Z/mZ, where m - 1 is divisible by N.
+
+   The tables are stored in "layered" order: entry h + j of w is w_{2h}^j
+   for 0 <= j < h, where w_{2h} is a primitive 2h-th root of unity, and
+   h runs over 1, 2, 4, ..., N/2. wi holds the inverses of the same roots.
+   wpre and wipre hold the corresponding values floor(w * B / m).
+*/
+typedef struct
+{
+   const zn_mod_struct* mod;
+   unsigned lgN;
+
+   ulong* w;
+   ulong* wpre;
+   ulong* wi;
+   ulong* wipre;
+
+   // 1/N mod m, and floor(Ninv * B / m)
+   ulong Ninv, Ninv_pre;
+
+   // nonzero if the AVX2 butterflies should be used
+   int avx2;
+}
+ntt_struct;
+
+typedef ntt_struct  ntt_t[1];
+
+
+/*
+   Returns a principal 2^lgN-th root of unity mod m, or zero if none could
+   be found (or if m is even, or has more than ULONG_BITS - 2 bits, in which
+   case the lazy transforms do not apply).
+
+   If m is prime, a root exists if and only if 2^lgN divides m - 1.
+*/
+#define zn_mod_ntt_root \
+    ZNP_zn_mod_ntt_root
+ulong
+zn_mod_ntt_root (unsigned lgN, const zn_mod_t mod);
+
+
+/*
+   Initialises res for transforms of length 2^lgN, lgN >= 1.
+
+   Returns 1 on success. Returns 0 (and does not allocate anything) if
+   zn_mod_ntt_root() fails for these parameters.
+*/
+#define ntt_init \
+    ZNP_ntt_init
+int
+ntt_init (ntt_t res, unsigned lgN, const zn_mod_t mod);
+
+
+#define ntt_clear \
+    ZNP_ntt_clear
+void
+ntt_clear (ntt_t op);
+
+
+/*
+   Same as zn_mod_ntt_root(), but the result is cached by the calling
+   thread, see ntt_cache_get().
+*/
+#define ntt_cache_root \
+    ZNP_ntt_cache_root
+ulong
+ntt_cache_root (unsigned lgN, const zn_mod_t mod);
+
+
+/*
+   Returns transforms of length 2^lgN, lgN >= 1, modulo mod->m, or NULL if
+   zn_mod_ntt_root() fails for these parameters. The transforms belong to
+   a small cache kept by the calling thread, and remain valid until it
+   asks for several other moduli or lengths; they must not be cleared.
+*/
+#define ntt_cache_get \
+    ZNP_ntt_cache_get
+const ntt_struct*
+ntt_cache_get (unsigned lgN, const zn_mod_t mod);
+
+
+/*
+   In-place forward transform of op[0, N), i.e. evaluation at the powers
+   of w_N. The output is in bit-reversed order.
+
+   Inputs must be in [0, 2m), outputs are in [0, 2m).
+*/
+#define ntt_fft \
+    ZNP_ntt_fft
+void
+ntt_fft (ulong* op, const ntt_t ntt);
+
+
+/*
+   In-place inverse transform of op[0, N), which should be in bit-reversed
+   order. The output is in natural order, and is *not* divided by N.
+
+   Inputs must be in [0, 4m), outputs are in [0, 4m).
+*/
+#define ntt_ifft \
+    ZNP_ntt_ifft
+void
+ntt_ifft (ulong* op, const ntt_t ntt);
+
+
+/*
+   Same as zn_array_mul(), but uses the transforms in ntt, which must have
+   length at least n1 + n2 - 1.
+   
+   Uses faster algorithm for squaring if inputs are identical buffers.
+
+   Output may overlap the inputs. There is no fudge factor.
+*/
+#define zn_array_mul_ntt \
+    ZNP_zn_array_mul_ntt
+void
+zn_array_mul_ntt (ulong* res,
+                  const ulong* op1, size_t n1,
+                  const ulong* op2, size_t n2,
+                  const ntt_t ntt);
+
+
+
 /* ============================================================================
 
      stuff from mpn_mulmid.c
@@ -319,4 +319,127 @@ test_zn_array_mul_fft_dft (int quick)
 }
 
 
+
+/*
+   Tests zn_array_mat_mul_fft, for an r x s by s x t product with random
+   entry lengths at most n1 (resp. n2), some of them zero.
+
+   Returns 1 on success.
+*/
+int
+testcase_zn_array_mat_mul_fft (unsigned r, unsigned s, unsigned t,
+                               size_t n1, size_t n2, const zn_mod_t mod)
+{
+   ulong** op1 = (ulong**) malloc (sizeof (ulong*) * r * s);
+   ulong** op2 = (ulong**) malloc (sizeof (ulong*) * s * t);
+   ulong** res = (ulong**) malloc (sizeof (ulong*) * r * t);
+   size_t* len1 = (size_t*) malloc (sizeof (size_t) * r * s);
+   size_t* len2 = (size_t*) malloc (sizeof (size_t) * s * t);
+
+   size_t i, j, k, N1 = 0, N2 = 0;
+
+   // generate random entries, making sure the maximum lengths are attained
+   for (i = 0; i < r * s; i++)
+   {
+      len1[i] = (i == 0) ? n1 : random_ulong (n1 + 1);
+      N1 = ZNP_MAX (N1, len1[i]);
+      op1[i] = (ulong*) malloc (sizeof (ulong) * (len1[i] + 1));
+      for (j = 0; j < len1[i]; j++)
+         op1[i][j] = random_ulong (mod->m);
+   }
+   for (i = 0; i < s * t; i++)
+   {
+      len2[i] = (i == s * t - 1) ? n2 : random_ulong (n2 + 1);
+      N2 = ZNP_MAX (N2, len2[i]);
+      op2[i] = (ulong*) malloc (sizeof (ulong) * (len2[i] + 1));
+      for (j = 0; j < len2[i]; j++)
+         op2[i][j] = random_ulong (mod->m);
+   }
+
+   size_t n3 = N1 + N2 - 1;
+   for (i = 0; i < r * t; i++)
+      res[i] = (ulong*) malloc (sizeof (ulong) * n3);
+
+   ulong* ref = (ulong*) malloc (sizeof (ulong) * n3);
+   ulong* temp = (ulong*) malloc (sizeof (ulong) * n3);
+
+   zn_array_mat_mul_fft (res, (const ulong* const*) op1, len1,
+                         (const ulong* const*) op2, len2, r, s, t, 1, mod);
+   ulong y = zn_array_mul_fft_fudge (N1, N2, 0, mod);
+
+   int success = 1;
+
+   // compare each entry against a sum of reference products
+   for (i = 0; i < r && success; i++)
+   for (j = 0; j < t && success; j++)
+   {
+      zn_array_zero (ref, n3);
+      for (k = 0; k < s; k++)
+      {
+         size_t a = len1[i * s + k], b = len2[k * t + j];
+         if (a == 0 || b == 0)
+            continue;
+         if (a >= b)
+            ref_zn_array_mul (temp, op1[i * s + k], a, op2[k * t + j], b, mod);
+         else
+            ref_zn_array_mul (temp, op2[k * t + j], b, op1[i * s + k], a, mod);
+         zn_array_add_inplace (ref, temp, a + b - 1, mod);
+      }
+
+      ref_zn_array_scalar_mul (res[i * t + j], res[i * t + j], n3, y, mod);
+      success = !zn_array_cmp (ref, res[i * t + j], n3);
+   }
+
+   free (temp);
+   free (ref);
+   for (i = 0; i < r * t; i++)
+      free (res[i]);
+   for (i = 0; i < s * t; i++)
+      free (op2[i]);
+   for (i = 0; i < r * s; i++)
+      free (op1[i]);
+   free (len2);
+   free (len1);
+   free (res);
+   free (op2);
+   free (op1);
+
+   return success;
+}
+
+
+
+/*
+   tests zn_array_mat_mul_fft() on a range of input cases
+*/
+int
+test_zn_array_mat_mul_fft (int quick)
+{
+   int success = 1;
+   int i, trial;
+   unsigned r, s, t;
+   size_t n1, n2;
+   zn_mod_t mod;
+
+   for (i = 0; i < num_test_bitsizes && success; i++)
+   for (trial = 0; trial < (quick ? 30 : 100) && success; trial++)
+   {
+      r = random_ulong (3) + 1;
+      s = random_ulong (4) + 1;
+      t = random_ulong (3) + 1;
+      if (trial & 1)
+         r = s = t = 2;    // exercise the Strassen-Winograd code too
+      n1 = random_ulong (trial < 20 ? 50 : 1000) + 1;
+      n2 = random_ulong (trial < 20 ? 50 : 1000) + 1;
+
+      zn_mod_init (mod, random_modulus (test_bitsizes[i], 1));
+      success = success &&
+                   testcase_zn_array_mat_mul_fft (r, s, t, n1, n2, mod);
+      zn_mod_clear (mod);
+   }
+
+   return success;
+}
+
+
 // end of file ****************************************************************
@@ -0,0 +1,233 @@
+/*
+   ntt-test.c:  test code for functions in ntt.c
+
+   Copyright (C) 2010, William Hart
+
+   This file is part of the zn_poly library (version 0.9).
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 2 of the License, or
+   (at your option) version 3 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "support.h"
+#include "zn_poly_internal.h"
+
+
+/*
+   Tests zn_array_mul_ntt for given lengths, transform length and modulus.
+
+   If sqr == 1, tests squaring (n2 is ignored), otherwise ordinary
+   multiplication.
+
+   Returns 1 on success.
+*/
+int
+testcase_zn_array_mul_ntt (size_t n1, size_t n2, unsigned lgN, int sqr,
+                           const zn_mod_t mod)
+{
+   if (sqr)
+      n2 = n1;
+
+   ulong* buf1 = (ulong*) malloc (sizeof (ulong) * n1);
+   ulong* buf2 = sqr ? buf1 : (ulong*) malloc (sizeof (ulong) * n2);
+   ulong* ref = (ulong*) malloc (sizeof (ulong) * (n1 + n2 - 1));
+   ulong* res = (ulong*) malloc (sizeof (ulong) * (n1 + n2 - 1));
+
+   // generate random polys
+   size_t i;
+   for (i = 0; i < n1; i++)
+      buf1[i] = random_ulong (mod->m);
+   if (!sqr)
+      for (i = 0; i < n2; i++)
+         buf2[i] = random_ulong (mod->m);
+
+   // compare target implementation against reference implementation
+   ref_zn_array_mul (ref, buf1, n1, buf2, n2, mod);
+
+   int success;
+   ntt_t ntt;
+
+   if (!ntt_init (ntt, lgN, mod))
+      success = 0;
+   else
+   {
+      zn_array_mul_ntt (res, buf1, n1, buf2, n2, ntt);
+      success = !zn_array_cmp (ref, res, n1 + n2 - 1);
+      ntt_clear (ntt);
+   }
+
+   free (res);
+   free (ref);
+   if (!sqr)
+      free (buf2);
+   free (buf1);
+
+   return success;
+}
+
+
+/*
+   tests zn_array_mul_ntt() on a range of input cases
+*/
+int
+test_zn_array_mul_ntt (int quick)
+{
+   int success = 1;
+   int i, trial, sqr;
+   unsigned lgN;
+   zn_mod_t mod;
+
+   // 30 and 31 bits are either side of the AVX2 cutoff
+   unsigned bitsizes[] = {16, 24, 30, 31, ULONG_BITS/2 + 8, ULONG_BITS - 2};
+
+   for (i = 0; i < sizeof (bitsizes) / sizeof (bitsizes[0]); i++)
+   for (lgN = 1; lgN <= (quick ? 10 : 14) && success; lgN++)
+   for (trial = 0; trial < (quick ? 1 : 5) && success; trial++)
+   for (sqr = 0; sqr <= 1 && success; sqr++)
+   {
+      if (bitsizes[i] < lgN + 8 || bitsizes[i] > ULONG_BITS - 2)
+         continue;
+
+      zn_mod_init (mod, random_ntt_prime (bitsizes[i], lgN));
+
+      size_t N = 1UL << lgN;
+      size_t n1 = random_ulong (N) + 1;
+      size_t n2 = random_ulong (N - n1 + 1) + 1;
+      if (sqr)
+      {
+         n1 = random_ulong (N / 2) + 1;
+         n2 = n1;
+      }
+      if (n1 < n2)
+      {
+         size_t temp = n1;
+         n1 = n2;
+         n2 = temp;
+      }
+
+      success = success && testcase_zn_array_mul_ntt (n1, n2, lgN, sqr, mod);
+
+      zn_mod_clear (mod);
+   }
+
+   // check that zn_array_mul() dispatches to the NTT above the tuning
+   // threshold, and gets the right answer
+   for (trial = 0; trial < (quick ? 2 : 10) && success; trial++)
+   {
+      unsigned b = (trial & 1) ? ULONG_BITS - 2 : ULONG_BITS/2 - 2;
+      size_t n = tuning_info[b].mul_ntt_thresh;
+      if (n == SIZE_MAX)
+         continue;
+      n += random_ulong (n);
+
+      zn_mod_init (mod, random_ntt_prime (b, ceil_lg (2 * n - 1)));
+
+      ulong* buf1 = (ulong*) malloc (sizeof (ulong) * n);
+      ulong* buf2 = (ulong*) malloc (sizeof (ulong) * n);
+      ulong* ref = (ulong*) malloc (sizeof (ulong) * (2 * n - 1));
+      ulong* res = (ulong*) malloc (sizeof (ulong) * (2 * n - 1));
+      size_t j;
+      for (j = 0; j < n; j++)
+      {
+         buf1[j] = random_ulong (mod->m);
+         buf2[j] = random_ulong (mod->m);
+      }
+
+      ref_zn_array_mul (ref, buf1, n, buf2, n, mod);
+      zn_array_mul (res, buf1, n, buf2, n, mod);
+      success = zn_array_mul_use_ntt (n, n, 0, mod)
+                && !zn_array_cmp (ref, res, 2 * n - 1);
+
+      free (res);
+      free (ref);
+      free (buf2);
+      free (buf1);
+      zn_mod_clear (mod);
+   }
+
+   // check the cached transforms, cycling through more moduli and lengths
+   // than the cache holds so that entries get evicted and rebuilt
+   {
+      ulong primes[6];
+      for (i = 0; i < 6; i++)
+         primes[i] = random_ntt_prime (ULONG_BITS/2 + 4 * i, 8);
+
+      for (trial = 0; trial < (quick ? 24 : 120) && success; trial++)
+      {
+         zn_mod_init (mod, primes[trial % 6]);
+         lgN = (trial % 5) + 4;
+
+         const ntt_struct* ntt = ntt_cache_get (lgN, mod);
+         success = success && ntt != NULL && ntt->lgN == lgN
+                   && ntt->mod->m == mod->m
+                   && ntt_cache_get (lgN, mod) == ntt
+                   && ntt_cache_root (lgN, mod) == zn_mod_ntt_root (lgN, mod);
+
+         size_t N = 1UL << lgN;
+         size_t n1 = random_ulong (N / 2) + 1;
+         size_t n2 = random_ulong (n1) + 1;
+
+         ulong* buf1 = (ulong*) malloc (sizeof (ulong) * n1);
+         ulong* buf2 = (ulong*) malloc (sizeof (ulong) * n2);
+         ulong* ref = (ulong*) malloc (sizeof (ulong) * (n1 + n2 - 1));
+         ulong* res = (ulong*) malloc (sizeof (ulong) * (n1 + n2 - 1));
+         size_t j;
+         for (j = 0; j < n1; j++)
+            buf1[j] = random_ulong (mod->m);
+         for (j = 0; j < n2; j++)
+            buf2[j] = random_ulong (mod->m);
+
+         ref_zn_array_mul (ref, buf1, n1, buf2, n2, mod);
+         if (success)
+         {
+            zn_array_mul_ntt (res, buf1, n1, buf2, n2, ntt);
+            success = !zn_array_cmp (ref, res, n1 + n2 - 1);
+         }
+
+         free (res);
+         free (ref);
+         free (buf2);
+         free (buf1);
+         zn_mod_clear (mod);
+      }
+
+      // a length the modulus has no root for isn't cached as a transform
+      zn_mod_init (mod, primes[0]);
+      lgN = 1;
+      while (zn_mod_ntt_root (lgN, mod) != 0)
+         lgN++;
+      success = success && ntt_cache_root (lgN, mod) == 0
+                        && ntt_cache_get (lgN, mod) == NULL;
+      zn_mod_clear (mod);
+   }
+
+   // check that zn_mod_ntt_root() refuses moduli that don't have enough
+   // roots of unity
+   for (lgN = 1; lgN <= 10 && success; lgN++)
+   {
+      zn_mod_init (mod, random_ntt_prime (ULONG_BITS/2, lgN));
+      ulong m = mod->m;
+      unsigned v = 0;
+      while (!((m - 1) & (1UL << v)))
+         v++;
+      success = success && (zn_mod_ntt_root (v, mod) != 0)
+                        && (zn_mod_ntt_root (v + 1, mod) == 0);
+      zn_mod_clear (mod);
+   }
+
+   return success;
+}
+
+
+// end of file ****************************************************************
@@ -84,6 +84,30 @@ random_modulus (unsigned b, int require_odd)
 }
 
 
+ulong
+random_ntt_prime (unsigned b, unsigned lgN)
+{
+   ZNP_ASSERT (lgN + 8 <= b && b <= ULONG_BITS);
+   
+   mpz_t x;
+   mpz_init (x);
+   
+   ulong p;
+   do
+   {
+      // p = k * 2^lgN + 1, where k has exactly b - lgN bits
+      ulong k = (1UL << (b - lgN - 1)) + random_ulong_bits (b - lgN - 1);
+      p = (k << lgN) + 1;
+      mpz_set_ui (x, p);
+   }
+   while (!mpz_probab_prime_p (x, 10));
+   
+   mpz_clear (x);
+   
+   return p;
+}
+
+
 void
 zn_array_print (const ulong* x, size_t n)
 {
@@ -57,8 +57,10 @@ extern int test_zn_array_unpack (int quick);
 extern int test_zn_array_mul_fft (int quick);
 extern int test_zn_array_sqr_fft (int quick);
 extern int test_zn_array_mul_fft_dft (int quick);
+extern int test_zn_array_mat_mul_fft (int quick);
 extern int test_zn_array_mulmid_fft (int quick);
 extern int test_nuss_mul (int quick);
+extern int test_zn_array_mul_ntt (int quick);
 extern int test_pmfvec_fft_dc (int quick);
 extern int test_pmfvec_fft_huge (int quick);
 extern int test_pmfvec_ifft_dc (int quick);
@@ -171,6 +173,12 @@ test_target_t targets[] = {
    {"zn_array_mul_fft_dft",
     test_zn_array_mul_fft_dft},
     
+   {"zn_array_mat_mul_fft",
+    test_zn_array_mat_mul_fft},
+    
+   {"zn_array_mul_ntt",
+    test_zn_array_mul_ntt},
+    
    {"zn_array_invert",
     test_zn_array_invert},
 
@@ -157,4 +157,155 @@ tune_mul (FILE* flog, int sqr, int verbose)
 }
 
 
+
+/*
+   For each modulus size, finds approximate threshold between the ordinary
+   multiplication code and the number-theoretic transform, for moduli that
+   support the latter.
+   
+   (Note this needs to be done *after* all the other multiplication
+   thresholds have been determined.)
+   
+   Store these in the global threshold table, and writes some logging
+   information to flog.
+*/
+void
+tune_mul_ntt (FILE* flog, int sqr, int verbose)
+{
+   unsigned b;
+
+   fprintf (flog, "    KS/NTT %s: ", sqr ? "sqr" : "mul");
+   fflush (flog);
+   
+   // how long we are willing to wait for each profile run
+   const double speed = 0.0001;
+   
+   // run tuning process for each modulus size
+   for (b = 2; b <= ULONG_BITS; b++)
+   {
+      // thresh for switching to the NTT
+      size_t thresh = SIZE_MAX;
+
+      // disable the NTT while profiling ALGO_MUL_BEST
+      if (sqr)
+         tuning_info[b].sqr_ntt_thresh = SIZE_MAX;
+      else
+         tuning_info[b].mul_ntt_thresh = SIZE_MAX;
+   
+      // the lazy butterflies need 4m < B; for small moduli there aren't
+      // enough roots of unity to be interesting
+      if (b > ULONG_BITS - 2 || b < 16)
+         goto done;
+
+      // largest transform we'll try
+      unsigned lgmax = ZNP_MIN (b - 8, 17);
+
+      double result[2];
+
+      profile_info_t info[2];
+      info[0]->sqr = info[1]->sqr = sqr;
+      info[0]->m = info[1]->m = random_ntt_prime (b, lgmax);
+
+      info[0]->algo = ALGO_MUL_BEST;
+      info[1]->algo = ALGO_MUL_NTT;
+      
+      // find an upper bound, where NTT algorithm appears to be safely
+      // ahead of everything else
+      size_t upper;
+      int found = 0;
+      for (upper = 4; 2 * upper <= (1UL << lgmax) && !found;
+           upper = 2 * upper)
+      {
+         info[0]->n1 = info[1]->n1 = upper;
+         info[0]->n2 = info[1]->n2 = upper;
+         
+         result[0] = profile (NULL, NULL, profile_mul, info[0], speed);
+         result[1] = profile (NULL, NULL, profile_mul, info[1], speed);
+         
+         if (result[1] < 0.95 * result[0])
+            found = 1;
+      }
+
+      if (!found)
+         // couldn't find a reasonable upper bound
+         goto done;
+      
+      upper /= 2;
+      
+      // find a lower bound, where other algorithms appear to be safely
+      // ahead of the NTT
+      size_t lower;
+      found = 0;
+      for (lower = upper/2; lower >= 2 && !found; lower = lower / 2)
+      {
+         info[0]->n1 = info[1]->n1 = lower;
+         info[0]->n2 = info[1]->n2 = lower;
+         
+         result[0] = profile (NULL, NULL, profile_mul, info[0], speed);
+         result[1] = profile (NULL, NULL, profile_mul, info[1], speed);
+         
+         if (result[1] > 1.05 * result[0])
+            found = 1;
+      }
+
+      if (!found)
+      {
+         // couldn't find a reasonable lower bound
+         thresh = 2;
+         goto done;
+      }
+      
+      lower *= 2;
+
+      // subdivide [lower, upper] into intervals and sample at each endpoint
+      {
+         double ratio = (double) upper / (double) lower;
+         const int max_intervals = 20;
+         size_t points[max_intervals + 1];
+         double score[max_intervals + 1];
+         unsigned i;
+         for (i = 0; i <= max_intervals; i++)
+         {
+            points[i] = ceil (lower * pow (ratio, (double) i / max_intervals));
+            info[0]->n1 = info[1]->n1 = points[i];
+            info[0]->n2 = info[1]->n2 = points[i];
+            result[0] = profile (NULL, NULL, profile_mul, info[0], speed);
+            result[1] = profile (NULL, NULL, profile_mul, info[1], speed);
+            score[i] = result[1] / result[0];
+         }
+      
+         // estimate threshold
+         unsigned count = 0;
+         for (i = 0; i <= max_intervals; i++)
+            if (score[i] > 1.0)
+               count++;
+         thresh = (size_t)
+              ceil (lower * pow (ratio, (double) count / (max_intervals + 1)));
+      }
+
+      done:
+      
+      if (verbose)
+      {
+         fprintf (flog, "\nbits = %u, cross to NTT at ", b);
+         if (thresh == SIZE_MAX)
+            fprintf (flog, "infinity");
+         else
+            fprintf (flog, "%lu", thresh);
+      }
+      else
+         fprintf (flog, ".");
+
+      fflush (flog);
+
+      if (sqr)
+         tuning_info[b].sqr_ntt_thresh = thresh;
+      else
+         tuning_info[b].mul_ntt_thresh = thresh;
+   }
+
+   fprintf (flog, "\n");
+}
+
+
 // end of file ****************************************************************
@@ -90,6 +90,8 @@ main (int argc, char* argv[])
    tune_nuss (stderr, 1, verbose);
    tune_mul (stderr, 0, verbose);
    tune_mul (stderr, 1, verbose);
+   tune_mul_ntt (stderr, 0, verbose);
+   tune_mul_ntt (stderr, 1, verbose);
    tune_mulmid (stderr, verbose);
 
 #else
@@ -165,9 +167,17 @@ main (int argc, char* argv[])
       
       printf ("      %5lu,   // nussbaumer multiplication threshold\n",
               tuning_info[bits].nuss_mul_thresh);
-      printf ("      %5lu    // nussbaumer squaring threshold\n",
+      printf ("      %5lu,   // nussbaumer squaring threshold\n",
               tuning_info[bits].nuss_sqr_thresh);
 
+      x = tuning_info[bits].mul_ntt_thresh;
+      printf (x == SIZE_MAX ? "   SIZE_MAX," : "      %5lu,", x);
+      printf ("   // KS -> NTT multiplication threshold\n");
+
+      x = tuning_info[bits].sqr_ntt_thresh;
+      printf (x == SIZE_MAX ? "   SIZE_MAX " : "      %5lu ", x);
+      printf ("   // KS -> NTT squaring threshold\n");
+
       printf ("   },\n");
    }
    